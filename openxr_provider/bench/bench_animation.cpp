@@ -0,0 +1,187 @@
+/* Copyright 2021, 2022, 2023 Rune Berg (GitHub: https://github.com/1runeberg, Twitter: https://twitter.com/1runeberg, YouTube: https://www.youtube.com/@1RuneBerg)
+ *
+ *  SPDX-License-Identifier: MIT
+ *
+ *  Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+ *
+ *  2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *
+ *  3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote products derived from this
+ *     software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ *  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+ *  BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ *  GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+ *  DAMAGE.
+ *
+ */
+
+// Animation and transform benchmarks - synthetic glTF node hierarchies (--nodes) with a clip of --keyframes keys per channel.
+// Only the cpu side of vkglTF::Model is used, no vulkan device is needed
+
+#include "bench_common.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+#include <xrvk/vulkanpbr/VulkanglTFModel.h>
+
+namespace oxr::bench
+{
+	namespace
+	{
+		const uint32_t k_unChildrenPerNode = 4;
+		const uint32_t k_unNodesPerMesh = 4;
+		const float k_fKeyframeInterval = 1.0f / 30.0f;
+		const float k_fFrameTime = 1.0f / 90.0f;
+
+		// Long clip - enough keyframes that scanning from the first one every frame would dominate the update
+		const uint32_t k_unLongClipKeyframes = 10000;
+		const uint32_t k_unLongClipNodes = 16;
+
+		/// <summary>
+		/// Node tree of the requested size, every k_unNodesPerMesh'th node has a mesh. One animation moves and rotates every node
+		/// </summary>
+		struct SyntheticScene
+		{
+			vkglTF::Model model;
+
+			SyntheticScene( uint32_t unNodes, uint32_t unKeyframes, vkglTF::AnimationSampler::InterpolationType eInterpolation )
+			{
+				// (1) Nodes - a tree k_unChildrenPerNode wide
+				for ( uint32_t i = 0; i < unNodes; i++ )
+				{
+					vkglTF::Node *pNode = new vkglTF::Node {};
+					pNode->index = i;
+					pNode->matrix = glm::mat4( 1.0f );
+					pNode->translation = glm::vec3( 0.0f, 0.1f, 0.0f );
+
+					if ( i == 0 )
+					{
+						model.nodes.push_back( pNode );
+					}
+					else
+					{
+						pNode->parent = model.linearNodes[ ( i - 1 ) / k_unChildrenPerNode ];
+						pNode->parent->children.push_back( pNode );
+					}
+
+					if ( i % k_unNodesPerMesh == 0 )
+						pNode->mesh = new vkglTF::Mesh( nullptr, glm::mat4( 1.0f ) );
+
+					model.linearNodes.push_back( pNode );
+				}
+
+				// (2) One clip with a translation and a rotation channel per node
+				const bool bCubic = eInterpolation == vkglTF::AnimationSampler::InterpolationType::CUBICSPLINE;
+				vkglTF::Animation animation;
+				animation.name = "bench";
+				animation.start = 0.0f;
+				animation.end = ( unKeyframes - 1 ) * k_fKeyframeInterval;
+
+				for ( auto pNode : model.linearNodes )
+				{
+					for ( auto ePath : { vkglTF::AnimationChannel::PathType::TRANSLATION, vkglTF::AnimationChannel::PathType::ROTATION } )
+					{
+						vkglTF::AnimationSampler sampler;
+						sampler.interpolation = eInterpolation;
+						sampler.inputs.resize( unKeyframes );
+						sampler.outputsVec4.reserve( unKeyframes * ( bCubic ? 3 : 1 ) );
+
+						for ( uint32_t k = 0; k < unKeyframes; k++ )
+						{
+							sampler.inputs[ k ] = k * k_fKeyframeInterval;
+
+							const float fPhase = ( float )( k + pNode->index ) * 0.1f;
+							glm::vec4 value = ePath == vkglTF::AnimationChannel::PathType::ROTATION
+												  ? glm::vec4( 0.0f, std::sin( fPhase * 0.5f ), 0.0f, std::cos( fPhase * 0.5f ) )
+												  : glm::vec4( std::sin( fPhase ) * 0.1f, 0.1f, 0.0f, 0.0f );
+
+							if ( bCubic )
+								sampler.outputsVec4.push_back( glm::vec4( 0.0f ) );
+							sampler.outputsVec4.push_back( value );
+							if ( bCubic )
+								sampler.outputsVec4.push_back( glm::vec4( 0.0f ) );
+						}
+
+						vkglTF::AnimationChannel channel;
+						channel.path = ePath;
+						channel.node = pNode;
+						channel.samplerIndex = static_cast< uint32_t >( animation.samplers.size() );
+
+						animation.samplers.push_back( std::move( sampler ) );
+						animation.channels.push_back( channel );
+					}
+				}
+
+				model.animations.push_back( std::move( animation ) );
+				model.updateTransforms();
+			}
+
+			~SyntheticScene() { model.destroy( VK_NULL_HANDLE ); }
+		};
+	} // namespace
+
+	void RunAnimationBenchmarks( Runner &runner )
+	{
+		if ( !runner.IsAnyEnabled( { "animation/update_transforms_static", "animation/update_transforms_root_moved", "animation/playback_linear", "animation/seek_linear",
+									  "animation/playback_cubicspline", "animation/playback_long_clip", "animation/seek_long_clip" } ) )
+			return;
+
+		const Options &options = runner.GetOptions();
+		const uint32_t unKeyframes = std::max( options.unKeyframes, 2u );
+		const Params params = { { "nodes", ( double )options.unNodes }, { "keyframes", ( double )unKeyframes } };
+
+		SyntheticScene scene( std::max( options.unNodes, 1u ), unKeyframes, vkglTF::AnimationSampler::InterpolationType::LINEAR );
+		vkglTF::Model &model = scene.model;
+		vkglTF::Node *pRoot = model.nodes.front();
+		const float fClipLength = model.animations[ 0 ].end;
+
+		// (1) Transform update with nothing changed - the cost of finding out that no subtree needs recomputing
+		runner.Run( "animation/update_transforms_static", params, [ & ]( uint32_t ) { model.updateTransforms(); } );
+
+		// (2) Transform update after the root moved - every world matrix and mesh uniform block is recomputed
+		runner.Run(
+			"animation/update_transforms_root_moved", params, [ & ]( uint32_t unIteration ) { pRoot->translation.x = ( unIteration & 1 ) ? 1.0f : 0.0f; },
+			[ & ]( uint32_t ) { model.updateTransforms(); } );
+
+		// (3) Playback at 90Hz - samplers mostly stay on their cached keyframe or move to the next one
+		runner.Run( "animation/playback_linear", params, [ & ]( uint32_t unIteration ) { model.updateAnimation( 0, std::fmod( unIteration * k_fFrameTime, fClipLength ) ); } );
+
+		// (4) Seeking to unrelated times - every sampler falls back to a binary search
+		runner.Run( "animation/seek_linear", params, [ & ]( uint32_t unIteration ) {
+			const float fTime = std::fmod( ( unIteration * 2654435761u % 10007u ) * 0.01f, fClipLength );
+			model.updateAnimation( 0, fTime );
+		} );
+
+		// (5) Playback of cubic spline clips, three outputs per keyframe
+		if ( runner.IsEnabled( "animation/playback_cubicspline" ) )
+		{
+			SyntheticScene cubicScene( std::max( options.unNodes, 1u ), unKeyframes, vkglTF::AnimationSampler::InterpolationType::CUBICSPLINE );
+			runner.Run( "animation/playback_cubicspline", params,
+						[ & ]( uint32_t unIteration ) { cubicScene.model.updateAnimation( 0, std::fmod( unIteration * k_fFrameTime, fClipLength ) ); } );
+		}
+
+		// (6) Playback and seeks in a 10k keyframe clip - playback stays constant time per channel, seeks are a binary search
+		if ( runner.IsAnyEnabled( { "animation/playback_long_clip", "animation/seek_long_clip" } ) )
+		{
+			SyntheticScene longScene( k_unLongClipNodes, k_unLongClipKeyframes, vkglTF::AnimationSampler::InterpolationType::LINEAR );
+			const Params longParams = { { "nodes", ( double )k_unLongClipNodes }, { "keyframes", ( double )k_unLongClipKeyframes } };
+			const float fLongClipLength = longScene.model.animations[ 0 ].end;
+
+			runner.Run( "animation/playback_long_clip", longParams,
+						[ & ]( uint32_t unIteration ) { longScene.model.updateAnimation( 0, std::fmod( unIteration * k_fFrameTime, fLongClipLength ) ); } );
+
+			runner.Run( "animation/seek_long_clip", longParams, [ & ]( uint32_t unIteration ) {
+				const float fTime = std::fmod( ( unIteration * 2654435761u % 10007u ) * 0.0331f, fLongClipLength );
+				longScene.model.updateAnimation( 0, fTime );
+			} );
+		}
+	}
+
+} // namespace oxr::bench
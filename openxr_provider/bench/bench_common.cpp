@@ -0,0 +1,195 @@
+/* Copyright 2021, 2022, 2023 Rune Berg (GitHub: https://github.com/1runeberg, Twitter: https://twitter.com/1runeberg, YouTube: https://www.youtube.com/@1RuneBerg)
+ *
+ *  SPDX-License-Identifier: MIT
+ *
+ *  Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+ *
+ *  2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *
+ *  3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote products derived from this
+ *     software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ *  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+ *  BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ *  GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+ *  DAMAGE.
+ *
+ */
+
+#include "bench_common.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+
+#include <openxr_provider.h>
+
+namespace oxr::bench
+{
+	namespace
+	{
+		inline int64_t NowNs() { return std::chrono::duration_cast< std::chrono::nanoseconds >( std::chrono::steady_clock::now().time_since_epoch() ).count(); }
+
+		// Nearest rank percentile of sorted samples
+		double Percentile( const std::vector< int64_t > &vecSorted, double dPercentile )
+		{
+			size_t unRank = static_cast< size_t >( dPercentile / 100.0 * ( double )vecSorted.size() + 0.5 );
+			unRank = std::clamp< size_t >( unRank, 1, vecSorted.size() );
+			return ( double )vecSorted[ unRank - 1 ];
+		}
+
+		// Writes a json string, benchmark names and skip reasons only need quotes and backslashes escaped
+		void WriteJsonString( FILE *pFile, const std::string &sValue )
+		{
+			std::fputc( '"', pFile );
+			for ( char c : sValue )
+			{
+				if ( c == '"' || c == '\\' )
+					std::fputc( '\\', pFile );
+				std::fputc( c, pFile );
+			}
+			std::fputc( '"', pFile );
+		}
+	} // namespace
+
+	bool Runner::IsEnabled( const char *pccName ) const { return m_Options.sFilter.empty() || std::string( pccName ).find( m_Options.sFilter ) != std::string::npos; }
+
+	bool Runner::IsAnyEnabled( std::initializer_list< const char * > listNames ) const
+	{
+		for ( const char *pccName : listNames )
+		{
+			if ( IsEnabled( pccName ) )
+				return true;
+		}
+
+		return false;
+	}
+
+	void Runner::Run( const char *pccName, const Params &params, const std::function< void( uint32_t ) > &fnPrepare, const std::function< void( uint32_t ) > &fnMeasure )
+	{
+		if ( !IsEnabled( pccName ) || m_Options.unIterations == 0 )
+			return;
+
+		// (1) Warmup - fills caches and lets pools and containers reach their steady state size
+		uint32_t unIteration = 0;
+		for ( ; unIteration < m_Options.unWarmupIterations; unIteration++ )
+		{
+			if ( fnPrepare )
+				fnPrepare( unIteration );
+			fnMeasure( unIteration );
+		}
+
+		// (2) Timed iterations, allocations are only counted for the measured work
+		std::vector< int64_t > vecSamples( m_Options.unIterations );
+		uint64_t unAllocations = 0;
+		uint64_t unAllocatedBytes = 0;
+		for ( uint32_t i = 0; i < m_Options.unIterations; i++, unIteration++ )
+		{
+			if ( fnPrepare )
+				fnPrepare( unIteration );
+
+			const uint64_t unAllocationsBefore = g_unAllocations.load( std::memory_order_relaxed );
+			const uint64_t unBytesBefore = g_unAllocatedBytes.load( std::memory_order_relaxed );
+			const int64_t nStartNs = NowNs();
+
+			fnMeasure( unIteration );
+
+			vecSamples[ i ] = NowNs() - nStartNs;
+			unAllocations += g_unAllocations.load( std::memory_order_relaxed ) - unAllocationsBefore;
+			unAllocatedBytes += g_unAllocatedBytes.load( std::memory_order_relaxed ) - unBytesBefore;
+		}
+
+		// (3) Statistics
+		Result result;
+		result.sName = pccName;
+		result.params = params;
+		result.unIterations = m_Options.unIterations;
+
+		int64_t nTotalNs = 0;
+		for ( int64_t nSample : vecSamples )
+			nTotalNs += nSample;
+
+		std::sort( vecSamples.begin(), vecSamples.end() );
+		result.dMeanNs = ( double )nTotalNs / ( double )vecSamples.size();
+		result.dP50Ns = Percentile( vecSamples, 50.0 );
+		result.dP90Ns = Percentile( vecSamples, 90.0 );
+		result.dP99Ns = Percentile( vecSamples, 99.0 );
+		result.dMinNs = ( double )vecSamples.front();
+		result.dMaxNs = ( double )vecSamples.back();
+		result.dAllocationsPerIteration = ( double )unAllocations / ( double )m_Options.unIterations;
+		result.dAllocatedBytesPerIteration = ( double )unAllocatedBytes / ( double )m_Options.unIterations;
+
+		std::printf( "%-48s p50 %10.3f us  p90 %10.3f us  p99 %10.3f us  max %10.3f us  allocs/it %8.2f\n", pccName, result.dP50Ns / 1000.0, result.dP90Ns / 1000.0, result.dP99Ns / 1000.0,
+					 result.dMaxNs / 1000.0, result.dAllocationsPerIteration );
+		std::fflush( stdout );
+
+		m_vecResults.push_back( std::move( result ) );
+	}
+
+	void Runner::Skip( const char *pccName, const char *pccReason )
+	{
+		if ( !IsEnabled( pccName ) )
+			return;
+
+		std::printf( "%-48s skipped: %s\n", pccName, pccReason );
+		m_vecSkipped.emplace_back( pccName, pccReason );
+	}
+
+	bool Runner::WriteJson() const
+	{
+		FILE *pFile = std::fopen( m_Options.sJsonPath.c_str(), "w" );
+		if ( !pFile )
+		{
+			std::fprintf( stderr, "Unable to write benchmark report to %s\n", m_Options.sJsonPath.c_str() );
+			return false;
+		}
+
+		std::fprintf( pFile, "{\n  \"provider_version\": \"%i.%i.%i\",\n", PROVIDER_VERSION_MAJOR, PROVIDER_VERSION_MINOR, PROVIDER_VERSION_PATCH );
+		std::fprintf( pFile, "  \"options\": { \"iterations\": %u, \"warmup_iterations\": %u, \"nodes\": %u, \"actions\": %u, \"keyframes\": %u, \"models\": %u, \"shapes\": %u },\n",
+					  m_Options.unIterations, m_Options.unWarmupIterations, m_Options.unNodes, m_Options.unActions, m_Options.unKeyframes, m_Options.unModels, m_Options.unShapes );
+
+		std::fprintf( pFile, "  \"results\": [" );
+		for ( size_t i = 0; i < m_vecResults.size(); i++ )
+		{
+			const Result &result = m_vecResults[ i ];
+			std::fprintf( pFile, "%s\n    { \"name\": ", i == 0 ? "" : "," );
+			WriteJsonString( pFile, result.sName );
+
+			std::fprintf( pFile, ", \"params\": {" );
+			for ( size_t p = 0; p < result.params.size(); p++ )
+			{
+				std::fprintf( pFile, "%s ", p == 0 ? "" : "," );
+				WriteJsonString( pFile, result.params[ p ].first );
+				std::fprintf( pFile, ": %.17g", result.params[ p ].second );
+			}
+
+			std::fprintf( pFile,
+						  " }, \"iterations\": %u, \"mean_ns\": %.1f, \"p50_ns\": %.1f, \"p90_ns\": %.1f, \"p99_ns\": %.1f, \"min_ns\": %.1f, \"max_ns\": %.1f, \"allocations_per_iteration\": %.3f, "
+						  "\"allocated_bytes_per_iteration\": %.1f }",
+						  result.unIterations, result.dMeanNs, result.dP50Ns, result.dP90Ns, result.dP99Ns, result.dMinNs, result.dMaxNs, result.dAllocationsPerIteration,
+						  result.dAllocatedBytesPerIteration );
+		}
+		std::fprintf( pFile, "\n  ],\n" );
+
+		std::fprintf( pFile, "  \"skipped\": [" );
+		for ( size_t i = 0; i < m_vecSkipped.size(); i++ )
+		{
+			std::fprintf( pFile, "%s\n    { \"name\": ", i == 0 ? "" : "," );
+			WriteJsonString( pFile, m_vecSkipped[ i ].first );
+			std::fprintf( pFile, ", \"reason\": " );
+			WriteJsonString( pFile, m_vecSkipped[ i ].second );
+			std::fprintf( pFile, " }" );
+		}
+		std::fprintf( pFile, "\n  ]\n}\n" );
+
+		std::fclose( pFile );
+		std::printf( "Benchmark report written to %s\n", m_Options.sJsonPath.c_str() );
+		return true;
+	}
+
+} // namespace oxr::bench
@@ -0,0 +1,161 @@
+/* Copyright 2021, 2022, 2023 Rune Berg (GitHub: https://github.com/1runeberg, Twitter: https://twitter.com/1runeberg, YouTube: https://www.youtube.com/@1RuneBerg)
+ *
+ *  SPDX-License-Identifier: MIT
+ *
+ *  Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+ *
+ *  2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *
+ *  3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote products derived from this
+ *     software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ *  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+ *  BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ *  GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+ *  DAMAGE.
+ *
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <initializer_list>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Benchmark harness for openxr_provider_bench. Every benchmark runs a fixed number of timed iterations, reports latency
+// percentiles and heap allocations per iteration, and is written to a json report that can be diffed across releases
+namespace oxr::bench
+{
+	// Heap allocations made through operator new (all threads), counted by the replacement operators in bench_main.cpp
+	extern std::atomic< uint64_t > g_unAllocations;
+	extern std::atomic< uint64_t > g_unAllocatedBytes;
+
+	/// <summary>
+	/// Command line options, see PrintUsage() in bench_main.cpp
+	/// </summary>
+	struct Options
+	{
+		// Timed iterations per benchmark and untimed ones before them
+		uint32_t unIterations = 1000;
+		uint32_t unWarmupIterations = 50;
+
+		// Only benchmarks whose name contains this are run, all if empty
+		std::string sFilter;
+
+		// Path of the json report
+		std::string sJsonPath = "openxr_provider_bench.json";
+
+		// Synthetic scene sizes
+		uint32_t unNodes = 1000;
+		uint32_t unActions = 16;
+		uint32_t unKeyframes = 100;
+		uint32_t unModels = 50;
+		uint32_t unShapes = 1000;
+	};
+
+	// Named parameters of a benchmark run (e.g. node count), written with its result
+	typedef std::vector< std::pair< std::string, double > > Params;
+
+	/// <summary>
+	/// Latency and allocation statistics of a benchmark run
+	/// </summary>
+	struct Result
+	{
+		std::string sName;
+		Params params;
+		uint32_t unIterations = 0;
+
+		// Per iteration latency in nanoseconds
+		double dMeanNs = 0.0;
+		double dP50Ns = 0.0;
+		double dP90Ns = 0.0;
+		double dP99Ns = 0.0;
+		double dMinNs = 0.0;
+		double dMaxNs = 0.0;
+
+		// Heap allocations per iteration (all threads)
+		double dAllocationsPerIteration = 0.0;
+		double dAllocatedBytesPerIteration = 0.0;
+	};
+
+	/// <summary>
+	/// Runs benchmarks and collects their results
+	/// </summary>
+	class Runner
+	{
+	  public:
+		explicit Runner( const Options &options )
+			: m_Options( options )
+		{
+		}
+
+		const Options &GetOptions() const { return m_Options; }
+
+		/// <summary>
+		/// Whether a benchmark passes the name filter - use it to skip expensive setup of filtered out benchmarks
+		/// </summary>
+		/// <param name="pccName">Benchmark name</param>
+		/// <returns>True if the benchmark should run</returns>
+		bool IsEnabled( const char *pccName ) const;
+
+		/// <summary>
+		/// Whether any of a group of benchmarks passes the name filter - use it to skip setup shared by a suite
+		/// </summary>
+		/// <param name="listNames">Benchmark names sharing the setup</param>
+		/// <returns>True if at least one of the benchmarks should run</returns>
+		bool IsAnyEnabled( std::initializer_list< const char * > listNames ) const;
+
+		/// <summary>
+		/// Times fnMeasure over the warmup and timed iterations. fnPrepare runs before each iteration and is not timed
+		/// </summary>
+		/// <param name="pccName">Benchmark name, use suite/benchmark (e.g. input/process_input)</param>
+		/// <param name="params">Parameters to report with the result</param>
+		/// <param name="fnPrepare">Untimed per iteration setup (e.g. scripting runtime inputs), can be empty</param>
+		/// <param name="fnMeasure">Timed work of one iteration, gets the iteration index (warmup iterations included)</param>
+		void Run( const char *pccName, const Params &params, const std::function< void( uint32_t ) > &fnPrepare, const std::function< void( uint32_t ) > &fnMeasure );
+
+		/// <summary>
+		/// Times fnMeasure over the warmup and timed iterations
+		/// </summary>
+		/// <param name="pccName">Benchmark name, use suite/benchmark (e.g. input/process_input)</param>
+		/// <param name="params">Parameters to report with the result</param>
+		/// <param name="fnMeasure">Timed work of one iteration, gets the iteration index (warmup iterations included)</param>
+		void Run( const char *pccName, const Params &params, const std::function< void( uint32_t ) > &fnMeasure ) { Run( pccName, params, nullptr, fnMeasure ); }
+
+		/// <summary>
+		/// Records a benchmark that could not run in this environment (e.g. no vulkan device), it is reported as skipped
+		/// </summary>
+		/// <param name="pccName">Benchmark or suite name</param>
+		/// <param name="pccReason">Why it was skipped</param>
+		void Skip( const char *pccName, const char *pccReason );
+
+		const std::vector< Result > &GetResults() const { return m_vecResults; }
+
+		/// <summary>
+		/// Writes all results and skipped benchmarks as json
+		/// </summary>
+		/// <returns>True if the report was written</returns>
+		bool WriteJson() const;
+
+	  private:
+		Options m_Options;
+		std::vector< Result > m_vecResults;
+		std::vector< std::pair< std::string, std::string > > m_vecSkipped;
+	};
+
+	// Benchmark suites, each in its own bench_*.cpp
+	void RunFrameLoopBenchmarks( Runner &runner );
+	void RunInputBenchmarks( Runner &runner );
+	void RunAnimationBenchmarks( Runner &runner );
+	void RunRenderBenchmarks( Runner &runner );
+
+} // namespace oxr::bench
@@ -0,0 +1,64 @@
+/* Copyright 2021, 2022, 2023 Rune Berg (GitHub: https://github.com/1runeberg, Twitter: https://twitter.com/1runeberg, YouTube: https://www.youtube.com/@1RuneBerg)
+ *
+ *  SPDX-License-Identifier: MIT
+ *
+ *  Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+ *
+ *  2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *
+ *  3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote products derived from this
+ *     software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ *  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+ *  BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ *  GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+ *  DAMAGE.
+ *
+ */
+
+// Frame loop benchmarks - provider overhead of a frame (wait, begin, end) with the mock runtime unthrottled, inline and pipelined
+
+#include "bench_common.hpp"
+#include "test_common.hpp"
+
+namespace oxr::bench
+{
+	void RunFrameLoopBenchmarks( Runner &runner )
+	{
+		if ( !runner.IsAnyEnabled( { "frame_loop/headless_inline", "frame_loop/headless_pipelined" } ) )
+			return;
+
+		// An unthrottled display makes xrWaitFrame return right away, so only provider and runtime call overhead is measured
+		oxr::mock::Config config;
+		config.fDisplayRate = 0.0f;
+		oxr::mock::SetConfig( config );
+
+		std::unique_ptr< oxr::Provider > pProvider = oxr::test::CreateFocusedHeadlessSession( "openxr_provider_bench" );
+		if ( !pProvider )
+		{
+			runner.Skip( "frame_loop/", "unable to start a session on the mock runtime (is XR_RUNTIME_JSON set?)" );
+			return;
+		}
+
+		oxr::Session *pSession = pProvider->Session();
+		XrFrameState xrFrameState { XR_TYPE_FRAME_STATE };
+
+		// (1) Wait, begin and end on the calling thread
+		runner.Run( "frame_loop/headless_inline", {}, [ & ]( uint32_t ) { pSession->RenderHeadlessFrame( &xrFrameState ); } );
+
+		// (2) Wait and begin on the frame pacing thread, end on the frame end thread - the render thread only takes and hands off frames
+		if ( runner.IsEnabled( "frame_loop/headless_pipelined" ) && pSession->StartFramePacing() == XR_SUCCESS )
+		{
+			runner.Run( "frame_loop/headless_pipelined", {}, [ & ]( uint32_t ) { pSession->RenderHeadlessFrame( &xrFrameState ); } );
+			pSession->StopFramePacing();
+		}
+
+		oxr::test::EndSession( pProvider.get() );
+	}
+
+} // namespace oxr::bench
@@ -0,0 +1,230 @@
+/* Copyright 2021, 2022, 2023 Rune Berg (GitHub: https://github.com/1runeberg, Twitter: https://twitter.com/1runeberg, YouTube: https://www.youtube.com/@1RuneBerg)
+ *
+ *  SPDX-License-Identifier: MIT
+ *
+ *  Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+ *
+ *  2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *
+ *  3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote products derived from this
+ *     software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ *  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+ *  BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ *  GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+ *  DAMAGE.
+ *
+ */
+
+// Input benchmarks - action sync and state reads for an action set of configurable size (--actions), every action bound on both hands
+
+#include "bench_common.hpp"
+#include "test_common.hpp"
+
+namespace oxr::bench
+{
+	namespace
+	{
+		// Action count of the event mode benchmarks
+		const uint32_t k_unEventActionCount = 200;
+
+		uint64_t g_unCallbacks = 0;
+		void CountCallback( oxr::Action *, uint32_t ) { g_unCallbacks++; }
+
+		// Input source per action type, the same source on both hands
+		const char *InputSource( XrActionType xrActionType )
+		{
+			switch ( xrActionType )
+			{
+				case XR_ACTION_TYPE_BOOLEAN_INPUT:
+					return "/input/a/click";
+				case XR_ACTION_TYPE_FLOAT_INPUT:
+					return "/input/trigger/value";
+				case XR_ACTION_TYPE_VECTOR2F_INPUT:
+					return "/input/thumbstick";
+				default:
+					return "/input/aim/pose";
+			}
+		}
+
+		/// <summary>
+		/// Action set with boolean, float, vector2f and pose actions in turn, bound to the valve index profile on both hands
+		/// </summary>
+		struct InputScene
+		{
+			oxr::ActionSet actionSet;
+			std::vector< std::unique_ptr< oxr::Action > > vecActions;
+			oxr::ValveIndex controller;
+
+			bool Init( oxr::Provider *pProvider, uint32_t unActionCount )
+			{
+				oxr::Input *pInput = pProvider->Input();
+				if ( !XR_UNQUALIFIED_SUCCESS( pInput->CreateActionSet( &actionSet, "bench", "benchmark actions" ) ) )
+					return false;
+
+				const XrActionType arrActionTypes[] = { XR_ACTION_TYPE_BOOLEAN_INPUT, XR_ACTION_TYPE_FLOAT_INPUT, XR_ACTION_TYPE_VECTOR2F_INPUT, XR_ACTION_TYPE_POSE_INPUT };
+				const char *arrHands[] = { "/user/hand/left", "/user/hand/right" };
+
+				for ( uint32_t i = 0; i < unActionCount; i++ )
+				{
+					const XrActionType xrActionType = arrActionTypes[ i % 4 ];
+					auto pAction = std::make_unique< oxr::Action >( xrActionType, &CountCallback );
+
+					const std::string sName = "action_" + std::to_string( i );
+					if ( !XR_UNQUALIFIED_SUCCESS( pInput->CreateAction( pAction.get(), &actionSet, sName, sName, { arrHands[ 0 ], arrHands[ 1 ] } ) ) )
+						return false;
+
+					for ( const char *pccHand : arrHands )
+						pInput->AddBinding( &controller, pAction->xrActionHandle, std::string( pccHand ) + InputSource( xrActionType ) );
+
+					vecActions.push_back( std::move( pAction ) );
+				}
+
+				if ( !XR_UNQUALIFIED_SUCCESS( pInput->SuggestBindings( &controller, nullptr ) ) )
+					return false;
+
+				pInput->Init( pProvider->Session() );
+				if ( !XR_UNQUALIFIED_SUCCESS( pInput->AttachActionSetsToSession( &actionSet.xrActionSetHandle, 1 ) ) )
+					return false;
+
+				XrPosef xrPoseInSpace { { 0.0f, 0.0f, 0.0f, 1.0f }, { 0.0f, 0.0f, 0.0f } };
+				for ( auto &pAction : vecActions )
+				{
+					if ( pAction->xrActionType == XR_ACTION_TYPE_POSE_INPUT && !XR_UNQUALIFIED_SUCCESS( pInput->CreateActionSpaces( pAction.get(), &xrPoseInSpace ) ) )
+						return false;
+				}
+
+				return XR_UNQUALIFIED_SUCCESS( pInput->AddActionsetForSync( &actionSet ) );
+			}
+		};
+
+		// Moves every scripted input source on both hands, so all non pose actions change on the next sync
+		void ScriptInputChange( uint32_t unIteration )
+		{
+			const bool bOn = ( unIteration & 1 ) != 0;
+			for ( const char *pccHand : { "/user/hand/left", "/user/hand/right" } )
+			{
+				const std::string sHand = pccHand;
+				oxr::mock::SetInputBoolean( ( sHand + "/input/a/click" ).c_str(), bOn );
+				oxr::mock::SetInputFloat( ( sHand + "/input/trigger/value" ).c_str(), bOn ? 1.0f : 0.0f );
+				oxr::mock::SetInputVector2f( ( sHand + "/input/thumbstick" ).c_str(), { bOn ? 1.0f : 0.0f, 0.5f } );
+			}
+		}
+
+		// Starts a session on the mock runtime with an input scene of the given size, skips the suite if it can't
+		bool StartInputScene( Runner &runner, const char *pccSuite, uint32_t unActionCount, std::unique_ptr< oxr::Provider > &outProvider, std::unique_ptr< InputScene > &outScene )
+		{
+			oxr::mock::SetConfig( oxr::mock::Config() );
+
+			outProvider = oxr::test::CreateFocusedHeadlessSession( "openxr_provider_bench" );
+			if ( !outProvider )
+			{
+				runner.Skip( pccSuite, "unable to start a session on the mock runtime (is XR_RUNTIME_JSON set?)" );
+				return false;
+			}
+
+			outScene = std::make_unique< InputScene >();
+			if ( !outScene->Init( outProvider.get(), unActionCount ) )
+			{
+				runner.Skip( pccSuite, "unable to create and attach the benchmark action set" );
+				outScene.reset();
+				oxr::test::EndSession( outProvider.get() );
+				return false;
+			}
+
+			return true;
+		}
+
+		// Sync cost in callback mode at the configured action count
+		void RunCallbackBenchmarks( Runner &runner )
+		{
+			if ( !runner.IsAnyEnabled( { "input/process_input_changed", "input/process_input_idle", "input/acquire_snapshot_read_all", "input/get_action_state" } ) )
+				return;
+
+			std::unique_ptr< oxr::Provider > pProvider;
+			std::unique_ptr< InputScene > pScene;
+			const uint32_t unActionCount = runner.GetOptions().unActions;
+			if ( !StartInputScene( runner, "input/", unActionCount, pProvider, pScene ) )
+				return;
+
+			oxr::Input *pInput = pProvider->Input();
+			const Params params = { { "actions", ( double )unActionCount }, { "subaction_paths", 2.0 } };
+
+			// (1) Sync with every action changed since the last sync - callbacks for all actions
+			runner.Run( "input/process_input_changed", params, &ScriptInputChange, [ & ]( uint32_t ) { pInput->ProcessInput(); } );
+
+			// (2) Sync with nothing changed - only pose callbacks
+			runner.Run( "input/process_input_idle", params, [ & ]( uint32_t ) { pInput->ProcessInput(); } );
+
+			// (3) Reading all action states from the latest snapshot, as other threads do
+			float fSum = 0.0f;
+			runner.Run( "input/acquire_snapshot_read_all", params, [ & ]( uint32_t ) {
+				oxr::ActionStateSnapshotRef snapshot = pInput->AcquireActionStates();
+				for ( auto &pAction : pScene->vecActions )
+				{
+					fSum += snapshot->GetVector2f( pAction.get(), 0 ).x;
+					fSum += snapshot->GetVector2f( pAction.get(), 1 ).x;
+				}
+			} );
+
+			// (4) A single action state read from the runtime
+			oxr::Action *pFloatAction = pScene->vecActions.size() > 1 ? pScene->vecActions[ 1 ].get() : pScene->vecActions.front().get();
+			runner.Run( "input/get_action_state", params, [ & ]( uint32_t ) { pInput->GetActionState( pFloatAction ); } );
+
+			pScene.reset();
+			oxr::test::EndSession( pProvider.get() );
+		}
+
+		// Sync, emit and drain with a large action set on both hands, against callbacks on the same set
+		void RunEventBenchmarks( Runner &runner )
+		{
+			if ( !runner.IsAnyEnabled( { "input/events_callbacks_changed", "input/events_emit_drain_changed", "input/events_emit_drain_idle" } ) )
+				return;
+
+			std::unique_ptr< oxr::Provider > pProvider;
+			std::unique_ptr< InputScene > pScene;
+			if ( !StartInputScene( runner, "input/events_", k_unEventActionCount, pProvider, pScene ) )
+				return;
+
+			oxr::Input *pInput = pProvider->Input();
+			const Params params = { { "actions", ( double )k_unEventActionCount }, { "subaction_paths", 2.0 } };
+
+			// (1) Callback mode baseline - every action changed
+			runner.Run( "input/events_callbacks_changed", params, &ScriptInputChange, [ & ]( uint32_t ) { pInput->ProcessInput(); } );
+
+			// (2) Event mode with every action changed - one event per changed action and hand, drained into a preallocated vector
+			std::vector< oxr::InputEvent > vecEvents;
+			vecEvents.reserve( k_unEventActionCount * 2 );
+			pInput->EnableEventQueue();
+
+			runner.Run( "input/events_emit_drain_changed", params, &ScriptInputChange, [ & ]( uint32_t ) {
+				vecEvents.clear();
+				pInput->ProcessInput();
+				pInput->DrainEvents( vecEvents );
+			} );
+
+			// (3) Event mode with nothing changed - the change filter drops everything
+			runner.Run( "input/events_emit_drain_idle", params, [ & ]( uint32_t ) {
+				vecEvents.clear();
+				pInput->ProcessInput();
+				pInput->DrainEvents( vecEvents );
+			} );
+
+			pInput->DisableEventQueue();
+			pScene.reset();
+			oxr::test::EndSession( pProvider.get() );
+		}
+	} // namespace
+
+	void RunInputBenchmarks( Runner &runner )
+	{
+		RunCallbackBenchmarks( runner );
+		RunEventBenchmarks( runner );
+	}
+
+} // namespace oxr::bench
@@ -0,0 +1,171 @@
+/* Copyright 2021, 2022, 2023 Rune Berg (GitHub: https://github.com/1runeberg, Twitter: https://twitter.com/1runeberg, YouTube: https://www.youtube.com/@1RuneBerg)
+ *
+ *  SPDX-License-Identifier: MIT
+ *
+ *  Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+ *
+ *  2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *
+ *  3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote products derived from this
+ *     software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ *  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+ *  BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ *  GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+ *  DAMAGE.
+ *
+ */
+
+// openxr_provider_bench - benchmarks of the provider's hot paths against the mock runtime.
+//
+// Usage: openxr_provider_bench [--filter <text>] [--iterations <n>] [--warmup <n>] [--json <path>]
+//                              [--nodes <n>] [--actions <n>] [--keyframes <n>] [--models <n>] [--shapes <n>]
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+
+#include "bench_common.hpp"
+
+namespace oxr::bench
+{
+	std::atomic< uint64_t > g_unAllocations { 0 };
+	std::atomic< uint64_t > g_unAllocatedBytes { 0 };
+} // namespace oxr::bench
+
+// Counting replacements of the global allocation functions, the aligned overloads keep their default implementation
+void *operator new( std::size_t unSize )
+{
+	oxr::bench::g_unAllocations.fetch_add( 1, std::memory_order_relaxed );
+	oxr::bench::g_unAllocatedBytes.fetch_add( unSize, std::memory_order_relaxed );
+
+	if ( void *pMemory = std::malloc( unSize == 0 ? 1 : unSize ) )
+		return pMemory;
+
+	throw std::bad_alloc();
+}
+
+void *operator new[]( std::size_t unSize ) { return operator new( unSize ); }
+void *operator new( std::size_t unSize, const std::nothrow_t & ) noexcept
+{
+	oxr::bench::g_unAllocations.fetch_add( 1, std::memory_order_relaxed );
+	oxr::bench::g_unAllocatedBytes.fetch_add( unSize, std::memory_order_relaxed );
+	return std::malloc( unSize == 0 ? 1 : unSize );
+}
+void *operator new[]( std::size_t unSize, const std::nothrow_t &nothrow ) noexcept { return operator new( unSize, nothrow ); }
+void operator delete( void *pMemory ) noexcept { std::free( pMemory ); }
+void operator delete[]( void *pMemory ) noexcept { std::free( pMemory ); }
+void operator delete( void *pMemory, std::size_t ) noexcept { std::free( pMemory ); }
+void operator delete[]( void *pMemory, std::size_t ) noexcept { std::free( pMemory ); }
+void operator delete( void *pMemory, const std::nothrow_t & ) noexcept { std::free( pMemory ); }
+void operator delete[]( void *pMemory, const std::nothrow_t & ) noexcept { std::free( pMemory ); }
+
+namespace
+{
+	void PrintUsage()
+	{
+		std::printf( "Usage: openxr_provider_bench [options]\n"
+					 "  --filter <text>     only run benchmarks whose name contains text (e.g. input/)\n"
+					 "  --iterations <n>    timed iterations per benchmark (default 1000)\n"
+					 "  --warmup <n>        untimed iterations before them (default 50)\n"
+					 "  --json <path>       json report path (default openxr_provider_bench.json)\n"
+					 "  --nodes <n>         nodes in synthetic scenes (default 1000)\n"
+					 "  --actions <n>       actions in the input action set (default 16)\n"
+					 "  --keyframes <n>     keyframes per animation sampler (default 100)\n"
+					 "  --models <n>        models in asset loading benchmarks (default 50)\n"
+					 "  --shapes <n>        shapes in batched shape benchmarks (default 1000)\n" );
+	}
+
+	bool ParseCount( const char *pccValue, uint32_t &outCount )
+	{
+		char *pEnd = nullptr;
+		const unsigned long unValue = std::strtoul( pccValue, &pEnd, 10 );
+		if ( pEnd == pccValue || *pEnd != '\0' )
+			return false;
+
+		outCount = static_cast< uint32_t >( unValue );
+		return true;
+	}
+
+	bool ParseOptions( int argc, char *argv[], oxr::bench::Options &outOptions )
+	{
+		for ( int i = 1; i < argc; i++ )
+		{
+			const char *pccOption = argv[ i ];
+			if ( std::strcmp( pccOption, "--help" ) == 0 || std::strcmp( pccOption, "-h" ) == 0 || i + 1 >= argc )
+				return false;
+
+			const char *pccValue = argv[ ++i ];
+			bool bValid = true;
+			if ( std::strcmp( pccOption, "--filter" ) == 0 )
+				outOptions.sFilter = pccValue;
+			else if ( std::strcmp( pccOption, "--json" ) == 0 )
+				outOptions.sJsonPath = pccValue;
+			else if ( std::strcmp( pccOption, "--iterations" ) == 0 )
+				bValid = ParseCount( pccValue, outOptions.unIterations );
+			else if ( std::strcmp( pccOption, "--warmup" ) == 0 )
+				bValid = ParseCount( pccValue, outOptions.unWarmupIterations );
+			else if ( std::strcmp( pccOption, "--nodes" ) == 0 )
+				bValid = ParseCount( pccValue, outOptions.unNodes );
+			else if ( std::strcmp( pccOption, "--actions" ) == 0 )
+				bValid = ParseCount( pccValue, outOptions.unActions );
+			else if ( std::strcmp( pccOption, "--keyframes" ) == 0 )
+				bValid = ParseCount( pccValue, outOptions.unKeyframes );
+			else if ( std::strcmp( pccOption, "--models" ) == 0 )
+				bValid = ParseCount( pccValue, outOptions.unModels );
+			else if ( std::strcmp( pccOption, "--shapes" ) == 0 )
+				bValid = ParseCount( pccValue, outOptions.unShapes );
+			else
+				bValid = false;
+
+			if ( !bValid )
+			{
+				std::fprintf( stderr, "Invalid option %s %s\n", pccOption, pccValue );
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	// Points the openxr loader to the mock runtime built with the benchmark, unless a runtime was chosen explicitly
+	void SelectMockRuntime()
+	{
+#ifdef OXR_MOCK_RUNTIME_JSON
+		if ( std::getenv( "XR_RUNTIME_JSON" ) )
+			return;
+
+	#if defined( _WIN32 )
+		_putenv_s( "XR_RUNTIME_JSON", OXR_MOCK_RUNTIME_JSON );
+	#else
+		setenv( "XR_RUNTIME_JSON", OXR_MOCK_RUNTIME_JSON, 0 );
+	#endif
+#endif
+	}
+} // namespace
+
+int main( int argc, char *argv[] )
+{
+	oxr::bench::Options options;
+	if ( !ParseOptions( argc, argv, options ) )
+	{
+		PrintUsage();
+		return EXIT_FAILURE;
+	}
+
+	SelectMockRuntime();
+
+	oxr::bench::Runner runner( options );
+	oxr::bench::RunFrameLoopBenchmarks( runner );
+	oxr::bench::RunInputBenchmarks( runner );
+	oxr::bench::RunAnimationBenchmarks( runner );
+	oxr::bench::RunRenderBenchmarks( runner );
+
+	return runner.WriteJson() ? EXIT_SUCCESS : EXIT_FAILURE;
+}
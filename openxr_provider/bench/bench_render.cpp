@@ -0,0 +1,425 @@
+/* Copyright 2021, 2022, 2023 Rune Berg (GitHub: https://github.com/1runeberg, Twitter: https://twitter.com/1runeberg, YouTube: https://www.youtube.com/@1RuneBerg)
+ *
+ *  SPDX-License-Identifier: MIT
+ *
+ *  Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+ *
+ *  2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *
+ *  3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote products derived from this
+ *     software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ *  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+ *  BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ *  GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+ *  DAMAGE.
+ *
+ */
+
+// Render benchmarks - whole frames (record, submit, wait for the gpu) of xrvk scenes and model loads on the mock runtime, with the render tests' assets.
+// Need a vulkan device, skipped otherwise
+
+#include <algorithm>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "bench_common.hpp"
+#include "render_common.hpp"
+
+namespace oxr::bench
+{
+	namespace
+	{
+		const char *k_pccAppName = "openxr_provider_bench";
+
+		// Mesh nodes of the generated draw list scene and how many of them share a parent node
+		const uint32_t k_unDrawListNodes = 10000;
+		const uint32_t k_unDrawListNodesPerGroup = 100;
+
+		/// <summary>
+		/// Places the i'th of unCount renderables on a square grid around the viewer, half a meter apart and below eye level
+		/// </summary>
+		void PlaceOnGrid( xrvk::RenderSceneBase *pRenderable, uint32_t i, uint32_t unCount )
+		{
+			const uint32_t unColumns = static_cast< uint32_t >( std::ceil( std::sqrt( static_cast< float >( unCount ) ) ) );
+			const float fColumn = static_cast< float >( i % unColumns ) - unColumns * 0.5f;
+			const float fRow = static_cast< float >( i / unColumns ) - unColumns * 0.5f;
+			pRenderable->currentPose.position = { fColumn * 0.5f, -0.5f, fRow * 0.5f };
+		}
+
+		/// <summary>
+		/// Writes a gltf scene (and its .bin) of unNodes mesh nodes on a grid around the viewer, parented in groups of k_unDrawListNodesPerGroup
+		/// under nodes without a mesh. Every node draws the same triangle, so the frame cost is dominated by walking the draw list
+		/// </summary>
+		/// <returns>False if the files couldn't be written</returns>
+		bool WriteNodeGridScene( const std::string &sGltfPath, const std::string &sBinName, uint32_t unNodes )
+		{
+			// (1) One triangle - positions, normals and unsigned short indices
+			const float arrPositions[] = { -0.02f, 0.0f, 0.0f, 0.02f, 0.0f, 0.0f, 0.0f, 0.04f, 0.0f };
+			const float arrNormals[] = { 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 1.0f };
+			const uint16_t arrIndices[] = { 0, 1, 2 };
+
+			std::ofstream binFile( std::filesystem::path( sGltfPath ).replace_filename( sBinName ), std::ios::binary | std::ios::trunc );
+			binFile.write( reinterpret_cast< const char * >( arrPositions ), sizeof( arrPositions ) );
+			binFile.write( reinterpret_cast< const char * >( arrNormals ), sizeof( arrNormals ) );
+			binFile.write( reinterpret_cast< const char * >( arrIndices ), sizeof( arrIndices ) );
+			if ( !binFile )
+				return false;
+
+			// (2) Group nodes first, then the mesh nodes they parent
+			const uint32_t unGroups = ( unNodes + k_unDrawListNodesPerGroup - 1 ) / k_unDrawListNodesPerGroup;
+			const uint32_t unColumns = static_cast< uint32_t >( std::ceil( std::sqrt( static_cast< float >( unNodes ) ) ) );
+
+			std::ostringstream ssNodes;
+			for ( uint32_t g = 0; g < unGroups; g++ )
+			{
+				ssNodes << ( g ? "," : "" ) << "{\"children\":[";
+				for ( uint32_t i = g * k_unDrawListNodesPerGroup; i < std::min( unNodes, ( g + 1 ) * k_unDrawListNodesPerGroup ); i++ )
+					ssNodes << ( i % k_unDrawListNodesPerGroup ? "," : "" ) << unGroups + i;
+				ssNodes << "]}";
+			}
+
+			for ( uint32_t i = 0; i < unNodes; i++ )
+			{
+				const float fColumn = static_cast< float >( i % unColumns ) - unColumns * 0.5f;
+				const float fRow = static_cast< float >( i / unColumns ) - unColumns * 0.5f;
+				ssNodes << ",{\"mesh\":0,\"translation\":[" << fColumn * 0.05f << ",-0.5," << fRow * 0.05f << "]}";
+			}
+
+			std::ostringstream ssRootNodes;
+			for ( uint32_t g = 0; g < unGroups; g++ )
+				ssRootNodes << ( g ? "," : "" ) << g;
+
+			// (3) Scene
+			std::ofstream gltfFile( sGltfPath, std::ios::trunc );
+			gltfFile << "{\"asset\":{\"version\":\"2.0\"},\"scene\":0,\"scenes\":[{\"nodes\":[" << ssRootNodes.str() << "]}],"
+					 << "\"nodes\":[" << ssNodes.str() << "],"
+					 << "\"meshes\":[{\"primitives\":[{\"attributes\":{\"POSITION\":0,\"NORMAL\":1},\"indices\":2}]}],"
+					 << "\"accessors\":["
+					 << "{\"bufferView\":0,\"componentType\":5126,\"count\":3,\"type\":\"VEC3\",\"min\":[-0.02,0.0,0.0],\"max\":[0.02,0.04,0.0]},"
+					 << "{\"bufferView\":1,\"componentType\":5126,\"count\":3,\"type\":\"VEC3\"},"
+					 << "{\"bufferView\":2,\"componentType\":5123,\"count\":3,\"type\":\"SCALAR\"}],"
+					 << "\"bufferViews\":["
+					 << "{\"buffer\":0,\"byteOffset\":0,\"byteLength\":" << sizeof( arrPositions ) << "},"
+					 << "{\"buffer\":0,\"byteOffset\":" << sizeof( arrPositions ) << ",\"byteLength\":" << sizeof( arrNormals ) << "},"
+					 << "{\"buffer\":0,\"byteOffset\":" << sizeof( arrPositions ) + sizeof( arrNormals ) << ",\"byteLength\":" << sizeof( arrIndices ) << "}],"
+					 << "\"buffers\":[{\"uri\":\"" << sBinName << "\",\"byteLength\":" << sizeof( arrPositions ) + sizeof( arrNormals ) + sizeof( arrIndices ) << "}]}";
+
+			return static_cast< bool >( gltfFile );
+		}
+
+		/// <summary>
+		/// Times frames of a single scene, whose draw list is walked once per frame
+		/// </summary>
+		void RunDrawListBenchmark( Runner &runner, const char *pccName, const std::string &sFilename, XrVector3f scale, XrVector3f position )
+		{
+			if ( !std::filesystem::exists( sFilename ) )
+			{
+				runner.Skip( pccName, "scene file not found" );
+				return;
+			}
+
+			oxr::test::RenderSession session;
+			if ( session.Init( k_pccAppName, false, false ) != oxr::test::ERunResult::Rendered )
+			{
+				runner.Skip( pccName, "mock runtime or vulkan device unavailable" );
+				return;
+			}
+
+			xrvk::Render *pRender = session.pRender.get();
+			pRender->AddRenderScene( sFilename, scale );
+			pRender->vecRenderScenes.back()->currentPose.position = position;
+
+			pRender->LoadAssets();
+			pRender->PrepareAllPipelines();
+
+			if ( !session.Begin() )
+			{
+				runner.Skip( pccName, "unable to start a session on the mock runtime" );
+				return;
+			}
+
+			const Params params = { { "draws", ( double )pRender->vecRenderScenes.back()->drawList.Size() } };
+			runner.Run( pccName, params, [ & ]( uint32_t ) { session.RenderFrame(); } );
+		}
+
+		/// <summary>
+		/// Times frames of a grid of models sharing one source file around the viewer, about half of them behind it. From two models on,
+		/// they are drawn as one instance group whose culling prepass has to reject the ones outside the view frustum
+		/// </summary>
+		void RunInstanceBenchmark( Runner &runner, const char *pccName, uint32_t unInstances )
+		{
+			oxr::test::RenderSession session;
+			if ( session.Init( k_pccAppName, false, false ) != oxr::test::ERunResult::Rendered )
+			{
+				runner.Skip( pccName, "mock runtime or vulkan device unavailable" );
+				return;
+			}
+
+			xrvk::Render *pRender = session.pRender.get();
+
+			for ( uint32_t i = 0; i < unInstances; i++ )
+			{
+				pRender->AddRenderModel( "models/Box.glb", { 0.2f, 0.2f, 0.2f } );
+				PlaceOnGrid( pRender->vecRenderModels.back(), i, unInstances );
+			}
+
+			pRender->LoadAssets();
+			pRender->PrepareAllPipelines();
+
+			if ( !session.Begin() )
+			{
+				runner.Skip( pccName, "unable to start a session on the mock runtime" );
+				return;
+			}
+
+			const Params params = { { "instances", ( double )unInstances }, { "instance_groups", ( double )pRender->GetInstanceGroupsCount() } };
+			runner.Run( pccName, params, [ & ]( uint32_t ) { session.RenderFrame(); } );
+		}
+
+		/// <summary>
+		/// Times frames of unScenes scenes drawn by unRecordingThreads worker threads (0 records on the render thread). Scenes are never
+		/// instanced, so each is recorded on its own and the chunks handed to the workers grow with the scene count
+		/// </summary>
+		void RunRecordingBenchmark( Runner &runner, const char *pccName, uint32_t unRecordingThreads, uint32_t unScenes )
+		{
+			oxr::test::RenderSession session;
+			if ( session.Init( k_pccAppName, false, false, unRecordingThreads ) != oxr::test::ERunResult::Rendered )
+			{
+				runner.Skip( pccName, "mock runtime or vulkan device unavailable" );
+				return;
+			}
+
+			xrvk::Render *pRender = session.pRender.get();
+			for ( uint32_t i = 0; i < unScenes; i++ )
+			{
+				pRender->AddRenderScene( "models/Box.glb", { 0.2f, 0.2f, 0.2f } );
+				PlaceOnGrid( pRender->vecRenderScenes.back(), i, unScenes );
+			}
+
+			pRender->LoadAssets();
+			pRender->PrepareAllPipelines();
+
+			if ( !session.Begin() )
+			{
+				runner.Skip( pccName, "unable to start a session on the mock runtime" );
+				return;
+			}
+
+			const Params params = { { "recording_threads", ( double )unRecordingThreads }, { "scenes", ( double )unScenes } };
+			runner.Run( pccName, params, [ & ]( uint32_t ) { session.RenderFrame(); } );
+		}
+
+		/// <summary>
+		/// Starts a renderer whose asset loader has unLoaderThreads worker threads and reads and writes the mesh cache in sMeshCacheDirectory
+		/// (empty disables it). Frames aren't rendered, the session is only there for the renderer's device and upload manager
+		/// </summary>
+		/// <returns>False (and the benchmark reported as skipped) if there's no renderer to load with</returns>
+		bool InitLoadSession( Runner &runner, const char *pccName, oxr::test::RenderSession &session, uint32_t unLoaderThreads, const std::string &sMeshCacheDirectory )
+		{
+			if ( session.Init( k_pccAppName, false, false ) != oxr::test::ERunResult::Rendered )
+			{
+				runner.Skip( pccName, "mock runtime or vulkan device unavailable" );
+				return false;
+			}
+
+			// The loader is created with the first model loaded by LoadAssets
+			xrvk::Render *pRender = session.pRender.get();
+			pRender->SetAssetLoaderThreads( unLoaderThreads );
+			pRender->SetMeshCacheDirectory( sMeshCacheDirectory );
+			pRender->AddRenderScene( "models/Box.glb" );
+			pRender->LoadAssets();
+
+			if ( !pRender->GetAssetLoader() )
+			{
+				runner.Skip( pccName, "asset loader not started" );
+				return false;
+			}
+
+			return true;
+		}
+
+		/// <summary>
+		/// Loads every file into its model on the renderer's asset loader and waits until they're usable on the graphics queue, same as LoadAssets
+		/// </summary>
+		/// <returns>The last file's load</returns>
+		xrvk::AssetHandle LoadModels( xrvk::Render *pRender, const std::vector< std::string > &vecFilenames, vkglTF::Model *pModels )
+		{
+			xrvk::AssetHandle asset;
+			for ( size_t i = 0; i < vecFilenames.size(); i++ )
+				asset = pRender->GetAssetLoader()->Load( vecFilenames[ i ], &pModels[ i ] );
+
+			pRender->GetAssetLoader()->WaitAll();
+			pRender->GetUploadManager()->SubmitGraphicsWork( pRender->GetSharedState()->vkQueue );
+			return asset;
+		}
+
+		/// <summary>
+		/// Times loading unModels models (alternating between the test assets' textured and untextured model) with the mesh cache disabled.
+		/// The loader's thread count stays the same however many models are queued
+		/// </summary>
+		void RunLoaderBenchmark( Runner &runner, const char *pccName, uint32_t unLoaderThreads, uint32_t unModels )
+		{
+			oxr::test::RenderSession session;
+			if ( !InitLoadSession( runner, pccName, session, unLoaderThreads, "" ) )
+				return;
+
+			xrvk::Render *pRender = session.pRender.get();
+			const VkDevice vkDevice = pRender->GetSharedState()->vkDevice;
+
+			std::vector< std::string > vecFilenames;
+			for ( uint32_t i = 0; i < unModels; i++ )
+				vecFilenames.push_back( i % 2 ? "models/Box.glb" : "models/floor_spot.glb" );
+
+			std::unique_ptr< vkglTF::Model[] > pModels( new vkglTF::Model[ unModels ] );
+			auto DestroyModels = [ & ]( uint32_t )
+			{
+				for ( uint32_t i = 0; i < unModels; i++ )
+					pModels[ i ].destroy( vkDevice );
+			};
+
+			const Params params = { { "models", ( double )unModels }, { "loader_threads", ( double )pRender->GetAssetLoader()->GetThreadCount() } };
+			runner.Run( pccName, params, DestroyModels, [ & ]( uint32_t ) { LoadModels( pRender, vecFilenames, pModels.get() ); } );
+
+			DestroyModels( 0 );
+		}
+
+		/// <summary>
+		/// Times loading DamagedHelmet with an empty mesh cache (parse, then write the cache) or from a cache written before the benchmark
+		/// </summary>
+		void RunMeshCacheBenchmark( Runner &runner, const char *pccName, bool bWarm )
+		{
+			const std::vector< std::string > vecFilenames { "models/DamagedHelmet.glb" };
+			if ( !std::filesystem::exists( vecFilenames[ 0 ] ) )
+			{
+				runner.Skip( pccName, "model file not found" );
+				return;
+			}
+
+			std::error_code ec;
+			const std::string sMeshCacheDirectory = "bench_mesh_cache";
+			auto ClearCache = [ & ]()
+			{
+				std::filesystem::remove_all( sMeshCacheDirectory, ec );
+				std::filesystem::create_directories( sMeshCacheDirectory, ec );
+			};
+
+			ClearCache();
+
+			oxr::test::RenderSession session;
+			if ( !InitLoadSession( runner, pccName, session, 0, sMeshCacheDirectory ) )
+				return;
+
+			xrvk::Render *pRender = session.pRender.get();
+			const VkDevice vkDevice = pRender->GetSharedState()->vkDevice;
+
+			// (1) First load writes the cache, the second has to read from it
+			vkglTF::Model model;
+			LoadModels( pRender, vecFilenames, &model );
+			model.destroy( vkDevice );
+
+			const bool bFromCache = LoadModels( pRender, vecFilenames, &model )->bFromCache;
+			model.destroy( vkDevice );
+
+			if ( !bFromCache )
+			{
+				runner.Skip( pccName, "mesh cache not written" );
+				return;
+			}
+
+			// (2) Cold loads start from an empty cache every iteration
+			auto Prepare = [ & ]( uint32_t )
+			{
+				model.destroy( vkDevice );
+				if ( !bWarm )
+					ClearCache();
+			};
+
+			const Params params = { { "from_cache", bWarm ? 1.0 : 0.0 } };
+			runner.Run( pccName, params, Prepare, [ & ]( uint32_t ) { LoadModels( pRender, vecFilenames, &model ); } );
+
+			model.destroy( vkDevice );
+		}
+	} // namespace
+
+	void RunRenderBenchmarks( Runner &runner )
+	{
+		const std::pair< const char *, uint32_t > arrInstanceBenchmarks[] = {
+			{ "render/instances_1", 1 }, { "render/instances_100", 100 }, { "render/instances_1000", 1000 } };
+
+		const std::pair< const char *, uint32_t > arrLoaderBenchmarks[] = {
+			{ "render/load_models_threads_0", 0 }, { "render/load_models_threads_1", 1 }, { "render/load_models_threads_2", 2 }, { "render/load_models_threads_4", 4 } };
+
+		const std::pair< const char *, uint32_t > arrRecordingBenchmarks[] = {
+			{ "render/recording_threads_0", 0 }, { "render/recording_threads_1", 1 }, { "render/recording_threads_2", 2 }, { "render/recording_threads_4", 4 } };
+
+		if ( !runner.IsAnyEnabled( { "render/instances_1", "render/instances_100", "render/instances_1000", "render/recording_threads_0", "render/recording_threads_1",
+									 "render/recording_threads_2", "render/recording_threads_4", "render/draw_list_helmet", "render/draw_list_nodes_10000",
+									 "render/load_models_threads_0", "render/load_models_threads_1", "render/load_models_threads_2", "render/load_models_threads_4",
+									 "render/mesh_cache_cold", "render/mesh_cache_warm" } ) )
+			return;
+
+		// Assets are loaded relative to the working directory, the json report is still written relative to the one we started in
+		std::error_code ec;
+		const std::filesystem::path startDirectory = std::filesystem::current_path( ec );
+		if ( !oxr::test::PrepareRenderTest() )
+		{
+			runner.Skip( "render/", "render test assets directory not found" );
+			return;
+		}
+
+		// (1) Instanced models
+		for ( auto &benchmark : arrInstanceBenchmarks )
+		{
+			if ( runner.IsEnabled( benchmark.first ) )
+				RunInstanceBenchmark( runner, benchmark.first, benchmark.second );
+		}
+
+		// (2) Parallel recording of --models scenes
+		for ( auto &benchmark : arrRecordingBenchmarks )
+		{
+			if ( runner.IsEnabled( benchmark.first ) )
+				RunRecordingBenchmark( runner, benchmark.first, benchmark.second, std::max( runner.GetOptions().unModels, 1u ) );
+		}
+
+		// (3) Draw lists of a textured pbr model and of a scene with many mesh nodes
+		if ( runner.IsEnabled( "render/draw_list_helmet" ) )
+			RunDrawListBenchmark( runner, "render/draw_list_helmet", "models/DamagedHelmet.glb", { 0.3f, 0.3f, 0.3f }, { 0.0f, 0.0f, -1.5f } );
+
+		if ( runner.IsEnabled( "render/draw_list_nodes_10000" ) )
+		{
+			const std::string sNodesScene = "models/bench_nodes_10000.gltf";
+			if ( WriteNodeGridScene( sNodesScene, "bench_nodes_10000.bin", k_unDrawListNodes ) )
+				RunDrawListBenchmark( runner, "render/draw_list_nodes_10000", sNodesScene, { 1.0f, 1.0f, 1.0f }, { 0.0f, 0.0f, 0.0f } );
+			else
+				runner.Skip( "render/draw_list_nodes_10000", "unable to write the generated scene" );
+		}
+
+		// (4) Loading --models models on a fixed number of loader threads, 0 sizes the pool to the hardware threads
+		for ( auto &benchmark : arrLoaderBenchmarks )
+		{
+			if ( runner.IsEnabled( benchmark.first ) )
+				RunLoaderBenchmark( runner, benchmark.first, benchmark.second, std::max( runner.GetOptions().unModels, 1u ) );
+		}
+
+		// (5) Loading from the source file and from the mesh cache
+		if ( runner.IsEnabled( "render/mesh_cache_cold" ) )
+			RunMeshCacheBenchmark( runner, "render/mesh_cache_cold", false );
+
+		if ( runner.IsEnabled( "render/mesh_cache_warm" ) )
+			RunMeshCacheBenchmark( runner, "render/mesh_cache_warm", true );
+
+		std::filesystem::current_path( startDirectory, ec );
+	}
+
+} // namespace oxr::bench
@@ -0,0 +1,76 @@
+# OPENXR PROVIDER v2 - SHADER VARIANTS
+# Builds the SPIR-V for the renderer's optional shader variants (multiview, bindless, instanced) that live in openxr_provider/shaders.
+# The base shaders (pbr.vert, pbr_khr.frag, ...) ship precompiled in each app's assets/shaders directory and are not rebuilt here.
+#
+# Usage (from an app's CMakeLists.txt, after the app target is defined):
+#   include("${PROVIDER_DIRECTORY}/cmake/xrvk_shaders.cmake")
+#   xrvk_compile_shaders(TARGET ${XR_PROJECT} OUTPUT_DIRECTORY "${APP_SHADERS_DIRECTORY}")
+#
+# The .spv files are written next to the app's other shaders so the existing post-build copies (and android asset packaging)
+# pick them up. If no glsl compiler is found, a warning is printed and the renderer falls back to the paths that only need the
+# base shaders - xrvk checks that each variant's .spv is present before enabling the feature that uses it.
+
+include_guard(GLOBAL)
+
+# Cached so apps in sibling directories see them after the first include
+get_filename_component(XRVK_SHADERS_DIRECTORY "${CMAKE_CURRENT_LIST_DIR}/../shaders" ABSOLUTE)
+set(XRVK_SHADERS_DIRECTORY "${XRVK_SHADERS_DIRECTORY}" CACHE INTERNAL "Provider shader variant sources")
+
+# Prefer the validator shipped with the Vulkan SDK (FindVulkan only reports it from cmake 3.19 onwards)
+if(Vulkan_GLSLANG_VALIDATOR_EXECUTABLE)
+    get_filename_component(XRVK_GLSLANG_HINT "${Vulkan_GLSLANG_VALIDATOR_EXECUTABLE}" DIRECTORY)
+endif()
+
+find_program(XRVK_GLSLANG_VALIDATOR NAMES glslangValidator glslang
+             HINTS ${XRVK_GLSLANG_HINT} "$ENV{VULKAN_SDK}/bin" "$ENV{VULKAN_SDK}/Bin")
+
+if(XRVK_GLSLANG_VALIDATOR)
+    message(STATUS "[xrvk] Shader variants will be compiled with: ${XRVK_GLSLANG_VALIDATOR}")
+else()
+    message(WARNING "[xrvk] glslangValidator not found (install the Vulkan SDK or set VULKAN_SDK). "
+                    "Multiview, bindless and instanced rendering are disabled at runtime, and shape batches (used by the finger painting samples) draw one instance at a time, "
+                    "unless their .spv files are already in the app's shaders directory.")
+endif()
+
+# xrvk_compile_shaders(TARGET <target> OUTPUT_DIRECTORY <dir> [SOURCES <glsl>...])
+#   TARGET           - target that needs the shaders, compilation runs before it is built
+#   OUTPUT_DIRECTORY - directory the .spv files are written to, named <source file name>.spv (e.g. pbr_multiview.vert.spv)
+#   SOURCES          - glsl sources to compile, defaults to every shader in openxr_provider/shaders
+function(xrvk_compile_shaders)
+    cmake_parse_arguments(XRVK "" "TARGET;OUTPUT_DIRECTORY" "SOURCES" ${ARGN})
+
+    if(NOT XRVK_TARGET OR NOT XRVK_OUTPUT_DIRECTORY)
+        message(FATAL_ERROR "[xrvk] xrvk_compile_shaders requires TARGET and OUTPUT_DIRECTORY")
+    endif()
+
+    if(NOT XRVK_GLSLANG_VALIDATOR)
+        return()
+    endif()
+
+    if(NOT XRVK_SOURCES)
+        file(GLOB XRVK_SOURCES
+            "${XRVK_SHADERS_DIRECTORY}/*.vert"
+            "${XRVK_SHADERS_DIRECTORY}/*.frag"
+            "${XRVK_SHADERS_DIRECTORY}/*.comp")
+    endif()
+
+    set(XRVK_OUTPUTS "")
+    foreach(XRVK_SOURCE ${XRVK_SOURCES})
+        get_filename_component(XRVK_SOURCE_NAME "${XRVK_SOURCE}" NAME)
+        set(XRVK_OUTPUT "${XRVK_OUTPUT_DIRECTORY}/${XRVK_SOURCE_NAME}.spv")
+
+        add_custom_command(
+            OUTPUT "${XRVK_OUTPUT}"
+            COMMAND ${CMAKE_COMMAND} -E make_directory "${XRVK_OUTPUT_DIRECTORY}"
+            COMMAND "${XRVK_GLSLANG_VALIDATOR}" -V --target-env vulkan1.1 -o "${XRVK_OUTPUT}" "${XRVK_SOURCE}"
+            DEPENDS "${XRVK_SOURCE}"
+            COMMENT "[xrvk] Compiling ${XRVK_SOURCE_NAME}"
+            VERBATIM)
+
+        list(APPEND XRVK_OUTPUTS "${XRVK_OUTPUT}")
+    endforeach()
+
+    add_custom_target(${XRVK_TARGET}_shaders DEPENDS ${XRVK_OUTPUTS} SOURCES ${XRVK_SOURCES})
+    set_target_properties(${XRVK_TARGET}_shaders PROPERTIES FOLDER "Shaders")
+    add_dependencies(${XRVK_TARGET} ${XRVK_TARGET}_shaders)
+endfunction()
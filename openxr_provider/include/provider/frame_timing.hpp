@@ -0,0 +1,247 @@
+/* Copyright 2021, 2022, 2023 Rune Berg (GitHub: https://github.com/1runeberg, Twitter: https://twitter.com/1runeberg, YouTube: https://www.youtube.com/@1RuneBerg)
+ *
+ *  SPDX-License-Identifier: MIT
+ *
+ *  Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+ *
+ *  2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *
+ *  3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote products derived from this
+ *     software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ *  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+ *  BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ *  GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+ *  DAMAGE.
+ *
+ */
+
+#pragma once
+#include "common.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <deque>
+
+#define LOG_CATEGORY_FRAMETIMING "OpenXRProvider-FrameTiming"
+
+namespace oxr
+{
+	// Default number of frame records kept in the frame timing ring
+	static const uint32_t k_unFrameTimingCapacity = 256;
+
+	// Maximum number of swapchains or render passes timed per frame
+	static const uint32_t k_unFrameTimingSlots = 4;
+
+	// Cpu stages timed in each frame. Swapchain stages are timed per swapchain, render stages per render pass (e.g. per eye)
+	enum class EFrameStage : uint32_t
+	{
+		WaitFrame = 0,
+		BeginFrame = 1,
+		AcquireImage = 2,
+		WaitImage = 3,
+		ReleaseImage = 4,
+		RecordCommands = 5,
+		QueueSubmit = 6,
+		EndFrame = 7,
+		EMax
+	};
+
+	// Begin and end of a timed stage in nanoseconds (steady clock), both zero if the stage didn't run this frame
+	struct FrameStageTime
+	{
+		int64_t nBeginNs = 0;
+		int64_t nEndNs = 0;
+	};
+
+	// Timing of a single frame
+	struct FrameTimingRecord
+	{
+		// Incremented for every frame begun by the session
+		uint64_t unFrameIndex = 0;
+
+		// Display time and period predicted by the runtime for this frame
+		XrTime xrPredictedDisplayTime = 0;
+		XrDuration xrPredictedDisplayPeriod = 0;
+
+		// Time between the predicted display times of the previous frame and this one, i.e. the period actually achieved
+		XrDuration xrActualDisplayPeriod = 0;
+
+		// Cpu stages, indexed by stage then by swapchain or render pass
+		FrameStageTime stages[ ( uint32_t )EFrameStage::EMax ][ k_unFrameTimingSlots ] {};
+
+		// Gpu time of each render pass from timestamp queries, zero if not available
+		float fGpuPassMs[ k_unFrameTimingSlots ] {};
+		uint32_t unGpuPasses = 0;
+
+		const FrameStageTime &GetStage( EFrameStage eStage, uint32_t unSlot = 0 ) const { return stages[ ( uint32_t )eStage ][ unSlot ]; }
+		float GetStageMs( EFrameStage eStage, uint32_t unSlot = 0 ) const { return ( GetStage( eStage, unSlot ).nEndNs - GetStage( eStage, unSlot ).nBeginNs ) / 1000000.0f; }
+	};
+
+	// Per frame timing records in a lock-free ring. The render thread fills and publishes records, any other thread can pull them.
+	// Disabled by default, in which case timing calls return right away
+	class FrameTiming
+	{
+	  public:
+		/// <summary>
+		/// Creates the frame timing ring
+		/// </summary>
+		/// <param name="unCapacity">Number of frame records kept before the oldest unread ones are overwritten</param>
+		FrameTiming( uint32_t unCapacity = k_unFrameTimingCapacity );
+		~FrameTiming() {}
+
+		/// <summary>
+		/// Enables or disables frame timing. Takes effect from the next frame
+		/// </summary>
+		/// <param name="bEnabled">Whether to record frame timings</param>
+		void SetEnabled( bool bEnabled ) { m_bEnabled.store( bEnabled, std::memory_order_relaxed ); }
+
+		/// <summary>
+		/// Checks whether frame timings are recorded
+		/// </summary>
+		/// <returns>True if frame timings are recorded</returns>
+		bool IsEnabled() const { return m_bEnabled.load( std::memory_order_relaxed ); }
+
+		/// <summary>
+		/// Checks whether the current frame is being timed - timing calls outside of a timed frame are ignored
+		/// </summary>
+		/// <returns>True if a frame record is open</returns>
+		bool IsTimingFrame() const { return m_bFrameOpen; }
+
+		/// <summary>
+		/// Current time in nanoseconds, from the clock used for all stage timings
+		/// </summary>
+		/// <returns>Steady clock time in nanoseconds</returns>
+		static int64_t Now() { return std::chrono::duration_cast< std::chrono::nanoseconds >( std::chrono::steady_clock::now().time_since_epoch() ).count(); }
+
+		/// <summary>
+		/// Opens the record of a new frame (render thread). Does nothing if frame timing is disabled
+		/// </summary>
+		/// <param name="xrPredictedDisplayTime">Display time predicted by the runtime for this frame</param>
+		/// <param name="xrPredictedDisplayPeriod">Display period predicted by the runtime for this frame</param>
+		void BeginFrame( XrTime xrPredictedDisplayTime, XrDuration xrPredictedDisplayPeriod );
+
+		/// <summary>
+		/// Closes the current frame record (render thread). It's published once the gpu timings of its passes can have been resolved
+		/// </summary>
+		void EndFrame();
+
+		/// <summary>
+		/// Index of the frame being timed, used to attach gpu timings resolved in later frames
+		/// </summary>
+		/// <returns>Index of the frame being timed</returns>
+		uint64_t GetCurrentFrameIndex() const { return m_currentRecord.unFrameIndex; }
+
+		/// <summary>
+		/// Marks the start of a stage in the current frame
+		/// </summary>
+		/// <param name="eStage">Stage to time</param>
+		/// <param name="unSlot">Swapchain or render pass index</param>
+		inline void MarkBegin( EFrameStage eStage, uint32_t unSlot = 0 )
+		{
+			if ( m_bFrameOpen && unSlot < k_unFrameTimingSlots )
+				m_currentRecord.stages[ ( uint32_t )eStage ][ unSlot ].nBeginNs = Now();
+		}
+
+		/// <summary>
+		/// Marks the end of a stage in the current frame
+		/// </summary>
+		/// <param name="eStage">Stage to time</param>
+		/// <param name="unSlot">Swapchain or render pass index</param>
+		inline void MarkEnd( EFrameStage eStage, uint32_t unSlot = 0 )
+		{
+			if ( m_bFrameOpen && unSlot < k_unFrameTimingSlots )
+				m_currentRecord.stages[ ( uint32_t )eStage ][ unSlot ].nEndNs = Now();
+		}
+
+		/// <summary>
+		/// Sets a stage timed elsewhere (e.g. xrWaitFrame and xrBeginFrame on the frame pacing thread) in the current frame
+		/// </summary>
+		/// <param name="eStage">Stage that was timed</param>
+		/// <param name="unSlot">Swapchain or render pass index</param>
+		/// <param name="stageTime">Begin and end of the stage</param>
+		void SetStage( EFrameStage eStage, uint32_t unSlot, FrameStageTime stageTime );
+
+		/// <summary>
+		/// Sets how many frames gpu timings lag behind their frame (render thread). Records are held back for this many frames before they're published
+		/// </summary>
+		/// <param name="unFrames">Number of frames until a frame's gpu timestamps are resolved, zero if there are no gpu timings</param>
+		void SetGpuLatency( uint32_t unFrames ) { m_unGpuLatency = unFrames; }
+
+		/// <summary>
+		/// Adds the gpu time of a render pass to the record of the frame it was rendered in, if that record hasn't been published yet (render thread)
+		/// </summary>
+		/// <param name="unFrameIndex">Frame the render pass belongs to</param>
+		/// <param name="unPass">Render pass index in its frame</param>
+		/// <param name="fMs">Gpu time of the render pass in milliseconds</param>
+		void SetGpuPassTime( uint64_t unFrameIndex, uint32_t unPass, float fMs );
+
+		/// <summary>
+		/// Retrieves the records published since the last pull (single consumer). Records overwritten before they were pulled are skipped
+		/// </summary>
+		/// <param name="outRecords">Output parameter the new records are appended to, oldest first</param>
+		/// <returns>Number of records appended</returns>
+		uint32_t Pull( std::vector< FrameTimingRecord > &outRecords );
+
+		/// <summary>
+		/// Copies all records currently in the ring without consuming them
+		/// </summary>
+		/// <param name="outRecords">Output parameter the records are appended to, oldest first</param>
+		/// <returns>Number of records appended</returns>
+		uint32_t Snapshot( std::vector< FrameTimingRecord > &outRecords );
+
+		/// <summary>
+		/// Writes the records currently in the ring to a csv file, one row per frame with stage durations in milliseconds
+		/// </summary>
+		/// <param name="sFilename">Path of the csv file to write</param>
+		/// <returns>True if the file was written</returns>
+		bool DumpCsv( const std::string &sFilename );
+
+		/// <summary>
+		/// Writes the records currently in the ring as a chrome trace (chrome://tracing, perfetto), one track per stage and slot
+		/// </summary>
+		/// <param name="sFilename">Path of the json file to write</param>
+		/// <returns>True if the file was written</returns>
+		bool DumpChromeTrace( const std::string &sFilename );
+
+		/// <summary>
+		/// Human readable name of a stage
+		/// </summary>
+		/// <param name="eStage">The stage</param>
+		/// <returns>Name of the stage</returns>
+		static const char *GetStageName( EFrameStage eStage );
+
+	  private:
+		// Ring slot - the sequence is odd while the record is written and 2 * (index + 1) once record (index) is published
+		struct Slot
+		{
+			std::atomic< uint64_t > unSequence { 0 };
+			FrameTimingRecord record;
+		};
+
+		std::atomic< bool > m_bEnabled { false };
+
+		// Ring of published records
+		std::unique_ptr< Slot[] > m_pSlots;
+		uint32_t m_unCapacity = 0;
+		std::atomic< uint64_t > m_unPublished { 0 };
+		std::atomic< uint64_t > m_unPulled { 0 };
+
+		// Render thread only - the frame being timed and closed frames waiting for their gpu timings
+		FrameTimingRecord m_currentRecord;
+		bool m_bFrameOpen = false;
+		uint64_t m_unNextFrameIndex = 0;
+		XrTime m_xrLastDisplayTime = 0;
+		uint32_t m_unGpuLatency = 0;
+		std::deque< FrameTimingRecord > m_deqPending;
+
+		void Publish( const FrameTimingRecord &record );
+		bool Read( uint64_t unIndex, FrameTimingRecord *outRecord );
+	};
+
+} // namespace oxr
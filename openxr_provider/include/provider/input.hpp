@@ -24,7 +24,11 @@
 #pragma once
 #include "common.hpp"
 #include "interaction_profiles.hpp"
+#include <atomic>
+#include <condition_variable>
 #include <map>
+#include <mutex>
+#include <thread>
 
 namespace oxr
 {
@@ -55,8 +59,9 @@ namespace oxr
 		// function will be called when the action is triggered
 		Callback_InputAction pfnCallback;
 
-		// mutex for multi-threading locks
-		std::mutex mutexActionState;
+		// first index of this action's states in action state snapshots, assigned when its actionset is added for sync.
+		// Read by threads holding a snapshot while the input thread may assign it to an action created later, so it's atomic
+		std::atomic< uint32_t > unSnapshotSlot { UINT32_MAX };
 
 		// all possible actionset forms
 		union ActionState
@@ -68,9 +73,22 @@ namespace oxr
 		};
 
 		// actionstate related to this action - this is a vector representing number of subpaths
-		// if there are none, use index 0
+		// if there are none, use index 0. These are written in place during input processing, so only read them
+		// from action callbacks - other threads should read an action state snapshot (Input::AcquireActionStates).
+		// With deferred callback dispatch or in event mode, these hold the states as of the last dispatched callback
 		std::vector< ActionState > vecActionStates;
 
+		// latest actionstate read from the runtime, owned by the thread processing input
+		std::vector< ActionState > vecSyncedActionStates;
+
+		// last state sent to the input event queue, per subaction path
+		std::vector< XrBool32 > vecEventIsActive;
+		std::vector< XrVector2f > vecEventValues;
+
+		// number of the last deferred pose callback queued, per subaction path - 0 if none. Compared against the dispatched callback
+		// count so a pose isn't queued again while the previous one is still waiting for DispatchCallbacks
+		std::vector< uint64_t > vecQueuedPoseCallbacks;
+
 		// the subpaths for this action, empty if none
 		std::vector< XrPath > vecSubactionpaths;
 
@@ -183,6 +201,252 @@ namespace oxr
 		}
 	};
 
+	// Number of action state snapshot buffers - the published one, the one being written and one a reader may still hold
+	static const uint32_t k_unActionStateSnapshots = 3;
+
+	/// <summary>
+	/// Immutable copy of the action states of all active actionsets, taken at one input sync.
+	/// States are held in contiguous arrays with one element per action subaction path, starting at Action::unSnapshotSlot
+	/// </summary>
+	struct ActionStateSnapshot
+	{
+		// Predicted display time of the session when the actions were synced
+		XrTime xrSyncTime = 0;
+
+		// Number of snapshots published before this one
+		uint64_t unSyncIndex = 0;
+
+		// Per action subaction path state
+		std::vector< XrBool32 > vecIsActive;
+		std::vector< XrBool32 > vecChangedSinceLastSync;
+		std::vector< XrTime > vecLastChangeTime;
+
+		// Current value - boolean (0 or 1) and float states are held in x, pose actions have no value
+		std::vector< XrVector2f > vecValues;
+
+		/// <summary>
+		/// Retrieves the index of an action's state in this snapshot
+		/// </summary>
+		/// <param name="pAction">Action to look up</param>
+		/// <param name="unActionStateIndex">Index for the subaction path, use 0 if none</param>
+		/// <returns>Index into the state arrays, UINT32_MAX if the action wasn't synced when this snapshot was taken</returns>
+		uint32_t GetSlot( const Action *pAction, uint32_t unActionStateIndex = 0 ) const
+		{
+			uint32_t unSnapshotSlot = pAction->unSnapshotSlot.load( std::memory_order_acquire );
+			if ( unSnapshotSlot == UINT32_MAX || unSnapshotSlot + unActionStateIndex >= vecIsActive.size() )
+				return UINT32_MAX;
+
+			return unSnapshotSlot + unActionStateIndex;
+		}
+
+		bool IsActive( const Action *pAction, uint32_t unActionStateIndex = 0 ) const
+		{
+			uint32_t unSlot = GetSlot( pAction, unActionStateIndex );
+			return unSlot != UINT32_MAX && vecIsActive[ unSlot ];
+		}
+
+		bool ChangedSinceLastSync( const Action *pAction, uint32_t unActionStateIndex = 0 ) const
+		{
+			uint32_t unSlot = GetSlot( pAction, unActionStateIndex );
+			return unSlot != UINT32_MAX && vecChangedSinceLastSync[ unSlot ];
+		}
+
+		bool GetBoolean( const Action *pAction, uint32_t unActionStateIndex = 0 ) const { return GetVector2f( pAction, unActionStateIndex ).x != 0.0f; }
+
+		float GetFloat( const Action *pAction, uint32_t unActionStateIndex = 0 ) const { return GetVector2f( pAction, unActionStateIndex ).x; }
+
+		XrVector2f GetVector2f( const Action *pAction, uint32_t unActionStateIndex = 0 ) const
+		{
+			uint32_t unSlot = GetSlot( pAction, unActionStateIndex );
+			return unSlot == UINT32_MAX ? XrVector2f { 0.0f, 0.0f } : vecValues[ unSlot ];
+		}
+	};
+
+	/// <summary>
+	/// Reader handle to a published action state snapshot. The snapshot isn't reused by the input thread while
+	/// a handle to it is held, so keep it only for as long as needed (e.g. one frame)
+	/// </summary>
+	class ActionStateSnapshotRef
+	{
+	  public:
+		ActionStateSnapshotRef() {}
+		ActionStateSnapshotRef( const ActionStateSnapshot *pSnapshot, std::atomic< uint32_t > *pReaders )
+			: m_pSnapshot( pSnapshot )
+			, m_pReaders( pReaders )
+		{
+		}
+
+		ActionStateSnapshotRef( ActionStateSnapshotRef &&other ) noexcept { *this = std::move( other ); }
+
+		ActionStateSnapshotRef &operator=( ActionStateSnapshotRef &&other ) noexcept
+		{
+			if ( this != &other )
+			{
+				Release();
+				std::swap( m_pSnapshot, other.m_pSnapshot );
+				std::swap( m_pReaders, other.m_pReaders );
+			}
+
+			return *this;
+		}
+
+		ActionStateSnapshotRef( const ActionStateSnapshotRef & ) = delete;
+		ActionStateSnapshotRef &operator=( const ActionStateSnapshotRef & ) = delete;
+
+		~ActionStateSnapshotRef() { Release(); }
+
+		/// <summary>
+		/// Releases the snapshot back to the input thread
+		/// </summary>
+		void Release()
+		{
+			if ( m_pReaders )
+				m_pReaders->fetch_sub( 1, std::memory_order_release );
+
+			m_pSnapshot = nullptr;
+			m_pReaders = nullptr;
+		}
+
+		bool IsValid() const { return m_pSnapshot != nullptr; }
+		const ActionStateSnapshot *operator->() const { return m_pSnapshot; }
+		const ActionStateSnapshot &operator*() const { return *m_pSnapshot; }
+
+	  private:
+		const ActionStateSnapshot *m_pSnapshot = nullptr;
+		std::atomic< uint32_t > *m_pReaders = nullptr;
+	};
+
+	// Where action callbacks are called when input is processed by the input thread
+	enum class EInputCallbackDispatch
+	{
+		// Called on the input thread during the sync
+		InputThread = 0,
+
+		// Queued and called on the thread that calls Input::DispatchCallbacks
+		Deferred = 1
+	};
+
+	// Capacity of the deferred callback queue - callbacks are dropped while it is full
+	static const uint32_t k_unInputCallbackQueueSize = 1024;
+
+	// Default capacity of the input event queue - changes that find it full are sent again on the next sync
+	static const uint32_t k_unInputEventQueueSize = 4096;
+
+	/// <summary>
+	/// Fixed capacity, lock free ring for one producer thread and one consumer thread. Pushes fail while the ring is full
+	/// </summary>
+	template < typename T > class SpscRing
+	{
+	  public:
+		/// <summary>
+		/// Allocates the ring, rounding the capacity up to a power of two. Only call while neither thread uses the ring
+		/// </summary>
+		void Allocate( uint32_t unCapacity )
+		{
+			uint32_t unSize = 1;
+			while ( unSize < unCapacity )
+				unSize <<= 1;
+
+			m_vecItems.clear();
+			m_vecItems.resize( unSize );
+			m_unHead = 0;
+			m_unTail = 0;
+		}
+
+		bool IsAllocated() const { return !m_vecItems.empty(); }
+
+		bool Push( const T &item )
+		{
+			uint32_t unTail = m_unTail.load( std::memory_order_relaxed );
+			if ( m_vecItems.empty() || unTail - m_unHead.load( std::memory_order_acquire ) >= m_vecItems.size() )
+				return false;
+
+			m_vecItems[ unTail & ( m_vecItems.size() - 1 ) ] = item;
+			m_unTail.store( unTail + 1, std::memory_order_release );
+			return true;
+		}
+
+		bool Pop( T &outItem )
+		{
+			uint32_t unHead = m_unHead.load( std::memory_order_relaxed );
+			if ( unHead == m_unTail.load( std::memory_order_acquire ) )
+				return false;
+
+			outItem = m_vecItems[ unHead & ( m_vecItems.size() - 1 ) ];
+			m_unHead.store( unHead + 1, std::memory_order_release );
+			return true;
+		}
+
+	  private:
+		std::vector< T > m_vecItems;
+		std::atomic< uint32_t > m_unHead { 0 };
+		std::atomic< uint32_t > m_unTail { 0 };
+	};
+
+	// Type of an input event
+	enum class EInputEventType
+	{
+		// Boolean action changed state (edge) or availability
+		Boolean = 0,
+
+		// Float action moved past the event epsilon or changed availability
+		Float = 1,
+
+		// Vector2f action moved past the event epsilon or changed availability
+		Vector2f = 2,
+
+		// Pose action became active or inactive
+		PoseValidity = 3
+	};
+
+	/// <summary>
+	/// Compact input event, emitted during input sync when the event queue is enabled
+	/// </summary>
+	struct InputEvent
+	{
+		EInputEventType eType = EInputEventType::Boolean;
+
+		// Action and subaction path index the event is for
+		Action *pAction = nullptr;
+		uint32_t unActionStateIndex = 0;
+
+		// Whether the action is active after this event
+		XrBool32 bIsActive = XR_FALSE;
+
+		// New value after the deadzone is applied - boolean (0 or 1) and float values are held in x
+		XrVector2f value { 0.0f, 0.0f };
+
+		// Time of the change as reported by the runtime - the sync's predicted display time for poses
+		XrTime xrTime = 0;
+	};
+
+	// Number of ProcessInput durations kept for latency percentiles
+	static const uint32_t k_unInputLatencySamples = 256;
+
+	/// <summary>
+	/// Input thread statistics
+	/// </summary>
+	struct InputThreadStats
+	{
+		// Threads created for input processing over the lifetime of this Input object
+		uint32_t unThreadsCreated = 0;
+
+		// ProcessInput calls made so far
+		uint64_t unProcessedFrames = 0;
+
+		// Deferred callbacks dropped because the queue was full
+		uint64_t unDroppedCallbacks = 0;
+
+		// Input events that found the event queue full - the change is sent again on the next sync
+		uint64_t unDroppedEvents = 0;
+
+		// ProcessInput latency over the last k_unInputLatencySamples calls, in milliseconds
+		float fLatencyP50Ms = 0.0f;
+		float fLatencyP95Ms = 0.0f;
+		float fLatencyP99Ms = 0.0f;
+		float fLatencyMaxMs = 0.0f;
+	};
+
 	class Session;
 
 	/// <summary>
@@ -280,7 +544,7 @@ namespace oxr
 		XrResult SuggestBindings( Controller *controller, void *pOtherInfo );
 
 		/// <summary>
-		/// Converts a given c++ string to an openxr path/handle
+		/// Converts a given c++ string to an openxr path/handle. Strings are interned, so only the first conversion of a string goes to the runtime
 		/// </summary>
 		/// <param name="string">The string to convert</param>
 		/// <param name="xrPath">Out arameter - XrPath</param>
@@ -296,7 +560,7 @@ namespace oxr
 		XrResult XrPathToString( std::string &outString, XrPath *xrPath );
 
 		/// <summary>
-		/// Adds an actionset for the next input sync with the runtime
+		/// Adds an actionset for the next input sync with the runtime - call before StartInputThread()
 		/// </summary>
 		/// <param name="pActionSet">Pointer to the actionset struct to add for the sync</param>
 		/// <param name="subpath">Optional subpath (e.g. "/user/hand/left")</param>
@@ -320,7 +584,8 @@ namespace oxr
 		XrResult AttachActionSetsToSession( XrActionSet *arrActionSets, uint32_t unActionSetCount );
 
 		/// <summary>
-		/// Processes all input and calls action callback if triggered during input frame - can be safely run in a separate thread
+		/// Processes all input and calls action callback if triggered during input frame - can be safely run in a separate thread.
+		/// Publishes a new action state snapshot once all states are updated
 		/// </summary>
 		/// <returns>Any result from the input check loop the runtime</returns>
 		XrResult ProcessInput();
@@ -336,7 +601,89 @@ namespace oxr
 		XrResult GetActionPose( XrSpaceLocation *outSpaceLocation, Action *pAction, uint32_t unSpaceIndex, XrTime xrTime );
 
 		/// <summary>
-		/// Retrieves the actionstate of an action in the current input frame
+		/// Starts a long lived input thread that calls ProcessInput, replacing a thread per frame (e.g. std::async) in the app's frame loop.
+		/// Start once the session is focused and stop on STOPPING. Don't add or remove actionsets for sync while the thread is running.
+		/// </summary>
+		/// <param name="fPollRateHz">Input processing rate - 0 to process once per RequestInput() call (e.g. once per frame), or a fixed rate for low latency polling</param>
+		/// <param name="eCallbackDispatch">Whether action callbacks are called on the input thread, or queued for DispatchCallbacks()</param>
+		/// <returns>Result of starting the input thread</returns>
+		XrResult StartInputThread( float fPollRateHz = 0.0f, EInputCallbackDispatch eCallbackDispatch = EInputCallbackDispatch::InputThread );
+
+		/// <summary>
+		/// Stops the input thread, waiting for any input processing in progress to finish. Queued callbacks remain available to DispatchCallbacks()
+		/// </summary>
+		void StopInputThread();
+
+		/// <summary>
+		/// Checks whether the input thread is running
+		/// </summary>
+		/// <returns>True if input is processed by the input thread</returns>
+		bool IsInputThreadActive() { return m_bInputThreadActive; }
+
+		/// <summary>
+		/// Wakes the input thread to process input once - call once per frame. Requests made while input is being processed are merged.
+		/// Not needed when polling at a fixed rate
+		/// </summary>
+		void RequestInput();
+
+		/// <summary>
+		/// Calls the action callbacks queued by the input thread (deferred callback dispatch) on the calling thread.
+		/// Call from one thread only
+		/// </summary>
+		/// <returns>Number of callbacks called</returns>
+		uint32_t DispatchCallbacks();
+
+		/// <summary>
+		/// Switches input to event mode - instead of calling action callbacks, each sync emits typed events for actions whose state changed
+		/// into a preallocated queue that the app drains at its own point in the frame (DrainEvents), or dispatches to the action callbacks (DispatchEvents).
+		/// Float and vector2f values inside the deadzone read as zero and only emit an event once they move more than the epsilon since the last event.
+		/// Pose actions only emit an event when they become active or inactive. Only call while input isn't being processed (e.g. before starting the input thread)
+		/// </summary>
+		/// <param name="fEpsilon">Minimum change in a float or vector2f value (vector length) to emit an event</param>
+		/// <param name="fDeadzone">Values (vector length) below this are treated as zero</param>
+		/// <param name="unCapacity">Number of events the queue can hold, rounded up to a power of two</param>
+		void EnableEventQueue( float fEpsilon = 0.01f, float fDeadzone = 0.0f, uint32_t unCapacity = k_unInputEventQueueSize );
+
+		/// <summary>
+		/// Switches input back to calling action callbacks during sync. Events still in the queue can be drained afterwards
+		/// </summary>
+		void DisableEventQueue() { m_bEventQueueEnabled = false; }
+
+		/// <summary>
+		/// Checks whether input is in event mode
+		/// </summary>
+		/// <returns>True if syncs emit input events instead of calling action callbacks</returns>
+		bool IsEventQueueEnabled() { return m_bEventQueueEnabled; }
+
+		/// <summary>
+		/// Moves all queued input events, oldest first, to the provided vector. Call from one thread only
+		/// </summary>
+		/// <param name="outEvents">Out parameter - events are appended to this vector</param>
+		/// <returns>Number of events drained</returns>
+		uint32_t DrainEvents( std::vector< InputEvent > &outEvents );
+
+		/// <summary>
+		/// Callback adapter for event mode - drains all queued input events, updates the affected action states and calls their action callbacks
+		/// on the calling thread. Callbacks are called for active actions and for every pose validity change. Call from one thread only
+		/// </summary>
+		/// <returns>Number of callbacks called</returns>
+		uint32_t DispatchEvents();
+
+		/// <summary>
+		/// Retrieves input thread statistics, including ProcessInput latency percentiles
+		/// </summary>
+		/// <returns>Current input thread statistics</returns>
+		InputThreadStats GetInputThreadStats();
+
+		/// <summary>
+		/// Retrieves the latest action state snapshot. Lock free and safe to call from any thread while input is processed in another
+		/// </summary>
+		/// <returns>Handle to the latest snapshot - invalid if no input has been processed yet</returns>
+		ActionStateSnapshotRef AcquireActionStates();
+
+		/// <summary>
+		/// Retrieves the actionstate of an action in the current input frame. Updates the action's states in place,
+		/// so call this from the thread that processes input
 		/// </summary>
 		/// <param name="pAction">Pointer to an input action (any action other than haptic/vibration)</param>
 		/// <returns>Result of retrieving the actionstate for the provided action from the runtime</returns>
@@ -346,9 +693,15 @@ namespace oxr
 		/// Retrieve the current active interaction profile (controller) as reported by the openxr runtime
 		/// </summary>
 		/// <param name="sUserPath">The user path to check (e.g. "/user/hand/left")</param>
-		/// <returns>Result of check the current interaction profile (controller) from the currently active openxr runtime</returns>
+		/// <returns>Current interaction profile path, interned and valid for the lifetime of this object - empty string if none or on error</returns>
 		const char *GetCurrentInteractionProfile( const char *sUserPath );
 
+		/// <summary>
+		/// Retrieves the path interning table used for all string and path conversions of this input object
+		/// </summary>
+		/// <returns>The path interning table</returns>
+		PathTable &GetPathTable() { return m_PathTable; }
+
 		/// <summary>
 		/// generate a haptic pulse with the frequency, duration, amplitude and frequency provided - also have common default settigns for convenience
 		/// </summary>
@@ -373,11 +726,116 @@ namespace oxr
 		// Pointer to a provider session object
 		Session *m_pSession = nullptr;
 
+		// Interned openxr paths
+		PathTable m_PathTable;
+
 		// Active action sets (XrActiveactionSet structs), this is internally kept in sync with m_vecActiveActionSets
 		std::vector< XrActiveActionSet > m_vecXrActiveActionSets;
 
 		// Active action sets (ActionSet struct pointers), this is internally kept in sync with m_vecXrActiveActionSets
 		std::vector< ActionSet * > m_vecActiveActionSets;
+
+		// Action state snapshots, each sync writes to one no reader holds and then publishes it
+		ActionStateSnapshot m_arrActionStateSnapshots[ k_unActionStateSnapshots ];
+
+		// Number of readers holding each snapshot
+		std::atomic< uint32_t > m_arrSnapshotReaders[ k_unActionStateSnapshots ] {};
+
+		// Index of the latest published snapshot, UINT32_MAX if none has been published yet
+		std::atomic< uint32_t > m_unLatestSnapshot { UINT32_MAX };
+
+		// Number of snapshots published so far
+		uint64_t m_unPublishedSnapshots = 0;
+
+		// Number of action state slots assigned to actions so far
+		uint32_t m_unSnapshotSlots = 0;
+
+		/// <summary>
+		/// Assigns snapshot slots to the actions of an actionset that don't have any yet
+		/// </summary>
+		/// <param name="pActionSet">Actionset whose actions need slots</param>
+		void AssignSnapshotSlots( ActionSet *pActionSet );
+
+		/// <summary>
+		/// Copies the current states of all active actions to a free snapshot and publishes it
+		/// </summary>
+		void PublishActionStates();
+
+		// Action callback queued for deferred dispatch, with the state that triggered it
+		struct QueuedCallback
+		{
+			Action *pAction = nullptr;
+			uint32_t unActionStateIndex = 0;
+			Action::ActionState actionState;
+		};
+
+		// Long lived input thread
+		std::thread m_threadInput;
+
+		// Whether the input thread is running
+		std::atomic< bool > m_bInputThreadActive { false };
+
+		// Whether input processing was requested since the input thread last woke
+		bool m_bInputRequested = false;
+
+		// Input processing rate of the input thread, 0 if processing on request
+		float m_fInputPollRateHz = 0.0f;
+
+		// Where action callbacks are called
+		EInputCallbackDispatch m_eCallbackDispatch = EInputCallbackDispatch::InputThread;
+
+		// Guards input requests and the input thread active flag
+		std::mutex m_mutexInputThread;
+
+		// Signals an input request or a stop to the input thread
+		std::condition_variable m_cvInputThread;
+
+		// Deferred callbacks, produced by the input thread and consumed by DispatchCallbacks
+		SpscRing< QueuedCallback > m_CallbackQueue;
+
+		// Deferred callbacks queued (input thread only) and dispatched so far - callback n is dispatched once the dispatched count reaches n
+		uint64_t m_unQueuedCallbacks = 0;
+		std::atomic< uint64_t > m_unDispatchedCallbacks { 0 };
+
+		// Input events, produced by input sync and consumed by DrainEvents or DispatchEvents
+		SpscRing< InputEvent > m_EventQueue;
+
+		// Whether syncs emit input events instead of calling action callbacks
+		std::atomic< bool > m_bEventQueueEnabled { false };
+
+		// Minimum value change to emit an input event
+		float m_fEventEpsilon = 0.01f;
+
+		// Values below this read as zero in input events
+		float m_fEventDeadzone = 0.0f;
+
+		// Input statistics
+		std::atomic< uint32_t > m_unInputThreadsCreated { 0 };
+		std::atomic< uint64_t > m_unDroppedCallbacks { 0 };
+		std::atomic< uint64_t > m_unDroppedEvents { 0 };
+		uint64_t m_unProcessedFrames = 0;
+		float m_arrLatencySamplesMs[ k_unInputLatencySamples ] {};
+		std::mutex m_mutexInputStats;
+
+		/// <summary>
+		/// Input thread loop - processes input when requested or at the poll rate until stopped
+		/// </summary>
+		void InputThreadLoop();
+
+		/// <summary>
+		/// Calls an action callback, or queues it with its current state when callbacks are deferred
+		/// </summary>
+		void InvokeCallback( Action *pAction, uint32_t unActionStateIndex, bool bDeferred );
+
+		/// <summary>
+		/// Checks whether a deferred pose callback for the action state is still waiting for DispatchCallbacks. Input thread only
+		/// </summary>
+		bool IsPoseCallbackQueued( Action *pAction, uint32_t unActionStateIndex );
+
+		/// <summary>
+		/// Queues an input event for an action's synced state if it changed enough since its last event
+		/// </summary>
+		void EmitEvent( Action *pAction, uint32_t unActionStateIndex );
 	};
 
 } // namespace oxr
@@ -24,6 +24,7 @@
 #pragma once
 
 #include "common.hpp"
+#include "path_table.hpp"
 #define LOG_CATEGORY_INPUT "OpenXRProvider-Input"
 
 namespace oxr
@@ -86,13 +87,28 @@ namespace oxr
 			ComponentEMax
 		};
 
+		// Binding path added but not converted to an XrPath yet
+		struct PendingBinding
+		{
+			XrAction action = XR_NULL_HANDLE;
+			BindingPathBuilder bindingPath;
+		};
+
 		std::vector< XrActionSuggestedBinding > vecSuggestedBindings;
 
+		// Binding paths added since bindings were last suggested - converted in one batch when suggesting
+		std::vector< PendingBinding > vecPendingBindings;
+
+		// Path interning table used to convert binding paths, set by oxr::Input. Paths are converted by the runtime directly if not set
+		PathTable *pPathTable = nullptr;
+
 		virtual const char *Path() = 0;
 		virtual XrResult AddBinding( XrInstance xrInstance, XrAction action, XrHandEXT hand, Controller::Component component, Controller::Qualifier qualifier ) = 0;
 		virtual XrResult SuggestBindings( XrInstance xrInstance, void *pOtherInfo ) = 0;
 
 		XrResult AddBinding( XrInstance xrInstance, XrAction action, std::string sFullBindingPath );
+		XrResult AddPendingBinding( XrAction action, const BindingPathBuilder &bindingPath );
+		XrResult ResolvePendingBindings( XrInstance xrInstance );
 		XrResult SuggestControllerBindings( XrInstance xrInstance, void *pOtherInfo );
 	};
 
@@ -134,6 +150,7 @@ namespace oxr
 		{
 			for ( auto &interactionProfile : vecSupportedControllers )
 			{
+				interactionProfile->pPathTable = pPathTable;
 				xrResult = interactionProfile->AddBinding( xrInstance, action, hand, component, qualifier );
 
 				if ( !XR_UNQUALIFIED_SUCCESS( xrResult ) )
@@ -147,6 +164,7 @@ namespace oxr
 		{
 			for ( auto &interactionProfile : vecSupportedControllers )
 			{
+				interactionProfile->pPathTable = pPathTable;
 				xrResult = interactionProfile->SuggestBindings( xrInstance, pOtherInfo );
 
 				if ( !XR_UNQUALIFIED_SUCCESS( xrResult ) )
@@ -0,0 +1,141 @@
+/* Copyright 2021, 2022, 2023 Rune Berg (GitHub: https://github.com/1runeberg, Twitter: https://twitter.com/1runeberg, YouTube: https://www.youtube.com/@1RuneBerg)
+ *
+ *  SPDX-License-Identifier: MIT
+ *
+ *  Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+ *
+ *  2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *
+ *  3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote products derived from this
+ *     software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ *  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+ *  BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ *  GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+ *  DAMAGE.
+ *
+ */
+
+#pragma once
+#include "common.hpp"
+
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <string_view>
+#include <unordered_map>
+
+namespace oxr
+{
+	/// <summary>
+	/// Assembles a path (e.g. a binding path) in a fixed buffer without heap allocations.
+	/// Paths longer than XR_MAX_PATH_LENGTH are truncated and flagged as overflowed
+	/// </summary>
+	struct BindingPathBuilder
+	{
+		BindingPathBuilder( const char *pccBase = "" ) { *this += pccBase; }
+
+		BindingPathBuilder &operator+=( const char *pccPart )
+		{
+			size_t unLength = strlen( pccPart );
+			size_t unAvailable = XR_MAX_PATH_LENGTH - 1 - m_unLength;
+
+			if ( unLength > unAvailable )
+			{
+				unLength = unAvailable;
+				m_bOverflowed = true;
+			}
+
+			memcpy( m_sPath + m_unLength, pccPart, unLength );
+			m_unLength += static_cast< uint32_t >( unLength );
+			m_sPath[ m_unLength ] = '\0';
+
+			return *this;
+		}
+
+		void clear()
+		{
+			m_unLength = 0;
+			m_sPath[ 0 ] = '\0';
+			m_bOverflowed = false;
+		}
+
+		bool empty() const { return m_unLength == 0; }
+		bool overflowed() const { return m_bOverflowed; }
+		const char *c_str() const { return m_sPath; }
+		std::string_view view() const { return std::string_view( m_sPath, m_unLength ); }
+
+	  private:
+		char m_sPath[ XR_MAX_PATH_LENGTH ] = {};
+		uint32_t m_unLength = 0;
+		bool m_bOverflowed = false;
+	};
+
+	/// <summary>
+	/// Interning table for openxr paths. Each string is converted by the runtime only once, after which
+	/// string to path and path to string lookups are hashed. Interned strings have stable storage for the lifetime of the table.
+	/// Safe to use from multiple threads
+	/// </summary>
+	class PathTable
+	{
+	  public:
+		/// <summary>
+		/// Sets the openxr instance paths are converted with - paths are only valid for this instance
+		/// </summary>
+		/// <param name="xrInstance">The active openxr instance</param>
+		void Init( XrInstance xrInstance );
+
+		/// <summary>
+		/// Converts a string to an openxr path, querying the runtime only if the string hasn't been interned yet
+		/// </summary>
+		/// <param name="sPath">The string to convert (e.g. "/user/hand/left")</param>
+		/// <param name="outPath">Out parameter - the XrPath for the string</param>
+		/// <returns>Result of the conversion from the openxr runtime, XR_SUCCESS if already interned</returns>
+		XrResult StringToPath( std::string_view sPath, XrPath *outPath );
+
+		/// <summary>
+		/// Converts a batch of strings to openxr paths under a single lock. Strings that fail to convert are set to XR_NULL_PATH
+		/// </summary>
+		/// <param name="pPaths">Strings to convert</param>
+		/// <param name="unCount">Number of strings to convert</param>
+		/// <param name="outPaths">Out parameter - array of at least unCount paths</param>
+		/// <returns>XR_SUCCESS if all strings were converted, otherwise the first error from the runtime</returns>
+		XrResult StringsToPaths( const std::string_view *pPaths, uint32_t unCount, XrPath *outPaths );
+
+		/// <summary>
+		/// Converts an openxr path to its string, querying the runtime only if the path hasn't been interned yet
+		/// </summary>
+		/// <param name="xrPath">Valid openxr path</param>
+		/// <returns>Interned, null terminated string for the path - empty if the path is invalid</returns>
+		std::string_view PathToString( XrPath xrPath );
+
+		/// <summary>
+		/// Retrieves the number of interned paths
+		/// </summary>
+		/// <returns>Number of interned paths</returns>
+		size_t Size();
+
+	  private:
+		// Instance the paths belong to
+		XrInstance m_xrInstance = XR_NULL_HANDLE;
+
+		// Stable storage for interned strings - map keys and values view into these
+		std::deque< std::string > m_deqStrings;
+
+		// Hashed lookups in both directions
+		std::unordered_map< std::string_view, XrPath > m_mapStringToPath;
+		std::unordered_map< XrPath, std::string_view > m_mapPathToString;
+
+		// Guards the table - paths are converted from both the app and input threads
+		std::mutex m_mutexPaths;
+
+		XrResult StringToPathLocked( std::string_view sPath, XrPath *outPath );
+		std::string_view Intern( std::string sPath, XrPath xrPath );
+	};
+
+} // namespace oxr
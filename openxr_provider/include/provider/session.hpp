@@ -23,6 +23,13 @@
 
 #pragma once
 #include "common.hpp"
+#include "frame_timing.hpp"
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
 
 #define LOG_CATEGORY_SESSION "OpenXRProvider-Session"
 
@@ -45,6 +52,61 @@ namespace oxr
 		Callback_RenderImage fnCallback;
 	};
 
+	// Location of a space relative to a base space, cached for the frame it was located in
+	struct SpaceLocationCacheEntry
+	{
+		// Space the location is relative to
+		XrSpace baseSpace = XR_NULL_HANDLE;
+
+		// Space that was located
+		XrSpace targetSpace = XR_NULL_HANDLE;
+
+		// Time the space was located at
+		XrTime xrTime = 0;
+
+		// Location returned by the runtime
+		XrSpaceLocation xrSpaceLocation { XR_TYPE_SPACE_LOCATION };
+
+		// Whether both spaces are reference spaces created by the session. Their locations don't change with an input sync,
+		// unlike action spaces or any other space the session doesn't know about
+		bool bReferenceSpaces = false;
+	};
+
+	// Frame handed over by the frame pacing thread to the render thread (pipelined frame loop)
+	struct FrameTicket
+	{
+		// Frame state returned by the runtime's xrWaitFrame for this frame
+		XrFrameState xrFrameState { XR_TYPE_FRAME_STATE };
+
+		// Result of xrBeginFrame for this frame - the render thread only renders and ends frames that began successfully
+		XrResult xrBeginFrameResult = XR_SUCCESS;
+
+		// xrWaitFrame and xrBeginFrame timings on the frame pacing thread, if frame timing is enabled
+		FrameStageTime waitFrameTime;
+		FrameStageTime beginFrameTime;
+	};
+
+	// Fence signalled when a piece of the current frame's gpu work completes
+	struct FrameGpuFence
+	{
+		VkDevice vkDevice = VK_NULL_HANDLE;
+		VkFence vkFence = VK_NULL_HANDLE;
+	};
+
+	// Frame submission handed from the render thread to the frame end thread (pipelined frame loop). Holds copies of the
+	// projection layers, views and depth infos as the render thread reuses its own for the next frame
+	struct PendingFrameEnd
+	{
+		XrFrameEndInfo xrFrameEndInfo { XR_TYPE_FRAME_END_INFO };
+		std::vector< const XrCompositionLayerBaseHeader * > vecLayers;
+		std::vector< XrCompositionLayerProjection > vecProjectionLayers;
+		std::vector< XrCompositionLayerProjectionView > vecProjectionViews;
+		std::vector< XrCompositionLayerDepthInfoKHR > vecDepthInfos;
+
+		// Gpu work of the frame that must complete before xrEndFrame
+		std::vector< FrameGpuFence > vecGpuFences;
+	};
+
 	// Set of vulkan texture formats that will be used for renders
 	struct TextureFormats
 	{
@@ -73,6 +135,9 @@ namespace oxr
 		// Swapchain image height - this is  assumed uniform for all images in the swapchains
 		int32_t unHeight = 0;
 
+		// Number of array layers in each swapchain image - an array size matching the view count renders all views in a single pass (multiview)
+		uint32_t unArraySize = 1;
+
 		// Color swapchain images/textures generated by the currently active runtime
 		std::vector< XrSwapchainImageVulkan2KHR > vecColorTextures;
 
@@ -99,6 +164,7 @@ namespace oxr
 		Session( oxr::Instance *pInstance, ELogLevel eLogLevel, bool bDepthHandling = false );
 		~Session()
 		{
+			StopFramePacing();
 
 			for ( Swapchain swapchain : m_vecSwapchains )
 			{
@@ -214,7 +280,9 @@ namespace oxr
 		XrResult CreateReferenceSpace( XrSpace *outSpace, XrReferenceSpaceType xrReferenceSpaceType, XrPosef xrReferencePose, void *pvAdditionalCreateInfo = nullptr );
 
 		/// <summary>
-		/// Retrieves the current pose and metadata for the provided reference space
+		/// Retrieves the current pose and metadata for the provided reference space.
+		/// Locations are cached per (base space, target space, time) until the next frame begins, so the same space is only located
+		/// once per frame. Locations of spaces other than the session's reference spaces (e.g. action spaces) are also dropped when input is synced. Locations with a next chain (e.g. velocities) always go to the runtime.
 		/// </summary>
 		/// <param name="baseSpace">The origin/reference space</param>
 		/// <param name="targetSpace">The space to get the pose and metadata of</param>
@@ -239,6 +307,23 @@ namespace oxr
 		/// <returns>Result from the openxr runtime of retrieving the pose and metadata for the app space</returns>
 		XrResult LocateAppSpace( XrTime predictedDisplayTime, XrSpaceLocation *outSpaceLocation );
 
+		/// <summary>
+		/// Clears all cached space locations - next calls to LocateSpace will query the runtime again
+		/// </summary>
+		void InvalidateSpaceLocationCache();
+
+		/// <summary>
+		/// Clears cached locations that may change with an input sync - those involving any space that isn't a reference space
+		/// created by this session (e.g. action spaces). Reference space locations stay cached for their display time
+		/// </summary>
+		void InvalidateActionSpaceLocations();
+
+		/// <summary>
+		/// Retrieves the number of locate calls made to the runtime during the last completed frame
+		/// </summary>
+		/// <returns>Runtime locate calls of the last frame</returns>
+		uint32_t GetLocateSpaceCallCount() { return m_unLastFrameLocateCalls.load( std::memory_order_relaxed ); }
+
 		/// <summary>
 		/// Updates the cache for the supported view configuration views by the currently active openxr runtime
 		/// This defines the runtime recommended texture sizes/extents as well the maximums.
@@ -283,6 +368,17 @@ namespace oxr
 		/// <returns>Cached swapchains and metadata</returns>
 		const std::vector< Swapchain > &GetSwapchains() { return m_vecSwapchains; }
 
+		/// <summary>
+		/// Checks if a swapchain holds all views of the session as array layers, in which case all views are rendered in a single pass (multiview)
+		/// and one projection view per array layer is submitted for it
+		/// </summary>
+		/// <param name="unSwapchainIndex">Index of the swapchain to check</param>
+		/// <returns>True if the swapchain is the only one in this session and has an array layer for each view</returns>
+		bool IsMultiviewSwapchain( uint32_t unSwapchainIndex )
+		{
+			return m_vecSwapchains.size() == 1 && unSwapchainIndex == 0 && m_vecViews.size() > 1 && m_vecSwapchains[ 0 ].unArraySize >= m_vecViews.size();
+		}
+
 		/// <summary>
 		/// Request the runtime to creates the images/textures for the swapchain (color textures by default)
 		/// This will use the runtime's recommended number of textures per swapchain
@@ -374,6 +470,46 @@ namespace oxr
 		/// <param name="pFrameState">Output parameter for the framestate, intended purely for updating predicted times</param>
 		void RenderHeadlessFrame( XrFrameState *pFrameState );
 
+		/// <summary>
+		/// Opt-in pipelined frame loop. Starts a dedicated frame pacing thread that calls xrWaitFrame and xrBeginFrame ahead of the render thread
+		/// and hands each begun frame over as a ticket. While active, RenderFrame, RenderFrameWithLayers and RenderHeadlessFrame consume these tickets
+		/// instead of waiting inline, so the wait for frame N+1 overlaps the cpu/gpu work of frame N. Registered render callbacks are called as normal.
+		/// Frames are ended on a frame end thread once their gpu fences (see AddFrameGpuFence) are signalled, so the render thread doesn't block on the gpu
+		/// while handing a frame over. As runtimes allow only one begun frame, frame N+1 is begun (and its recording can start) only once frame N has
+		/// been ended, i.e. after its gpu work is done - recording N+1 doesn't overlap the gpu work of N. A frame whose fences aren't signalled within
+		/// one second is ended without layers.
+		/// Layers passed to RenderFrameWithLayers other than projection layers must stay valid until the next frame is begun.
+		/// Start only after the session has begun and stop before ending the session (e.g. on STOPPING).
+		/// </summary>
+		/// <returns>Result of starting the frame pacing thread</returns>
+		XrResult StartFramePacing();
+
+		/// <summary>
+		/// Registers a fence that is signalled by gpu work of the frame currently being rendered (e.g. a queue submit from a release swapchain image callback).
+		/// xrEndFrame for the frame is only called once all of its registered fences are signalled. Fences must not be reset or reused until the frame is ended.
+		/// </summary>
+		/// <param name="vkDevice">Device that owns the fence</param>
+		/// <param name="vkFence">Fence passed to the queue submit</param>
+		void AddFrameGpuFence( VkDevice vkDevice, VkFence vkFence ) { m_vecFrameGpuFences.push_back( { vkDevice, vkFence } ); }
+
+		/// <summary>
+		/// Marks the frame currently being rendered as failed (e.g. its gpu work couldn't be recorded or submitted). The frame is still ended,
+		/// but without layers so the runtime doesn't show swapchain images that weren't rendered
+		/// </summary>
+		void DiscardFrameLayers() { m_bDiscardFrameLayers = true; }
+
+		/// <summary>
+		/// Stops the frame pacing thread and ends any frame it has begun that the render thread has not consumed.
+		/// Rendering falls back to the inline xrWaitFrame/xrBeginFrame path afterwards.
+		/// </summary>
+		void StopFramePacing();
+
+		/// <summary>
+		/// Checks whether the pipelined frame loop (frame pacing thread) is active
+		/// </summary>
+		/// <returns>True if frames are being waited on and begun by the frame pacing thread</returns>
+		bool IsFramePacingActive() { return m_bFramePacingActive; }
+
 		/// <summary>
 		/// Retrieve the most recent predicted display time from the openxr runtime
 		/// </summary>
@@ -387,6 +523,13 @@ namespace oxr
 		/// <returns>The most recent predicted display period from the openxr runtime</returns>
 		XrTime GetPredictedDisplayPeriod() { return m_xrPredictedDisplayPeriod; }
 
+		/// <summary>
+		/// Retrieves the per frame timing records of this session. Disabled by default, enable with SetEnabled(true).
+		/// Covers the frame loop's openxr calls and, when rendering with xrvk, command recording, queue submits and gpu time per render pass
+		/// </summary>
+		/// <returns>The session's frame timing ring</returns>
+		FrameTiming &GetFrameTiming() { return m_FrameTiming; }
+
 		/// <summary>
 		/// Retrieves the reference space handle for this session
 		/// </summary>
@@ -495,12 +638,52 @@ namespace oxr
 		// Cache of swapchains. Each swapchain is a pair for both color and depth
 		std::vector< Swapchain > m_vecSwapchains;
 
+		// Depth info for each submitted projection view - kept here as these are chained to the projection views until xrEndFrame
+		std::vector< XrCompositionLayerDepthInfoKHR > m_vecDepthInfos;
+
 		// The most recent predicted display time from the last library render call
 		XrTime m_xrPredictedDisplayTime = 0;
 
 		// The most recent predicted display period from the last library render call
 		XrTime m_xrPredictedDisplayPeriod = 0;
 
+		// Per frame timing records, filled in by the render thread
+		FrameTiming m_FrameTiming;
+
+		// Space locations made during the current frame. Small enough that a linear search beats hashing
+		std::vector< SpaceLocationCacheEntry > m_vecSpaceLocationCache;
+
+		// Guards the space location cache - spaces are located from both the render and input threads
+		std::mutex m_mutexSpaceLocationCache;
+
+		// Incremented on every cache invalidation - locations made across an invalidation are not cached
+		uint64_t m_unSpaceLocationCacheGeneration = 0;
+
+		// Incremented on every invalidation of action space locations (including full invalidations)
+		uint64_t m_unActionSpaceCacheGeneration = 0;
+
+		// Reference spaces created by this session, guarded by the space location cache mutex
+		std::vector< XrSpace > m_vecReferenceSpaces;
+
+		/// <summary>
+		/// Adds a reference space created by this session to the ones whose locations outlive input syncs
+		/// </summary>
+		/// <param name="xrSpace">Newly created reference space</param>
+		void AddReferenceSpace( XrSpace xrSpace );
+
+		/// <summary>
+		/// Checks if a space is a reference space created by this session - call with the cache mutex held
+		/// </summary>
+		/// <param name="xrSpace">Space to check</param>
+		/// <returns>True if the space is one of the session's reference spaces</returns>
+		bool IsReferenceSpace( XrSpace xrSpace ) const;
+
+		// Runtime locate calls made during the current frame
+		std::atomic< uint32_t > m_unLocateCalls { 0 };
+
+		// Runtime locate calls made during the last completed frame
+		std::atomic< uint32_t > m_unLastFrameLocateCalls { 0 };
+
 		// The active session's reference space
 		XrSpace m_xrReferenceSpace = XR_NULL_HANDLE;
 
@@ -516,6 +699,113 @@ namespace oxr
 		// Holds the app callbacks that will be called after release swapchain
 		std::vector< RenderImageCallback * > m_vecReleaseSwapchainImageCallbacks;
 
+		// Whether frames are waited on and begun by the frame pacing thread
+		std::atomic< bool > m_bFramePacingActive { false };
+
+		// Dedicated thread for xrWaitFrame/xrBeginFrame when the pipelined frame loop is active
+		std::thread m_threadFramePacing;
+
+		// Begun frames waiting for the render thread. Runtimes only allow a single begun frame,
+		// so this never holds more than one ticket - the next xrBeginFrame waits until the previous frame has ended
+		std::deque< FrameTicket > m_deqFrameTickets;
+
+		// Whether a frame has been begun by the frame pacing thread but not ended by the render thread yet
+		bool m_bFrameInFlight = false;
+
+		// Guards the frame ticket queue and frame in flight flag
+		std::mutex m_mutexFrameTickets;
+
+		// Signals a new frame ticket (to the render thread), a frame to end (to the frame end thread) or an ended frame (to the frame pacing thread)
+		std::condition_variable m_cvFrameTickets;
+
+		// Dedicated thread that waits for a frame's gpu work and ends it when the pipelined frame loop is active
+		std::thread m_threadFrameEnd;
+
+		// Frame submitted by the render thread that the frame end thread has yet to end
+		PendingFrameEnd m_PendingFrameEnd;
+
+		// Whether m_PendingFrameEnd holds a frame to end
+		bool m_bFrameEndPending = false;
+
+		// Frame the frame pacing thread waited for but couldn't begin as it was stopped while the render thread still had a frame in flight.
+		// Whoever begins the next frame (inline or a restarted frame pacing thread) begins this one instead of calling xrWaitFrame again
+		FrameTicket m_WaitedFrame;
+		bool m_bHasWaitedFrame = false;
+
+		// Fences for the gpu work of the frame currently being rendered, only accessed by the render thread
+		std::vector< FrameGpuFence > m_vecFrameGpuFences;
+
+		// Whether the frame currently being rendered is ended without layers (see DiscardFrameLayers), only accessed by the render thread
+		bool m_bDiscardFrameLayers = false;
+
+		/// <summary>
+		/// Frame pacing thread loop - waits for and begins frames ahead of the render thread
+		/// </summary>
+		void FramePacingLoop();
+
+		/// <summary>
+		/// Frame end thread loop - ends frames submitted by the render thread once their gpu work completes
+		/// </summary>
+		void FrameEndLoop();
+
+		/// <summary>
+		/// Copies a frame's end info into m_PendingFrameEnd, deep copying projection layers along with their views and depth infos
+		/// </summary>
+		/// <param name="pFrameEndInfo">End frame info from the render thread</param>
+		void CopyPendingFrameEnd( const XrFrameEndInfo *pFrameEndInfo );
+
+		/// <summary>
+		/// Blocks until all the given gpu fences are signalled, for at most one second. If they aren't (or waiting fails) the frame's gpu work
+		/// is treated as failed and its layers are removed, so the frame is ended without showing swapchain images that may not be rendered
+		/// </summary>
+		/// <param name="vecGpuFences">Fences of the frame's gpu work</param>
+		/// <param name="pFrameEndInfo">End frame info of the frame, its layers are cleared on failure</param>
+		/// <returns>True if all fences were signalled</returns>
+		bool WaitForFrameGpuFences( const std::vector< FrameGpuFence > &vecGpuFences, XrFrameEndInfo *pFrameEndInfo );
+
+		/// <summary>
+		/// Takes the frame the frame pacing thread waited for but didn't begin, if any
+		/// </summary>
+		/// <param name="outFrameTicket">Output parameter for the waited frame's state and wait timing</param>
+		/// <returns>True if there was such a frame - it must be begun without waiting for another one</returns>
+		bool TakeWaitedFrame( FrameTicket *outFrameTicket );
+
+		/// <summary>
+		/// Waits for and begins a new frame, or takes one begun ahead by the frame pacing thread if the pipelined frame loop is active
+		/// </summary>
+		/// <param name="pFrameState">Output parameter for the framestate of the new frame</param>
+		/// <returns>True if a frame was begun and must be ended via EndFrame(), false otherwise</returns>
+		bool BeginNextFrame( XrFrameState *pFrameState );
+
+		/// <summary>
+		/// Submits the current frame to the runtime once its gpu work has completed. With the pipelined frame loop active, the frame is handed over
+		/// to the frame end thread instead, which ends it and lets the frame pacing thread begin the next one
+		/// </summary>
+		/// <param name="pFrameEndInfo">End frame info with the layers to submit</param>
+		void EndFrame( XrFrameEndInfo *pFrameEndInfo );
+
+		/// <summary>
+		/// Locates the views and runs the acquire, wait and release swapchain image cycle (and app callbacks) for each swapchain
+		/// </summary>
+		/// <param name="outFrameLayerProjection">Output parameter - projection layer for the rendered views</param>
+		/// <param name="vecFrameLayerProjectionViews">Vector of projection views to fill in</param>
+		/// <param name="pFrameState">Framestate of the current frame</param>
+		/// <param name="xrCompositionLayerFlags">Flags for the projection layer</param>
+		/// <param name="xrRectOffset">Rect offset (e.g. for single pass rendering or lowering res during runtime)</param>
+		/// <param name="xrRectExtent">Rect extent (e.g. for single pass rendering or lowering res during runtime)</param>
+		/// <param name="bIsarray">Whether texture to render to is an array</param>
+		/// <param name="unArrayIndex">Index if a texture array</param>
+		/// <returns>True if the projection layer was filled in and should be submitted, false otherwise</returns>
+		bool RenderProjectionViews(
+			XrCompositionLayerProjection *outFrameLayerProjection,
+			std::vector< XrCompositionLayerProjectionView > &vecFrameLayerProjectionViews,
+			XrFrameState *pFrameState,
+			XrCompositionLayerFlags xrCompositionLayerFlags,
+			XrOffset2Di xrRectOffset,
+			XrExtent2Di xrRectExtent,
+			bool bIsarray,
+			uint32_t unArrayIndex );
+
 		/// <summary>
 		/// Removes an app register render callback
 		/// </summary>
@@ -0,0 +1,152 @@
+/* Copyright 2021, 2022, 2023 Rune Berg (GitHub: https://github.com/1runeberg, Twitter: https://twitter.com/1runeberg, YouTube: https://www.youtube.com/@1RuneBerg)
+ *
+ *  SPDX-License-Identifier: MIT
+ *
+ *  Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+ *
+ *  2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *
+ *  3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote products derived from this
+ *     software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ *  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+ *  BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ *  GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+ *  DAMAGE.
+ *
+ */
+
+
+#pragma once
+
+#include "job_system.hpp"
+#include "log.hpp"
+#include "mesh_cache.hpp"
+#include "upload_manager.hpp"
+#include "vulkanpbr/VulkanglTFModel.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace xrvk
+{
+	enum class EAssetState : uint32_t
+	{
+		Queued = 0,	   // waiting for a worker thread
+		Parsing = 1,   // file read, parse and decode on a worker thread
+		Uploading = 2, // parsed, staged by the upload thread and waiting for its copies to complete
+		Ready = 3,	   // copies completed on the transfer queue, the model can be used once the upload manager recorded unUploadToken
+		Cancelled = 4, // cancelled before the upload, the model was left empty
+		Failed = 5	   // file couldn't be read or parsed, the model was left empty
+	};
+
+	// A single model load, shared between the loader threads and the caller
+	struct AssetRequest
+	{
+		std::string sFilename;
+		vkglTF::Model *pModel = nullptr;
+		float fScale = 1.0f;
+
+		std::atomic< EAssetState > eState { EAssetState::Queued };
+		std::atomic< bool > bCancel { false };
+
+		// true if the model ended up on the gpu, false if cancelled or failed
+		std::promise< bool > promise;
+		std::shared_future< bool > future;
+
+		// model was rebuilt from the mesh cache instead of parsed
+		bool bFromCache = false;
+
+		// upload batch the model's copies were submitted in
+		UploadToken unUploadToken = 0;
+
+		// timings, only valid once the asset is done
+		float fParseMs = 0.f;
+		float fUploadMs = 0.f;
+		std::chrono::high_resolution_clock::time_point tUploadStart;
+
+		bool IsDone() { return eState.load() >= EAssetState::Ready; }
+		bool IsReady() { return eState.load() == EAssetState::Ready; }
+	};
+
+	typedef std::shared_ptr< AssetRequest > AssetHandle;
+
+	// Loads gltf models off the calling thread:
+	// a fixed pool of worker threads does the file read, parse and decode, and a single upload thread takes every model parsed
+	// since its last pass, stages them into the upload manager's ring and submits them as one batch. The upload thread never
+	// blocks on the gpu unless the staging ring is full, batches are polled for completion while new models are staged
+	class AssetLoader
+	{
+	  public:
+		// pUploadManager must outlive the loader, it's only used from the upload thread (apart from its thread safe completion checks)
+		// a worker thread count of 0 uses the number of hardware threads (minus one for the upload thread)
+		// models are read from and written to the mesh cache in sMeshCacheDirectory, an empty directory disables it
+		AssetLoader( vks::VulkanDevice *pVulkanDevice, UploadManager *pUploadManager, uint32_t unWorkerThreadCount = 0, const std::string &sMeshCacheDirectory = "" );
+
+		// Cancels anything not yet uploaded and joins all loader threads
+		~AssetLoader();
+
+		// Queues a model load, pModel must stay alive and untouched by the caller until the returned asset is done
+		AssetHandle Load( const std::string &sFilename, vkglTF::Model *pModel, float fScale = 1.0f );
+
+		// Cancels an asset that isn't on the gpu yet, already uploaded assets are unaffected
+		void Cancel( const AssetHandle &asset ) { asset->bCancel = true; }
+		void CancelAll();
+
+		// Blocks until every asset queued so far is done (its copies completed)
+		void WaitAll();
+
+		// Number of assets queued and not yet done
+		uint32_t GetPendingCount();
+
+		// Done assets over all assets queued since the loader was last idle (1 if there's nothing to load)
+		float GetProgress();
+
+		// Total threads owned by the loader (workers plus the upload thread) - this never grows with the number of assets
+		uint32_t GetThreadCount() { return m_pWorkers->GetThreadCount() + 1; }
+
+	  private:
+		vks::VulkanDevice *m_pVulkanDevice = nullptr;
+		UploadManager *m_pUploadManager = nullptr;
+
+		// preprocessed models, only used from the worker threads
+		MeshCache m_MeshCache;
+
+		// file read, parse and decode
+		JobSystem *m_pWorkers = nullptr;
+
+		// parsed assets waiting for the upload thread, guarded by m_mutexUploads
+		std::thread m_UploadThread;
+		std::deque< AssetHandle > m_deqUploads;
+		std::mutex m_mutexUploads;
+		std::condition_variable m_cvUploads;
+		bool m_bStop = false;
+
+		// progress, guarded by m_mutexAssets and reset whenever the loader becomes idle
+		uint32_t m_unQueuedCount = 0;
+		uint32_t m_unDoneCount = 0;
+		std::mutex m_mutexAssets;
+		std::condition_variable m_cvIdle;
+
+		// assets not yet done, for CancelAll
+		std::vector< AssetHandle > m_vecInFlight;
+
+		void ParseAsset( AssetHandle asset );
+		void UploadLoop();
+		void FinishAsset( const AssetHandle &asset, EAssetState eState );
+	};
+
+} // namespace xrvk
@@ -80,6 +80,10 @@ namespace xrvk
 		uint32_t vkQueueFamilyIndex = 0;
 		uint32_t vkQueueIndex = 0;
 
+		// transfer only queue for uploads if the device has one, otherwise the graphics queue above
+		VkQueue vkTransferQueue = VK_NULL_HANDLE;
+		uint32_t vkTransferQueueFamilyIndex = 0;
+
 		VkPipelineCache vkPipelineCache = VK_NULL_HANDLE;
 
 		// Android specific
@@ -102,13 +106,22 @@ namespace xrvk
 		VkCommandPool vkCommandPool = VK_NULL_HANDLE;
 		VkCommandBuffer vkCommandBuffer = VK_NULL_HANDLE;
 		VkFence vkCommandFence = VK_NULL_HANDLE;
+
+		// gpu timestamps of the last render recorded in this slot, read once the slot comes around again
+		bool bTimestampsWritten = false;
+		uint64_t unTimedFrameIndex = 0;
+		uint32_t unTimedPass = 0;
+
+		// parallel recording only
+		std::vector< VkCommandPool > vecSecondaryCommandPools;
+		std::vector< VkCommandBuffer > vecSecondaryCommandBuffers;
 	};
 
 	struct Buffer
 	{
 		VkDevice device = VK_NULL_HANDLE;
 		VkBuffer buffer = VK_NULL_HANDLE;
-		VkDeviceMemory memory = VK_NULL_HANDLE;
+		MemoryAllocation memory {};
 		VkDescriptorBufferInfo descriptor {};
 		int32_t count = 0;
 		void *mapped = nullptr;
@@ -119,7 +132,7 @@ namespace xrvk
 			descriptor = { buffer, 0, size };
 			if ( map )
 			{
-				VK_CHECK_RESULT( vkMapMemory( device->logicalDevice, memory, 0, size, 0, &mapped ) );
+				this->map();
 			}
 		}
 
@@ -129,7 +142,7 @@ namespace xrvk
 			device->createBuffer( usageFlags, memoryPropertyFlags, size, &buffer, &memory, data );
 			descriptor = { buffer, 0, size };
 
-			VK_CHECK_RESULT( vkMapMemory( device->logicalDevice, memory, 0, size, 0, &mapped ) );
+			map();
 		}
 
 		void destroy()
@@ -144,29 +157,136 @@ namespace xrvk
 				if ( buffer != VK_NULL_HANDLE )
 					vkDestroyBuffer( device, buffer, nullptr );
 
-				if ( memory != VK_NULL_HANDLE )
-					vkFreeMemory( device, memory, nullptr );
+				if ( memory.pAllocator )
+					memory.pAllocator->Free( memory );
 			}
 
 			buffer = VK_NULL_HANDLE;
-			memory = VK_NULL_HANDLE;
 		}
-		void map() { VK_CHECK_RESULT( vkMapMemory( device, memory, 0, VK_WHOLE_SIZE, 0, &mapped ) ); }
-		void unmap()
+
+		// host visible memory is persistently mapped by the allocator, map and unmap only hand out its pointer
+		void map()
 		{
-			if ( mapped )
-			{
-				vkUnmapMemory( device, memory );
-				mapped = nullptr;
-			}
+			assert( memory.pMapped );
+			mapped = memory.pMapped;
 		}
+		void unmap() { mapped = nullptr; }
 		void flush( VkDeviceSize size = VK_WHOLE_SIZE )
 		{
-			VkMappedMemoryRange mappedRange {};
-			mappedRange.sType = VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE;
-			mappedRange.memory = memory;
-			mappedRange.size = size;
-			VK_CHECK_RESULT( vkFlushMappedMemoryRanges( device, 1, &mappedRange ) );
+			if ( memory.pAllocator )
+				memory.pAllocator->Flush( memory, 0, size );
+		}
+	};
+
+	struct PushConstBlockMaterial
+	{
+		glm::vec4 baseColorFactor;
+		glm::vec4 emissiveFactor;
+		glm::vec4 diffuseFactor;
+		glm::vec4 specularFactor;
+		float workflow;
+		int colorTextureSet;
+		int PhysicalDescriptorTextureSet;
+		int normalTextureSet;
+		int occlusionTextureSet;
+		int emissiveTextureSet;
+		float metallicFactor;
+		float roughnessFactor;
+		float alphaMask;
+		float alphaMaskCutoff;
+	};
+
+	// Material table entry for descriptor indexing (bindless) - matches MaterialData (std430) in pbr_khr_bindless.frag
+	struct BindlessMaterial
+	{
+		PushConstBlockMaterial params;
+		int32_t colorMap = 0; // indices into the bindless texture array, 0 is the empty texture
+		int32_t physicalDescriptorMap = 0;
+		int32_t normalMap = 0;
+		int32_t aoMap = 0;
+		int32_t emissiveMap = 0;
+		int32_t padding = 0;
+	};
+	static_assert( sizeof( BindlessMaterial ) == 128, "BindlessMaterial must match the std430 layout of MaterialData in the bindless pbr shaders" );
+
+	// Flattened primitives of a gltf model (struct of arrays), built once after the model's descriptor sets are allocated.
+	// Draws are sorted by alpha mode (opaque, mask, blend), then pipeline and material - blended draws keep their node order
+	struct DrawList
+	{
+		enum class EPipeline : uint8_t
+		{
+			Pbr = 0,
+			PbrDoubleSided = 1,
+			PbrAlphaBlend = 2,
+			EMax
+		};
+
+		// per draw
+		std::vector< EPipeline > vecPipelines;
+		std::vector< uint32_t > vecMaterials; // index to per material arrays
+		std::vector< uint32_t > vecMeshUniformOffsets; // offset of the mesh in the first frame region of the model's mesh uniforms
+		std::vector< uint32_t > vecFirstIndices;
+		std::vector< uint32_t > vecCounts; // index count if indexed, vertex count otherwise
+		std::vector< uint8_t > vecIndexed;
+
+		// per material
+		std::vector< VkDescriptorSet > vecMaterialDescriptorSets;
+		std::vector< PushConstBlockMaterial > vecMaterialPushConstants;
+		std::vector< uint32_t > vecMaterialTableIndices; // bindless only
+
+		// nodes with meshes in traversal order, their transforms are updated once per render
+		std::vector< vkglTF::Node * > vecMeshNodes;
+
+		bool bIsBuilt = false;
+
+		uint32_t Size() { return static_cast< uint32_t >( vecPipelines.size() ); }
+
+		void Clear()
+		{
+			vecPipelines.clear();
+			vecMaterials.clear();
+			vecMeshUniformOffsets.clear();
+			vecFirstIndices.clear();
+			vecCounts.clear();
+			vecIndexed.clear();
+			vecMaterialDescriptorSets.clear();
+			vecMaterialPushConstants.clear();
+			vecMaterialTableIndices.clear();
+			vecMeshNodes.clear();
+			bIsBuilt = false;
+		}
+	};
+
+	struct RenderSceneBase;
+
+	// Renderables that share a source file share the gltf model of the first one (the source), which draws all of them
+	// with instanced indirect draws. A compute prepass culls the instances against the view frustum, the vertex shader
+	// reads the model matrices of the ones that passed from a storage buffer
+	struct InstanceGroup
+	{
+		RenderSceneBase *pSource = nullptr;
+		std::vector< RenderSceneBase * > vecInstances; // all members, including the source
+
+		glm::vec4 boundingSphere { 0.0f, 0.0f, 0.0f, -1.0f }; // model space center and radius of the source's model, negative radius skips culling
+		uint32_t unVisibleInstances = 0;					  // instances with bIsVisible set in the current frame slot, before culling
+
+		// per frame slot
+		std::vector< Buffer > vecInstanceBuffers;		  // model matrix per visible instance, written by the cpu
+		std::vector< Buffer > vecCulledInstanceBuffers; // model matrix per instance inside the frustum, written by the culling prepass
+		std::vector< Buffer > vecIndirectBuffers;		  // VkDrawIndexedIndirectCommand per draw of the source's draw list, instance counts written by the culling prepass
+		std::vector< VkDescriptorSet > vecDescriptorSets;	  // culled instances (vertex shader)
+		std::vector< VkDescriptorSet > vecCullDescriptorSets; // instances, culled instances, indirect draws and views (culling prepass)
+
+		~InstanceGroup()
+		{
+			for ( auto &buffer : vecInstanceBuffers )
+				buffer.destroy();
+
+			for ( auto &buffer : vecCulledInstanceBuffers )
+				buffer.destroy();
+
+			for ( auto &buffer : vecIndirectBuffers )
+				buffer.destroy();
 		}
 	};
 
@@ -174,10 +294,14 @@ namespace xrvk
 	{
 		// data payload
 		bool bIsVisible = true;
+		bool bIsLoaded = false; // gltf model is on the gpu, until then it belongs to the asset loader
 		bool bMovesWithPlayer = false;
 		std::string sFilename;
 		vkglTF::Model gltfModel;
+		DrawList drawList;
 		VkPipeline vkPipeline = VK_NULL_HANDLE;
+		InstanceGroup *pInstanceGroup = nullptr;			// set if this renderable is drawn instanced with others of the same source file
+		VkDescriptorPool vkDescriptorPool = VK_NULL_HANDLE; // set if this renderable was streamed in after descriptor setup
 
 		// custom info - gameplay or exts
 		void *pSpaceLocationExtChain = nullptr;
@@ -192,6 +316,8 @@ namespace xrvk
 		int32_t fAnimIndex = 0;
 		float fAnimTimer = 0.0f;
 		float fAnimSpeed = 0.01f;
+		std::vector< float > vecAnimWeights; // blend weight per animation, only fAnimIndex is played if empty
+		std::vector< vkglTF::Model::AnimationLayer > vecAnimLayers;
 
 		RenderSceneBase( std::string filename )
 			: sFilename( filename )
@@ -218,30 +344,49 @@ namespace xrvk
 		virtual void GetMatrix( XrMatrix4x4f *matrix ) = 0;
 
 		// functions
+		bool IsInstanceSource() { return pInstanceGroup != nullptr && pInstanceGroup->pSource == this; }
 		glm::vec3 GetScale() { return glm::vec3( currentScale.x, currentScale.y, currentScale.z ); }
 		virtual glm::vec3 GetPosition() = 0;
 		glm::quat GetRotation() { return glm::quat( currentPose.orientation.w, currentPose.orientation.x, currentPose.orientation.y, currentPose.orientation.z ); }
 
 		void PlayAnimations()
 		{
-			if ( !bPlayAnimations )
+			if ( !bPlayAnimations || !bIsLoaded )
 				return;
 
-			// Play animation
 			uint32_t unAnimCount = static_cast< uint32_t >( gltfModel.animations.size() );
-			if ( unAnimCount > 0 )
+			if ( unAnimCount == 0 )
+				return;
+
+			// (1) Advance the shared timer once per update, wrapping at the end of the longest animation
+			float fLongestEnd = 0.0f;
+			for ( auto &animation : gltfModel.animations )
+				fLongestEnd = std::max( fLongestEnd, animation.end );
+
+			fAnimTimer += fAnimSpeed;
+			if ( fLongestEnd > 0.0f && fAnimTimer > fLongestEnd )
+				fAnimTimer = fmodf( fAnimTimer, fLongestEnd );
+
+			// (2) Play the selected animation, or blend all weighted animations - each loops at its own end
+			auto AnimTime = [ & ]( uint32_t unIndex ) { return gltfModel.animations[ unIndex ].end > 0.0f ? fmodf( fAnimTimer, gltfModel.animations[ unIndex ].end ) : 0.0f; };
+
+			vecAnimLayers.clear();
+			if ( vecAnimWeights.empty() )
+			{
+				uint32_t unIndex = std::min( static_cast< uint32_t >( std::max( fAnimIndex, 0 ) ), unAnimCount - 1 );
+				vecAnimLayers.push_back( { unIndex, AnimTime( unIndex ), 1.0f } );
+			}
+			else
 			{
-				for ( uint32_t i = 0; i < unAnimCount; i++ )
+				uint32_t unLayers = std::min( unAnimCount, static_cast< uint32_t >( vecAnimWeights.size() ) );
+				for ( uint32_t i = 0; i < unLayers; i++ )
 				{
-					fAnimTimer += fAnimSpeed;
-					if ( fAnimTimer > gltfModel.animations[ i ].end )
-					{
-						fAnimTimer -= gltfModel.animations[ i ].end;
-					}
-
-					gltfModel.updateAnimation( 0, fAnimTimer );
+					if ( vecAnimWeights[ i ] > 0.0f )
+						vecAnimLayers.push_back( { i, AnimTime( i ), vecAnimWeights[ i ] } );
 				}
 			}
+
+			gltfModel.updateAnimations( vecAnimLayers );
 		}
 	};
 
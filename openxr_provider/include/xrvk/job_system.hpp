@@ -0,0 +1,70 @@
+/* Copyright 2021, 2022, 2023 Rune Berg (GitHub: https://github.com/1runeberg, Twitter: https://twitter.com/1runeberg, YouTube: https://www.youtube.com/@1RuneBerg)
+ *
+ *  SPDX-License-Identifier: MIT
+ *
+ *  Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+ *
+ *  2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *
+ *  3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote products derived from this
+ *     software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ *  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+ *  BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ *  GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+ *  DAMAGE.
+ *
+ */
+
+
+#pragma once
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace xrvk
+{
+	// Fixed pool of worker threads that runs queued jobs in submission order
+	class JobSystem
+	{
+	  public:
+		// Starts the worker threads, a thread count of 0 uses the number of hardware threads
+		JobSystem( uint32_t unThreadCount = 0 );
+
+		// Finishes any queued jobs then joins all worker threads
+		~JobSystem();
+
+		// Queues a job for the next available worker thread
+		std::future< void > Submit( std::function< void() > job );
+
+		// Runs job( i ) for i in [0, unCount) across the worker threads and blocks until all are done
+		void Dispatch( uint32_t unCount, const std::function< void( uint32_t ) > &job );
+
+		uint32_t GetThreadCount() { return static_cast< uint32_t >( m_vecWorkers.size() ); }
+
+	  private:
+		// worker threads
+		std::vector< std::thread > m_vecWorkers;
+
+		// pending jobs, guarded by m_mutexJobs
+		std::deque< std::packaged_task< void() > > m_deqJobs;
+		std::mutex m_mutexJobs;
+		std::condition_variable m_cvJobs;
+		bool m_bStop = false;
+
+		void WorkerLoop();
+	};
+
+} // namespace xrvk
@@ -0,0 +1,134 @@
+/* Copyright 2021, 2022, 2023 Rune Berg (GitHub: https://github.com/1runeberg, Twitter: https://twitter.com/1runeberg, YouTube: https://www.youtube.com/@1RuneBerg)
+ *
+ *  SPDX-License-Identifier: MIT
+ *
+ *  Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+ *
+ *  2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *
+ *  3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote products derived from this
+ *     software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ *  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+ *  BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ *  GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+ *  DAMAGE.
+ *
+ */
+#pragma once
+
+#include "log.hpp"
+
+#include <vulkan/vulkan.h>
+
+#include <map>
+#include <mutex>
+#include <vector>
+
+namespace xrvk
+{
+	static const VkDeviceSize k_unMemoryBlockSize = 64 * 1024 * 1024; // default size of the device memory blocks resources are sub-allocated from
+
+	class MemoryAllocator;
+	struct MemoryBlock;
+
+	// Memory of a single buffer or image, either a range of a shared block or a dedicated allocation
+	struct MemoryAllocation
+	{
+		VkDeviceMemory vkMemory = VK_NULL_HANDLE;
+		VkDeviceSize unOffset = 0;
+		VkDeviceSize unSize = 0;
+
+		// host visible memory is persistently mapped - this points to unOffset, never map the allocation's vkMemory directly
+		void *pMapped = nullptr;
+
+		// owner, null for empty allocations
+		MemoryAllocator *pAllocator = nullptr;
+		uint32_t unMemoryTypeIndex = 0;
+
+		// range reserved in the block including alignment padding, no block for dedicated allocations
+		MemoryBlock *pBlock = nullptr;
+		VkDeviceSize unRangeOffset = 0;
+		VkDeviceSize unRangeSize = 0;
+
+		bool IsValid() const { return vkMemory != VK_NULL_HANDLE; }
+	};
+
+	struct MemoryStats
+	{
+		uint32_t unBlockCount = 0;
+		uint32_t unDedicatedCount = 0;	// allocations too large for a block
+		uint32_t unAllocationCount = 0; // sub-allocations in blocks plus dedicated allocations
+		VkDeviceSize unAllocatedBytes = 0; // device memory allocated from the driver
+		VkDeviceSize unUsedBytes = 0;	   // requested by resources
+		VkDeviceSize unWastedBytes = 0;	   // alignment padding
+		VkDeviceSize unFreeBytes = 0;	   // free ranges in blocks
+		VkDeviceSize unLargestFreeRange = 0;
+
+		// 0 if all free space in blocks is a single range, approaching 1 the more it's split up
+		float GetFragmentation() const { return unFreeBytes == 0 ? 0.f : 1.f - static_cast< float >( unLargestFreeRange ) / static_cast< float >( unFreeBytes ); }
+	};
+
+	// Pooled device memory:
+	// - resources are sub-allocated from large blocks per memory type (best fit in a free list, neighbouring free ranges are merged),
+	//   an empty block keeps being reused, so streaming doesn't hit the driver's allocation count limit or allocation latency
+	// - buffers and optimally tiled images only share blocks if the device's bufferImageGranularity is 1
+	// - resources larger than half a block get a dedicated allocation
+	// - host visible blocks are mapped once for their lifetime
+	// Thread safe, must outlive every allocation made from it
+	class MemoryAllocator
+	{
+	  public:
+		MemoryAllocator( VkPhysicalDevice vkPhysicalDevice, VkDevice vkDevice, VkDeviceSize unBlockSize = k_unMemoryBlockSize );
+
+		// Frees all blocks (including allocations that were never freed)
+		~MemoryAllocator();
+
+		// Allocates memory for a buffer and binds it
+		VkResult AllocateBuffer( VkBuffer vkBuffer, VkMemoryPropertyFlags vkMemoryProperties, MemoryAllocation *pAllocation );
+
+		// Allocates memory for an optimally tiled image and binds it
+		VkResult AllocateImage( VkImage vkImage, VkMemoryPropertyFlags vkMemoryProperties, MemoryAllocation *pAllocation );
+
+		// bLinear - buffers and linearly tiled images
+		VkResult Allocate( const VkMemoryRequirements &vkMemoryRequirements, VkMemoryPropertyFlags vkMemoryProperties, bool bLinear, MemoryAllocation *pAllocation );
+
+		// Resets the allocation, empty allocations are ignored
+		void Free( MemoryAllocation &allocation );
+
+		// Flushes host writes to non coherent memory (no-op for coherent memory), offset is relative to the allocation
+		void Flush( const MemoryAllocation &allocation, VkDeviceSize unOffset = 0, VkDeviceSize unSize = VK_WHOLE_SIZE );
+
+		MemoryStats GetStats();
+		void LogStats();
+
+		VkDeviceSize GetBlockSize() { return m_unBlockSize; }
+
+	  private:
+		VkDevice m_vkDevice = VK_NULL_HANDLE;
+		VkPhysicalDeviceMemoryProperties m_vkMemoryProperties {};
+		VkDeviceSize m_unBufferImageGranularity = 1;
+		VkDeviceSize m_unNonCoherentAtomSize = 1;
+		VkDeviceSize m_unBlockSize = k_unMemoryBlockSize;
+
+		// blocks per pool (memory type, plus resource kind if buffers and images can't share a block), guarded by m_mutex
+		std::vector< std::vector< MemoryBlock * > > m_vecPools;
+		bool m_bSeparateImagePools = false;
+		uint32_t m_unDedicatedCount = 0;
+		VkDeviceSize m_unDedicatedBytes = 0;
+		std::mutex m_mutex;
+
+		uint32_t FindMemoryType( uint32_t unTypeBits, VkMemoryPropertyFlags vkMemoryProperties );
+		bool IsHostVisible( uint32_t unMemoryTypeIndex ) { return m_vkMemoryProperties.memoryTypes[ unMemoryTypeIndex ].propertyFlags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT; }
+		bool IsCoherent( uint32_t unMemoryTypeIndex ) { return m_vkMemoryProperties.memoryTypes[ unMemoryTypeIndex ].propertyFlags & VK_MEMORY_PROPERTY_HOST_COHERENT_BIT; }
+
+		VkResult AllocateDeviceMemory( uint32_t unMemoryTypeIndex, VkDeviceSize unSize, VkDeviceMemory *pMemory, void **ppMapped );
+		bool AllocateFromBlock( MemoryBlock *pBlock, VkDeviceSize unSize, VkDeviceSize unAlignment, MemoryAllocation *pAllocation );
+	};
+
+} // namespace xrvk
@@ -0,0 +1,125 @@
+/* Copyright 2021, 2022, 2023 Rune Berg (GitHub: https://github.com/1runeberg, Twitter: https://twitter.com/1runeberg, YouTube: https://www.youtube.com/@1RuneBerg)
+ *
+ *  SPDX-License-Identifier: MIT
+ *
+ *  Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+ *
+ *  2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *
+ *  3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote products derived from this
+ *     software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ *  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+ *  BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ *  GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+ *  DAMAGE.
+ *
+ */
+
+
+#pragma once
+
+#include "log.hpp"
+#include "vulkanpbr/VulkanglTFModel.h"
+
+#include <memory>
+#include <string>
+
+namespace xrvk
+{
+	// mesh cache file - bump the version whenever the layout or the model structs it mirrors change
+	static const uint32_t k_unMeshCacheMagic = 0x4d565258; // "XRVM"
+	static const uint32_t k_unMeshCacheFileVersion = 1;
+	static const uint64_t k_unMeshCacheAlignment = 16; // section offsets, vertex and index data are used in place
+
+	// Read only memory mapping of a whole file
+	class MappedFile
+	{
+	  public:
+		MappedFile() = default;
+		~MappedFile() { Close(); }
+
+		MappedFile( const MappedFile & ) = delete;
+		MappedFile &operator=( const MappedFile & ) = delete;
+
+		bool Open( const std::string &sFilename );
+		void Close();
+
+		const uint8_t *GetData() { return m_pData; }
+		uint64_t GetSize() { return m_unSize; }
+
+	  private:
+		const uint8_t *m_pData = nullptr;
+		uint64_t m_unSize = 0;
+
+#ifdef _WIN32
+		void *m_hFile = nullptr;
+		void *m_hMapping = nullptr;
+#endif
+	};
+
+	// Preprocessed gltf models - the final interleaved vertex and index data, node hierarchy, materials, skins, animations
+	// and fully mipped rgba8 textures in a single file that's memory mapped on load, so a repeat load skips the gltf parse,
+	// node walk, vertex conversion and image decode and goes straight to staging.
+	// Files are named after the source path and scale, and validated against a hash of the source file(s)
+	class MeshCache
+	{
+	  public:
+		// An empty directory disables the cache
+		MeshCache( const std::string &sDirectory ) : m_sDirectory( sDirectory ) {}
+
+		bool IsEnabled() { return !m_sDirectory.empty(); }
+		const std::string &GetDirectory() { return m_sDirectory; }
+
+		std::string GetFilename( const std::string &sSource, float fScale );
+
+		// FNV-1a over the source file, any external buffers and images it references, and the scale
+		uint64_t HashSource( const std::string &sSource, float fScale );
+
+		// Rebuilds an empty model from a valid cache file and creates its (still empty) buffers - the pending upload reads
+		// directly from the mapped file, which stays mapped until the uploads are staged. Returns false if missing, stale or invalid
+		bool Load( const std::string &sCacheFilename, uint64_t unSourceHash, vkglTF::Model *pModel, vks::VulkanDevice *pVulkanDevice );
+
+		// Writes a model right after parseFromFile (before its uploads are staged), generating the texture mip chains on the cpu
+		bool Save( const std::string &sCacheFilename, uint64_t unSourceHash, vkglTF::Model *pModel );
+
+	  private:
+		std::string m_sDirectory;
+
+		struct FileHeader
+		{
+			uint32_t unMagic = k_unMeshCacheMagic;
+			uint32_t unVersion = k_unMeshCacheFileVersion;
+			uint64_t unSourceHash = 0;
+			uint64_t unFileSize = 0; // catches truncated files
+			uint32_t unVertexStride = sizeof( vkglTF::Model::Vertex );
+			uint32_t unTextureCount = 0;
+			uint64_t unVertexCount = 0;
+			uint64_t unVertexOffset = 0;
+			uint64_t unIndexCount = 0;
+			uint64_t unIndexOffset = 0;
+			uint64_t unModelOffset = 0; // serialized samplers, materials, nodes, skins and animations
+			uint64_t unModelSize = 0;
+		};
+
+		// follows the file header, one per texture slot
+		struct TextureHeader
+		{
+			uint32_t unWidth = 0;
+			uint32_t unHeight = 0;
+			uint32_t unMipLevels = 0;
+			uint32_t unPadding = 0;
+			vkglTF::TextureSampler sampler {};
+			uint64_t unDataOffset = 0;
+			uint64_t unDataSize = 0;
+		};
+
+		void GenerateMips( const uint8_t *pBaseLevel, uint32_t unWidth, uint32_t unHeight, uint32_t unMipLevels, std::vector< uint8_t > &vecMips );
+	};
+
+} // namespace xrvk
@@ -0,0 +1,176 @@
+/* Copyright 2021, 2022, 2023 Rune Berg (GitHub: https://github.com/1runeberg, Twitter: https://twitter.com/1runeberg, YouTube: https://www.youtube.com/@1RuneBerg)
+ *
+ *  SPDX-License-Identifier: MIT
+ *
+ *  Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+ *
+ *  2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *
+ *  3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote products derived from this
+ *     software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ *  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+ *  BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ *  GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+ *  DAMAGE.
+ *
+ */
+
+
+#pragma once
+
+#include "log.hpp"
+#include "vulkanpbr/VulkanDevice.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <deque>
+#include <mutex>
+#include <vector>
+
+namespace xrvk
+{
+	static const VkDeviceSize k_unStagingRingSize = 32 * 1024 * 1024; // default persistently mapped staging ring size
+	static const VkDeviceSize k_unStagingAlignment = 16;				  // staging offsets, covers the texel size of all uploaded formats
+
+	// Completion token of a submitted upload batch, tokens complete in submission order
+	typedef uint64_t UploadToken;
+
+	// Space reserved in the staging ring, valid until the batch it's copied in has completed
+	struct StagingRegion
+	{
+		void *pData = nullptr;
+		VkBuffer vkBuffer = VK_NULL_HANDLE;
+		VkDeviceSize unOffset = 0;
+		VkDeviceSize unSize = 0;
+	};
+
+	// Uploads buffers and images through a persistently mapped staging ring on the transfer queue:
+	// - Stage, CopyBuffer, CopyImage and Submit are called from a single upload thread, which blocks (not the render loop) while the ring is full
+	// - Batches complete on a timeline semaphore (a fence per batch without timeline semaphore support)
+	// - With a dedicated transfer queue family, resources are released to the graphics family and acquired (plus image mip generation)
+	//   in a graphics command buffer with RecordGraphicsWork once their batch has completed, without ever waiting on the gpu
+	class UploadManager
+	{
+	  public:
+		UploadManager(
+			vks::VulkanDevice *pVulkanDevice,
+			VkQueue vkTransferQueue,
+			uint32_t unTransferQueueFamilyIndex,
+			uint32_t unGraphicsQueueFamilyIndex,
+			bool bTimelineSemaphore,
+			VkDeviceSize unRingSize = k_unStagingRingSize );
+
+		// Waits for all submitted batches, then frees the ring
+		~UploadManager();
+
+		// Upload thread - reserve staging space, data is written directly to pData
+		StagingRegion Stage( VkDeviceSize unSize );
+
+		// Upload thread - record copies from staged data into the current batch
+		void CopyBuffer( const StagingRegion &region, VkBuffer vkBuffer, VkDeviceSize unDstOffset = 0 );
+
+		// Upload thread - copies the staged mips of an rgba8 image (created with transfer src and dst usage), stored back to back in the region.
+		// Either only mip 0 is staged and the remaining mips are generated by blits, or the whole chain is. The image ends up in shader read only layout
+		void CopyImage( const StagingRegion &region, VkImage vkImage, uint32_t unWidth, uint32_t unHeight, uint32_t unMipLevels, uint32_t unStagedMipLevels = 1 );
+
+		// Upload thread - submits the current batch (if not empty) and returns its completion token
+		UploadToken Submit();
+
+		// Upload thread - blocks until a batch has completed
+		void Wait( UploadToken unToken );
+
+		// Upload thread - frees the staging space and command buffers of completed batches
+		void Poll() { RetireBatches( false ); }
+
+		// Any thread - non blocking completion checks
+		UploadToken GetCompletedToken();
+		bool IsComplete( UploadToken unToken ) { return unToken <= GetCompletedToken(); }
+
+		// Render thread - records queue family acquires and mip generation of all completed batches into a graphics command buffer (outside a render pass),
+		// resources of batches up to GetRecordedToken() can be used in commands recorded after this
+		uint32_t RecordGraphicsWork( VkCommandBuffer vkCommandBuffer );
+		UploadToken GetRecordedToken() { return m_unRecordedToken.load(); }
+
+		// Blocking RecordGraphicsWork on the graphics queue, for loads outside of the frame loop (e.g. startup)
+		void SubmitGraphicsWork( VkQueue vkGraphicsQueue );
+
+		bool IsDedicatedTransferQueue() { return m_unTransferQueueFamilyIndex != m_unGraphicsQueueFamilyIndex; }
+		bool IsTimelineSemaphoreEnabled() { return m_vkTimelineSemaphore != VK_NULL_HANDLE; }
+		VkDeviceSize GetRingSize() { return m_unRingSize; }
+
+	  private:
+		vks::VulkanDevice *m_pVulkanDevice = nullptr;
+		VkQueue m_vkTransferQueue = VK_NULL_HANDLE;
+		uint32_t m_unTransferQueueFamilyIndex = 0;
+		uint32_t m_unGraphicsQueueFamilyIndex = 0;
+
+		// staging ring - positions only ever grow, the ring offset is position % size
+		VkBuffer m_vkRingBuffer = VK_NULL_HANDLE;
+		MemoryAllocation m_RingMemory {};
+		uint8_t *m_pRingData = nullptr;
+		VkDeviceSize m_unRingSize = 0;
+		VkDeviceSize m_unRingHead = 0;
+		VkDeviceSize m_unRingTail = 0;
+
+		// staging buffer for uploads larger than the ring, freed with its batch
+		struct DedicatedStaging
+		{
+			VkBuffer vkBuffer = VK_NULL_HANDLE;
+			MemoryAllocation memory {};
+		};
+
+		// submitted batches not yet retired (upload thread only)
+		struct Batch
+		{
+			UploadToken unToken = 0;
+			VkCommandBuffer vkCommandBuffer = VK_NULL_HANDLE;
+			VkFence vkFence = VK_NULL_HANDLE; // without timeline semaphores
+			VkDeviceSize unRingEnd = 0;
+			std::vector< DedicatedStaging > vecDedicatedStaging;
+		};
+
+		std::deque< Batch > m_deqBatches;
+		VkCommandPool m_vkCommandPool = VK_NULL_HANDLE;
+
+		// batch being recorded (upload thread only)
+		VkCommandBuffer m_vkCurrentCommandBuffer = VK_NULL_HANDLE;
+		std::vector< DedicatedStaging > m_vecCurrentDedicatedStaging;
+		UploadToken m_unNextToken = 1;
+
+		// completion
+		VkSemaphore m_vkTimelineSemaphore = VK_NULL_HANDLE;
+		PFN_vkGetSemaphoreCounterValueKHR m_pfnGetSemaphoreCounterValue = nullptr;
+		PFN_vkWaitSemaphoresKHR m_pfnWaitSemaphores = nullptr;
+		std::atomic< UploadToken > m_unCompletedToken { 0 }; // fence path, updated when batches retire
+
+		// graphics queue side of uploads, consumed by RecordGraphicsWork
+		struct GraphicsWork
+		{
+			UploadToken unToken = 0;
+			VkBuffer vkBuffer = VK_NULL_HANDLE; // either a buffer range ...
+			VkDeviceSize unOffset = 0;
+			VkDeviceSize unSize = 0;
+			VkImage vkImage = VK_NULL_HANDLE; // ... or an image
+			uint32_t unWidth = 0;
+			uint32_t unHeight = 0;
+			uint32_t unMipLevels = 1;
+			bool bGenerateMips = false; // only mip 0 was copied
+		};
+
+		std::vector< GraphicsWork > m_vecPendingGraphicsWork; // current batch (upload thread only)
+		std::deque< GraphicsWork > m_deqGraphicsWork;		  // submitted batches, guarded by m_mutexGraphicsWork
+		std::mutex m_mutexGraphicsWork;
+		std::atomic< UploadToken > m_unRecordedToken { 0 };
+
+		VkCommandBuffer GetCommandBuffer();
+		void RetireBatches( bool bWaitOldest );
+		void GenerateMips( VkCommandBuffer vkCommandBuffer, VkImage vkImage, uint32_t unWidth, uint32_t unHeight, uint32_t unMipLevels );
+	};
+
+} // namespace xrvk
@@ -14,6 +14,7 @@
 #include <assert.h>
 #include <algorithm>
 #include <cstring>
+#include <mutex>
 #include <vector>
 #include "vulkan/vulkan.h"
 
@@ -36,6 +37,8 @@
 
 #include "macros.h"
 
+#include <xrvk/memory_allocator.hpp>
+
 namespace vks
 {	
 	struct VulkanDevice
@@ -48,6 +51,10 @@ namespace vks
 		VkPhysicalDeviceMemoryProperties memoryProperties;
 		std::vector<VkQueueFamilyProperties> queueFamilyProperties;
 		VkCommandPool commandPool = VK_NULL_HANDLE;
+		// Serializes submissions to the shared queue (e.g. loader threads vs. the render loop)
+		std::mutex queueMutex;
+		// Sub-allocates the memory of all buffers and images, set up once the logical device exists (owned by the renderer)
+		xrvk::MemoryAllocator *memoryAllocator = nullptr;
 
 
 #if defined(__ANDROID__)
@@ -250,19 +257,21 @@ namespace vks
 		}
 
 		/**
-		* Create a buffer on the device
+		* Create a buffer on the device, its memory is sub-allocated from memoryAllocator
 		*
 		* @param usageFlags Usage flag bitmask for the buffer (i.e. index, vertex, uniform buffer)
 		* @param memoryPropertyFlags Memory properties for this buffer (i.e. device local, host visible, coherent)
 		* @param size Size of the buffer in byes
 		* @param buffer Pointer to the buffer handle acquired by the function
-		* @param memory Pointer to the memory handle acquired by the function
+		* @param memory Pointer to the memory allocation acquired by the function (free with memoryAllocator->Free)
 		* @param data Pointer to the data that should be copied to the buffer after creation (optional, if not set, no data is copied over)
 		*
 		* @return VK_SUCCESS if buffer handle and memory have been created and (optionally passed) data has been copied
 		*/
-		VkResult createBuffer(VkBufferUsageFlags usageFlags, VkMemoryPropertyFlags memoryPropertyFlags, VkDeviceSize size, VkBuffer *buffer, VkDeviceMemory *memory, void *data = nullptr)
+		VkResult createBuffer(VkBufferUsageFlags usageFlags, VkMemoryPropertyFlags memoryPropertyFlags, VkDeviceSize size, VkBuffer *buffer, xrvk::MemoryAllocation *memory, void *data = nullptr)
 		{
+			assert(memoryAllocator);
+
 			// Create the buffer handle
 			VkBufferCreateInfo bufferCreateInfo{};
 			bufferCreateInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
@@ -271,38 +280,23 @@ namespace vks
 			bufferCreateInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
 			VK_CHECK_RESULT(vkCreateBuffer(logicalDevice, &bufferCreateInfo, nullptr, buffer));
 
-			// Create the memory backing up the buffer handle
-			VkMemoryRequirements memReqs;
-			VkMemoryAllocateInfo memAlloc{};
-			memAlloc.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
-			vkGetBufferMemoryRequirements(logicalDevice, *buffer, &memReqs);
-			memAlloc.allocationSize = memReqs.size;
-			// Find a memory type index that fits the properties of the buffer
-			memAlloc.memoryTypeIndex = getMemoryType(memReqs.memoryTypeBits, memoryPropertyFlags);
-			VK_CHECK_RESULT(vkAllocateMemory(logicalDevice, &memAlloc, nullptr, memory));
-			
-			// If a pointer to the buffer data has been passed, map the buffer and copy over the data
+			// Sub-allocate and bind the memory backing up the buffer handle
+			VkResult result = memoryAllocator->AllocateBuffer(*buffer, memoryPropertyFlags, memory);
+			if (result != VK_SUCCESS) {
+				vkDestroyBuffer(logicalDevice, *buffer, nullptr);
+				*buffer = VK_NULL_HANDLE;
+				return result;
+			}
+
+			// If a pointer to the buffer data has been passed, copy it over (host visible memory is persistently mapped)
 			if (data != nullptr)
 			{
-				void *mapped;
-				VK_CHECK_RESULT(vkMapMemory(logicalDevice, *memory, 0, size, 0, &mapped));
-				memcpy(mapped, data, size);
-				// If host coherency hasn't been requested, do a manual flush to make writes visible
-				if ((memoryPropertyFlags & VK_MEMORY_PROPERTY_HOST_COHERENT_BIT) == 0)
-				{
-					VkMappedMemoryRange mappedRange{};
-					mappedRange.sType = VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE;
-					mappedRange.memory = *memory;
-					mappedRange.offset = 0;
-					mappedRange.size = size;
-					vkFlushMappedMemoryRanges(logicalDevice, 1, &mappedRange);
-				}
-				vkUnmapMemory(logicalDevice, *memory);
+				assert(memory->pMapped);
+				memcpy(memory->pMapped, data, size);
+				// Non coherent memory needs a manual flush to make writes visible
+				memoryAllocator->Flush(*memory, 0, size);
 			}
 
-			// Attach the memory to the buffer object
-			VK_CHECK_RESULT(vkBindBufferMemory(logicalDevice, *buffer, *memory, 0));
-
 			return VK_SUCCESS;
 		}
 
@@ -336,10 +330,24 @@ namespace vks
 		* @return A handle to the allocated command buffer
 		*/
 		VkCommandBuffer createCommandBuffer(VkCommandBufferLevel level, bool begin = false)
+		{
+			return createCommandBuffer(level, commandPool, begin);
+		}
+
+		/**
+		* Allocate a command buffer from a specific command pool
+		*
+		* @param level Level of the new command buffer (primary or secondary)
+		* @param pool Command pool to allocate from (e.g. one owned by a loader thread)
+		* @param (Optional) begin If true, recording on the new command buffer will be started (vkBeginCommandBuffer) (Defaults to false)
+		*
+		* @return A handle to the allocated command buffer
+		*/
+		VkCommandBuffer createCommandBuffer(VkCommandBufferLevel level, VkCommandPool pool, bool begin = false)
 		{
 			VkCommandBufferAllocateInfo cmdBufAllocateInfo{};
 			cmdBufAllocateInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
-			cmdBufAllocateInfo.commandPool = commandPool;
+			cmdBufAllocateInfo.commandPool = pool;
 			cmdBufAllocateInfo.level = level;
 			cmdBufAllocateInfo.commandBufferCount = 1;
 
@@ -374,7 +382,22 @@ namespace vks
 		* @note Uses a fence to ensure command buffer has finished executing
 		*/
 		void flushCommandBuffer(VkCommandBuffer commandBuffer, VkQueue queue, bool free = true)
-		{			
+		{
+			flushCommandBuffer(commandBuffer, queue, commandPool, free);
+		}
+
+		/**
+		* Finish command buffer recording and submit it to a queue
+		*
+		* @param commandBuffer Command buffer to flush
+		* @param queue Queue to submit the command buffer to
+		* @param pool Command pool the command buffer was allocated from
+		* @param (Optional) free Free the command buffer once it has been submitted (Defaults to true)
+		*
+		* @note The submission is serialized with queueMutex, waiting on the fence is not
+		*/
+		void flushCommandBuffer(VkCommandBuffer commandBuffer, VkQueue queue, VkCommandPool pool, bool free = true)
+		{
 			VK_CHECK_RESULT(vkEndCommandBuffer(commandBuffer));
 
 			VkSubmitInfo submitInfo{};
@@ -389,14 +412,17 @@ namespace vks
 			VK_CHECK_RESULT(vkCreateFence(logicalDevice, &fenceInfo, nullptr, &fence));
 			
 			// Submit to the queue
-			VK_CHECK_RESULT(vkQueueSubmit(queue, 1, &submitInfo, fence));
+			{
+				const std::lock_guard<std::mutex> lock(queueMutex);
+				VK_CHECK_RESULT(vkQueueSubmit(queue, 1, &submitInfo, fence));
+			}
 			// Wait for the fence to signal that command buffer has finished executing
 			VK_CHECK_RESULT(vkWaitForFences(logicalDevice, 1, &fence, VK_TRUE, 100000000000));
 
 			vkDestroyFence(logicalDevice, fence, nullptr);
 
 			if (free) {
-				vkFreeCommandBuffers(logicalDevice, commandPool, 1, &commandBuffer);
+				vkFreeCommandBuffers(logicalDevice, pool, 1, &commandBuffer);
 			}
 		}
 	};
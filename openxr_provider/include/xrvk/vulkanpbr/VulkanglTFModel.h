@@ -13,7 +13,8 @@
 #include <string>
 #include <fstream>
 #include <vector>
-#include <mutex>
+#include <memory>
+#include <algorithm>
 
 #include "vulkan/vulkan.h"
 #include "VulkanDevice.hpp"
@@ -46,6 +47,14 @@
 // Changing this value here also requires changing it in the vertex shader
 #define MAX_NUM_JOINTS 128u
 
+// Frame regions of a model's mesh uniform buffer, tracked with one bit each in Mesh::staleFrames
+#define MAX_MESH_UNIFORM_FRAMES 32u
+
+namespace xrvk
+{
+	class UploadManager;
+}
+
 namespace vkglTF
 {
 	struct Node;
@@ -68,21 +77,28 @@ namespace vkglTF
 	};
 
 	struct Texture {
-		vks::VulkanDevice *device;
-		VkImage image;
+		vks::VulkanDevice *device = nullptr;
+		VkImage image = VK_NULL_HANDLE;
 		VkImageLayout imageLayout;
-		VkDeviceMemory deviceMemory;
-		VkImageView view;
+		xrvk::MemoryAllocation deviceMemory;
+		VkImageView view = VK_NULL_HANDLE;
 		uint32_t width, height;
 		uint32_t mipLevels;
 		uint32_t layerCount;
 		VkDescriptorImageInfo descriptor;
-		VkSampler sampler;
+		VkSampler sampler = VK_NULL_HANDLE;
 
 		void updateDescriptor();
 		void destroy();
 		// Load a texture from a glTF image (stored as vector of chars loaded via stb_image) and generate a full mip chain for it
-		void fromglTfImage(tinygltf::Image& gltfimage, TextureSampler textureSampler, vks::VulkanDevice* device, VkQueue copyQueue);
+		// commandPool defaults to the device's pool, threads other than the main one must pass their own
+		void fromglTfImage(tinygltf::Image& gltfimage, TextureSampler textureSampler, vks::VulkanDevice* device, VkQueue copyQueue, VkCommandPool commandPool = VK_NULL_HANDLE);
+		// Create an empty rgba8 image (full mip chain), sampler and view, for uploads recorded elsewhere
+		void createImage(uint32_t width, uint32_t height, TextureSampler textureSampler, vks::VulkanDevice* device);
+		// Write a glTF image as rgba8 (width * height * 4 bytes)
+		static void copyRGBA(const tinygltf::Image& gltfimage, unsigned char* dst);
+		// Size of the first mipLevels of an rgba8 mip chain stored back to back
+		static VkDeviceSize getRGBASize(uint32_t width, uint32_t height, uint32_t mipLevels);
 	};
 
 	struct Material {		
@@ -136,13 +152,10 @@ namespace vkglTF
 		std::vector<Primitive*> primitives;
 		BoundingBox bb;
 		BoundingBox aabb;
-		struct UniformBuffer {
-			VkBuffer buffer;
-			VkDeviceMemory memory;
-			VkDescriptorBufferInfo descriptor;
-			VkDescriptorSet descriptorSet;
-			void *mapped;
-		} uniformBuffer;
+		// Slot of this mesh in the model's mesh uniform buffer
+		uint32_t uniformIndex = 0;
+		// Frame regions of the model's mesh uniform buffer that don't hold the current uniformBlock yet (one bit per frame slot, up to MAX_MESH_UNIFORM_FRAMES)
+		uint32_t staleFrames = UINT32_MAX;
 		struct UniformBlock {
 			glm::mat4 matrix;
 			glm::mat4 jointMatrix[MAX_NUM_JOINTS]{};
@@ -174,9 +187,21 @@ namespace vkglTF
 		glm::quat rotation{};
 		BoundingBox bvh;
 		BoundingBox aabb;
+		// Cached transforms, refreshed by Model::updateTransforms
+		glm::mat4 worldMatrix{ 1.0f };
+		glm::mat4 cachedLocalMatrix{ 1.0f };
+		glm::vec3 cachedTranslation{};
+		glm::vec3 cachedScale{ 1.0f };
+		glm::quat cachedRotation{};
+		// Forces a recompute of the local matrix (translation, rotation and scale changes are detected automatically)
+		bool dirty = true;
+		// World matrix changed in the last transform update
+		bool worldChanged = false;
 		glm::mat4 localMatrix();
 		glm::mat4 getMatrix();
 		void update();
+		void updateWorldMatrix(bool parentChanged, uint32_t &recomputed);
+		void updateUniformBlock();
 		~Node();
 	};
 
@@ -185,13 +210,21 @@ namespace vkglTF
 		PathType path;
 		Node *node;
 		uint32_t samplerIndex;
+		// Keyframe found by the last evaluation, playback stays on it or moves to the next one most of the time
+		size_t cursor = 0;
 	};
 
 	struct AnimationSampler {
 		enum InterpolationType { LINEAR, STEP, CUBICSPLINE };
 		InterpolationType interpolation;
 		std::vector<float> inputs;
+		// Cubic spline samplers store an in tangent, the value and an out tangent per keyframe
 		std::vector<glm::vec4> outputsVec4;
+		bool isValid() const;
+		// Index i of the keyframes with inputs[i] <= time < inputs[i + 1] (clamped to the first and last pair), tries the cursor before a binary search
+		size_t findKeyframe(float time, size_t &cursor) const;
+		// Interpolated output at time, rotations are quaternions (x, y, z, w)
+		glm::vec4 evaluate(float time, size_t &cursor, bool rotation) const;
 	};
 
 	struct Animation {
@@ -207,9 +240,6 @@ namespace vkglTF
 		// Reference to vulkan logical device
 		vks::VulkanDevice *device;
 
-		// mutex for vulkan queue operations
-		std::mutex mutexVulkanQueue;
-
 		struct Vertex {
 			glm::vec3 pos;
 			glm::vec3 normal;
@@ -222,12 +252,12 @@ namespace vkglTF
 
 		struct Vertices {
 			VkBuffer buffer = VK_NULL_HANDLE;
-			VkDeviceMemory memory;
+			xrvk::MemoryAllocation memory;
 		} vertices;
 		struct Indices {
 			int count;
 			VkBuffer buffer = VK_NULL_HANDLE;
-			VkDeviceMemory memory;
+			xrvk::MemoryAllocation memory;
 		} indices;
 
 		glm::mat4 aabb;
@@ -237,12 +267,46 @@ namespace vkglTF
 
 		std::vector<Skin*> skins;
 
+		// Transform update counters, accumulated until resetTransformCounters
+		uint32_t nodesRecomputed = 0;
+		uint32_t uniformBuffersWritten = 0;
+
+		// Uniform data of all meshes in one persistently mapped buffer, split in one region per frame slot.
+		// Meshes are addressed with dynamic offsets (frame * frameSize + uniformIndex * stride) into a single descriptor set
+		struct MeshUniforms {
+			VkBuffer buffer = VK_NULL_HANDLE;
+			xrvk::MemoryAllocation memory;
+			VkDescriptorBufferInfo descriptor{};
+			VkDescriptorSet descriptorSet = VK_NULL_HANDLE;
+			VkDeviceSize stride = 0;
+			VkDeviceSize frameSize = 0;
+			uint32_t frameCount = 0;
+			uint32_t meshCount = 0;
+		} meshUniforms;
+
 		std::vector<Texture> textures;
 		std::vector<TextureSampler> textureSamplers;
 		std::vector<Material> materials;
 		std::vector<Animation> animations;
 		std::vector<std::string> extensions;
 
+		// Animation evaluated at time and blended with the other layers by weight
+		struct AnimationLayer {
+			uint32_t index;
+			float time;
+			float weight = 1.0f;
+		};
+
+		// Weighted sums of the animated node properties (by node index), reset after each update
+		struct AnimationBlend {
+			glm::vec3 translation{};
+			glm::vec4 rotation{};
+			glm::vec3 scale{};
+			float weights[3]{};
+		};
+		std::vector<AnimationBlend> animationBlend;
+		std::vector<Node*> animationTargets;
+
 		struct Dimensions {
 			glm::vec3 min = glm::vec3(FLT_MAX);
 			glm::vec3 max = glm::vec3(-FLT_MAX);
@@ -255,22 +319,65 @@ namespace vkglTF
 			size_t vertexPos = 0;
 		};
 
+		// State kept between parseFromFile (or a mesh cache load) and the gpu uploads
+		struct PendingUpload {
+			tinygltf::Model gltfModel;
+			// Final vertex and index data, either owned here or pointing into sourceData
+			std::vector<Vertex> vertexStorage;
+			std::vector<uint32_t> indexStorage;
+			const Vertex* vertexData = nullptr;
+			size_t vertexCount = 0;
+			const uint32_t* indexData = nullptr;
+			size_t indexCount = 0;
+			// RGBA8 data per texture slot, mipLevels are stored back to back in data (the rest of the chain is generated on upload)
+			struct TextureData {
+				const unsigned char* data = nullptr;
+				uint32_t width = 0;
+				uint32_t height = 0;
+				uint32_t mipLevels = 1;
+				TextureSampler sampler{};
+			};
+			std::vector<TextureData> textureData;
+			// Keeps the data source (e.g. a mapped cache file) alive until the uploads are staged
+			std::shared_ptr<void> sourceData;
+		};
+		std::unique_ptr<PendingUpload> pendingUpload;
+
 		void destroy(VkDevice device);
 		void loadNode(vkglTF::Node* parent, const tinygltf::Node& node, uint32_t nodeIndex, const tinygltf::Model& model, LoaderInfo& loaderInfo, float globalscale);
 		void getNodeProps(const tinygltf::Node& node, const tinygltf::Model& model, size_t& vertexCount, size_t& indexCount);
 		void loadSkins(tinygltf::Model& gltfModel);
-		void loadTextures(tinygltf::Model& gltfModel, vks::VulkanDevice* device, VkQueue transferQueue);
+		void loadTextures(tinygltf::Model& gltfModel, vks::VulkanDevice* device, VkQueue transferQueue, VkCommandPool commandPool = VK_NULL_HANDLE);
+		TextureSampler getTextureSampler(const tinygltf::Texture& tex);
 		VkSamplerAddressMode getVkWrapMode(int32_t wrapMode);
 		VkFilter getVkFilterMode(int32_t filterMode);
 		void loadTextureSamplers(tinygltf::Model& gltfModel);
 		void loadMaterials(tinygltf::Model& gltfModel);
 		void loadAnimations(tinygltf::Model& gltfModel);
 		void loadFromFile(std::string filename, vks::VulkanDevice* device, VkQueue transferQueue, float scale = 1.0f);
+		// Split load used by threaded loaders: parseFromFile does the file read, parse and decode and creates the (still empty) buffers,
+		// stageUploads then writes all textures and geometry to the upload manager's staging ring and records their copies
+		bool parseFromFile(std::string filename, vks::VulkanDevice* device, float scale = 1.0f);
+		void stageUploads(xrvk::UploadManager* uploadManager);
+		// Creates the (still empty) device local vertex and index buffers for the pending upload
+		void createBuffers();
+		// Blocking uploads, used by loadFromFile
+		void uploadTextures(VkQueue transferQueue, VkCommandPool commandPool = VK_NULL_HANDLE);
+		void uploadGeometry(VkQueue transferQueue);
+		void releasePendingUpload();
 		void drawNode(Node* node, VkCommandBuffer commandBuffer);
 		void draw(VkCommandBuffer commandBuffer);
 		void calculateBoundingBox(Node* node, Node* parent);
 		void getSceneDimensions();
 		void updateAnimation(uint32_t index, float time);
+		void updateAnimations(const std::vector<AnimationLayer>& layers);
+		void updateTransforms();
+		// Creates the mesh uniform buffer (call once the model is loaded), the descriptor set is left to the renderer
+		void createMeshUniforms(uint32_t frameCount);
+		// Copies the uniform blocks that changed since this frame region was last written
+		void writeMeshUniforms(uint32_t frame);
+		uint32_t getMeshUniformOffset(const Mesh* mesh, uint32_t frame) const;
+		void resetTransformCounters();
 		Node* findNode(Node* parent, uint32_t index);
 		Node* nodeFromIndex(uint32_t index);
 	};
@@ -29,8 +29,16 @@
 
 #pragma once
 
+#include "asset_loader.hpp"
 #include "data_types.hpp"
+#include "job_system.hpp"
+#include "memory_allocator.hpp"
+#include <algorithm>
+#include <atomic>
 #include <future>
+#include <memory>
+#include <thread>
+#include <unordered_map>
 
 namespace Shapes
 {
@@ -108,11 +116,128 @@ namespace Shapes
 			return shape;
 		}
 	};
+
+	// Per instance data of a shape batch - read as instance rate vertex attributes by shape_instanced.vert
+	struct ShapeInstance
+	{
+		XrQuaternionf orientation { 0.f, 0.f, 0.f, 1.f };
+		XrVector3f position { 0.f, 0.f, 0.f };
+		XrVector3f scale { 1.f, 1.f, 1.f };
+		XrVector3f color { 1.f, 1.f, 1.f }; // multiplied with the vertex colors
+	};
+
+	// A single shape mesh and pipeline drawn for all of its instances with one draw call per render (see xrvk::Render::AddShapeBatch).
+	// Instances live in a persistently mapped ring with a fixed capacity, one region per frame slot. Add() writes the new instance into
+	// every region and only then publishes it by bumping the count (release), draws read the count (acquire) - so appending (e.g. paint
+	// strokes) is O(1), never allocates and is safe from any thread, including action callbacks on the input thread.
+	// Set() changes instances that frames in flight may still be drawing, so it's render thread only: it goes through a cpu copy that is
+	// written to each region when that region's frame slot is next drawn
+	struct ShapeBatch
+	{
+		static const uint32_t k_unInvalidIndex = UINT32_MAX;
+
+		bool bIsVisible = true;
+
+		xrvk::Buffer indexBuffer {};
+		xrvk::Buffer vertexBuffer {};
+		VkPipeline pipeline = VK_NULL_HANDLE;
+
+		// false if the instanced vertex shader isn't available - each instance is then drawn on its own with the per shape pipeline
+		bool bInstanced = true;
+
+		// gpu ring, unCapacity instances per region (instanced batches only)
+		xrvk::Buffer instanceBuffer {};
+		uint32_t unCapacity = 0;
+		uint32_t unRegions = 0;
+
+		// cpu copy of every instance - the source of Set() updates and of non instanced draws
+		std::unique_ptr< ShapeInstance[] > pInstances;
+
+		// instances changed by Set() since each region was last drawn, as a [first, last) range
+		std::vector< std::pair< uint32_t, uint32_t > > vecRegionChanges;
+
+		// slots handed out by Add(), and the leading slots that are written and visible to draws
+		std::atomic< uint32_t > unReserved { 0 };
+		std::atomic< uint32_t > unCount { 0 };
+
+		~ShapeBatch()
+		{
+			indexBuffer.destroy();
+			vertexBuffer.destroy();
+			instanceBuffer.destroy();
+		}
+
+		uint32_t Count() { return unCount.load( std::memory_order_acquire ); }
+		uint32_t Capacity() { return unCapacity; }
+
+		// Appends an instance, returns its index or k_unInvalidIndex if the batch is full. Any thread
+		uint32_t Add( const ShapeInstance &instance )
+		{
+			// (1) Claim a slot - slots past the capacity are never published
+			const uint32_t unIndex = unReserved.fetch_add( 1, std::memory_order_relaxed );
+			if ( unIndex >= unCapacity )
+				return k_unInvalidIndex;
+
+			// (2) Fill it in everywhere, no draw reads it until it's published
+			pInstances[ unIndex ] = instance;
+
+			ShapeInstance *pRing = static_cast< ShapeInstance * >( instanceBuffer.mapped );
+			for ( uint32_t i = 0; pRing && i < unRegions; i++ )
+				pRing[ unCapacity * i + unIndex ] = instance;
+
+			// (3) Publish in slot order - concurrent appends wait for the slots claimed before theirs
+			while ( unCount.load( std::memory_order_acquire ) != unIndex )
+				std::this_thread::yield();
+
+			unCount.store( unIndex + 1, std::memory_order_release );
+			return unIndex;
+		}
+
+		// Replaces an instance that was already added. Render thread only
+		void Set( uint32_t unIndex, const ShapeInstance &instance )
+		{
+			assert( unIndex < Count() );
+			pInstances[ unIndex ] = instance;
+
+			for ( auto &changes : vecRegionChanges )
+			{
+				changes.first = std::min( changes.first, unIndex );
+				changes.second = std::max( changes.second, unIndex + 1 );
+			}
+		}
+	};
 } // namespace Shapes
 
 namespace xrvk
 {
-	static const uint32_t k_unCommandBufferNum = 2; // (double buffer)
+	static const uint32_t k_unCommandBufferNum = 2; // (double buffer) default number of frames in flight
+	static const uint32_t k_unMultiviewCount = 2;	// (stereo - single pass)
+	static const uint32_t k_unMaxFramesInFlight = MAX_MESH_UNIFORM_FRAMES; // max frame slots (frames in flight x renders per frame) - mesh uniform staleness is tracked in a 32 bit mask per mesh
+
+	// secondary command buffers per frame slot when recording in parallel
+	static const uint32_t k_unSecondaryPre = 0;			// vismask and skybox
+	static const uint32_t k_unSecondaryPost = 1;		// basic geometry (shapes)
+	static const uint64_t k_unFrameSlotTimeoutNs = 1000000000ull; // how long a render waits for its frame slot's previous render before it's skipped
+	static const uint32_t k_unSecondaryFirstChunk = 2;	// renderables, one per worker thread
+
+	// descriptor indexing (bindless materials) - upper bounds, the texture array is further clamped to the device limits
+	static const uint32_t k_unBindlessMaxTextures = 4096;
+	static const uint32_t k_unBindlessMaxMaterials = 4096;
+
+	// instance culling prepass - invocations per workgroup, must match local_size_x in instance_cull.comp
+	static const uint32_t k_unInstanceCullGroupSize = 64;
+
+	// pipeline cache file - a small xrvk header followed by the driver's pipeline cache data
+	static const uint32_t k_unPipelineCacheMagic = 0x43565258; // "XRVC"
+	static const uint32_t k_unPipelineCacheFileVersion = 1;
+
+	// image based lighting - generated texture sizes and filter samples, bump the cache version when the generation itself changes
+	static const uint32_t k_unIrradianceDim = 64;
+	static const uint32_t k_unPrefilteredDim = 512;
+	static const uint32_t k_unPrefilterSamples = 32;
+	static const uint32_t k_unBRDFLUTDim = 512;
+	static const uint32_t k_unIBLCacheMagic = 0x49565258; // "XRVI"
+	static const uint32_t k_unIBLCacheFileVersion = 1;
 
 	class Render
 	{
@@ -147,16 +272,17 @@ namespace xrvk
 		struct UniformBufferSet
 		{
 			Buffer scene;
+			Buffer skybox;
 			Buffer params;
 
 			~UniformBufferSet()
 			{
 				scene.destroy();
+				skybox.destroy();
 				params.destroy();
 			}
 		};
-		Buffer skyboxUniformBuffer;
-		std::vector< UniformBufferSet > vecUniformBuffers;
+		std::vector< UniformBufferSet > vecUniformBuffers; // one set per frame slot
 
 		std::vector< std::vector< Buffer > > vecvecUniformBuffers_Shapes;
 
@@ -179,11 +305,21 @@ namespace xrvk
 			XrVector3f eyePos;
 		} uboMatricesScene, uboMatricesSkybox;
 
+		// Scene ubo for multiview - all views are rendered in a single pass and picked in the shaders via gl_ViewIndex
+		struct UBOMatricesMultiview
+		{
+			XrMatrix4x4f vp[ k_unMultiviewCount ];
+			XrMatrix4x4f model;
+			XrVector4f eyePos[ k_unMultiviewCount ];
+		} uboMatricesSceneMultiview, uboMatricesSkyboxMultiview;
+
 		struct DescriptorSetLayouts
 		{
 			VkDescriptorSetLayout scene = VK_NULL_HANDLE;
 			VkDescriptorSetLayout material = VK_NULL_HANDLE;
 			VkDescriptorSetLayout node = VK_NULL_HANDLE;
+			VkDescriptorSetLayout instance = VK_NULL_HANDLE;
+			VkDescriptorSetLayout instanceCull = VK_NULL_HANDLE;
 		} descriptorSetLayouts;
 
 		struct DescriptorSets
@@ -193,23 +329,16 @@ namespace xrvk
 		};
 		std::vector< DescriptorSets > vecDescriptorSets;
 
-		struct PushConstBlockMaterial
+		using PushConstBlockMaterial = xrvk::PushConstBlockMaterial;
+		PushConstBlockMaterial pushConstBlockMaterial;
+
+		// Vismasks for all views are drawn in the same pass for multiview, the vertex shader discards vertices outside of this view index
+		struct PushConstVisMaskMultiview
 		{
-			glm::vec4 baseColorFactor;
-			glm::vec4 emissiveFactor;
-			glm::vec4 diffuseFactor;
-			glm::vec4 specularFactor;
-			float workflow;
-			int colorTextureSet;
-			int PhysicalDescriptorTextureSet;
-			int normalTextureSet;
-			int occlusionTextureSet;
-			int emissiveTextureSet;
-			float metallicFactor;
-			float roughnessFactor;
-			float alphaMask;
-			float alphaMaskCutoff;
-		} pushConstBlockMaterial;
+			XrMatrix4x4f mvp;
+			uint32_t unViewIndex = 0;
+			uint32_t unPadding[ 3 ] = { 0, 0, 0 };
+		};
 
 		struct Pipelines
 		{
@@ -218,6 +347,10 @@ namespace xrvk
 			VkPipeline pbr = VK_NULL_HANDLE;
 			VkPipeline pbrDoubleSided = VK_NULL_HANDLE;
 			VkPipeline pbrAlphaBlend = VK_NULL_HANDLE;
+			VkPipeline pbrInstanced = VK_NULL_HANDLE;
+			VkPipeline pbrDoubleSidedInstanced = VK_NULL_HANDLE;
+			VkPipeline pbrAlphaBlendInstanced = VK_NULL_HANDLE;
+			VkPipeline instanceCull = VK_NULL_HANDLE;
 		} pipelines;
 
 		struct VisMask
@@ -248,13 +381,12 @@ namespace xrvk
 		VkDeviceSize vkDeviceSizeOffsets[ 1 ] = { 0 };
 		VkDescriptorPool vkDescriptorPool = VK_NULL_HANDLE;
 
-		// pipelines
-		VkPipeline vkBoundPipeline = VK_NULL_HANDLE;
-
 		// pipeline layouts
 		VkPipelineLayout vkPipelineLayout = VK_NULL_HANDLE;
 		VkPipelineLayout vkPipelineLayoutVisMask = VK_NULL_HANDLE;
 		VkPipelineLayout vkPipelineLayoutShapes = VK_NULL_HANDLE;
+		VkPipelineLayout vkPipelineLayoutInstanced = VK_NULL_HANDLE;
+		VkPipelineLayout vkPipelineLayoutInstanceCull = VK_NULL_HANDLE;
 
 		// renderables
 		RenderModel *skybox = nullptr;
@@ -283,11 +415,29 @@ namespace xrvk
 #endif
 		~Render();
 
-		// Initialize rendering
-		XrResult Init( oxr::Provider *pProvider, const char *pccAppName, uint32_t unAppVersion, const char *pccEngineName, uint32_t unEngineVersion );
-
-		// Initialize vulkan resources
-		void CreateRenderResources( oxr::Session *pSession, int64_t nColorFormat, int64_t nDepthFormat, VkExtent2D vkExtent );
+		// Initialize rendering. Multiview (single pass stereo) is used if requested, supported by the device and the session has a single array swapchain for all views
+		// Bindless materials (one texture array and material table for all models) are used if requested, descriptor indexing is supported by the device
+		// and the bindless pbr shaders were built (see openxr_provider/cmake/xrvk_shaders.cmake)
+		XrResult Init(
+			oxr::Provider *pProvider,
+			const char *pccAppName,
+			uint32_t unAppVersion,
+			const char *pccEngineName,
+			uint32_t unEngineVersion,
+			bool bRequestMultiview = false,
+			bool bRequestBindless = false );
+
+		// Initialize vulkan resources. Frames in flight is the number of frames that can be queued on the gpu before the cpu waits.
+		// Each swapchain (or the single multiview swapchain) is rendered and submitted separately and takes its own frame slot, so there are
+		// frames in flight x swapchains slots - frames in flight is clamped so that this stays within k_unMaxFramesInFlight.
+		// Recording threads > 0 records renderables into secondary command buffers across that many worker threads
+		void CreateRenderResources(
+			oxr::Session *pSession,
+			int64_t nColorFormat,
+			int64_t nDepthFormat,
+			VkExtent2D vkExtent,
+			uint32_t unFramesInFlight = k_unCommandBufferNum,
+			uint32_t unRecordingThreads = 0 );
 
 		// Initialize hmd tracking
 		void StartHmdTracking(oxr::Session *pSession);
@@ -295,8 +445,9 @@ namespace xrvk
 		// Apply player world state
 		void ApplyPlayerWorldStateToPose(XrPosef* pose);
 
-		// Rendering
-		void BeginRender(
+		// Rendering - BeginRender waits (bounded) for the gpu to finish with the next frame slot. If it doesn't return VK_SUCCESS nothing was recorded,
+		// EndRender doesn't submit and the session ends the frame without layers. VK_ERROR_DEVICE_LOST is returned by every render after the device is lost
+		VkResult BeginRender(
 			oxr::Session *pSession,
 			std::vector< XrCompositionLayerProjectionView > &vecFrameLayerProjectionViews,
 			XrFrameState *pFrameState,
@@ -306,9 +457,9 @@ namespace xrvk
 			float fFarZ = 100.0f,
 			XrVector3f v3fScaleEyeView = { 1.0f, 1.0f, 1.0f } );
 
-		void EndRender();
+		VkResult EndRender();
+		bool IsDeviceLost() { return m_bDeviceLost; }
 
-		void RenderNode( RenderSceneBase *renderable, vkglTF::Node *gltfNode, uint32_t unCmdBufIndex, vkglTF::Material::AlphaMode gltfAlphaMode );
 
 		// Asset handling
 		void LoadAssets();
@@ -319,7 +470,7 @@ namespace xrvk
 		void GenerateBRDFLUT();
 
 		void SetupDescriptors();
-		void SetupNodeDescriptorSet( vkglTF::Node *node );
+		void SetupMeshDescriptorSet( RenderSceneBase *renderable, VkDescriptorPool vkPool = VK_NULL_HANDLE );
 
 		// Pipelines
 		void PrepareShapesPipeline( Shapes::Shape *shape, std::string sVertexShader, std::string sFragmentShader,
@@ -341,6 +492,19 @@ namespace xrvk
 		// basic geometry
 		std::vector< Shapes::Shape * > vecShapes;
 
+		// Instanced basic geometry - returns the index of the new batch in vecShapeBatches. Call after CreateRenderResources, the instance ring
+		// is sized for its frame slots. Capacity is fixed, Add() fails once it's reached. If the instanced vertex shader isn't available the batch
+		// falls back to one draw per instance with "shaders/shape.vert.spv" (instance colors are then ignored)
+		uint32_t AddShapeBatch(
+			std::vector< unsigned short > *vecIndices,
+			std::vector< Shapes::Vertex > *vecVertices,
+			uint32_t unCapacity = 16384,
+			std::string sVertexShader = "shaders/shape_instanced.vert.spv",
+			std::string sFragmentShader = "shaders/shape.frag.spv",
+			VkPolygonMode vkPolygonMode = VK_POLYGON_MODE_FILL );
+
+		std::vector< Shapes::ShapeBatch * > vecShapeBatches;
+
 		// Custom graphics pipelines
 		struct CustomLayout
 		{
@@ -379,6 +543,62 @@ namespace xrvk
 		void SetSkyboxVisibility( bool bNewVisibility );
 
 		bool GetSkyboxVisibility();
+		bool IsMultiviewSupported() { return m_bMultiviewSupported; }
+		uint32_t GetFramesInFlight() { return m_unFramesInFlight; }
+		uint32_t GetFrameSlotCount() { return static_cast< uint32_t >( m_vecFrameData.size() ); }
+		uint32_t GetCurrentFrameIndex() { return m_unCurrentFrame; }
+		bool IsParallelRecordingEnabled() { return m_pJobSystem != nullptr; }
+		bool IsBindlessEnabled() { return m_bBindlessEnabled; }
+
+		// Instancing - sectors and models that share a source file share one gltf model and are drawn with instanced indirect draws,
+		// after a compute prepass culled them against the view frustums. Needs the instanced and culling shaders (built from openxr_provider/shaders).
+		// Must be set before LoadAssets, instanced renderables ignore custom pipelines (vkPipeline)
+		void SetInstancingEnabled( bool bEnable ) { m_bInstancingEnabled = bEnable; }
+		bool IsInstancingEnabled() { return m_bInstancingEnabled; }
+		uint32_t GetInstanceGroupsCount() { return static_cast< uint32_t >( m_vecInstanceGroups.size() ); }
+
+		// Pipeline cache - persisted per device and driver so pipelines are created from the cache on later starts.
+		// The directory must be set before CreateRenderResources and be writable (on android e.g. the activity's internalDataPath), empty disables the disk cache
+		void SetPipelineCacheDirectory( const std::string &sDirectory ) { m_sPipelineCacheDirectory = sDirectory; }
+		const std::string &GetPipelineCacheDirectory() { return m_sPipelineCacheDirectory; }
+		bool IsPipelineCacheLoaded() { return m_bPipelineCacheLoaded; }
+
+		// Writes the pipeline cache to disk (replacing the previous file only once fully written), also called on shutdown
+		bool SavePipelineCache();
+
+		// Image based lighting cache - the generated irradiance cube, prefiltered cube and brdf lut are stored per environment, shaders and filter parameters
+		// and uploaded directly on later starts. Empty directory disables the cache, forcing regeneration rebuilds and overwrites the cached files
+		void SetIBLCacheDirectory( const std::string &sDirectory ) { m_sIBLCacheDirectory = sDirectory; }
+		const std::string &GetIBLCacheDirectory() { return m_sIBLCacheDirectory; }
+		void SetForceIBLRegeneration( bool bForce ) { m_bForceIBLRegeneration = bForce; }
+		bool IsForceIBLRegeneration() { return m_bForceIBLRegeneration; }
+
+		// Asset loading - gltf files are read, parsed and decoded on a fixed pool of loader threads and uploaded in batches from a single upload thread.
+		// Thread count must be set before LoadAssets, 0 uses the number of hardware threads
+		void SetAssetLoaderThreads( uint32_t unThreadCount ) { m_unAssetLoaderThreads = unThreadCount; }
+		AssetLoader *GetAssetLoader() { return m_pAssetLoader; }
+
+		// Mesh cache - each gltf file is preprocessed into a memory mapped binary file on its first load and read from it while the source is unchanged.
+		// Must be set before LoadAssets, empty disables the cache
+		void SetMeshCacheDirectory( const std::string &sDirectory ) { m_sMeshCacheDirectory = sDirectory; }
+		const std::string &GetMeshCacheDirectory() { return m_sMeshCacheDirectory; }
+
+		// Uploads go through a persistently mapped staging ring on the transfer queue (a transfer only queue family if the device has one), created in Init
+		UploadManager *GetUploadManager() { return m_pUploadManager; }
+
+		// Device memory of all buffers and images is sub-allocated from large blocks, created in Init
+		MemoryAllocator *GetMemoryAllocator() { return m_pMemoryAllocator; }
+
+		// Streams in a scene, sector or model added after LoadAssets - it's drawn from the first frame after its load is done, without blocking the frame loop.
+		// Use the returned handle for progress and cancellation, it's empty if the renderable is already loaded, loading or drawn instanced
+		AssetHandle LoadRenderableAsync( RenderSceneBase *renderable );
+
+		// Number of gltf draw calls recorded since the last reset - call once per frame for per frame counts
+		uint32_t GetDrawCallCount( bool bReset = true );
+
+		// Number of gltf nodes whose world matrix was recomputed and mesh ubos written since the last reset - call once per frame for per frame counts
+		void GetTransformCounters( uint32_t *pNodesRecomputed, uint32_t *pUniformBuffersWritten, bool bReset = true );
+		bool IsMultiviewEnabled() { return m_bMultiviewEnabled; }
 		ELogLevel GetCurrentLogLevel() { return m_eMinLogLevel; }
 		SharedState *GetSharedState() { return &m_SharedState; }
 		std::vector< VisMask > &GetVisMasks() { return m_vecVisMasks; }
@@ -442,11 +662,128 @@ namespace xrvk
 		ELogLevel m_eMinLogLevel = ELogLevel::LogDebug;
 		SharedState m_SharedState {};
 
+		// multiview (single pass stereo)
+		bool m_bMultiviewSupported = false;
+		bool m_bMultiviewEnabled = false;
+
+		// descriptor indexing (bindless materials)
+		bool m_bBindlessEnabled = false;
+		uint32_t m_unBindlessTextureCapacity = 0;
+		uint32_t m_unBindlessTextureCount = 0;
+		uint32_t m_unBindlessMaterialCount = 0;
+		VkDescriptorPool m_vkBindlessDescriptorPool = VK_NULL_HANDLE;
+		VkDescriptorSet m_vkBindlessDescriptorSet = VK_NULL_HANDLE;
+		Buffer m_BindlessMaterialBuffer {};
+		std::unordered_map< const vkglTF::Texture *, uint32_t > m_mapBindlessTextures;
+		std::unordered_map< const vkglTF::Material *, uint32_t > m_mapBindlessMaterials;
+
+		// instancing
+		bool m_bInstancingEnabled = true;
+		std::vector< InstanceGroup * > m_vecInstanceGroups;
+		std::vector< Buffer > m_vecInstanceCullBuffers; // view projections the culling prepass tests against, one per frame slot
+
+		// Per instance group parameters of the culling prepass (instance_cull.comp)
+		struct PushConstInstanceCull
+		{
+			glm::vec4 boundingSphere;
+			uint32_t unInstanceCount = 0;
+			uint32_t unDrawCount = 0;
+			uint32_t unViewCount = 0;
+			uint32_t unPadding = 0;
+		};
+		std::atomic< uint32_t > m_unDrawCalls { 0 };
+
+		// pipeline cache
+		struct PipelineCacheFileHeader
+		{
+			uint32_t unMagic = k_unPipelineCacheMagic;
+			uint32_t unVersion = k_unPipelineCacheFileVersion;
+			uint32_t unVendorID = 0;
+			uint32_t unDeviceID = 0;
+			uint32_t unDriverVersion = 0;
+			uint8_t pipelineCacheUUID[ VK_UUID_SIZE ] = {};
+			float fColdCreationMs = 0.0f; // pipeline creation time without a cache, used to report the time saved
+			uint64_t unDataSize = 0;
+		};
+
+#ifdef XR_USE_PLATFORM_ANDROID
+		std::string m_sPipelineCacheDirectory;
+#else
+		std::string m_sPipelineCacheDirectory = ".";
+#endif
+		bool m_bPipelineCacheLoaded = false;
+		float m_fPipelineColdCreationMs = 0.0f;
+
+		// image based lighting cache - a file header followed by a header and data (per mip, then per layer) for each image
+		struct IBLCacheFileHeader
+		{
+			uint32_t unMagic = k_unIBLCacheMagic;
+			uint32_t unVersion = k_unIBLCacheFileVersion;
+			uint32_t unImageCount = 0;
+			uint32_t unPadding = 0;
+		};
+
+		struct IBLCacheImageHeader
+		{
+			uint32_t unFormat = 0;
+			uint32_t unDim = 0;
+			uint32_t unMips = 0;
+			uint32_t unLayers = 0;
+			uint64_t unDataSize = 0;
+		};
+
+		struct IBLCacheImage
+		{
+			vks::Texture *pTexture = nullptr;
+			VkFormat vkFormat = VK_FORMAT_UNDEFINED;
+		};
+
+#ifdef XR_USE_PLATFORM_ANDROID
+		std::string m_sIBLCacheDirectory;
+#else
+		std::string m_sIBLCacheDirectory = ".";
+#endif
+		bool m_bForceIBLRegeneration = false;
+		std::string m_sEnvironmentFilename;
+
 		// internal
 		std::vector< std::vector< RenderTarget > > m_vec2RenderTargets;
-		std::vector< FrameData > m_vecFrameData {};
+		std::vector< FrameData > m_vecFrameData {}; // frame slots - one per render (swapchain) of each frame in flight
+		uint32_t m_unCurrentFrame = 0;
+		uint32_t m_unFramesInFlight = 0;
+		XrTime m_xrPosedDisplayTime = -1;
+
+		// session the render targets were created for - submits register their fences with it so frames are only ended after their gpu work
+		oxr::Session *m_pSession = nullptr;
+
+		// whether the current render's frame slot was acquired and recorded into, so EndRender can submit it
+		bool m_bRenderRecorded = false;
+		bool m_bDeviceLost = false;
+
+		// frame timing (owned by the session)
+		oxr::FrameTiming *m_pFrameTiming = nullptr;
+		VkQueryPool m_vkTimestampQueryPool = VK_NULL_HANDLE;
+		uint64_t m_unTimestampMask = UINT64_MAX;
+		uint32_t m_unTimedPass = 0;
 		std::vector< VkRenderPass > m_vecRenderPasses { VK_NULL_HANDLE };
 
+		// parallel recording
+		JobSystem *m_pJobSystem = nullptr;
+		std::vector< RenderSceneBase * > m_vecRecordingRenderables;
+		std::vector< std::future< void > > m_vecRecordingJobs;
+
+		// asset loading
+		AssetLoader *m_pAssetLoader = nullptr;
+		UploadManager *m_pUploadManager = nullptr;
+		MemoryAllocator *m_pMemoryAllocator = nullptr;
+		uint32_t m_unAssetLoaderThreads = 0;
+#ifdef XR_USE_PLATFORM_ANDROID
+		std::string m_sMeshCacheDirectory;
+#else
+		std::string m_sMeshCacheDirectory = ".";
+#endif
+		std::vector< std::pair< RenderSceneBase *, AssetHandle > > m_vecStreamingRenderables;
+
 		// openxr
 		oxr::Provider *m_pProvider = nullptr;
 		bool m_bEnableVismask = true;
@@ -467,23 +804,77 @@ namespace xrvk
 
 		// functions - render resources
 		void CreateRenderPass( int64_t nColorFormat, int64_t nDepthFormat, uint32_t nIndex = 0 );
+		VkPipeline CreateShapesPipeline( std::string sVertexShader, std::string sFragmentShader, VkPolygonMode vkPolygonMode, bool bInstanced );
 		void CreateRenderTargets( oxr::Session *pSession, VkRenderPass vkRenderPass );
+		void CreatePipelineCache();
+		std::string GetPipelineCacheFilename();
+		bool WriteFileAtomically( const std::string &sFilename, const std::vector< char > &vecData );
+
+		// functions - image based lighting cache
+		uint64_t HashIBLInputs( const std::vector< std::string > &vecFiles, const std::vector< uint32_t > &vecParams );
+		std::string GetIBLCacheFilename( const char *pccName, uint64_t unKey );
+		uint32_t GetIBLTexelSize( VkFormat vkFormat );
+		VkDeviceSize GetIBLImageSize( VkFormat vkFormat, uint32_t unDim, uint32_t unMips, uint32_t unLayers );
+		bool LoadIBLCache( const std::string &sFilename, std::vector< IBLCacheImage > &vecImages );
+		bool SaveIBLCache( const std::string &sFilename, std::vector< IBLCacheImage > &vecImages );
+
+		// functions - rendering
+		VkResult WaitForFrameSlot();
+		void BeginGpuTiming( VkCommandBuffer vkCommandBuffer );
+		void EndGpuTiming( VkCommandBuffer vkCommandBuffer );
+		void ResolveGpuTiming();
+		VkCommandBuffer BeginSecondaryCommandBuffer( uint32_t unIndex, VkRenderPassBeginInfo *pRenderPassBeginInfo );
+		void StartParallelRecording( VkRenderPassBeginInfo *pRenderPassBeginInfo );
+		void ExecuteSecondaryCommandBuffers( VkCommandBuffer vkPrimaryCommandBuffer );
+		void BeginRenderMultiview(
+			oxr::Session *pSession,
+			std::vector< XrCompositionLayerProjectionView > &vecFrameLayerProjectionViews,
+			XrFrameState *pFrameState,
+			uint32_t unSwapchainIndex,
+			uint32_t unImageIndex,
+			float fNearZ,
+			float fFarZ,
+			XrVector3f v3fScaleEyeView );
+
+		void UploadShapeBatch( Shapes::ShapeBatch *pShapeBatch );
+		void DrawShapeBatches( VkCommandBuffer vkCommandBuffer, XrMatrix4x4f *pViewProjections, uint32_t unViewCount );
+
+		void UpdateHmdState( oxr::Session *pSession, XrFrameState *pFrameState );
+		void CalculateViewProjection(
+			XrMatrix4x4f *outMatViewProjection, XrMatrix4x4f *outMatVisMaskMVP, XrCompositionLayerProjectionView *pProjectionView, float fNearZ, float fFarZ, XrVector3f *pScaleEyeView );
 
 		// functions - renderables
-		void RenderGltfScene( RenderSceneBase *renderable );
-		void RenderGltfScenes();
+		void BuildDrawList( RenderSceneBase *renderable );
+		void RenderGltfScene( RenderSceneBase *renderable, VkCommandBuffer vkCommandBuffer );
+		void RenderGltfScenes( VkCommandBuffer vkCommandBuffer );
+		void BindSceneDescriptorSets( VkCommandBuffer vkCommandBuffer );
 
-		void LoadGltfScene( RenderSceneBase *renderable );
+		void BuildInstanceGroups();
+		void SetupInstanceGroups();
+		uint32_t UpdateInstanceGroup( InstanceGroup *pInstanceGroup );
+		void CullInstanceGroups( VkCommandBuffer vkCommandBuffer, XrMatrix4x4f *pViewProjections, uint32_t unViewCount );
+
+		AssetHandle LoadGltfScene( RenderSceneBase *renderable );
 		void LoadGltfScenes();
+		void FinishStreamedRenderables();
 
 		void UpdateUniformBuffers( UBOMatrices *uboMatrices, Buffer *buffer, RenderSceneBase *renderable, XrMatrix4x4f *matViewProjection, XrPosef *eyePose );
 		void UpdateUniformBuffers( UBOMatrices *uboMatrices, Buffer *buffer, XrMatrix4x4f *matViewProjection, XrPosef *eyePose );
 
+		void UpdateUniformBuffers( UBOMatricesMultiview *uboMatrices, Buffer *buffer, RenderSceneBase *renderable, XrMatrix4x4f *matViewProjections, XrPosef *eyePoses );
+		void UpdateUniformBuffers( UBOMatricesMultiview *uboMatrices, Buffer *buffer, XrMatrix4x4f *matViewProjections, XrPosef *eyePoses );
+
 		void UpdateRenderablePoses( oxr::Session *pSession, XrFrameState *pFrameState );
 
 		// functions - utility
-		void CalculateDescriptorScope( vkglTF::Model *gltfModel, uint32_t *imageSamplerCount, uint32_t *materialCount, uint32_t *meshCount );
-		void AllocateDescriptorSet( vkglTF::Model *gltfModel );
+		void CalculateDescriptorScope( vkglTF::Model *gltfModel, uint32_t *imageSamplerCount, uint32_t *materialCount, uint32_t *meshSetCount );
+		void AllocateDescriptorSet( vkglTF::Model *gltfModel, VkDescriptorPool vkPool = VK_NULL_HANDLE );
+		void SetupBindlessDescriptorSet();
+		void RegisterBindlessMaterials( vkglTF::Model *gltfModel );
+		uint32_t RegisterBindlessTexture( vkglTF::Texture *pTexture );
+
+		bool IsShaderAvailable( const std::string &sFilename );
+		std::string GetShaderVariant( const std::string &sFilename );
 	};
 
 } // namespace xrvk
\ No newline at end of file
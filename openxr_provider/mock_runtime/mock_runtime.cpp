@@ -0,0 +1,2681 @@
+/* Copyright 2021, 2022, 2023 Rune Berg (GitHub: https://github.com/1runeberg, Twitter: https://twitter.com/1runeberg, YouTube: https://www.youtube.com/@1RuneBerg)
+ *
+ *  SPDX-License-Identifier: MIT
+ *
+ *  Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+ *
+ *  2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *
+ *  3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote products derived from this
+ *     software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ *  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+ *  BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ *  GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+ *  DAMAGE.
+ *
+ */
+
+#include "mock_runtime.hpp"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+
+#include "openxr/openxr_reflection.h"
+
+// Loader <-> runtime negotiation interface. Only 1.0.29+ headers ship openxr_loader_negotiation.h,
+// older ones keep these definitions in the loader sources (loader_interfaces.h)
+#if __has_include( "openxr/openxr_loader_negotiation.h" )
+	#include "openxr/openxr_loader_negotiation.h"
+#else
+typedef enum XrLoaderInterfaceStructs
+{
+	XR_LOADER_INTERFACE_STRUCT_UNINTIALIZED = 0,
+	XR_LOADER_INTERFACE_STRUCT_LOADER_INFO,
+	XR_LOADER_INTERFACE_STRUCT_API_LAYER_REQUEST,
+	XR_LOADER_INTERFACE_STRUCT_RUNTIME_REQUEST,
+	XR_LOADER_INTERFACE_STRUCT_API_LAYER_CREATE_INFO,
+	XR_LOADER_INTERFACE_STRUCT_API_LAYER_NEXT_INFO,
+} XrLoaderInterfaceStructs;
+
+	#define XR_LOADER_INFO_STRUCT_VERSION 1
+typedef struct XrNegotiateLoaderInfo
+{
+	XrLoaderInterfaceStructs structType;
+	uint32_t structVersion;
+	size_t structSize;
+	uint32_t minInterfaceVersion;
+	uint32_t maxInterfaceVersion;
+	XrVersion minApiVersion;
+	XrVersion maxApiVersion;
+} XrNegotiateLoaderInfo;
+
+	#define XR_RUNTIME_INFO_STRUCT_VERSION 1
+typedef struct XrNegotiateRuntimeRequest
+{
+	XrLoaderInterfaceStructs structType;
+	uint32_t structVersion;
+	size_t structSize;
+	uint32_t runtimeInterfaceVersion;
+	XrVersion runtimeApiVersion;
+	PFN_xrGetInstanceProcAddr getInstanceProcAddr;
+} XrNegotiateRuntimeRequest;
+
+	#define XR_CURRENT_LOADER_RUNTIME_VERSION 1
+#endif
+
+namespace
+{
+	using namespace oxr::mock;
+
+	static const char *k_pccRuntimeName = "OpenXR Provider Mock Runtime";
+	static const XrSystemId k_xrSystemId = 1;
+	static const uint32_t k_unViewCount = 2;
+	static const int64_t k_nNominalPeriodNs = 1000000000 / 90;
+
+	// --------------------------------------------------------------------------------------------
+	// Pose math
+	// --------------------------------------------------------------------------------------------
+
+	XrPosef IdentityPose() { return { { 0.0f, 0.0f, 0.0f, 1.0f }, { 0.0f, 0.0f, 0.0f } }; }
+
+	XrQuaternionf Multiply( const XrQuaternionf &a, const XrQuaternionf &b )
+	{
+		return { a.w * b.x + a.x * b.w + a.y * b.z - a.z * b.y,
+				 a.w * b.y - a.x * b.z + a.y * b.w + a.z * b.x,
+				 a.w * b.z + a.x * b.y - a.y * b.x + a.z * b.w,
+				 a.w * b.w - a.x * b.x - a.y * b.y - a.z * b.z };
+	}
+
+	XrVector3f Rotate( const XrQuaternionf &q, const XrVector3f &v )
+	{
+		// v' = v + 2w(q x v) + 2(q x (q x v))
+		const XrVector3f t { 2.0f * ( q.y * v.z - q.z * v.y ), 2.0f * ( q.z * v.x - q.x * v.z ), 2.0f * ( q.x * v.y - q.y * v.x ) };
+		return { v.x + q.w * t.x + ( q.y * t.z - q.z * t.y ), v.y + q.w * t.y + ( q.z * t.x - q.x * t.z ), v.z + q.w * t.z + ( q.x * t.y - q.y * t.x ) };
+	}
+
+	// Pose b expressed in a's space, transformed to a's parent space
+	XrPosef Multiply( const XrPosef &a, const XrPosef &b )
+	{
+		const XrVector3f p = Rotate( a.orientation, b.position );
+		return { Multiply( a.orientation, b.orientation ), { a.position.x + p.x, a.position.y + p.y, a.position.z + p.z } };
+	}
+
+	XrPosef Inverse( const XrPosef &a )
+	{
+		const XrQuaternionf q { -a.orientation.x, -a.orientation.y, -a.orientation.z, a.orientation.w };
+		const XrVector3f p = Rotate( q, a.position );
+		return { q, { -p.x, -p.y, -p.z } };
+	}
+
+	bool IsValidPose( const XrPosef &a )
+	{
+		const XrQuaternionf &q = a.orientation;
+		const float fLengthSq = q.x * q.x + q.y * q.y + q.z * q.z + q.w * q.w;
+		return std::fabs( fLengthSq - 1.0f ) < 0.01f;
+	}
+
+	int64_t NowNs() { return std::chrono::duration_cast< std::chrono::nanoseconds >( std::chrono::steady_clock::now().time_since_epoch() ).count(); }
+
+	// --------------------------------------------------------------------------------------------
+	// Runtime objects. Handles are pointers to these, validated against the live object set
+	// --------------------------------------------------------------------------------------------
+
+	enum class EObjectType
+	{
+		Instance,
+		Session,
+		Space,
+		Swapchain,
+		ActionSet,
+		Action,
+		HandTracker
+	};
+
+	struct MockObject
+	{
+		explicit MockObject( EObjectType eType )
+			: eObjectType( eType )
+		{
+		}
+		virtual ~MockObject() = default;
+		EObjectType eObjectType;
+	};
+
+	struct MockAction;
+	struct MockSession;
+	struct InputSource;
+
+	struct MockInstance : MockObject
+	{
+		MockInstance()
+			: MockObject( EObjectType::Instance )
+		{
+		}
+		std::vector< std::string > vecEnabledExtensions;
+		std::map< XrPath, std::vector< XrActionSuggestedBinding > > mapSuggestedBindings;
+		std::vector< XrPath > vecSuggestedProfileOrder;
+		MockSession *pSession = nullptr;
+		VkInstance vkInstance = VK_NULL_HANDLE;
+		VkPhysicalDevice vkPhysicalDevice = VK_NULL_HANDLE;
+		bool bActionSetsAttached = false;
+	};
+
+	struct ActionState
+	{
+		bool bValue = false;
+		float fValue = 0.0f;
+		XrVector2f xrValue {};
+		bool bIsActive = false;
+		bool bChanged = false;
+		XrTime xrLastChangeTime = 0;
+	};
+
+	struct MockActionSet : MockObject
+	{
+		MockActionSet()
+			: MockObject( EObjectType::ActionSet )
+		{
+		}
+		MockInstance *pInstance = nullptr;
+		std::string sName;
+		std::vector< MockAction * > vecActions;
+		bool bAttached = false;
+	};
+
+	struct MockAction : MockObject
+	{
+		MockAction()
+			: MockObject( EObjectType::Action )
+		{
+		}
+		MockActionSet *pActionSet = nullptr;
+		std::string sName;
+		XrActionType xrActionType = XR_ACTION_TYPE_BOOLEAN_INPUT;
+		std::vector< XrPath > vecSubactionPaths;
+
+		// Synced state per subaction path, XR_NULL_PATH holds the combined state
+		std::map< XrPath, ActionState > mapStates;
+
+		// Input sources bound in xrBoundProfile per subaction path - XR_NULL_PATH first, then vecSubactionPaths in order
+		XrPath xrBoundProfile = XR_NULL_PATH;
+		std::vector< std::vector< const InputSource * > > vecBoundInputs;
+	};
+
+	struct FramePacing
+	{
+		std::mutex mutex;
+		std::condition_variable cv;
+		uint64_t unWaited = 0;
+		uint64_t unBegun = 0;
+		bool bFrameBegun = false;
+		int64_t nLastWakeNs = 0;
+	};
+
+	struct MockSession : MockObject
+	{
+		MockSession()
+			: MockObject( EObjectType::Session )
+		{
+		}
+		MockInstance *pInstance = nullptr;
+		XrSessionState xrState = XR_SESSION_STATE_UNKNOWN;
+		bool bRunning = false;
+		bool bExitRequested = false;
+		XrViewConfigurationType xrViewConfigurationType = XR_VIEW_CONFIGURATION_TYPE_PRIMARY_STEREO;
+		XrPath xrCurrentProfile = XR_NULL_PATH;
+
+		// Vulkan graphics binding, all null for headless sessions
+		VkInstance vkInstance = VK_NULL_HANDLE;
+		VkPhysicalDevice vkPhysicalDevice = VK_NULL_HANDLE;
+		VkDevice vkDevice = VK_NULL_HANDLE;
+		uint32_t unQueueFamilyIndex = 0;
+		uint32_t unQueueIndex = 0;
+
+		FramePacing framePacing;
+	};
+
+	struct MockSpace : MockObject
+	{
+		MockSpace()
+			: MockObject( EObjectType::Space )
+		{
+		}
+		MockSession *pSession = nullptr;
+		XrReferenceSpaceType xrReferenceSpaceType = XR_REFERENCE_SPACE_TYPE_LOCAL;
+		MockAction *pAction = nullptr;
+		XrPath xrSubactionPath = XR_NULL_PATH;
+		XrPosef xrPoseInSpace = IdentityPose();
+	};
+
+	struct MockSwapchain : MockObject
+	{
+		MockSwapchain()
+			: MockObject( EObjectType::Swapchain )
+		{
+		}
+		MockSession *pSession = nullptr;
+		XrSwapchainCreateInfo xrCreateInfo {};
+		std::vector< VkImage > vecImages;
+		std::vector< VkDeviceMemory > vecMemory;
+		std::deque< uint32_t > deqAcquired;
+		bool bFrontWaited = false;
+		uint32_t unNextImage = 0;
+		int32_t nLastReleased = -1;
+	};
+
+	struct MockHandTracker : MockObject
+	{
+		MockHandTracker()
+			: MockObject( EObjectType::HandTracker )
+		{
+		}
+		MockSession *pSession = nullptr;
+		XrHandEXT xrHand = XR_HAND_LEFT_EXT;
+	};
+
+	// Scripted input source, one value set per full input path (e.g. /user/hand/left/input/trigger/value)
+	struct InputSource
+	{
+		bool bValue = false;
+		float fValue = 0.0f;
+		XrVector2f xrValue {};
+		XrPosef xrPose = IdentityPose();
+		bool bHasPose = false;
+	};
+
+	struct HandJoints
+	{
+		bool bActive = true;
+		bool bScripted = false;
+		std::array< XrPosef, XR_HAND_JOINT_COUNT_EXT > arrPoses;
+	};
+
+	struct Runtime
+	{
+		// Guards everything below. Frame pacing has its own lock (see FramePacing) which is always taken before this one
+		std::mutex mutex;
+
+		Config config;
+		Stats stats;
+
+		std::unordered_set< MockObject * > setObjects;
+		MockInstance *pInstance = nullptr;
+
+		// Interned paths - XrPath n is vecPaths[ n - 1 ]
+		std::vector< std::string > vecPaths;
+		std::unordered_map< std::string, XrPath > mapPaths;
+
+		std::deque< XrEventDataBuffer > deqEvents;
+
+		XrPosef xrHeadPose { { 0.0f, 0.0f, 0.0f, 1.0f }, { 0.0f, 1.6f, 0.0f } };
+		std::unordered_map< std::string, InputSource > mapInputs;
+		std::string sPreferredProfile;
+		std::array< HandJoints, 2 > arrHands;
+
+		std::vector< SubmittedView > vecLastSubmittedViews;
+	};
+
+	Runtime &GetRuntime()
+	{
+		static Runtime runtime;
+		return runtime;
+	}
+
+	template < typename T > T *Lookup( Runtime &runtime, const void *pHandle, EObjectType eType )
+	{
+		auto pObject = reinterpret_cast< MockObject * >( const_cast< void * >( pHandle ) );
+		if ( !pObject || runtime.setObjects.count( pObject ) == 0 || pObject->eObjectType != eType )
+			return nullptr;
+
+		return static_cast< T * >( pObject );
+	}
+
+	template < typename T > T *Track( Runtime &runtime, T *pObject )
+	{
+		runtime.setObjects.insert( pObject );
+		return pObject;
+	}
+
+	void Untrack( Runtime &runtime, MockObject *pObject )
+	{
+		runtime.setObjects.erase( pObject );
+		delete pObject;
+	}
+
+	XrResult Fail( Runtime &runtime, XrResult xrResult )
+	{
+		runtime.stats.unErrors++;
+		return xrResult;
+	}
+
+	// Two call idiom helper for arrays
+	template < typename T > XrResult FillArray( const std::vector< T > &vecValues, uint32_t unCapacity, uint32_t *pCountOutput, T *pOut )
+	{
+		if ( !pCountOutput )
+			return XR_ERROR_VALIDATION_FAILURE;
+
+		*pCountOutput = ( uint32_t )vecValues.size();
+		if ( unCapacity == 0 )
+			return XR_SUCCESS;
+
+		if ( unCapacity < vecValues.size() || !pOut )
+			return XR_ERROR_SIZE_INSUFFICIENT;
+
+		std::copy( vecValues.begin(), vecValues.end(), pOut );
+		return XR_SUCCESS;
+	}
+
+	XrResult FillString( const std::string &sValue, uint32_t unCapacity, uint32_t *pCountOutput, char *pOut )
+	{
+		if ( !pCountOutput )
+			return XR_ERROR_VALIDATION_FAILURE;
+
+		*pCountOutput = ( uint32_t )sValue.size() + 1;
+		if ( unCapacity == 0 )
+			return XR_SUCCESS;
+
+		if ( unCapacity < sValue.size() + 1 || !pOut )
+			return XR_ERROR_SIZE_INSUFFICIENT;
+
+		std::memcpy( pOut, sValue.c_str(), sValue.size() + 1 );
+		return XR_SUCCESS;
+	}
+
+	// --------------------------------------------------------------------------------------------
+	// Paths
+	// --------------------------------------------------------------------------------------------
+
+	bool IsWellFormedPath( const char *pccPath )
+	{
+		if ( !pccPath || pccPath[ 0 ] != '/' )
+			return false;
+
+		const size_t unLength = std::strlen( pccPath );
+		if ( unLength < 2 || unLength >= XR_MAX_PATH_LENGTH || pccPath[ unLength - 1 ] == '/' )
+			return false;
+
+		for ( size_t i = 0; i < unLength; i++ )
+		{
+			const char c = pccPath[ i ];
+			const bool bAllowed = ( c >= 'a' && c <= 'z' ) || ( c >= '0' && c <= '9' ) || c == '-' || c == '_' || c == '.' || c == '/';
+			if ( !bAllowed || ( c == '/' && i > 0 && pccPath[ i - 1 ] == '/' ) )
+				return false;
+		}
+
+		return true;
+	}
+
+	bool IsWellFormedName( const char *pccName )
+	{
+		if ( !pccName || pccName[ 0 ] == 0 )
+			return false;
+
+		for ( const char *c = pccName; *c; c++ )
+		{
+			if ( !( ( *c >= 'a' && *c <= 'z' ) || ( *c >= '0' && *c <= '9' ) || *c == '-' || *c == '_' || *c == '.' ) )
+				return false;
+		}
+
+		return true;
+	}
+
+	XrPath InternPath( Runtime &runtime, const std::string &sPath )
+	{
+		auto it = runtime.mapPaths.find( sPath );
+		if ( it != runtime.mapPaths.end() )
+			return it->second;
+
+		runtime.vecPaths.push_back( sPath );
+		const XrPath xrPath = ( XrPath )runtime.vecPaths.size();
+		runtime.mapPaths.emplace( sPath, xrPath );
+		return xrPath;
+	}
+
+	const std::string *PathString( Runtime &runtime, XrPath xrPath )
+	{
+		if ( xrPath == XR_NULL_PATH || xrPath > runtime.vecPaths.size() )
+			return nullptr;
+
+		return &runtime.vecPaths[ xrPath - 1 ];
+	}
+
+	bool StartsWith( const std::string &s, const std::string &sPrefix ) { return s.size() >= sPrefix.size() && s.compare( 0, sPrefix.size(), sPrefix ) == 0; }
+
+	// Whether a binding path (e.g. /user/hand/left/input/select/click) belongs to a top level user path (e.g. /user/hand/left)
+	bool IsBindingForUserPath( const std::string &sBinding, const std::string &sUserPath )
+	{
+		return sBinding.size() > sUserPath.size() && StartsWith( sBinding, sUserPath ) && sBinding[ sUserPath.size() ] == '/';
+	}
+
+	// --------------------------------------------------------------------------------------------
+	// Events and session state
+	// --------------------------------------------------------------------------------------------
+
+	void QueueStateChange( Runtime &runtime, MockSession *pSession, XrSessionState xrState )
+	{
+		pSession->xrState = xrState;
+
+		XrEventDataBuffer xrEvent { XR_TYPE_EVENT_DATA_BUFFER };
+		auto pStateChanged = reinterpret_cast< XrEventDataSessionStateChanged * >( &xrEvent );
+		pStateChanged->type = XR_TYPE_EVENT_DATA_SESSION_STATE_CHANGED;
+		pStateChanged->next = nullptr;
+		pStateChanged->session = reinterpret_cast< XrSession >( pSession );
+		pStateChanged->state = xrState;
+		pStateChanged->time = NowNs();
+		runtime.deqEvents.push_back( xrEvent );
+	}
+
+	void QueueProfileChanged( Runtime &runtime, MockSession *pSession )
+	{
+		XrEventDataBuffer xrEvent { XR_TYPE_EVENT_DATA_BUFFER };
+		auto pProfileChanged = reinterpret_cast< XrEventDataInteractionProfileChanged * >( &xrEvent );
+		pProfileChanged->type = XR_TYPE_EVENT_DATA_INTERACTION_PROFILE_CHANGED;
+		pProfileChanged->next = nullptr;
+		pProfileChanged->session = reinterpret_cast< XrSession >( pSession );
+		runtime.deqEvents.push_back( xrEvent );
+	}
+
+	void StopSession( Runtime &runtime, MockSession *pSession )
+	{
+		if ( !pSession->bRunning || pSession->xrState == XR_SESSION_STATE_STOPPING )
+			return;
+
+		pSession->bExitRequested = true;
+		if ( pSession->xrState == XR_SESSION_STATE_FOCUSED )
+			QueueStateChange( runtime, pSession, XR_SESSION_STATE_VISIBLE );
+		if ( pSession->xrState == XR_SESSION_STATE_VISIBLE )
+			QueueStateChange( runtime, pSession, XR_SESSION_STATE_SYNCHRONIZED );
+		QueueStateChange( runtime, pSession, XR_SESSION_STATE_STOPPING );
+	}
+
+	// --------------------------------------------------------------------------------------------
+	// Input
+	// --------------------------------------------------------------------------------------------
+
+	// Suggested bindings of the interaction profile currently bound to the session
+	const std::vector< XrActionSuggestedBinding > *CurrentBindings( MockSession *pSession )
+	{
+		auto it = pSession->pInstance->mapSuggestedBindings.find( pSession->xrCurrentProfile );
+		return it == pSession->pInstance->mapSuggestedBindings.end() ? nullptr : &it->second;
+	}
+
+	// Full input paths bound to an action in the current profile, optionally filtered to a top level user path
+	std::vector< const std::string * > BoundSources( Runtime &runtime, MockSession *pSession, MockAction *pAction, XrPath xrSubactionPath )
+	{
+		std::vector< const std::string * > vecSources;
+		auto pBindings = CurrentBindings( pSession );
+		if ( !pBindings )
+			return vecSources;
+
+		const std::string *pUserPath = PathString( runtime, xrSubactionPath );
+		for ( auto &binding : *pBindings )
+		{
+			if ( binding.action != reinterpret_cast< XrAction >( pAction ) )
+				continue;
+
+			const std::string *pBinding = PathString( runtime, binding.binding );
+			if ( pBinding && ( !pUserPath || IsBindingForUserPath( *pBinding, *pUserPath ) ) )
+				vecSources.push_back( pBinding );
+		}
+
+		return vecSources;
+	}
+
+	// Input sources bound to an action per subaction path, cached until the session's interaction profile changes
+	const std::vector< std::vector< const InputSource * > > &BoundInputs( Runtime &runtime, MockSession *pSession, MockAction *pAction )
+	{
+		if ( !pAction->vecBoundInputs.empty() && pAction->xrBoundProfile == pSession->xrCurrentProfile )
+			return pAction->vecBoundInputs;
+
+		pAction->xrBoundProfile = pSession->xrCurrentProfile;
+		pAction->vecBoundInputs.assign( pAction->vecSubactionPaths.size() + 1, {} );
+		for ( size_t i = 0; i < pAction->vecBoundInputs.size(); i++ )
+		{
+			// Unscripted sources are added with their default values, map nodes keep their address
+			for ( auto pSource : BoundSources( runtime, pSession, pAction, i == 0 ? XR_NULL_PATH : pAction->vecSubactionPaths[ i - 1 ] ) )
+				pAction->vecBoundInputs[ i ].push_back( &runtime.mapInputs[ *pSource ] );
+		}
+
+		return pAction->vecBoundInputs;
+	}
+
+	// Resting pose of a hand (or other tracked device) when none was scripted
+	XrPosef DefaultPose( const std::string &sInputPath )
+	{
+		if ( StartsWith( sInputPath, "/user/hand/left/" ) )
+			return { { 0.0f, 0.0f, 0.0f, 1.0f }, { -0.2f, 1.3f, -0.4f } };
+
+		if ( StartsWith( sInputPath, "/user/hand/right/" ) )
+			return { { 0.0f, 0.0f, 0.0f, 1.0f }, { 0.2f, 1.3f, -0.4f } };
+
+		return { { 0.0f, 0.0f, 0.0f, 1.0f }, { 0.0f, 1.0f, -0.5f } };
+	}
+
+	XrPosef SourcePose( Runtime &runtime, const std::string &sInputPath )
+	{
+		auto it = runtime.mapInputs.find( sInputPath );
+		return ( it != runtime.mapInputs.end() && it->second.bHasPose ) ? it->second.xrPose : DefaultPose( sInputPath );
+	}
+
+	void SyncAction( Runtime &runtime, MockSession *pSession, MockAction *pAction, bool bFocused, XrTime xrNow )
+	{
+		const auto &vecBoundInputs = BoundInputs( runtime, pSession, pAction );
+		for ( size_t i = 0; i < vecBoundInputs.size(); i++ )
+		{
+			const XrPath xrSubactionPath = i == 0 ? XR_NULL_PATH : pAction->vecSubactionPaths[ i - 1 ];
+			ActionState newState;
+			newState.bIsActive = bFocused && !vecBoundInputs[ i ].empty();
+
+			if ( newState.bIsActive )
+			{
+				// Multiple bound sources are combined as the spec requires - boolean OR, largest absolute float, longest vector
+				for ( const InputSource *pSource : vecBoundInputs[ i ] )
+				{
+					const InputSource &source = *pSource;
+					newState.bValue = newState.bValue || source.bValue;
+					if ( std::fabs( source.fValue ) > std::fabs( newState.fValue ) )
+						newState.fValue = source.fValue;
+
+					const float fLengthSq = source.xrValue.x * source.xrValue.x + source.xrValue.y * source.xrValue.y;
+					if ( fLengthSq > newState.xrValue.x * newState.xrValue.x + newState.xrValue.y * newState.xrValue.y )
+						newState.xrValue = source.xrValue;
+				}
+			}
+
+			ActionState &state = pAction->mapStates[ xrSubactionPath ];
+			bool bChanged = false;
+			switch ( pAction->xrActionType )
+			{
+				case XR_ACTION_TYPE_BOOLEAN_INPUT:
+					bChanged = state.bValue != newState.bValue;
+					break;
+				case XR_ACTION_TYPE_FLOAT_INPUT:
+					bChanged = state.fValue != newState.fValue;
+					break;
+				case XR_ACTION_TYPE_VECTOR2F_INPUT:
+					bChanged = state.xrValue.x != newState.xrValue.x || state.xrValue.y != newState.xrValue.y;
+					break;
+				default:
+					break;
+			}
+
+			// Changes only count between two active syncs
+			newState.bChanged = bChanged && newState.bIsActive && state.bIsActive;
+			newState.xrLastChangeTime = newState.bChanged ? xrNow : state.xrLastChangeTime;
+			state = newState;
+		}
+	}
+
+	// Validates a get action state call and returns the synced state, or nullptr with an error in outResult
+	const ActionState *GetActionState( Runtime &runtime, XrSession session, const XrActionStateGetInfo *getInfo, XrActionType xrExpectedType, XrResult *outResult )
+	{
+		auto pSession = Lookup< MockSession >( runtime, session, EObjectType::Session );
+		if ( !pSession )
+		{
+			*outResult = Fail( runtime, XR_ERROR_HANDLE_INVALID );
+			return nullptr;
+		}
+
+		auto pAction = getInfo ? Lookup< MockAction >( runtime, getInfo->action, EObjectType::Action ) : nullptr;
+		if ( !pAction )
+		{
+			*outResult = Fail( runtime, XR_ERROR_HANDLE_INVALID );
+			return nullptr;
+		}
+
+		if ( pAction->xrActionType != xrExpectedType )
+		{
+			*outResult = Fail( runtime, XR_ERROR_ACTION_TYPE_MISMATCH );
+			return nullptr;
+		}
+
+		if ( !pAction->pActionSet->bAttached )
+		{
+			*outResult = Fail( runtime, XR_ERROR_ACTIONSET_NOT_ATTACHED );
+			return nullptr;
+		}
+
+		if ( getInfo->subactionPath != XR_NULL_PATH &&
+			 std::find( pAction->vecSubactionPaths.begin(), pAction->vecSubactionPaths.end(), getInfo->subactionPath ) == pAction->vecSubactionPaths.end() )
+		{
+			*outResult = Fail( runtime, XR_ERROR_PATH_UNSUPPORTED );
+			return nullptr;
+		}
+
+		*outResult = XR_SUCCESS;
+		return &pAction->mapStates[ getInfo->subactionPath ];
+	}
+
+	// --------------------------------------------------------------------------------------------
+	// Spaces
+	// --------------------------------------------------------------------------------------------
+
+	// Pose of a space relative to the shared local/stage origin. Returns false if the space isn't tracked
+	bool SpacePose( Runtime &runtime, MockSpace *pSpace, XrPosef *outPose )
+	{
+		if ( !pSpace->pAction )
+		{
+			*outPose = pSpace->xrReferenceSpaceType == XR_REFERENCE_SPACE_TYPE_VIEW ? Multiply( runtime.xrHeadPose, pSpace->xrPoseInSpace ) : pSpace->xrPoseInSpace;
+			return true;
+		}
+
+		if ( !pSpace->pAction->pActionSet->bAttached )
+			return false;
+
+		auto vecSources = BoundSources( runtime, pSpace->pSession, pSpace->pAction, pSpace->xrSubactionPath );
+		if ( vecSources.empty() )
+			return false;
+
+		*outPose = Multiply( SourcePose( runtime, *vecSources.front() ), pSpace->xrPoseInSpace );
+		return true;
+	}
+
+	// Default joint layout - palm at the hand's grip pose, wrist behind it and five fingers of four (thumb) or five joints pointing forward
+	XrPosef DefaultJointPose( const XrPosef &xrGripPose, XrHandEXT xrHand, uint32_t unJoint )
+	{
+		XrVector3f xrOffset { 0.0f, 0.0f, 0.0f };
+		if ( unJoint == XR_HAND_JOINT_WRIST_EXT )
+		{
+			xrOffset.z = 0.08f;
+		}
+		else if ( unJoint >= XR_HAND_JOINT_THUMB_METACARPAL_EXT )
+		{
+			const uint32_t unFinger = unJoint < XR_HAND_JOINT_INDEX_METACARPAL_EXT ? 0 : 1 + ( unJoint - XR_HAND_JOINT_INDEX_METACARPAL_EXT ) / 5;
+			const uint32_t unFirstJoint = unFinger == 0 ? ( uint32_t )XR_HAND_JOINT_THUMB_METACARPAL_EXT : ( uint32_t )XR_HAND_JOINT_INDEX_METACARPAL_EXT + ( unFinger - 1 ) * 5;
+			const float fSide = xrHand == XR_HAND_LEFT_EXT ? 1.0f : -1.0f;
+
+			xrOffset.x = fSide * ( ( float )unFinger - 2.0f ) * 0.02f;
+			xrOffset.z = -0.03f * ( float )( unJoint - unFirstJoint + 1 );
+		}
+
+		return Multiply( xrGripPose, { { 0.0f, 0.0f, 0.0f, 1.0f }, xrOffset } );
+	}
+
+	// --------------------------------------------------------------------------------------------
+	// Vulkan swapchain images
+	// --------------------------------------------------------------------------------------------
+
+	bool IsDepthFormat( int64_t nFormat ) { return nFormat == VK_FORMAT_D16_UNORM || nFormat == VK_FORMAT_D32_SFLOAT || nFormat == VK_FORMAT_D24_UNORM_S8_UINT; }
+
+	std::vector< int64_t > SupportedSwapchainFormats( MockSession *pSession )
+	{
+		static const std::array< VkFormat, 7 > k_arrFormats { VK_FORMAT_R8G8B8A8_SRGB,	VK_FORMAT_B8G8R8A8_SRGB,	 VK_FORMAT_R8G8B8A8_UNORM, VK_FORMAT_B8G8R8A8_UNORM,
+															  VK_FORMAT_D32_SFLOAT, VK_FORMAT_D24_UNORM_S8_UINT, VK_FORMAT_D16_UNORM };
+
+		// Only report formats the app's device can render to
+		std::vector< int64_t > vecFormats;
+		if ( pSession->vkPhysicalDevice == VK_NULL_HANDLE )
+			return vecFormats;
+
+		for ( VkFormat vkFormat : k_arrFormats )
+		{
+			VkFormatProperties vkFormatProperties {};
+			vkGetPhysicalDeviceFormatProperties( pSession->vkPhysicalDevice, vkFormat, &vkFormatProperties );
+
+			const VkFormatFeatureFlags vkRequired = IsDepthFormat( vkFormat ) ? VK_FORMAT_FEATURE_DEPTH_STENCIL_ATTACHMENT_BIT : VK_FORMAT_FEATURE_COLOR_ATTACHMENT_BIT;
+			if ( ( vkFormatProperties.optimalTilingFeatures & vkRequired ) == vkRequired )
+				vecFormats.push_back( vkFormat );
+		}
+
+		return vecFormats;
+	}
+
+	void DestroySwapchainImages( MockSwapchain *pSwapchain )
+	{
+		const VkDevice vkDevice = pSwapchain->pSession->vkDevice;
+		for ( VkImage vkImage : pSwapchain->vecImages )
+			vkDestroyImage( vkDevice, vkImage, nullptr );
+
+		for ( VkDeviceMemory vkMemory : pSwapchain->vecMemory )
+			vkFreeMemory( vkDevice, vkMemory, nullptr );
+
+		pSwapchain->vecImages.clear();
+		pSwapchain->vecMemory.clear();
+	}
+
+	// Creates the swapchain images on the app's device and transitions them to the attachment layout that openxr guarantees on acquire
+	XrResult CreateSwapchainImages( MockSwapchain *pSwapchain, uint32_t unImageCount )
+	{
+		MockSession *pSession = pSwapchain->pSession;
+		const XrSwapchainCreateInfo &info = pSwapchain->xrCreateInfo;
+		const bool bIsDepth = IsDepthFormat( info.format );
+
+		VkImageUsageFlags vkUsage = VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT;
+		if ( info.usageFlags & XR_SWAPCHAIN_USAGE_COLOR_ATTACHMENT_BIT )
+			vkUsage |= VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT;
+		if ( info.usageFlags & XR_SWAPCHAIN_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT )
+			vkUsage |= VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT;
+		if ( info.usageFlags & XR_SWAPCHAIN_USAGE_SAMPLED_BIT )
+			vkUsage |= VK_IMAGE_USAGE_SAMPLED_BIT;
+		if ( info.usageFlags & XR_SWAPCHAIN_USAGE_UNORDERED_ACCESS_BIT )
+			vkUsage |= VK_IMAGE_USAGE_STORAGE_BIT;
+		if ( info.usageFlags & XR_SWAPCHAIN_USAGE_INPUT_ATTACHMENT_BIT_KHR )
+			vkUsage |= VK_IMAGE_USAGE_INPUT_ATTACHMENT_BIT;
+
+		VkPhysicalDeviceMemoryProperties vkMemoryProperties {};
+		vkGetPhysicalDeviceMemoryProperties( pSession->vkPhysicalDevice, &vkMemoryProperties );
+
+		for ( uint32_t i = 0; i < unImageCount; i++ )
+		{
+			VkImageCreateInfo vkImageCI { VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO };
+			vkImageCI.imageType = VK_IMAGE_TYPE_2D;
+			vkImageCI.format = ( VkFormat )info.format;
+			vkImageCI.extent = { info.width, info.height, 1 };
+			vkImageCI.mipLevels = std::max( info.mipCount, 1u );
+			vkImageCI.arrayLayers = std::max( info.arraySize, 1u );
+			vkImageCI.samples = ( VkSampleCountFlagBits )std::max( info.sampleCount, 1u );
+			vkImageCI.tiling = VK_IMAGE_TILING_OPTIMAL;
+			vkImageCI.usage = vkUsage;
+			vkImageCI.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+			vkImageCI.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+
+			VkImage vkImage = VK_NULL_HANDLE;
+			if ( vkCreateImage( pSession->vkDevice, &vkImageCI, nullptr, &vkImage ) != VK_SUCCESS )
+				return XR_ERROR_RUNTIME_FAILURE;
+			pSwapchain->vecImages.push_back( vkImage );
+
+			VkMemoryRequirements vkMemoryRequirements {};
+			vkGetImageMemoryRequirements( pSession->vkDevice, vkImage, &vkMemoryRequirements );
+
+			uint32_t unMemoryType = UINT32_MAX;
+			for ( uint32_t t = 0; t < vkMemoryProperties.memoryTypeCount && unMemoryType == UINT32_MAX; t++ )
+			{
+				if ( ( vkMemoryRequirements.memoryTypeBits & ( 1u << t ) ) && ( vkMemoryProperties.memoryTypes[ t ].propertyFlags & VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT ) )
+					unMemoryType = t;
+			}
+
+			if ( unMemoryType == UINT32_MAX )
+				return XR_ERROR_RUNTIME_FAILURE;
+
+			VkMemoryAllocateInfo vkAllocateInfo { VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO };
+			vkAllocateInfo.allocationSize = vkMemoryRequirements.size;
+			vkAllocateInfo.memoryTypeIndex = unMemoryType;
+
+			VkDeviceMemory vkMemory = VK_NULL_HANDLE;
+			if ( vkAllocateMemory( pSession->vkDevice, &vkAllocateInfo, nullptr, &vkMemory ) != VK_SUCCESS )
+				return XR_ERROR_RUNTIME_FAILURE;
+			pSwapchain->vecMemory.push_back( vkMemory );
+
+			if ( vkBindImageMemory( pSession->vkDevice, vkImage, vkMemory, 0 ) != VK_SUCCESS )
+				return XR_ERROR_RUNTIME_FAILURE;
+		}
+
+		// Transition to the attachment layout. The app's queue is borrowed once here - swapchains are expected to be created before rendering starts
+		VkCommandPoolCreateInfo vkPoolCI { VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO };
+		vkPoolCI.queueFamilyIndex = pSession->unQueueFamilyIndex;
+
+		VkCommandPool vkPool = VK_NULL_HANDLE;
+		if ( vkCreateCommandPool( pSession->vkDevice, &vkPoolCI, nullptr, &vkPool ) != VK_SUCCESS )
+			return XR_ERROR_RUNTIME_FAILURE;
+
+		VkCommandBufferAllocateInfo vkCmdAI { VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO };
+		vkCmdAI.commandPool = vkPool;
+		vkCmdAI.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+		vkCmdAI.commandBufferCount = 1;
+
+		VkCommandBuffer vkCmd = VK_NULL_HANDLE;
+		vkAllocateCommandBuffers( pSession->vkDevice, &vkCmdAI, &vkCmd );
+
+		VkCommandBufferBeginInfo vkBeginInfo { VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO };
+		vkBeginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+		vkBeginCommandBuffer( vkCmd, &vkBeginInfo );
+
+		for ( VkImage vkImage : pSwapchain->vecImages )
+		{
+			VkImageMemoryBarrier vkBarrier { VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER };
+			vkBarrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+			vkBarrier.newLayout = bIsDepth ? VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL : VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+			vkBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+			vkBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+			vkBarrier.image = vkImage;
+			vkBarrier.subresourceRange.aspectMask =
+				bIsDepth ? ( VK_IMAGE_ASPECT_DEPTH_BIT | ( info.format == VK_FORMAT_D24_UNORM_S8_UINT ? VK_IMAGE_ASPECT_STENCIL_BIT : 0 ) ) : VK_IMAGE_ASPECT_COLOR_BIT;
+			vkBarrier.subresourceRange.levelCount = VK_REMAINING_MIP_LEVELS;
+			vkBarrier.subresourceRange.layerCount = VK_REMAINING_ARRAY_LAYERS;
+			vkBarrier.dstAccessMask = bIsDepth ? VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT : VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+
+			vkCmdPipelineBarrier( vkCmd, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, 0, 0, nullptr, 0, nullptr, 1, &vkBarrier );
+		}
+
+		vkEndCommandBuffer( vkCmd );
+
+		VkQueue vkQueue = VK_NULL_HANDLE;
+		vkGetDeviceQueue( pSession->vkDevice, pSession->unQueueFamilyIndex, pSession->unQueueIndex, &vkQueue );
+
+		VkSubmitInfo vkSubmitInfo { VK_STRUCTURE_TYPE_SUBMIT_INFO };
+		vkSubmitInfo.commandBufferCount = 1;
+		vkSubmitInfo.pCommandBuffers = &vkCmd;
+		const VkResult vkResult = vkQueueSubmit( vkQueue, 1, &vkSubmitInfo, VK_NULL_HANDLE );
+		vkQueueWaitIdle( vkQueue );
+
+		vkDestroyCommandPool( pSession->vkDevice, vkPool, nullptr );
+		return vkResult == VK_SUCCESS ? XR_SUCCESS : XR_ERROR_RUNTIME_FAILURE;
+	}
+
+	// --------------------------------------------------------------------------------------------
+	// Instance and system
+	// --------------------------------------------------------------------------------------------
+
+	struct SupportedExtension
+	{
+		const char *pccName;
+		uint32_t unVersion;
+	};
+
+	static const std::array< SupportedExtension, 4 > k_arrSupportedExtensions { { { XR_KHR_VULKAN_ENABLE_EXTENSION_NAME, XR_KHR_vulkan_enable_SPEC_VERSION },
+																				  { XR_KHR_VULKAN_ENABLE2_EXTENSION_NAME, XR_KHR_vulkan_enable2_SPEC_VERSION },
+																				  { XR_KHR_COMPOSITION_LAYER_DEPTH_EXTENSION_NAME, XR_KHR_composition_layer_depth_SPEC_VERSION },
+																				  { XR_EXT_HAND_TRACKING_EXTENSION_NAME, XR_EXT_hand_tracking_SPEC_VERSION } } };
+
+	bool IsExtensionEnabled( MockInstance *pInstance, const char *pccName )
+	{
+		return std::find( pInstance->vecEnabledExtensions.begin(), pInstance->vecEnabledExtensions.end(), pccName ) != pInstance->vecEnabledExtensions.end();
+	}
+
+	XRAPI_ATTR XrResult XRAPI_CALL MockEnumerateInstanceExtensionProperties( const char *layerName, uint32_t propertyCapacityInput, uint32_t *propertyCountOutput, XrExtensionProperties *properties )
+	{
+		if ( layerName != nullptr )
+			return XR_ERROR_API_LAYER_NOT_PRESENT;
+
+		std::vector< XrExtensionProperties > vecProperties;
+		for ( auto &extension : k_arrSupportedExtensions )
+		{
+			XrExtensionProperties xrProperties { XR_TYPE_EXTENSION_PROPERTIES };
+			std::strncpy( xrProperties.extensionName, extension.pccName, XR_MAX_EXTENSION_NAME_SIZE - 1 );
+			xrProperties.extensionVersion = extension.unVersion;
+			vecProperties.push_back( xrProperties );
+		}
+
+		return FillArray( vecProperties, propertyCapacityInput, propertyCountOutput, properties );
+	}
+
+	XRAPI_ATTR XrResult XRAPI_CALL MockEnumerateApiLayerProperties( uint32_t propertyCapacityInput, uint32_t *propertyCountOutput, XrApiLayerProperties *properties )
+	{
+		return FillArray( std::vector< XrApiLayerProperties >(), propertyCapacityInput, propertyCountOutput, properties );
+	}
+
+	XRAPI_ATTR XrResult XRAPI_CALL MockCreateInstance( const XrInstanceCreateInfo *createInfo, XrInstance *instance )
+	{
+		Runtime &runtime = GetRuntime();
+		std::lock_guard< std::mutex > lock( runtime.mutex );
+
+		if ( !createInfo || !instance || createInfo->type != XR_TYPE_INSTANCE_CREATE_INFO )
+			return Fail( runtime, XR_ERROR_VALIDATION_FAILURE );
+
+		// A single instance at a time keeps the runtime state simple
+		if ( runtime.pInstance )
+			return Fail( runtime, XR_ERROR_LIMIT_REACHED );
+
+		std::vector< std::string > vecEnabledExtensions;
+		for ( uint32_t i = 0; i < createInfo->enabledExtensionCount; i++ )
+		{
+			const char *pccName = createInfo->enabledExtensionNames[ i ];
+			auto it = std::find_if( k_arrSupportedExtensions.begin(), k_arrSupportedExtensions.end(), [ pccName ]( const SupportedExtension &ext ) { return std::strcmp( ext.pccName, pccName ) == 0; } );
+
+			if ( it == k_arrSupportedExtensions.end() )
+				return Fail( runtime, XR_ERROR_EXTENSION_NOT_PRESENT );
+
+			vecEnabledExtensions.push_back( pccName );
+		}
+
+		auto pInstance = Track( runtime, new MockInstance() );
+		pInstance->vecEnabledExtensions = std::move( vecEnabledExtensions );
+		runtime.pInstance = pInstance;
+
+		*instance = reinterpret_cast< XrInstance >( pInstance );
+		return XR_SUCCESS;
+	}
+
+	void DestroySessionObjects( Runtime &runtime, MockSession *pSession )
+	{
+		std::vector< MockObject * > vecChildren;
+		for ( MockObject *pObject : runtime.setObjects )
+		{
+			if ( pObject->eObjectType == EObjectType::Space && static_cast< MockSpace * >( pObject )->pSession == pSession )
+				vecChildren.push_back( pObject );
+			else if ( pObject->eObjectType == EObjectType::HandTracker && static_cast< MockHandTracker * >( pObject )->pSession == pSession )
+				vecChildren.push_back( pObject );
+			else if ( pObject->eObjectType == EObjectType::Swapchain && static_cast< MockSwapchain * >( pObject )->pSession == pSession )
+			{
+				DestroySwapchainImages( static_cast< MockSwapchain * >( pObject ) );
+				vecChildren.push_back( pObject );
+			}
+		}
+
+		for ( MockObject *pChild : vecChildren )
+			Untrack( runtime, pChild );
+
+		pSession->pInstance->pSession = nullptr;
+		Untrack( runtime, pSession );
+	}
+
+	XRAPI_ATTR XrResult XRAPI_CALL MockDestroyInstance( XrInstance instance )
+	{
+		Runtime &runtime = GetRuntime();
+		std::lock_guard< std::mutex > lock( runtime.mutex );
+
+		auto pInstance = Lookup< MockInstance >( runtime, instance, EObjectType::Instance );
+		if ( !pInstance )
+			return Fail( runtime, XR_ERROR_HANDLE_INVALID );
+
+		if ( pInstance->pSession )
+			DestroySessionObjects( runtime, pInstance->pSession );
+
+		// Children of the instance - action sets and their actions
+		std::vector< MockObject * > vecChildren;
+		for ( MockObject *pObject : runtime.setObjects )
+		{
+			if ( pObject->eObjectType == EObjectType::ActionSet || pObject->eObjectType == EObjectType::Action )
+				vecChildren.push_back( pObject );
+		}
+
+		for ( MockObject *pChild : vecChildren )
+			Untrack( runtime, pChild );
+
+		Untrack( runtime, pInstance );
+		runtime.pInstance = nullptr;
+		runtime.deqEvents.clear();
+		runtime.vecLastSubmittedViews.clear();
+		return XR_SUCCESS;
+	}
+
+	XRAPI_ATTR XrResult XRAPI_CALL MockGetInstanceProperties( XrInstance instance, XrInstanceProperties *instanceProperties )
+	{
+		Runtime &runtime = GetRuntime();
+		std::lock_guard< std::mutex > lock( runtime.mutex );
+
+		if ( !Lookup< MockInstance >( runtime, instance, EObjectType::Instance ) )
+			return Fail( runtime, XR_ERROR_HANDLE_INVALID );
+
+		instanceProperties->runtimeVersion = XR_MAKE_VERSION( 0, 1, 0 );
+		std::strncpy( instanceProperties->runtimeName, k_pccRuntimeName, XR_MAX_RUNTIME_NAME_SIZE - 1 );
+		return XR_SUCCESS;
+	}
+
+	XRAPI_ATTR XrResult XRAPI_CALL MockPollEvent( XrInstance instance, XrEventDataBuffer *eventData )
+	{
+		Runtime &runtime = GetRuntime();
+		std::lock_guard< std::mutex > lock( runtime.mutex );
+
+		if ( !Lookup< MockInstance >( runtime, instance, EObjectType::Instance ) )
+			return Fail( runtime, XR_ERROR_HANDLE_INVALID );
+
+		if ( runtime.deqEvents.empty() )
+			return XR_EVENT_UNAVAILABLE;
+
+		*eventData = runtime.deqEvents.front();
+		runtime.deqEvents.pop_front();
+		return XR_SUCCESS;
+	}
+
+#define MOCK_ENUM_CASE( name, val )                                                                                                                                                                    \
+	case name:                                                                                                                                                                                         \
+		return #name;
+
+	const char *ResultName( XrResult xrResult )
+	{
+		switch ( xrResult )
+		{
+			XR_LIST_ENUM_XrResult( MOCK_ENUM_CASE ) default : return nullptr;
+		}
+	}
+
+	const char *StructureTypeName( XrStructureType xrType )
+	{
+		switch ( xrType )
+		{
+			XR_LIST_ENUM_XrStructureType( MOCK_ENUM_CASE ) default : return nullptr;
+		}
+	}
+
+#undef MOCK_ENUM_CASE
+
+	XRAPI_ATTR XrResult XRAPI_CALL MockResultToString( XrInstance instance, XrResult value, char buffer[ XR_MAX_RESULT_STRING_SIZE ] )
+	{
+		const char *pccName = ResultName( value );
+		if ( pccName )
+			std::snprintf( buffer, XR_MAX_RESULT_STRING_SIZE, "%s", pccName );
+		else
+			std::snprintf( buffer, XR_MAX_RESULT_STRING_SIZE, "XR_%s_%d", value < 0 ? "UNKNOWN_FAILURE" : "UNKNOWN_SUCCESS", ( int )value );
+
+		return XR_SUCCESS;
+	}
+
+	XRAPI_ATTR XrResult XRAPI_CALL MockStructureTypeToString( XrInstance instance, XrStructureType value, char buffer[ XR_MAX_STRUCTURE_NAME_SIZE ] )
+	{
+		const char *pccName = StructureTypeName( value );
+		if ( pccName )
+			std::snprintf( buffer, XR_MAX_STRUCTURE_NAME_SIZE, "%s", pccName );
+		else
+			std::snprintf( buffer, XR_MAX_STRUCTURE_NAME_SIZE, "XR_UNKNOWN_STRUCTURE_TYPE_%d", ( int )value );
+
+		return XR_SUCCESS;
+	}
+
+	XRAPI_ATTR XrResult XRAPI_CALL MockGetSystem( XrInstance instance, const XrSystemGetInfo *getInfo, XrSystemId *systemId )
+	{
+		Runtime &runtime = GetRuntime();
+		std::lock_guard< std::mutex > lock( runtime.mutex );
+
+		if ( !Lookup< MockInstance >( runtime, instance, EObjectType::Instance ) )
+			return Fail( runtime, XR_ERROR_HANDLE_INVALID );
+
+		if ( getInfo->formFactor != XR_FORM_FACTOR_HEAD_MOUNTED_DISPLAY )
+			return Fail( runtime, XR_ERROR_FORM_FACTOR_UNSUPPORTED );
+
+		*systemId = k_xrSystemId;
+		return XR_SUCCESS;
+	}
+
+	XRAPI_ATTR XrResult XRAPI_CALL MockGetSystemProperties( XrInstance instance, XrSystemId systemId, XrSystemProperties *properties )
+	{
+		Runtime &runtime = GetRuntime();
+		std::lock_guard< std::mutex > lock( runtime.mutex );
+
+		if ( !Lookup< MockInstance >( runtime, instance, EObjectType::Instance ) )
+			return Fail( runtime, XR_ERROR_HANDLE_INVALID );
+
+		if ( systemId != k_xrSystemId )
+			return Fail( runtime, XR_ERROR_SYSTEM_INVALID );
+
+		properties->systemId = k_xrSystemId;
+		properties->vendorId = 0;
+		std::strncpy( properties->systemName, k_pccRuntimeName, XR_MAX_SYSTEM_NAME_SIZE - 1 );
+		properties->graphicsProperties.maxLayerCount = XR_MIN_COMPOSITION_LAYERS_SUPPORTED;
+		properties->graphicsProperties.maxSwapchainImageWidth = 4096;
+		properties->graphicsProperties.maxSwapchainImageHeight = 4096;
+		properties->trackingProperties.orientationTracking = XR_TRUE;
+		properties->trackingProperties.positionTracking = XR_TRUE;
+
+		for ( auto pNext = reinterpret_cast< XrBaseOutStructure * >( properties->next ); pNext; pNext = pNext->next )
+		{
+			if ( pNext->type == XR_TYPE_SYSTEM_HAND_TRACKING_PROPERTIES_EXT )
+				reinterpret_cast< XrSystemHandTrackingPropertiesEXT * >( pNext )->supportsHandTracking = XR_TRUE;
+		}
+
+		return XR_SUCCESS;
+	}
+
+	XRAPI_ATTR XrResult XRAPI_CALL MockEnumerateEnvironmentBlendModes(
+		XrInstance instance, XrSystemId systemId, XrViewConfigurationType viewConfigurationType, uint32_t environmentBlendModeCapacityInput, uint32_t *environmentBlendModeCountOutput,
+		XrEnvironmentBlendMode *environmentBlendModes )
+	{
+		if ( viewConfigurationType != XR_VIEW_CONFIGURATION_TYPE_PRIMARY_STEREO )
+			return XR_ERROR_VIEW_CONFIGURATION_TYPE_UNSUPPORTED;
+
+		return FillArray( std::vector< XrEnvironmentBlendMode > { XR_ENVIRONMENT_BLEND_MODE_OPAQUE }, environmentBlendModeCapacityInput, environmentBlendModeCountOutput, environmentBlendModes );
+	}
+
+	XRAPI_ATTR XrResult XRAPI_CALL MockEnumerateViewConfigurations(
+		XrInstance instance, XrSystemId systemId, uint32_t viewConfigurationTypeCapacityInput, uint32_t *viewConfigurationTypeCountOutput, XrViewConfigurationType *viewConfigurationTypes )
+	{
+		return FillArray(
+			std::vector< XrViewConfigurationType > { XR_VIEW_CONFIGURATION_TYPE_PRIMARY_STEREO }, viewConfigurationTypeCapacityInput, viewConfigurationTypeCountOutput, viewConfigurationTypes );
+	}
+
+	XRAPI_ATTR XrResult XRAPI_CALL
+		MockGetViewConfigurationProperties( XrInstance instance, XrSystemId systemId, XrViewConfigurationType viewConfigurationType, XrViewConfigurationProperties *configurationProperties )
+	{
+		if ( viewConfigurationType != XR_VIEW_CONFIGURATION_TYPE_PRIMARY_STEREO )
+			return XR_ERROR_VIEW_CONFIGURATION_TYPE_UNSUPPORTED;
+
+		configurationProperties->viewConfigurationType = viewConfigurationType;
+		configurationProperties->fovMutable = XR_TRUE;
+		return XR_SUCCESS;
+	}
+
+	XRAPI_ATTR XrResult XRAPI_CALL MockEnumerateViewConfigurationViews(
+		XrInstance instance, XrSystemId systemId, XrViewConfigurationType viewConfigurationType, uint32_t viewCapacityInput, uint32_t *viewCountOutput, XrViewConfigurationView *views )
+	{
+		if ( viewConfigurationType != XR_VIEW_CONFIGURATION_TYPE_PRIMARY_STEREO )
+			return XR_ERROR_VIEW_CONFIGURATION_TYPE_UNSUPPORTED;
+
+		Runtime &runtime = GetRuntime();
+		std::lock_guard< std::mutex > lock( runtime.mutex );
+
+		XrViewConfigurationView xrView { XR_TYPE_VIEW_CONFIGURATION_VIEW };
+		xrView.recommendedImageRectWidth = runtime.config.unRecommendedWidth;
+		xrView.recommendedImageRectHeight = runtime.config.unRecommendedHeight;
+		xrView.maxImageRectWidth = 4096;
+		xrView.maxImageRectHeight = 4096;
+		xrView.recommendedSwapchainSampleCount = 1;
+		xrView.maxSwapchainSampleCount = 4;
+
+		return FillArray( std::vector< XrViewConfigurationView >( k_unViewCount, xrView ), viewCapacityInput, viewCountOutput, views );
+	}
+
+	// --------------------------------------------------------------------------------------------
+	// Vulkan graphics (XR_KHR_vulkan_enable and XR_KHR_vulkan_enable2)
+	// --------------------------------------------------------------------------------------------
+
+	XRAPI_ATTR XrResult XRAPI_CALL MockGetVulkanGraphicsRequirementsKHR( XrInstance instance, XrSystemId systemId, XrGraphicsRequirementsVulkanKHR *graphicsRequirements )
+	{
+		if ( systemId != k_xrSystemId )
+			return XR_ERROR_SYSTEM_INVALID;
+
+		graphicsRequirements->minApiVersionSupported = XR_MAKE_VERSION( 1, 0, 0 );
+		graphicsRequirements->maxApiVersionSupported = XR_MAKE_VERSION( 1, 3, 0 );
+		return XR_SUCCESS;
+	}
+
+	// No extra instance or device extensions are needed as images are created on the app's device
+	XRAPI_ATTR XrResult XRAPI_CALL MockGetVulkanExtensionsKHR( XrInstance instance, XrSystemId systemId, uint32_t bufferCapacityInput, uint32_t *bufferCountOutput, char *buffer )
+	{
+		return FillString( "", bufferCapacityInput, bufferCountOutput, buffer );
+	}
+
+	XrResult SelectPhysicalDevice( VkInstance vkInstance, VkPhysicalDevice *vkPhysicalDevice )
+	{
+		uint32_t unCount = 0;
+		if ( vkEnumeratePhysicalDevices( vkInstance, &unCount, nullptr ) != VK_SUCCESS || unCount == 0 )
+			return XR_ERROR_RUNTIME_FAILURE;
+
+		std::vector< VkPhysicalDevice > vecDevices( unCount );
+		vkEnumeratePhysicalDevices( vkInstance, &unCount, vecDevices.data() );
+
+		Runtime &runtime = GetRuntime();
+		std::lock_guard< std::mutex > lock( runtime.mutex );
+		if ( runtime.pInstance )
+		{
+			runtime.pInstance->vkInstance = vkInstance;
+			runtime.pInstance->vkPhysicalDevice = vecDevices.front();
+		}
+
+		*vkPhysicalDevice = vecDevices.front();
+		return XR_SUCCESS;
+	}
+
+	XRAPI_ATTR XrResult XRAPI_CALL MockGetVulkanGraphicsDeviceKHR( XrInstance instance, XrSystemId systemId, VkInstance vkInstance, VkPhysicalDevice *vkPhysicalDevice )
+	{
+		if ( systemId != k_xrSystemId )
+			return XR_ERROR_SYSTEM_INVALID;
+
+		return SelectPhysicalDevice( vkInstance, vkPhysicalDevice );
+	}
+
+	XRAPI_ATTR XrResult XRAPI_CALL MockGetVulkanGraphicsDevice2KHR( XrInstance instance, const XrVulkanGraphicsDeviceGetInfoKHR *getInfo, VkPhysicalDevice *vulkanPhysicalDevice )
+	{
+		if ( getInfo->systemId != k_xrSystemId )
+			return XR_ERROR_SYSTEM_INVALID;
+
+		return SelectPhysicalDevice( getInfo->vulkanInstance, vulkanPhysicalDevice );
+	}
+
+	XRAPI_ATTR XrResult XRAPI_CALL MockCreateVulkanInstanceKHR( XrInstance instance, const XrVulkanInstanceCreateInfoKHR *createInfo, VkInstance *vulkanInstance, VkResult *vulkanResult )
+	{
+		auto pfnCreateInstance = ( PFN_vkCreateInstance )createInfo->pfnGetInstanceProcAddr( VK_NULL_HANDLE, "vkCreateInstance" );
+		*vulkanResult = pfnCreateInstance( createInfo->vulkanCreateInfo, createInfo->vulkanAllocator, vulkanInstance );
+		return XR_SUCCESS;
+	}
+
+	XRAPI_ATTR XrResult XRAPI_CALL MockCreateVulkanDeviceKHR( XrInstance instance, const XrVulkanDeviceCreateInfoKHR *createInfo, VkDevice *vulkanDevice, VkResult *vulkanResult )
+	{
+		VkInstance vkInstance = VK_NULL_HANDLE;
+		{
+			Runtime &runtime = GetRuntime();
+			std::lock_guard< std::mutex > lock( runtime.mutex );
+			if ( !runtime.pInstance || runtime.pInstance->vkInstance == VK_NULL_HANDLE )
+				return XR_ERROR_VALIDATION_FAILURE;
+
+			vkInstance = runtime.pInstance->vkInstance;
+		}
+
+		auto pfnCreateDevice = ( PFN_vkCreateDevice )createInfo->pfnGetInstanceProcAddr( vkInstance, "vkCreateDevice" );
+		*vulkanResult = pfnCreateDevice( createInfo->vulkanPhysicalDevice, createInfo->vulkanCreateInfo, createInfo->vulkanAllocator, vulkanDevice );
+		return XR_SUCCESS;
+	}
+
+	// --------------------------------------------------------------------------------------------
+	// Session
+	// --------------------------------------------------------------------------------------------
+
+	XRAPI_ATTR XrResult XRAPI_CALL MockCreateSession( XrInstance instance, const XrSessionCreateInfo *createInfo, XrSession *session )
+	{
+		Runtime &runtime = GetRuntime();
+		std::lock_guard< std::mutex > lock( runtime.mutex );
+
+		auto pInstance = Lookup< MockInstance >( runtime, instance, EObjectType::Instance );
+		if ( !pInstance )
+			return Fail( runtime, XR_ERROR_HANDLE_INVALID );
+
+		if ( createInfo->systemId != k_xrSystemId )
+			return Fail( runtime, XR_ERROR_SYSTEM_INVALID );
+
+		if ( pInstance->pSession )
+			return Fail( runtime, XR_ERROR_LIMIT_REACHED );
+
+		auto pSession = new MockSession();
+		pSession->pInstance = pInstance;
+
+		// Sessions without a vulkan binding are headless - frames can be waited on, begun and ended but no swapchains created
+		for ( auto pNext = reinterpret_cast< const XrBaseInStructure * >( createInfo->next ); pNext; pNext = pNext->next )
+		{
+			if ( pNext->type == XR_TYPE_GRAPHICS_BINDING_VULKAN_KHR )
+			{
+				auto pBinding = reinterpret_cast< const XrGraphicsBindingVulkanKHR * >( pNext );
+				if ( pBinding->device == VK_NULL_HANDLE || pBinding->physicalDevice == VK_NULL_HANDLE )
+				{
+					delete pSession;
+					return Fail( runtime, XR_ERROR_GRAPHICS_DEVICE_INVALID );
+				}
+
+				pSession->vkInstance = pBinding->instance;
+				pSession->vkPhysicalDevice = pBinding->physicalDevice;
+				pSession->vkDevice = pBinding->device;
+				pSession->unQueueFamilyIndex = pBinding->queueFamilyIndex;
+				pSession->unQueueIndex = pBinding->queueIndex;
+			}
+		}
+
+		Track( runtime, pSession );
+		pInstance->pSession = pSession;
+
+		QueueStateChange( runtime, pSession, XR_SESSION_STATE_IDLE );
+		QueueStateChange( runtime, pSession, XR_SESSION_STATE_READY );
+
+		*session = reinterpret_cast< XrSession >( pSession );
+		return XR_SUCCESS;
+	}
+
+	XRAPI_ATTR XrResult XRAPI_CALL MockDestroySession( XrSession session )
+	{
+		Runtime &runtime = GetRuntime();
+		std::lock_guard< std::mutex > lock( runtime.mutex );
+
+		auto pSession = Lookup< MockSession >( runtime, session, EObjectType::Session );
+		if ( !pSession )
+			return Fail( runtime, XR_ERROR_HANDLE_INVALID );
+
+		DestroySessionObjects( runtime, pSession );
+		return XR_SUCCESS;
+	}
+
+	XRAPI_ATTR XrResult XRAPI_CALL MockBeginSession( XrSession session, const XrSessionBeginInfo *beginInfo )
+	{
+		Runtime &runtime = GetRuntime();
+		std::lock_guard< std::mutex > lock( runtime.mutex );
+
+		auto pSession = Lookup< MockSession >( runtime, session, EObjectType::Session );
+		if ( !pSession )
+			return Fail( runtime, XR_ERROR_HANDLE_INVALID );
+
+		if ( pSession->bRunning )
+			return Fail( runtime, XR_ERROR_SESSION_RUNNING );
+
+		if ( pSession->xrState != XR_SESSION_STATE_READY )
+			return Fail( runtime, XR_ERROR_SESSION_NOT_READY );
+
+		if ( beginInfo->primaryViewConfigurationType != XR_VIEW_CONFIGURATION_TYPE_PRIMARY_STEREO )
+			return Fail( runtime, XR_ERROR_VIEW_CONFIGURATION_TYPE_UNSUPPORTED );
+
+		pSession->bRunning = true;
+		pSession->bExitRequested = false;
+		pSession->xrViewConfigurationType = beginInfo->primaryViewConfigurationType;
+
+		QueueStateChange( runtime, pSession, XR_SESSION_STATE_SYNCHRONIZED );
+		QueueStateChange( runtime, pSession, XR_SESSION_STATE_VISIBLE );
+		QueueStateChange( runtime, pSession, XR_SESSION_STATE_FOCUSED );
+		return XR_SUCCESS;
+	}
+
+	XRAPI_ATTR XrResult XRAPI_CALL MockEndSession( XrSession session )
+	{
+		Runtime &runtime = GetRuntime();
+		std::lock_guard< std::mutex > lock( runtime.mutex );
+
+		auto pSession = Lookup< MockSession >( runtime, session, EObjectType::Session );
+		if ( !pSession )
+			return Fail( runtime, XR_ERROR_HANDLE_INVALID );
+
+		if ( !pSession->bRunning )
+			return Fail( runtime, XR_ERROR_SESSION_NOT_RUNNING );
+
+		if ( pSession->xrState != XR_SESSION_STATE_STOPPING )
+			return Fail( runtime, XR_ERROR_SESSION_NOT_STOPPING );
+
+		pSession->bRunning = false;
+		QueueStateChange( runtime, pSession, XR_SESSION_STATE_IDLE );
+		if ( pSession->bExitRequested )
+			QueueStateChange( runtime, pSession, XR_SESSION_STATE_EXITING );
+
+		return XR_SUCCESS;
+	}
+
+	XRAPI_ATTR XrResult XRAPI_CALL MockRequestExitSession( XrSession session )
+	{
+		Runtime &runtime = GetRuntime();
+		std::lock_guard< std::mutex > lock( runtime.mutex );
+
+		auto pSession = Lookup< MockSession >( runtime, session, EObjectType::Session );
+		if ( !pSession )
+			return Fail( runtime, XR_ERROR_HANDLE_INVALID );
+
+		if ( !pSession->bRunning )
+			return Fail( runtime, XR_ERROR_SESSION_NOT_RUNNING );
+
+		StopSession( runtime, pSession );
+		return XR_SUCCESS;
+	}
+
+	// --------------------------------------------------------------------------------------------
+	// Frames
+	// --------------------------------------------------------------------------------------------
+
+	XRAPI_ATTR XrResult XRAPI_CALL MockWaitFrame( XrSession session, const XrFrameWaitInfo *frameWaitInfo, XrFrameState *frameState )
+	{
+		Runtime &runtime = GetRuntime();
+		MockSession *pSession = nullptr;
+		float fDisplayRate = 0.0f;
+		bool bShouldRender = false;
+		{
+			std::lock_guard< std::mutex > lock( runtime.mutex );
+
+			pSession = Lookup< MockSession >( runtime, session, EObjectType::Session );
+			if ( !pSession )
+				return Fail( runtime, XR_ERROR_HANDLE_INVALID );
+
+			if ( !pSession->bRunning )
+				return Fail( runtime, XR_ERROR_SESSION_NOT_RUNNING );
+
+			runtime.stats.unWaitFrameCalls++;
+			fDisplayRate = runtime.config.fDisplayRate;
+			bShouldRender = pSession->xrState == XR_SESSION_STATE_VISIBLE || pSession->xrState == XR_SESSION_STATE_FOCUSED;
+		}
+
+		// A second wait blocks until the previously waited frame has been begun
+		FramePacing &pacing = pSession->framePacing;
+		std::unique_lock< std::mutex > lock( pacing.mutex );
+		pacing.cv.wait( lock, [ &pacing ] { return pacing.unBegun == pacing.unWaited; } );
+		pacing.unWaited++;
+
+		// Wake up on the next display period boundary, one frame per period at most
+		const int64_t nPeriodNs = fDisplayRate > 0.0f ? ( int64_t )( 1e9 / fDisplayRate ) : k_nNominalPeriodNs;
+		const int64_t nNowNs = NowNs();
+		int64_t nWakeNs = nNowNs;
+
+		if ( fDisplayRate > 0.0f )
+		{
+			nWakeNs = ( nNowNs / nPeriodNs + 1 ) * nPeriodNs;
+			if ( nWakeNs <= pacing.nLastWakeNs )
+				nWakeNs = pacing.nLastWakeNs + nPeriodNs;
+		}
+
+		pacing.nLastWakeNs = nWakeNs;
+		lock.unlock();
+
+		if ( nWakeNs > nNowNs )
+			std::this_thread::sleep_for( std::chrono::nanoseconds( nWakeNs - nNowNs ) );
+
+		frameState->predictedDisplayTime = nWakeNs + nPeriodNs;
+		frameState->predictedDisplayPeriod = nPeriodNs;
+		frameState->shouldRender = bShouldRender ? XR_TRUE : XR_FALSE;
+		return XR_SUCCESS;
+	}
+
+	XRAPI_ATTR XrResult XRAPI_CALL MockBeginFrame( XrSession session, const XrFrameBeginInfo *frameBeginInfo )
+	{
+		Runtime &runtime = GetRuntime();
+		MockSession *pSession = nullptr;
+		{
+			std::lock_guard< std::mutex > lock( runtime.mutex );
+			pSession = Lookup< MockSession >( runtime, session, EObjectType::Session );
+			if ( !pSession )
+				return Fail( runtime, XR_ERROR_HANDLE_INVALID );
+
+			if ( !pSession->bRunning )
+				return Fail( runtime, XR_ERROR_SESSION_NOT_RUNNING );
+		}
+
+		FramePacing &pacing = pSession->framePacing;
+		std::unique_lock< std::mutex > lock( pacing.mutex );
+
+		std::lock_guard< std::mutex > runtimeLock( runtime.mutex );
+		if ( pacing.unBegun == pacing.unWaited )
+			return Fail( runtime, XR_ERROR_CALL_ORDER_INVALID );
+
+		runtime.stats.unBeginFrameCalls++;
+		pacing.unBegun++;
+		pacing.cv.notify_all();
+
+		// Beginning a frame while the previous one hasn't been ended discards the previous frame
+		if ( pacing.bFrameBegun )
+		{
+			runtime.stats.unDiscardedFrames++;
+			return XR_FRAME_DISCARDED;
+		}
+
+		pacing.bFrameBegun = true;
+		return XR_SUCCESS;
+	}
+
+	// Validates a projection layer and resolves its views to the released swapchain images
+	XrResult ValidateProjectionLayer( Runtime &runtime, MockSession *pSession, const XrCompositionLayerProjection *pLayer, std::vector< SubmittedView > &outViews )
+	{
+		if ( !Lookup< MockSpace >( runtime, pLayer->space, EObjectType::Space ) )
+			return XR_ERROR_HANDLE_INVALID;
+
+		if ( pLayer->viewCount != k_unViewCount || !pLayer->views )
+			return XR_ERROR_VALIDATION_FAILURE;
+
+		for ( uint32_t v = 0; v < pLayer->viewCount; v++ )
+		{
+			const XrCompositionLayerProjectionView &view = pLayer->views[ v ];
+			auto pSwapchain = Lookup< MockSwapchain >( runtime, view.subImage.swapchain, EObjectType::Swapchain );
+			if ( !pSwapchain || pSwapchain->pSession != pSession )
+				return XR_ERROR_HANDLE_INVALID;
+
+			// Each submitted swapchain must have had an image released
+			if ( pSwapchain->nLastReleased < 0 )
+				return XR_ERROR_LAYER_INVALID;
+
+			const XrSwapchainCreateInfo &info = pSwapchain->xrCreateInfo;
+			if ( view.subImage.imageArrayIndex >= info.arraySize )
+				return XR_ERROR_VALIDATION_FAILURE;
+
+			const XrRect2Di &rect = view.subImage.imageRect;
+			if ( rect.offset.x < 0 || rect.offset.y < 0 || rect.extent.width <= 0 || rect.extent.height <= 0 || ( uint32_t )( rect.offset.x + rect.extent.width ) > info.width ||
+				 ( uint32_t )( rect.offset.y + rect.extent.height ) > info.height )
+				return XR_ERROR_SWAPCHAIN_RECT_INVALID;
+
+			SubmittedView submittedView;
+			submittedView.vkImage = pSwapchain->vecImages[ pSwapchain->nLastReleased ];
+			submittedView.vkFormat = ( VkFormat )info.format;
+			submittedView.unWidth = info.width;
+			submittedView.unHeight = info.height;
+			submittedView.unArrayIndex = view.subImage.imageArrayIndex;
+			submittedView.xrImageRect = rect;
+			submittedView.xrPose = view.pose;
+			outViews.push_back( submittedView );
+		}
+
+		return XR_SUCCESS;
+	}
+
+	XRAPI_ATTR XrResult XRAPI_CALL MockEndFrame( XrSession session, const XrFrameEndInfo *frameEndInfo )
+	{
+		Runtime &runtime = GetRuntime();
+		MockSession *pSession = nullptr;
+		{
+			std::lock_guard< std::mutex > lock( runtime.mutex );
+			pSession = Lookup< MockSession >( runtime, session, EObjectType::Session );
+			if ( !pSession )
+				return Fail( runtime, XR_ERROR_HANDLE_INVALID );
+		}
+
+		FramePacing &pacing = pSession->framePacing;
+		uint32_t unEndFrameCostUs = 0;
+		{
+			std::lock_guard< std::mutex > lock( pacing.mutex );
+			std::lock_guard< std::mutex > runtimeLock( runtime.mutex );
+
+			if ( !pacing.bFrameBegun )
+				return Fail( runtime, XR_ERROR_CALL_ORDER_INVALID );
+
+			runtime.stats.unEndFrameCalls++;
+
+			// The frame is ended even if the submitted layers are invalid
+			pacing.bFrameBegun = false;
+
+			if ( frameEndInfo->displayTime <= 0 )
+				return Fail( runtime, XR_ERROR_TIME_INVALID );
+
+			if ( frameEndInfo->environmentBlendMode != XR_ENVIRONMENT_BLEND_MODE_OPAQUE )
+				return Fail( runtime, XR_ERROR_ENVIRONMENT_BLEND_MODE_UNSUPPORTED );
+
+			if ( frameEndInfo->layerCount > XR_MIN_COMPOSITION_LAYERS_SUPPORTED )
+				return Fail( runtime, XR_ERROR_LAYER_LIMIT_EXCEEDED );
+
+			if ( frameEndInfo->layerCount > 0 && !frameEndInfo->layers )
+				return Fail( runtime, XR_ERROR_LAYER_INVALID );
+
+			std::vector< SubmittedView > vecViews;
+			for ( uint32_t i = 0; i < frameEndInfo->layerCount; i++ )
+			{
+				const XrCompositionLayerBaseHeader *pLayer = frameEndInfo->layers[ i ];
+				if ( !pLayer )
+					return Fail( runtime, XR_ERROR_LAYER_INVALID );
+
+				if ( pLayer->type == XR_TYPE_COMPOSITION_LAYER_PROJECTION )
+				{
+					const XrResult xrResult = ValidateProjectionLayer( runtime, pSession, reinterpret_cast< const XrCompositionLayerProjection * >( pLayer ), vecViews );
+					if ( !XR_SUCCEEDED( xrResult ) )
+						return Fail( runtime, xrResult );
+				}
+			}
+
+			if ( frameEndInfo->layerCount > 0 )
+				runtime.stats.unFramesWithLayers++;
+
+			runtime.vecLastSubmittedViews = std::move( vecViews );
+			unEndFrameCostUs = runtime.config.unEndFrameCostUs;
+		}
+
+		if ( unEndFrameCostUs > 0 )
+			std::this_thread::sleep_for( std::chrono::microseconds( unEndFrameCostUs ) );
+
+		return XR_SUCCESS;
+	}
+
+	// --------------------------------------------------------------------------------------------
+	// Spaces and views
+	// --------------------------------------------------------------------------------------------
+
+	XRAPI_ATTR XrResult XRAPI_CALL MockEnumerateReferenceSpaces( XrSession session, uint32_t spaceCapacityInput, uint32_t *spaceCountOutput, XrReferenceSpaceType *spaces )
+	{
+		return FillArray(
+			std::vector< XrReferenceSpaceType > { XR_REFERENCE_SPACE_TYPE_VIEW, XR_REFERENCE_SPACE_TYPE_LOCAL, XR_REFERENCE_SPACE_TYPE_STAGE }, spaceCapacityInput, spaceCountOutput, spaces );
+	}
+
+	XRAPI_ATTR XrResult XRAPI_CALL MockCreateReferenceSpace( XrSession session, const XrReferenceSpaceCreateInfo *createInfo, XrSpace *space )
+	{
+		Runtime &runtime = GetRuntime();
+		std::lock_guard< std::mutex > lock( runtime.mutex );
+
+		auto pSession = Lookup< MockSession >( runtime, session, EObjectType::Session );
+		if ( !pSession )
+			return Fail( runtime, XR_ERROR_HANDLE_INVALID );
+
+		if ( createInfo->referenceSpaceType != XR_REFERENCE_SPACE_TYPE_VIEW && createInfo->referenceSpaceType != XR_REFERENCE_SPACE_TYPE_LOCAL &&
+			 createInfo->referenceSpaceType != XR_REFERENCE_SPACE_TYPE_STAGE )
+			return Fail( runtime, XR_ERROR_REFERENCE_SPACE_UNSUPPORTED );
+
+		if ( !IsValidPose( createInfo->poseInReferenceSpace ) )
+			return Fail( runtime, XR_ERROR_POSE_INVALID );
+
+		auto pSpace = Track( runtime, new MockSpace() );
+		pSpace->pSession = pSession;
+		pSpace->xrReferenceSpaceType = createInfo->referenceSpaceType;
+		pSpace->xrPoseInSpace = createInfo->poseInReferenceSpace;
+
+		*space = reinterpret_cast< XrSpace >( pSpace );
+		return XR_SUCCESS;
+	}
+
+	XRAPI_ATTR XrResult XRAPI_CALL MockGetReferenceSpaceBoundsRect( XrSession session, XrReferenceSpaceType referenceSpaceType, XrExtent2Df *bounds )
+	{
+		if ( referenceSpaceType != XR_REFERENCE_SPACE_TYPE_STAGE )
+		{
+			*bounds = { 0.0f, 0.0f };
+			return XR_SPACE_BOUNDS_UNAVAILABLE;
+		}
+
+		*bounds = { 2.0f, 2.0f };
+		return XR_SUCCESS;
+	}
+
+	XRAPI_ATTR XrResult XRAPI_CALL MockCreateActionSpace( XrSession session, const XrActionSpaceCreateInfo *createInfo, XrSpace *space )
+	{
+		Runtime &runtime = GetRuntime();
+		std::lock_guard< std::mutex > lock( runtime.mutex );
+
+		auto pSession = Lookup< MockSession >( runtime, session, EObjectType::Session );
+		auto pAction = Lookup< MockAction >( runtime, createInfo->action, EObjectType::Action );
+		if ( !pSession || !pAction )
+			return Fail( runtime, XR_ERROR_HANDLE_INVALID );
+
+		if ( pAction->xrActionType != XR_ACTION_TYPE_POSE_INPUT )
+			return Fail( runtime, XR_ERROR_ACTION_TYPE_MISMATCH );
+
+		if ( createInfo->subactionPath != XR_NULL_PATH &&
+			 std::find( pAction->vecSubactionPaths.begin(), pAction->vecSubactionPaths.end(), createInfo->subactionPath ) == pAction->vecSubactionPaths.end() )
+			return Fail( runtime, XR_ERROR_PATH_UNSUPPORTED );
+
+		if ( !IsValidPose( createInfo->poseInActionSpace ) )
+			return Fail( runtime, XR_ERROR_POSE_INVALID );
+
+		auto pSpace = Track( runtime, new MockSpace() );
+		pSpace->pSession = pSession;
+		pSpace->pAction = pAction;
+		pSpace->xrSubactionPath = createInfo->subactionPath;
+		pSpace->xrPoseInSpace = createInfo->poseInActionSpace;
+
+		*space = reinterpret_cast< XrSpace >( pSpace );
+		return XR_SUCCESS;
+	}
+
+	XRAPI_ATTR XrResult XRAPI_CALL MockDestroySpace( XrSpace space )
+	{
+		Runtime &runtime = GetRuntime();
+		std::lock_guard< std::mutex > lock( runtime.mutex );
+
+		auto pSpace = Lookup< MockSpace >( runtime, space, EObjectType::Space );
+		if ( !pSpace )
+			return Fail( runtime, XR_ERROR_HANDLE_INVALID );
+
+		Untrack( runtime, pSpace );
+		return XR_SUCCESS;
+	}
+
+	XRAPI_ATTR XrResult XRAPI_CALL MockLocateSpace( XrSpace space, XrSpace baseSpace, XrTime time, XrSpaceLocation *location )
+	{
+		Runtime &runtime = GetRuntime();
+		std::lock_guard< std::mutex > lock( runtime.mutex );
+
+		auto pSpace = Lookup< MockSpace >( runtime, space, EObjectType::Space );
+		auto pBaseSpace = Lookup< MockSpace >( runtime, baseSpace, EObjectType::Space );
+		if ( !pSpace || !pBaseSpace )
+			return Fail( runtime, XR_ERROR_HANDLE_INVALID );
+
+		if ( time <= 0 )
+			return Fail( runtime, XR_ERROR_TIME_INVALID );
+
+		runtime.stats.unLocateSpaceCalls++;
+
+		XrPosef xrPose, xrBasePose;
+		const bool bTracked = SpacePose( runtime, pSpace, &xrPose ) && SpacePose( runtime, pBaseSpace, &xrBasePose );
+
+		location->locationFlags = 0;
+		location->pose = IdentityPose();
+		if ( bTracked )
+		{
+			location->pose = Multiply( Inverse( xrBasePose ), xrPose );
+			location->locationFlags =
+				XR_SPACE_LOCATION_ORIENTATION_VALID_BIT | XR_SPACE_LOCATION_POSITION_VALID_BIT | XR_SPACE_LOCATION_ORIENTATION_TRACKED_BIT | XR_SPACE_LOCATION_POSITION_TRACKED_BIT;
+		}
+
+		// Scripted poses are static between updates, so velocities are zero
+		for ( auto pNext = reinterpret_cast< XrBaseOutStructure * >( location->next ); pNext; pNext = pNext->next )
+		{
+			if ( pNext->type == XR_TYPE_SPACE_VELOCITY )
+			{
+				auto pVelocity = reinterpret_cast< XrSpaceVelocity * >( pNext );
+				pVelocity->velocityFlags = bTracked ? ( XR_SPACE_VELOCITY_LINEAR_VALID_BIT | XR_SPACE_VELOCITY_ANGULAR_VALID_BIT ) : 0;
+				pVelocity->linearVelocity = { 0.0f, 0.0f, 0.0f };
+				pVelocity->angularVelocity = { 0.0f, 0.0f, 0.0f };
+			}
+		}
+
+		return XR_SUCCESS;
+	}
+
+	XRAPI_ATTR XrResult XRAPI_CALL
+		MockLocateViews( XrSession session, const XrViewLocateInfo *viewLocateInfo, XrViewState *viewState, uint32_t viewCapacityInput, uint32_t *viewCountOutput, XrView *views )
+	{
+		Runtime &runtime = GetRuntime();
+		std::lock_guard< std::mutex > lock( runtime.mutex );
+
+		auto pSession = Lookup< MockSession >( runtime, session, EObjectType::Session );
+		auto pBaseSpace = Lookup< MockSpace >( runtime, viewLocateInfo->space, EObjectType::Space );
+		if ( !pSession || !pBaseSpace )
+			return Fail( runtime, XR_ERROR_HANDLE_INVALID );
+
+		if ( viewLocateInfo->viewConfigurationType != XR_VIEW_CONFIGURATION_TYPE_PRIMARY_STEREO )
+			return Fail( runtime, XR_ERROR_VIEW_CONFIGURATION_TYPE_UNSUPPORTED );
+
+		if ( viewLocateInfo->displayTime <= 0 )
+			return Fail( runtime, XR_ERROR_TIME_INVALID );
+
+		*viewCountOutput = k_unViewCount;
+		if ( viewCapacityInput == 0 )
+			return XR_SUCCESS;
+
+		if ( viewCapacityInput < k_unViewCount )
+			return Fail( runtime, XR_ERROR_SIZE_INSUFFICIENT );
+
+		runtime.stats.unLocateViewsCalls++;
+
+		XrPosef xrBasePose;
+		SpacePose( runtime, pBaseSpace, &xrBasePose );
+		const XrPosef xrHeadInBase = Multiply( Inverse( xrBasePose ), runtime.xrHeadPose );
+
+		for ( uint32_t v = 0; v < k_unViewCount; v++ )
+		{
+			const float fEyeOffset = ( v == 0 ? -0.5f : 0.5f ) * runtime.config.fIpd;
+			views[ v ].pose = Multiply( xrHeadInBase, { { 0.0f, 0.0f, 0.0f, 1.0f }, { fEyeOffset, 0.0f, 0.0f } } );
+			views[ v ].fov = { -0.785398f, 0.785398f, 0.785398f, -0.785398f };
+		}
+
+		viewState->viewStateFlags =
+			XR_VIEW_STATE_ORIENTATION_VALID_BIT | XR_VIEW_STATE_POSITION_VALID_BIT | XR_VIEW_STATE_ORIENTATION_TRACKED_BIT | XR_VIEW_STATE_POSITION_TRACKED_BIT;
+		return XR_SUCCESS;
+	}
+
+	// --------------------------------------------------------------------------------------------
+	// Swapchains
+	// --------------------------------------------------------------------------------------------
+
+	XRAPI_ATTR XrResult XRAPI_CALL MockEnumerateSwapchainFormats( XrSession session, uint32_t formatCapacityInput, uint32_t *formatCountOutput, int64_t *formats )
+	{
+		Runtime &runtime = GetRuntime();
+		std::lock_guard< std::mutex > lock( runtime.mutex );
+
+		auto pSession = Lookup< MockSession >( runtime, session, EObjectType::Session );
+		if ( !pSession )
+			return Fail( runtime, XR_ERROR_HANDLE_INVALID );
+
+		return FillArray( SupportedSwapchainFormats( pSession ), formatCapacityInput, formatCountOutput, formats );
+	}
+
+	XRAPI_ATTR XrResult XRAPI_CALL MockCreateSwapchain( XrSession session, const XrSwapchainCreateInfo *createInfo, XrSwapchain *swapchain )
+	{
+		Runtime &runtime = GetRuntime();
+		std::lock_guard< std::mutex > lock( runtime.mutex );
+
+		auto pSession = Lookup< MockSession >( runtime, session, EObjectType::Session );
+		if ( !pSession )
+			return Fail( runtime, XR_ERROR_HANDLE_INVALID );
+
+		if ( pSession->vkDevice == VK_NULL_HANDLE )
+			return Fail( runtime, XR_ERROR_FEATURE_UNSUPPORTED );
+
+		const auto vecFormats = SupportedSwapchainFormats( pSession );
+		if ( std::find( vecFormats.begin(), vecFormats.end(), createInfo->format ) == vecFormats.end() )
+			return Fail( runtime, XR_ERROR_SWAPCHAIN_FORMAT_UNSUPPORTED );
+
+		if ( createInfo->faceCount != 1 || createInfo->width == 0 || createInfo->height == 0 || createInfo->arraySize == 0 )
+			return Fail( runtime, XR_ERROR_VALIDATION_FAILURE );
+
+		auto pSwapchain = Track( runtime, new MockSwapchain() );
+		pSwapchain->pSession = pSession;
+		pSwapchain->xrCreateInfo = *createInfo;
+		pSwapchain->xrCreateInfo.next = nullptr;
+
+		const XrResult xrResult = CreateSwapchainImages( pSwapchain, std::max( runtime.config.unSwapchainImageCount, 1u ) );
+		if ( !XR_SUCCEEDED( xrResult ) )
+		{
+			DestroySwapchainImages( pSwapchain );
+			Untrack( runtime, pSwapchain );
+			return Fail( runtime, xrResult );
+		}
+
+		*swapchain = reinterpret_cast< XrSwapchain >( pSwapchain );
+		return XR_SUCCESS;
+	}
+
+	XRAPI_ATTR XrResult XRAPI_CALL MockDestroySwapchain( XrSwapchain swapchain )
+	{
+		Runtime &runtime = GetRuntime();
+		std::lock_guard< std::mutex > lock( runtime.mutex );
+
+		auto pSwapchain = Lookup< MockSwapchain >( runtime, swapchain, EObjectType::Swapchain );
+		if ( !pSwapchain )
+			return Fail( runtime, XR_ERROR_HANDLE_INVALID );
+
+		DestroySwapchainImages( pSwapchain );
+		Untrack( runtime, pSwapchain );
+		return XR_SUCCESS;
+	}
+
+	XRAPI_ATTR XrResult XRAPI_CALL MockEnumerateSwapchainImages( XrSwapchain swapchain, uint32_t imageCapacityInput, uint32_t *imageCountOutput, XrSwapchainImageBaseHeader *images )
+	{
+		Runtime &runtime = GetRuntime();
+		std::lock_guard< std::mutex > lock( runtime.mutex );
+
+		auto pSwapchain = Lookup< MockSwapchain >( runtime, swapchain, EObjectType::Swapchain );
+		if ( !pSwapchain )
+			return Fail( runtime, XR_ERROR_HANDLE_INVALID );
+
+		std::vector< XrSwapchainImageVulkanKHR > vecImages;
+		for ( VkImage vkImage : pSwapchain->vecImages )
+			vecImages.push_back( { XR_TYPE_SWAPCHAIN_IMAGE_VULKAN_KHR, nullptr, vkImage } );
+
+		return FillArray( vecImages, imageCapacityInput, imageCountOutput, reinterpret_cast< XrSwapchainImageVulkanKHR * >( images ) );
+	}
+
+	XRAPI_ATTR XrResult XRAPI_CALL MockAcquireSwapchainImage( XrSwapchain swapchain, const XrSwapchainImageAcquireInfo *acquireInfo, uint32_t *index )
+	{
+		Runtime &runtime = GetRuntime();
+		std::lock_guard< std::mutex > lock( runtime.mutex );
+
+		auto pSwapchain = Lookup< MockSwapchain >( runtime, swapchain, EObjectType::Swapchain );
+		if ( !pSwapchain )
+			return Fail( runtime, XR_ERROR_HANDLE_INVALID );
+
+		if ( pSwapchain->deqAcquired.size() >= pSwapchain->vecImages.size() )
+			return Fail( runtime, XR_ERROR_CALL_ORDER_INVALID );
+
+		*index = pSwapchain->unNextImage;
+		pSwapchain->unNextImage = ( pSwapchain->unNextImage + 1 ) % ( uint32_t )pSwapchain->vecImages.size();
+		pSwapchain->deqAcquired.push_back( *index );
+		return XR_SUCCESS;
+	}
+
+	XRAPI_ATTR XrResult XRAPI_CALL MockWaitSwapchainImage( XrSwapchain swapchain, const XrSwapchainImageWaitInfo *waitInfo )
+	{
+		Runtime &runtime = GetRuntime();
+		std::lock_guard< std::mutex > lock( runtime.mutex );
+
+		auto pSwapchain = Lookup< MockSwapchain >( runtime, swapchain, EObjectType::Swapchain );
+		if ( !pSwapchain )
+			return Fail( runtime, XR_ERROR_HANDLE_INVALID );
+
+		if ( pSwapchain->deqAcquired.empty() || pSwapchain->bFrontWaited )
+			return Fail( runtime, XR_ERROR_CALL_ORDER_INVALID );
+
+		pSwapchain->bFrontWaited = true;
+		return XR_SUCCESS;
+	}
+
+	XRAPI_ATTR XrResult XRAPI_CALL MockReleaseSwapchainImage( XrSwapchain swapchain, const XrSwapchainImageReleaseInfo *releaseInfo )
+	{
+		Runtime &runtime = GetRuntime();
+		std::lock_guard< std::mutex > lock( runtime.mutex );
+
+		auto pSwapchain = Lookup< MockSwapchain >( runtime, swapchain, EObjectType::Swapchain );
+		if ( !pSwapchain )
+			return Fail( runtime, XR_ERROR_HANDLE_INVALID );
+
+		if ( pSwapchain->deqAcquired.empty() || !pSwapchain->bFrontWaited )
+			return Fail( runtime, XR_ERROR_CALL_ORDER_INVALID );
+
+		pSwapchain->nLastReleased = ( int32_t )pSwapchain->deqAcquired.front();
+		pSwapchain->deqAcquired.pop_front();
+		pSwapchain->bFrontWaited = false;
+		return XR_SUCCESS;
+	}
+
+	// --------------------------------------------------------------------------------------------
+	// Paths and actions
+	// --------------------------------------------------------------------------------------------
+
+	XRAPI_ATTR XrResult XRAPI_CALL MockStringToPath( XrInstance instance, const char *pathString, XrPath *path )
+	{
+		Runtime &runtime = GetRuntime();
+		std::lock_guard< std::mutex > lock( runtime.mutex );
+
+		if ( !Lookup< MockInstance >( runtime, instance, EObjectType::Instance ) )
+			return Fail( runtime, XR_ERROR_HANDLE_INVALID );
+
+		if ( !IsWellFormedPath( pathString ) )
+			return Fail( runtime, XR_ERROR_PATH_FORMAT_INVALID );
+
+		*path = InternPath( runtime, pathString );
+		return XR_SUCCESS;
+	}
+
+	XRAPI_ATTR XrResult XRAPI_CALL MockPathToString( XrInstance instance, XrPath path, uint32_t bufferCapacityInput, uint32_t *bufferCountOutput, char *buffer )
+	{
+		Runtime &runtime = GetRuntime();
+		std::lock_guard< std::mutex > lock( runtime.mutex );
+
+		const std::string *pPath = PathString( runtime, path );
+		if ( !pPath )
+			return Fail( runtime, XR_ERROR_PATH_INVALID );
+
+		return FillString( *pPath, bufferCapacityInput, bufferCountOutput, buffer );
+	}
+
+	XRAPI_ATTR XrResult XRAPI_CALL MockCreateActionSet( XrInstance instance, const XrActionSetCreateInfo *createInfo, XrActionSet *actionSet )
+	{
+		Runtime &runtime = GetRuntime();
+		std::lock_guard< std::mutex > lock( runtime.mutex );
+
+		auto pInstance = Lookup< MockInstance >( runtime, instance, EObjectType::Instance );
+		if ( !pInstance )
+			return Fail( runtime, XR_ERROR_HANDLE_INVALID );
+
+		if ( !IsWellFormedName( createInfo->actionSetName ) )
+			return Fail( runtime, XR_ERROR_PATH_FORMAT_INVALID );
+
+		for ( MockObject *pObject : runtime.setObjects )
+		{
+			if ( pObject->eObjectType == EObjectType::ActionSet && static_cast< MockActionSet * >( pObject )->sName == createInfo->actionSetName )
+				return Fail( runtime, XR_ERROR_NAME_DUPLICATED );
+		}
+
+		auto pActionSet = Track( runtime, new MockActionSet() );
+		pActionSet->pInstance = pInstance;
+		pActionSet->sName = createInfo->actionSetName;
+
+		*actionSet = reinterpret_cast< XrActionSet >( pActionSet );
+		return XR_SUCCESS;
+	}
+
+	XRAPI_ATTR XrResult XRAPI_CALL MockDestroyActionSet( XrActionSet actionSet )
+	{
+		Runtime &runtime = GetRuntime();
+		std::lock_guard< std::mutex > lock( runtime.mutex );
+
+		auto pActionSet = Lookup< MockActionSet >( runtime, actionSet, EObjectType::ActionSet );
+		if ( !pActionSet )
+			return Fail( runtime, XR_ERROR_HANDLE_INVALID );
+
+		for ( MockAction *pAction : pActionSet->vecActions )
+			Untrack( runtime, pAction );
+
+		Untrack( runtime, pActionSet );
+		return XR_SUCCESS;
+	}
+
+	XRAPI_ATTR XrResult XRAPI_CALL MockCreateAction( XrActionSet actionSet, const XrActionCreateInfo *createInfo, XrAction *action )
+	{
+		Runtime &runtime = GetRuntime();
+		std::lock_guard< std::mutex > lock( runtime.mutex );
+
+		auto pActionSet = Lookup< MockActionSet >( runtime, actionSet, EObjectType::ActionSet );
+		if ( !pActionSet )
+			return Fail( runtime, XR_ERROR_HANDLE_INVALID );
+
+		if ( pActionSet->bAttached )
+			return Fail( runtime, XR_ERROR_ACTIONSETS_ALREADY_ATTACHED );
+
+		if ( !IsWellFormedName( createInfo->actionName ) )
+			return Fail( runtime, XR_ERROR_PATH_FORMAT_INVALID );
+
+		for ( MockAction *pExisting : pActionSet->vecActions )
+		{
+			if ( pExisting->sName == createInfo->actionName )
+				return Fail( runtime, XR_ERROR_NAME_DUPLICATED );
+		}
+
+		std::vector< XrPath > vecSubactionPaths;
+		for ( uint32_t i = 0; i < createInfo->countSubactionPaths; i++ )
+		{
+			const std::string *pPath = PathString( runtime, createInfo->subactionPaths[ i ] );
+			if ( !pPath )
+				return Fail( runtime, XR_ERROR_PATH_INVALID );
+
+			if ( !StartsWith( *pPath, "/user/" ) || std::find( vecSubactionPaths.begin(), vecSubactionPaths.end(), createInfo->subactionPaths[ i ] ) != vecSubactionPaths.end() )
+				return Fail( runtime, XR_ERROR_PATH_UNSUPPORTED );
+
+			vecSubactionPaths.push_back( createInfo->subactionPaths[ i ] );
+		}
+
+		auto pAction = Track( runtime, new MockAction() );
+		pAction->pActionSet = pActionSet;
+		pAction->sName = createInfo->actionName;
+		pAction->xrActionType = createInfo->actionType;
+		pAction->vecSubactionPaths = std::move( vecSubactionPaths );
+		pActionSet->vecActions.push_back( pAction );
+
+		*action = reinterpret_cast< XrAction >( pAction );
+		return XR_SUCCESS;
+	}
+
+	XRAPI_ATTR XrResult XRAPI_CALL MockDestroyAction( XrAction action )
+	{
+		Runtime &runtime = GetRuntime();
+		std::lock_guard< std::mutex > lock( runtime.mutex );
+
+		auto pAction = Lookup< MockAction >( runtime, action, EObjectType::Action );
+		if ( !pAction )
+			return Fail( runtime, XR_ERROR_HANDLE_INVALID );
+
+		auto &vecActions = pAction->pActionSet->vecActions;
+		vecActions.erase( std::remove( vecActions.begin(), vecActions.end(), pAction ), vecActions.end() );
+		Untrack( runtime, pAction );
+		return XR_SUCCESS;
+	}
+
+	XRAPI_ATTR XrResult XRAPI_CALL MockSuggestInteractionProfileBindings( XrInstance instance, const XrInteractionProfileSuggestedBinding *suggestedBindings )
+	{
+		Runtime &runtime = GetRuntime();
+		std::lock_guard< std::mutex > lock( runtime.mutex );
+
+		auto pInstance = Lookup< MockInstance >( runtime, instance, EObjectType::Instance );
+		if ( !pInstance )
+			return Fail( runtime, XR_ERROR_HANDLE_INVALID );
+
+		if ( pInstance->bActionSetsAttached )
+			return Fail( runtime, XR_ERROR_ACTIONSETS_ALREADY_ATTACHED );
+
+		const std::string *pProfile = PathString( runtime, suggestedBindings->interactionProfile );
+		if ( !pProfile )
+			return Fail( runtime, XR_ERROR_PATH_INVALID );
+
+		if ( !StartsWith( *pProfile, "/interaction_profiles/" ) )
+			return Fail( runtime, XR_ERROR_PATH_UNSUPPORTED );
+
+		if ( suggestedBindings->countSuggestedBindings == 0 || !suggestedBindings->suggestedBindings )
+			return Fail( runtime, XR_ERROR_VALIDATION_FAILURE );
+
+		std::vector< XrActionSuggestedBinding > vecBindings;
+		for ( uint32_t i = 0; i < suggestedBindings->countSuggestedBindings; i++ )
+		{
+			const XrActionSuggestedBinding &binding = suggestedBindings->suggestedBindings[ i ];
+			if ( !Lookup< MockAction >( runtime, binding.action, EObjectType::Action ) )
+				return Fail( runtime, XR_ERROR_HANDLE_INVALID );
+
+			const std::string *pBinding = PathString( runtime, binding.binding );
+			if ( !pBinding )
+				return Fail( runtime, XR_ERROR_PATH_INVALID );
+
+			// Bindings must name an input or output component of a top level user path
+			if ( !StartsWith( *pBinding, "/user/" ) || ( pBinding->find( "/input/" ) == std::string::npos && pBinding->find( "/output/" ) == std::string::npos ) )
+				return Fail( runtime, XR_ERROR_PATH_UNSUPPORTED );
+
+			vecBindings.push_back( binding );
+		}
+
+		// Later suggestions for the same profile replace earlier ones
+		if ( pInstance->mapSuggestedBindings.count( suggestedBindings->interactionProfile ) == 0 )
+			pInstance->vecSuggestedProfileOrder.push_back( suggestedBindings->interactionProfile );
+
+		pInstance->mapSuggestedBindings[ suggestedBindings->interactionProfile ] = std::move( vecBindings );
+		return XR_SUCCESS;
+	}
+
+	// Picks the scripted preferred profile if the app suggested bindings for it, otherwise the first suggested profile
+	void SelectInteractionProfile( Runtime &runtime, MockSession *pSession )
+	{
+		MockInstance *pInstance = pSession->pInstance;
+		pSession->xrCurrentProfile = pInstance->vecSuggestedProfileOrder.empty() ? XR_NULL_PATH : pInstance->vecSuggestedProfileOrder.front();
+
+		auto it = runtime.mapPaths.find( runtime.sPreferredProfile );
+		if ( it != runtime.mapPaths.end() && pInstance->mapSuggestedBindings.count( it->second ) > 0 )
+			pSession->xrCurrentProfile = it->second;
+	}
+
+	XRAPI_ATTR XrResult XRAPI_CALL MockAttachSessionActionSets( XrSession session, const XrSessionActionSetsAttachInfo *attachInfo )
+	{
+		Runtime &runtime = GetRuntime();
+		std::lock_guard< std::mutex > lock( runtime.mutex );
+
+		auto pSession = Lookup< MockSession >( runtime, session, EObjectType::Session );
+		if ( !pSession )
+			return Fail( runtime, XR_ERROR_HANDLE_INVALID );
+
+		if ( pSession->pInstance->bActionSetsAttached )
+			return Fail( runtime, XR_ERROR_ACTIONSETS_ALREADY_ATTACHED );
+
+		for ( uint32_t i = 0; i < attachInfo->countActionSets; i++ )
+		{
+			if ( !Lookup< MockActionSet >( runtime, attachInfo->actionSets[ i ], EObjectType::ActionSet ) )
+				return Fail( runtime, XR_ERROR_HANDLE_INVALID );
+		}
+
+		for ( uint32_t i = 0; i < attachInfo->countActionSets; i++ )
+			Lookup< MockActionSet >( runtime, attachInfo->actionSets[ i ], EObjectType::ActionSet )->bAttached = true;
+
+		pSession->pInstance->bActionSetsAttached = true;
+		SelectInteractionProfile( runtime, pSession );
+		QueueProfileChanged( runtime, pSession );
+		return XR_SUCCESS;
+	}
+
+	XRAPI_ATTR XrResult XRAPI_CALL MockGetCurrentInteractionProfile( XrSession session, XrPath topLevelUserPath, XrInteractionProfileState *interactionProfile )
+	{
+		Runtime &runtime = GetRuntime();
+		std::lock_guard< std::mutex > lock( runtime.mutex );
+
+		auto pSession = Lookup< MockSession >( runtime, session, EObjectType::Session );
+		if ( !pSession )
+			return Fail( runtime, XR_ERROR_HANDLE_INVALID );
+
+		if ( !pSession->pInstance->bActionSetsAttached )
+			return Fail( runtime, XR_ERROR_ACTIONSET_NOT_ATTACHED );
+
+		const std::string *pUserPath = PathString( runtime, topLevelUserPath );
+		if ( !pUserPath )
+			return Fail( runtime, XR_ERROR_PATH_INVALID );
+
+		// A profile is only current for user paths it has bindings for
+		interactionProfile->interactionProfile = XR_NULL_PATH;
+		if ( auto pBindings = CurrentBindings( pSession ) )
+		{
+			for ( auto &binding : *pBindings )
+			{
+				const std::string *pBinding = PathString( runtime, binding.binding );
+				if ( pBinding && IsBindingForUserPath( *pBinding, *pUserPath ) )
+				{
+					interactionProfile->interactionProfile = pSession->xrCurrentProfile;
+					break;
+				}
+			}
+		}
+
+		return XR_SUCCESS;
+	}
+
+	XRAPI_ATTR XrResult XRAPI_CALL MockSyncActions( XrSession session, const XrActionsSyncInfo *syncInfo )
+	{
+		Runtime &runtime = GetRuntime();
+		std::lock_guard< std::mutex > lock( runtime.mutex );
+
+		auto pSession = Lookup< MockSession >( runtime, session, EObjectType::Session );
+		if ( !pSession )
+			return Fail( runtime, XR_ERROR_HANDLE_INVALID );
+
+		runtime.stats.unSyncActionsCalls++;
+
+		for ( uint32_t i = 0; i < syncInfo->countActiveActionSets; i++ )
+		{
+			auto pActionSet = Lookup< MockActionSet >( runtime, syncInfo->activeActionSets[ i ].actionSet, EObjectType::ActionSet );
+			if ( !pActionSet )
+				return Fail( runtime, XR_ERROR_HANDLE_INVALID );
+
+			if ( !pActionSet->bAttached )
+				return Fail( runtime, XR_ERROR_ACTIONSET_NOT_ATTACHED );
+		}
+
+		// Input is only active while the session has focus
+		const bool bFocused = pSession->xrState == XR_SESSION_STATE_FOCUSED;
+		const XrTime xrNow = NowNs();
+		for ( uint32_t i = 0; i < syncInfo->countActiveActionSets; i++ )
+		{
+			auto pActionSet = Lookup< MockActionSet >( runtime, syncInfo->activeActionSets[ i ].actionSet, EObjectType::ActionSet );
+			for ( MockAction *pAction : pActionSet->vecActions )
+				SyncAction( runtime, pSession, pAction, bFocused, xrNow );
+		}
+
+		return bFocused ? XR_SUCCESS : XR_SESSION_NOT_FOCUSED;
+	}
+
+	XRAPI_ATTR XrResult XRAPI_CALL MockGetActionStateBoolean( XrSession session, const XrActionStateGetInfo *getInfo, XrActionStateBoolean *state )
+	{
+		Runtime &runtime = GetRuntime();
+		std::lock_guard< std::mutex > lock( runtime.mutex );
+
+		XrResult xrResult;
+		const ActionState *pState = GetActionState( runtime, session, getInfo, XR_ACTION_TYPE_BOOLEAN_INPUT, &xrResult );
+		if ( !pState )
+			return xrResult;
+
+		state->currentState = pState->bValue ? XR_TRUE : XR_FALSE;
+		state->changedSinceLastSync = pState->bChanged ? XR_TRUE : XR_FALSE;
+		state->lastChangeTime = pState->xrLastChangeTime;
+		state->isActive = pState->bIsActive ? XR_TRUE : XR_FALSE;
+		return XR_SUCCESS;
+	}
+
+	XRAPI_ATTR XrResult XRAPI_CALL MockGetActionStateFloat( XrSession session, const XrActionStateGetInfo *getInfo, XrActionStateFloat *state )
+	{
+		Runtime &runtime = GetRuntime();
+		std::lock_guard< std::mutex > lock( runtime.mutex );
+
+		XrResult xrResult;
+		const ActionState *pState = GetActionState( runtime, session, getInfo, XR_ACTION_TYPE_FLOAT_INPUT, &xrResult );
+		if ( !pState )
+			return xrResult;
+
+		state->currentState = pState->fValue;
+		state->changedSinceLastSync = pState->bChanged ? XR_TRUE : XR_FALSE;
+		state->lastChangeTime = pState->xrLastChangeTime;
+		state->isActive = pState->bIsActive ? XR_TRUE : XR_FALSE;
+		return XR_SUCCESS;
+	}
+
+	XRAPI_ATTR XrResult XRAPI_CALL MockGetActionStateVector2f( XrSession session, const XrActionStateGetInfo *getInfo, XrActionStateVector2f *state )
+	{
+		Runtime &runtime = GetRuntime();
+		std::lock_guard< std::mutex > lock( runtime.mutex );
+
+		XrResult xrResult;
+		const ActionState *pState = GetActionState( runtime, session, getInfo, XR_ACTION_TYPE_VECTOR2F_INPUT, &xrResult );
+		if ( !pState )
+			return xrResult;
+
+		state->currentState = pState->xrValue;
+		state->changedSinceLastSync = pState->bChanged ? XR_TRUE : XR_FALSE;
+		state->lastChangeTime = pState->xrLastChangeTime;
+		state->isActive = pState->bIsActive ? XR_TRUE : XR_FALSE;
+		return XR_SUCCESS;
+	}
+
+	XRAPI_ATTR XrResult XRAPI_CALL MockGetActionStatePose( XrSession session, const XrActionStateGetInfo *getInfo, XrActionStatePose *state )
+	{
+		Runtime &runtime = GetRuntime();
+		std::lock_guard< std::mutex > lock( runtime.mutex );
+
+		XrResult xrResult;
+		const ActionState *pState = GetActionState( runtime, session, getInfo, XR_ACTION_TYPE_POSE_INPUT, &xrResult );
+		if ( !pState )
+			return xrResult;
+
+		state->isActive = pState->bIsActive ? XR_TRUE : XR_FALSE;
+		return XR_SUCCESS;
+	}
+
+	XRAPI_ATTR XrResult XRAPI_CALL MockEnumerateBoundSourcesForAction(
+		XrSession session, const XrBoundSourcesForActionEnumerateInfo *enumerateInfo, uint32_t sourceCapacityInput, uint32_t *sourceCountOutput, XrPath *sources )
+	{
+		Runtime &runtime = GetRuntime();
+		std::lock_guard< std::mutex > lock( runtime.mutex );
+
+		auto pSession = Lookup< MockSession >( runtime, session, EObjectType::Session );
+		auto pAction = Lookup< MockAction >( runtime, enumerateInfo->action, EObjectType::Action );
+		if ( !pSession || !pAction )
+			return Fail( runtime, XR_ERROR_HANDLE_INVALID );
+
+		if ( !pAction->pActionSet->bAttached )
+			return Fail( runtime, XR_ERROR_ACTIONSET_NOT_ATTACHED );
+
+		std::vector< XrPath > vecSources;
+		for ( auto pSource : BoundSources( runtime, pSession, pAction, XR_NULL_PATH ) )
+			vecSources.push_back( runtime.mapPaths[ *pSource ] );
+
+		return FillArray( vecSources, sourceCapacityInput, sourceCountOutput, sources );
+	}
+
+	XRAPI_ATTR XrResult XRAPI_CALL
+		MockGetInputSourceLocalizedName( XrSession session, const XrInputSourceLocalizedNameGetInfo *getInfo, uint32_t bufferCapacityInput, uint32_t *bufferCountOutput, char *buffer )
+	{
+		Runtime &runtime = GetRuntime();
+		std::lock_guard< std::mutex > lock( runtime.mutex );
+
+		const std::string *pPath = PathString( runtime, getInfo->sourcePath );
+		if ( !pPath )
+			return Fail( runtime, XR_ERROR_PATH_INVALID );
+
+		return FillString( *pPath, bufferCapacityInput, bufferCountOutput, buffer );
+	}
+
+	XRAPI_ATTR XrResult XRAPI_CALL MockApplyHapticFeedback( XrSession session, const XrHapticActionInfo *hapticActionInfo, const XrHapticBaseHeader *hapticFeedback )
+	{
+		Runtime &runtime = GetRuntime();
+		std::lock_guard< std::mutex > lock( runtime.mutex );
+
+		auto pAction = Lookup< MockAction >( runtime, hapticActionInfo->action, EObjectType::Action );
+		if ( !Lookup< MockSession >( runtime, session, EObjectType::Session ) || !pAction )
+			return Fail( runtime, XR_ERROR_HANDLE_INVALID );
+
+		if ( pAction->xrActionType != XR_ACTION_TYPE_VIBRATION_OUTPUT )
+			return Fail( runtime, XR_ERROR_ACTION_TYPE_MISMATCH );
+
+		if ( !pAction->pActionSet->bAttached )
+			return Fail( runtime, XR_ERROR_ACTIONSET_NOT_ATTACHED );
+
+		runtime.stats.unHapticCalls++;
+		return XR_SUCCESS;
+	}
+
+	XRAPI_ATTR XrResult XRAPI_CALL MockStopHapticFeedback( XrSession session, const XrHapticActionInfo *hapticActionInfo )
+	{
+		Runtime &runtime = GetRuntime();
+		std::lock_guard< std::mutex > lock( runtime.mutex );
+
+		auto pAction = Lookup< MockAction >( runtime, hapticActionInfo->action, EObjectType::Action );
+		if ( !Lookup< MockSession >( runtime, session, EObjectType::Session ) || !pAction )
+			return Fail( runtime, XR_ERROR_HANDLE_INVALID );
+
+		if ( pAction->xrActionType != XR_ACTION_TYPE_VIBRATION_OUTPUT )
+			return Fail( runtime, XR_ERROR_ACTION_TYPE_MISMATCH );
+
+		return XR_SUCCESS;
+	}
+
+	// --------------------------------------------------------------------------------------------
+	// Hand tracking (XR_EXT_hand_tracking)
+	// --------------------------------------------------------------------------------------------
+
+	XRAPI_ATTR XrResult XRAPI_CALL MockCreateHandTrackerEXT( XrSession session, const XrHandTrackerCreateInfoEXT *createInfo, XrHandTrackerEXT *handTracker )
+	{
+		Runtime &runtime = GetRuntime();
+		std::lock_guard< std::mutex > lock( runtime.mutex );
+
+		auto pSession = Lookup< MockSession >( runtime, session, EObjectType::Session );
+		if ( !pSession )
+			return Fail( runtime, XR_ERROR_HANDLE_INVALID );
+
+		if ( ( createInfo->hand != XR_HAND_LEFT_EXT && createInfo->hand != XR_HAND_RIGHT_EXT ) || createInfo->handJointSet != XR_HAND_JOINT_SET_DEFAULT_EXT )
+			return Fail( runtime, XR_ERROR_VALIDATION_FAILURE );
+
+		auto pHandTracker = Track( runtime, new MockHandTracker() );
+		pHandTracker->pSession = pSession;
+		pHandTracker->xrHand = createInfo->hand;
+
+		*handTracker = reinterpret_cast< XrHandTrackerEXT >( pHandTracker );
+		return XR_SUCCESS;
+	}
+
+	XRAPI_ATTR XrResult XRAPI_CALL MockDestroyHandTrackerEXT( XrHandTrackerEXT handTracker )
+	{
+		Runtime &runtime = GetRuntime();
+		std::lock_guard< std::mutex > lock( runtime.mutex );
+
+		auto pHandTracker = Lookup< MockHandTracker >( runtime, handTracker, EObjectType::HandTracker );
+		if ( !pHandTracker )
+			return Fail( runtime, XR_ERROR_HANDLE_INVALID );
+
+		Untrack( runtime, pHandTracker );
+		return XR_SUCCESS;
+	}
+
+	XRAPI_ATTR XrResult XRAPI_CALL MockLocateHandJointsEXT( XrHandTrackerEXT handTracker, const XrHandJointsLocateInfoEXT *locateInfo, XrHandJointLocationsEXT *locations )
+	{
+		Runtime &runtime = GetRuntime();
+		std::lock_guard< std::mutex > lock( runtime.mutex );
+
+		auto pHandTracker = Lookup< MockHandTracker >( runtime, handTracker, EObjectType::HandTracker );
+		auto pBaseSpace = Lookup< MockSpace >( runtime, locateInfo->baseSpace, EObjectType::Space );
+		if ( !pHandTracker || !pBaseSpace )
+			return Fail( runtime, XR_ERROR_HANDLE_INVALID );
+
+		if ( locations->jointCount != XR_HAND_JOINT_COUNT_EXT || !locations->jointLocations )
+			return Fail( runtime, XR_ERROR_VALIDATION_FAILURE );
+
+		XrHandJointVelocitiesEXT *pVelocities = nullptr;
+		for ( auto pNext = reinterpret_cast< XrBaseOutStructure * >( locations->next ); pNext; pNext = pNext->next )
+		{
+			if ( pNext->type == XR_TYPE_HAND_JOINT_VELOCITIES_EXT )
+				pVelocities = reinterpret_cast< XrHandJointVelocitiesEXT * >( pNext );
+		}
+
+		const uint32_t unHand = pHandTracker->xrHand == XR_HAND_LEFT_EXT ? 0 : 1;
+		const HandJoints &hand = runtime.arrHands[ unHand ];
+
+		XrPosef xrBasePose;
+		const bool bActive = hand.bActive && SpacePose( runtime, pBaseSpace, &xrBasePose );
+		locations->isActive = bActive ? XR_TRUE : XR_FALSE;
+
+		const XrPosef xrGripPose = SourcePose( runtime, unHand == 0 ? "/user/hand/left/input/grip/pose" : "/user/hand/right/input/grip/pose" );
+		const XrPosef xrBaseInverse = bActive ? Inverse( xrBasePose ) : IdentityPose();
+
+		for ( uint32_t j = 0; j < XR_HAND_JOINT_COUNT_EXT; j++ )
+		{
+			XrHandJointLocationEXT &joint = locations->jointLocations[ j ];
+			joint.radius = 0.01f;
+			joint.locationFlags = 0;
+			joint.pose = IdentityPose();
+
+			if ( bActive )
+			{
+				const XrPosef xrJointPose = hand.bScripted ? hand.arrPoses[ j ] : DefaultJointPose( xrGripPose, pHandTracker->xrHand, j );
+				joint.pose = Multiply( xrBaseInverse, xrJointPose );
+				joint.locationFlags =
+					XR_SPACE_LOCATION_ORIENTATION_VALID_BIT | XR_SPACE_LOCATION_POSITION_VALID_BIT | XR_SPACE_LOCATION_ORIENTATION_TRACKED_BIT | XR_SPACE_LOCATION_POSITION_TRACKED_BIT;
+			}
+
+			if ( pVelocities && j < pVelocities->jointCount )
+			{
+				pVelocities->jointVelocities[ j ].velocityFlags = bActive ? ( XR_SPACE_VELOCITY_LINEAR_VALID_BIT | XR_SPACE_VELOCITY_ANGULAR_VALID_BIT ) : 0;
+				pVelocities->jointVelocities[ j ].linearVelocity = { 0.0f, 0.0f, 0.0f };
+				pVelocities->jointVelocities[ j ].angularVelocity = { 0.0f, 0.0f, 0.0f };
+			}
+		}
+
+		return XR_SUCCESS;
+	}
+
+	// --------------------------------------------------------------------------------------------
+	// Dispatch
+	// --------------------------------------------------------------------------------------------
+
+	struct DispatchEntry
+	{
+		const char *pccName;
+		PFN_xrVoidFunction pfnFunction;
+
+		// Extension that must be enabled on the instance, nullptr for core functions
+		const char *pccExtension;
+		const char *pccAltExtension;
+	};
+
+#define MOCK_CORE( name, fn ) { #name, reinterpret_cast< PFN_xrVoidFunction >( fn ), nullptr, nullptr }
+#define MOCK_EXT( name, fn, ext ) { #name, reinterpret_cast< PFN_xrVoidFunction >( fn ), ext, nullptr }
+#define MOCK_EXT2( name, fn, ext, alt ) { #name, reinterpret_cast< PFN_xrVoidFunction >( fn ), ext, alt }
+
+	XRAPI_ATTR XrResult XRAPI_CALL MockGetInstanceProcAddr( XrInstance instance, const char *name, PFN_xrVoidFunction *function );
+
+	// The vulkan enable (1) functions are also available with vulkan enable 2 - the provider queries graphics requirements through them in both cases
+	static const DispatchEntry k_arrDispatch[] = {
+		MOCK_CORE( xrGetInstanceProcAddr, MockGetInstanceProcAddr ),
+		MOCK_CORE( xrEnumerateApiLayerProperties, MockEnumerateApiLayerProperties ),
+		MOCK_CORE( xrEnumerateInstanceExtensionProperties, MockEnumerateInstanceExtensionProperties ),
+		MOCK_CORE( xrCreateInstance, MockCreateInstance ),
+		MOCK_CORE( xrDestroyInstance, MockDestroyInstance ),
+		MOCK_CORE( xrGetInstanceProperties, MockGetInstanceProperties ),
+		MOCK_CORE( xrPollEvent, MockPollEvent ),
+		MOCK_CORE( xrResultToString, MockResultToString ),
+		MOCK_CORE( xrStructureTypeToString, MockStructureTypeToString ),
+		MOCK_CORE( xrGetSystem, MockGetSystem ),
+		MOCK_CORE( xrGetSystemProperties, MockGetSystemProperties ),
+		MOCK_CORE( xrEnumerateEnvironmentBlendModes, MockEnumerateEnvironmentBlendModes ),
+		MOCK_CORE( xrCreateSession, MockCreateSession ),
+		MOCK_CORE( xrDestroySession, MockDestroySession ),
+		MOCK_CORE( xrEnumerateReferenceSpaces, MockEnumerateReferenceSpaces ),
+		MOCK_CORE( xrCreateReferenceSpace, MockCreateReferenceSpace ),
+		MOCK_CORE( xrGetReferenceSpaceBoundsRect, MockGetReferenceSpaceBoundsRect ),
+		MOCK_CORE( xrCreateActionSpace, MockCreateActionSpace ),
+		MOCK_CORE( xrLocateSpace, MockLocateSpace ),
+		MOCK_CORE( xrDestroySpace, MockDestroySpace ),
+		MOCK_CORE( xrEnumerateViewConfigurations, MockEnumerateViewConfigurations ),
+		MOCK_CORE( xrGetViewConfigurationProperties, MockGetViewConfigurationProperties ),
+		MOCK_CORE( xrEnumerateViewConfigurationViews, MockEnumerateViewConfigurationViews ),
+		MOCK_CORE( xrEnumerateSwapchainFormats, MockEnumerateSwapchainFormats ),
+		MOCK_CORE( xrCreateSwapchain, MockCreateSwapchain ),
+		MOCK_CORE( xrDestroySwapchain, MockDestroySwapchain ),
+		MOCK_CORE( xrEnumerateSwapchainImages, MockEnumerateSwapchainImages ),
+		MOCK_CORE( xrAcquireSwapchainImage, MockAcquireSwapchainImage ),
+		MOCK_CORE( xrWaitSwapchainImage, MockWaitSwapchainImage ),
+		MOCK_CORE( xrReleaseSwapchainImage, MockReleaseSwapchainImage ),
+		MOCK_CORE( xrBeginSession, MockBeginSession ),
+		MOCK_CORE( xrEndSession, MockEndSession ),
+		MOCK_CORE( xrRequestExitSession, MockRequestExitSession ),
+		MOCK_CORE( xrWaitFrame, MockWaitFrame ),
+		MOCK_CORE( xrBeginFrame, MockBeginFrame ),
+		MOCK_CORE( xrEndFrame, MockEndFrame ),
+		MOCK_CORE( xrLocateViews, MockLocateViews ),
+		MOCK_CORE( xrStringToPath, MockStringToPath ),
+		MOCK_CORE( xrPathToString, MockPathToString ),
+		MOCK_CORE( xrCreateActionSet, MockCreateActionSet ),
+		MOCK_CORE( xrDestroyActionSet, MockDestroyActionSet ),
+		MOCK_CORE( xrCreateAction, MockCreateAction ),
+		MOCK_CORE( xrDestroyAction, MockDestroyAction ),
+		MOCK_CORE( xrSuggestInteractionProfileBindings, MockSuggestInteractionProfileBindings ),
+		MOCK_CORE( xrAttachSessionActionSets, MockAttachSessionActionSets ),
+		MOCK_CORE( xrGetCurrentInteractionProfile, MockGetCurrentInteractionProfile ),
+		MOCK_CORE( xrGetActionStateBoolean, MockGetActionStateBoolean ),
+		MOCK_CORE( xrGetActionStateFloat, MockGetActionStateFloat ),
+		MOCK_CORE( xrGetActionStateVector2f, MockGetActionStateVector2f ),
+		MOCK_CORE( xrGetActionStatePose, MockGetActionStatePose ),
+		MOCK_CORE( xrSyncActions, MockSyncActions ),
+		MOCK_CORE( xrEnumerateBoundSourcesForAction, MockEnumerateBoundSourcesForAction ),
+		MOCK_CORE( xrGetInputSourceLocalizedName, MockGetInputSourceLocalizedName ),
+		MOCK_CORE( xrApplyHapticFeedback, MockApplyHapticFeedback ),
+		MOCK_CORE( xrStopHapticFeedback, MockStopHapticFeedback ),
+		MOCK_EXT2( xrGetVulkanGraphicsRequirementsKHR, MockGetVulkanGraphicsRequirementsKHR, XR_KHR_VULKAN_ENABLE_EXTENSION_NAME, XR_KHR_VULKAN_ENABLE2_EXTENSION_NAME ),
+		MOCK_EXT2( xrGetVulkanInstanceExtensionsKHR, MockGetVulkanExtensionsKHR, XR_KHR_VULKAN_ENABLE_EXTENSION_NAME, XR_KHR_VULKAN_ENABLE2_EXTENSION_NAME ),
+		MOCK_EXT2( xrGetVulkanDeviceExtensionsKHR, MockGetVulkanExtensionsKHR, XR_KHR_VULKAN_ENABLE_EXTENSION_NAME, XR_KHR_VULKAN_ENABLE2_EXTENSION_NAME ),
+		MOCK_EXT2( xrGetVulkanGraphicsDeviceKHR, MockGetVulkanGraphicsDeviceKHR, XR_KHR_VULKAN_ENABLE_EXTENSION_NAME, XR_KHR_VULKAN_ENABLE2_EXTENSION_NAME ),
+		MOCK_EXT( xrGetVulkanGraphicsRequirements2KHR, MockGetVulkanGraphicsRequirementsKHR, XR_KHR_VULKAN_ENABLE2_EXTENSION_NAME ),
+		MOCK_EXT( xrGetVulkanGraphicsDevice2KHR, MockGetVulkanGraphicsDevice2KHR, XR_KHR_VULKAN_ENABLE2_EXTENSION_NAME ),
+		MOCK_EXT( xrCreateVulkanInstanceKHR, MockCreateVulkanInstanceKHR, XR_KHR_VULKAN_ENABLE2_EXTENSION_NAME ),
+		MOCK_EXT( xrCreateVulkanDeviceKHR, MockCreateVulkanDeviceKHR, XR_KHR_VULKAN_ENABLE2_EXTENSION_NAME ),
+		MOCK_EXT( xrCreateHandTrackerEXT, MockCreateHandTrackerEXT, XR_EXT_HAND_TRACKING_EXTENSION_NAME ),
+		MOCK_EXT( xrDestroyHandTrackerEXT, MockDestroyHandTrackerEXT, XR_EXT_HAND_TRACKING_EXTENSION_NAME ),
+		MOCK_EXT( xrLocateHandJointsEXT, MockLocateHandJointsEXT, XR_EXT_HAND_TRACKING_EXTENSION_NAME ),
+	};
+
+#undef MOCK_CORE
+#undef MOCK_EXT
+#undef MOCK_EXT2
+
+	XRAPI_ATTR XrResult XRAPI_CALL MockGetInstanceProcAddr( XrInstance instance, const char *name, PFN_xrVoidFunction *function )
+	{
+		if ( !name || !function )
+			return XR_ERROR_VALIDATION_FAILURE;
+
+		*function = nullptr;
+		Runtime &runtime = GetRuntime();
+		std::lock_guard< std::mutex > lock( runtime.mutex );
+
+		auto pInstance = Lookup< MockInstance >( runtime, instance, EObjectType::Instance );
+		if ( instance != XR_NULL_HANDLE && !pInstance )
+			return XR_ERROR_HANDLE_INVALID;
+
+		for ( const DispatchEntry &entry : k_arrDispatch )
+		{
+			if ( std::strcmp( entry.pccName, name ) != 0 )
+				continue;
+
+			// Extension functions are only available once their extension is enabled on the instance
+			if ( entry.pccExtension &&
+				 ( !pInstance || ( !IsExtensionEnabled( pInstance, entry.pccExtension ) && !( entry.pccAltExtension && IsExtensionEnabled( pInstance, entry.pccAltExtension ) ) ) ) )
+				return XR_ERROR_FUNCTION_UNSUPPORTED;
+
+			*function = entry.pfnFunction;
+			return XR_SUCCESS;
+		}
+
+		return XR_ERROR_FUNCTION_UNSUPPORTED;
+	}
+
+} // namespace
+
+// ------------------------------------------------------------------------------------------------
+// Scripting api
+// ------------------------------------------------------------------------------------------------
+
+namespace oxr::mock
+{
+	void SetConfig( const Config &config )
+	{
+		Runtime &runtime = GetRuntime();
+		std::lock_guard< std::mutex > lock( runtime.mutex );
+		runtime.config = config;
+	}
+
+	Config GetConfig()
+	{
+		Runtime &runtime = GetRuntime();
+		std::lock_guard< std::mutex > lock( runtime.mutex );
+		return runtime.config;
+	}
+
+	Stats GetStats()
+	{
+		Runtime &runtime = GetRuntime();
+		std::lock_guard< std::mutex > lock( runtime.mutex );
+		return runtime.stats;
+	}
+
+	void ResetStats()
+	{
+		Runtime &runtime = GetRuntime();
+		std::lock_guard< std::mutex > lock( runtime.mutex );
+		runtime.stats = {};
+	}
+
+	void SetHeadPose( const XrPosef &xrPose )
+	{
+		Runtime &runtime = GetRuntime();
+		std::lock_guard< std::mutex > lock( runtime.mutex );
+		runtime.xrHeadPose = xrPose;
+	}
+
+	void SetInputBoolean( const char *pccInputPath, bool bValue )
+	{
+		Runtime &runtime = GetRuntime();
+		std::lock_guard< std::mutex > lock( runtime.mutex );
+
+		InputSource &source = runtime.mapInputs[ pccInputPath ];
+		source.bValue = bValue;
+		source.fValue = bValue ? 1.0f : 0.0f;
+	}
+
+	void SetInputFloat( const char *pccInputPath, float fValue )
+	{
+		Runtime &runtime = GetRuntime();
+		std::lock_guard< std::mutex > lock( runtime.mutex );
+
+		// Boolean actions bound to a value component use the same click threshold as most runtimes
+		InputSource &source = runtime.mapInputs[ pccInputPath ];
+		source.fValue = fValue;
+		source.bValue = fValue > 0.5f;
+	}
+
+	void SetInputVector2f( const char *pccInputPath, const XrVector2f &xrValue )
+	{
+		Runtime &runtime = GetRuntime();
+		std::lock_guard< std::mutex > lock( runtime.mutex );
+		runtime.mapInputs[ pccInputPath ].xrValue = xrValue;
+	}
+
+	void SetInputPose( const char *pccInputPath, const XrPosef &xrPose )
+	{
+		Runtime &runtime = GetRuntime();
+		std::lock_guard< std::mutex > lock( runtime.mutex );
+
+		InputSource &source = runtime.mapInputs[ pccInputPath ];
+		source.xrPose = xrPose;
+		source.bHasPose = true;
+	}
+
+	void SetInteractionProfile( const char *pccInteractionProfile )
+	{
+		Runtime &runtime = GetRuntime();
+		std::lock_guard< std::mutex > lock( runtime.mutex );
+
+		runtime.sPreferredProfile = pccInteractionProfile ? pccInteractionProfile : "";
+
+		MockInstance *pInstance = runtime.pInstance;
+		if ( !pInstance || !pInstance->pSession || !pInstance->bActionSetsAttached )
+			return;
+
+		const XrPath xrPrevious = pInstance->pSession->xrCurrentProfile;
+		SelectInteractionProfile( runtime, pInstance->pSession );
+		if ( pInstance->pSession->xrCurrentProfile != xrPrevious )
+			QueueProfileChanged( runtime, pInstance->pSession );
+	}
+
+	void SetHandJoints( XrHandEXT xrHand, bool bActive, const XrPosef *pJointPoses )
+	{
+		Runtime &runtime = GetRuntime();
+		std::lock_guard< std::mutex > lock( runtime.mutex );
+
+		HandJoints &hand = runtime.arrHands[ xrHand == XR_HAND_LEFT_EXT ? 0 : 1 ];
+		hand.bActive = bActive;
+		if ( pJointPoses )
+		{
+			std::copy( pJointPoses, pJointPoses + XR_HAND_JOINT_COUNT_EXT, hand.arrPoses.begin() );
+			hand.bScripted = true;
+		}
+	}
+
+	void QueueEvent( const XrEventDataBuffer &xrEvent )
+	{
+		Runtime &runtime = GetRuntime();
+		std::lock_guard< std::mutex > lock( runtime.mutex );
+		runtime.deqEvents.push_back( xrEvent );
+	}
+
+	void RequestSessionStop()
+	{
+		Runtime &runtime = GetRuntime();
+		std::lock_guard< std::mutex > lock( runtime.mutex );
+
+		if ( runtime.pInstance && runtime.pInstance->pSession )
+			StopSession( runtime, runtime.pInstance->pSession );
+	}
+
+	std::vector< SubmittedView > GetLastSubmittedViews()
+	{
+		Runtime &runtime = GetRuntime();
+		std::lock_guard< std::mutex > lock( runtime.mutex );
+		return runtime.vecLastSubmittedViews;
+	}
+
+} // namespace oxr::mock
+
+// ------------------------------------------------------------------------------------------------
+// Loader entry point - the only exported openxr symbol
+// ------------------------------------------------------------------------------------------------
+
+extern "C" OXR_MOCK_EXPORT XrResult XRAPI_CALL xrNegotiateLoaderRuntimeInterface( const XrNegotiateLoaderInfo *loaderInfo, XrNegotiateRuntimeRequest *runtimeRequest )
+{
+	if ( !loaderInfo || !runtimeRequest || loaderInfo->structType != XR_LOADER_INTERFACE_STRUCT_LOADER_INFO || loaderInfo->structVersion != XR_LOADER_INFO_STRUCT_VERSION ||
+		 loaderInfo->structSize != sizeof( XrNegotiateLoaderInfo ) || runtimeRequest->structType != XR_LOADER_INTERFACE_STRUCT_RUNTIME_REQUEST ||
+		 runtimeRequest->structVersion != XR_RUNTIME_INFO_STRUCT_VERSION || runtimeRequest->structSize != sizeof( XrNegotiateRuntimeRequest ) )
+		return XR_ERROR_INITIALIZATION_FAILED;
+
+	if ( loaderInfo->minInterfaceVersion > XR_CURRENT_LOADER_RUNTIME_VERSION || loaderInfo->maxInterfaceVersion < XR_CURRENT_LOADER_RUNTIME_VERSION )
+		return XR_ERROR_INITIALIZATION_FAILED;
+
+	if ( XR_VERSION_MAJOR( loaderInfo->minApiVersion ) > XR_VERSION_MAJOR( XR_CURRENT_API_VERSION ) ||
+		 XR_VERSION_MAJOR( loaderInfo->maxApiVersion ) < XR_VERSION_MAJOR( XR_CURRENT_API_VERSION ) )
+		return XR_ERROR_INITIALIZATION_FAILED;
+
+	runtimeRequest->runtimeInterfaceVersion = XR_CURRENT_LOADER_RUNTIME_VERSION;
+	runtimeRequest->runtimeApiVersion = XR_CURRENT_API_VERSION;
+	runtimeRequest->getInstanceProcAddr = MockGetInstanceProcAddr;
+	return XR_SUCCESS;
+}
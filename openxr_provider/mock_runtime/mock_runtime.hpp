@@ -0,0 +1,197 @@
+/* Copyright 2021, 2022, 2023 Rune Berg (GitHub: https://github.com/1runeberg, Twitter: https://twitter.com/1runeberg, YouTube: https://www.youtube.com/@1RuneBerg)
+ *
+ *  SPDX-License-Identifier: MIT
+ *
+ *  Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+ *
+ *  2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *
+ *  3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote products derived from this
+ *     software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ *  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+ *  BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ *  GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+ *  DAMAGE.
+ *
+ */
+
+#pragma once
+
+// The mock runtime is Vulkan only, same as the provider
+#define XR_USE_GRAPHICS_API_VULKAN 1
+#include <vulkan/vulkan.h>
+
+#include <cstdint>
+#include <vector>
+
+#include "openxr/openxr.h"
+#include "openxr/openxr_platform.h"
+
+#if defined( _WIN32 )
+	#define OXR_MOCK_EXPORT __declspec( dllexport )
+#else
+	#define OXR_MOCK_EXPORT __attribute__( ( visibility( "default" ) ) )
+#endif
+
+// Minimal in-process OpenXR runtime for tests and benchmarks.
+//
+// The library is loaded by the OpenXR loader through its runtime json (see openxr_mock_runtime.json in the build directory,
+// point XR_RUNTIME_JSON to it). It implements instance, system, session, reference/action spaces, swapchains (Vulkan images
+// created on the app's device), frame pacing at a configurable display rate, actions, hand joints and events.
+//
+// Test and benchmark executables can also link the library directly and script it via the functions below. The loader
+// opens the same shared library, so scripted state is seen by the app's openxr calls. None of the openxr entry points are
+// exported - apps always go through the loader.
+namespace oxr::mock
+{
+	// Runtime wide configuration, read when an instance or session is created unless noted otherwise
+	struct Config
+	{
+		// Display refresh rate in Hz that xrWaitFrame paces to. 0 returns immediately (unthrottled). Applies immediately
+		float fDisplayRate = 90.0f;
+
+		// Recommended per eye swapchain image extent
+		uint32_t unRecommendedWidth = 1024;
+		uint32_t unRecommendedHeight = 1024;
+
+		// Number of images in each swapchain
+		uint32_t unSwapchainImageCount = 3;
+
+		// Distance between the eyes in meters
+		float fIpd = 0.064f;
+
+		// Simulated compositor cost of xrEndFrame in microseconds. Applies immediately
+		uint32_t unEndFrameCostUs = 0;
+	};
+
+	// Frame and input counters since the last ResetStats() call
+	struct Stats
+	{
+		uint64_t unWaitFrameCalls = 0;
+		uint64_t unBeginFrameCalls = 0;
+		uint64_t unEndFrameCalls = 0;
+
+		// Frames discarded because xrBeginFrame was called again before xrEndFrame
+		uint64_t unDiscardedFrames = 0;
+
+		// Frames ended with at least one layer
+		uint64_t unFramesWithLayers = 0;
+
+		uint64_t unSyncActionsCalls = 0;
+		uint64_t unLocateSpaceCalls = 0;
+		uint64_t unLocateViewsCalls = 0;
+		uint64_t unHapticCalls = 0;
+
+		// Calls that returned an error, e.g. call order or invalid layer errors
+		uint64_t unErrors = 0;
+	};
+
+	// A projection view submitted in the last xrEndFrame, resolved to the swapchain image that was released for it
+	struct SubmittedView
+	{
+		VkImage vkImage = VK_NULL_HANDLE;
+		VkFormat vkFormat = VK_FORMAT_UNDEFINED;
+		uint32_t unWidth = 0;
+		uint32_t unHeight = 0;
+		uint32_t unArrayIndex = 0;
+		XrRect2Di xrImageRect {};
+		XrPosef xrPose {};
+	};
+
+	/// <summary>
+	/// Sets the runtime configuration. Values noted as applying immediately take effect on the next frame, others on the next instance or session
+	/// </summary>
+	/// <param name="config">New runtime configuration</param>
+	OXR_MOCK_EXPORT void SetConfig( const Config &config );
+
+	/// <summary>
+	/// Retrieves the current runtime configuration
+	/// </summary>
+	/// <returns>The current runtime configuration</returns>
+	OXR_MOCK_EXPORT Config GetConfig();
+
+	/// <summary>
+	/// Retrieves the frame and input counters
+	/// </summary>
+	/// <returns>Counters since the runtime was loaded or ResetStats() was last called</returns>
+	OXR_MOCK_EXPORT Stats GetStats();
+
+	/// <summary>
+	/// Resets all frame and input counters to zero
+	/// </summary>
+	OXR_MOCK_EXPORT void ResetStats();
+
+	/// <summary>
+	/// Sets the head pose (view space) relative to the local/stage reference spaces
+	/// </summary>
+	/// <param name="xrPose">Head pose</param>
+	OXR_MOCK_EXPORT void SetHeadPose( const XrPosef &xrPose );
+
+	/// <summary>
+	/// Scripts a boolean input source (e.g. /user/hand/left/input/trigger/click). Actions bound to it in the current interaction profile pick it up on the next xrSyncActions
+	/// </summary>
+	/// <param name="pccInputPath">Full input source path</param>
+	/// <param name="bValue">New value</param>
+	OXR_MOCK_EXPORT void SetInputBoolean( const char *pccInputPath, bool bValue );
+
+	/// <summary>
+	/// Scripts a float input source (e.g. /user/hand/left/input/trigger/value)
+	/// </summary>
+	/// <param name="pccInputPath">Full input source path</param>
+	/// <param name="fValue">New value</param>
+	OXR_MOCK_EXPORT void SetInputFloat( const char *pccInputPath, float fValue );
+
+	/// <summary>
+	/// Scripts a vector2 input source (e.g. /user/hand/left/input/thumbstick)
+	/// </summary>
+	/// <param name="pccInputPath">Full input source path</param>
+	/// <param name="xrValue">New value</param>
+	OXR_MOCK_EXPORT void SetInputVector2f( const char *pccInputPath, const XrVector2f &xrValue );
+
+	/// <summary>
+	/// Scripts a pose input source (e.g. /user/hand/left/input/aim/pose) relative to the local/stage reference spaces.
+	/// Unscripted hand poses default to a resting position in front of the user
+	/// </summary>
+	/// <param name="pccInputPath">Full input source path</param>
+	/// <param name="xrPose">New pose</param>
+	OXR_MOCK_EXPORT void SetInputPose( const char *pccInputPath, const XrPosef &xrPose );
+
+	/// <summary>
+	/// Selects which of the app's suggested interaction profiles is bound. By default, the first suggested profile is used.
+	/// Queues an interaction profile changed event if actions are already attached
+	/// </summary>
+	/// <param name="pccInteractionProfile">Interaction profile path (e.g. /interaction_profiles/valve/index_controller)</param>
+	OXR_MOCK_EXPORT void SetInteractionProfile( const char *pccInteractionProfile );
+
+	/// <summary>
+	/// Scripts the hand joints reported through XR_EXT_hand_tracking. Joints default to a flat hand at the hand's grip pose
+	/// </summary>
+	/// <param name="xrHand">Hand to script</param>
+	/// <param name="bActive">Whether the hand is tracked</param>
+	/// <param name="pJointPoses">XR_HAND_JOINT_COUNT_EXT joint poses relative to the local/stage reference spaces, or nullptr to keep the default</param>
+	OXR_MOCK_EXPORT void SetHandJoints( XrHandEXT xrHand, bool bActive, const XrPosef *pJointPoses );
+
+	/// <summary>
+	/// Queues an arbitrary event for xrPollEvent (e.g. XrEventDataReferenceSpaceChangePending)
+	/// </summary>
+	/// <param name="xrEvent">Event to queue, the type determines how much of the buffer is used</param>
+	OXR_MOCK_EXPORT void QueueEvent( const XrEventDataBuffer &xrEvent );
+
+	/// <summary>
+	/// Simulates the runtime asking the app to stop (e.g. user quit from the system menu). Queues a STOPPING state change on the running session
+	/// </summary>
+	OXR_MOCK_EXPORT void RequestSessionStop();
+
+	/// <summary>
+	/// Retrieves the projection views submitted in the last xrEndFrame. Image contents are only safe to read after the app's GPU work for the frame has completed
+	/// </summary>
+	/// <returns>The submitted projection views in submission order</returns>
+	OXR_MOCK_EXPORT std::vector< SubmittedView > GetLastSubmittedViews();
+
+} // namespace oxr::mock
@@ -0,0 +1,40 @@
+// Copyright (c) 2017-2022, The Khronos Group Inc.
+//
+// SPDX-License-Identifier: Apache-2.0
+#version 400
+#extension GL_ARB_separate_shader_objects : enable
+#extension GL_ARB_shading_language_420pack : enable
+
+#pragma shader_stage(vertex)
+#pragma vertex
+
+layout (std140, push_constant) uniform buf
+{
+    mat4 vp;
+} ubuf;
+
+layout (location = 0) in vec3 Position;
+layout (location = 1) in vec3 Color;
+
+// Per instance
+layout (location = 2) in vec4 InstanceOrientation;
+layout (location = 3) in vec3 InstancePosition;
+layout (location = 4) in vec3 InstanceScale;
+layout (location = 5) in vec3 InstanceColor;
+
+layout (location = 0) out vec4 oColor;
+out gl_PerVertex
+{
+    vec4 gl_Position;
+};
+
+void main()
+{
+    // Scale, rotate (quaternion) then translate - same order as XrMatrix4x4f_CreateTranslationRotationScale
+    vec3 pos = Position * InstanceScale;
+    pos += 2.0 * cross(InstanceOrientation.xyz, cross(InstanceOrientation.xyz, pos) + InstanceOrientation.w * pos);
+
+    oColor.rgb  = Color.rgb * InstanceColor;
+    oColor.a  = 1.0;
+    gl_Position = ubuf.vp * vec4(pos + InstancePosition, 1);
+}
@@ -0,0 +1,31 @@
+// Copyright (c) 2017-2022, The Khronos Group Inc.
+//
+// SPDX-License-Identifier: Apache-2.0
+#version 450
+#extension GL_ARB_separate_shader_objects : enable
+#extension GL_ARB_shading_language_420pack : enable
+#extension GL_EXT_multiview : enable
+
+#pragma shader_stage(vertex)
+#pragma vertex
+
+layout (std140, push_constant) uniform buf
+{
+    mat4 mvp[2];
+} ubuf;
+
+layout (location = 0) in vec3 Position;
+layout (location = 1) in vec3 Color;
+
+layout (location = 0) out vec4 oColor;
+out gl_PerVertex
+{
+    vec4 gl_Position;
+};
+
+void main()
+{
+    oColor.rgb  = Color.rgb;
+    oColor.a  = 1.0;
+    gl_Position = ubuf.mvp[gl_ViewIndex] * vec4(Position, 1);
+}
@@ -0,0 +1,22 @@
+#version 450
+
+#extension GL_EXT_multiview : enable
+
+#pragma shader_stage(vertex)
+#pragma vertex
+
+// mvp matrix and the view this mask belongs to as pushconsts
+layout (std140, push_constant) uniform buf
+{
+    mat4 mvp;
+    uint viewIndex;
+} ubuf;
+
+// vertex and color info
+layout (location = 0) in vec2 Position;
+
+void main()
+{
+    // masks are drawn for all views at once, push vertices of other views' masks outside the clip volume
+    gl_Position = ( gl_ViewIndex == ubuf.viewIndex ) ? ubuf.mvp * vec4(Position, 0, 1) : vec4(2, 2, 2, 1);
+}
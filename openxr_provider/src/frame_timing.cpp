@@ -0,0 +1,314 @@
+/* Copyright 2021, 2022, 2023 Rune Berg (GitHub: https://github.com/1runeberg, Twitter: https://twitter.com/1runeberg, YouTube: https://www.youtube.com/@1RuneBerg)
+ *
+ *  SPDX-License-Identifier: MIT
+ *
+ *  Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+ *
+ *  2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *
+ *  3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote products derived from this
+ *     software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ *  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+ *  BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ *  GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+ *  DAMAGE.
+ *
+ */
+
+#include <provider/frame_timing.hpp>
+
+namespace oxr
+{
+	FrameTiming::FrameTiming( uint32_t unCapacity )
+		: m_unCapacity( std::max( unCapacity, 1u ) )
+	{
+		m_pSlots.reset( new Slot[ m_unCapacity ] );
+	}
+
+	void FrameTiming::BeginFrame( XrTime xrPredictedDisplayTime, XrDuration xrPredictedDisplayPeriod )
+	{
+		if ( !IsEnabled() )
+		{
+			// Publish what's left from before timing was disabled, their gpu timings won't come
+			while ( !m_deqPending.empty() )
+			{
+				Publish( m_deqPending.front() );
+				m_deqPending.pop_front();
+			}
+
+			m_xrLastDisplayTime = 0;
+			return;
+		}
+
+		m_currentRecord = {};
+		m_currentRecord.unFrameIndex = m_unNextFrameIndex++;
+		m_currentRecord.xrPredictedDisplayTime = xrPredictedDisplayTime;
+		m_currentRecord.xrPredictedDisplayPeriod = xrPredictedDisplayPeriod;
+		m_currentRecord.xrActualDisplayPeriod = m_xrLastDisplayTime == 0 ? 0 : xrPredictedDisplayTime - m_xrLastDisplayTime;
+
+		m_xrLastDisplayTime = xrPredictedDisplayTime;
+		m_bFrameOpen = true;
+	}
+
+	void FrameTiming::EndFrame()
+	{
+		if ( !m_bFrameOpen )
+			return;
+
+		m_bFrameOpen = false;
+		m_deqPending.push_back( m_currentRecord );
+
+		// Hold records back until the gpu timings of their passes had the chance to be resolved
+		while ( m_deqPending.size() > m_unGpuLatency )
+		{
+			Publish( m_deqPending.front() );
+			m_deqPending.pop_front();
+		}
+	}
+
+	void FrameTiming::SetStage( EFrameStage eStage, uint32_t unSlot, FrameStageTime stageTime )
+	{
+		if ( m_bFrameOpen && unSlot < k_unFrameTimingSlots )
+			m_currentRecord.stages[ ( uint32_t )eStage ][ unSlot ] = stageTime;
+	}
+
+	void FrameTiming::SetGpuPassTime( uint64_t unFrameIndex, uint32_t unPass, float fMs )
+	{
+		if ( unPass >= k_unFrameTimingSlots )
+			return;
+
+		auto SetPass = [ & ]( FrameTimingRecord &record )
+		{
+			record.fGpuPassMs[ unPass ] = fMs;
+			record.unGpuPasses = std::max( record.unGpuPasses, unPass + 1 );
+		};
+
+		if ( m_bFrameOpen && m_currentRecord.unFrameIndex == unFrameIndex )
+		{
+			SetPass( m_currentRecord );
+			return;
+		}
+
+		for ( auto &record : m_deqPending )
+		{
+			if ( record.unFrameIndex == unFrameIndex )
+			{
+				SetPass( record );
+				return;
+			}
+		}
+	}
+
+	void FrameTiming::Publish( const FrameTimingRecord &record )
+	{
+		// Single producer - readers detect a slot being overwritten by its sequence
+		const uint64_t unIndex = m_unPublished.load( std::memory_order_relaxed );
+		Slot &slot = m_pSlots[ unIndex % m_unCapacity ];
+
+		slot.unSequence.store( 2 * unIndex + 1, std::memory_order_relaxed );
+		std::atomic_thread_fence( std::memory_order_release );
+
+		slot.record = record;
+
+		slot.unSequence.store( 2 * ( unIndex + 1 ), std::memory_order_release );
+		m_unPublished.store( unIndex + 1, std::memory_order_release );
+	}
+
+	bool FrameTiming::Read( uint64_t unIndex, FrameTimingRecord *outRecord )
+	{
+		const Slot &slot = m_pSlots[ unIndex % m_unCapacity ];
+
+		const uint64_t unExpected = 2 * ( unIndex + 1 );
+		if ( slot.unSequence.load( std::memory_order_acquire ) != unExpected )
+			return false;
+
+		*outRecord = slot.record;
+
+		// The copy is only valid if the producer didn't start overwriting the slot in the meantime
+		std::atomic_thread_fence( std::memory_order_acquire );
+		return slot.unSequence.load( std::memory_order_relaxed ) == unExpected;
+	}
+
+	uint32_t FrameTiming::Pull( std::vector< FrameTimingRecord > &outRecords )
+	{
+		const uint64_t unPublished = m_unPublished.load( std::memory_order_acquire );
+		uint64_t unIndex = m_unPulled.load( std::memory_order_relaxed );
+
+		// Skip records that were overwritten since the last pull
+		if ( unPublished - unIndex > m_unCapacity )
+			unIndex = unPublished - m_unCapacity;
+
+		uint32_t unCount = 0;
+		FrameTimingRecord record;
+		for ( ; unIndex < unPublished; unIndex++ )
+		{
+			if ( Read( unIndex, &record ) )
+			{
+				outRecords.push_back( record );
+				unCount++;
+			}
+		}
+
+		m_unPulled.store( unPublished, std::memory_order_relaxed );
+		return unCount;
+	}
+
+	uint32_t FrameTiming::Snapshot( std::vector< FrameTimingRecord > &outRecords )
+	{
+		const uint64_t unPublished = m_unPublished.load( std::memory_order_acquire );
+		const uint64_t unFirst = unPublished > m_unCapacity ? unPublished - m_unCapacity : 0;
+
+		uint32_t unCount = 0;
+		FrameTimingRecord record;
+		for ( uint64_t unIndex = unFirst; unIndex < unPublished; unIndex++ )
+		{
+			if ( Read( unIndex, &record ) )
+			{
+				outRecords.push_back( record );
+				unCount++;
+			}
+		}
+
+		return unCount;
+	}
+
+	bool FrameTiming::DumpCsv( const std::string &sFilename )
+	{
+		std::vector< FrameTimingRecord > vecRecords;
+		Snapshot( vecRecords );
+
+		std::ofstream file( sFilename, std::ios::out | std::ios::trunc );
+		if ( !file.is_open() )
+		{
+			oxr::LogError( LOG_CATEGORY_FRAMETIMING, "Unable to write frame timings to %s", sFilename.c_str() );
+			return false;
+		}
+
+		// (1) Only add columns for stages and gpu passes that were timed in any of the frames
+		bool bStageUsed[ ( uint32_t )EFrameStage::EMax ][ k_unFrameTimingSlots ] {};
+		uint32_t unGpuPasses = 0;
+		for ( auto &record : vecRecords )
+		{
+			for ( uint32_t s = 0; s < ( uint32_t )EFrameStage::EMax; s++ )
+				for ( uint32_t i = 0; i < k_unFrameTimingSlots; i++ )
+					bStageUsed[ s ][ i ] |= record.stages[ s ][ i ].nEndNs != 0;
+
+			unGpuPasses = std::max( unGpuPasses, record.unGpuPasses );
+		}
+
+		// (2) Header
+		file << "frame,predicted_display_time,predicted_display_period_ms,actual_display_period_ms";
+		for ( uint32_t s = 0; s < ( uint32_t )EFrameStage::EMax; s++ )
+			for ( uint32_t i = 0; i < k_unFrameTimingSlots; i++ )
+				if ( bStageUsed[ s ][ i ] )
+					file << "," << GetStageName( ( EFrameStage )s ) << "_" << i << "_ms";
+
+		for ( uint32_t i = 0; i < unGpuPasses; i++ )
+			file << ",gpu_pass_" << i << "_ms";
+
+		file << "\n";
+
+		// (3) One row per frame
+		for ( auto &record : vecRecords )
+		{
+			file << record.unFrameIndex << "," << record.xrPredictedDisplayTime << "," << record.xrPredictedDisplayPeriod / 1000000.0 << ","
+				 << record.xrActualDisplayPeriod / 1000000.0;
+
+			for ( uint32_t s = 0; s < ( uint32_t )EFrameStage::EMax; s++ )
+				for ( uint32_t i = 0; i < k_unFrameTimingSlots; i++ )
+					if ( bStageUsed[ s ][ i ] )
+						file << "," << record.GetStageMs( ( EFrameStage )s, i );
+
+			for ( uint32_t i = 0; i < unGpuPasses; i++ )
+				file << "," << record.fGpuPassMs[ i ];
+
+			file << "\n";
+		}
+
+		oxr::LogInfo( LOG_CATEGORY_FRAMETIMING, "%i frame timings written to %s", ( uint32_t )vecRecords.size(), sFilename.c_str() );
+		return file.good();
+	}
+
+	bool FrameTiming::DumpChromeTrace( const std::string &sFilename )
+	{
+		std::vector< FrameTimingRecord > vecRecords;
+		Snapshot( vecRecords );
+
+		std::ofstream file( sFilename, std::ios::out | std::ios::trunc );
+		if ( !file.is_open() )
+		{
+			oxr::LogError( LOG_CATEGORY_FRAMETIMING, "Unable to write frame timings to %s", sFilename.c_str() );
+			return false;
+		}
+
+		// Complete events (microseconds) with one thread per slot, gpu pass times as counters at the end of each frame
+		file << "{\"traceEvents\":[";
+		bool bFirst = true;
+		for ( auto &record : vecRecords )
+		{
+			int64_t nFrameEndNs = 0;
+			for ( uint32_t s = 0; s < ( uint32_t )EFrameStage::EMax; s++ )
+			{
+				for ( uint32_t i = 0; i < k_unFrameTimingSlots; i++ )
+				{
+					const FrameStageTime &stageTime = record.stages[ s ][ i ];
+					if ( stageTime.nEndNs == 0 )
+						continue;
+
+					file << ( bFirst ? "" : "," ) << "\n{\"name\":\"" << GetStageName( ( EFrameStage )s ) << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << i
+						 << ",\"ts\":" << stageTime.nBeginNs / 1000.0 << ",\"dur\":" << ( stageTime.nEndNs - stageTime.nBeginNs ) / 1000.0
+						 << ",\"args\":{\"frame\":" << record.unFrameIndex << "}}";
+
+					bFirst = false;
+					nFrameEndNs = std::max( nFrameEndNs, stageTime.nEndNs );
+				}
+			}
+
+			if ( record.unGpuPasses > 0 && nFrameEndNs != 0 )
+			{
+				file << ( bFirst ? "" : "," ) << "\n{\"name\":\"GpuPassMs\",\"ph\":\"C\",\"pid\":1,\"ts\":" << nFrameEndNs / 1000.0 << ",\"args\":{";
+				for ( uint32_t i = 0; i < record.unGpuPasses; i++ )
+					file << ( i == 0 ? "" : "," ) << "\"pass_" << i << "\":" << record.fGpuPassMs[ i ];
+				file << "}}";
+
+				bFirst = false;
+			}
+		}
+		file << "\n]}\n";
+
+		oxr::LogInfo( LOG_CATEGORY_FRAMETIMING, "%i frame timings written to %s", ( uint32_t )vecRecords.size(), sFilename.c_str() );
+		return file.good();
+	}
+
+	const char *FrameTiming::GetStageName( EFrameStage eStage )
+	{
+		switch ( eStage )
+		{
+			case EFrameStage::WaitFrame:
+				return "WaitFrame";
+			case EFrameStage::BeginFrame:
+				return "BeginFrame";
+			case EFrameStage::AcquireImage:
+				return "AcquireImage";
+			case EFrameStage::WaitImage:
+				return "WaitImage";
+			case EFrameStage::ReleaseImage:
+				return "ReleaseImage";
+			case EFrameStage::RecordCommands:
+				return "RecordCommands";
+			case EFrameStage::QueueSubmit:
+				return "QueueSubmit";
+			case EFrameStage::EndFrame:
+				return "EndFrame";
+			default:
+				return "Unknown";
+		}
+	}
+
+} // namespace oxr
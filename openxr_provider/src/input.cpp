@@ -24,6 +24,10 @@
 #include <provider/input.hpp>
 #include <provider/session.hpp>
 
+#include <chrono>
+#include <cmath>
+#include <thread>
+
 namespace oxr
 {
 	Action::~Action()
@@ -144,6 +148,9 @@ namespace oxr
 				vecActionSpaces.resize( 1, XR_NULL_HANDLE );
 		}
 
+		// Synced states start out the same as the app facing ones
+		vecSyncedActionStates = vecActionStates;
+
 		xrResult = xrCreateAction( pActionSet->xrActionSetHandle, &xrActionCreateInfo, &xrActionHandle );
 
 		if ( !XR_UNQUALIFIED_SUCCESS( xrResult ) )
@@ -180,9 +187,10 @@ namespace oxr
 	{
 		assert( pInstance );
 		m_pInstance = pInstance;
+		m_PathTable.Init( pInstance->xrInstance );
 	}
 
-	Input::~Input() {}
+	Input::~Input() { StopInputThread(); }
 
 	void Input::Init( oxr::Session *pSession )
 	{
@@ -282,6 +290,7 @@ namespace oxr
 	{
 		assert( controller );
 
+		controller->pPathTable = &m_PathTable;
 		return controller->AddBinding( m_pInstance->xrInstance, action, hand, component, qualifier );
 	}
 
@@ -289,35 +298,31 @@ namespace oxr
 	{
 		assert( controller );
 
+		controller->pPathTable = &m_PathTable;
 		return controller->AddBinding( m_pInstance->xrInstance, action, sFullBindingPath );
 	}
 
-	XrResult Input::SuggestBindings( Controller *controller, void *pOtherInfo ) { return controller->SuggestBindings( m_pInstance->xrInstance, pOtherInfo ); }
+	XrResult Input::SuggestBindings( Controller *controller, void *pOtherInfo )
+	{
+		controller->pPathTable = &m_PathTable;
+		return controller->SuggestBindings( m_pInstance->xrInstance, pOtherInfo );
+	}
 
 	XrResult Input::StringToXrPath( const char *string, XrPath *xrPath )
 	{
 		assert( xrPath );
 
-		XrResult xrResult = xrStringToPath( m_pInstance->xrInstance, string, xrPath );
-
-		if ( !XR_UNQUALIFIED_SUCCESS( xrResult ) )
-			LogError( LOG_CATEGORY_INPUT, "Unable to convert %s to an XrPath: %s", string, XrEnumToString( xrResult ) );
-
-		return xrResult;
+		return m_PathTable.StringToPath( string, xrPath );
 	}
 
 	XrResult Input::XrPathToString( std::string &outString, XrPath *xrPath )
 	{
-		outString.clear();
-
-		uint32_t unCount = 0;
-		char sPath[ XR_MAX_PATH_LENGTH ];
-		XrResult xrResult = xrPathToString( m_pInstance->xrInstance, *xrPath, sizeof( sPath ), &unCount, sPath );
+		std::string_view sPath = m_PathTable.PathToString( *xrPath );
 
-		if ( !XR_UNQUALIFIED_SUCCESS( xrResult ) )
+		if ( sPath.empty() )
 		{
-			LogError( LOG_CATEGORY_INPUT, "Unable to convert XrPath: %" PRIu64 " to a readable string", *xrPath, XrEnumToString( xrResult ) );
-			return xrResult;
+			outString.clear();
+			return XR_ERROR_PATH_INVALID;
 		}
 
 		outString = sPath;
@@ -338,6 +343,9 @@ namespace oxr
 		m_vecActiveActionSets.push_back( pActionSet );
 		m_vecXrActiveActionSets.push_back( { pActionSet->xrActionSetHandle, xrPath } );
 
+		// Assign snapshot slots here rather than on the input thread, so readers never see them change
+		AssignSnapshotSlots( pActionSet );
+
 		return XR_SUCCESS;
 	}
 
@@ -396,6 +404,9 @@ namespace oxr
 		if ( !XR_UNQUALIFIED_SUCCESS( xrResult ) )
 			return xrResult;
 
+		// Action space locations may change with the sync - reference space locations stay cached for the frame
+		m_pSession->InvalidateActionSpaceLocations();
+
 		// Update action states
 		for ( auto &actionset : m_vecActiveActionSets )
 		{
@@ -405,15 +416,125 @@ namespace oxr
 			}
 		}
 
+		// Make the new states available to other threads
+		PublishActionStates();
+
 		return xrResult;
 	}
 
+	ActionStateSnapshotRef Input::AcquireActionStates()
+	{
+		while ( true )
+		{
+			uint32_t unLatest = m_unLatestSnapshot.load();
+			if ( unLatest == UINT32_MAX )
+				return {};
+
+			// Pin the snapshot, then make sure it wasn't replaced before the pin was visible to the input thread
+			m_arrSnapshotReaders[ unLatest ].fetch_add( 1 );
+			if ( m_unLatestSnapshot.load() == unLatest )
+				return ActionStateSnapshotRef( &m_arrActionStateSnapshots[ unLatest ], &m_arrSnapshotReaders[ unLatest ] );
+
+			m_arrSnapshotReaders[ unLatest ].fetch_sub( 1 );
+		}
+	}
+
+	void Input::AssignSnapshotSlots( ActionSet *pActionSet )
+	{
+		for ( auto &action : pActionSet->vecActions )
+		{
+			if ( action->unSnapshotSlot.load( std::memory_order_relaxed ) != UINT32_MAX )
+				continue;
+
+			// Threads holding a snapshot may read the slot while the input thread assigns it
+			action->unSnapshotSlot.store( m_unSnapshotSlots, std::memory_order_release );
+			m_unSnapshotSlots += static_cast< uint32_t >( action->vecActionStates.size() );
+		}
+	}
+
+	void Input::PublishActionStates()
+	{
+		// (1) Assign snapshot slots to actions created after their actionset was added for sync
+		for ( auto &actionset : m_vecActiveActionSets )
+			AssignSnapshotSlots( actionset );
+
+		// (2) Find a snapshot that isn't published and that no reader holds - only waits if readers hold on to older snapshots
+		uint32_t unLatest = m_unLatestSnapshot.load();
+		uint32_t unTarget = UINT32_MAX;
+		while ( unTarget == UINT32_MAX )
+		{
+			for ( uint32_t i = 0; i < k_unActionStateSnapshots; i++ )
+			{
+				if ( i != unLatest && m_arrSnapshotReaders[ i ].load() == 0 )
+				{
+					unTarget = i;
+					break;
+				}
+			}
+
+			if ( unTarget == UINT32_MAX )
+				std::this_thread::yield();
+		}
+
+		// (3) Copy the current action states - actions of inactive actionsets are left inactive
+		ActionStateSnapshot &snapshot = m_arrActionStateSnapshots[ unTarget ];
+		snapshot.xrSyncTime = m_pSession->GetPredictedDisplayTime();
+		snapshot.unSyncIndex = m_unPublishedSnapshots++;
+		snapshot.vecIsActive.assign( m_unSnapshotSlots, XR_FALSE );
+		snapshot.vecChangedSinceLastSync.assign( m_unSnapshotSlots, XR_FALSE );
+		snapshot.vecLastChangeTime.assign( m_unSnapshotSlots, 0 );
+		snapshot.vecValues.assign( m_unSnapshotSlots, { 0.0f, 0.0f } );
+
+		for ( auto &actionset : m_vecActiveActionSets )
+		{
+			for ( auto &action : actionset->vecActions )
+			{
+				for ( uint32_t i = 0; i < action->vecSyncedActionStates.size(); i++ )
+				{
+					uint32_t unSlot = action->unSnapshotSlot.load( std::memory_order_relaxed ) + i;
+					const Action::ActionState &state = action->vecSyncedActionStates[ i ];
+
+					switch ( action->xrActionType )
+					{
+						case XR_ACTION_TYPE_BOOLEAN_INPUT:
+							snapshot.vecIsActive[ unSlot ] = state.stateBoolean.isActive;
+							snapshot.vecChangedSinceLastSync[ unSlot ] = state.stateBoolean.changedSinceLastSync;
+							snapshot.vecLastChangeTime[ unSlot ] = state.stateBoolean.lastChangeTime;
+							snapshot.vecValues[ unSlot ].x = state.stateBoolean.currentState ? 1.0f : 0.0f;
+							break;
+						case XR_ACTION_TYPE_FLOAT_INPUT:
+							snapshot.vecIsActive[ unSlot ] = state.stateFloat.isActive;
+							snapshot.vecChangedSinceLastSync[ unSlot ] = state.stateFloat.changedSinceLastSync;
+							snapshot.vecLastChangeTime[ unSlot ] = state.stateFloat.lastChangeTime;
+							snapshot.vecValues[ unSlot ].x = state.stateFloat.currentState;
+							break;
+						case XR_ACTION_TYPE_VECTOR2F_INPUT:
+							snapshot.vecIsActive[ unSlot ] = state.stateVector2f.isActive;
+							snapshot.vecChangedSinceLastSync[ unSlot ] = state.stateVector2f.changedSinceLastSync;
+							snapshot.vecLastChangeTime[ unSlot ] = state.stateVector2f.lastChangeTime;
+							snapshot.vecValues[ unSlot ] = state.stateVector2f.currentState;
+							break;
+						case XR_ACTION_TYPE_POSE_INPUT:
+							snapshot.vecIsActive[ unSlot ] = state.statePose.isActive;
+							break;
+						case XR_ACTION_TYPE_MAX_ENUM:
+						default:
+							break;
+					}
+				}
+			}
+		}
+
+		// (4) Publish
+		m_unLatestSnapshot.store( unTarget );
+	}
+
 	XrResult Input::GetActionPose( XrSpaceLocation *outSpaceLocation, Action *pAction, uint32_t unSpaceIndex, XrTime xrTime )
 	{
 		if ( pAction->vecActionSpaces[ unSpaceIndex ] == XR_NULL_HANDLE )
 			return XR_ERROR_VALIDATION_FAILURE;
 
-		return xrLocateSpace( pAction->vecActionSpaces[ unSpaceIndex ], m_pSession->GetAppSpace(), xrTime, outSpaceLocation );
+		return m_pSession->LocateSpace( m_pSession->GetAppSpace(), pAction->vecActionSpaces[ unSpaceIndex ], xrTime, outSpaceLocation );
 	}
 
 	XrResult Input::GetActionState( Action *pAction )
@@ -422,46 +543,414 @@ namespace oxr
 		xrActionStateGetInfo.action = pAction->xrActionHandle;
 
 		XrResult xrResult = XR_SUCCESS;
+		const bool bEvents = m_bEventQueueEnabled;
+		const bool bDeferred = m_bInputThreadActive && m_eCallbackDispatch == EInputCallbackDispatch::Deferred;
 
-		// get the action state from the runtime, block other threads while doing so
-		const std::lock_guard< std::mutex > lock( pAction->mutexActionState );
-
+		// get the action state from the runtime
 		uint32_t unIterations = static_cast< uint32_t >( pAction->vecSubactionpaths.empty() ? 1 : pAction->vecSubactionpaths.size() );
 		for ( uint32_t i = 0; i < unIterations; i++ )
 		{
 			xrActionStateGetInfo.subactionPath = pAction->vecSubactionpaths.empty() ? XR_NULL_PATH : pAction->vecSubactionpaths[ i ];
+			Action::ActionState &syncedState = pAction->vecSyncedActionStates[ i ];
+			bool bCallback = false;
 
 			switch ( pAction->xrActionType )
 			{
 				case XR_ACTION_TYPE_BOOLEAN_INPUT:
-					xrResult = xrGetActionStateBoolean( m_pSession->GetXrSession(), &xrActionStateGetInfo, &pAction->vecActionStates[ i ].stateBoolean );
-					if ( pAction->vecActionStates[ i ].stateBoolean.isActive && pAction->vecActionStates[ i ].stateBoolean.changedSinceLastSync )
-						pAction->pfnCallback( pAction, i );
+					xrResult = xrGetActionStateBoolean( m_pSession->GetXrSession(), &xrActionStateGetInfo, &syncedState.stateBoolean );
+					bCallback = syncedState.stateBoolean.isActive && syncedState.stateBoolean.changedSinceLastSync;
 					break;
 				case XR_ACTION_TYPE_FLOAT_INPUT:
-					xrResult = xrGetActionStateFloat( m_pSession->GetXrSession(), &xrActionStateGetInfo, &pAction->vecActionStates[ i ].stateFloat );
-					if ( pAction->vecActionStates[ i ].stateFloat.isActive && pAction->vecActionStates[ i ].stateFloat.changedSinceLastSync )
-						pAction->pfnCallback( pAction, i );
+					xrResult = xrGetActionStateFloat( m_pSession->GetXrSession(), &xrActionStateGetInfo, &syncedState.stateFloat );
+					bCallback = syncedState.stateFloat.isActive && syncedState.stateFloat.changedSinceLastSync;
 					break;
 				case XR_ACTION_TYPE_VECTOR2F_INPUT:
-					xrResult = xrGetActionStateVector2f( m_pSession->GetXrSession(), &xrActionStateGetInfo, &pAction->vecActionStates[ i ].stateVector2f );
-					if ( pAction->vecActionStates[ i ].stateVector2f.isActive && pAction->vecActionStates[ i ].stateVector2f.changedSinceLastSync )
-						pAction->pfnCallback( pAction, i );
+					xrResult = xrGetActionStateVector2f( m_pSession->GetXrSession(), &xrActionStateGetInfo, &syncedState.stateVector2f );
+					bCallback = syncedState.stateVector2f.isActive && syncedState.stateVector2f.changedSinceLastSync;
 					break;
 				case XR_ACTION_TYPE_POSE_INPUT:
-					xrResult = xrGetActionStatePose( m_pSession->GetXrSession(), &xrActionStateGetInfo, &pAction->vecActionStates[ i ].statePose );
-					pAction->pfnCallback( pAction, i );
-					break;
+				{
+					// poses move every frame, so they call back on every sync. Deferred ones are only queued when the pose's activity changed,
+					// or while active once the previous one was dispatched, so a fast polling input thread doesn't fill the queue with stale poses
+					const XrBool32 bWasActive = syncedState.statePose.isActive;
+					xrResult = xrGetActionStatePose( m_pSession->GetXrSession(), &xrActionStateGetInfo, &syncedState.statePose );
+					bCallback = !bDeferred || syncedState.statePose.isActive != bWasActive || ( syncedState.statePose.isActive && !IsPoseCallbackQueued( pAction, i ) );
+				}
+				break;
 				case XR_ACTION_TYPE_MAX_ENUM:
 				default:
 					xrResult = XR_ERROR_ACTION_TYPE_MISMATCH;
 					break;
 			}
+
+			// in event mode, changes are queued for the app instead of calling the callback here
+			if ( bEvents )
+			{
+				EmitEvent( pAction, i );
+				continue;
+			}
+
+			// deferred callbacks update the app facing state when they are dispatched
+			if ( !bDeferred )
+				pAction->vecActionStates[ i ] = syncedState;
+
+			if ( bCallback )
+				InvokeCallback( pAction, i, bDeferred );
 		}
 
 		return xrResult;
 	}
 
+	void Input::InvokeCallback( Action *pAction, uint32_t unActionStateIndex, bool bDeferred )
+	{
+		if ( !bDeferred )
+		{
+			pAction->pfnCallback( pAction, unActionStateIndex );
+			return;
+		}
+
+		// Queue the callback with the state that triggered it, drop it if the app isn't keeping up
+		QueuedCallback queuedCallback;
+		queuedCallback.pAction = pAction;
+		queuedCallback.unActionStateIndex = unActionStateIndex;
+		queuedCallback.actionState = pAction->vecSyncedActionStates[ unActionStateIndex ];
+
+		if ( !m_CallbackQueue.Push( queuedCallback ) )
+		{
+			m_unDroppedCallbacks.fetch_add( 1, std::memory_order_relaxed );
+			return;
+		}
+
+		m_unQueuedCallbacks++;
+		if ( pAction->xrActionType == XR_ACTION_TYPE_POSE_INPUT )
+		{
+			if ( pAction->vecQueuedPoseCallbacks.size() != pAction->vecSyncedActionStates.size() )
+				pAction->vecQueuedPoseCallbacks.assign( pAction->vecSyncedActionStates.size(), 0 );
+
+			pAction->vecQueuedPoseCallbacks[ unActionStateIndex ] = m_unQueuedCallbacks;
+		}
+	}
+
+	bool Input::IsPoseCallbackQueued( Action *pAction, uint32_t unActionStateIndex )
+	{
+		if ( unActionStateIndex >= pAction->vecQueuedPoseCallbacks.size() )
+			return false;
+
+		return pAction->vecQueuedPoseCallbacks[ unActionStateIndex ] > m_unDispatchedCallbacks.load( std::memory_order_acquire );
+	}
+
+	uint32_t Input::DispatchCallbacks()
+	{
+		uint32_t unDispatched = 0;
+
+		QueuedCallback queuedCallback;
+		while ( m_CallbackQueue.Pop( queuedCallback ) )
+		{
+			m_unDispatchedCallbacks.fetch_add( 1, std::memory_order_release );
+			queuedCallback.pAction->vecActionStates[ queuedCallback.unActionStateIndex ] = queuedCallback.actionState;
+			queuedCallback.pAction->pfnCallback( queuedCallback.pAction, queuedCallback.unActionStateIndex );
+			unDispatched++;
+		}
+
+		return unDispatched;
+	}
+
+	void Input::EnableEventQueue( float fEpsilon /*= 0.01f*/, float fDeadzone /*= 0.0f*/, uint32_t unCapacity /*= k_unInputEventQueueSize*/ )
+	{
+		m_fEventEpsilon = std::max( fEpsilon, 0.0f );
+		m_fEventDeadzone = std::max( fDeadzone, 0.0f );
+		m_EventQueue.Allocate( std::max( unCapacity, 1u ) );
+
+		// Start from scratch so the first sync reports the current state of all active actions
+		for ( auto &actionset : m_vecActiveActionSets )
+		{
+			for ( auto &action : actionset->vecActions )
+			{
+				action->vecEventIsActive.clear();
+				action->vecEventValues.clear();
+			}
+		}
+
+		m_bEventQueueEnabled = true;
+		LogInfo( LOG_CATEGORY_INPUT, "Input event queue enabled (%i events, epsilon %.3f, deadzone %.3f)", unCapacity, m_fEventEpsilon, m_fEventDeadzone );
+	}
+
+	void Input::EmitEvent( Action *pAction, uint32_t unActionStateIndex )
+	{
+		// (1) Lazily set up tracking of the last state sent for each subaction path
+		if ( pAction->vecEventIsActive.size() != pAction->vecSyncedActionStates.size() )
+		{
+			pAction->vecEventIsActive.assign( pAction->vecSyncedActionStates.size(), XR_FALSE );
+			pAction->vecEventValues.assign( pAction->vecSyncedActionStates.size(), { 0.0f, 0.0f } );
+		}
+
+		// (2) Build the event from the synced state, applying the deadzone to float and vector values
+		const Action::ActionState &state = pAction->vecSyncedActionStates[ unActionStateIndex ];
+
+		InputEvent inputEvent;
+		inputEvent.pAction = pAction;
+		inputEvent.unActionStateIndex = unActionStateIndex;
+
+		switch ( pAction->xrActionType )
+		{
+			case XR_ACTION_TYPE_BOOLEAN_INPUT:
+				inputEvent.eType = EInputEventType::Boolean;
+				inputEvent.bIsActive = state.stateBoolean.isActive;
+				inputEvent.value.x = state.stateBoolean.currentState ? 1.0f : 0.0f;
+				inputEvent.xrTime = state.stateBoolean.lastChangeTime;
+				break;
+			case XR_ACTION_TYPE_FLOAT_INPUT:
+				inputEvent.eType = EInputEventType::Float;
+				inputEvent.bIsActive = state.stateFloat.isActive;
+				inputEvent.value.x = std::fabs( state.stateFloat.currentState ) < m_fEventDeadzone ? 0.0f : state.stateFloat.currentState;
+				inputEvent.xrTime = state.stateFloat.lastChangeTime;
+				break;
+			case XR_ACTION_TYPE_VECTOR2F_INPUT:
+			{
+				const XrVector2f &value = state.stateVector2f.currentState;
+				inputEvent.eType = EInputEventType::Vector2f;
+				inputEvent.bIsActive = state.stateVector2f.isActive;
+				inputEvent.value = ( value.x * value.x + value.y * value.y ) < m_fEventDeadzone * m_fEventDeadzone ? XrVector2f { 0.0f, 0.0f } : value;
+				inputEvent.xrTime = state.stateVector2f.lastChangeTime;
+				break;
+			}
+			case XR_ACTION_TYPE_POSE_INPUT:
+				inputEvent.eType = EInputEventType::PoseValidity;
+				inputEvent.bIsActive = state.statePose.isActive;
+				inputEvent.xrTime = m_pSession->GetPredictedDisplayTime();
+				break;
+			case XR_ACTION_TYPE_MAX_ENUM:
+			default:
+				return;
+		}
+
+		// (3) Only emit changes - availability changes always, booleans on any edge and float/vector values once they move past the epsilon
+		XrBool32 &bLastIsActive = pAction->vecEventIsActive[ unActionStateIndex ];
+		XrVector2f &lastValue = pAction->vecEventValues[ unActionStateIndex ];
+
+		bool bEmit = inputEvent.bIsActive != bLastIsActive;
+		if ( !bEmit && inputEvent.bIsActive && inputEvent.eType != EInputEventType::PoseValidity )
+		{
+			float fDeltaX = inputEvent.value.x - lastValue.x;
+			float fDeltaY = inputEvent.value.y - lastValue.y;
+
+			if ( inputEvent.eType == EInputEventType::Boolean )
+				bEmit = fDeltaX != 0.0f;
+			else
+				bEmit = ( fDeltaX * fDeltaX + fDeltaY * fDeltaY ) > m_fEventEpsilon * m_fEventEpsilon;
+		}
+
+		if ( !bEmit )
+			return;
+
+		// (4) The last sent state only moves on once the event is queued, so a change dropped on a full queue is sent again on the next sync
+		if ( !m_EventQueue.Push( inputEvent ) )
+		{
+			m_unDroppedEvents.fetch_add( 1, std::memory_order_relaxed );
+			return;
+		}
+
+		bLastIsActive = inputEvent.bIsActive;
+		lastValue = inputEvent.value;
+	}
+
+	uint32_t Input::DrainEvents( std::vector< InputEvent > &outEvents )
+	{
+		uint32_t unDrained = 0;
+
+		InputEvent inputEvent;
+		while ( m_EventQueue.Pop( inputEvent ) )
+		{
+			outEvents.push_back( inputEvent );
+			unDrained++;
+		}
+
+		return unDrained;
+	}
+
+	uint32_t Input::DispatchEvents()
+	{
+		uint32_t unDispatched = 0;
+
+		InputEvent inputEvent;
+		while ( m_EventQueue.Pop( inputEvent ) )
+		{
+			// (1) Update the app facing action state from the event
+			Action::ActionState &state = inputEvent.pAction->vecActionStates[ inputEvent.unActionStateIndex ];
+
+			switch ( inputEvent.eType )
+			{
+				case EInputEventType::Boolean:
+					state.stateBoolean.isActive = inputEvent.bIsActive;
+					state.stateBoolean.currentState = inputEvent.value.x != 0.0f;
+					state.stateBoolean.changedSinceLastSync = XR_TRUE;
+					state.stateBoolean.lastChangeTime = inputEvent.xrTime;
+					break;
+				case EInputEventType::Float:
+					state.stateFloat.isActive = inputEvent.bIsActive;
+					state.stateFloat.currentState = inputEvent.value.x;
+					state.stateFloat.changedSinceLastSync = XR_TRUE;
+					state.stateFloat.lastChangeTime = inputEvent.xrTime;
+					break;
+				case EInputEventType::Vector2f:
+					state.stateVector2f.isActive = inputEvent.bIsActive;
+					state.stateVector2f.currentState = inputEvent.value;
+					state.stateVector2f.changedSinceLastSync = XR_TRUE;
+					state.stateVector2f.lastChangeTime = inputEvent.xrTime;
+					break;
+				case EInputEventType::PoseValidity:
+					state.statePose.isActive = inputEvent.bIsActive;
+					break;
+			}
+
+			// (2) Call the callback - as with callbacks during sync, only for active actions, but for every pose validity change
+			if ( inputEvent.bIsActive || inputEvent.eType == EInputEventType::PoseValidity )
+			{
+				inputEvent.pAction->pfnCallback( inputEvent.pAction, inputEvent.unActionStateIndex );
+				unDispatched++;
+			}
+		}
+
+		return unDispatched;
+	}
+
+	XrResult Input::StartInputThread( float fPollRateHz /*= 0.0f*/, EInputCallbackDispatch eCallbackDispatch /*= EInputCallbackDispatch::InputThread*/ )
+	{
+		if ( !m_pSession )
+			return XR_ERROR_CALL_ORDER_INVALID;
+
+		if ( m_bInputThreadActive )
+			return XR_SUCCESS;
+
+		// Clean up after an input thread that was never stopped
+		StopInputThread();
+
+		m_fInputPollRateHz = std::max( fPollRateHz, 0.0f );
+		m_eCallbackDispatch = eCallbackDispatch;
+
+		// Allocated once, as the consumer may still be draining it after the thread is stopped
+		if ( !m_CallbackQueue.IsAllocated() )
+			m_CallbackQueue.Allocate( k_unInputCallbackQueueSize );
+
+		{
+			std::lock_guard< std::mutex > lock( m_mutexInputThread );
+			m_bInputRequested = false;
+			m_bInputThreadActive = true;
+		}
+
+		m_threadInput = std::thread( &Input::InputThreadLoop, this );
+		m_unInputThreadsCreated.fetch_add( 1, std::memory_order_relaxed );
+
+		if ( m_fInputPollRateHz > 0.0f )
+			LogInfo( LOG_CATEGORY_INPUT, "Input thread started, polling at %.1f Hz", m_fInputPollRateHz );
+		else
+			LogInfo( LOG_CATEGORY_INPUT, "Input thread started, processing input on request" );
+
+		return XR_SUCCESS;
+	}
+
+	void Input::StopInputThread()
+	{
+		{
+			std::lock_guard< std::mutex > lock( m_mutexInputThread );
+			m_bInputThreadActive = false;
+		}
+
+		m_cvInputThread.notify_all();
+
+		if ( m_threadInput.joinable() )
+		{
+			m_threadInput.join();
+			LogInfo( LOG_CATEGORY_INPUT, "Input thread stopped" );
+		}
+	}
+
+	void Input::RequestInput()
+	{
+		{
+			std::lock_guard< std::mutex > lock( m_mutexInputThread );
+			m_bInputRequested = true;
+		}
+
+		m_cvInputThread.notify_one();
+	}
+
+	void Input::InputThreadLoop()
+	{
+		auto nextPoll = std::chrono::steady_clock::now();
+
+		while ( true )
+		{
+			// (1) Wait for a request, the next poll or a stop
+			{
+				std::unique_lock< std::mutex > lock( m_mutexInputThread );
+
+				if ( m_fInputPollRateHz > 0.0f )
+				{
+					// Polls missed while processing are skipped rather than caught up on
+					nextPoll = std::max(
+						nextPoll + std::chrono::duration_cast< std::chrono::steady_clock::duration >( std::chrono::duration< float >( 1.0f / m_fInputPollRateHz ) ),
+						std::chrono::steady_clock::now() );
+
+					m_cvInputThread.wait_until( lock, nextPoll, [ this ] { return !m_bInputThreadActive; } );
+				}
+				else
+				{
+					m_cvInputThread.wait( lock, [ this ] { return m_bInputRequested || !m_bInputThreadActive; } );
+				}
+
+				if ( !m_bInputThreadActive )
+					return;
+
+				m_bInputRequested = false;
+			}
+
+			// (2) Actions can only be synced while the session is running
+			XrSessionState xrSessionState = m_pSession->GetState();
+			if ( xrSessionState != XR_SESSION_STATE_SYNCHRONIZED && xrSessionState != XR_SESSION_STATE_VISIBLE && xrSessionState != XR_SESSION_STATE_FOCUSED )
+				continue;
+
+			// (3) Process input and record how long it took
+			auto processStart = std::chrono::steady_clock::now();
+			ProcessInput();
+			float fLatencyMs = std::chrono::duration< float, std::milli >( std::chrono::steady_clock::now() - processStart ).count();
+
+			{
+				std::lock_guard< std::mutex > lock( m_mutexInputStats );
+				m_arrLatencySamplesMs[ m_unProcessedFrames % k_unInputLatencySamples ] = fLatencyMs;
+				m_unProcessedFrames++;
+			}
+		}
+	}
+
+	InputThreadStats Input::GetInputThreadStats()
+	{
+		InputThreadStats stats;
+		stats.unThreadsCreated = m_unInputThreadsCreated.load( std::memory_order_relaxed );
+		stats.unDroppedCallbacks = m_unDroppedCallbacks.load( std::memory_order_relaxed );
+		stats.unDroppedEvents = m_unDroppedEvents.load( std::memory_order_relaxed );
+
+		std::vector< float > vecSamplesMs;
+		{
+			std::lock_guard< std::mutex > lock( m_mutexInputStats );
+			stats.unProcessedFrames = m_unProcessedFrames;
+			vecSamplesMs.assign( m_arrLatencySamplesMs, m_arrLatencySamplesMs + std::min< uint64_t >( m_unProcessedFrames, k_unInputLatencySamples ) );
+		}
+
+		if ( vecSamplesMs.empty() )
+			return stats;
+
+		std::sort( vecSamplesMs.begin(), vecSamplesMs.end() );
+		auto Percentile = [ &vecSamplesMs ]( float fPercentile ) { return vecSamplesMs[ static_cast< size_t >( fPercentile * ( vecSamplesMs.size() - 1 ) + 0.5f ) ]; };
+
+		stats.fLatencyP50Ms = Percentile( 0.50f );
+		stats.fLatencyP95Ms = Percentile( 0.95f );
+		stats.fLatencyP99Ms = Percentile( 0.99f );
+		stats.fLatencyMaxMs = vecSamplesMs.back();
+
+		return stats;
+	}
+
 	const char *Input::GetCurrentInteractionProfile( const char *sUserPath )
 	{
 		XrPath xrPath;
@@ -473,17 +962,15 @@ namespace oxr
 		XrInteractionProfileState xrInteractionProfileState { XR_TYPE_INTERACTION_PROFILE_STATE };
 		xrResult = xrGetCurrentInteractionProfile( m_pSession->GetXrSession(), xrPath, &xrInteractionProfileState );
 
-		if ( !XR_UNQUALIFIED_SUCCESS( xrResult ) )
+		if ( !XR_UNQUALIFIED_SUCCESS( xrResult ) || xrInteractionProfileState.interactionProfile == XR_NULL_PATH )
 			return "";
 
-		std::string sInteractionProfile;
-		xrResult = XrPathToString( sInteractionProfile, &xrInteractionProfileState.interactionProfile );
-
-		if ( !XR_UNQUALIFIED_SUCCESS( xrResult ) )
-			return "";
+		// Interned strings are null terminated and owned by the path table, so the pointer outlives this call
+		std::string_view sInteractionProfile = m_PathTable.PathToString( xrInteractionProfileState.interactionProfile );
+		const char *pccInteractionProfile = sInteractionProfile.empty() ? "" : sInteractionProfile.data();
 
-		LogInfo( LOG_CATEGORY_INPUT, "Current interaction profile (%s) : %s", sUserPath, sInteractionProfile.c_str() );
-		return sInteractionProfile.c_str();
+		LogInfo( LOG_CATEGORY_INPUT, "Current interaction profile (%s) : %s", sUserPath, pccInteractionProfile );
+		return pccInteractionProfile;
 	}
 
 	XrResult Input::GenerateHaptic(
@@ -25,32 +25,125 @@
 
 namespace oxr
 {
+	namespace
+	{
+		// Whether a path is well formed per the openxr path rules: /component[/component...] with components made of
+		// lowercase letters, digits, '-', '_' and '.', and not consisting of dots only
+		bool IsWellFormedPath( std::string_view sPath )
+		{
+			if ( sPath.size() < 2 || sPath.front() != '/' || sPath.back() == '/' )
+				return false;
+
+			bool bComponentHasNonDot = false;
+			for ( size_t i = 1; i < sPath.size(); i++ )
+			{
+				const char c = sPath[ i ];
+				if ( c == '/' )
+				{
+					if ( !bComponentHasNonDot )
+						return false;
+
+					bComponentHasNonDot = false;
+				}
+				else if ( ( c >= 'a' && c <= 'z' ) || ( c >= '0' && c <= '9' ) || c == '-' || c == '_' )
+				{
+					bComponentHasNonDot = true;
+				}
+				else if ( c != '.' )
+				{
+					return false;
+				}
+			}
+
+			return bComponentHasNonDot;
+		}
+	} // namespace
+
 	XrResult Controller::AddBinding( XrInstance xrInstance, XrAction action, std::string sFullBindingPath )
 	{
-		// Convert binding to path
-		XrPath xrPath = XR_NULL_PATH;
-		XrResult xrResult = xrStringToPath( xrInstance, sFullBindingPath.c_str(), &xrPath );
-		if ( !XR_UNQUALIFIED_SUCCESS( xrResult ) )
+		return AddPendingBinding( action, BindingPathBuilder( sFullBindingPath.c_str() ) );
+	}
+
+	XrResult Controller::AddPendingBinding( XrAction action, const BindingPathBuilder &bindingPath )
+	{
+		if ( bindingPath.overflowed() )
 		{
-			LogError( LOG_CATEGORY_INPUT, "Error adding binding path [%s]: (%s) for: (%s)", XrEnumToString( xrResult ), sFullBindingPath.c_str(), Path() );
-			return xrResult;
+			LogError( LOG_CATEGORY_INPUT, "Error adding binding path, path too long: (%s...) for: (%s)", bindingPath.c_str(), Path() );
+			return XR_ERROR_PATH_FORMAT_INVALID;
 		}
 
-		XrActionSuggestedBinding suggestedBinding {};
-		suggestedBinding.action = action;
-		suggestedBinding.binding = xrPath;
+		// Conversion is deferred to SuggestControllerBindings, so reject malformed paths here where the caller can still act on the error
+		if ( !IsWellFormedPath( bindingPath.view() ) )
+		{
+			LogError( LOG_CATEGORY_INPUT, "Error adding binding path, path is malformed: (%s) for: (%s)", bindingPath.c_str(), Path() );
+			return XR_ERROR_PATH_FORMAT_INVALID;
+		}
 
-		vecSuggestedBindings.push_back( suggestedBinding );
+		vecPendingBindings.push_back( { action, bindingPath } );
 
-		LogInfo( LOG_CATEGORY_INPUT, "Added binding path: (%s) for: (%s)", sFullBindingPath.c_str(), Path() );
+		LogInfo( LOG_CATEGORY_INPUT, "Added binding path: (%s) for: (%s)", bindingPath.c_str(), Path() );
 		return XR_SUCCESS;
 	}
 
+	XrResult Controller::ResolvePendingBindings( XrInstance xrInstance )
+	{
+		if ( vecPendingBindings.empty() )
+			return XR_SUCCESS;
+
+		// (1) Convert all pending binding paths in one batch - through the path table if available
+		std::vector< std::string_view > vecPaths;
+		vecPaths.reserve( vecPendingBindings.size() );
+		for ( auto &pendingBinding : vecPendingBindings )
+			vecPaths.push_back( pendingBinding.bindingPath.view() );
+
+		std::vector< XrPath > vecXrPaths( vecPaths.size(), XR_NULL_PATH );
+		XrResult xrResult = XR_SUCCESS;
+
+		if ( pPathTable )
+		{
+			xrResult = pPathTable->StringsToPaths( vecPaths.data(), static_cast< uint32_t >( vecPaths.size() ), vecXrPaths.data() );
+		}
+		else
+		{
+			for ( size_t i = 0; i < vecPendingBindings.size(); i++ )
+			{
+				XrResult xrPathResult = xrStringToPath( xrInstance, vecPendingBindings[ i ].bindingPath.c_str(), &vecXrPaths[ i ] );
+				if ( !XR_UNQUALIFIED_SUCCESS( xrPathResult ) )
+				{
+					vecXrPaths[ i ] = XR_NULL_PATH;
+					xrResult = xrPathResult;
+				}
+			}
+		}
+
+		// (2) Add the converted bindings, skipping any the runtime rejected
+		for ( size_t i = 0; i < vecPendingBindings.size(); i++ )
+		{
+			if ( vecXrPaths[ i ] == XR_NULL_PATH )
+			{
+				LogError( LOG_CATEGORY_INPUT, "Error adding binding path: (%s) for: (%s)", vecPendingBindings[ i ].bindingPath.c_str(), Path() );
+				continue;
+			}
+
+			XrActionSuggestedBinding suggestedBinding {};
+			suggestedBinding.action = vecPendingBindings[ i ].action;
+			suggestedBinding.binding = vecXrPaths[ i ];
+
+			vecSuggestedBindings.push_back( suggestedBinding );
+		}
+
+		vecPendingBindings.clear();
+		return xrResult;
+	}
+
 	XrResult Controller::SuggestControllerBindings( XrInstance xrInstance, void *pOtherInfo )
 	{
+		// Convert pending binding paths - bindings that fail to convert are logged, skipped and their error returned after the rest are suggested
+		XrResult xrResolveResult = ResolvePendingBindings( xrInstance );
+
 		// Convert interaction profile path to an xrpath
 		XrPath xrPath = XR_NULL_PATH;
-		XrResult xrResult = xrStringToPath( xrInstance, Path(), &xrPath );
+		XrResult xrResult = pPathTable ? pPathTable->StringToPath( Path(), &xrPath ) : xrStringToPath( xrInstance, Path(), &xrPath );
 		if ( !XR_UNQUALIFIED_SUCCESS( xrResult ) )
 		{
 			LogError( LOG_CATEGORY_INPUT, "Error converting interaction profile to an xrpath (%s): %s", XrEnumToString( xrResult ), Path() );
@@ -71,12 +164,12 @@ namespace oxr
 		}
 
 		LogInfo( LOG_CATEGORY_INPUT, "All action bindings sent to runtime for: (%s)", Path() );
-		return xrResult;
+		return XR_UNQUALIFIED_SUCCESS( xrResult ) ? xrResolveResult : xrResult;
 	}
 
 	XrResult ValveIndex::AddBinding( XrInstance xrInstance, XrAction action, XrHandEXT hand, Controller::Component component, Controller::Qualifier qualifier )
 	{
-		std::string sBinding = ( hand == XR_HAND_LEFT_EXT ) ? k_pccLeftHand : k_pccRightHand;
+		BindingPathBuilder sBinding( ( hand == XR_HAND_LEFT_EXT ) ? k_pccLeftHand : k_pccRightHand );
 		sBinding += ( component == Controller::Component::Haptic ) ? k_pccOutput : k_pccInput;
 
 		// Map requested binding configuration for this controller
@@ -163,28 +256,13 @@ namespace oxr
 			return XR_SUCCESS;
 		}
 
-		// Convert binding to path
-		XrPath xrPath = XR_NULL_PATH;
-		XrResult xrResult = xrStringToPath( xrInstance, sBinding.c_str(), &xrPath );
-		if ( !XR_UNQUALIFIED_SUCCESS( xrResult ) )
-		{
-			LogError( LOG_CATEGORY_INPUT, "Error adding binding path [%s]: (%s) for: (%s)", XrEnumToString( xrResult ), sBinding.c_str(), Path() );
-			return xrResult;
-		}
-
-		XrActionSuggestedBinding suggestedBinding {};
-		suggestedBinding.action = action;
-		suggestedBinding.binding = xrPath;
-
-		vecSuggestedBindings.push_back( suggestedBinding );
-
-		LogInfo( LOG_CATEGORY_INPUT, "Added binding path: (%s) for: (%s)", sBinding.c_str(), Path() );
-		return XR_SUCCESS;
+		// Binding paths are resolved in one batch when bindings are suggested
+		return AddPendingBinding( action, sBinding );
 	}
 
 	XrResult OculusTouch::AddBinding( XrInstance xrInstance, XrAction action, XrHandEXT hand, Controller::Component component, Controller::Qualifier qualifier )
 	{
-		std::string sBinding = ( hand == XR_HAND_LEFT_EXT ) ? k_pccLeftHand : k_pccRightHand;
+		BindingPathBuilder sBinding( ( hand == XR_HAND_LEFT_EXT ) ? k_pccLeftHand : k_pccRightHand );
 		sBinding += ( component == Controller::Component::Haptic ) ? k_pccOutput : k_pccInput;
 
 		// Map requested binding configuration for this controller
@@ -283,28 +361,13 @@ namespace oxr
 			return XR_SUCCESS;
 		}
 
-		// Convert binding to path
-		XrPath xrPath = XR_NULL_PATH;
-		XrResult xrResult = xrStringToPath( xrInstance, sBinding.c_str(), &xrPath );
-		if ( !XR_UNQUALIFIED_SUCCESS( xrResult ) )
-		{
-			LogError( LOG_CATEGORY_INPUT, "Error adding binding path [%s]: (%s) for: (%s)", XrEnumToString( xrResult ), sBinding.c_str(), Path() );
-			return xrResult;
-		}
-
-		XrActionSuggestedBinding suggestedBinding {};
-		suggestedBinding.action = action;
-		suggestedBinding.binding = xrPath;
-
-		vecSuggestedBindings.push_back( suggestedBinding );
-
-		LogInfo( LOG_CATEGORY_INPUT, "Added binding path: (%s) for: (%s)", sBinding.c_str(), Path() );
-		return XR_SUCCESS;
+		// Binding paths are resolved in one batch when bindings are suggested
+		return AddPendingBinding( action, sBinding );
 	}
 
 	XrResult HTCVive::AddBinding( XrInstance xrInstance, XrAction action, XrHandEXT hand, Controller::Component component, Controller::Qualifier qualifier )
 	{
-		std::string sBinding = ( hand == XR_HAND_LEFT_EXT ) ? k_pccLeftHand : k_pccRightHand;
+		BindingPathBuilder sBinding( ( hand == XR_HAND_LEFT_EXT ) ? k_pccLeftHand : k_pccRightHand );
 		sBinding += ( component == Controller::Component::Haptic ) ? k_pccOutput : k_pccInput;
 
 		// Map requested binding configuration for this controller
@@ -372,28 +435,13 @@ namespace oxr
 			return XR_SUCCESS;
 		}
 
-		// Convert binding to path
-		XrPath xrPath = XR_NULL_PATH;
-		XrResult xrResult = xrStringToPath( xrInstance, sBinding.c_str(), &xrPath );
-		if ( !XR_UNQUALIFIED_SUCCESS( xrResult ) )
-		{
-			LogError( LOG_CATEGORY_INPUT, "Error adding binding path [%s]: (%s) for: (%s)", XrEnumToString( xrResult ), sBinding.c_str(), Path() );
-			return xrResult;
-		}
-
-		XrActionSuggestedBinding suggestedBinding {};
-		suggestedBinding.action = action;
-		suggestedBinding.binding = xrPath;
-
-		vecSuggestedBindings.push_back( suggestedBinding );
-
-		LogInfo( LOG_CATEGORY_INPUT, "Added binding path: (%s) for: (%s)", sBinding.c_str(), Path() );
-		return XR_SUCCESS;
+		// Binding paths are resolved in one batch when bindings are suggested
+		return AddPendingBinding( action, sBinding );
 	}
 
 	XrResult MicrosoftMixedReality::AddBinding( XrInstance xrInstance, XrAction action, XrHandEXT hand, Controller::Component component, Controller::Qualifier qualifier )
 	{
-		std::string sBinding = ( hand == XR_HAND_LEFT_EXT ) ? k_pccLeftHand : k_pccRightHand;
+		BindingPathBuilder sBinding( ( hand == XR_HAND_LEFT_EXT ) ? k_pccLeftHand : k_pccRightHand );
 		sBinding += ( component == Controller::Component::Haptic ) ? k_pccOutput : k_pccInput;
 
 		// Map requested binding configuration for this controller
@@ -454,22 +502,7 @@ namespace oxr
 			return XR_SUCCESS;
 		}
 
-		// Convert binding to path
-		XrPath xrPath = XR_NULL_PATH;
-		XrResult xrResult = xrStringToPath( xrInstance, sBinding.c_str(), &xrPath );
-		if ( !XR_UNQUALIFIED_SUCCESS( xrResult ) )
-		{
-			LogError( LOG_CATEGORY_INPUT, "Error adding binding path [%s]: (%s) for: (%s)", XrEnumToString( xrResult ), sBinding.c_str(), Path() );
-			return xrResult;
-		}
-
-		XrActionSuggestedBinding suggestedBinding {};
-		suggestedBinding.action = action;
-		suggestedBinding.binding = xrPath;
-
-		vecSuggestedBindings.push_back( suggestedBinding );
-
-		LogInfo( LOG_CATEGORY_INPUT, "Added binding path: (%s) for: (%s)", sBinding.c_str(), Path() );
-		return XR_SUCCESS;
+		// Binding paths are resolved in one batch when bindings are suggested
+		return AddPendingBinding( action, sBinding );
 	}
 } // namespace oxr
@@ -0,0 +1,146 @@
+/* Copyright 2021, 2022, 2023 Rune Berg (GitHub: https://github.com/1runeberg, Twitter: https://twitter.com/1runeberg, YouTube: https://www.youtube.com/@1RuneBerg)
+ *
+ *  SPDX-License-Identifier: MIT
+ *
+ *  Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+ *
+ *  2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *
+ *  3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote products derived from this
+ *     software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ *  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+ *  BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ *  GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+ *  DAMAGE.
+ *
+ */
+
+#include <provider/interaction_profiles.hpp>
+
+namespace oxr
+{
+	void PathTable::Init( XrInstance xrInstance )
+	{
+		std::lock_guard< std::mutex > lock( m_mutexPaths );
+
+		// Paths from another instance are meaningless
+		if ( m_xrInstance != xrInstance )
+		{
+			m_mapStringToPath.clear();
+			m_mapPathToString.clear();
+			m_deqStrings.clear();
+		}
+
+		m_xrInstance = xrInstance;
+	}
+
+	XrResult PathTable::StringToPath( std::string_view sPath, XrPath *outPath )
+	{
+		assert( outPath );
+
+		std::lock_guard< std::mutex > lock( m_mutexPaths );
+		return StringToPathLocked( sPath, outPath );
+	}
+
+	XrResult PathTable::StringsToPaths( const std::string_view *pPaths, uint32_t unCount, XrPath *outPaths )
+	{
+		assert( outPaths );
+
+		XrResult xrFirstError = XR_SUCCESS;
+		std::lock_guard< std::mutex > lock( m_mutexPaths );
+
+		for ( uint32_t i = 0; i < unCount; i++ )
+		{
+			XrResult xrResult = StringToPathLocked( pPaths[ i ], &outPaths[ i ] );
+
+			if ( !XR_UNQUALIFIED_SUCCESS( xrResult ) )
+			{
+				outPaths[ i ] = XR_NULL_PATH;
+
+				if ( XR_UNQUALIFIED_SUCCESS( xrFirstError ) )
+					xrFirstError = xrResult;
+			}
+		}
+
+		return xrFirstError;
+	}
+
+	std::string_view PathTable::PathToString( XrPath xrPath )
+	{
+		std::lock_guard< std::mutex > lock( m_mutexPaths );
+
+		// (1) Return the interned string if this path has been seen before
+		auto it = m_mapPathToString.find( xrPath );
+		if ( it != m_mapPathToString.end() )
+			return it->second;
+
+		// (2) Otherwise ask the runtime and intern the result
+		uint32_t unCount = 0;
+		char sPath[ XR_MAX_PATH_LENGTH ];
+		XrResult xrResult = xrPathToString( m_xrInstance, xrPath, sizeof( sPath ), &unCount, sPath );
+
+		if ( !XR_UNQUALIFIED_SUCCESS( xrResult ) )
+		{
+			LogError( LOG_CATEGORY_INPUT, "Unable to convert XrPath: %" PRIu64 " to a readable string: %s", xrPath, XrEnumToString( xrResult ) );
+			return std::string_view();
+		}
+
+		return Intern( sPath, xrPath );
+	}
+
+	size_t PathTable::Size()
+	{
+		std::lock_guard< std::mutex > lock( m_mutexPaths );
+		return m_mapPathToString.size();
+	}
+
+	XrResult PathTable::StringToPathLocked( std::string_view sPath, XrPath *outPath )
+	{
+		// (1) Hashed lookup, no allocations
+		auto it = m_mapStringToPath.find( sPath );
+		if ( it != m_mapStringToPath.end() )
+		{
+			*outPath = it->second;
+			return XR_SUCCESS;
+		}
+
+		// (2) First time this string is seen, convert with the runtime (needs a null terminated copy) and intern
+		std::string sPathCopy( sPath );
+		XrResult xrResult = xrStringToPath( m_xrInstance, sPathCopy.c_str(), outPath );
+
+		if ( !XR_UNQUALIFIED_SUCCESS( xrResult ) )
+		{
+			LogError( LOG_CATEGORY_INPUT, "Unable to convert %s to an XrPath: %s", sPathCopy.c_str(), XrEnumToString( xrResult ) );
+			return xrResult;
+		}
+
+		Intern( std::move( sPathCopy ), *outPath );
+		return XR_SUCCESS;
+	}
+
+	std::string_view PathTable::Intern( std::string sPath, XrPath xrPath )
+	{
+		// Paths are unique per string, so a path seen before already has its string interned
+		auto it = m_mapPathToString.find( xrPath );
+		if ( it != m_mapPathToString.end() )
+		{
+			m_mapStringToPath.emplace( it->second, xrPath );
+			return it->second;
+		}
+
+		m_deqStrings.push_back( std::move( sPath ) );
+		std::string_view sInterned( m_deqStrings.back() );
+
+		m_mapStringToPath.emplace( sInterned, xrPath );
+		m_mapPathToString.emplace( xrPath, sInterned );
+
+		return sInterned;
+	}
+
+} // namespace oxr
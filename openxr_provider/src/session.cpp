@@ -98,6 +98,7 @@ namespace oxr
 			if ( !XR_UNQUALIFIED_SUCCESS( xrResult ) )
 				return xrResult;
 
+			AddReferenceSpace( m_xrReferenceSpace );
 			oxr::LogDebug( m_sLogCategory, "Reference space of type (%s) created with handle (%" PRIu64 ").", XrEnumToString( xrRefSpaceType ), ( uint64_t )m_xrReferenceSpace );
 
 			// Create app space
@@ -108,6 +109,7 @@ namespace oxr
 			if ( !XR_UNQUALIFIED_SUCCESS( xrResult ) )
 				return xrResult;
 
+			AddReferenceSpace( m_xrAppSpace );
 			oxr::LogDebug( m_sLogCategory, "App Reference space of type (%s) created with handle (%" PRIu64 ").", XrEnumToString( xrRefSpaceType ), ( uint64_t )m_xrReferenceSpace );
 		}
 
@@ -212,6 +214,7 @@ namespace oxr
 
 		if ( XR_UNQUALIFIED_SUCCESS( xrResult ) )
 		{
+			AddReferenceSpace( *outSpace );
 			oxr::LogDebug( m_sLogCategory, "Reference space created of type (%s) Handle (%" PRIu64 ")", XrEnumToString( xrReferenceSpaceType ), ( uint64_t )*outSpace );
 		}
 
@@ -220,7 +223,82 @@ namespace oxr
 
 	XrResult Session::LocateSpace( XrSpace baseSpace, XrSpace targetSpace, XrTime predictedDisplayTime, XrSpaceLocation *outSpaceLocation )
 	{
-		return xrLocateSpace( targetSpace, baseSpace, predictedDisplayTime, outSpaceLocation );
+		// (1) Extension chains can't be served from the cache
+		if ( outSpaceLocation->next != nullptr )
+		{
+			m_unLocateCalls.fetch_add( 1, std::memory_order_relaxed );
+			return xrLocateSpace( targetSpace, baseSpace, predictedDisplayTime, outSpaceLocation );
+		}
+
+		// (2) Return the cached location if this space was already located for this time
+		uint64_t unCacheGeneration = 0;
+		uint64_t unActionSpaceGeneration = 0;
+		{
+			std::lock_guard< std::mutex > lock( m_mutexSpaceLocationCache );
+			for ( auto &entry : m_vecSpaceLocationCache )
+			{
+				if ( entry.targetSpace == targetSpace && entry.baseSpace == baseSpace && entry.xrTime == predictedDisplayTime )
+				{
+					*outSpaceLocation = entry.xrSpaceLocation;
+					return XR_SUCCESS;
+				}
+			}
+
+			unCacheGeneration = m_unSpaceLocationCacheGeneration;
+			unActionSpaceGeneration = m_unActionSpaceCacheGeneration;
+		}
+
+		// (3) Locate outside the lock, so the render and input threads don't wait on each other's runtime calls
+		m_unLocateCalls.fetch_add( 1, std::memory_order_relaxed );
+		XrResult xrResult = xrLocateSpace( targetSpace, baseSpace, predictedDisplayTime, outSpaceLocation );
+
+		if ( !XR_UNQUALIFIED_SUCCESS( xrResult ) )
+			return xrResult;
+
+		// (4) Cache the result, unless the cache was invalidated while locating or another thread already cached the same location
+		std::lock_guard< std::mutex > lock( m_mutexSpaceLocationCache );
+		if ( unCacheGeneration != m_unSpaceLocationCacheGeneration )
+			return xrResult;
+
+		bool bReferenceSpaces = IsReferenceSpace( baseSpace ) && IsReferenceSpace( targetSpace );
+		if ( !bReferenceSpaces && unActionSpaceGeneration != m_unActionSpaceCacheGeneration )
+			return xrResult;
+
+		for ( auto &entry : m_vecSpaceLocationCache )
+		{
+			if ( entry.targetSpace == targetSpace && entry.baseSpace == baseSpace && entry.xrTime == predictedDisplayTime )
+				return xrResult;
+		}
+
+		m_vecSpaceLocationCache.push_back( { baseSpace, targetSpace, predictedDisplayTime, *outSpaceLocation, bReferenceSpaces } );
+		return xrResult;
+	}
+
+	void Session::InvalidateSpaceLocationCache()
+	{
+		std::lock_guard< std::mutex > lock( m_mutexSpaceLocationCache );
+		m_vecSpaceLocationCache.clear();
+		m_unSpaceLocationCacheGeneration++;
+		m_unActionSpaceCacheGeneration++;
+	}
+
+	void Session::InvalidateActionSpaceLocations()
+	{
+		std::lock_guard< std::mutex > lock( m_mutexSpaceLocationCache );
+		auto end = std::remove_if( m_vecSpaceLocationCache.begin(), m_vecSpaceLocationCache.end(), []( const SpaceLocationCacheEntry &entry ) { return !entry.bReferenceSpaces; } );
+		m_vecSpaceLocationCache.erase( end, m_vecSpaceLocationCache.end() );
+		m_unActionSpaceCacheGeneration++;
+	}
+
+	void Session::AddReferenceSpace( XrSpace xrSpace )
+	{
+		std::lock_guard< std::mutex > lock( m_mutexSpaceLocationCache );
+		m_vecReferenceSpaces.push_back( xrSpace );
+	}
+
+	bool Session::IsReferenceSpace( XrSpace xrSpace ) const
+	{
+		return std::find( m_vecReferenceSpaces.begin(), m_vecReferenceSpaces.end(), xrSpace ) != m_vecReferenceSpaces.end();
 	}
 
 	XrResult Session::LocateReferenceSpace( XrTime predictedDisplayTime, XrSpaceLocation *outSpaceLocation )
@@ -474,6 +552,7 @@ namespace oxr
 
 			providerSwapchain.unWidth = unWidth == 0 ? m_vecConfigViews[ i ].recommendedImageRectWidth : unWidth;
 			providerSwapchain.unHeight = unHeight == 0 ? m_vecConfigViews[ i ].recommendedImageRectHeight : unHeight;
+			providerSwapchain.unArraySize = unArraysize;
 
 			// (5) Set general openxr swapchain info
 			XrSwapchainCreateInfo xrSwapchainCreateInfo { XR_TYPE_SWAPCHAIN_CREATE_INFO };
@@ -573,149 +652,553 @@ namespace oxr
 		if ( m_xrSession == XR_NULL_HANDLE || m_vecSwapchains.empty() )
 			return;
 
-		// (1) Wait for a new frame
-		XrFrameWaitInfo xrWaitFrameInfo { XR_TYPE_FRAME_WAIT_INFO };
+		// (1) Wait for and begin a new frame before doing any GPU work
+		if ( !BeginNextFrame( pFrameState ) )
+			return;
+
+		// (2) Render views to the swapchain images and add the projection layer
+		XrCompositionLayerProjection xrFrameLayerProjection { XR_TYPE_COMPOSITION_LAYER_PROJECTION };
+
+		if ( pFrameState->shouldRender &&
+			 RenderProjectionViews( &xrFrameLayerProjection, vecFrameLayerProjectionViews, pFrameState, xrCompositionLayerFlags, xrRectOffset, xrRectExtent, bIsarray, unArrayIndex ) )
+		{
+			vecFrameLayers.push_back( reinterpret_cast< XrCompositionLayerBaseHeader * >( &xrFrameLayerProjection ) );
+		}
+
+		// (3) End current frame
+		XrFrameEndInfo xrEndFrameInfo { XR_TYPE_FRAME_END_INFO };
+		xrEndFrameInfo.displayTime = pFrameState->predictedDisplayTime;
+		xrEndFrameInfo.environmentBlendMode = xrEnvironmentBlendMode;
+		xrEndFrameInfo.layerCount = ( uint32_t )vecFrameLayers.size();
+		xrEndFrameInfo.layers = vecFrameLayers.data();
+
+		EndFrame( &xrEndFrameInfo );
+	}
+
+	bool Session::RenderProjectionViews(
+		XrCompositionLayerProjection *outFrameLayerProjection,
+		std::vector< XrCompositionLayerProjectionView > &vecFrameLayerProjectionViews,
+		XrFrameState *pFrameState,
+		XrCompositionLayerFlags xrCompositionLayerFlags,
+		XrOffset2Di xrRectOffset,
+		XrExtent2Di xrRectExtent,
+		bool bIsarray,
+		uint32_t unArrayIndex )
+	{
+		XrResult xrResult = XR_SUCCESS;
+
+		// (1) Get space and time information for this frame
+		XrViewLocateInfo xrFrameSpaceTimeInfo { XR_TYPE_VIEW_LOCATE_INFO };
+		xrFrameSpaceTimeInfo.displayTime = pFrameState->predictedDisplayTime;
+		xrFrameSpaceTimeInfo.space = m_xrReferenceSpace;
+		xrFrameSpaceTimeInfo.viewConfigurationType = m_xrViewConfigurationType;
+
+		XrViewState xrFrameViewState { XR_TYPE_VIEW_STATE };
+		uint32_t nFoundViewsCount;
+		xrResult = xrLocateViews( m_xrSession, &xrFrameSpaceTimeInfo, &xrFrameViewState, ( uint32_t )m_vecViews.size(), &nFoundViewsCount, m_vecViews.data() );
+		if ( xrResult != XR_SUCCESS )
+		{
+			return false;
+		}
+
+		// (2) Grab images from swapchain and render - must at least have orientation tracking
+		if ( ( xrFrameViewState.viewStateFlags & XR_VIEW_STATE_ORIENTATION_VALID_BIT ) == 0 )
+			return false;
+
+		for ( uint32_t i = 0; i < m_vecSwapchains.size(); i++ )
+		{
+			// (2.1) Acquire swapchain image
+			const XrSwapchain xrSwapchain = m_vecSwapchains[ i ].xrColorSwapchain;
+			XrSwapchainImageAcquireInfo xrAcquireInfo { XR_TYPE_SWAPCHAIN_IMAGE_ACQUIRE_INFO };
+			uint32_t unImageIndex;
+			m_FrameTiming.MarkBegin( EFrameStage::AcquireImage, i );
+			if ( xrAcquireSwapchainImage( xrSwapchain, &xrAcquireInfo, &unImageIndex ) != XR_SUCCESS )
+				return false;
+			m_FrameTiming.MarkEnd( EFrameStage::AcquireImage, i );
+
+			// (2.2) Let apps build command buffers via their registered callbacks
+			ExecuteRenderImageCallbacks( m_vecAcquireSwapchainImageCallbacks, i, unImageIndex );
+
+			// (2.3) Wait for swapchain image
+			XrSwapchainImageWaitInfo xrWaitInfo { XR_TYPE_SWAPCHAIN_IMAGE_WAIT_INFO };
+			xrWaitInfo.timeout = XR_INFINITE_DURATION;
+			m_FrameTiming.MarkBegin( EFrameStage::WaitImage, i );
+			if ( xrWaitSwapchainImage( xrSwapchain, &xrWaitInfo ) != XR_SUCCESS )
+				return false;
+			m_FrameTiming.MarkEnd( EFrameStage::WaitImage, i );
+
+			// (2.4) Add projection view(s) to swapchain image - a multiview swapchain holds one view per array layer
+			const bool bIsMultiview = IsMultiviewSwapchain( i );
+			const uint32_t unViewsNum = bIsMultiview ? ( uint32_t )m_vecViews.size() : 1;
+
+			if ( vecFrameLayerProjectionViews.size() < i + unViewsNum )
+				vecFrameLayerProjectionViews.resize( i + unViewsNum, { XR_TYPE_COMPOSITION_LAYER_PROJECTION_VIEW } );
+
+			if ( m_vecDepthInfos.size() < vecFrameLayerProjectionViews.size() )
+				m_vecDepthInfos.resize( vecFrameLayerProjectionViews.size(), { XR_TYPE_COMPOSITION_LAYER_DEPTH_INFO_KHR } );
+
+			for ( uint32_t v = i; v < i + unViewsNum; v++ )
+			{
+				vecFrameLayerProjectionViews[ v ] = { XR_TYPE_COMPOSITION_LAYER_PROJECTION_VIEW };
+				vecFrameLayerProjectionViews[ v ].pose = m_vecViews[ v ].pose;
+				vecFrameLayerProjectionViews[ v ].fov = m_vecViews[ v ].fov;
+				vecFrameLayerProjectionViews[ v ].subImage.swapchain = xrSwapchain;
+				vecFrameLayerProjectionViews[ v ].subImage.imageArrayIndex = bIsMultiview ? v - i : ( bIsarray ? unArrayIndex : 0 );
+				vecFrameLayerProjectionViews[ v ].subImage.imageRect.offset = xrRectOffset;
+				vecFrameLayerProjectionViews[ v ].subImage.imageRect.extent = {
+					xrRectExtent.width == 0 ? m_vecSwapchains[ i ].unWidth : xrRectExtent.width, xrRectExtent.height == 0 ? m_vecSwapchains[ i ].unHeight : xrRectExtent.height };
+
+				// (2.5) Depth handling
+				if ( m_bDepthHandling )
+				{
+					XrCompositionLayerDepthInfoKHR *pDepthInfo = &m_vecDepthInfos[ v ];
+					*pDepthInfo = { XR_TYPE_COMPOSITION_LAYER_DEPTH_INFO_KHR };
+					pDepthInfo->subImage.swapchain = m_vecSwapchains[ i ].xrDepthSwapchain;
+					pDepthInfo->subImage.imageArrayIndex = vecFrameLayerProjectionViews[ v ].subImage.imageArrayIndex;
+					pDepthInfo->subImage.imageRect.offset = { 0, 0 };
+					pDepthInfo->subImage.imageRect.extent = vecFrameLayerProjectionViews[ v ].subImage.imageRect.extent;
+					pDepthInfo->minDepth = 0.0f;
+					pDepthInfo->maxDepth = 1.0f;
+					pDepthInfo->nearZ = 0.1f;
+					pDepthInfo->farZ = FLT_MAX;
+
+					vecFrameLayerProjectionViews[ v ].next = pDepthInfo;
+				}
+			}
+
+			// (2.6) Let apps render to textures via their registered callbacks
+			ExecuteRenderImageCallbacks( m_vecWaitSwapchainImageCallbacks, i, unImageIndex );
+
+			// (2.7) Release swapchain image
+			XrSwapchainImageReleaseInfo xrSwapChainRleaseInfo { XR_TYPE_SWAPCHAIN_IMAGE_RELEASE_INFO };
+			m_FrameTiming.MarkBegin( EFrameStage::ReleaseImage, i );
+			if ( xrReleaseSwapchainImage( xrSwapchain, &xrSwapChainRleaseInfo ) != XR_SUCCESS )
+				return false;
+			m_FrameTiming.MarkEnd( EFrameStage::ReleaseImage, i );
 
-		if ( xrWaitFrame( m_xrSession, &xrWaitFrameInfo, pFrameState ) != XR_SUCCESS )
+			// (2.8) Let apps do any internal cleanups via their registered callbacks
+			ExecuteRenderImageCallbacks( m_vecReleaseSwapchainImageCallbacks, i, unImageIndex );
+		}
+
+		// (3) Assemble projection layer
+		outFrameLayerProjection->space = m_xrAppSpace;
+		outFrameLayerProjection->layerFlags = xrCompositionLayerFlags;
+		outFrameLayerProjection->viewCount = ( uint32_t )vecFrameLayerProjectionViews.size();
+		outFrameLayerProjection->views = vecFrameLayerProjectionViews.data();
+
+		return true;
+	}
+
+	void Session::RenderHeadlessFrame( XrFrameState *pFrameState )
+	{
+		// Check if there's a valid session and swapchains to work with
+		if ( m_xrSession == XR_NULL_HANDLE )
+			return;
+
+		// (1) Wait for and begin a new frame
+		if ( !BeginNextFrame( pFrameState ) )
 			return;
 
-		// Cache predicted time and period
+		// (2) End current frame
+		XrFrameEndInfo xrEndFrameInfo { XR_TYPE_FRAME_END_INFO };
+		xrEndFrameInfo.displayTime = pFrameState->predictedDisplayTime;
+		xrEndFrameInfo.environmentBlendMode = XR_ENVIRONMENT_BLEND_MODE_OPAQUE;
+		xrEndFrameInfo.layerCount = 0;
+
+		EndFrame( &xrEndFrameInfo );
+	}
+
+	bool Session::BeginNextFrame( XrFrameState *pFrameState )
+	{
+		const bool bTiming = m_FrameTiming.IsEnabled();
+		FrameStageTime waitFrameTime, beginFrameTime;
+
+		if ( m_bFramePacingActive )
+		{
+			// (1) Take the next frame begun by the frame pacing thread
+			FrameTicket frameTicket;
+			{
+				std::unique_lock< std::mutex > lock( m_mutexFrameTickets );
+				m_cvFrameTickets.wait( lock, [ this ] { return !m_deqFrameTickets.empty() || !m_bFramePacingActive; } );
+
+				if ( m_deqFrameTickets.empty() )
+					return false;
+
+				frameTicket = m_deqFrameTickets.front();
+				m_deqFrameTickets.pop_front();
+			}
+
+			*pFrameState = frameTicket.xrFrameState;
+			waitFrameTime = frameTicket.waitFrameTime;
+			beginFrameTime = frameTicket.beginFrameTime;
+
+			if ( !XR_SUCCEEDED( frameTicket.xrBeginFrameResult ) )
+				return false;
+		}
+		else
+		{
+			// (1) Wait for a new frame - unless frame pacing stopped after waiting for one it couldn't begin
+			FrameTicket waitedFrame;
+			if ( TakeWaitedFrame( &waitedFrame ) )
+			{
+				*pFrameState = waitedFrame.xrFrameState;
+				waitFrameTime = waitedFrame.waitFrameTime;
+			}
+			else
+			{
+				XrFrameWaitInfo xrWaitFrameInfo { XR_TYPE_FRAME_WAIT_INFO };
+
+				waitFrameTime.nBeginNs = bTiming ? FrameTiming::Now() : 0;
+				if ( xrWaitFrame( m_xrSession, &xrWaitFrameInfo, pFrameState ) != XR_SUCCESS )
+					return false;
+				waitFrameTime.nEndNs = bTiming ? FrameTiming::Now() : 0;
+			}
+
+			// (2) Begin frame
+			XrFrameBeginInfo xrBeginFrameInfo { XR_TYPE_FRAME_BEGIN_INFO };
+			beginFrameTime.nBeginNs = waitFrameTime.nEndNs;
+			if ( xrBeginFrame( m_xrSession, &xrBeginFrameInfo ) != XR_SUCCESS )
+				return false;
+			beginFrameTime.nEndNs = bTiming ? FrameTiming::Now() : 0;
+		}
+
+		// Cache predicted time and period of the frame being rendered
 		m_xrPredictedDisplayTime = pFrameState->predictedDisplayTime;
 		m_xrPredictedDisplayPeriod = pFrameState->predictedDisplayPeriod;
 
-		// (2) Begin frame before doing any GPU work
-		XrFrameBeginInfo xrBeginFrameInfo { XR_TYPE_FRAME_BEGIN_INFO };
-		if ( xrBeginFrame( m_xrSession, &xrBeginFrameInfo ) != XR_SUCCESS )
+		// Space locations are only valid for the frame they were made in
+		InvalidateSpaceLocationCache();
+		m_unLastFrameLocateCalls.store( m_unLocateCalls.exchange( 0, std::memory_order_relaxed ), std::memory_order_relaxed );
+
+		// Open this frame's timing record
+		m_FrameTiming.BeginFrame( pFrameState->predictedDisplayTime, pFrameState->predictedDisplayPeriod );
+		m_FrameTiming.SetStage( EFrameStage::WaitFrame, 0, waitFrameTime );
+		m_FrameTiming.SetStage( EFrameStage::BeginFrame, 0, beginFrameTime );
+
+		return true;
+	}
+
+	void Session::EndFrame( XrFrameEndInfo *pFrameEndInfo )
+	{
+		// A frame whose gpu work failed is ended without layers
+		if ( m_bDiscardFrameLayers )
+		{
+			pFrameEndInfo->layerCount = 0;
+			pFrameEndInfo->layers = nullptr;
+			m_bDiscardFrameLayers = false;
+		}
+
+		// (1) Pipelined - hand the frame over to the frame end thread, which ends it once its gpu work completes
+		//     and lets the frame pacing thread begin the next frame. The render thread moves on right away
+		if ( m_bFramePacingActive )
+		{
+			m_FrameTiming.MarkBegin( EFrameStage::EndFrame );
+			CopyPendingFrameEnd( pFrameEndInfo );
+			m_PendingFrameEnd.vecGpuFences.swap( m_vecFrameGpuFences );
+			m_vecFrameGpuFences.clear();
+
+			{
+				std::lock_guard< std::mutex > lock( m_mutexFrameTickets );
+				m_bFrameEndPending = true;
+			}
+
+			m_cvFrameTickets.notify_all();
+			m_FrameTiming.MarkEnd( EFrameStage::EndFrame );
+			m_FrameTiming.EndFrame();
 			return;
+		}
 
-		XrCompositionLayerProjection xrFrameLayerProjection { XR_TYPE_COMPOSITION_LAYER_PROJECTION };
+		// (2) Inline - the runtime gets the frame once its gpu work is done
+		m_FrameTiming.MarkBegin( EFrameStage::EndFrame );
+		WaitForFrameGpuFences( m_vecFrameGpuFences, pFrameEndInfo );
+		m_vecFrameGpuFences.clear();
+		xrEndFrame( m_xrSession, pFrameEndInfo );
+		m_FrameTiming.MarkEnd( EFrameStage::EndFrame );
+		m_FrameTiming.EndFrame();
 
-		if ( pFrameState->shouldRender )
+		// Frame pacing may have stopped on its own while this frame was being rendered
 		{
-			XrResult xrResult = XR_SUCCESS;
+			std::lock_guard< std::mutex > lock( m_mutexFrameTickets );
+			m_bFrameInFlight = false;
+		}
 
-			// (3) Get space and time information for this frame
-			XrViewLocateInfo xrFrameSpaceTimeInfo { XR_TYPE_VIEW_LOCATE_INFO };
-			xrFrameSpaceTimeInfo.displayTime = pFrameState->predictedDisplayTime;
-			xrFrameSpaceTimeInfo.space = m_xrReferenceSpace;
-			xrFrameSpaceTimeInfo.viewConfigurationType = m_xrViewConfigurationType;
+		m_cvFrameTickets.notify_all();
+	}
 
-			XrViewState xrFrameViewState { XR_TYPE_VIEW_STATE };
-			uint32_t nFoundViewsCount;
-			xrResult = xrLocateViews( m_xrSession, &xrFrameSpaceTimeInfo, &xrFrameViewState, ( uint32_t )m_vecViews.size(), &nFoundViewsCount, m_vecViews.data() );
-			if ( xrResult != XR_SUCCESS )
+	void Session::CopyPendingFrameEnd( const XrFrameEndInfo *pFrameEndInfo )
+	{
+		PendingFrameEnd &frameEnd = m_PendingFrameEnd;
+		frameEnd.xrFrameEndInfo = *pFrameEndInfo;
+		frameEnd.vecLayers.assign( pFrameEndInfo->layers, pFrameEndInfo->layers + pFrameEndInfo->layerCount );
+
+		// (1) Size the copies up front so pointers into them stay valid
+		size_t unProjectionLayers = 0;
+		size_t unViews = 0;
+		for ( const XrCompositionLayerBaseHeader *pLayer : frameEnd.vecLayers )
+		{
+			if ( pLayer && pLayer->type == XR_TYPE_COMPOSITION_LAYER_PROJECTION )
 			{
-				return;
+				unProjectionLayers++;
+				unViews += reinterpret_cast< const XrCompositionLayerProjection * >( pLayer )->viewCount;
 			}
+		}
+
+		frameEnd.vecProjectionLayers.clear();
+		frameEnd.vecProjectionViews.clear();
+		frameEnd.vecDepthInfos.clear();
+		frameEnd.vecProjectionLayers.reserve( unProjectionLayers );
+		frameEnd.vecProjectionViews.reserve( unViews );
+		frameEnd.vecDepthInfos.reserve( unViews );
+
+		// (2) Copy projection layers, their views and any depth info chained directly to a view. Other layer types are submitted as is
+		for ( const XrCompositionLayerBaseHeader *&pLayer : frameEnd.vecLayers )
+		{
+			if ( !pLayer || pLayer->type != XR_TYPE_COMPOSITION_LAYER_PROJECTION )
+				continue;
 
-			// (4) Grab images from swapchain and render - must at least have orientation tracking
-			if ( xrFrameViewState.viewStateFlags & XR_VIEW_STATE_ORIENTATION_VALID_BIT )
+			frameEnd.vecProjectionLayers.push_back( *reinterpret_cast< const XrCompositionLayerProjection * >( pLayer ) );
+			XrCompositionLayerProjection &projectionLayer = frameEnd.vecProjectionLayers.back();
+
+			const size_t unFirstView = frameEnd.vecProjectionViews.size();
+			for ( uint32_t v = 0; v < projectionLayer.viewCount; v++ )
 			{
-				for ( uint32_t i = 0; i < m_vecSwapchains.size(); i++ )
+				frameEnd.vecProjectionViews.push_back( projectionLayer.views[ v ] );
+				XrCompositionLayerProjectionView &view = frameEnd.vecProjectionViews.back();
+
+				auto pDepthInfo = reinterpret_cast< const XrCompositionLayerDepthInfoKHR * >( view.next );
+				if ( pDepthInfo && pDepthInfo->type == XR_TYPE_COMPOSITION_LAYER_DEPTH_INFO_KHR )
 				{
-					// (4.1) Acquire swapchain image
-					const XrSwapchain xrSwapchain = m_vecSwapchains[ i ].xrColorSwapchain;
-					XrSwapchainImageAcquireInfo xrAcquireInfo { XR_TYPE_SWAPCHAIN_IMAGE_ACQUIRE_INFO };
-					uint32_t unImageIndex;
-					if ( xrAcquireSwapchainImage( xrSwapchain, &xrAcquireInfo, &unImageIndex ) != XR_SUCCESS )
-						return;
-
-					// (4.2) Let apps build command buffers via their registered callbacks
-					ExecuteRenderImageCallbacks( m_vecAcquireSwapchainImageCallbacks, i, unImageIndex );
-
-					// (4.3) Wait for swapchain image
-					XrSwapchainImageWaitInfo xrWaitInfo { XR_TYPE_SWAPCHAIN_IMAGE_WAIT_INFO };
-					xrWaitInfo.timeout = XR_INFINITE_DURATION;
-					if ( xrWaitSwapchainImage( xrSwapchain, &xrWaitInfo ) != XR_SUCCESS )
-						return;
-
-					// (4.4) Add projection view to swapchain image
-					vecFrameLayerProjectionViews[ i ] = { XR_TYPE_COMPOSITION_LAYER_PROJECTION_VIEW };
-					vecFrameLayerProjectionViews[ i ].pose = m_vecViews[ i ].pose;
-					vecFrameLayerProjectionViews[ i ].fov = m_vecViews[ i ].fov;
-					vecFrameLayerProjectionViews[ i ].subImage.swapchain = xrSwapchain;
-					vecFrameLayerProjectionViews[ i ].subImage.imageArrayIndex = bIsarray ? unArrayIndex : 0;
-					vecFrameLayerProjectionViews[ i ].subImage.imageRect.offset = xrRectOffset;
-					vecFrameLayerProjectionViews[ i ].subImage.imageRect.extent = {
-						xrRectExtent.width == 0 ? m_vecSwapchains[ i ].unWidth : xrRectExtent.width, xrRectExtent.height == 0 ? m_vecSwapchains[ i ].unHeight : xrRectExtent.height };
-
-					// (4.5) Depth handling
-					if ( m_bDepthHandling )
-					{
-						XrCompositionLayerDepthInfoKHR xrDepthInfo { XR_TYPE_COMPOSITION_LAYER_DEPTH_INFO_KHR };
-						xrDepthInfo.subImage.swapchain = m_vecSwapchains[ i ].xrDepthSwapchain;
-						xrDepthInfo.subImage.imageArrayIndex = 0;
-						xrDepthInfo.subImage.imageRect.offset = { 0, 0 };
-						xrDepthInfo.subImage.imageRect.extent = vecFrameLayerProjectionViews[ i ].subImage.imageRect.extent;
-						xrDepthInfo.minDepth = 0.0f;
-						xrDepthInfo.maxDepth = 1.0f;
-						xrDepthInfo.nearZ = 0.1f;
-						xrDepthInfo.farZ = FLT_MAX;
-
-						vecFrameLayerProjectionViews[ i ].next = &xrDepthInfo;
-					}
+					frameEnd.vecDepthInfos.push_back( *pDepthInfo );
+					view.next = &frameEnd.vecDepthInfos.back();
+				}
+			}
 
-					// (4.6) Let apps render to textures via their registered callbacks
-					ExecuteRenderImageCallbacks( m_vecWaitSwapchainImageCallbacks, i, unImageIndex );
+			projectionLayer.views = frameEnd.vecProjectionViews.data() + unFirstView;
+			pLayer = reinterpret_cast< const XrCompositionLayerBaseHeader * >( &projectionLayer );
+		}
 
-					// (4.7) Release swapchain image
-					XrSwapchainImageReleaseInfo xrSwapChainRleaseInfo { XR_TYPE_SWAPCHAIN_IMAGE_RELEASE_INFO };
-					if ( xrReleaseSwapchainImage( xrSwapchain, &xrSwapChainRleaseInfo ) != XR_SUCCESS )
-						return;
+		frameEnd.xrFrameEndInfo.layers = frameEnd.vecLayers.data();
+	}
 
-					// (4.8) Let apps do any internal cleanups via their registered callbacks
-					ExecuteRenderImageCallbacks( m_vecReleaseSwapchainImageCallbacks, i, unImageIndex );
-				}
+	bool Session::WaitForFrameGpuFences( const std::vector< FrameGpuFence > &vecGpuFences, XrFrameEndInfo *pFrameEndInfo )
+	{
+		// The timeout covers all of the frame's fences, so a frame is never held back for more than a second
+		const int64_t nDeadlineNs = FrameTiming::Now() + 1000000000ll;
+		for ( const FrameGpuFence &gpuFence : vecGpuFences )
+		{
+			const uint64_t unTimeoutNs = static_cast< uint64_t >( std::max< int64_t >( nDeadlineNs - FrameTiming::Now(), 0 ) );
+			const VkResult vkResult = vkWaitForFences( gpuFence.vkDevice, 1, &gpuFence.vkFence, VK_TRUE, unTimeoutNs );
+			if ( vkResult == VK_SUCCESS )
+				continue;
+
+			if ( vkResult == VK_TIMEOUT )
+				oxr::LogError( m_sLogCategory, "Timed out waiting for the frame's gpu work to finish, ending frame without layers." );
+			else
+				oxr::LogError( m_sLogCategory, "Unable to wait for the frame's gpu work with vulkan result (%i), ending frame without layers.", ( int32_t )vkResult );
+
+			pFrameEndInfo->layerCount = 0;
+			pFrameEndInfo->layers = nullptr;
+			return false;
+		}
+
+		return true;
+	}
+
+	bool Session::TakeWaitedFrame( FrameTicket *outFrameTicket )
+	{
+		std::lock_guard< std::mutex > lock( m_mutexFrameTickets );
+		if ( !m_bHasWaitedFrame )
+			return false;
 
-				// (4.9) Assemble projection layer
-				xrFrameLayerProjection.space = m_xrAppSpace;
-				xrFrameLayerProjection.layerFlags = xrCompositionLayerFlags;
-				xrFrameLayerProjection.viewCount = ( uint32_t )vecFrameLayerProjectionViews.size();
-				xrFrameLayerProjection.views = vecFrameLayerProjectionViews.data();
+		*outFrameTicket = m_WaitedFrame;
+		m_bHasWaitedFrame = false;
+		return true;
+	}
 
-				vecFrameLayers.push_back( reinterpret_cast< XrCompositionLayerBaseHeader * >( &xrFrameLayerProjection ) );
+	void Session::FrameEndLoop()
+	{
+		while ( true )
+		{
+			// (1) Wait for the render thread to submit a frame. Submitted frames are always ended, even when stopping,
+			//     as the frame pacing thread can't begin another frame until then
+			{
+				std::unique_lock< std::mutex > lock( m_mutexFrameTickets );
+				m_cvFrameTickets.wait( lock, [ this ] { return m_bFrameEndPending || !m_bFramePacingActive; } );
+
+				if ( !m_bFrameEndPending )
+					return;
 			}
+
+			// (2) Wait for the frame's gpu work, then hand it to the runtime. The next frame is only begun after this, so recording it
+			//     doesn't overlap this frame's gpu work - runtimes don't allow beginning a frame before the previous one has ended
+			WaitForFrameGpuFences( m_PendingFrameEnd.vecGpuFences, &m_PendingFrameEnd.xrFrameEndInfo );
+			xrEndFrame( m_xrSession, &m_PendingFrameEnd.xrFrameEndInfo );
+
+			// (3) Let the frame pacing thread begin the next frame
+			{
+				std::lock_guard< std::mutex > lock( m_mutexFrameTickets );
+				m_bFrameEndPending = false;
+				m_bFrameInFlight = false;
+			}
+
+			m_cvFrameTickets.notify_all();
 		}
+	}
 
-		// (5) End current frame
+	XrResult Session::StartFramePacing()
+	{
+		// Check if session was initialized correctly
+		XrResult xrResult = CheckIfInitCalled();
+		if ( !XR_UNQUALIFIED_SUCCESS( xrResult ) )
+			return xrResult;
 
-		XrFrameEndInfo xrEndFrameInfo { XR_TYPE_FRAME_END_INFO };
-		xrEndFrameInfo.displayTime = pFrameState->predictedDisplayTime;
-		xrEndFrameInfo.environmentBlendMode = xrEnvironmentBlendMode;
-		xrEndFrameInfo.layerCount = ( uint32_t )vecFrameLayers.size();
-		xrEndFrameInfo.layers = vecFrameLayers.data();
+		if ( m_bFramePacingActive )
+			return XR_SUCCESS;
 
-		xrEndFrame( m_xrSession, &xrEndFrameInfo );
+		// Clean up after a frame pacing thread that stopped on its own (e.g. runtime error)
+		StopFramePacing();
+
+		{
+			std::lock_guard< std::mutex > lock( m_mutexFrameTickets );
+			m_deqFrameTickets.clear();
+			m_bFrameInFlight = false;
+			m_bFrameEndPending = false;
+			m_bFramePacingActive = true;
+		}
+
+		m_threadFrameEnd = std::thread( &Session::FrameEndLoop, this );
+		m_threadFramePacing = std::thread( &Session::FramePacingLoop, this );
+
+		oxr::LogInfo( m_sLogCategory, "Pipelined frame loop started." );
+		return XR_SUCCESS;
 	}
 
-	void Session::RenderHeadlessFrame( XrFrameState *pFrameState )
+	void Session::StopFramePacing()
 	{
-		// Check if there's a valid session and swapchains to work with
-		if ( m_xrSession == XR_NULL_HANDLE )
-			return;
+		// (1) Signal the frame pacing thread to stop
+		{
+			std::lock_guard< std::mutex > lock( m_mutexFrameTickets );
+			m_bFramePacingActive = false;
+		}
 
-		// (1) Wait for a new frame
-		XrFrameWaitInfo xrWaitFrameInfo { XR_TYPE_FRAME_WAIT_INFO };
+		m_cvFrameTickets.notify_all();
 
-		if ( xrWaitFrame( m_xrSession, &xrWaitFrameInfo, pFrameState ) != XR_SUCCESS )
-			return;
+		// (2) Let the frame end thread end the last submitted frame
+		if ( m_threadFrameEnd.joinable() )
+			m_threadFrameEnd.join();
 
-		// Cache predicted time and period
-		m_xrPredictedDisplayTime = pFrameState->predictedDisplayTime;
-		m_xrPredictedDisplayPeriod = pFrameState->predictedDisplayPeriod;
+		// A frame submitted after the frame end thread exited (frame pacing stopped on its own mid-frame) is ended here
+		if ( m_bFrameEndPending )
+		{
+			WaitForFrameGpuFences( m_PendingFrameEnd.vecGpuFences, &m_PendingFrameEnd.xrFrameEndInfo );
+			xrEndFrame( m_xrSession, &m_PendingFrameEnd.xrFrameEndInfo );
 
-		// (2) Begin frame before doing any GPU work
-		XrFrameBeginInfo xrBeginFrameInfo { XR_TYPE_FRAME_BEGIN_INFO };
-		if ( xrBeginFrame( m_xrSession, &xrBeginFrameInfo ) != XR_SUCCESS )
-			return;
+			std::lock_guard< std::mutex > lock( m_mutexFrameTickets );
+			m_bFrameEndPending = false;
+			m_bFrameInFlight = false;
+		}
 
-		// (3) End current frame
+		m_cvFrameTickets.notify_all();
 
-		XrFrameEndInfo xrEndFrameInfo { XR_TYPE_FRAME_END_INFO };
-		xrEndFrameInfo.displayTime = pFrameState->predictedDisplayTime;
-		xrEndFrameInfo.layerCount = 0;
+		// (3) End frames that were begun but never consumed by the render thread - the frame pacing thread
+		//     may be waiting for these before it can begin the frame it's holding, so this is done before and after joining
+		auto EndUnconsumedFrames = [ this ]()
+		{
+			std::unique_lock< std::mutex > lock( m_mutexFrameTickets );
+			while ( !m_deqFrameTickets.empty() )
+			{
+				FrameTicket frameTicket = m_deqFrameTickets.front();
+				m_deqFrameTickets.pop_front();
+
+				if ( XR_SUCCEEDED( frameTicket.xrBeginFrameResult ) )
+				{
+					XrFrameEndInfo xrEndFrameInfo { XR_TYPE_FRAME_END_INFO };
+					xrEndFrameInfo.displayTime = frameTicket.xrFrameState.predictedDisplayTime;
+					xrEndFrameInfo.environmentBlendMode = XR_ENVIRONMENT_BLEND_MODE_OPAQUE;
+					xrEndFrameInfo.layerCount = 0;
+
+					xrEndFrame( m_xrSession, &xrEndFrameInfo );
+					m_bFrameInFlight = false;
+				}
+			}
+
+			lock.unlock();
+			m_cvFrameTickets.notify_all();
+		};
+
+		EndUnconsumedFrames();
+
+		// (4) Wait for the frame pacing thread to finish its current frame
+		if ( m_threadFramePacing.joinable() )
+		{
+			m_threadFramePacing.join();
+			oxr::LogInfo( m_sLogCategory, "Pipelined frame loop stopped." );
+		}
+
+		EndUnconsumedFrames();
+	}
 
-		xrEndFrame( m_xrSession, &xrEndFrameInfo );
+	void Session::FramePacingLoop()
+	{
+		while ( m_bFramePacingActive )
+		{
+			FrameTicket frameTicket;
+
+			// (1) Wait for the next frame - this overlaps with the render thread's work on the previous frame. A frame waited for by a previous
+			//     frame pacing thread that was never begun is begun first, as the runtime blocks further waits until then
+			const bool bTiming = m_FrameTiming.IsEnabled();
+			XrResult xrResult = XR_SUCCESS;
+			if ( !TakeWaitedFrame( &frameTicket ) )
+			{
+				XrFrameWaitInfo xrWaitFrameInfo { XR_TYPE_FRAME_WAIT_INFO };
+				frameTicket.waitFrameTime.nBeginNs = bTiming ? FrameTiming::Now() : 0;
+				xrResult = xrWaitFrame( m_xrSession, &xrWaitFrameInfo, &frameTicket.xrFrameState );
+				frameTicket.waitFrameTime.nEndNs = bTiming ? FrameTiming::Now() : 0;
+			}
+
+			if ( !XR_SUCCEEDED( xrResult ) )
+			{
+				oxr::LogError( m_sLogCategory, "Frame pacing thread unable to wait for frame (%s). Falling back to inline frame waits.", XrEnumToString( xrResult ) );
+
+				{
+					std::lock_guard< std::mutex > lock( m_mutexFrameTickets );
+					m_bFramePacingActive = false;
+				}
+
+				m_cvFrameTickets.notify_all();
+				return;
+			}
+
+			// (2) Only one frame can be begun at a time, wait until the render thread has ended the previous one.
+			//     A waited frame must always be begun, or subsequent xrWaitFrame calls will block. When stopping, frames not consumed by the
+			//     render thread or handed to the frame end thread are still ended, but if the render thread is rendering one, beginning now would
+			//     discard it - so leave the waited frame to whoever begins the next one
+			{
+				std::unique_lock< std::mutex > lock( m_mutexFrameTickets );
+				m_cvFrameTickets.wait(
+					lock, [ this ] { return !m_bFrameInFlight || ( !m_bFramePacingActive && !m_bFrameEndPending && m_deqFrameTickets.empty() ); } );
+
+				if ( m_bFrameInFlight )
+				{
+					m_WaitedFrame = frameTicket;
+					m_bHasWaitedFrame = true;
+					return;
+				}
+
+				// (3) Begin frame and hand it over to the render thread
+				XrFrameBeginInfo xrBeginFrameInfo { XR_TYPE_FRAME_BEGIN_INFO };
+				frameTicket.beginFrameTime.nBeginNs = bTiming ? FrameTiming::Now() : 0;
+				frameTicket.xrBeginFrameResult = xrBeginFrame( m_xrSession, &xrBeginFrameInfo );
+				frameTicket.beginFrameTime.nEndNs = bTiming ? FrameTiming::Now() : 0;
+
+				if ( XR_SUCCEEDED( frameTicket.xrBeginFrameResult ) )
+					m_bFrameInFlight = true;
+
+				m_deqFrameTickets.push_back( frameTicket );
+			}
+
+			m_cvFrameTickets.notify_all();
+		}
 	}
 
 } // namespace oxr
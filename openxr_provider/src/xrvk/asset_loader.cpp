@@ -0,0 +1,260 @@
+/* Copyright 2021, 2022, 2023 Rune Berg (GitHub: https://github.com/1runeberg, Twitter: https://twitter.com/1runeberg, YouTube: https://www.youtube.com/@1RuneBerg)
+ *
+ *  SPDX-License-Identifier: MIT
+ *
+ *  Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+ *
+ *  2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *
+ *  3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote products derived from this
+ *     software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ *  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+ *  BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ *  GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+ *  DAMAGE.
+ *
+ */
+
+
+#include <xrvk/asset_loader.hpp>
+
+namespace xrvk
+{
+	AssetLoader::AssetLoader( vks::VulkanDevice *pVulkanDevice, UploadManager *pUploadManager, uint32_t unWorkerThreadCount, const std::string &sMeshCacheDirectory )
+		: m_pVulkanDevice( pVulkanDevice )
+		, m_pUploadManager( pUploadManager )
+		, m_MeshCache( sMeshCacheDirectory )
+	{
+		assert( pVulkanDevice );
+		assert( pUploadManager );
+
+		// leave a hardware thread for the upload thread
+		if ( unWorkerThreadCount == 0 )
+			unWorkerThreadCount = std::max( 2u, std::thread::hardware_concurrency() ) - 1;
+
+		m_pWorkers = new JobSystem( unWorkerThreadCount );
+		m_UploadThread = std::thread( &AssetLoader::UploadLoop, this );
+
+		LogInfo( "Asset loader started with %i worker thread(s) and an upload thread.", unWorkerThreadCount );
+	}
+
+	AssetLoader::~AssetLoader()
+	{
+		// (1) Nothing left in the queues will make it to the gpu
+		CancelAll();
+
+		// (2) Let the workers drain their queue, cancelled assets are skipped or handed over to the upload thread
+		delete m_pWorkers;
+		m_pWorkers = nullptr;
+
+		// (3) Stop the upload thread once it has emptied its queue and its batches completed
+		{
+			std::lock_guard< std::mutex > lock( m_mutexUploads );
+			m_bStop = true;
+		}
+		m_cvUploads.notify_all();
+
+		if ( m_UploadThread.joinable() )
+			m_UploadThread.join();
+	}
+
+	AssetHandle AssetLoader::Load( const std::string &sFilename, vkglTF::Model *pModel, float fScale )
+	{
+		assert( pModel );
+
+		AssetHandle asset = std::make_shared< AssetRequest >();
+		asset->sFilename = sFilename;
+		asset->pModel = pModel;
+		asset->fScale = fScale;
+		asset->future = asset->promise.get_future().share();
+
+		{
+			std::lock_guard< std::mutex > lock( m_mutexAssets );
+			m_vecInFlight.push_back( asset );
+			m_unQueuedCount++;
+		}
+
+		m_pWorkers->Submit( [ this, asset ]() { ParseAsset( asset ); } );
+
+		return asset;
+	}
+
+	void AssetLoader::CancelAll()
+	{
+		std::lock_guard< std::mutex > lock( m_mutexAssets );
+		for ( auto &asset : m_vecInFlight )
+			asset->bCancel = true;
+	}
+
+	void AssetLoader::WaitAll()
+	{
+		std::unique_lock< std::mutex > lock( m_mutexAssets );
+		m_cvIdle.wait( lock, [ this ] { return m_vecInFlight.empty(); } );
+	}
+
+	uint32_t AssetLoader::GetPendingCount()
+	{
+		std::lock_guard< std::mutex > lock( m_mutexAssets );
+		return static_cast< uint32_t >( m_vecInFlight.size() );
+	}
+
+	float AssetLoader::GetProgress()
+	{
+		std::lock_guard< std::mutex > lock( m_mutexAssets );
+		if ( m_unQueuedCount == 0 )
+			return 1.f;
+
+		return static_cast< float >( m_unDoneCount ) / static_cast< float >( m_unQueuedCount );
+	}
+
+	void AssetLoader::ParseAsset( AssetHandle asset )
+	{
+		if ( asset->bCancel )
+		{
+			FinishAsset( asset, EAssetState::Cancelled );
+			return;
+		}
+
+		// (1) Mesh cache, or file read, parse and decode - either way this also creates the (still empty) gpu buffers
+		asset->eState = EAssetState::Parsing;
+		auto tStart = std::chrono::high_resolution_clock::now();
+
+		std::string sCacheFilename = m_MeshCache.GetFilename( asset->sFilename, asset->fScale );
+		uint64_t unSourceHash = sCacheFilename.empty() ? 0 : m_MeshCache.HashSource( asset->sFilename, asset->fScale );
+
+		asset->bFromCache = m_MeshCache.Load( sCacheFilename, unSourceHash, asset->pModel, m_pVulkanDevice );
+		bool bParsed = asset->bFromCache || asset->pModel->parseFromFile( asset->sFilename, m_pVulkanDevice, asset->fScale );
+		asset->fParseMs = std::chrono::duration< float, std::milli >( std::chrono::high_resolution_clock::now() - tStart ).count();
+
+		// ... first load, keep the preprocessed model for the next run (not counted in the parse time)
+		if ( bParsed && !asset->bFromCache && unSourceHash != 0 && !asset->bCancel )
+		{
+			auto tSaveStart = std::chrono::high_resolution_clock::now();
+			if ( m_MeshCache.Save( sCacheFilename, unSourceHash, asset->pModel ) )
+			{
+				LogVerbose( "Mesh cache %s written in %f ms", sCacheFilename.c_str(),
+							std::chrono::duration< float, std::milli >( std::chrono::high_resolution_clock::now() - tSaveStart ).count() );
+			}
+		}
+
+		if ( !bParsed )
+		{
+			LogError( "Unable to load gltf file %s", asset->sFilename.c_str() );
+			asset->pModel->destroy( m_pVulkanDevice->logicalDevice );
+			FinishAsset( asset, EAssetState::Failed );
+			return;
+		}
+
+		if ( asset->bCancel )
+		{
+			asset->pModel->destroy( m_pVulkanDevice->logicalDevice );
+			FinishAsset( asset, EAssetState::Cancelled );
+			return;
+		}
+
+		// (2) Hand over to the upload thread
+		asset->eState = EAssetState::Uploading;
+		{
+			std::lock_guard< std::mutex > lock( m_mutexUploads );
+			m_deqUploads.push_back( asset );
+		}
+		m_cvUploads.notify_one();
+	}
+
+	void AssetLoader::UploadLoop()
+	{
+		std::vector< AssetHandle > vecBatch;
+		std::deque< AssetHandle > deqSubmitted;
+		while ( true )
+		{
+			// (1) Take everything parsed since the last pass, only sleeping briefly while batches are in flight
+			{
+				std::unique_lock< std::mutex > lock( m_mutexUploads );
+				auto bWake = [ this ] { return m_bStop || !m_deqUploads.empty(); };
+
+				if ( deqSubmitted.empty() )
+					m_cvUploads.wait( lock, bWake );
+				else
+					m_cvUploads.wait_for( lock, std::chrono::milliseconds( 1 ), bWake );
+
+				if ( m_bStop && m_deqUploads.empty() && deqSubmitted.empty() )
+					break;
+
+				vecBatch.assign( m_deqUploads.begin(), m_deqUploads.end() );
+				m_deqUploads.clear();
+			}
+
+			// (2) Stage the batch into the ring and submit all of its copies at once
+			if ( !vecBatch.empty() )
+			{
+				auto tStart = std::chrono::high_resolution_clock::now();
+
+				for ( auto &asset : vecBatch )
+				{
+					if ( asset->bCancel )
+					{
+						asset->pModel->destroy( m_pVulkanDevice->logicalDevice );
+						FinishAsset( asset, EAssetState::Cancelled );
+						continue;
+					}
+
+					asset->pModel->stageUploads( m_pUploadManager );
+				}
+
+				UploadToken unToken = m_pUploadManager->Submit();
+
+				for ( auto &asset : vecBatch )
+				{
+					if ( asset->IsDone() )
+						continue;
+
+					asset->unUploadToken = unToken;
+					asset->tUploadStart = tStart;
+					deqSubmitted.push_back( asset );
+				}
+
+				vecBatch.clear();
+			}
+
+			// (3) Finish assets whose batch has completed, tokens complete in submission order
+			m_pUploadManager->Poll();
+
+			while ( !deqSubmitted.empty() && m_pUploadManager->IsComplete( deqSubmitted.front()->unUploadToken ) )
+			{
+				AssetHandle asset = deqSubmitted.front();
+				deqSubmitted.pop_front();
+
+				asset->fUploadMs = std::chrono::duration< float, std::milli >( std::chrono::high_resolution_clock::now() - asset->tUploadStart ).count();
+				FinishAsset( asset, EAssetState::Ready );
+
+				LogVerbose( "Loaded %s (parse %.2fms, upload %.2fms in batch %llu)", asset->sFilename.c_str(), asset->fParseMs, asset->fUploadMs, static_cast< unsigned long long >( asset->unUploadToken ) );
+			}
+		}
+	}
+
+	void AssetLoader::FinishAsset( const AssetHandle &asset, EAssetState eState )
+	{
+		asset->eState = eState;
+		asset->promise.set_value( eState == EAssetState::Ready );
+
+		{
+			std::lock_guard< std::mutex > lock( m_mutexAssets );
+			m_vecInFlight.erase( std::remove( m_vecInFlight.begin(), m_vecInFlight.end(), asset ), m_vecInFlight.end() );
+			m_unDoneCount++;
+
+			if ( m_vecInFlight.empty() )
+			{
+				m_unQueuedCount = 0;
+				m_unDoneCount = 0;
+			}
+		}
+		m_cvIdle.notify_all();
+	}
+
+} // namespace xrvk
@@ -0,0 +1,102 @@
+/* Copyright 2021, 2022, 2023 Rune Berg (GitHub: https://github.com/1runeberg, Twitter: https://twitter.com/1runeberg, YouTube: https://www.youtube.com/@1RuneBerg)
+ *
+ *  SPDX-License-Identifier: MIT
+ *
+ *  Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+ *
+ *  2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *
+ *  3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote products derived from this
+ *     software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ *  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+ *  BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ *  GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+ *  DAMAGE.
+ *
+ */
+
+
+#include <xrvk/job_system.hpp>
+
+namespace xrvk
+{
+	JobSystem::JobSystem( uint32_t unThreadCount )
+	{
+		if ( unThreadCount == 0 )
+			unThreadCount = std::max( 1u, std::thread::hardware_concurrency() );
+
+		m_vecWorkers.reserve( unThreadCount );
+		for ( uint32_t i = 0; i < unThreadCount; i++ )
+			m_vecWorkers.emplace_back( &JobSystem::WorkerLoop, this );
+	}
+
+	JobSystem::~JobSystem()
+	{
+		{
+			std::lock_guard< std::mutex > lock( m_mutexJobs );
+			m_bStop = true;
+		}
+		m_cvJobs.notify_all();
+
+		for ( auto &worker : m_vecWorkers )
+		{
+			if ( worker.joinable() )
+				worker.join();
+		}
+	}
+
+	std::future< void > JobSystem::Submit( std::function< void() > job )
+	{
+		std::packaged_task< void() > task( std::move( job ) );
+		std::future< void > result = task.get_future();
+
+		{
+			std::lock_guard< std::mutex > lock( m_mutexJobs );
+			m_deqJobs.push_back( std::move( task ) );
+		}
+		m_cvJobs.notify_one();
+
+		return result;
+	}
+
+	void JobSystem::Dispatch( uint32_t unCount, const std::function< void( uint32_t ) > &job )
+	{
+		std::vector< std::future< void > > vecResults;
+		vecResults.reserve( unCount );
+
+		for ( uint32_t i = 0; i < unCount; i++ )
+			vecResults.push_back( Submit( [ &job, i ]() { job( i ); } ) );
+
+		for ( auto &result : vecResults )
+			result.get();
+	}
+
+	void JobSystem::WorkerLoop()
+	{
+		while ( true )
+		{
+			std::packaged_task< void() > task;
+
+			{
+				std::unique_lock< std::mutex > lock( m_mutexJobs );
+				m_cvJobs.wait( lock, [ this ] { return m_bStop || !m_deqJobs.empty(); } );
+
+				// only exit once the queue has been drained
+				if ( m_deqJobs.empty() )
+					return;
+
+				task = std::move( m_deqJobs.front() );
+				m_deqJobs.pop_front();
+			}
+
+			task();
+		}
+	}
+
+} // namespace xrvk
@@ -0,0 +1,409 @@
+/* Copyright 2021, 2022, 2023 Rune Berg (GitHub: https://github.com/1runeberg, Twitter: https://twitter.com/1runeberg, YouTube: https://www.youtube.com/@1RuneBerg)
+ *
+ *  SPDX-License-Identifier: MIT
+ *
+ *  Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+ *
+ *  2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *
+ *  3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote products derived from this
+ *     software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ *  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+ *  BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ *  GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+ *  DAMAGE.
+ *
+ */
+
+#include <xrvk/memory_allocator.hpp>
+
+#include <algorithm>
+#include <cassert>
+
+namespace xrvk
+{
+	// A device memory allocation that resources are sub-allocated from
+	struct MemoryBlock
+	{
+		VkDeviceMemory vkMemory = VK_NULL_HANDLE;
+		VkDeviceSize unSize = 0;
+		uint8_t *pMapped = nullptr;
+		uint32_t unMemoryTypeIndex = 0;
+		uint32_t unPool = 0;
+
+		// offset, size - neighbouring ranges are always merged
+		std::map< VkDeviceSize, VkDeviceSize > mapFreeRanges;
+
+		uint32_t unAllocationCount = 0;
+		VkDeviceSize unUsedBytes = 0;
+		VkDeviceSize unWastedBytes = 0;
+	};
+
+	static VkDeviceSize AlignUp( VkDeviceSize unValue, VkDeviceSize unAlignment ) { return ( unValue + unAlignment - 1 ) & ~( unAlignment - 1 ); }
+	static VkDeviceSize AlignDown( VkDeviceSize unValue, VkDeviceSize unAlignment ) { return unValue & ~( unAlignment - 1 ); }
+
+	MemoryAllocator::MemoryAllocator( VkPhysicalDevice vkPhysicalDevice, VkDevice vkDevice, VkDeviceSize unBlockSize )
+		: m_vkDevice( vkDevice )
+		, m_unBlockSize( unBlockSize )
+	{
+		assert( vkPhysicalDevice != VK_NULL_HANDLE );
+		assert( vkDevice != VK_NULL_HANDLE );
+
+		VkPhysicalDeviceProperties vkPhysicalDeviceProperties;
+		vkGetPhysicalDeviceProperties( vkPhysicalDevice, &vkPhysicalDeviceProperties );
+		vkGetPhysicalDeviceMemoryProperties( vkPhysicalDevice, &m_vkMemoryProperties );
+
+		m_unBufferImageGranularity = std::max< VkDeviceSize >( 1, vkPhysicalDeviceProperties.limits.bufferImageGranularity );
+		m_unNonCoherentAtomSize = std::max< VkDeviceSize >( 1, vkPhysicalDeviceProperties.limits.nonCoherentAtomSize );
+
+		// Buffers and optimally tiled images next to each other in a block would have to be granularity apart,
+		// keeping them in separate blocks avoids that padding altogether
+		m_bSeparateImagePools = m_unBufferImageGranularity > 1;
+		m_vecPools.resize( m_vkMemoryProperties.memoryTypeCount * 2 );
+
+		LogInfo(
+			"Memory allocator created with %.0f MB blocks (buffer image granularity %llu, %s).",
+			static_cast< double >( m_unBlockSize ) / ( 1024.0 * 1024.0 ),
+			static_cast< unsigned long long >( m_unBufferImageGranularity ),
+			m_bSeparateImagePools ? "separate buffer and image blocks" : "buffers and images share blocks" );
+	}
+
+	MemoryAllocator::~MemoryAllocator()
+	{
+		uint32_t unLeakedCount = m_unDedicatedCount;
+		for ( auto &vecBlocks : m_vecPools )
+		{
+			for ( auto pBlock : vecBlocks )
+			{
+				unLeakedCount += pBlock->unAllocationCount;
+				vkFreeMemory( m_vkDevice, pBlock->vkMemory, nullptr );
+				delete pBlock;
+			}
+		}
+
+		// released with the device otherwise
+		if ( unLeakedCount > 0 )
+			LogVerbose( "Memory allocator destroyed with %u allocation(s) still in use.", unLeakedCount );
+	}
+
+	VkResult MemoryAllocator::AllocateBuffer( VkBuffer vkBuffer, VkMemoryPropertyFlags vkMemoryProperties, MemoryAllocation *pAllocation )
+	{
+		VkMemoryRequirements vkMemoryRequirements;
+		vkGetBufferMemoryRequirements( m_vkDevice, vkBuffer, &vkMemoryRequirements );
+
+		VkResult vkResult = Allocate( vkMemoryRequirements, vkMemoryProperties, true, pAllocation );
+		if ( vkResult != VK_SUCCESS )
+			return vkResult;
+
+		return vkBindBufferMemory( m_vkDevice, vkBuffer, pAllocation->vkMemory, pAllocation->unOffset );
+	}
+
+	VkResult MemoryAllocator::AllocateImage( VkImage vkImage, VkMemoryPropertyFlags vkMemoryProperties, MemoryAllocation *pAllocation )
+	{
+		VkMemoryRequirements vkMemoryRequirements;
+		vkGetImageMemoryRequirements( m_vkDevice, vkImage, &vkMemoryRequirements );
+
+		VkResult vkResult = Allocate( vkMemoryRequirements, vkMemoryProperties, false, pAllocation );
+		if ( vkResult != VK_SUCCESS )
+			return vkResult;
+
+		return vkBindImageMemory( m_vkDevice, vkImage, pAllocation->vkMemory, pAllocation->unOffset );
+	}
+
+	VkResult MemoryAllocator::Allocate( const VkMemoryRequirements &vkMemoryRequirements, VkMemoryPropertyFlags vkMemoryProperties, bool bLinear, MemoryAllocation *pAllocation )
+	{
+		assert( pAllocation );
+		*pAllocation = MemoryAllocation();
+
+		uint32_t unMemoryTypeIndex = FindMemoryType( vkMemoryRequirements.memoryTypeBits, vkMemoryProperties );
+		if ( unMemoryTypeIndex == UINT32_MAX )
+		{
+			LogError( "No memory type with properties 0x%x for memory type bits 0x%x", vkMemoryProperties, vkMemoryRequirements.memoryTypeBits );
+			return VK_ERROR_FEATURE_NOT_PRESENT;
+		}
+
+		// Non coherent allocations cover whole atoms so flushing one never touches its neighbours
+		VkDeviceSize unAlignment = std::max< VkDeviceSize >( 1, vkMemoryRequirements.alignment );
+		VkDeviceSize unSize = vkMemoryRequirements.size;
+		if ( IsHostVisible( unMemoryTypeIndex ) && !IsCoherent( unMemoryTypeIndex ) )
+		{
+			unAlignment = std::max( unAlignment, m_unNonCoherentAtomSize );
+			unSize = AlignUp( unSize, m_unNonCoherentAtomSize );
+		}
+
+		std::lock_guard< std::mutex > lock( m_mutex );
+
+		// (1) Large resources get their own allocation
+		if ( unSize > m_unBlockSize / 2 )
+		{
+			void *pMapped = nullptr;
+			VkResult vkResult = AllocateDeviceMemory( unMemoryTypeIndex, unSize, &pAllocation->vkMemory, &pMapped );
+			if ( vkResult != VK_SUCCESS )
+				return vkResult;
+
+			pAllocation->unSize = unSize;
+			pAllocation->unRangeSize = unSize;
+			pAllocation->pMapped = pMapped;
+			pAllocation->pAllocator = this;
+			pAllocation->unMemoryTypeIndex = unMemoryTypeIndex;
+
+			m_unDedicatedCount++;
+			m_unDedicatedBytes += unSize;
+			return VK_SUCCESS;
+		}
+
+		// (2) Best fit in the pool's blocks
+		const uint32_t unPool = unMemoryTypeIndex * 2 + ( m_bSeparateImagePools && !bLinear ? 1 : 0 );
+		std::vector< MemoryBlock * > &vecBlocks = m_vecPools[ unPool ];
+
+		for ( auto pBlock : vecBlocks )
+		{
+			if ( AllocateFromBlock( pBlock, unSize, unAlignment, pAllocation ) )
+				return VK_SUCCESS;
+		}
+
+		// (3) New block - smaller ones if the heap can't fit a full block
+		MemoryBlock *pBlock = new MemoryBlock;
+		pBlock->unMemoryTypeIndex = unMemoryTypeIndex;
+		pBlock->unPool = unPool;
+		pBlock->unSize = m_unBlockSize;
+
+		void *pMapped = nullptr;
+		VkResult vkResult = AllocateDeviceMemory( unMemoryTypeIndex, pBlock->unSize, &pBlock->vkMemory, &pMapped );
+		while ( vkResult != VK_SUCCESS && pBlock->unSize / 2 >= unSize )
+		{
+			pBlock->unSize /= 2;
+			vkResult = AllocateDeviceMemory( unMemoryTypeIndex, pBlock->unSize, &pBlock->vkMemory, &pMapped );
+		}
+
+		if ( vkResult != VK_SUCCESS )
+		{
+			LogError( "Unable to allocate a device memory block of memory type %u (%i)", unMemoryTypeIndex, ( int32_t )vkResult );
+			delete pBlock;
+			return vkResult;
+		}
+
+		pBlock->pMapped = static_cast< uint8_t * >( pMapped );
+		pBlock->mapFreeRanges[ 0 ] = pBlock->unSize;
+		vecBlocks.push_back( pBlock );
+
+		bool bAllocated = AllocateFromBlock( pBlock, unSize, unAlignment, pAllocation );
+		assert( bAllocated );
+		( void )bAllocated;
+
+		return VK_SUCCESS;
+	}
+
+	void MemoryAllocator::Free( MemoryAllocation &allocation )
+	{
+		if ( !allocation.IsValid() )
+			return;
+
+		assert( allocation.pAllocator == this );
+
+		std::lock_guard< std::mutex > lock( m_mutex );
+
+		// (1) Dedicated allocations go straight back to the driver (which also unmaps them)
+		MemoryBlock *pBlock = allocation.pBlock;
+		if ( pBlock == nullptr )
+		{
+			vkFreeMemory( m_vkDevice, allocation.vkMemory, nullptr );
+			m_unDedicatedCount--;
+			m_unDedicatedBytes -= allocation.unSize;
+			allocation = MemoryAllocation();
+			return;
+		}
+
+		// (2) Return the range to the block's free list, merged with its neighbours
+		pBlock->unAllocationCount--;
+		pBlock->unUsedBytes -= allocation.unSize;
+		pBlock->unWastedBytes -= allocation.unRangeSize - allocation.unSize;
+
+		auto it = pBlock->mapFreeRanges.emplace( allocation.unRangeOffset, allocation.unRangeSize ).first;
+
+		auto itNext = std::next( it );
+		if ( itNext != pBlock->mapFreeRanges.end() && it->first + it->second == itNext->first )
+		{
+			it->second += itNext->second;
+			pBlock->mapFreeRanges.erase( itNext );
+		}
+
+		if ( it != pBlock->mapFreeRanges.begin() )
+		{
+			auto itPrev = std::prev( it );
+			if ( itPrev->first + itPrev->second == it->first )
+			{
+				itPrev->second += it->second;
+				pBlock->mapFreeRanges.erase( it );
+			}
+		}
+
+		allocation = MemoryAllocation();
+
+		// (3) Release empty blocks, keeping one per pool so loads and unloads don't keep reallocating it
+		if ( pBlock->unAllocationCount > 0 )
+			return;
+
+		std::vector< MemoryBlock * > &vecBlocks = m_vecPools[ pBlock->unPool ];
+		auto unEmptyCount = std::count_if( vecBlocks.begin(), vecBlocks.end(), []( MemoryBlock *pPoolBlock ) { return pPoolBlock->unAllocationCount == 0; } );
+		if ( unEmptyCount > 1 )
+		{
+			vecBlocks.erase( std::find( vecBlocks.begin(), vecBlocks.end(), pBlock ) );
+			vkFreeMemory( m_vkDevice, pBlock->vkMemory, nullptr );
+			delete pBlock;
+		}
+	}
+
+	void MemoryAllocator::Flush( const MemoryAllocation &allocation, VkDeviceSize unOffset, VkDeviceSize unSize )
+	{
+		if ( allocation.pMapped == nullptr || IsCoherent( allocation.unMemoryTypeIndex ) )
+			return;
+
+		// allocations of non coherent memory start and end on atom boundaries
+		VkDeviceSize unEnd = unSize == VK_WHOLE_SIZE ? allocation.unSize : std::min( allocation.unSize, AlignUp( unOffset + unSize, m_unNonCoherentAtomSize ) );
+
+		VkMappedMemoryRange vkMappedRange { VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE };
+		vkMappedRange.memory = allocation.vkMemory;
+		vkMappedRange.offset = allocation.unOffset + AlignDown( unOffset, m_unNonCoherentAtomSize );
+		vkMappedRange.size = allocation.unOffset + unEnd - vkMappedRange.offset;
+		vkFlushMappedMemoryRanges( m_vkDevice, 1, &vkMappedRange );
+	}
+
+	MemoryStats MemoryAllocator::GetStats()
+	{
+		std::lock_guard< std::mutex > lock( m_mutex );
+
+		MemoryStats stats;
+		stats.unDedicatedCount = m_unDedicatedCount;
+		stats.unAllocationCount = m_unDedicatedCount;
+		stats.unAllocatedBytes = m_unDedicatedBytes;
+		stats.unUsedBytes = m_unDedicatedBytes;
+
+		for ( auto &vecBlocks : m_vecPools )
+		{
+			for ( auto pBlock : vecBlocks )
+			{
+				stats.unBlockCount++;
+				stats.unAllocationCount += pBlock->unAllocationCount;
+				stats.unAllocatedBytes += pBlock->unSize;
+				stats.unUsedBytes += pBlock->unUsedBytes;
+				stats.unWastedBytes += pBlock->unWastedBytes;
+
+				for ( auto &freeRange : pBlock->mapFreeRanges )
+				{
+					stats.unFreeBytes += freeRange.second;
+					stats.unLargestFreeRange = std::max( stats.unLargestFreeRange, freeRange.second );
+				}
+			}
+		}
+
+		return stats;
+	}
+
+	void MemoryAllocator::LogStats()
+	{
+		MemoryStats stats = GetStats();
+
+		LogInfo(
+			"Device memory: %u allocation(s) in %u block(s) plus %u dedicated, %.2f MB allocated, %.2f MB used, %.2f KB alignment padding, %.2f MB free (%.0f%% fragmented)",
+			stats.unAllocationCount - stats.unDedicatedCount,
+			stats.unBlockCount,
+			stats.unDedicatedCount,
+			static_cast< double >( stats.unAllocatedBytes ) / ( 1024.0 * 1024.0 ),
+			static_cast< double >( stats.unUsedBytes ) / ( 1024.0 * 1024.0 ),
+			static_cast< double >( stats.unWastedBytes ) / 1024.0,
+			static_cast< double >( stats.unFreeBytes ) / ( 1024.0 * 1024.0 ),
+			stats.GetFragmentation() * 100.0 );
+	}
+
+	uint32_t MemoryAllocator::FindMemoryType( uint32_t unTypeBits, VkMemoryPropertyFlags vkMemoryProperties )
+	{
+		for ( uint32_t i = 0; i < m_vkMemoryProperties.memoryTypeCount; i++ )
+		{
+			if ( ( unTypeBits & ( 1u << i ) ) && ( m_vkMemoryProperties.memoryTypes[ i ].propertyFlags & vkMemoryProperties ) == vkMemoryProperties )
+				return i;
+		}
+
+		return UINT32_MAX;
+	}
+
+	VkResult MemoryAllocator::AllocateDeviceMemory( uint32_t unMemoryTypeIndex, VkDeviceSize unSize, VkDeviceMemory *pMemory, void **ppMapped )
+	{
+		VkMemoryAllocateInfo vkMemoryAllocateInfo { VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO };
+		vkMemoryAllocateInfo.allocationSize = unSize;
+		vkMemoryAllocateInfo.memoryTypeIndex = unMemoryTypeIndex;
+
+		VkResult vkResult = vkAllocateMemory( m_vkDevice, &vkMemoryAllocateInfo, nullptr, pMemory );
+		if ( vkResult != VK_SUCCESS )
+			return vkResult;
+
+		// Host visible memory stays mapped until it's freed
+		*ppMapped = nullptr;
+		if ( IsHostVisible( unMemoryTypeIndex ) )
+		{
+			vkResult = vkMapMemory( m_vkDevice, *pMemory, 0, VK_WHOLE_SIZE, 0, ppMapped );
+			if ( vkResult != VK_SUCCESS )
+			{
+				vkFreeMemory( m_vkDevice, *pMemory, nullptr );
+				*pMemory = VK_NULL_HANDLE;
+			}
+		}
+
+		return vkResult;
+	}
+
+	bool MemoryAllocator::AllocateFromBlock( MemoryBlock *pBlock, VkDeviceSize unSize, VkDeviceSize unAlignment, MemoryAllocation *pAllocation )
+	{
+		// Smallest free range that fits the aligned allocation
+		auto itBest = pBlock->mapFreeRanges.end();
+		VkDeviceSize unBestOffset = 0;
+
+		for ( auto it = pBlock->mapFreeRanges.begin(); it != pBlock->mapFreeRanges.end(); ++it )
+		{
+			VkDeviceSize unAlignedOffset = AlignUp( it->first, unAlignment );
+			if ( unAlignedOffset + unSize > it->first + it->second )
+				continue;
+
+			if ( itBest == pBlock->mapFreeRanges.end() || it->second < itBest->second )
+			{
+				itBest = it;
+				unBestOffset = unAlignedOffset;
+			}
+		}
+
+		if ( itBest == pBlock->mapFreeRanges.end() )
+			return false;
+
+		// The alignment padding stays with the allocation, the rest of the range remains free
+		const VkDeviceSize unRangeOffset = itBest->first;
+		const VkDeviceSize unRangeEnd = unBestOffset + unSize;
+		const VkDeviceSize unRemaining = itBest->first + itBest->second - unRangeEnd;
+
+		pBlock->mapFreeRanges.erase( itBest );
+		if ( unRemaining > 0 )
+			pBlock->mapFreeRanges[ unRangeEnd ] = unRemaining;
+
+		pAllocation->vkMemory = pBlock->vkMemory;
+		pAllocation->unOffset = unBestOffset;
+		pAllocation->unSize = unSize;
+		pAllocation->pMapped = pBlock->pMapped ? pBlock->pMapped + unBestOffset : nullptr;
+		pAllocation->pAllocator = this;
+		pAllocation->unMemoryTypeIndex = pBlock->unMemoryTypeIndex;
+		pAllocation->pBlock = pBlock;
+		pAllocation->unRangeOffset = unRangeOffset;
+		pAllocation->unRangeSize = unRangeEnd - unRangeOffset;
+
+		pBlock->unAllocationCount++;
+		pBlock->unUsedBytes += unSize;
+		pBlock->unWastedBytes += unBestOffset - unRangeOffset;
+
+		return true;
+	}
+
+} // namespace xrvk
@@ -0,0 +1,842 @@
+/* Copyright 2021, 2022, 2023 Rune Berg (GitHub: https://github.com/1runeberg, Twitter: https://twitter.com/1runeberg, YouTube: https://www.youtube.com/@1RuneBerg)
+ *
+ *  SPDX-License-Identifier: MIT
+ *
+ *  Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+ *
+ *  2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *
+ *  3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote products derived from this
+ *     software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ *  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+ *  BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ *  GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+ *  DAMAGE.
+ *
+ */
+
+
+#include <xrvk/mesh_cache.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <thread>
+#include <unordered_map>
+
+#ifdef _WIN32
+	#include <windows.h>
+#else
+	#include <fcntl.h>
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <unistd.h>
+#endif
+
+namespace xrvk
+{
+	static uint64_t HashFNV1a( const void *pData, size_t unSize, uint64_t unHash = 0xcbf29ce484222325ull )
+	{
+		const uint8_t *pBytes = static_cast< const uint8_t * >( pData );
+		for ( size_t i = 0; i < unSize; i++ )
+		{
+			unHash ^= pBytes[ i ];
+			unHash *= 0x100000001b3ull;
+		}
+
+		return unHash;
+	}
+
+	static uint64_t AlignCacheOffset( uint64_t unOffset ) { return ( unOffset + k_unMeshCacheAlignment - 1 ) & ~( k_unMeshCacheAlignment - 1 ); }
+
+	// Flattens the model structs into a blob
+	struct MeshCacheWriter
+	{
+		std::vector< char > vecData;
+
+		template < typename T >
+		void Write( const T &value )
+		{
+			const char *pBytes = reinterpret_cast< const char * >( &value );
+			vecData.insert( vecData.end(), pBytes, pBytes + sizeof( T ) );
+		}
+
+		void WriteString( const std::string &sValue )
+		{
+			Write( static_cast< uint32_t >( sValue.size() ) );
+			vecData.insert( vecData.end(), sValue.begin(), sValue.end() );
+		}
+
+		template < typename T >
+		void WriteVector( const std::vector< T > &vecValues )
+		{
+			Write( static_cast< uint32_t >( vecValues.size() ) );
+			const char *pBytes = reinterpret_cast< const char * >( vecValues.data() );
+			vecData.insert( vecData.end(), pBytes, pBytes + vecValues.size() * sizeof( T ) );
+		}
+
+		void WriteBoundingBox( const vkglTF::BoundingBox &box )
+		{
+			Write( box.min );
+			Write( box.max );
+			Write( static_cast< uint8_t >( box.valid ) );
+		}
+	};
+
+	// Bounds checked reads of the blob, a single read past its end invalidates the whole load
+	struct MeshCacheReader
+	{
+		const uint8_t *pData = nullptr;
+		uint64_t unSize = 0;
+		uint64_t unPos = 0;
+		bool bValid = true;
+
+		bool Fits( uint64_t unBytes )
+		{
+			bValid = bValid && unBytes <= unSize - unPos;
+			return bValid;
+		}
+
+		template < typename T >
+		T Read()
+		{
+			T value {};
+			if ( Fits( sizeof( T ) ) )
+			{
+				memcpy( &value, pData + unPos, sizeof( T ) );
+				unPos += sizeof( T );
+			}
+
+			return value;
+		}
+
+		std::string ReadString()
+		{
+			uint32_t unLength = Read< uint32_t >();
+			if ( !Fits( unLength ) )
+				return std::string();
+
+			std::string sValue( reinterpret_cast< const char * >( pData + unPos ), unLength );
+			unPos += unLength;
+			return sValue;
+		}
+
+		template < typename T >
+		std::vector< T > ReadVector()
+		{
+			uint32_t unCount = Read< uint32_t >();
+			if ( !Fits( uint64_t( unCount ) * sizeof( T ) ) )
+				return std::vector< T >();
+
+			std::vector< T > vecValues( unCount );
+			memcpy( vecValues.data(), pData + unPos, unCount * sizeof( T ) );
+			unPos += unCount * sizeof( T );
+			return vecValues;
+		}
+
+		vkglTF::BoundingBox ReadBoundingBox()
+		{
+			vkglTF::BoundingBox box;
+			box.min = Read< glm::vec3 >();
+			box.max = Read< glm::vec3 >();
+			box.valid = Read< uint8_t >() != 0;
+			return box;
+		}
+	};
+
+	bool MappedFile::Open( const std::string &sFilename )
+	{
+		Close();
+
+#ifdef _WIN32
+		HANDLE hFile = CreateFileA( sFilename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr );
+		if ( hFile == INVALID_HANDLE_VALUE )
+			return false;
+
+		LARGE_INTEGER fileSize {};
+		if ( !GetFileSizeEx( hFile, &fileSize ) || fileSize.QuadPart == 0 )
+		{
+			CloseHandle( hFile );
+			return false;
+		}
+
+		HANDLE hMapping = CreateFileMappingA( hFile, nullptr, PAGE_READONLY, 0, 0, nullptr );
+		void *pView = hMapping ? MapViewOfFile( hMapping, FILE_MAP_READ, 0, 0, 0 ) : nullptr;
+		if ( pView == nullptr )
+		{
+			if ( hMapping )
+				CloseHandle( hMapping );
+
+			CloseHandle( hFile );
+			return false;
+		}
+
+		m_hFile = hFile;
+		m_hMapping = hMapping;
+		m_pData = static_cast< const uint8_t * >( pView );
+		m_unSize = static_cast< uint64_t >( fileSize.QuadPart );
+#else
+		int nFile = open( sFilename.c_str(), O_RDONLY );
+		if ( nFile < 0 )
+			return false;
+
+		struct stat fileStat;
+		if ( fstat( nFile, &fileStat ) != 0 || fileStat.st_size == 0 )
+		{
+			close( nFile );
+			return false;
+		}
+
+		// the mapping stays valid after the descriptor is closed
+		void *pView = mmap( nullptr, static_cast< size_t >( fileStat.st_size ), PROT_READ, MAP_PRIVATE, nFile, 0 );
+		close( nFile );
+
+		if ( pView == MAP_FAILED )
+			return false;
+
+		m_pData = static_cast< const uint8_t * >( pView );
+		m_unSize = static_cast< uint64_t >( fileStat.st_size );
+#endif
+
+		return true;
+	}
+
+	void MappedFile::Close()
+	{
+		if ( m_pData == nullptr )
+			return;
+
+#ifdef _WIN32
+		UnmapViewOfFile( m_pData );
+		CloseHandle( m_hMapping );
+		CloseHandle( m_hFile );
+		m_hMapping = nullptr;
+		m_hFile = nullptr;
+#else
+		munmap( const_cast< uint8_t * >( m_pData ), static_cast< size_t >( m_unSize ) );
+#endif
+
+		m_pData = nullptr;
+		m_unSize = 0;
+	}
+
+	std::string MeshCache::GetFilename( const std::string &sSource, float fScale )
+	{
+		if ( !IsEnabled() )
+			return "";
+
+		// One file per source and scale, replaced whenever the source changes
+		uint64_t unKey = HashFNV1a( sSource.data(), sSource.size() );
+		unKey = HashFNV1a( &fScale, sizeof( fScale ), unKey );
+
+		std::string sStem = std::filesystem::path( sSource ).stem().string();
+		char pcFilename[ 64 ];
+		snprintf( pcFilename, sizeof( pcFilename ), "_%016llx.bin", static_cast< unsigned long long >( unKey ) );
+		return ( std::filesystem::path( m_sDirectory ) / ( "xrvk_mesh_" + sStem + pcFilename ) ).generic_string();
+	}
+
+	uint64_t MeshCache::HashSource( const std::string &sSource, float fScale )
+	{
+		// (1) Source file - if it can't be read directly (e.g. packaged assets) the model isn't cached
+		MappedFile sourceFile;
+		if ( !sourceFile.Open( sSource ) )
+			return 0;
+
+		uint64_t unHash = HashFNV1a( sourceFile.GetData(), sourceFile.GetSize() );
+
+		// (2) Buffers and images a .gltf references by uri (embedded data uris are already hashed)
+		if ( std::filesystem::path( sSource ).extension() == ".gltf" )
+		{
+			const std::string sJson( reinterpret_cast< const char * >( sourceFile.GetData() ), sourceFile.GetSize() );
+			const std::filesystem::path directory = std::filesystem::path( sSource ).parent_path();
+
+			size_t unPos = 0;
+			while ( ( unPos = sJson.find( "\"uri\"", unPos ) ) != std::string::npos )
+			{
+				size_t unStart = sJson.find( '"', sJson.find( ':', unPos ) );
+				size_t unEnd = unStart == std::string::npos ? std::string::npos : sJson.find( '"', unStart + 1 );
+				if ( unEnd == std::string::npos )
+					break;
+
+				std::string sUri = sJson.substr( unStart + 1, unEnd - unStart - 1 );
+				if ( sUri.compare( 0, 5, "data:" ) != 0 )
+				{
+					MappedFile externalFile;
+					if ( externalFile.Open( ( directory / sUri ).generic_string() ) )
+						unHash = HashFNV1a( externalFile.GetData(), externalFile.GetSize(), unHash );
+				}
+
+				unPos = unEnd + 1;
+			}
+		}
+
+		// (3) Parameters the cached data depends on
+		unHash = HashFNV1a( &fScale, sizeof( fScale ), unHash );
+		unHash = HashFNV1a( &k_unMeshCacheFileVersion, sizeof( k_unMeshCacheFileVersion ), unHash );
+
+		return unHash;
+	}
+
+	bool MeshCache::Load( const std::string &sCacheFilename, uint64_t unSourceHash, vkglTF::Model *pModel, vks::VulkanDevice *pVulkanDevice )
+	{
+		if ( sCacheFilename.empty() || unSourceHash == 0 )
+			return false;
+
+		auto pFile = std::make_shared< MappedFile >();
+		if ( !pFile->Open( sCacheFilename ) )
+			return false;
+
+		// (1) Validate header and section bounds
+		const uint8_t *pData = pFile->GetData();
+		const uint64_t unSize = pFile->GetSize();
+
+		FileHeader header;
+		if ( unSize < sizeof( FileHeader ) )
+		{
+			LogError( "Mesh cache %s is truncated, rebuilding.", sCacheFilename.c_str() );
+			return false;
+		}
+
+		memcpy( &header, pData, sizeof( FileHeader ) );
+
+		if ( header.unMagic != k_unMeshCacheMagic || header.unVersion != k_unMeshCacheFileVersion || header.unVertexStride != sizeof( vkglTF::Model::Vertex ) )
+		{
+			LogInfo( "Mesh cache %s is from a different version, rebuilding.", sCacheFilename.c_str() );
+			return false;
+		}
+
+		if ( header.unSourceHash != unSourceHash )
+		{
+			LogInfo( "Mesh cache %s is out of date, rebuilding.", sCacheFilename.c_str() );
+			return false;
+		}
+
+		auto IsInFile = [ unSize ]( uint64_t unOffset, uint64_t unBytes ) { return unOffset <= unSize && unBytes <= unSize - unOffset; };
+
+		const uint64_t unTextureTableSize = uint64_t( header.unTextureCount ) * sizeof( TextureHeader );
+		if ( header.unFileSize != unSize || header.unVertexCount == 0 || !IsInFile( sizeof( FileHeader ), unTextureTableSize ) ||
+			 !IsInFile( header.unModelOffset, header.unModelSize ) || !IsInFile( header.unVertexOffset, header.unVertexCount * sizeof( vkglTF::Model::Vertex ) ) ||
+			 !IsInFile( header.unIndexOffset, header.unIndexCount * sizeof( uint32_t ) ) )
+		{
+			LogError( "Mesh cache %s is invalid, rebuilding.", sCacheFilename.c_str() );
+			return false;
+		}
+
+		std::vector< TextureHeader > vecTextureHeaders( header.unTextureCount );
+		memcpy( vecTextureHeaders.data(), pData + sizeof( FileHeader ), unTextureTableSize );
+
+		for ( auto &textureHeader : vecTextureHeaders )
+		{
+			const uint32_t unMipLevels = static_cast< uint32_t >( floor( log2( std::max( textureHeader.unWidth, textureHeader.unHeight ) ) ) + 1.0 );
+			if ( textureHeader.unWidth == 0 || textureHeader.unHeight == 0 || textureHeader.unMipLevels != unMipLevels ||
+				 textureHeader.unDataSize != vkglTF::Texture::getRGBASize( textureHeader.unWidth, textureHeader.unHeight, unMipLevels ) ||
+				 !IsInFile( textureHeader.unDataOffset, textureHeader.unDataSize ) )
+			{
+				LogError( "Mesh cache %s has invalid textures, rebuilding.", sCacheFilename.c_str() );
+				return false;
+			}
+		}
+
+		// (2) Model structure
+		MeshCacheReader reader;
+		reader.pData = pData + header.unModelOffset;
+		reader.unSize = header.unModelSize;
+
+		pModel->device = pVulkanDevice;
+		pModel->textureSamplers = reader.ReadVector< vkglTF::TextureSampler >();
+		pModel->textures.resize( header.unTextureCount );
+
+		auto TextureFromIndex = [ pModel, &reader ]( int32_t nIndex ) -> vkglTF::Texture *
+		{
+			if ( nIndex < 0 )
+				return nullptr;
+
+			reader.bValid = reader.bValid && static_cast< size_t >( nIndex ) < pModel->textures.size();
+			return reader.bValid ? &pModel->textures[ nIndex ] : nullptr;
+		};
+
+		// ... materials, primitives keep references into this vector so it's sized once
+		pModel->materials.resize( reader.Read< uint32_t >() );
+		for ( auto &material : pModel->materials )
+		{
+			material.alphaMode = static_cast< vkglTF::Material::AlphaMode >( reader.Read< uint32_t >() );
+			material.alphaCutoff = reader.Read< float >();
+			material.metallicFactor = reader.Read< float >();
+			material.roughnessFactor = reader.Read< float >();
+			material.baseColorFactor = reader.Read< glm::vec4 >();
+			material.emissiveFactor = reader.Read< glm::vec4 >();
+			material.baseColorTexture = TextureFromIndex( reader.Read< int32_t >() );
+			material.metallicRoughnessTexture = TextureFromIndex( reader.Read< int32_t >() );
+			material.normalTexture = TextureFromIndex( reader.Read< int32_t >() );
+			material.occlusionTexture = TextureFromIndex( reader.Read< int32_t >() );
+			material.emissiveTexture = TextureFromIndex( reader.Read< int32_t >() );
+			material.extension.specularGlossinessTexture = TextureFromIndex( reader.Read< int32_t >() );
+			material.extension.diffuseTexture = TextureFromIndex( reader.Read< int32_t >() );
+			material.doubleSided = reader.Read< uint8_t >() != 0;
+			material.texCoordSets = reader.Read< vkglTF::Material::TexCoordSets >();
+			material.extension.diffuseFactor = reader.Read< glm::vec4 >();
+			material.extension.specularFactor = reader.Read< glm::vec3 >();
+			material.pbrWorkflows.metallicRoughness = reader.Read< uint8_t >() != 0;
+			material.pbrWorkflows.specularGlossiness = reader.Read< uint8_t >() != 0;
+		}
+
+		uint32_t unExtensionCount = reader.Read< uint32_t >();
+		for ( uint32_t i = 0; i < unExtensionCount && reader.bValid; i++ )
+			pModel->extensions.push_back( reader.ReadString() );
+
+		// ... nodes are stored in linear (children first) order with their parent's linear index, links are made once all nodes are read
+		const uint32_t unNodeCount = reader.Read< uint32_t >();
+		std::vector< vkglTF::Node * > vecNodes;
+		std::vector< int32_t > vecParents;
+
+		for ( uint32_t i = 0; i < unNodeCount && reader.bValid; i++ )
+		{
+			vkglTF::Node *pNode = new vkglTF::Node {};
+			vecNodes.push_back( pNode );
+
+			int32_t nParent = reader.Read< int32_t >();
+			reader.bValid = reader.bValid && ( nParent < 0 || ( nParent > static_cast< int32_t >( i ) && nParent < static_cast< int32_t >( unNodeCount ) ) );
+			vecParents.push_back( nParent );
+
+			pNode->index = reader.Read< uint32_t >();
+			pNode->name = reader.ReadString();
+			pNode->skinIndex = reader.Read< int32_t >();
+			pNode->matrix = reader.Read< glm::mat4 >();
+			pNode->translation = reader.Read< glm::vec3 >();
+			pNode->rotation = reader.Read< glm::quat >();
+			pNode->scale = reader.Read< glm::vec3 >();
+
+			if ( reader.Read< uint8_t >() == 0 || !reader.bValid )
+				continue;
+
+			vkglTF::Mesh *pMesh = new vkglTF::Mesh( pVulkanDevice, pNode->matrix );
+			pNode->mesh = pMesh;
+			pMesh->bb = reader.ReadBoundingBox();
+
+			uint32_t unPrimitiveCount = reader.Read< uint32_t >();
+			for ( uint32_t j = 0; j < unPrimitiveCount && reader.bValid; j++ )
+			{
+				uint32_t unFirstIndex = reader.Read< uint32_t >();
+				uint32_t unIndexCount = reader.Read< uint32_t >();
+				uint32_t unVertexCount = reader.Read< uint32_t >();
+				uint32_t unMaterial = reader.Read< uint32_t >();
+				vkglTF::BoundingBox bb = reader.ReadBoundingBox();
+
+				reader.bValid = reader.bValid && unMaterial < pModel->materials.size() && uint64_t( unFirstIndex ) + unIndexCount <= header.unIndexCount;
+				if ( !reader.bValid )
+					break;
+
+				vkglTF::Primitive *pPrimitive = new vkglTF::Primitive( unFirstIndex, unIndexCount, unVertexCount, pModel->materials[ unMaterial ] );
+				pPrimitive->bb = bb;
+				pMesh->primitives.push_back( pPrimitive );
+			}
+		}
+
+		if ( !reader.bValid )
+		{
+			// nothing is linked yet, so each node only owns its mesh
+			for ( auto pNode : vecNodes )
+				delete pNode;
+
+			pModel->destroy( pVulkanDevice->logicalDevice );
+			LogError( "Mesh cache %s is corrupt, rebuilding.", sCacheFilename.c_str() );
+			return false;
+		}
+
+		for ( uint32_t i = 0; i < unNodeCount; i++ )
+		{
+			vkglTF::Node *pNode = vecNodes[ i ];
+			pNode->parent = vecParents[ i ] < 0 ? nullptr : vecNodes[ vecParents[ i ] ];
+
+			if ( pNode->parent )
+				pNode->parent->children.push_back( pNode );
+			else
+				pModel->nodes.push_back( pNode );
+
+			pModel->linearNodes.push_back( pNode );
+		}
+
+		auto NodeFromIndex = [ &vecNodes, &reader ]( int32_t nIndex ) -> vkglTF::Node *
+		{
+			if ( nIndex < 0 )
+				return nullptr;
+
+			reader.bValid = reader.bValid && static_cast< size_t >( nIndex ) < vecNodes.size();
+			return reader.bValid ? vecNodes[ nIndex ] : nullptr;
+		};
+
+		// ... skins
+		uint32_t unSkinCount = reader.Read< uint32_t >();
+		for ( uint32_t i = 0; i < unSkinCount && reader.bValid; i++ )
+		{
+			vkglTF::Skin *pSkin = new vkglTF::Skin {};
+			pModel->skins.push_back( pSkin );
+
+			pSkin->name = reader.ReadString();
+			pSkin->skeletonRoot = NodeFromIndex( reader.Read< int32_t >() );
+			pSkin->inverseBindMatrices = reader.ReadVector< glm::mat4 >();
+
+			uint32_t unJointCount = reader.Read< uint32_t >();
+			for ( uint32_t j = 0; j < unJointCount && reader.bValid; j++ )
+				pSkin->joints.push_back( NodeFromIndex( reader.Read< int32_t >() ) );
+		}
+
+		for ( auto pNode : pModel->linearNodes )
+		{
+			if ( pNode->skinIndex > -1 )
+			{
+				reader.bValid = reader.bValid && static_cast< size_t >( pNode->skinIndex ) < pModel->skins.size();
+				pNode->skin = reader.bValid ? pModel->skins[ pNode->skinIndex ] : nullptr;
+			}
+		}
+
+		// ... animations
+		uint32_t unAnimationCount = reader.Read< uint32_t >();
+		for ( uint32_t i = 0; i < unAnimationCount && reader.bValid; i++ )
+		{
+			vkglTF::Animation animation;
+			animation.name = reader.ReadString();
+			animation.start = reader.Read< float >();
+			animation.end = reader.Read< float >();
+
+			uint32_t unSamplerCount = reader.Read< uint32_t >();
+			for ( uint32_t j = 0; j < unSamplerCount && reader.bValid; j++ )
+			{
+				vkglTF::AnimationSampler sampler;
+				sampler.interpolation = static_cast< vkglTF::AnimationSampler::InterpolationType >( reader.Read< uint32_t >() );
+				sampler.inputs = reader.ReadVector< float >();
+				sampler.outputsVec4 = reader.ReadVector< glm::vec4 >();
+				animation.samplers.push_back( sampler );
+			}
+
+			uint32_t unChannelCount = reader.Read< uint32_t >();
+			for ( uint32_t j = 0; j < unChannelCount && reader.bValid; j++ )
+			{
+				vkglTF::AnimationChannel channel;
+				channel.path = static_cast< vkglTF::AnimationChannel::PathType >( reader.Read< uint32_t >() );
+				channel.node = NodeFromIndex( reader.Read< int32_t >() );
+				channel.samplerIndex = reader.Read< uint32_t >();
+
+				reader.bValid = reader.bValid && channel.node && channel.samplerIndex < animation.samplers.size();
+				animation.channels.push_back( channel );
+			}
+
+			pModel->animations.push_back( animation );
+		}
+
+		if ( !reader.bValid )
+		{
+			pModel->destroy( pVulkanDevice->logicalDevice );
+			LogError( "Mesh cache %s is corrupt, rebuilding.", sCacheFilename.c_str() );
+			return false;
+		}
+
+		// (3) Uploads read straight from the mapped file
+		pModel->pendingUpload = std::make_unique< vkglTF::Model::PendingUpload >();
+		vkglTF::Model::PendingUpload *pPending = pModel->pendingUpload.get();
+
+		pPending->vertexData = reinterpret_cast< const vkglTF::Model::Vertex * >( pData + header.unVertexOffset );
+		pPending->vertexCount = static_cast< size_t >( header.unVertexCount );
+		pPending->indexData = reinterpret_cast< const uint32_t * >( pData + header.unIndexOffset );
+		pPending->indexCount = static_cast< size_t >( header.unIndexCount );
+
+		pPending->textureData.resize( vecTextureHeaders.size() );
+		for ( size_t i = 0; i < vecTextureHeaders.size(); i++ )
+		{
+			pPending->textureData[ i ].data = pData + vecTextureHeaders[ i ].unDataOffset;
+			pPending->textureData[ i ].width = vecTextureHeaders[ i ].unWidth;
+			pPending->textureData[ i ].height = vecTextureHeaders[ i ].unHeight;
+			pPending->textureData[ i ].mipLevels = vecTextureHeaders[ i ].unMipLevels;
+			pPending->textureData[ i ].sampler = vecTextureHeaders[ i ].sampler;
+		}
+
+		pPending->sourceData = pFile;
+
+		// (4) Same end state as parseFromFile
+		pModel->createBuffers();
+		pModel->updateTransforms();
+		pModel->getSceneDimensions();
+
+		return true;
+	}
+
+	bool MeshCache::Save( const std::string &sCacheFilename, uint64_t unSourceHash, vkglTF::Model *pModel )
+	{
+		vkglTF::Model::PendingUpload *pPending = pModel->pendingUpload.get();
+		if ( sCacheFilename.empty() || unSourceHash == 0 || pPending == nullptr )
+			return false;
+
+		// (1) Model structure
+		MeshCacheWriter writer;
+
+		std::unordered_map< const vkglTF::Node *, int32_t > mapNodeIndices;
+		for ( size_t i = 0; i < pModel->linearNodes.size(); i++ )
+			mapNodeIndices[ pModel->linearNodes[ i ] ] = static_cast< int32_t >( i );
+
+		auto NodeIndex = [ &mapNodeIndices ]( const vkglTF::Node *pNode )
+		{
+			auto it = mapNodeIndices.find( pNode );
+			return it == mapNodeIndices.end() ? -1 : it->second;
+		};
+
+		auto TextureIndex = [ pModel ]( const vkglTF::Texture *pTexture ) { return pTexture ? static_cast< int32_t >( pTexture - pModel->textures.data() ) : -1; };
+
+		writer.WriteVector( pModel->textureSamplers );
+
+		writer.Write( static_cast< uint32_t >( pModel->materials.size() ) );
+		for ( auto &material : pModel->materials )
+		{
+			writer.Write( static_cast< uint32_t >( material.alphaMode ) );
+			writer.Write( material.alphaCutoff );
+			writer.Write( material.metallicFactor );
+			writer.Write( material.roughnessFactor );
+			writer.Write( material.baseColorFactor );
+			writer.Write( material.emissiveFactor );
+			writer.Write( TextureIndex( material.baseColorTexture ) );
+			writer.Write( TextureIndex( material.metallicRoughnessTexture ) );
+			writer.Write( TextureIndex( material.normalTexture ) );
+			writer.Write( TextureIndex( material.occlusionTexture ) );
+			writer.Write( TextureIndex( material.emissiveTexture ) );
+			writer.Write( TextureIndex( material.extension.specularGlossinessTexture ) );
+			writer.Write( TextureIndex( material.extension.diffuseTexture ) );
+			writer.Write( static_cast< uint8_t >( material.doubleSided ) );
+			writer.Write( material.texCoordSets );
+			writer.Write( material.extension.diffuseFactor );
+			writer.Write( material.extension.specularFactor );
+			writer.Write( static_cast< uint8_t >( material.pbrWorkflows.metallicRoughness ) );
+			writer.Write( static_cast< uint8_t >( material.pbrWorkflows.specularGlossiness ) );
+		}
+
+		writer.Write( static_cast< uint32_t >( pModel->extensions.size() ) );
+		for ( auto &sExtension : pModel->extensions )
+			writer.WriteString( sExtension );
+
+		writer.Write( static_cast< uint32_t >( pModel->linearNodes.size() ) );
+		for ( auto pNode : pModel->linearNodes )
+		{
+			writer.Write( NodeIndex( pNode->parent ) );
+			writer.Write( pNode->index );
+			writer.WriteString( pNode->name );
+			writer.Write( pNode->skinIndex );
+			writer.Write( pNode->matrix );
+			writer.Write( pNode->translation );
+			writer.Write( pNode->rotation );
+			writer.Write( pNode->scale );
+			writer.Write( static_cast< uint8_t >( pNode->mesh != nullptr ) );
+
+			if ( pNode->mesh == nullptr )
+				continue;
+
+			writer.WriteBoundingBox( pNode->mesh->bb );
+			writer.Write( static_cast< uint32_t >( pNode->mesh->primitives.size() ) );
+			for ( auto pPrimitive : pNode->mesh->primitives )
+			{
+				writer.Write( pPrimitive->firstIndex );
+				writer.Write( pPrimitive->indexCount );
+				writer.Write( pPrimitive->vertexCount );
+				writer.Write( static_cast< uint32_t >( &pPrimitive->material - pModel->materials.data() ) );
+				writer.WriteBoundingBox( pPrimitive->bb );
+			}
+		}
+
+		writer.Write( static_cast< uint32_t >( pModel->skins.size() ) );
+		for ( auto pSkin : pModel->skins )
+		{
+			writer.WriteString( pSkin->name );
+			writer.Write( NodeIndex( pSkin->skeletonRoot ) );
+			writer.WriteVector( pSkin->inverseBindMatrices );
+			writer.Write( static_cast< uint32_t >( pSkin->joints.size() ) );
+			for ( auto pJoint : pSkin->joints )
+				writer.Write( NodeIndex( pJoint ) );
+		}
+
+		writer.Write( static_cast< uint32_t >( pModel->animations.size() ) );
+		for ( auto &animation : pModel->animations )
+		{
+			writer.WriteString( animation.name );
+			writer.Write( animation.start );
+			writer.Write( animation.end );
+
+			writer.Write( static_cast< uint32_t >( animation.samplers.size() ) );
+			for ( auto &sampler : animation.samplers )
+			{
+				writer.Write( static_cast< uint32_t >( sampler.interpolation ) );
+				writer.WriteVector( sampler.inputs );
+				writer.WriteVector( sampler.outputsVec4 );
+			}
+
+			writer.Write( static_cast< uint32_t >( animation.channels.size() ) );
+			for ( auto &channel : animation.channels )
+			{
+				writer.Write( static_cast< uint32_t >( channel.path ) );
+				writer.Write( NodeIndex( channel.node ) );
+				writer.Write( channel.samplerIndex );
+			}
+		}
+
+		// (2) Textures with their full mip chains - slots sharing an image share its data
+		std::vector< TextureHeader > vecTextureHeaders( pPending->textureData.size() );
+		std::vector< std::vector< uint8_t > > vecImages;
+		std::map< const unsigned char *, size_t > mapImageIndices;
+		std::vector< size_t > vecTextureImages;
+
+		for ( size_t i = 0; i < pPending->textureData.size(); i++ )
+		{
+			const vkglTF::Model::PendingUpload::TextureData &textureData = pPending->textureData[ i ];
+			TextureHeader &textureHeader = vecTextureHeaders[ i ];
+			textureHeader.unWidth = textureData.width;
+			textureHeader.unHeight = textureData.height;
+			textureHeader.unMipLevels = static_cast< uint32_t >( floor( log2( std::max( textureData.width, textureData.height ) ) ) + 1.0 );
+			textureHeader.sampler = textureData.sampler;
+			textureHeader.unDataSize = vkglTF::Texture::getRGBASize( textureData.width, textureData.height, textureHeader.unMipLevels );
+
+			auto it = mapImageIndices.find( textureData.data );
+			if ( it == mapImageIndices.end() )
+			{
+				it = mapImageIndices.insert( { textureData.data, vecImages.size() } ).first;
+				vecImages.emplace_back();
+				GenerateMips( textureData.data, textureData.width, textureData.height, textureHeader.unMipLevels, vecImages.back() );
+			}
+
+			vecTextureImages.push_back( it->second );
+		}
+
+		// (3) Layout - header, texture table, model blob, then the aligned vertex, index and texture data
+		FileHeader header;
+		header.unSourceHash = unSourceHash;
+		header.unTextureCount = static_cast< uint32_t >( vecTextureHeaders.size() );
+		header.unVertexCount = pPending->vertexCount;
+		header.unIndexCount = pPending->indexCount;
+
+		uint64_t unOffset = AlignCacheOffset( sizeof( FileHeader ) + vecTextureHeaders.size() * sizeof( TextureHeader ) );
+		header.unModelOffset = unOffset;
+		header.unModelSize = writer.vecData.size();
+		unOffset = AlignCacheOffset( unOffset + header.unModelSize );
+
+		header.unVertexOffset = unOffset;
+		unOffset = AlignCacheOffset( unOffset + header.unVertexCount * sizeof( vkglTF::Model::Vertex ) );
+
+		header.unIndexOffset = unOffset;
+		unOffset = AlignCacheOffset( unOffset + header.unIndexCount * sizeof( uint32_t ) );
+
+		std::vector< uint64_t > vecImageOffsets;
+		for ( auto &vecImage : vecImages )
+		{
+			vecImageOffsets.push_back( unOffset );
+			unOffset = AlignCacheOffset( unOffset + vecImage.size() );
+		}
+
+		for ( size_t i = 0; i < vecTextureHeaders.size(); i++ )
+			vecTextureHeaders[ i ].unDataOffset = vecImageOffsets[ vecTextureImages[ i ] ];
+
+		header.unFileSize = unOffset;
+
+		// (4) Write to a temporary file first so a crash mid write never leaves a truncated cache behind
+		std::error_code errorCode;
+		std::filesystem::create_directories( std::filesystem::path( sCacheFilename ).parent_path(), errorCode );
+
+		std::stringstream ssTempFilename;
+		ssTempFilename << sCacheFilename << "." << std::this_thread::get_id() << ".tmp";
+		const std::string sTempFilename = ssTempFilename.str();
+
+		std::ofstream file( sTempFilename, std::ios::binary | std::ios::trunc );
+		if ( !file.is_open() )
+		{
+			LogError( "Unable to write to %s", sTempFilename.c_str() );
+			return false;
+		}
+
+		uint64_t unWritten = 0;
+		auto WriteSection = [ &file, &unWritten ]( uint64_t unSectionOffset, const void *pSectionData, uint64_t unSectionSize )
+		{
+			static const char pcPadding[ k_unMeshCacheAlignment ] = {};
+			file.write( pcPadding, static_cast< std::streamsize >( unSectionOffset - unWritten ) );
+			file.write( static_cast< const char * >( pSectionData ), static_cast< std::streamsize >( unSectionSize ) );
+			unWritten = unSectionOffset + unSectionSize;
+		};
+
+		WriteSection( 0, &header, sizeof( FileHeader ) );
+		WriteSection( sizeof( FileHeader ), vecTextureHeaders.data(), vecTextureHeaders.size() * sizeof( TextureHeader ) );
+		WriteSection( header.unModelOffset, writer.vecData.data(), header.unModelSize );
+		WriteSection( header.unVertexOffset, pPending->vertexData, header.unVertexCount * sizeof( vkglTF::Model::Vertex ) );
+		WriteSection( header.unIndexOffset, pPending->indexData, header.unIndexCount * sizeof( uint32_t ) );
+
+		for ( size_t i = 0; i < vecImages.size(); i++ )
+			WriteSection( vecImageOffsets[ i ], vecImages[ i ].data(), vecImages[ i ].size() );
+
+		WriteSection( header.unFileSize, nullptr, 0 );
+		file.close();
+
+		if ( file.fail() )
+		{
+			LogError( "Unable to write to %s", sTempFilename.c_str() );
+			std::filesystem::remove( sTempFilename, errorCode );
+			return false;
+		}
+
+		// Replace the previous file
+		std::filesystem::rename( sTempFilename, sCacheFilename, errorCode );
+		if ( errorCode )
+		{
+			LogError( "Unable to replace %s (%s)", sCacheFilename.c_str(), errorCode.message().c_str() );
+			std::filesystem::remove( sTempFilename, errorCode );
+			return false;
+		}
+
+		return true;
+	}
+
+	void MeshCache::GenerateMips( const uint8_t *pBaseLevel, uint32_t unWidth, uint32_t unHeight, uint32_t unMipLevels, std::vector< uint8_t > &vecMips )
+	{
+		vecMips.resize( static_cast< size_t >( vkglTF::Texture::getRGBASize( unWidth, unHeight, unMipLevels ) ) );
+		memcpy( vecMips.data(), pBaseLevel, size_t( unWidth ) * unHeight * 4 );
+
+		// 2x2 box filter of the previous mip, same as the linear blits done on upload without a cache
+		size_t unSrcOffset = 0;
+		size_t unDstOffset = size_t( unWidth ) * unHeight * 4;
+
+		for ( uint32_t i = 1; i < unMipLevels; i++ )
+		{
+			const uint32_t unSrcWidth = std::max( 1u, unWidth >> ( i - 1 ) );
+			const uint32_t unSrcHeight = std::max( 1u, unHeight >> ( i - 1 ) );
+			const uint32_t unDstWidth = std::max( 1u, unWidth >> i );
+			const uint32_t unDstHeight = std::max( 1u, unHeight >> i );
+
+			const uint8_t *pSrc = vecMips.data() + unSrcOffset;
+			uint8_t *pDst = vecMips.data() + unDstOffset;
+
+			for ( uint32_t y = 0; y < unDstHeight; y++ )
+			{
+				const uint32_t y0 = std::min( y * 2, unSrcHeight - 1 );
+				const uint32_t y1 = std::min( y * 2 + 1, unSrcHeight - 1 );
+
+				for ( uint32_t x = 0; x < unDstWidth; x++ )
+				{
+					const uint32_t x0 = std::min( x * 2, unSrcWidth - 1 );
+					const uint32_t x1 = std::min( x * 2 + 1, unSrcWidth - 1 );
+
+					for ( uint32_t c = 0; c < 4; c++ )
+					{
+						uint32_t unSum = pSrc[ ( y0 * unSrcWidth + x0 ) * 4 + c ] + pSrc[ ( y0 * unSrcWidth + x1 ) * 4 + c ] + pSrc[ ( y1 * unSrcWidth + x0 ) * 4 + c ] +
+										 pSrc[ ( y1 * unSrcWidth + x1 ) * 4 + c ];
+						pDst[ ( y * unDstWidth + x ) * 4 + c ] = static_cast< uint8_t >( ( unSum + 2 ) / 4 );
+					}
+				}
+			}
+
+			unSrcOffset = unDstOffset;
+			unDstOffset += size_t( unDstWidth ) * unDstHeight * 4;
+		}
+	}
+
+} // namespace xrvk
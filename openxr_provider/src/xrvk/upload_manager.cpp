@@ -0,0 +1,575 @@
+/* Copyright 2021, 2022, 2023 Rune Berg (GitHub: https://github.com/1runeberg, Twitter: https://twitter.com/1runeberg, YouTube: https://www.youtube.com/@1RuneBerg)
+ *
+ *  SPDX-License-Identifier: MIT
+ *
+ *  Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+ *
+ *  2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *
+ *  3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote products derived from this
+ *     software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ *  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+ *  BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ *  GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+ *  DAMAGE.
+ *
+ */
+
+
+#include <xrvk/upload_manager.hpp>
+
+namespace xrvk
+{
+	UploadManager::UploadManager(
+		vks::VulkanDevice *pVulkanDevice,
+		VkQueue vkTransferQueue,
+		uint32_t unTransferQueueFamilyIndex,
+		uint32_t unGraphicsQueueFamilyIndex,
+		bool bTimelineSemaphore,
+		VkDeviceSize unRingSize )
+		: m_pVulkanDevice( pVulkanDevice )
+		, m_vkTransferQueue( vkTransferQueue )
+		, m_unTransferQueueFamilyIndex( unTransferQueueFamilyIndex )
+		, m_unGraphicsQueueFamilyIndex( unGraphicsQueueFamilyIndex )
+		, m_unRingSize( unRingSize )
+	{
+		assert( pVulkanDevice );
+		assert( unRingSize > 0 && unRingSize % k_unStagingAlignment == 0 );
+
+		// (1) Persistently mapped staging ring
+		VK_CHECK_RESULT( m_pVulkanDevice->createBuffer(
+			VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, m_unRingSize, &m_vkRingBuffer, &m_RingMemory ) );
+		m_pRingData = static_cast< uint8_t * >( m_RingMemory.pMapped );
+
+		// (2) Command pool for the transfer queue, only used by the upload thread
+		m_vkCommandPool = m_pVulkanDevice->createCommandPool( m_unTransferQueueFamilyIndex );
+
+		// (3) Timeline semaphore signalled with each batch's token
+		if ( bTimelineSemaphore )
+		{
+			m_pfnGetSemaphoreCounterValue = ( PFN_vkGetSemaphoreCounterValueKHR )vkGetDeviceProcAddr( m_pVulkanDevice->logicalDevice, "vkGetSemaphoreCounterValueKHR" );
+			m_pfnWaitSemaphores = ( PFN_vkWaitSemaphoresKHR )vkGetDeviceProcAddr( m_pVulkanDevice->logicalDevice, "vkWaitSemaphoresKHR" );
+
+			if ( m_pfnGetSemaphoreCounterValue && m_pfnWaitSemaphores )
+			{
+				VkSemaphoreTypeCreateInfoKHR semaphoreTypeInfo { VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO_KHR };
+				semaphoreTypeInfo.semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE_KHR;
+				semaphoreTypeInfo.initialValue = 0;
+
+				VkSemaphoreCreateInfo semaphoreInfo { VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO };
+				semaphoreInfo.pNext = &semaphoreTypeInfo;
+				VK_CHECK_RESULT( vkCreateSemaphore( m_pVulkanDevice->logicalDevice, &semaphoreInfo, nullptr, &m_vkTimelineSemaphore ) );
+			}
+		}
+
+		LogInfo(
+			"Upload manager created with a %i MB staging ring on %s, tracking completion with %s.",
+			static_cast< uint32_t >( m_unRingSize / ( 1024 * 1024 ) ),
+			IsDedicatedTransferQueue() ? "a dedicated transfer queue" : "the graphics queue",
+			IsTimelineSemaphoreEnabled() ? "a timeline semaphore" : "fences" );
+	}
+
+	UploadManager::~UploadManager()
+	{
+		// (1) Let everything in flight finish
+		UploadToken unLastToken = Submit();
+		Wait( unLastToken );
+		RetireBatches( false );
+
+		// (2) Free the ring and sync objects
+		if ( m_vkTimelineSemaphore != VK_NULL_HANDLE )
+			vkDestroySemaphore( m_pVulkanDevice->logicalDevice, m_vkTimelineSemaphore, nullptr );
+
+		if ( m_vkCommandPool != VK_NULL_HANDLE )
+			vkDestroyCommandPool( m_pVulkanDevice->logicalDevice, m_vkCommandPool, nullptr );
+
+		if ( m_vkRingBuffer != VK_NULL_HANDLE )
+			vkDestroyBuffer( m_pVulkanDevice->logicalDevice, m_vkRingBuffer, nullptr );
+
+		m_pVulkanDevice->memoryAllocator->Free( m_RingMemory );
+	}
+
+	StagingRegion UploadManager::Stage( VkDeviceSize unSize )
+	{
+		StagingRegion region;
+		region.unSize = unSize;
+
+		RetireBatches( false );
+
+		// (1) Larger than the ring - dedicated staging buffer, freed with its batch
+		if ( unSize > m_unRingSize )
+		{
+			LogVerbose( "Upload of %llu bytes exceeds the staging ring, using a dedicated staging buffer.", static_cast< unsigned long long >( unSize ) );
+
+			DedicatedStaging staging;
+			VK_CHECK_RESULT( m_pVulkanDevice->createBuffer(
+				VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, unSize, &staging.vkBuffer, &staging.memory ) );
+			region.pData = staging.memory.pMapped;
+
+			region.vkBuffer = staging.vkBuffer;
+			m_vecCurrentDedicatedStaging.push_back( staging );
+			return region;
+		}
+
+		// (2) Align, and move to the start of the ring if the region would wrap around
+		VkDeviceSize unStart = ( m_unRingHead + k_unStagingAlignment - 1 ) & ~( k_unStagingAlignment - 1 );
+		if ( ( unStart % m_unRingSize ) + unSize > m_unRingSize )
+			unStart = ( unStart / m_unRingSize + 1 ) * m_unRingSize;
+
+		// (3) Free up space until the region fits - this blocks the upload thread, never the render loop
+		while ( unStart + unSize - m_unRingTail > m_unRingSize )
+		{
+			// ... nothing in use, the ring starts over at this region
+			if ( m_unRingTail == m_unRingHead )
+			{
+				m_unRingTail = m_unRingHead = unStart;
+				break;
+			}
+
+			// ... the batch being recorded holds the space
+			if ( m_deqBatches.empty() )
+				Submit();
+
+			// ... staged but never copied
+			if ( m_deqBatches.empty() )
+			{
+				m_unRingTail = m_unRingHead;
+				continue;
+			}
+
+			RetireBatches( true );
+		}
+
+		m_unRingHead = unStart + unSize;
+
+		region.vkBuffer = m_vkRingBuffer;
+		region.unOffset = unStart % m_unRingSize;
+		region.pData = m_pRingData + region.unOffset;
+		return region;
+	}
+
+	void UploadManager::CopyBuffer( const StagingRegion &region, VkBuffer vkBuffer, VkDeviceSize unDstOffset )
+	{
+		VkCommandBuffer vkCommandBuffer = GetCommandBuffer();
+
+		VkBufferCopy copyRegion {};
+		copyRegion.srcOffset = region.unOffset;
+		copyRegion.dstOffset = unDstOffset;
+		copyRegion.size = region.unSize;
+		vkCmdCopyBuffer( vkCommandBuffer, region.vkBuffer, vkBuffer, 1, &copyRegion );
+
+		GraphicsWork work;
+		work.vkBuffer = vkBuffer;
+		work.unOffset = unDstOffset;
+		work.unSize = region.unSize;
+
+		// Release to the graphics queue family, the matching acquire is recorded by RecordGraphicsWork
+		if ( IsDedicatedTransferQueue() )
+		{
+			VkBufferMemoryBarrier bufferBarrier { VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER };
+			bufferBarrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+			bufferBarrier.dstAccessMask = 0;
+			bufferBarrier.srcQueueFamilyIndex = m_unTransferQueueFamilyIndex;
+			bufferBarrier.dstQueueFamilyIndex = m_unGraphicsQueueFamilyIndex;
+			bufferBarrier.buffer = vkBuffer;
+			bufferBarrier.offset = work.unOffset;
+			bufferBarrier.size = work.unSize;
+			vkCmdPipelineBarrier( vkCommandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, 0, 0, nullptr, 1, &bufferBarrier, 0, nullptr );
+		}
+
+		m_vecPendingGraphicsWork.push_back( work );
+	}
+
+	void UploadManager::CopyImage( const StagingRegion &region, VkImage vkImage, uint32_t unWidth, uint32_t unHeight, uint32_t unMipLevels, uint32_t unStagedMipLevels )
+	{
+		assert( unStagedMipLevels == 1 || unStagedMipLevels == unMipLevels );
+
+		VkCommandBuffer vkCommandBuffer = GetCommandBuffer();
+		const bool bGenerateMips = unStagedMipLevels < unMipLevels;
+
+		VkImageSubresourceRange stagedRange {};
+		stagedRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+		stagedRange.levelCount = unStagedMipLevels;
+		stagedRange.layerCount = 1;
+
+		// (1) Copy the staged mips
+		{
+			VkImageMemoryBarrier imageBarrier { VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER };
+			imageBarrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+			imageBarrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+			imageBarrier.srcAccessMask = 0;
+			imageBarrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+			imageBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+			imageBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+			imageBarrier.image = vkImage;
+			imageBarrier.subresourceRange = stagedRange;
+			vkCmdPipelineBarrier( vkCommandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, nullptr, 0, nullptr, 1, &imageBarrier );
+		}
+
+		std::vector< VkBufferImageCopy > vecCopyRegions( unStagedMipLevels );
+		VkDeviceSize unOffset = region.unOffset;
+		for ( uint32_t i = 0; i < unStagedMipLevels; i++ )
+		{
+			const uint32_t unMipWidth = std::max( 1u, unWidth >> i );
+			const uint32_t unMipHeight = std::max( 1u, unHeight >> i );
+
+			VkBufferImageCopy &copyRegion = vecCopyRegions[ i ];
+			copyRegion.bufferOffset = unOffset;
+			copyRegion.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+			copyRegion.imageSubresource.mipLevel = i;
+			copyRegion.imageSubresource.baseArrayLayer = 0;
+			copyRegion.imageSubresource.layerCount = 1;
+			copyRegion.imageExtent = { unMipWidth, unMipHeight, 1 };
+
+			unOffset += VkDeviceSize( unMipWidth ) * unMipHeight * 4;
+		}
+
+		vkCmdCopyBufferToImage(
+			vkCommandBuffer, region.vkBuffer, vkImage, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, static_cast< uint32_t >( vecCopyRegions.size() ), vecCopyRegions.data() );
+
+		// (2) Mip 0 becomes the blit source for the remaining mips, or the image is ready for sampling
+		const VkImageLayout vkStagedLayout = bGenerateMips ? VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL : VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+
+		VkImageMemoryBarrier imageBarrier { VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER };
+		imageBarrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+		imageBarrier.newLayout = vkStagedLayout;
+		imageBarrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+		imageBarrier.image = vkImage;
+		imageBarrier.subresourceRange = stagedRange;
+
+		if ( IsDedicatedTransferQueue() )
+		{
+			// ... released to the graphics queue family (with the layout change), transfer queues can't blit so mips are generated there
+			imageBarrier.dstAccessMask = 0;
+			imageBarrier.srcQueueFamilyIndex = m_unTransferQueueFamilyIndex;
+			imageBarrier.dstQueueFamilyIndex = m_unGraphicsQueueFamilyIndex;
+			vkCmdPipelineBarrier( vkCommandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, 0, 0, nullptr, 0, nullptr, 1, &imageBarrier );
+
+			GraphicsWork work;
+			work.vkImage = vkImage;
+			work.unWidth = unWidth;
+			work.unHeight = unHeight;
+			work.unMipLevels = unMipLevels;
+			work.bGenerateMips = bGenerateMips;
+			m_vecPendingGraphicsWork.push_back( work );
+			return;
+		}
+
+		// ... same queue, mips are generated right away
+		imageBarrier.dstAccessMask = bGenerateMips ? VK_ACCESS_TRANSFER_READ_BIT : VK_ACCESS_SHADER_READ_BIT;
+		imageBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		imageBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		vkCmdPipelineBarrier(
+			vkCommandBuffer,
+			VK_PIPELINE_STAGE_TRANSFER_BIT,
+			bGenerateMips ? VK_PIPELINE_STAGE_TRANSFER_BIT : VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
+			0,
+			0,
+			nullptr,
+			0,
+			nullptr,
+			1,
+			&imageBarrier );
+
+		if ( bGenerateMips )
+			GenerateMips( vkCommandBuffer, vkImage, unWidth, unHeight, unMipLevels );
+	}
+
+	UploadToken UploadManager::Submit()
+	{
+		// (1) Nothing recorded since the last batch
+		if ( m_vkCurrentCommandBuffer == VK_NULL_HANDLE )
+			return m_unNextToken - 1;
+
+		VK_CHECK_RESULT( vkEndCommandBuffer( m_vkCurrentCommandBuffer ) );
+
+		Batch batch;
+		batch.unToken = m_unNextToken++;
+		batch.vkCommandBuffer = m_vkCurrentCommandBuffer;
+		batch.unRingEnd = m_unRingHead;
+		batch.vecDedicatedStaging.swap( m_vecCurrentDedicatedStaging );
+		m_vkCurrentCommandBuffer = VK_NULL_HANDLE;
+
+		// (2) Graphics queue side of this batch, recorded once the batch is complete
+		{
+			std::lock_guard< std::mutex > lock( m_mutexGraphicsWork );
+			for ( auto &work : m_vecPendingGraphicsWork )
+			{
+				work.unToken = batch.unToken;
+				m_deqGraphicsWork.push_back( work );
+			}
+		}
+		m_vecPendingGraphicsWork.clear();
+
+		// (3) Submit, signalling the batch's token
+		VkSubmitInfo submitInfo { VK_STRUCTURE_TYPE_SUBMIT_INFO };
+		submitInfo.commandBufferCount = 1;
+		submitInfo.pCommandBuffers = &batch.vkCommandBuffer;
+
+		VkTimelineSemaphoreSubmitInfoKHR timelineSubmitInfo { VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO_KHR };
+		if ( IsTimelineSemaphoreEnabled() )
+		{
+			timelineSubmitInfo.signalSemaphoreValueCount = 1;
+			timelineSubmitInfo.pSignalSemaphoreValues = &batch.unToken;
+
+			submitInfo.pNext = &timelineSubmitInfo;
+			submitInfo.signalSemaphoreCount = 1;
+			submitInfo.pSignalSemaphores = &m_vkTimelineSemaphore;
+		}
+		else
+		{
+			VkFenceCreateInfo fenceInfo { VK_STRUCTURE_TYPE_FENCE_CREATE_INFO };
+			VK_CHECK_RESULT( vkCreateFence( m_pVulkanDevice->logicalDevice, &fenceInfo, nullptr, &batch.vkFence ) );
+		}
+
+		{
+			// ... the graphics queue is shared with the render loop
+			std::unique_lock< std::mutex > lock( m_pVulkanDevice->queueMutex, std::defer_lock );
+			if ( !IsDedicatedTransferQueue() )
+				lock.lock();
+
+			VK_CHECK_RESULT( vkQueueSubmit( m_vkTransferQueue, 1, &submitInfo, batch.vkFence ) );
+		}
+
+		m_deqBatches.push_back( std::move( batch ) );
+		return m_deqBatches.back().unToken;
+	}
+
+	void UploadManager::Wait( UploadToken unToken )
+	{
+		while ( !IsComplete( unToken ) && !m_deqBatches.empty() )
+			RetireBatches( true );
+	}
+
+	UploadToken UploadManager::GetCompletedToken()
+	{
+		if ( !IsTimelineSemaphoreEnabled() )
+			return m_unCompletedToken.load();
+
+		uint64_t unValue = 0;
+		VK_CHECK_RESULT( m_pfnGetSemaphoreCounterValue( m_pVulkanDevice->logicalDevice, m_vkTimelineSemaphore, &unValue ) );
+		return unValue;
+	}
+
+	uint32_t UploadManager::RecordGraphicsWork( VkCommandBuffer vkCommandBuffer )
+	{
+		// (1) Take the work of all completed batches
+		const UploadToken unCompletedToken = GetCompletedToken();
+
+		std::vector< GraphicsWork > vecWork;
+		{
+			std::lock_guard< std::mutex > lock( m_mutexGraphicsWork );
+			while ( !m_deqGraphicsWork.empty() && m_deqGraphicsWork.front().unToken <= unCompletedToken )
+			{
+				vecWork.push_back( m_deqGraphicsWork.front() );
+				m_deqGraphicsWork.pop_front();
+			}
+		}
+
+		if ( vecWork.empty() )
+		{
+			m_unRecordedToken = unCompletedToken;
+			return 0;
+		}
+
+		// (2) Same queue - the copies are earlier in submission order, so a memory barrier makes them visible to the draws that follow
+		if ( !IsDedicatedTransferQueue() )
+		{
+			VkMemoryBarrier memoryBarrier { VK_STRUCTURE_TYPE_MEMORY_BARRIER };
+			memoryBarrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+			memoryBarrier.dstAccessMask = VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT | VK_ACCESS_INDEX_READ_BIT | VK_ACCESS_SHADER_READ_BIT;
+			vkCmdPipelineBarrier(
+				vkCommandBuffer,
+				VK_PIPELINE_STAGE_TRANSFER_BIT,
+				VK_PIPELINE_STAGE_VERTEX_INPUT_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
+				0,
+				1,
+				&memoryBarrier,
+				0,
+				nullptr,
+				0,
+				nullptr );
+
+			m_unRecordedToken = unCompletedToken;
+			return static_cast< uint32_t >( vecWork.size() );
+		}
+
+		// (3) Dedicated transfer queue - acquire everything the transfer queue released (same ranges and layouts as the release)
+		std::vector< VkBufferMemoryBarrier > vecBufferBarriers;
+		std::vector< VkImageMemoryBarrier > vecImageBarriers;
+
+		for ( auto &work : vecWork )
+		{
+			if ( work.vkBuffer != VK_NULL_HANDLE )
+			{
+				VkBufferMemoryBarrier bufferBarrier { VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER };
+				bufferBarrier.srcAccessMask = 0;
+				bufferBarrier.dstAccessMask = VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT | VK_ACCESS_INDEX_READ_BIT;
+				bufferBarrier.srcQueueFamilyIndex = m_unTransferQueueFamilyIndex;
+				bufferBarrier.dstQueueFamilyIndex = m_unGraphicsQueueFamilyIndex;
+				bufferBarrier.buffer = work.vkBuffer;
+				bufferBarrier.offset = work.unOffset;
+				bufferBarrier.size = work.unSize;
+				vecBufferBarriers.push_back( bufferBarrier );
+			}
+			else
+			{
+				VkImageMemoryBarrier imageBarrier { VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER };
+				imageBarrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+				imageBarrier.newLayout = work.bGenerateMips ? VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL : VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+				imageBarrier.srcAccessMask = 0;
+				imageBarrier.dstAccessMask = work.bGenerateMips ? VK_ACCESS_TRANSFER_READ_BIT : VK_ACCESS_SHADER_READ_BIT;
+				imageBarrier.srcQueueFamilyIndex = m_unTransferQueueFamilyIndex;
+				imageBarrier.dstQueueFamilyIndex = m_unGraphicsQueueFamilyIndex;
+				imageBarrier.image = work.vkImage;
+				imageBarrier.subresourceRange = { VK_IMAGE_ASPECT_COLOR_BIT, 0, work.bGenerateMips ? 1 : work.unMipLevels, 0, 1 };
+				vecImageBarriers.push_back( imageBarrier );
+			}
+		}
+
+		vkCmdPipelineBarrier(
+			vkCommandBuffer,
+			VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
+			VK_PIPELINE_STAGE_VERTEX_INPUT_BIT | VK_PIPELINE_STAGE_TRANSFER_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
+			0,
+			0,
+			nullptr,
+			static_cast< uint32_t >( vecBufferBarriers.size() ),
+			vecBufferBarriers.data(),
+			static_cast< uint32_t >( vecImageBarriers.size() ),
+			vecImageBarriers.data() );
+
+		// (4) Generate the mips of acquired images
+		for ( auto &work : vecWork )
+		{
+			if ( work.vkImage != VK_NULL_HANDLE && work.bGenerateMips )
+				GenerateMips( vkCommandBuffer, work.vkImage, work.unWidth, work.unHeight, work.unMipLevels );
+		}
+
+		m_unRecordedToken = unCompletedToken;
+		return static_cast< uint32_t >( vecWork.size() );
+	}
+
+	void UploadManager::SubmitGraphicsWork( VkQueue vkGraphicsQueue )
+	{
+		VkCommandBuffer vkCommandBuffer = m_pVulkanDevice->createCommandBuffer( VK_COMMAND_BUFFER_LEVEL_PRIMARY, true );
+		RecordGraphicsWork( vkCommandBuffer );
+		m_pVulkanDevice->flushCommandBuffer( vkCommandBuffer, vkGraphicsQueue, true );
+	}
+
+	VkCommandBuffer UploadManager::GetCommandBuffer()
+	{
+		if ( m_vkCurrentCommandBuffer != VK_NULL_HANDLE )
+			return m_vkCurrentCommandBuffer;
+
+		m_vkCurrentCommandBuffer = m_pVulkanDevice->createCommandBuffer( VK_COMMAND_BUFFER_LEVEL_PRIMARY, m_vkCommandPool, false );
+
+		VkCommandBufferBeginInfo beginInfo { VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO };
+		beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+		VK_CHECK_RESULT( vkBeginCommandBuffer( m_vkCurrentCommandBuffer, &beginInfo ) );
+
+		return m_vkCurrentCommandBuffer;
+	}
+
+	void UploadManager::RetireBatches( bool bWaitOldest )
+	{
+		while ( !m_deqBatches.empty() )
+		{
+			Batch &batch = m_deqBatches.front();
+
+			// (1) Check (or wait for) completion
+			if ( IsTimelineSemaphoreEnabled() )
+			{
+				if ( GetCompletedToken() < batch.unToken )
+				{
+					if ( !bWaitOldest )
+						break;
+
+					VkSemaphoreWaitInfoKHR waitInfo { VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO_KHR };
+					waitInfo.semaphoreCount = 1;
+					waitInfo.pSemaphores = &m_vkTimelineSemaphore;
+					waitInfo.pValues = &batch.unToken;
+					VK_CHECK_RESULT( m_pfnWaitSemaphores( m_pVulkanDevice->logicalDevice, &waitInfo, UINT64_MAX ) );
+				}
+			}
+			else if ( vkGetFenceStatus( m_pVulkanDevice->logicalDevice, batch.vkFence ) != VK_SUCCESS )
+			{
+				if ( !bWaitOldest )
+					break;
+
+				VK_CHECK_RESULT( vkWaitForFences( m_pVulkanDevice->logicalDevice, 1, &batch.vkFence, VK_TRUE, UINT64_MAX ) );
+			}
+
+			// ... only wait for a single batch
+			bWaitOldest = false;
+
+			// (2) Free its resources and staging space
+			vkFreeCommandBuffers( m_pVulkanDevice->logicalDevice, m_vkCommandPool, 1, &batch.vkCommandBuffer );
+
+			if ( batch.vkFence != VK_NULL_HANDLE )
+				vkDestroyFence( m_pVulkanDevice->logicalDevice, batch.vkFence, nullptr );
+
+			for ( auto &staging : batch.vecDedicatedStaging )
+			{
+				vkDestroyBuffer( m_pVulkanDevice->logicalDevice, staging.vkBuffer, nullptr );
+				m_pVulkanDevice->memoryAllocator->Free( staging.memory );
+			}
+
+			m_unRingTail = batch.unRingEnd;
+			m_unCompletedToken = batch.unToken;
+			m_deqBatches.pop_front();
+		}
+	}
+
+	void UploadManager::GenerateMips( VkCommandBuffer vkCommandBuffer, VkImage vkImage, uint32_t unWidth, uint32_t unHeight, uint32_t unMipLevels )
+	{
+		// mip 0 is in transfer src layout, each mip is blitted from the previous one
+		for ( uint32_t i = 1; i < unMipLevels; i++ )
+		{
+			VkImageSubresourceRange mipRange { VK_IMAGE_ASPECT_COLOR_BIT, i, 1, 0, 1 };
+
+			VkImageMemoryBarrier imageBarrier { VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER };
+			imageBarrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+			imageBarrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+			imageBarrier.srcAccessMask = 0;
+			imageBarrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+			imageBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+			imageBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+			imageBarrier.image = vkImage;
+			imageBarrier.subresourceRange = mipRange;
+			vkCmdPipelineBarrier( vkCommandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, nullptr, 0, nullptr, 1, &imageBarrier );
+
+			VkImageBlit imageBlit {};
+			imageBlit.srcSubresource = { VK_IMAGE_ASPECT_COLOR_BIT, i - 1, 0, 1 };
+			imageBlit.srcOffsets[ 1 ] = { std::max( 1, int32_t( unWidth >> ( i - 1 ) ) ), std::max( 1, int32_t( unHeight >> ( i - 1 ) ) ), 1 };
+			imageBlit.dstSubresource = { VK_IMAGE_ASPECT_COLOR_BIT, i, 0, 1 };
+			imageBlit.dstOffsets[ 1 ] = { std::max( 1, int32_t( unWidth >> i ) ), std::max( 1, int32_t( unHeight >> i ) ), 1 };
+			vkCmdBlitImage( vkCommandBuffer, vkImage, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, vkImage, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &imageBlit, VK_FILTER_LINEAR );
+
+			imageBarrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+			imageBarrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+			imageBarrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+			imageBarrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+			vkCmdPipelineBarrier( vkCommandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, nullptr, 0, nullptr, 1, &imageBarrier );
+		}
+
+		// all mips ready for sampling
+		VkImageMemoryBarrier imageBarrier { VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER };
+		imageBarrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+		imageBarrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+		imageBarrier.srcAccessMask = VK_ACCESS_TRANSFER_READ_BIT | VK_ACCESS_TRANSFER_WRITE_BIT;
+		imageBarrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+		imageBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		imageBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		imageBarrier.image = vkImage;
+		imageBarrier.subresourceRange = { VK_IMAGE_ASPECT_COLOR_BIT, 0, unMipLevels, 0, 1 };
+		vkCmdPipelineBarrier( vkCommandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, 0, 0, nullptr, 0, nullptr, 1, &imageBarrier );
+	}
+
+} // namespace xrvk
@@ -14,6 +14,7 @@
 #define STBI_MSC_SECURE_CRT
 
 #include <xrvk/vulkanpbr/VulkanglTFModel.h>
+#include <xrvk/upload_manager.hpp>
 
 namespace vkglTF
 {
@@ -61,76 +62,64 @@ namespace vkglTF
 
 	void Texture::destroy()
 	{
-		vkDestroyImageView(device->logicalDevice, view, nullptr);
-		vkDestroyImage(device->logicalDevice, image, nullptr);
-		vkFreeMemory(device->logicalDevice, deviceMemory, nullptr);
-		vkDestroySampler(device->logicalDevice, sampler, nullptr);
+		// Slots of a model that was cancelled or failed before its upload are still empty
+		if (device == nullptr) {
+			return;
+		}
+		if (view != VK_NULL_HANDLE) {
+			vkDestroyImageView(device->logicalDevice, view, nullptr);
+		}
+		if (image != VK_NULL_HANDLE) {
+			vkDestroyImage(device->logicalDevice, image, nullptr);
+		}
+		device->memoryAllocator->Free(deviceMemory);
+		if (sampler != VK_NULL_HANDLE) {
+			vkDestroySampler(device->logicalDevice, sampler, nullptr);
+		}
 	}
 
-	void Texture::fromglTfImage(tinygltf::Image &gltfimage, TextureSampler textureSampler, vks::VulkanDevice *device, VkQueue copyQueue)
+	void Texture::copyRGBA(const tinygltf::Image &gltfimage, unsigned char *dst)
 	{
-		this->device = device;
-
-		unsigned char* buffer = nullptr;
-		VkDeviceSize bufferSize = 0;
-		bool deleteBuffer = false;
 		if (gltfimage.component == 3) {
 			// Most devices don't support RGB only on Vulkan so convert if necessary
 			// TODO: Check actual format support and transform only if required
-			bufferSize = gltfimage.width * gltfimage.height * 4;
-			buffer = new unsigned char[bufferSize];
-			unsigned char* rgba = buffer;
-			unsigned char* rgb = &gltfimage.image[0];
-			for (int32_t i = 0; i< gltfimage.width * gltfimage.height; ++i) {
+			const unsigned char* rgb = &gltfimage.image[0];
+			for (int32_t i = 0; i < gltfimage.width * gltfimage.height; ++i) {
 				for (int32_t j = 0; j < 3; ++j) {
-					rgba[j] = rgb[j];
+					dst[j] = rgb[j];
 				}
-				rgba += 4;
+				dst += 4;
 				rgb += 3;
 			}
-			deleteBuffer = true;
 		}
 		else {
-			buffer = &gltfimage.image[0];
-			bufferSize = gltfimage.image.size();
+			memcpy(dst, &gltfimage.image[0], std::min(gltfimage.image.size(), size_t(gltfimage.width) * gltfimage.height * 4));
 		}
+	}
 
-		VkFormat format = VK_FORMAT_R8G8B8A8_UNORM;
-
-		VkFormatProperties formatProperties;
+	VkDeviceSize Texture::getRGBASize(uint32_t width, uint32_t height, uint32_t mipLevels)
+	{
+		VkDeviceSize size = 0;
+		for (uint32_t i = 0; i < mipLevels; i++) {
+			size += VkDeviceSize(std::max(1u, width >> i)) * std::max(1u, height >> i) * 4;
+		}
+		return size;
+	}
 
-		width = gltfimage.width;
-		height = gltfimage.height;
+	void Texture::createImage(uint32_t width, uint32_t height, TextureSampler textureSampler, vks::VulkanDevice *device)
+	{
+		this->device = device;
+		this->width = width;
+		this->height = height;
 		mipLevels = static_cast<uint32_t>(floor(log2(std::max(width, height))) + 1.0);
 
+		VkFormat format = VK_FORMAT_R8G8B8A8_UNORM;
+
+		VkFormatProperties formatProperties;
 		vkGetPhysicalDeviceFormatProperties(device->physicalDevice, format, &formatProperties);
 		assert(formatProperties.optimalTilingFeatures & VK_FORMAT_FEATURE_BLIT_SRC_BIT);
 		assert(formatProperties.optimalTilingFeatures & VK_FORMAT_FEATURE_BLIT_DST_BIT);
 
-		VkMemoryAllocateInfo memAllocInfo{};
-		memAllocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
-		VkMemoryRequirements memReqs{};
-
-		VkBuffer stagingBuffer;
-		VkDeviceMemory stagingMemory;
-
-		VkBufferCreateInfo bufferCreateInfo{};
-		bufferCreateInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
-		bufferCreateInfo.size = bufferSize;
-		bufferCreateInfo.usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
-		bufferCreateInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
-		VK_CHECK_RESULT(vkCreateBuffer(device->logicalDevice, &bufferCreateInfo, nullptr, &stagingBuffer));
-		vkGetBufferMemoryRequirements(device->logicalDevice, stagingBuffer, &memReqs);
-		memAllocInfo.allocationSize = memReqs.size;
-		memAllocInfo.memoryTypeIndex = device->getMemoryType(memReqs.memoryTypeBits, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
-		VK_CHECK_RESULT(vkAllocateMemory(device->logicalDevice, &memAllocInfo, nullptr, &stagingMemory));
-		VK_CHECK_RESULT(vkBindBufferMemory(device->logicalDevice, stagingBuffer, stagingMemory, 0));
-
-		uint8_t *data;
-		VK_CHECK_RESULT(vkMapMemory(device->logicalDevice, stagingMemory, 0, memReqs.size, 0, (void **)&data));
-		memcpy(data, buffer, bufferSize);
-		vkUnmapMemory(device->logicalDevice, stagingMemory);
-
 		VkImageCreateInfo imageCreateInfo{};
 		imageCreateInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
 		imageCreateInfo.imageType = VK_IMAGE_TYPE_2D;
@@ -139,19 +128,66 @@ namespace vkglTF
 		imageCreateInfo.arrayLayers = 1;
 		imageCreateInfo.samples = VK_SAMPLE_COUNT_1_BIT;
 		imageCreateInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
-		imageCreateInfo.usage = VK_IMAGE_USAGE_SAMPLED_BIT;
 		imageCreateInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
 		imageCreateInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
 		imageCreateInfo.extent = { width, height, 1 };
 		imageCreateInfo.usage = VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
 		VK_CHECK_RESULT(vkCreateImage(device->logicalDevice, &imageCreateInfo, nullptr, &image));
-		vkGetImageMemoryRequirements(device->logicalDevice, image, &memReqs);
-		memAllocInfo.allocationSize = memReqs.size;
-		memAllocInfo.memoryTypeIndex = device->getMemoryType(memReqs.memoryTypeBits, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
-		VK_CHECK_RESULT(vkAllocateMemory(device->logicalDevice, &memAllocInfo, nullptr, &deviceMemory));
-		VK_CHECK_RESULT(vkBindImageMemory(device->logicalDevice, image, deviceMemory, 0));
+		VK_CHECK_RESULT(device->memoryAllocator->AllocateImage(image, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, &deviceMemory));
 
-		VkCommandBuffer copyCmd = device->createCommandBuffer(VK_COMMAND_BUFFER_LEVEL_PRIMARY, true);
+		VkSamplerCreateInfo samplerInfo{};
+		samplerInfo.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
+		samplerInfo.magFilter = textureSampler.magFilter;
+		samplerInfo.minFilter = textureSampler.minFilter;
+		samplerInfo.mipmapMode = VK_SAMPLER_MIPMAP_MODE_LINEAR;
+		samplerInfo.addressModeU = textureSampler.addressModeU;
+		samplerInfo.addressModeV = textureSampler.addressModeV;
+		samplerInfo.addressModeW = textureSampler.addressModeW;
+		samplerInfo.compareOp = VK_COMPARE_OP_NEVER;
+		samplerInfo.borderColor = VK_BORDER_COLOR_FLOAT_OPAQUE_WHITE;
+		samplerInfo.maxAnisotropy = 1.0;
+		samplerInfo.anisotropyEnable = VK_FALSE;
+		samplerInfo.maxLod = (float)mipLevels;
+		samplerInfo.maxAnisotropy = 8.0f;
+		samplerInfo.anisotropyEnable = VK_TRUE;
+		VK_CHECK_RESULT(vkCreateSampler(device->logicalDevice, &samplerInfo, nullptr, &sampler));
+
+		VkImageViewCreateInfo viewInfo{};
+		viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+		viewInfo.image = image;
+		viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+		viewInfo.format = format;
+		viewInfo.components = { VK_COMPONENT_SWIZZLE_R, VK_COMPONENT_SWIZZLE_G, VK_COMPONENT_SWIZZLE_B, VK_COMPONENT_SWIZZLE_A };
+		viewInfo.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+		viewInfo.subresourceRange.layerCount = 1;
+		viewInfo.subresourceRange.levelCount = mipLevels;
+		VK_CHECK_RESULT(vkCreateImageView(device->logicalDevice, &viewInfo, nullptr, &view));
+
+		// Layout once the uploads are done
+		imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+		updateDescriptor();
+	}
+
+	void Texture::fromglTfImage(tinygltf::Image &gltfimage, TextureSampler textureSampler, vks::VulkanDevice *device, VkQueue copyQueue, VkCommandPool commandPool)
+	{
+		VkCommandPool pool = commandPool != VK_NULL_HANDLE ? commandPool : device->commandPool;
+
+		createImage(gltfimage.width, gltfimage.height, textureSampler, device);
+
+		VkDeviceSize bufferSize = width * height * 4;
+
+		VkBuffer stagingBuffer;
+		xrvk::MemoryAllocation stagingMemory;
+		VK_CHECK_RESULT(device->createBuffer(
+			VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+			VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+			bufferSize,
+			&stagingBuffer,
+			&stagingMemory));
+
+		copyRGBA(gltfimage, static_cast<unsigned char*>(stagingMemory.pMapped));
+
+		VkCommandBuffer copyCmd = device->createCommandBuffer(VK_COMMAND_BUFFER_LEVEL_PRIMARY, pool, true);
 
 		VkImageSubresourceRange subresourceRange = {};
 		subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
@@ -193,13 +229,13 @@ namespace vkglTF
 			vkCmdPipelineBarrier(copyCmd, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, 0, 0, nullptr, 0, nullptr, 1, &imageMemoryBarrier);
 		}
 
-		device->flushCommandBuffer(copyCmd, copyQueue, true);
+		device->flushCommandBuffer(copyCmd, copyQueue, pool, true);
 
-		vkFreeMemory(device->logicalDevice, stagingMemory, nullptr);
+		device->memoryAllocator->Free(stagingMemory);
 		vkDestroyBuffer(device->logicalDevice, stagingBuffer, nullptr);
 
 		// Generate the mip chain (glTF uses jpg and png, so we need to create this manually)
-		VkCommandBuffer blitCmd = device->createCommandBuffer(VK_COMMAND_BUFFER_LEVEL_PRIMARY, true);
+		VkCommandBuffer blitCmd = device->createCommandBuffer(VK_COMMAND_BUFFER_LEVEL_PRIMARY, pool, true);
 		for (uint32_t i = 1; i < mipLevels; i++) {
 			VkImageBlit imageBlit{};
 
@@ -251,7 +287,6 @@ namespace vkglTF
 		}
 
 		subresourceRange.levelCount = mipLevels;
-		imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
 
 		{
 			VkImageMemoryBarrier imageMemoryBarrier{};
@@ -265,43 +300,7 @@ namespace vkglTF
 			vkCmdPipelineBarrier(blitCmd, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, 0, 0, nullptr, 0, nullptr, 1, &imageMemoryBarrier);
 		}
 
-		device->flushCommandBuffer(blitCmd, copyQueue, true);
-
-		VkSamplerCreateInfo samplerInfo{};
-		samplerInfo.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
-		samplerInfo.magFilter = textureSampler.magFilter;
-		samplerInfo.minFilter = textureSampler.minFilter;
-		samplerInfo.mipmapMode = VK_SAMPLER_MIPMAP_MODE_LINEAR;
-		samplerInfo.addressModeU = textureSampler.addressModeU;
-		samplerInfo.addressModeV = textureSampler.addressModeV;
-		samplerInfo.addressModeW = textureSampler.addressModeW;
-		samplerInfo.compareOp = VK_COMPARE_OP_NEVER;
-		samplerInfo.borderColor = VK_BORDER_COLOR_FLOAT_OPAQUE_WHITE;
-		samplerInfo.maxAnisotropy = 1.0;
-		samplerInfo.anisotropyEnable = VK_FALSE;
-		samplerInfo.maxLod = (float)mipLevels;
-		samplerInfo.maxAnisotropy = 8.0f;
-		samplerInfo.anisotropyEnable = VK_TRUE;
-		VK_CHECK_RESULT(vkCreateSampler(device->logicalDevice, &samplerInfo, nullptr, &sampler));
-
-		VkImageViewCreateInfo viewInfo{};
-		viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
-		viewInfo.image = image;
-		viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
-		viewInfo.format = format;
-		viewInfo.components = { VK_COMPONENT_SWIZZLE_R, VK_COMPONENT_SWIZZLE_G, VK_COMPONENT_SWIZZLE_B, VK_COMPONENT_SWIZZLE_A };
-		viewInfo.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-		viewInfo.subresourceRange.layerCount = 1;
-		viewInfo.subresourceRange.levelCount = mipLevels;
-		VK_CHECK_RESULT(vkCreateImageView(device->logicalDevice, &viewInfo, nullptr, &view));
-
-		descriptor.sampler = sampler;
-		descriptor.imageView = view;
-		descriptor.imageLayout = imageLayout;
-
-		if (deleteBuffer)
-			delete[] buffer;
-
+		device->flushCommandBuffer(blitCmd, copyQueue, pool, true);
 	}
 
 	// Primitive
@@ -319,20 +318,9 @@ namespace vkglTF
 	Mesh::Mesh(vks::VulkanDevice *device, glm::mat4 matrix) {
 		this->device = device;
 		this->uniformBlock.matrix = matrix;
-		VK_CHECK_RESULT(device->createBuffer(
-			VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT,
-			VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
-			sizeof(uniformBlock),
-			&uniformBuffer.buffer,
-			&uniformBuffer.memory,
-			&uniformBlock));
-		VK_CHECK_RESULT(vkMapMemory(device->logicalDevice, uniformBuffer.memory, 0, sizeof(uniformBlock), 0, &uniformBuffer.mapped));
-		uniformBuffer.descriptor = { uniformBuffer.buffer, 0, sizeof(uniformBlock) };
 	};
 
 	Mesh::~Mesh() {
-		vkDestroyBuffer(device->logicalDevice, uniformBuffer.buffer, nullptr);
-		vkFreeMemory(device->logicalDevice, uniformBuffer.memory, nullptr);
 		for (Primitive* p : primitives)
 			delete p;
 	}
@@ -373,10 +361,10 @@ namespace vkglTF
 					mesh->uniformBlock.jointMatrix[i] = jointMat;
 				}
 				mesh->uniformBlock.jointcount = (float)numJoints;
-				memcpy(mesh->uniformBuffer.mapped, &mesh->uniformBlock, sizeof(mesh->uniformBlock));
 			} else {
-				memcpy(mesh->uniformBuffer.mapped, &m, sizeof(glm::mat4));
+				mesh->uniformBlock.matrix = m;
 			}
+			mesh->staleFrames = UINT32_MAX;
 		}
 
 		for (auto& child : children) {
@@ -384,6 +372,51 @@ namespace vkglTF
 		}
 	}
 
+	void Node::updateWorldMatrix(bool parentChanged, uint32_t &recomputed) {
+		bool localChanged = dirty || translation != cachedTranslation || rotation != cachedRotation || scale != cachedScale;
+		if (localChanged) {
+			cachedTranslation = translation;
+			cachedRotation = rotation;
+			cachedScale = scale;
+			cachedLocalMatrix = localMatrix();
+			dirty = false;
+		}
+
+		// Only nodes in changed subtrees are recomputed
+		worldChanged = false;
+		if (localChanged || parentChanged) {
+			glm::mat4 m = parent ? parent->worldMatrix * cachedLocalMatrix : cachedLocalMatrix;
+			worldChanged = m != worldMatrix;
+			worldMatrix = m;
+			recomputed++;
+		}
+
+		for (auto& child : children) {
+			child->updateWorldMatrix(worldChanged, recomputed);
+		}
+	}
+
+	void Node::updateUniformBlock() {
+		if (!mesh) {
+			return;
+		}
+
+		if (skin) {
+			mesh->uniformBlock.matrix = worldMatrix;
+			// Update joint matrices
+			glm::mat4 inverseTransform = glm::inverse(worldMatrix);
+			size_t numJoints = std::min((uint32_t)skin->joints.size(), MAX_NUM_JOINTS);
+			for (size_t i = 0; i < numJoints; i++) {
+				glm::mat4 jointMat = skin->joints[i]->worldMatrix * skin->inverseBindMatrices[i];
+				mesh->uniformBlock.jointMatrix[i] = inverseTransform * jointMat;
+			}
+			mesh->uniformBlock.jointcount = (float)numJoints;
+		} else {
+			mesh->uniformBlock.matrix = worldMatrix;
+		}
+		mesh->staleFrames = UINT32_MAX;
+	}
+
 	Node::~Node() {
 		if (mesh) {
 			delete mesh;
@@ -399,14 +432,20 @@ namespace vkglTF
 	{
 		if (vertices.buffer != VK_NULL_HANDLE) {
 			vkDestroyBuffer(device, vertices.buffer, nullptr);
-			vkFreeMemory(device, vertices.memory, nullptr);
+			this->device->memoryAllocator->Free(vertices.memory);
 			vertices.buffer = VK_NULL_HANDLE;
 		}
 		if (indices.buffer != VK_NULL_HANDLE) {
 			vkDestroyBuffer(device, indices.buffer, nullptr);
-			vkFreeMemory(device, indices.memory, nullptr);
+			this->device->memoryAllocator->Free(indices.memory);
 			indices.buffer = VK_NULL_HANDLE;
 		}
+		if (meshUniforms.buffer != VK_NULL_HANDLE) {
+			vkDestroyBuffer(device, meshUniforms.buffer, nullptr);
+			this->device->memoryAllocator->Free(meshUniforms.memory);
+			meshUniforms = {};
+		}
+		releasePendingUpload();
 		for (auto &texture : textures) {
 			texture.destroy();
 		}
@@ -417,6 +456,8 @@ namespace vkglTF
 		}
 		materials.resize(0);
 		animations.resize(0);
+		animationBlend.resize(0);
+		animationTargets.resize(0);
 		nodes.resize(0);
 		linearNodes.resize(0);
 		extensions.resize(0);
@@ -707,26 +748,29 @@ namespace vkglTF
 		}
 	}
 
-	void Model::loadTextures(tinygltf::Model &gltfModel, vks::VulkanDevice *device, VkQueue transferQueue)
+	TextureSampler Model::getTextureSampler(const tinygltf::Texture &tex)
 	{
-		for (tinygltf::Texture &tex : gltfModel.textures) {
-			tinygltf::Image image = gltfModel.images[tex.source];
+		if (tex.sampler == -1) {
+			// No sampler specified, use a default one
 			vkglTF::TextureSampler textureSampler;
-			if (tex.sampler == -1) {
-				// No sampler specified, use a default one
-				textureSampler.magFilter = VK_FILTER_LINEAR;
-				textureSampler.minFilter = VK_FILTER_LINEAR;
-				textureSampler.addressModeU = VK_SAMPLER_ADDRESS_MODE_REPEAT;
-				textureSampler.addressModeV = VK_SAMPLER_ADDRESS_MODE_REPEAT;
-				textureSampler.addressModeW = VK_SAMPLER_ADDRESS_MODE_REPEAT;
-			}
-			else {
-				textureSampler = textureSamplers[tex.sampler];
-			}
-			vkglTF::Texture texture;
-			const std::lock_guard< std::mutex > lock( mutexVulkanQueue );
-			texture.fromglTfImage(image, textureSampler, device, transferQueue);
-			textures.push_back(texture);
+			textureSampler.magFilter = VK_FILTER_LINEAR;
+			textureSampler.minFilter = VK_FILTER_LINEAR;
+			textureSampler.addressModeU = VK_SAMPLER_ADDRESS_MODE_REPEAT;
+			textureSampler.addressModeV = VK_SAMPLER_ADDRESS_MODE_REPEAT;
+			textureSampler.addressModeW = VK_SAMPLER_ADDRESS_MODE_REPEAT;
+			return textureSampler;
+		}
+		return textureSamplers[tex.sampler];
+	}
+
+	void Model::loadTextures(tinygltf::Model &gltfModel, vks::VulkanDevice *device, VkQueue transferQueue, VkCommandPool commandPool)
+	{
+		// Filled in place, materials may already point to the slots
+		textures.resize(gltfModel.textures.size());
+		for (size_t i = 0; i < gltfModel.textures.size(); i++) {
+			tinygltf::Texture &tex = gltfModel.textures[i];
+			tinygltf::Image &image = gltfModel.images[tex.source];
+			textures[i].fromglTfImage(image, getTextureSampler(tex), device, transferQueue, commandPool);
 		}
 	}
 
@@ -978,9 +1022,12 @@ namespace vkglTF
 		}
 	}
 
-	void Model::loadFromFile(std::string filename, vks::VulkanDevice* device, VkQueue transferQueue, float scale)
+	bool Model::parseFromFile(std::string filename, vks::VulkanDevice* device, float scale)
 	{
-		tinygltf::Model gltfModel;
+		releasePendingUpload();
+		pendingUpload = std::make_unique<PendingUpload>();
+
+		tinygltf::Model &gltfModel = pendingUpload->gltfModel;
 		tinygltf::TinyGLTF gltfContext;
 
 		std::string error;
@@ -1002,7 +1049,8 @@ namespace vkglTF
 
 		if (fileLoaded) {
 			loadTextureSamplers(gltfModel);
-			loadTextures(gltfModel, device, transferQueue);
+			// Texture slots are filled in by uploadTextures, materials only keep pointers to them
+			textures.resize(gltfModel.textures.size());
 			loadMaterials(gltfModel);
 
 			const tinygltf::Scene& scene = gltfModel.scenes[gltfModel.defaultScene > -1 ? gltfModel.defaultScene : 0];
@@ -1011,8 +1059,10 @@ namespace vkglTF
 			for (size_t i = 0; i < scene.nodes.size(); i++) {
 				getNodeProps(gltfModel.nodes[scene.nodes[i]], gltfModel, vertexCount, indexCount);
 			}
-			loaderInfo.vertexBuffer = new Vertex[vertexCount];
-			loaderInfo.indexBuffer = new uint32_t[indexCount];
+			pendingUpload->vertexStorage.resize(vertexCount);
+			pendingUpload->indexStorage.resize(indexCount);
+			loaderInfo.vertexBuffer = pendingUpload->vertexStorage.data();
+			loaderInfo.indexBuffer = pendingUpload->indexStorage.data();
 
 			// TODO: scene handling with no default scene
 			for (size_t i = 0; i < scene.nodes.size(); i++) {
@@ -1029,32 +1079,103 @@ namespace vkglTF
 				if (node->skinIndex > -1) {
 					node->skin = skins[node->skinIndex];
 				}
-				// Initial pose
-				if (node->mesh) {
-					node->update();
-				}
 			}
+
+			// Initial pose
+			updateTransforms();
 		}
 		else {
-			// TODO: throw
 			std::cerr << "Could not load gltf file: " << error << std::endl;
-			return;
+			pendingUpload.reset();
+			return false;
 		}
 
 		extensions = gltfModel.extensionsUsed;
 
-		size_t vertexBufferSize = vertexCount * sizeof(Vertex);
-		size_t indexBufferSize = indexCount * sizeof(uint32_t);
-		indices.count = static_cast<int>(indexCount);
+		if (vertexCount == 0) {
+			std::cerr << "No vertex data in gltf file: " << filename << std::endl;
+			pendingUpload.reset();
+			return false;
+		}
+
+		pendingUpload->vertexData = pendingUpload->vertexStorage.data();
+		pendingUpload->vertexCount = vertexCount;
+		pendingUpload->indexData = pendingUpload->indexStorage.data();
+		pendingUpload->indexCount = indexCount;
+
+		// Most devices don't support RGB only on Vulkan, so decoded images are expanded here (off the upload thread)
+		for (tinygltf::Image &image : gltfModel.images) {
+			if (image.component == 3) {
+				std::vector<unsigned char> rgba(size_t(image.width) * image.height * 4);
+				Texture::copyRGBA(image, rgba.data());
+				image.image.swap(rgba);
+				image.component = 4;
+			}
+		}
+
+		pendingUpload->textureData.resize(gltfModel.textures.size());
+		for (size_t i = 0; i < gltfModel.textures.size(); i++) {
+			const tinygltf::Texture &tex = gltfModel.textures[i];
+			const tinygltf::Image &image = gltfModel.images[tex.source];
+			PendingUpload::TextureData &textureData = pendingUpload->textureData[i];
+			textureData.data = image.image.data();
+			textureData.width = image.width;
+			textureData.height = image.height;
+			textureData.sampler = getTextureSampler(tex);
+		}
+
+		createBuffers();
+		getSceneDimensions();
+
+		return true;
+	}
+
+	void Model::createBuffers()
+	{
+		assert(pendingUpload);
+
+		VkDeviceSize vertexBufferSize = pendingUpload->vertexCount * sizeof(Vertex);
+		VkDeviceSize indexBufferSize = pendingUpload->indexCount * sizeof(uint32_t);
+		indices.count = static_cast<int>(pendingUpload->indexCount);
+
+		// Create device local buffers, filled by the uploads
+		// Vertex buffer
+		VK_CHECK_RESULT(device->createBuffer(
+			VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+			VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+			vertexBufferSize,
+			&vertices.buffer,
+			&vertices.memory));
+		// Index buffer
+		if (indexBufferSize > 0) {
+			VK_CHECK_RESULT(device->createBuffer(
+				VK_BUFFER_USAGE_INDEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+				VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+				indexBufferSize,
+				&indices.buffer,
+				&indices.memory));
+		}
+	}
+
+	void Model::uploadTextures(VkQueue transferQueue, VkCommandPool commandPool)
+	{
+		assert(pendingUpload);
+		loadTextures(pendingUpload->gltfModel, device, transferQueue, commandPool);
+	}
 
-		assert(vertexBufferSize > 0);
+	void Model::uploadGeometry(VkQueue transferQueue)
+	{
+		assert(pendingUpload);
 
+		// Create staging buffers
 		struct StagingBuffer {
-			VkBuffer buffer;
-			VkDeviceMemory memory;
+			VkBuffer buffer = VK_NULL_HANDLE;
+			xrvk::MemoryAllocation memory;
 		} vertexStaging, indexStaging;
 
-		// Create staging buffers
+		VkDeviceSize vertexBufferSize = pendingUpload->vertexCount * sizeof(Vertex);
+		VkDeviceSize indexBufferSize = pendingUpload->indexCount * sizeof(uint32_t);
+
 		// Vertex data
 		VK_CHECK_RESULT(device->createBuffer(
 			VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
@@ -1062,7 +1183,7 @@ namespace vkglTF
 			vertexBufferSize,
 			&vertexStaging.buffer,
 			&vertexStaging.memory,
-			loaderInfo.vertexBuffer));
+			(void*)pendingUpload->vertexData));
 		// Index data
 		if (indexBufferSize > 0) {
 			VK_CHECK_RESULT(device->createBuffer(
@@ -1071,25 +1192,7 @@ namespace vkglTF
 				indexBufferSize,
 				&indexStaging.buffer,
 				&indexStaging.memory,
-				loaderInfo.indexBuffer));
-		}
-
-		// Create device local buffers
-		// Vertex buffer
-		VK_CHECK_RESULT(device->createBuffer(
-			VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
-			VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
-			vertexBufferSize,
-			&vertices.buffer,
-			&vertices.memory));
-		// Index buffer
-		if (indexBufferSize > 0) {
-			VK_CHECK_RESULT(device->createBuffer(
-				VK_BUFFER_USAGE_INDEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
-				VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
-				indexBufferSize,
-				&indices.buffer,
-				&indices.memory));
+				(void*)pendingUpload->indexData));
 		}
 
 		// Copy from staging buffers
@@ -1105,21 +1208,60 @@ namespace vkglTF
 			vkCmdCopyBuffer(copyCmd, indexStaging.buffer, indices.buffer, 1, &copyRegion);
 		}
 
-		// run vulkan commands, lock vulkan queue as it's not thread safe
-		const std::lock_guard< std::mutex > lock( mutexVulkanQueue );
 		device->flushCommandBuffer(copyCmd, transferQueue, true);
 
 		vkDestroyBuffer(device->logicalDevice, vertexStaging.buffer, nullptr);
-		vkFreeMemory(device->logicalDevice, vertexStaging.memory, nullptr);
+		device->memoryAllocator->Free(vertexStaging.memory);
 		if (indexBufferSize > 0) {
 			vkDestroyBuffer(device->logicalDevice, indexStaging.buffer, nullptr);
-			vkFreeMemory(device->logicalDevice, indexStaging.memory, nullptr);
+			device->memoryAllocator->Free(indexStaging.memory);
 		}
+	}
 
-		delete[] loaderInfo.vertexBuffer;
-		delete[] loaderInfo.indexBuffer;
+	void Model::stageUploads(xrvk::UploadManager* uploadManager)
+	{
+		assert(pendingUpload);
 
-		getSceneDimensions();
+		// Textures - the stored mips are staged, the rest of the chain is blitted by the upload manager
+		for (size_t i = 0; i < pendingUpload->textureData.size(); i++) {
+			const PendingUpload::TextureData &textureData = pendingUpload->textureData[i];
+			textures[i].createImage(textureData.width, textureData.height, textureData.sampler, device);
+
+			uint32_t stagedMipLevels = std::min(textureData.mipLevels, textures[i].mipLevels);
+			xrvk::StagingRegion region = uploadManager->Stage(Texture::getRGBASize(textureData.width, textureData.height, stagedMipLevels));
+			memcpy(region.pData, textureData.data, region.unSize);
+			uploadManager->CopyImage(region, textures[i].image, textures[i].width, textures[i].height, textures[i].mipLevels, stagedMipLevels);
+		}
+
+		// Geometry
+		xrvk::StagingRegion vertexRegion = uploadManager->Stage(pendingUpload->vertexCount * sizeof(Vertex));
+		memcpy(vertexRegion.pData, pendingUpload->vertexData, vertexRegion.unSize);
+		uploadManager->CopyBuffer(vertexRegion, vertices.buffer);
+
+		if (pendingUpload->indexCount > 0) {
+			xrvk::StagingRegion indexRegion = uploadManager->Stage(pendingUpload->indexCount * sizeof(uint32_t));
+			memcpy(indexRegion.pData, pendingUpload->indexData, indexRegion.unSize);
+			uploadManager->CopyBuffer(indexRegion, indices.buffer);
+		}
+
+		// Everything is in the staging ring now
+		releasePendingUpload();
+	}
+
+	void Model::releasePendingUpload()
+	{
+		pendingUpload.reset();
+	}
+
+	void Model::loadFromFile(std::string filename, vks::VulkanDevice* device, VkQueue transferQueue, float scale)
+	{
+		if (!parseFromFile(filename, device, scale)) {
+			return;
+		}
+
+		uploadTextures(transferQueue);
+		uploadGeometry(transferQueue);
+		releasePendingUpload();
 	}
 
 	void Model::drawNode(Node *node, VkCommandBuffer commandBuffer)
@@ -1190,67 +1332,273 @@ namespace vkglTF
 		aabb[3][2] = dimensions.min[2];
 	}
 
+	// AnimationSampler
+	bool AnimationSampler::isValid() const {
+		const size_t valuesPerKeyframe = interpolation == CUBICSPLINE ? 3 : 1;
+		return !inputs.empty() && outputsVec4.size() >= inputs.size() * valuesPerKeyframe;
+	}
+
+	size_t AnimationSampler::findKeyframe(float time, size_t &cursor) const {
+		assert(inputs.size() > 1);
+		const size_t last = inputs.size() - 2;
+
+		// Playback stays within the cached keyframes or moves on to the next ones
+		size_t i = std::min(cursor, last);
+		if (time >= inputs[i] && (i == last || time < inputs[i + 1])) {
+			return cursor = i;
+		}
+		if (i < last && time >= inputs[i + 1] && (i + 1 == last || time < inputs[i + 2])) {
+			return cursor = i + 1;
+		}
+
+		// Seeks and loops fall back to a binary search
+		size_t upper = static_cast<size_t>(std::upper_bound(inputs.begin(), inputs.end(), time) - inputs.begin());
+		cursor = upper == 0 ? 0 : std::min(upper - 1, last);
+		return cursor;
+	}
+
+	glm::vec4 AnimationSampler::evaluate(float time, size_t &cursor, bool rotation) const {
+		const bool cubic = interpolation == CUBICSPLINE;
+		auto value = [&](size_t keyframe) { return outputsVec4[cubic ? keyframe * 3 + 1 : keyframe]; };
+
+		if (inputs.size() == 1) {
+			return value(0);
+		}
+
+		const size_t i = findKeyframe(time, cursor);
+		const float dt = inputs[i + 1] - inputs[i];
+		const float u = dt > 0.0f ? glm::clamp((time - inputs[i]) / dt, 0.0f, 1.0f) : 0.0f;
+
+		switch (interpolation) {
+		case STEP: {
+			return value(u >= 1.0f ? i + 1 : i);
+		}
+		case CUBICSPLINE: {
+			// Hermite spline from the out tangent of keyframe i and the in tangent of keyframe i + 1, both scaled by the keyframe delta
+			const float u2 = u * u;
+			const float u3 = u2 * u;
+			glm::vec4 result = (2.0f * u3 - 3.0f * u2 + 1.0f) * value(i)
+				+ (u3 - 2.0f * u2 + u) * dt * outputsVec4[i * 3 + 2]
+				+ (-2.0f * u3 + 3.0f * u2) * value(i + 1)
+				+ (u3 - u2) * dt * outputsVec4[(i + 1) * 3];
+			return rotation ? glm::normalize(result) : result;
+		}
+		default: {
+			if (!rotation) {
+				return glm::mix(value(i), value(i + 1), u);
+			}
+			glm::vec4 v1 = value(i);
+			glm::vec4 v2 = value(i + 1);
+			glm::quat q1;
+			q1.x = v1.x;
+			q1.y = v1.y;
+			q1.z = v1.z;
+			q1.w = v1.w;
+			glm::quat q2;
+			q2.x = v2.x;
+			q2.y = v2.y;
+			q2.z = v2.z;
+			q2.w = v2.w;
+			glm::quat q = glm::normalize(glm::slerp(q1, q2, u));
+			return glm::vec4(q.x, q.y, q.z, q.w);
+		}
+		}
+	}
+
 	void Model::updateAnimation(uint32_t index, float time)
 	{
 		if (animations.empty()) {
 			std::cout << ".glTF does not contain animation." << std::endl;
 			return;
 		}
-		if (index > static_cast<uint32_t>(animations.size()) - 1) {
-			std::cout << "No animation with index " << index << std::endl;
+		updateAnimations({ { index, time, 1.0f } });
+	}
+
+	void Model::updateAnimations(const std::vector<AnimationLayer>& layers)
+	{
+		// (1) Accumulate the weighted channel outputs per animated node
+		for (auto& layer : layers) {
+			if (layer.index >= static_cast<uint32_t>(animations.size())) {
+				std::cout << "No animation with index " << layer.index << std::endl;
+				continue;
+			}
+			if (layer.weight <= 0.0f) {
+				continue;
+			}
+
+			Animation &animation = animations[layer.index];
+			for (auto& channel : animation.channels) {
+				const vkglTF::AnimationSampler &sampler = animation.samplers[channel.samplerIndex];
+				if (!sampler.isValid()) {
+					continue;
+				}
+
+				if (channel.node->index >= animationBlend.size()) {
+					animationBlend.resize(channel.node->index + 1);
+				}
+				AnimationBlend &blend = animationBlend[channel.node->index];
+				if (blend.weights[0] == 0.0f && blend.weights[1] == 0.0f && blend.weights[2] == 0.0f) {
+					animationTargets.push_back(channel.node);
+				}
+
+				const bool rotation = channel.path == vkglTF::AnimationChannel::PathType::ROTATION;
+				glm::vec4 output = sampler.evaluate(layer.time, channel.cursor, rotation);
+				switch (channel.path) {
+				case vkglTF::AnimationChannel::PathType::TRANSLATION: {
+					blend.translation += layer.weight * glm::vec3(output);
+					blend.weights[0] += layer.weight;
+					break;
+				}
+				case vkglTF::AnimationChannel::PathType::ROTATION: {
+					// Keep the quaternions in one hemisphere so they don't cancel out
+					if (glm::dot(blend.rotation, output) < 0.0f) {
+						output = -output;
+					}
+					blend.rotation += layer.weight * output;
+					blend.weights[1] += layer.weight;
+					break;
+				}
+				case vkglTF::AnimationChannel::PathType::SCALE: {
+					blend.scale += layer.weight * glm::vec3(output);
+					blend.weights[2] += layer.weight;
+					break;
+				}
+				}
+			}
+		}
+
+		if (animationTargets.empty()) {
 			return;
 		}
-		Animation &animation = animations[index];
 
-		bool updated = false;
-		for (auto& channel : animation.channels) {
-			vkglTF::AnimationSampler &sampler = animation.samplers[channel.samplerIndex];
-			if (sampler.inputs.size() > sampler.outputsVec4.size()) {
+		// (2) Normalized blends become the new node properties
+		for (auto node : animationTargets) {
+			AnimationBlend &blend = animationBlend[node->index];
+			if (blend.weights[0] > 0.0f) {
+				node->translation = blend.translation / blend.weights[0];
+			}
+			if (blend.weights[1] > 0.0f) {
+				glm::vec4 q = glm::normalize(blend.rotation);
+				node->rotation.x = q.x;
+				node->rotation.y = q.y;
+				node->rotation.z = q.z;
+				node->rotation.w = q.w;
+			}
+			if (blend.weights[2] > 0.0f) {
+				node->scale = blend.scale / blend.weights[2];
+			}
+			blend = {};
+		}
+		animationTargets.clear();
+
+		updateTransforms();
+	}
+
+	void Model::updateTransforms() {
+		// Recompute world matrices of changed subtrees
+		for (auto &node : nodes) {
+			node->updateWorldMatrix(false, nodesRecomputed);
+		}
+
+		// Refresh the uniform blocks of meshes whose matrices changed, skinned meshes also change when any of their joints moved
+		for (auto &node : linearNodes) {
+			if (!node->mesh) {
 				continue;
 			}
 
-			for (size_t i = 0; i < sampler.inputs.size() - 1; i++) {
-				if ((time >= sampler.inputs[i]) && (time <= sampler.inputs[i + 1])) {
-					float u = std::max(0.0f, time - sampler.inputs[i]) / (sampler.inputs[i + 1] - sampler.inputs[i]);
-					if (u <= 1.0f) {
-						switch (channel.path) {
-						case vkglTF::AnimationChannel::PathType::TRANSLATION: {
-							glm::vec4 trans = glm::mix(sampler.outputsVec4[i], sampler.outputsVec4[i + 1], u);
-							channel.node->translation = glm::vec3(trans);
-							break;
-						}
-						case vkglTF::AnimationChannel::PathType::SCALE: {
-							glm::vec4 trans = glm::mix(sampler.outputsVec4[i], sampler.outputsVec4[i + 1], u);
-							channel.node->scale = glm::vec3(trans);
-							break;
-						}
-						case vkglTF::AnimationChannel::PathType::ROTATION: {
-							glm::quat q1;
-							q1.x = sampler.outputsVec4[i].x;
-							q1.y = sampler.outputsVec4[i].y;
-							q1.z = sampler.outputsVec4[i].z;
-							q1.w = sampler.outputsVec4[i].w;
-							glm::quat q2;
-							q2.x = sampler.outputsVec4[i + 1].x;
-							q2.y = sampler.outputsVec4[i + 1].y;
-							q2.z = sampler.outputsVec4[i + 1].z;
-							q2.w = sampler.outputsVec4[i + 1].w;
-							channel.node->rotation = glm::normalize(glm::slerp(q1, q2, u));
-							break;
-						}
-						}
-						updated = true;
+			bool changed = node->worldChanged;
+			if (!changed && node->skin) {
+				for (auto &joint : node->skin->joints) {
+					if (joint->worldChanged) {
+						changed = true;
+						break;
 					}
 				}
 			}
+
+			if (changed) {
+				node->updateUniformBlock();
+			}
+		}
+	}
+
+	void Model::createMeshUniforms(uint32_t frameCount) {
+		assert(meshUniforms.buffer == VK_NULL_HANDLE);
+		// Renderers clamp their frame slots to this (see xrvk::Render::CreateRenderResources)
+		assert(frameCount > 0 && frameCount <= MAX_MESH_UNIFORM_FRAMES);
+
+		// (1) Assign every mesh its slot
+		uint32_t meshCount = 0;
+		for (auto &node : linearNodes) {
+			if (node->mesh) {
+				node->mesh->uniformIndex = meshCount++;
+			}
+		}
+
+		if (meshCount == 0) {
+			return;
+		}
+
+		// (2) One buffer for all meshes and frames, slots are aligned for use as dynamic offsets
+		const VkDeviceSize alignment = std::max<VkDeviceSize>(device->properties.limits.minUniformBufferOffsetAlignment, 1);
+		meshUniforms.stride = (sizeof(Mesh::UniformBlock) + alignment - 1) & ~(alignment - 1);
+		meshUniforms.frameSize = meshUniforms.stride * meshCount;
+		meshUniforms.frameCount = frameCount;
+		meshUniforms.meshCount = meshCount;
+
+		VK_CHECK_RESULT(device->createBuffer(
+			VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT,
+			VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+			meshUniforms.frameSize * frameCount,
+			&meshUniforms.buffer,
+			&meshUniforms.memory));
+		meshUniforms.descriptor = { meshUniforms.buffer, 0, sizeof(Mesh::UniformBlock) };
+
+		// (3) Initial blocks in every frame region
+		uint8_t *mapped = static_cast<uint8_t*>(meshUniforms.memory.pMapped);
+		for (auto &node : linearNodes) {
+			if (!node->mesh) {
+				continue;
+			}
+
+			for (uint32_t frame = 0; frame < frameCount; frame++) {
+				memcpy(mapped + getMeshUniformOffset(node->mesh, frame), &node->mesh->uniformBlock, sizeof(Mesh::UniformBlock));
+			}
+			node->mesh->staleFrames = 0;
+		}
+	}
+
+	void Model::writeMeshUniforms(uint32_t frame) {
+		if (meshUniforms.buffer == VK_NULL_HANDLE) {
+			return;
 		}
-		if (updated) {
-			for (auto &node : nodes) {
-				node->update();
+
+		assert(frame < meshUniforms.frameCount);
+		const uint32_t frameBit = 1u << frame;
+		uint8_t *mapped = static_cast<uint8_t*>(meshUniforms.memory.pMapped);
+		for (auto &node : linearNodes) {
+			Mesh *mesh = node->mesh;
+			if (!mesh || (mesh->staleFrames & frameBit) == 0) {
+				continue;
 			}
+
+			// Unskinned meshes only ever change their matrix, the rest of the block keeps its initial contents
+			const size_t size = node->skin ? sizeof(Mesh::UniformBlock) : sizeof(glm::mat4);
+			memcpy(mapped + getMeshUniformOffset(mesh, frame), &mesh->uniformBlock, size);
+			mesh->staleFrames &= ~frameBit;
+			uniformBuffersWritten++;
 		}
 	}
 
+	uint32_t Model::getMeshUniformOffset(const Mesh* mesh, uint32_t frame) const {
+		return static_cast<uint32_t>(frame * meshUniforms.frameSize + mesh->uniformIndex * meshUniforms.stride);
+	}
+
+	void Model::resetTransformCounters() {
+		nodesRecomputed = 0;
+		uniformBuffersWritten = 0;
+	}
+
 	Node* Model::findNode(Node *parent, uint32_t index) {
 		Node* nodeFound = nullptr;
 		if (parent->index == index) {
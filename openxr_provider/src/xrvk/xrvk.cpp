@@ -64,26 +64,77 @@ namespace xrvk
 
 	Render::~Render()
 	{
+		// stop loading, models that aren't on the gpu yet are left empty
+		if ( m_pAssetLoader != nullptr )
+			delete m_pAssetLoader;
+
+		// waits for uploads still in flight
+		if ( m_pUploadManager != nullptr )
+			delete m_pUploadManager;
+
+		// wait for any frames still in flight before freeing their resources
+		if ( m_SharedState.vkDevice != VK_NULL_HANDLE )
+			vkDeviceWaitIdle( m_SharedState.vkDevice );
+
 		// free internal objects
+		if ( m_pJobSystem != nullptr )
+			delete m_pJobSystem;
+
 		if ( skybox != nullptr )
 			delete skybox;
 
 		for ( auto &shape : vecShapes )
 			delete shape;
 
+		for ( auto &shapeBatch : vecShapeBatches )
+		{
+			if ( shapeBatch->pipeline != VK_NULL_HANDLE )
+				vkDestroyPipeline( m_SharedState.vkDevice, shapeBatch->pipeline, nullptr );
+
+			delete shapeBatch;
+		}
+
 		for ( auto &renderable : vecRenderScenes )
+		{
+			if ( renderable->vkDescriptorPool != VK_NULL_HANDLE )
+				vkDestroyDescriptorPool( m_SharedState.vkDevice, renderable->vkDescriptorPool, nullptr );
+
 			delete renderable;
+		}
 
 		for ( auto &renderable : vecRenderSectors )
+		{
+			if ( renderable->vkDescriptorPool != VK_NULL_HANDLE )
+				vkDestroyDescriptorPool( m_SharedState.vkDevice, renderable->vkDescriptorPool, nullptr );
+
 			delete renderable;
+		}
 
 		for ( auto &renderable : vecRenderModels )
+		{
+			if ( renderable->vkDescriptorPool != VK_NULL_HANDLE )
+				vkDestroyDescriptorPool( m_SharedState.vkDevice, renderable->vkDescriptorPool, nullptr );
+
 			delete renderable;
+		}
+
+		for ( auto &instanceGroup : m_vecInstanceGroups )
+			delete instanceGroup;
 
-		// free vulkan descriptor pool
+		// free vulkan descriptor pools
 		if ( vkDescriptorPool != VK_NULL_HANDLE )
 			vkDestroyDescriptorPool( m_SharedState.vkDevice, vkDescriptorPool, nullptr );
 
+		if ( m_vkBindlessDescriptorPool != VK_NULL_HANDLE )
+			vkDestroyDescriptorPool( m_SharedState.vkDevice, m_vkBindlessDescriptorPool, nullptr );
+
+		// persist and free the pipeline cache
+		if ( m_SharedState.vkPipelineCache != VK_NULL_HANDLE )
+		{
+			SavePipelineCache();
+			vkDestroyPipelineCache( m_SharedState.vkDevice, m_SharedState.vkPipelineCache, nullptr );
+		}
+
 		// free pipelines
 		if ( pipelines.pbr != VK_NULL_HANDLE )
 			vkDestroyPipeline( m_SharedState.vkDevice, pipelines.pbr, nullptr );
@@ -94,6 +145,18 @@ namespace xrvk
 		if ( pipelines.pbrDoubleSided != VK_NULL_HANDLE )
 			vkDestroyPipeline( m_SharedState.vkDevice, pipelines.pbrDoubleSided, nullptr );
 
+		if ( pipelines.pbrInstanced != VK_NULL_HANDLE )
+			vkDestroyPipeline( m_SharedState.vkDevice, pipelines.pbrInstanced, nullptr );
+
+		if ( pipelines.pbrAlphaBlendInstanced != VK_NULL_HANDLE )
+			vkDestroyPipeline( m_SharedState.vkDevice, pipelines.pbrAlphaBlendInstanced, nullptr );
+
+		if ( pipelines.pbrDoubleSidedInstanced != VK_NULL_HANDLE )
+			vkDestroyPipeline( m_SharedState.vkDevice, pipelines.pbrDoubleSidedInstanced, nullptr );
+
+		if ( pipelines.instanceCull != VK_NULL_HANDLE )
+			vkDestroyPipeline( m_SharedState.vkDevice, pipelines.instanceCull, nullptr );
+
 		if ( pipelines.vismask != VK_NULL_HANDLE )
 			vkDestroyPipeline( m_SharedState.vkDevice, pipelines.vismask, nullptr );
 
@@ -113,6 +176,12 @@ namespace xrvk
 		if ( vkPipelineLayoutShapes != VK_NULL_HANDLE )
 			vkDestroyPipelineLayout( m_SharedState.vkDevice, vkPipelineLayoutShapes, nullptr );
 
+		if ( vkPipelineLayoutInstanced != VK_NULL_HANDLE )
+			vkDestroyPipelineLayout( m_SharedState.vkDevice, vkPipelineLayoutInstanced, nullptr );
+
+		if ( vkPipelineLayoutInstanceCull != VK_NULL_HANDLE )
+			vkDestroyPipelineLayout( m_SharedState.vkDevice, vkPipelineLayoutInstanceCull, nullptr );
+
 		m_vecCustomLayouts.clear();
 
 		// free descriptor set layouts
@@ -125,18 +194,51 @@ namespace xrvk
 		if ( descriptorSetLayouts.scene != VK_NULL_HANDLE )
 			vkDestroyDescriptorSetLayout( m_SharedState.vkDevice, descriptorSetLayouts.scene, nullptr );
 
+		if ( descriptorSetLayouts.instance != VK_NULL_HANDLE )
+			vkDestroyDescriptorSetLayout( m_SharedState.vkDevice, descriptorSetLayouts.instance, nullptr );
+
+		if ( descriptorSetLayouts.instanceCull != VK_NULL_HANDLE )
+			vkDestroyDescriptorSetLayout( m_SharedState.vkDevice, descriptorSetLayouts.instanceCull, nullptr );
+
 		// free buffers
-		skyboxUniformBuffer.destroy();
+		m_BindlessMaterialBuffer.destroy();
 		vecUniformBuffers.clear();
 		vecvecUniformBuffers_Shapes.clear();
 		m_vecVisMaskBuffers.clear();
 
+		for ( auto &buffer : m_vecInstanceCullBuffers )
+			buffer.destroy();
+
+		// free frame slots
+		for ( auto &frameData : m_vecFrameData )
+		{
+			if ( frameData.vkCommandFence != VK_NULL_HANDLE )
+				vkDestroyFence( m_SharedState.vkDevice, frameData.vkCommandFence, nullptr );
+
+			if ( frameData.vkCommandPool != VK_NULL_HANDLE )
+				vkDestroyCommandPool( m_SharedState.vkDevice, frameData.vkCommandPool, nullptr );
+
+			for ( auto &vkCommandPool : frameData.vecSecondaryCommandPools )
+				vkDestroyCommandPool( m_SharedState.vkDevice, vkCommandPool, nullptr );
+		}
+		m_vecFrameData.clear();
+
+		if ( m_vkTimestampQueryPool != VK_NULL_HANDLE )
+			vkDestroyQueryPool( m_SharedState.vkDevice, m_vkTimestampQueryPool, nullptr );
+
+		// device memory, after everything allocated from it
+		if ( m_pMemoryAllocator )
+		{
+			m_pMemoryAllocator->LogStats();
+			delete m_pMemoryAllocator;
+		}
+
 		// vulkan device cleanup
 		if ( m_pVulkanDevice )
 			delete m_pVulkanDevice;
 	}
 
-	XrResult Render::Init( oxr::Provider *pProvider, const char *pccAppName, uint32_t unAppVersion, const char *pccEngineName, uint32_t unEngineVersion )
+	XrResult Render::Init( oxr::Provider *pProvider, const char *pccAppName, uint32_t unAppVersion, const char *pccEngineName, uint32_t unEngineVersion, bool bRequestMultiview, bool bRequestBindless )
 	{
 		assert( pccAppName );
 		assert( pccEngineName );
@@ -177,6 +279,26 @@ namespace xrvk
 			vecExtensions.push_back( validationExtension );
 		}
 
+		// ... multiview and descriptor indexing need the physical device properties2 extension in vulkan 1.0
+		bool bInstanceSupportsProperties2 = false;
+		if ( bRequestMultiview || bRequestBindless )
+		{
+			uint32_t unInstanceExtensionCount = 0;
+			vkEnumerateInstanceExtensionProperties( nullptr, &unInstanceExtensionCount, nullptr );
+			std::vector< VkExtensionProperties > vecInstanceExtensions( unInstanceExtensionCount );
+			vkEnumerateInstanceExtensionProperties( nullptr, &unInstanceExtensionCount, vecInstanceExtensions.data() );
+
+			for ( auto &instanceExtension : vecInstanceExtensions )
+			{
+				if ( strcmp( instanceExtension.extensionName, VK_KHR_GET_PHYSICAL_DEVICE_PROPERTIES_2_EXTENSION_NAME ) == 0 )
+				{
+					vecExtensions.push_back( VK_KHR_GET_PHYSICAL_DEVICE_PROPERTIES_2_EXTENSION_NAME );
+					bInstanceSupportsProperties2 = true;
+					break;
+				}
+			}
+		}
+
 		// (4) Create vulkan instance
 		VkInstanceCreateInfo vkInstanceCreateInfo { VK_STRUCTURE_TYPE_INSTANCE_CREATE_INFO };
 		vkInstanceCreateInfo.pApplicationInfo = &vkApplicationInfo;
@@ -246,20 +368,199 @@ namespace xrvk
 			}
 		}
 
+		// ... uploads use a transfer only queue family if there's one (usually backed by dedicated copy engines), otherwise the graphics queue
+		m_SharedState.vkTransferQueueFamilyIndex = m_SharedState.vkQueueFamilyIndex;
+		for ( uint32_t i = 0; i < unQueueFamilyCount; ++i )
+		{
+			const VkQueueFlags vkFlags = vecQueueFamilyProps[ i ].queueFlags;
+			if ( ( vkFlags & VK_QUEUE_TRANSFER_BIT ) != 0u && ( vkFlags & ( VK_QUEUE_GRAPHICS_BIT | VK_QUEUE_COMPUTE_BIT ) ) == 0u )
+			{
+				m_SharedState.vkTransferQueueFamilyIndex = i;
+				break;
+			}
+		}
+
+		std::vector< VkDeviceQueueCreateInfo > vecQueueCreateInfos { vkDeviceQueueCreateInfo };
+		if ( m_SharedState.vkTransferQueueFamilyIndex != m_SharedState.vkQueueFamilyIndex )
+		{
+			VkDeviceQueueCreateInfo vkTransferQueueCreateInfo = vkDeviceQueueCreateInfo;
+			vkTransferQueueCreateInfo.queueFamilyIndex = m_SharedState.vkTransferQueueFamilyIndex;
+			vecQueueCreateInfos.push_back( vkTransferQueueCreateInfo );
+		}
+
 		std::vector< const char * > vkDeviceExtensions;
 
 #if defined( _WIN32 )
 		vkDeviceExtensions.push_back( VK_KHR_SWAPCHAIN_EXTENSION_NAME );
 #endif
 
+		std::vector< VkExtensionProperties > vecDeviceExtensions;
+		if ( bInstanceSupportsProperties2 )
+		{
+			uint32_t unDeviceExtensionCount = 0;
+			vkEnumerateDeviceExtensionProperties( m_SharedState.vkPhysicalDevice, nullptr, &unDeviceExtensionCount, nullptr );
+			vecDeviceExtensions.resize( unDeviceExtensionCount );
+			vkEnumerateDeviceExtensionProperties( m_SharedState.vkPhysicalDevice, nullptr, &unDeviceExtensionCount, vecDeviceExtensions.data() );
+		}
+
+		auto IsDeviceExtensionSupported = [ &vecDeviceExtensions ]( const char *pccExtensionName )
+		{
+			for ( auto &deviceExtension : vecDeviceExtensions )
+			{
+				if ( strcmp( deviceExtension.extensionName, pccExtensionName ) == 0 )
+					return true;
+			}
+
+			return false;
+		};
+
+		// Enable multiview if requested and supported by the runtime's gpu, otherwise we'll render each view separately
+		VkPhysicalDeviceMultiviewFeaturesKHR vkMultiviewFeatures { VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MULTIVIEW_FEATURES_KHR };
+		m_bMultiviewSupported = false;
+
+		if ( bRequestMultiview && bInstanceSupportsProperties2 )
+		{
+			m_bMultiviewSupported = IsDeviceExtensionSupported( VK_KHR_MULTIVIEW_EXTENSION_NAME );
+
+			// ... the multiview variants of our built-in shaders must also be present
+			for ( auto &sShader : { "shaders/pbr_multiview.vert.spv", "shaders/pbr_khr_multiview.frag.spv", "shaders/skybox_multiview.vert.spv", "shaders/vismask_multiview.vert.spv" } )
+			{
+				if ( m_bMultiviewSupported && !IsShaderAvailable( sShader ) )
+				{
+					LogError( "Multiview shader %s not found.", sShader );
+					m_bMultiviewSupported = false;
+				}
+			}
+
+			if ( m_bMultiviewSupported )
+			{
+				vkDeviceExtensions.push_back( VK_KHR_MULTIVIEW_EXTENSION_NAME );
+				vkMultiviewFeatures.multiview = VK_TRUE;
+			}
+		}
+
+		if ( bRequestMultiview )
+			LogInfo( "Multiview (single pass stereo) requested and is %s.", m_bMultiviewSupported ? "available" : "NOT available" );
+
+		// Enable descriptor indexing (bindless materials) if requested and supported, otherwise we'll use a descriptor set per material
+		VkPhysicalDeviceDescriptorIndexingFeaturesEXT vkDescriptorIndexingFeatures { VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_FEATURES_EXT };
+		m_bBindlessEnabled = false;
+
+		if ( bRequestBindless && bInstanceSupportsProperties2 && IsDeviceExtensionSupported( VK_EXT_DESCRIPTOR_INDEXING_EXTENSION_NAME ) &&
+			 IsDeviceExtensionSupported( VK_KHR_MAINTENANCE3_EXTENSION_NAME ) )
+		{
+			// ... check the individual features we need
+			VkPhysicalDeviceDescriptorIndexingFeaturesEXT vkSupportedIndexingFeatures { VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_FEATURES_EXT };
+			VkPhysicalDeviceFeatures2KHR vkPhysicalDeviceFeatures2 { VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2_KHR };
+			vkPhysicalDeviceFeatures2.pNext = &vkSupportedIndexingFeatures;
+
+			VkPhysicalDeviceDescriptorIndexingPropertiesEXT vkIndexingProperties { VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_PROPERTIES_EXT };
+			VkPhysicalDeviceProperties2KHR vkPhysicalDeviceProperties2 { VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2_KHR };
+			vkPhysicalDeviceProperties2.pNext = &vkIndexingProperties;
+
+			auto pfnGetPhysicalDeviceFeatures2 = ( PFN_vkGetPhysicalDeviceFeatures2KHR )vkGetInstanceProcAddr( m_SharedState.vkInstance, "vkGetPhysicalDeviceFeatures2KHR" );
+			auto pfnGetPhysicalDeviceProperties2 = ( PFN_vkGetPhysicalDeviceProperties2KHR )vkGetInstanceProcAddr( m_SharedState.vkInstance, "vkGetPhysicalDeviceProperties2KHR" );
+
+			if ( pfnGetPhysicalDeviceFeatures2 && pfnGetPhysicalDeviceProperties2 )
+			{
+				pfnGetPhysicalDeviceFeatures2( m_SharedState.vkPhysicalDevice, &vkPhysicalDeviceFeatures2 );
+				pfnGetPhysicalDeviceProperties2( m_SharedState.vkPhysicalDevice, &vkPhysicalDeviceProperties2 );
+
+				m_bBindlessEnabled = vkSupportedIndexingFeatures.runtimeDescriptorArray && vkSupportedIndexingFeatures.descriptorBindingPartiallyBound &&
+									 vkSupportedIndexingFeatures.descriptorBindingVariableDescriptorCount &&
+									 vkSupportedIndexingFeatures.shaderSampledImageArrayNonUniformIndexing &&
+									 vkSupportedIndexingFeatures.descriptorBindingSampledImageUpdateAfterBind;
+			}
+
+			// ... the bindless variants of our built-in shaders must also be present
+			std::vector< const char * > vecBindlessShaders { "shaders/pbr_khr_bindless.frag.spv" };
+			if ( m_bMultiviewSupported )
+				vecBindlessShaders.push_back( "shaders/pbr_khr_bindless_multiview.frag.spv" );
+
+			for ( auto &sShader : vecBindlessShaders )
+			{
+				if ( m_bBindlessEnabled && !IsShaderAvailable( sShader ) )
+				{
+					LogError( "Bindless shader %s not found.", sShader );
+					m_bBindlessEnabled = false;
+				}
+			}
+
+			if ( m_bBindlessEnabled )
+			{
+				// ... clamp the texture array to what the device can bind in a single update after bind set
+				m_unBindlessTextureCapacity = std::min( k_unBindlessMaxTextures, vkIndexingProperties.maxDescriptorSetUpdateAfterBindSampledImages );
+				m_unBindlessTextureCapacity = std::min( m_unBindlessTextureCapacity, vkIndexingProperties.maxPerStageDescriptorUpdateAfterBindSampledImages );
+				m_unBindlessTextureCapacity = std::min( m_unBindlessTextureCapacity, vkIndexingProperties.maxDescriptorSetUpdateAfterBindSamplers );
+				m_unBindlessTextureCapacity = std::min( m_unBindlessTextureCapacity, vkIndexingProperties.maxPerStageDescriptorUpdateAfterBindSamplers );
+
+				vkDeviceExtensions.push_back( VK_KHR_MAINTENANCE3_EXTENSION_NAME );
+				vkDeviceExtensions.push_back( VK_EXT_DESCRIPTOR_INDEXING_EXTENSION_NAME );
+
+				vkDescriptorIndexingFeatures.runtimeDescriptorArray = VK_TRUE;
+				vkDescriptorIndexingFeatures.descriptorBindingPartiallyBound = VK_TRUE;
+				vkDescriptorIndexingFeatures.descriptorBindingVariableDescriptorCount = VK_TRUE;
+				vkDescriptorIndexingFeatures.shaderSampledImageArrayNonUniformIndexing = VK_TRUE;
+				vkDescriptorIndexingFeatures.descriptorBindingSampledImageUpdateAfterBind = VK_TRUE;
+			}
+		}
+
+		if ( bRequestBindless )
+			LogInfo( "Bindless materials (descriptor indexing) requested and is %s.", m_bBindlessEnabled ? "available" : "NOT available" );
+
+		// Enable timeline semaphores if supported, used to track upload completion (otherwise a fence per upload batch)
+		VkPhysicalDeviceTimelineSemaphoreFeaturesKHR vkTimelineSemaphoreFeatures { VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_TIMELINE_SEMAPHORE_FEATURES_KHR };
+		bool bTimelineSemaphoreEnabled = false;
+
+		if ( bInstanceSupportsProperties2 && IsDeviceExtensionSupported( VK_KHR_TIMELINE_SEMAPHORE_EXTENSION_NAME ) )
+		{
+			VkPhysicalDeviceTimelineSemaphoreFeaturesKHR vkSupportedTimelineFeatures { VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_TIMELINE_SEMAPHORE_FEATURES_KHR };
+			VkPhysicalDeviceFeatures2KHR vkPhysicalDeviceFeatures2 { VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2_KHR };
+			vkPhysicalDeviceFeatures2.pNext = &vkSupportedTimelineFeatures;
+
+			auto pfnGetPhysicalDeviceFeatures2 = ( PFN_vkGetPhysicalDeviceFeatures2KHR )vkGetInstanceProcAddr( m_SharedState.vkInstance, "vkGetPhysicalDeviceFeatures2KHR" );
+			if ( pfnGetPhysicalDeviceFeatures2 )
+			{
+				pfnGetPhysicalDeviceFeatures2( m_SharedState.vkPhysicalDevice, &vkPhysicalDeviceFeatures2 );
+				bTimelineSemaphoreEnabled = vkSupportedTimelineFeatures.timelineSemaphore == VK_TRUE;
+			}
+
+			if ( bTimelineSemaphoreEnabled )
+			{
+				vkDeviceExtensions.push_back( VK_KHR_TIMELINE_SEMAPHORE_EXTENSION_NAME );
+				vkTimelineSemaphoreFeatures.timelineSemaphore = VK_TRUE;
+			}
+		}
+
+		// ... chain enabled feature structs
+		void *pDeviceCreateNext = nullptr;
+		if ( bTimelineSemaphoreEnabled )
+		{
+			vkTimelineSemaphoreFeatures.pNext = pDeviceCreateNext;
+			pDeviceCreateNext = &vkTimelineSemaphoreFeatures;
+		}
+
+		if ( m_bBindlessEnabled )
+		{
+			vkDescriptorIndexingFeatures.pNext = pDeviceCreateNext;
+			pDeviceCreateNext = &vkDescriptorIndexingFeatures;
+		}
+
+		if ( m_bMultiviewSupported )
+		{
+			vkMultiviewFeatures.pNext = pDeviceCreateNext;
+			pDeviceCreateNext = &vkMultiviewFeatures;
+		}
+
 		VkDeviceCreateInfo vkDeviceCreateInfo { VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO };
-		vkDeviceCreateInfo.queueCreateInfoCount = 1;
-		vkDeviceCreateInfo.pQueueCreateInfos = &vkDeviceQueueCreateInfo;
+		vkDeviceCreateInfo.queueCreateInfoCount = ( uint32_t )vecQueueCreateInfos.size();
+		vkDeviceCreateInfo.pQueueCreateInfos = vecQueueCreateInfos.data();
 		vkDeviceCreateInfo.enabledLayerCount = 0;
 		vkDeviceCreateInfo.ppEnabledLayerNames = nullptr;
 		vkDeviceCreateInfo.enabledExtensionCount = ( uint32_t )vkDeviceExtensions.size();
 		vkDeviceCreateInfo.ppEnabledExtensionNames = vkDeviceExtensions.empty() ? nullptr : vkDeviceExtensions.data();
 		vkDeviceCreateInfo.pEnabledFeatures = &m_SharedState.vkPhysicalDeviceFeatures;
+		vkDeviceCreateInfo.pNext = pDeviceCreateNext;
 
 		XrVulkanDeviceCreateInfoKHR xrVulkanDeviceCreateInfo { XR_TYPE_VULKAN_DEVICE_CREATE_INFO_KHR };
 		xrVulkanDeviceCreateInfo.systemId = pProvider->Instance()->xrSystemId;
@@ -279,11 +580,17 @@ namespace xrvk
 			return xrResult == XR_SUCCESS ? XR_ERROR_VALIDATION_FAILURE : xrResult;
 		}
 
-		// (8) Get device queue
+		// (8) Get device queues
 		vkGetDeviceQueue( m_SharedState.vkDevice, vkDeviceQueueCreateInfo.queueFamilyIndex, 0, &m_SharedState.vkQueue );
 
-		// (9) Set vks properties
+		m_SharedState.vkTransferQueue = m_SharedState.vkQueue;
+		if ( m_SharedState.vkTransferQueueFamilyIndex != m_SharedState.vkQueueFamilyIndex )
+			vkGetDeviceQueue( m_SharedState.vkDevice, m_SharedState.vkTransferQueueFamilyIndex, 0, &m_SharedState.vkTransferQueue );
+
+		// (9) Set vks properties - all buffer and image memory is sub-allocated from here on
 		m_pVulkanDevice->logicalDevice = m_SharedState.vkDevice;
+		m_pMemoryAllocator = new MemoryAllocator( m_SharedState.vkPhysicalDevice, m_SharedState.vkDevice );
+		m_pVulkanDevice->memoryAllocator = m_pMemoryAllocator;
 
 		// (10) Create graphics binding that we will use to create an openxr session
 		m_SharedState.xrGraphicsBinding.instance = m_SharedState.vkInstance;
@@ -292,19 +599,45 @@ namespace xrvk
 		m_SharedState.xrGraphicsBinding.queueFamilyIndex = vkDeviceQueueCreateInfo.queueFamilyIndex;
 		m_SharedState.xrGraphicsBinding.queueIndex = m_SharedState.vkQueueIndex;
 
+		// (11) Create upload manager
+		m_pUploadManager = new UploadManager(
+			m_pVulkanDevice, m_SharedState.vkTransferQueue, m_SharedState.vkTransferQueueFamilyIndex, m_SharedState.vkQueueFamilyIndex, bTimelineSemaphoreEnabled );
+
 		return XR_SUCCESS;
 	}
 
-	void Render::CreateRenderResources( oxr::Session *pSession, int64_t nColorFormat, int64_t nDepthFormat, VkExtent2D vkExtent )
+	void Render::CreateRenderResources( oxr::Session *pSession, int64_t nColorFormat, int64_t nDepthFormat, VkExtent2D vkExtent, uint32_t unFramesInFlight, uint32_t unRecordingThreads )
 	{
 		assert( pSession );
 
+		// Every render (one per swapchain, each view when not using multiview) records into and submits its own frame slot, so a frame takes
+		// one slot per swapchain. Slots index per render resources like the mesh uniform regions of models, which can't track more than k_unMaxFramesInFlight
+		const uint32_t unRendersPerFrame = std::max( static_cast< uint32_t >( pSession->GetSwapchains().size() ), 1u );
+		const uint32_t unMaxFramesInFlight = std::max( k_unMaxFramesInFlight / unRendersPerFrame, 1u );
+		if ( unFramesInFlight == 0 || unFramesInFlight > unMaxFramesInFlight )
+		{
+			const uint32_t unClamped = std::clamp( unFramesInFlight, 1u, unMaxFramesInFlight );
+			LogWarning( "Requested %u frames in flight, using %u (supported range is 1 to %u with %u renders per frame).", unFramesInFlight, unClamped, unMaxFramesInFlight, unRendersPerFrame );
+			unFramesInFlight = unClamped;
+		}
+
+		m_unFramesInFlight = unFramesInFlight;
+		const uint32_t unFrameSlots = unFramesInFlight * unRendersPerFrame;
+
 		// Set extent
 		this->vkExtent = vkExtent;
 
-		// (1) Set shader parameters
-		vecUniformBuffers.resize( k_unCommandBufferNum );
-		vecDescriptorSets.resize( k_unCommandBufferNum );
+		// Use multiview if supported and all views share a single array swapchain
+		m_bMultiviewEnabled = m_bMultiviewSupported && pSession->IsMultiviewSwapchain( 0 );
+
+		if ( !m_bMultiviewSupported && pSession->IsMultiviewSwapchain( 0 ) )
+			LogError( "Session has a single array swapchain for all views but multiview isn't supported. Check IsMultiviewSupported() before creating swapchains." );
+
+		LogInfo( "Rendering %s.", m_bMultiviewEnabled ? "all views in a single pass (multiview)" : "each view separately" );
+
+		// (1) Set shader parameters - each frame slot has its own set so it can be updated while other renders are still in flight
+		vecUniformBuffers.resize( unFrameSlots );
+		vecDescriptorSets.resize( unFrameSlots );
 
 		// (2) Create render pass(es)
 		CreateRenderPass( nColorFormat, nDepthFormat );
@@ -312,26 +645,73 @@ namespace xrvk
 		// (3) Create render target(s) per image in the swapchain including frame buffers
 		CreateRenderTargets( pSession, m_vecRenderPasses[ 0 ] );
 
-		// (4) Create vulkan command buffers
-		m_vecFrameData.resize( k_unCommandBufferNum, {} );
+		// (4) Create vulkan command buffers - one pool, command buffer and fence per frame slot
+		m_vecFrameData.resize( unFrameSlots, {} );
+		m_unCurrentFrame = 0;
 
-		for ( uint32_t i = 0; i < k_unCommandBufferNum; i++ )
+		for ( uint32_t i = 0; i < unFrameSlots; i++ )
 		{
 			// Create a command pool to allocate our command buffer from
 			VkCommandPoolCreateInfo cmdPoolInfo { VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO };
-			cmdPoolInfo.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
+			cmdPoolInfo.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
 			cmdPoolInfo.queueFamilyIndex = m_SharedState.vkQueueFamilyIndex;
-			vkCreateCommandPool( m_SharedState.vkDevice, &cmdPoolInfo, nullptr, &m_vecFrameData[ 0 ].vkCommandPool );
+			vkCreateCommandPool( m_SharedState.vkDevice, &cmdPoolInfo, nullptr, &m_vecFrameData[ i ].vkCommandPool );
 
 			// Create the command buffer from the command pool
 			VkCommandBufferAllocateInfo cmd { VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO };
-			cmd.commandPool = m_vecFrameData[ 0 ].vkCommandPool;
+			cmd.commandPool = m_vecFrameData[ i ].vkCommandPool;
 			cmd.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
 			cmd.commandBufferCount = 1;
-			vkAllocateCommandBuffers( m_SharedState.vkDevice, &cmd, &m_vecFrameData[ 0 ].vkCommandBuffer );
+			vkAllocateCommandBuffers( m_SharedState.vkDevice, &cmd, &m_vecFrameData[ i ].vkCommandBuffer );
 
+			// Fences start signaled so the first use of each slot doesn't wait
 			VkFenceCreateInfo fenceInfo { VK_STRUCTURE_TYPE_FENCE_CREATE_INFO };
-			vkCreateFence( m_SharedState.vkDevice, &fenceInfo, nullptr, &m_vecFrameData[ 0 ].vkCommandFence );
+			fenceInfo.flags = VK_FENCE_CREATE_SIGNALED_BIT;
+			vkCreateFence( m_SharedState.vkDevice, &fenceInfo, nullptr, &m_vecFrameData[ i ].vkCommandFence );
+
+			// Secondary command buffers for parallel recording (pre, post and one per worker thread), each with its own pool as pools can't be shared across threads
+			if ( unRecordingThreads > 0 )
+			{
+				const uint32_t unSecondaries = k_unSecondaryFirstChunk + unRecordingThreads;
+				m_vecFrameData[ i ].vecSecondaryCommandPools.resize( unSecondaries, VK_NULL_HANDLE );
+				m_vecFrameData[ i ].vecSecondaryCommandBuffers.resize( unSecondaries, VK_NULL_HANDLE );
+
+				for ( uint32_t j = 0; j < unSecondaries; j++ )
+				{
+					vkCreateCommandPool( m_SharedState.vkDevice, &cmdPoolInfo, nullptr, &m_vecFrameData[ i ].vecSecondaryCommandPools[ j ] );
+
+					VkCommandBufferAllocateInfo secondaryCmd { VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO };
+					secondaryCmd.commandPool = m_vecFrameData[ i ].vecSecondaryCommandPools[ j ];
+					secondaryCmd.level = VK_COMMAND_BUFFER_LEVEL_SECONDARY;
+					secondaryCmd.commandBufferCount = 1;
+					vkAllocateCommandBuffers( m_SharedState.vkDevice, &secondaryCmd, &m_vecFrameData[ i ].vecSecondaryCommandBuffers[ j ] );
+				}
+			}
+		}
+
+		// (4.1) Start worker threads for parallel recording
+		if ( unRecordingThreads > 0 )
+		{
+			m_pJobSystem = new JobSystem( unRecordingThreads );
+			LogInfo( "Recording renderables in parallel across %i worker threads.", unRecordingThreads );
+		}
+
+		// (4.2) Frame timing - recording and submits are added to the session's frame records, with a pair of gpu timestamps per frame slot if the queue supports them
+		m_pFrameTiming = &pSession->GetFrameTiming();
+		m_pSession = pSession;
+
+		const uint32_t unTimestampValidBits = m_pVulkanDevice->queueFamilyProperties[ m_SharedState.vkQueueFamilyIndex ].timestampValidBits;
+		if ( unTimestampValidBits > 0 && m_pVulkanDevice->properties.limits.timestampPeriod > 0.0f )
+		{
+			VkQueryPoolCreateInfo queryPoolInfo { VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO };
+			queryPoolInfo.queryType = VK_QUERY_TYPE_TIMESTAMP;
+			queryPoolInfo.queryCount = 2 * unFrameSlots;
+			VK_CHECK_RESULT( vkCreateQueryPool( m_SharedState.vkDevice, &queryPoolInfo, nullptr, &m_vkTimestampQueryPool ) );
+
+			m_unTimestampMask = unTimestampValidBits >= 64 ? UINT64_MAX : ( 1ull << unTimestampValidBits ) - 1;
+
+			// a frame slot's timestamps are read when the slot is reused, which is frames in flight frames later
+			m_pFrameTiming->SetGpuLatency( unFramesInFlight );
 		}
 
 		// (5) Create command pool
@@ -341,10 +721,165 @@ namespace xrvk
 		cmdPoolInfo.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
 		VK_CHECK_RESULT( vkCreateCommandPool( m_SharedState.vkDevice, &cmdPoolInfo, nullptr, &m_pVulkanDevice->commandPool ) );
 
-		// (6) Create pipeline cache
+		// (6) Create pipeline cache, seeded from disk if a valid cache exists for this device and driver
+		CreatePipelineCache();
+	}
+
+	std::string Render::GetPipelineCacheFilename()
+	{
+		if ( m_sPipelineCacheDirectory.empty() )
+			return "";
+
+		// Key by pipeline cache uuid and driver version - either changing invalidates the driver's cache data
+		const VkPhysicalDeviceProperties &vkProperties = m_pVulkanDevice->properties;
+
+		char pcFilename[ 128 ];
+		int nLen = snprintf( pcFilename, sizeof( pcFilename ), "xrvk_pipelines_%04x_%04x_", vkProperties.vendorID, vkProperties.deviceID );
+		for ( uint32_t i = 0; i < VK_UUID_SIZE; i++ )
+			nLen += snprintf( pcFilename + nLen, sizeof( pcFilename ) - nLen, "%02x", vkProperties.pipelineCacheUUID[ i ] );
+		snprintf( pcFilename + nLen, sizeof( pcFilename ) - nLen, "_%08x.bin", vkProperties.driverVersion );
+
+		return ( std::filesystem::path( m_sPipelineCacheDirectory ) / pcFilename ).generic_string();
+	}
+
+	void Render::CreatePipelineCache()
+	{
+		const VkPhysicalDeviceProperties &vkProperties = m_pVulkanDevice->properties;
+		std::vector< char > vecCacheData;
+		m_bPipelineCacheLoaded = false;
+		m_fPipelineColdCreationMs = 0.0f;
+
+		// (1) Read the cache file, any mismatch or truncation means we start with an empty cache
+		std::string sFilename = GetPipelineCacheFilename();
+		std::ifstream file( sFilename, std::ios::binary );
+		if ( !sFilename.empty() && file.is_open() )
+		{
+			PipelineCacheFileHeader fileHeader {};
+			file.read( reinterpret_cast< char * >( &fileHeader ), sizeof( PipelineCacheFileHeader ) );
+
+			bool bValid = file.good() && fileHeader.unMagic == k_unPipelineCacheMagic && fileHeader.unVersion == k_unPipelineCacheFileVersion &&
+						  fileHeader.unVendorID == vkProperties.vendorID && fileHeader.unDeviceID == vkProperties.deviceID &&
+						  fileHeader.unDriverVersion == vkProperties.driverVersion &&
+						  memcmp( fileHeader.pipelineCacheUUID, vkProperties.pipelineCacheUUID, VK_UUID_SIZE ) == 0 &&
+						  fileHeader.unDataSize >= sizeof( VkPipelineCacheHeaderVersionOne );
+
+			if ( bValid )
+			{
+				vecCacheData.resize( static_cast< size_t >( fileHeader.unDataSize ) );
+				file.read( vecCacheData.data(), vecCacheData.size() );
+				bValid = file.gcount() == static_cast< std::streamsize >( vecCacheData.size() );
+			}
+
+			// (2) Validate the driver's own header as well, the driver would otherwise silently ignore (or on some drivers choke on) foreign data
+			if ( bValid )
+			{
+				VkPipelineCacheHeaderVersionOne vkCacheHeader {};
+				memcpy( &vkCacheHeader, vecCacheData.data(), sizeof( VkPipelineCacheHeaderVersionOne ) );
+
+				bValid = vkCacheHeader.headerSize >= sizeof( VkPipelineCacheHeaderVersionOne ) && vkCacheHeader.headerVersion == VK_PIPELINE_CACHE_HEADER_VERSION_ONE &&
+						 vkCacheHeader.vendorID == vkProperties.vendorID && vkCacheHeader.deviceID == vkProperties.deviceID &&
+						 memcmp( vkCacheHeader.pipelineCacheUUID, vkProperties.pipelineCacheUUID, VK_UUID_SIZE ) == 0;
+			}
+
+			if ( bValid )
+			{
+				m_fPipelineColdCreationMs = fileHeader.fColdCreationMs;
+			}
+			else
+			{
+				LogInfo( "Pipeline cache %s is stale or invalid and will be rebuilt.", sFilename.c_str() );
+				vecCacheData.clear();
+			}
+		}
+		file.close();
+
+		// (3) Create the pipeline cache, falling back to an empty one if the driver rejects the data
 		VkPipelineCacheCreateInfo pipelineCacheCreateInfo {};
 		pipelineCacheCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
-		VK_CHECK_RESULT( vkCreatePipelineCache( m_SharedState.vkDevice, &pipelineCacheCreateInfo, nullptr, &m_SharedState.vkPipelineCache ) );
+		pipelineCacheCreateInfo.initialDataSize = vecCacheData.size();
+		pipelineCacheCreateInfo.pInitialData = vecCacheData.empty() ? nullptr : vecCacheData.data();
+
+		VkResult vkResult = vkCreatePipelineCache( m_SharedState.vkDevice, &pipelineCacheCreateInfo, nullptr, &m_SharedState.vkPipelineCache );
+		if ( vkResult != VK_SUCCESS && !vecCacheData.empty() )
+		{
+			LogError( "Unable to create pipeline cache from %s (%i), starting with an empty cache.", sFilename.c_str(), ( int32_t )vkResult );
+			pipelineCacheCreateInfo.initialDataSize = 0;
+			pipelineCacheCreateInfo.pInitialData = nullptr;
+			vecCacheData.clear();
+			vkResult = vkCreatePipelineCache( m_SharedState.vkDevice, &pipelineCacheCreateInfo, nullptr, &m_SharedState.vkPipelineCache );
+		}
+		VK_CHECK_RESULT( vkResult );
+
+		m_bPipelineCacheLoaded = !vecCacheData.empty();
+		if ( m_bPipelineCacheLoaded )
+			LogInfo( "Pipeline cache loaded from %s (%i bytes).", sFilename.c_str(), ( int32_t )vecCacheData.size() );
+	}
+
+	bool Render::WriteFileAtomically( const std::string &sFilename, const std::vector< char > &vecData )
+	{
+		// Write to a temporary file first so a crash mid write never leaves a truncated file behind
+		std::string sTempFilename = sFilename + ".tmp";
+		std::ofstream file( sTempFilename, std::ios::binary | std::ios::trunc );
+		if ( !file.is_open() )
+		{
+			LogError( "Unable to write to %s", sTempFilename.c_str() );
+			return false;
+		}
+
+		file.write( vecData.data(), vecData.size() );
+		file.close();
+
+		std::error_code errorCode;
+		if ( file.fail() )
+		{
+			LogError( "Unable to write to %s", sTempFilename.c_str() );
+			std::filesystem::remove( sTempFilename, errorCode );
+			return false;
+		}
+
+		// Replace the previous file
+		std::filesystem::rename( sTempFilename, sFilename, errorCode );
+		if ( errorCode )
+		{
+			LogError( "Unable to replace %s (%s)", sFilename.c_str(), errorCode.message().c_str() );
+			std::filesystem::remove( sTempFilename, errorCode );
+			return false;
+		}
+
+		return true;
+	}
+
+	bool Render::SavePipelineCache()
+	{
+		std::string sFilename = GetPipelineCacheFilename();
+		if ( sFilename.empty() || m_SharedState.vkPipelineCache == VK_NULL_HANDLE )
+			return false;
+
+		// (1) Get the driver's cache data
+		size_t unDataSize = 0;
+		if ( vkGetPipelineCacheData( m_SharedState.vkDevice, m_SharedState.vkPipelineCache, &unDataSize, nullptr ) != VK_SUCCESS || unDataSize == 0 )
+			return false;
+
+		std::vector< char > vecCacheData( unDataSize );
+		if ( vkGetPipelineCacheData( m_SharedState.vkDevice, m_SharedState.vkPipelineCache, &unDataSize, vecCacheData.data() ) != VK_SUCCESS )
+			return false;
+
+		const VkPhysicalDeviceProperties &vkProperties = m_pVulkanDevice->properties;
+		PipelineCacheFileHeader fileHeader {};
+		fileHeader.unVendorID = vkProperties.vendorID;
+		fileHeader.unDeviceID = vkProperties.deviceID;
+		fileHeader.unDriverVersion = vkProperties.driverVersion;
+		memcpy( fileHeader.pipelineCacheUUID, vkProperties.pipelineCacheUUID, VK_UUID_SIZE );
+		fileHeader.fColdCreationMs = m_fPipelineColdCreationMs;
+		fileHeader.unDataSize = unDataSize;
+
+		// (2) Write header and data
+		vecCacheData.insert( vecCacheData.begin(), reinterpret_cast< const char * >( &fileHeader ), reinterpret_cast< const char * >( &fileHeader ) + sizeof( PipelineCacheFileHeader ) );
+		if ( !WriteFileAtomically( sFilename, vecCacheData ) )
+			return false;
+
+		LogInfo( "Pipeline cache saved to %s (%i bytes).", sFilename.c_str(), ( int32_t )unDataSize );
+		return true;
 	}
 
 	void Render::StartHmdTracking( oxr::Session *pSession )
@@ -368,7 +903,7 @@ namespace xrvk
 		// XrQuaternionf_Multiply( &pose->orientation, &playerWorldState.orientation, &poseOrientation );
 	}
 
-	void Render::BeginRender(
+	VkResult Render::BeginRender(
 		oxr::Session *pSession,
 		std::vector< XrCompositionLayerProjectionView > &vecFrameLayerProjectionViews,
 		XrFrameState *pFrameState,
@@ -378,9 +913,52 @@ namespace xrvk
 		float fFarZ /*= 100.0f*/,
 		XrVector3f v3fScaleEyeView /*= { 1.0f, 1.0f, 1.0f } */ )
 	{
-		// (1) Set command buffer to recording
+		// Wait until the gpu is done with the frame slot we're about to record into - if it isn't, skip this render so the swapchain image
+		// isn't shown half drawn
+		VkResult vkResult = WaitForFrameSlot();
+		m_bRenderRecorded = vkResult == VK_SUCCESS;
+		if ( !m_bRenderRecorded )
+		{
+			pSession->DiscardFrameLayers();
+			return vkResult;
+		}
+
+		m_unTimedPass = unSwapchainIndex;
+		m_pFrameTiming->MarkBegin( oxr::EFrameStage::RecordCommands, m_unTimedPass );
+
+		// All views are recorded once in multiview
+		if ( m_bMultiviewEnabled )
+		{
+			BeginRenderMultiview( pSession, vecFrameLayerProjectionViews, pFrameState, unSwapchainIndex, unImageIndex, fNearZ, fFarZ, v3fScaleEyeView );
+			return VK_SUCCESS;
+		}
+
+		// (1) Set command buffer to recording - with parallel recording, draws go to secondary command buffers that the primary executes
+		VkCommandBuffer vkPrimaryCommandBuffer = m_vecFrameData[ m_unCurrentFrame ].vkCommandBuffer;
+		VkCommandBuffer vkCommandBuffer = vkPrimaryCommandBuffer;
+
 		VkCommandBufferBeginInfo cmdBeginInfo { VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO };
-		vkBeginCommandBuffer( m_vecFrameData[ 0 ].vkCommandBuffer, &cmdBeginInfo );
+		vkBeginCommandBuffer( vkPrimaryCommandBuffer, &cmdBeginInfo );
+		BeginGpuTiming( vkPrimaryCommandBuffer );
+
+		// (1.1) Acquire completed uploads and set up renderables that finished streaming in, once per frame so all views draw the same set
+		if ( unSwapchainIndex == 0 )
+		{
+			m_pUploadManager->RecordGraphicsWork( vkPrimaryCommandBuffer );
+			FinishStreamedRenderables();
+		}
+
+		// (1.2) Update eye, head and renderable poses and create the view projection (eye transform) and vismask matrices
+		XrPosef *eyePose = &vecFrameLayerProjectionViews[ unSwapchainIndex ].pose;
+		UpdateHmdState( pSession, pFrameState );
+
+		XrMatrix4x4f matViewProjection, matVisMaskMVP;
+		CalculateViewProjection( &matViewProjection, &matVisMaskMVP, &vecFrameLayerProjectionViews[ unSwapchainIndex ], fNearZ, fFarZ, &v3fScaleEyeView );
+
+		UpdateRenderablePoses( pSession, pFrameState );
+
+		// (1.3) Cull instanced renderables against this eye's frustum - compute work has to be recorded outside the render pass
+		CullInstanceGroups( vkPrimaryCommandBuffer, &matViewProjection, 1 );
 
 		// (2) Set render pass info
 		VkRenderPassBeginInfo renderPassBeginInfo { VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO };
@@ -402,293 +980,536 @@ namespace xrvk
 		renderPassBeginInfo.renderArea.extent = vkExtent;
 
 		// (6) Start render pass
-		vkCmdBeginRenderPass( m_vecFrameData[ 0 ].vkCommandBuffer, &renderPassBeginInfo, VK_SUBPASS_CONTENTS_INLINE );
+		vkCmdBeginRenderPass( vkPrimaryCommandBuffer, &renderPassBeginInfo, IsParallelRecordingEnabled() ? VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS : VK_SUBPASS_CONTENTS_INLINE );
 
-		// (7) Create the projection matrix
-		XrMatrix4x4f matProjection;
-		XrMatrix4x4f_CreateProjectionFov( &matProjection, GRAPHICS_VULKAN, vecFrameLayerProjectionViews[ unSwapchainIndex ].fov, fNearZ, fFarZ );
+		if ( IsParallelRecordingEnabled() )
+			vkCommandBuffer = BeginSecondaryCommandBuffer( k_unSecondaryPre, &renderPassBeginInfo );
 
-		// (8) Update eye and head poses
+		// (7) Draw vismask if available
+		if ( m_vecVisMasks.size() > unSwapchainIndex && !m_vecVisMasks[ unSwapchainIndex ].indices.empty() )
+		{
+			assert( m_vecVisMasks.size() == m_vecVisMaskBuffers.size() );
 
-		// (8.1) Update current eye pose
-		XrPosef *eyePose = &vecFrameLayerProjectionViews[ unSwapchainIndex ].pose;
+			// Reverse winding order
+			for ( auto &vismask : m_vecVisMasks )
+			{
+				for ( uint32_t i = 0; i < vismask.indices.size(); i += 3 )
+				{
+					std::swap( vismask.indices[ i + 1 ], vismask.indices[ i + 2 ] );
+				}
+			}
+
+			// bind graphics pipeline
+			vkCmdBindPipeline( vkCommandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipelines.vismask );
+
+			// bind buffers
+			const VkDeviceSize offsets[ 1 ] = { 0 };
+			vkCmdBindVertexBuffers( vkCommandBuffer, 0, 1, &m_vecVisMaskBuffers[ unSwapchainIndex ].vertexBuffer.buffer, offsets );
+			vkCmdBindIndexBuffer( vkCommandBuffer, m_vecVisMaskBuffers[ unSwapchainIndex ].indexBuffer.buffer, 0, VK_INDEX_TYPE_UINT32 );
+
+			// update push constants
+			vkCmdPushConstants( vkCommandBuffer, vkPipelineLayoutVisMask, VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof( matVisMaskMVP.m ), &matVisMaskMVP.m[ 0 ] );
+
+			// finally, draw
+			vkCmdDrawIndexed( vkCommandBuffer, static_cast< uint32_t >( m_vecVisMasks[ unSwapchainIndex ].indices.size() ), 1, 0, 0, 0 );
+		}
+
+		// (8) Draw skybox
+		if ( GetSkyboxVisibility() )
+		{
+			UpdateUniformBuffers( &uboMatricesSkybox, &vecUniformBuffers[ m_unCurrentFrame ].skybox, skybox, &matViewProjection, eyePose );
+
+			vkCmdBindDescriptorSets( vkCommandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, vkPipelineLayout, 0, 1, &vecDescriptorSets[ m_unCurrentFrame ].skybox, 0, nullptr );
+			vkCmdBindPipeline( vkCommandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipelines.skybox );
+			skybox->gltfModel.draw( vkCommandBuffer );
+		}
+
+		// (9) Draw all renderables (recording command buffer)
+
+		// (9.1) Update renderables shader values UBOs
+		UpdateUniformBuffers( &uboMatricesScene, &vecUniformBuffers[ m_unCurrentFrame ].scene, &matViewProjection, eyePose );
+
+		// (9.2) Copy pbr properties to gpu
+		memcpy( vecUniformBuffers[ m_unCurrentFrame ].params.mapped, &shaderValuesPbrParams, sizeof( shaderValuesPbrParams ) );
+
+		// (9.3) Draw renderables - with parallel recording, worker threads record these while we record the rest of the frame
+		if ( IsParallelRecordingEnabled() )
+		{
+			StartParallelRecording( &renderPassBeginInfo );
+			vkEndCommandBuffer( vkCommandBuffer );
+			vkCommandBuffer = BeginSecondaryCommandBuffer( k_unSecondaryPost, &renderPassBeginInfo );
+		}
+		else
+		{
+			RenderGltfScenes( vkCommandBuffer );
+		}
+
+		// (10) Draw basic geometry if present
+		for ( auto &shape : vecShapes )
+		{
+			if ( !shape->bIsVisible )
+				continue;
+
+			// Bind the graphics pipeline for this shape
+			vkCmdBindPipeline( vkCommandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, shape->pipeline );
+
+			// Bind shape's index and vertex buffers
+			const VkDeviceSize offsets[ 1 ] = { 0 };
+			vkCmdBindIndexBuffer( vkCommandBuffer, shape->indexBuffer.buffer, 0, VK_INDEX_TYPE_UINT16 );
+			vkCmdBindVertexBuffers( vkCommandBuffer, 0, 1, &shape->vertexBuffer.buffer, offsets );
+
+			// Compute the model-view-projection transform and push as a vertex shader constant
+			XrMatrix4x4f model;
+			XrMatrix4x4f_CreateTranslationRotationScale( &model, &shape->pose.position, &shape->pose.orientation, &shape->scale );
+
+			XrMatrix4x4f mvp;
+			XrMatrix4x4f_Multiply( &mvp, &matViewProjection, &model );
+
+			vkCmdPushConstants( vkCommandBuffer, vkPipelineLayoutShapes, VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof( mvp.m ), &mvp.m[ 0 ] );
+
+			// Draw the shape
+			vkCmdDrawIndexed( vkCommandBuffer, shape->indexBuffer.count, 1, 0, 0, 0 );
+		}
+
+		// (10.1) Draw instanced basic geometry - one draw per batch
+		DrawShapeBatches( vkCommandBuffer, &matViewProjection, 1 );
+
+		// (11) End render pass
+		if ( IsParallelRecordingEnabled() )
+		{
+			vkEndCommandBuffer( vkCommandBuffer );
+			ExecuteSecondaryCommandBuffers( vkPrimaryCommandBuffer );
+		}
+
+		vkCmdEndRenderPass( vkPrimaryCommandBuffer );
+
+		// (12) Close command buffer recording
+		EndGpuTiming( vkPrimaryCommandBuffer );
+		vkEndCommandBuffer( vkPrimaryCommandBuffer );
+		m_pFrameTiming->MarkEnd( oxr::EFrameStage::RecordCommands, m_unTimedPass );
+		return VK_SUCCESS;
+	}
+
+	void Render::BeginRenderMultiview(
+		oxr::Session *pSession,
+		std::vector< XrCompositionLayerProjectionView > &vecFrameLayerProjectionViews,
+		XrFrameState *pFrameState,
+		uint32_t unSwapchainIndex,
+		uint32_t unImageIndex,
+		float fNearZ,
+		float fFarZ,
+		XrVector3f v3fScaleEyeView )
+	{
+		assert( vecFrameLayerProjectionViews.size() >= k_unMultiviewCount );
+
+		// (1) Set command buffer to recording
+		VkCommandBuffer vkPrimaryCommandBuffer = m_vecFrameData[ m_unCurrentFrame ].vkCommandBuffer;
+		VkCommandBuffer vkCommandBuffer = vkPrimaryCommandBuffer;
+
+		VkCommandBufferBeginInfo cmdBeginInfo { VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO };
+		vkBeginCommandBuffer( vkPrimaryCommandBuffer, &cmdBeginInfo );
+		BeginGpuTiming( vkPrimaryCommandBuffer );
+
+		// (1.1) Acquire completed uploads and set up renderables that finished streaming in
+		if ( unSwapchainIndex == 0 )
+		{
+			m_pUploadManager->RecordGraphicsWork( vkPrimaryCommandBuffer );
+			FinishStreamedRenderables();
+		}
+
+		// (1.2) Update head and renderable poses and create the view projection and vismask matrices for each view
+		UpdateHmdState( pSession, pFrameState );
+
+		XrPosef eyePoses[ k_unMultiviewCount ];
+		XrMatrix4x4f matViewProjections[ k_unMultiviewCount ];
+		PushConstVisMaskMultiview pushConstVisMasks[ k_unMultiviewCount ];
+
+		for ( uint32_t i = 0; i < k_unMultiviewCount; i++ )
+		{
+			eyePoses[ i ] = vecFrameLayerProjectionViews[ i ].pose;
+			pushConstVisMasks[ i ].unViewIndex = i;
+			CalculateViewProjection( &matViewProjections[ i ], &pushConstVisMasks[ i ].mvp, &vecFrameLayerProjectionViews[ i ], fNearZ, fFarZ, &v3fScaleEyeView );
+		}
+
+		UpdateRenderablePoses( pSession, pFrameState );
+
+		// (1.3) Cull instanced renderables against the frustums of all views - compute work has to be recorded outside the render pass
+		CullInstanceGroups( vkPrimaryCommandBuffer, matViewProjections, k_unMultiviewCount );
+
+		// (2) Set render pass info - the render pass view mask broadcasts all draws to each layer of the array swapchain image
+		auto *pSwapchain = &pSession->GetSwapchains()[ unSwapchainIndex ];
+
+		VkRenderPassBeginInfo renderPassBeginInfo { VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO };
+		renderPassBeginInfo.clearValueCount = ( uint32_t )m_SharedState.vkClearValues.size();
+		renderPassBeginInfo.pClearValues = m_SharedState.vkClearValues.data();
+		renderPassBeginInfo.renderPass = m_vecRenderPasses[ 0 ];
+		renderPassBeginInfo.framebuffer = m_vec2RenderTargets[ unSwapchainIndex ][ unImageIndex ].vkFrameBuffer;
+		renderPassBeginInfo.renderArea.offset = { 0, 0 };
+		renderPassBeginInfo.renderArea.extent = { ( uint32_t )pSwapchain->unWidth, ( uint32_t )pSwapchain->unHeight };
+
+		// (3) Start render pass
+		vkCmdBeginRenderPass( vkPrimaryCommandBuffer, &renderPassBeginInfo, IsParallelRecordingEnabled() ? VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS : VK_SUBPASS_CONTENTS_INLINE );
+
+		if ( IsParallelRecordingEnabled() )
+			vkCommandBuffer = BeginSecondaryCommandBuffer( k_unSecondaryPre, &renderPassBeginInfo );
+
+		// (4) Draw vismasks if available - each mask is discarded by the vertex shader in views other than its own
+		for ( uint32_t i = 0; i < k_unMultiviewCount && i < m_vecVisMasks.size(); i++ )
+		{
+			if ( m_vecVisMasks[ i ].indices.empty() )
+				continue;
+
+			assert( m_vecVisMasks.size() == m_vecVisMaskBuffers.size() );
+
+			vkCmdBindPipeline( vkCommandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipelines.vismask );
+
+			const VkDeviceSize offsets[ 1 ] = { 0 };
+			vkCmdBindVertexBuffers( vkCommandBuffer, 0, 1, &m_vecVisMaskBuffers[ i ].vertexBuffer.buffer, offsets );
+			vkCmdBindIndexBuffer( vkCommandBuffer, m_vecVisMaskBuffers[ i ].indexBuffer.buffer, 0, VK_INDEX_TYPE_UINT32 );
+
+			vkCmdPushConstants( vkCommandBuffer, vkPipelineLayoutVisMask, VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof( PushConstVisMaskMultiview ), &pushConstVisMasks[ i ] );
+			vkCmdDrawIndexed( vkCommandBuffer, static_cast< uint32_t >( m_vecVisMasks[ i ].indices.size() ), 1, 0, 0, 0 );
+		}
+
+		// (5) Draw skybox
+		if ( GetSkyboxVisibility() )
+		{
+			UpdateUniformBuffers( &uboMatricesSkyboxMultiview, &vecUniformBuffers[ m_unCurrentFrame ].skybox, skybox, matViewProjections, eyePoses );
+
+			vkCmdBindDescriptorSets( vkCommandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, vkPipelineLayout, 0, 1, &vecDescriptorSets[ m_unCurrentFrame ].skybox, 0, nullptr );
+			vkCmdBindPipeline( vkCommandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipelines.skybox );
+			skybox->gltfModel.draw( vkCommandBuffer );
+		}
 
-		// (8.2) Update current hmd pose
-		if ( currentHmdState.space != XR_NULL_HANDLE )
+		// (6) Draw all renderables once for all views
+		UpdateUniformBuffers( &uboMatricesSceneMultiview, &vecUniformBuffers[ m_unCurrentFrame ].scene, matViewProjections, eyePoses );
+		memcpy( vecUniformBuffers[ m_unCurrentFrame ].params.mapped, &shaderValuesPbrParams, sizeof( shaderValuesPbrParams ) );
+
+		if ( IsParallelRecordingEnabled() )
+		{
+			StartParallelRecording( &renderPassBeginInfo );
+			vkEndCommandBuffer( vkCommandBuffer );
+			vkCommandBuffer = BeginSecondaryCommandBuffer( k_unSecondaryPost, &renderPassBeginInfo );
+		}
+		else
 		{
-			XrSpaceLocation xrSpaceLocation { XR_TYPE_SPACE_LOCATION };
-			pSession->LocateSpace( pSession->GetAppSpace(), currentHmdState.space, pFrameState->predictedDisplayTime, &xrSpaceLocation );
+			RenderGltfScenes( vkCommandBuffer );
+		}
 
-			if ( xrSpaceLocation.locationFlags & XR_SPACE_LOCATION_POSITION_VALID_BIT )
-				currentHmdState.position = xrSpaceLocation.pose.position;
+		// (7) Draw basic geometry if present - the mvp of each view is pushed as vertex shader constants
+		for ( auto &shape : vecShapes )
+		{
+			if ( !shape->bIsVisible )
+				continue;
+
+			vkCmdBindPipeline( vkCommandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, shape->pipeline );
 
-			if ( xrSpaceLocation.locationFlags & XR_SPACE_LOCATION_ORIENTATION_VALID_BIT )
-				currentHmdState.orientation = xrSpaceLocation.pose.orientation;
+			const VkDeviceSize offsets[ 1 ] = { 0 };
+			vkCmdBindIndexBuffer( vkCommandBuffer, shape->indexBuffer.buffer, 0, VK_INDEX_TYPE_UINT16 );
+			vkCmdBindVertexBuffers( vkCommandBuffer, 0, 1, &shape->vertexBuffer.buffer, offsets );
+
+			XrMatrix4x4f model;
+			XrMatrix4x4f_CreateTranslationRotationScale( &model, &shape->pose.position, &shape->pose.orientation, &shape->scale );
+
+			XrMatrix4x4f mvps[ k_unMultiviewCount ];
+			for ( uint32_t i = 0; i < k_unMultiviewCount; i++ )
+				XrMatrix4x4f_Multiply( &mvps[ i ], &matViewProjections[ i ], &model );
+
+			vkCmdPushConstants( vkCommandBuffer, vkPipelineLayoutShapes, VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof( mvps ), &mvps[ 0 ].m[ 0 ] );
+			vkCmdDrawIndexed( vkCommandBuffer, shape->indexBuffer.count, 1, 0, 0, 0 );
+		}
+
+		// (7.1) Draw instanced basic geometry - one draw per batch for all views
+		DrawShapeBatches( vkCommandBuffer, matViewProjections, k_unMultiviewCount );
+
+		// (8) End render pass
+		if ( IsParallelRecordingEnabled() )
+		{
+			vkEndCommandBuffer( vkCommandBuffer );
+			ExecuteSecondaryCommandBuffers( vkPrimaryCommandBuffer );
 		}
 
-		// (9) Create the view matrix (eye transform)
+		vkCmdEndRenderPass( vkPrimaryCommandBuffer );
+
+		// (9) Close command buffer recording
+		EndGpuTiming( vkPrimaryCommandBuffer );
+		vkEndCommandBuffer( vkPrimaryCommandBuffer );
+		m_pFrameTiming->MarkEnd( oxr::EFrameStage::RecordCommands, m_unTimedPass );
+	}
+
+	void Render::UpdateHmdState( oxr::Session *pSession, XrFrameState *pFrameState )
+	{
+		if ( currentHmdState.space == XR_NULL_HANDLE )
+			return;
 
-		// (9.1) Update player position in world
+		XrSpaceLocation xrSpaceLocation { XR_TYPE_SPACE_LOCATION };
+		pSession->LocateSpace( pSession->GetAppSpace(), currentHmdState.space, pFrameState->predictedDisplayTime, &xrSpaceLocation );
+
+		if ( xrSpaceLocation.locationFlags & XR_SPACE_LOCATION_POSITION_VALID_BIT )
+			currentHmdState.position = xrSpaceLocation.pose.position;
+
+		if ( xrSpaceLocation.locationFlags & XR_SPACE_LOCATION_ORIENTATION_VALID_BIT )
+			currentHmdState.orientation = xrSpaceLocation.pose.orientation;
+	}
+
+	void Render::CalculateViewProjection(
+		XrMatrix4x4f *outMatViewProjection, XrMatrix4x4f *outMatVisMaskMVP, XrCompositionLayerProjectionView *pProjectionView, float fNearZ, float fFarZ, XrVector3f *pScaleEyeView )
+	{
+		XrPosef *eyePose = &pProjectionView->pose;
+
+		// (1) Create the projection matrix
+		XrMatrix4x4f matProjection;
+		XrMatrix4x4f_CreateProjectionFov( &matProjection, GRAPHICS_VULKAN, pProjectionView->fov, fNearZ, fFarZ );
+
+		// (2) Create the view matrix (eye transform)
+
+		// (2.1) Update player position in world
 		WorldState newPlayerWorldState {};
 
 		newPlayerWorldState.position.x = playerWorldState.position.x + eyePose->position.x;
 		newPlayerWorldState.position.y = playerWorldState.position.y + eyePose->position.y;
 		newPlayerWorldState.position.z = playerWorldState.position.z + eyePose->position.z;
 
-		// (9.2) Update player orientation in world
+		// (2.2) Update player orientation in world
 		XrQuaternionf_Multiply( &newPlayerWorldState.orientation, &playerWorldState.orientation, &eyePose->orientation );
 
-		// (9.3) Create TRS matrix
+		// (2.3) Create TRS matrix
 		XrMatrix4x4f matView;
-		XrMatrix4x4f_CreateTranslationRotationScale( &matView, &newPlayerWorldState.position, &newPlayerWorldState.orientation, &v3fScaleEyeView );
+		XrMatrix4x4f_CreateTranslationRotationScale( &matView, &newPlayerWorldState.position, &newPlayerWorldState.orientation, pScaleEyeView );
 
-		// (10) Invert
+		// (3) Invert
 		XrMatrix4x4f matInvertedRigidBodyView;
 		XrMatrix4x4f_InvertRigidBody( &matInvertedRigidBodyView, &matView );
 
-		// (11) View Projection
-		XrMatrix4x4f matViewProjection;
-		XrMatrix4x4f_Multiply( &matViewProjection, &matProjection, &matInvertedRigidBodyView );
+		// (4) View Projection
+		XrMatrix4x4f_Multiply( outMatViewProjection, &matProjection, &matInvertedRigidBodyView );
 
-		// (12) Draw vismask if available
-		if ( m_vecVisMasks.size() > unSwapchainIndex && !m_vecVisMasks[ unSwapchainIndex ].indices.empty() )
-		{
-			assert( m_vecVisMasks.size() == m_vecVisMaskBuffers.size() );
+		// (5) Vismask mvp - the mask is fixed to the eye, so it ignores the player's world state
+		XrMatrix4x4f matVisMask;
+		XrVector3f scaleVisMask;
+		XrVector3f_Set( &scaleVisMask, 1.f );
+		XrMatrix4x4f_CreateTranslationRotationScale( &matVisMask, &eyePose->position, &eyePose->orientation, &scaleVisMask );
 
-			// Reverse winding order
-			for ( auto &vismask : m_vecVisMasks )
-			{
-				for ( uint32_t i = 0; i < vismask.indices.size(); i += 3 )
-				{
-					std::swap( vismask.indices[ i + 1 ], vismask.indices[ i + 2 ] );
-				}
-			}
-
-			XrMatrix4x4f matVisMask;
-			XrMatrix4x4f_CreateIdentity( &matVisMask );
+		XrMatrix4x4f vismaskMatView;
+		XrMatrix4x4f_CreateTranslationRotationScale( &vismaskMatView, &eyePose->position, &eyePose->orientation, pScaleEyeView );
 
-			XrVector3f scaleVisMask;
-			XrVector3f_Set( &scaleVisMask, 1.f );
-			XrMatrix4x4f_CreateTranslationRotationScale( &matVisMask, &eyePose->position, &eyePose->orientation, &scaleVisMask );
+		XrMatrix4x4f vismaskMatInvertedRigidBodyView;
+		XrMatrix4x4f_InvertRigidBody( &vismaskMatInvertedRigidBodyView, &vismaskMatView );
 
-			// calculate mvp
-			XrMatrix4x4f vismaskMatView;
-			XrMatrix4x4f_CreateTranslationRotationScale( &vismaskMatView, &eyePose->position, &eyePose->orientation, &v3fScaleEyeView );
+		XrMatrix4x4f vismaskViewProjection;
+		XrMatrix4x4f_Multiply( &vismaskViewProjection, &matProjection, &vismaskMatInvertedRigidBodyView );
 
-			XrMatrix4x4f vismaskMatInvertedRigidBodyView;
-			XrMatrix4x4f_InvertRigidBody( &vismaskMatInvertedRigidBodyView, &vismaskMatView );
+		XrMatrix4x4f_Multiply( outMatVisMaskMVP, &vismaskViewProjection, &matVisMask );
+	}
 
-			XrMatrix4x4f vismaskViewProjection;
-			XrMatrix4x4f_Multiply( &vismaskViewProjection, &matProjection, &vismaskMatInvertedRigidBodyView );
+	VkResult Render::EndRender()
+	{
+		// Nothing was recorded if BeginRender couldn't get its frame slot
+		if ( !m_bRenderRecorded )
+			return m_bDeviceLost ? VK_ERROR_DEVICE_LOST : VK_NOT_READY;
 
-			XrMatrix4x4f mvp;
-			XrMatrix4x4f_CreateIdentity( &mvp );
-			XrMatrix4x4f_Multiply( &mvp, &vismaskViewProjection, &matVisMask );
+		m_bRenderRecorded = false;
 
-			// bind graphics pipeline
-			vkCmdBindPipeline( m_vecFrameData[ 0 ].vkCommandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipelines.vismask );
+		// Execute command buffer (requires exclusive access to vkQueue)
+		// safest after wait swapchain image
+		VkSubmitInfo submitInfo { VK_STRUCTURE_TYPE_SUBMIT_INFO };
+		submitInfo.commandBufferCount = 1;
+		submitInfo.pCommandBuffers = &m_vecFrameData[ m_unCurrentFrame ].vkCommandBuffer;
+		m_pFrameTiming->MarkBegin( oxr::EFrameStage::QueueSubmit, m_unTimedPass );
+		VkResult vkResult = VK_SUCCESS;
+		{
+			// asset loader threads may be uploading on the same queue
+			const std::lock_guard< std::mutex > lock( m_pVulkanDevice->queueMutex );
+			vkResult = vkQueueSubmit( m_SharedState.vkQueue, 1, &submitInfo, m_vecFrameData[ m_unCurrentFrame ].vkCommandFence );
+		}
+		m_pFrameTiming->MarkEnd( oxr::EFrameStage::QueueSubmit, m_unTimedPass );
 
-			// bind buffers
-			const VkDeviceSize offsets[ 1 ] = { 0 };
-			vkCmdBindVertexBuffers( m_vecFrameData[ 0 ].vkCommandBuffer, 0, 1, &m_vecVisMaskBuffers[ unSwapchainIndex ].vertexBuffer.buffer, offsets );
-			vkCmdBindIndexBuffer( m_vecFrameData[ 0 ].vkCommandBuffer, m_vecVisMaskBuffers[ unSwapchainIndex ].indexBuffer.buffer, 0, VK_INDEX_TYPE_UINT32 );
+		// The frame is ended without layers if the submit failed. The slot's fence was reset for this submit, so signal it with an empty one
+		// to let the slot be reused - unless the device is lost, after which no render waits on it
+		if ( vkResult != VK_SUCCESS )
+		{
+			LogError( "Unable to submit frame slot %u with vulkan result (%i), frame layers won't be submitted.", m_unCurrentFrame, ( int32_t )vkResult );
+			m_pSession->DiscardFrameLayers();
 
-			// update push constants
-			vkCmdPushConstants( m_vecFrameData[ 0 ].vkCommandBuffer, vkPipelineLayoutVisMask, VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof( mvp.m ), &mvp.m[ 0 ] );
+			m_bDeviceLost = vkResult == VK_ERROR_DEVICE_LOST;
+			if ( !m_bDeviceLost )
+			{
+				const std::lock_guard< std::mutex > lock( m_pVulkanDevice->queueMutex );
+				vkQueueSubmit( m_SharedState.vkQueue, 0, nullptr, m_vecFrameData[ m_unCurrentFrame ].vkCommandFence );
+			}
 
-			// finally, draw
-			vkCmdDrawIndexed( m_vecFrameData[ 0 ].vkCommandBuffer, static_cast< uint32_t >( m_vecVisMasks[ unSwapchainIndex ].indices.size() ), 1, 0, 0, 0 );
+			return vkResult;
 		}
 
-		// (13) Draw skybox
-		if ( GetSkyboxVisibility() )
+		// The session only ends the frame once this submission has finished
+		m_pSession->AddFrameGpuFence( m_SharedState.vkDevice, m_vecFrameData[ m_unCurrentFrame ].vkCommandFence );
+
+		// Move on to the next frame slot - we'll only wait for this submission once its slot comes around again
+		m_unCurrentFrame = ( m_unCurrentFrame + 1 ) % static_cast< uint32_t >( m_vecFrameData.size() );
+		return VK_SUCCESS;
+	}
+
+	VkResult Render::WaitForFrameSlot()
+	{
+		FrameData *pFrameData = &m_vecFrameData[ m_unCurrentFrame ];
+
+		// (1) A lost device never signals the fence again, don't wait on it every render
+		if ( m_bDeviceLost )
+			return VK_ERROR_DEVICE_LOST;
+
+		// (2) The slot's scene uniforms, descriptor sets and the mesh uniform region of every model it drew are rewritten for this render,
+		//     so it can't be reused until the gpu is done with them. The fence and pools are left as is on failure, so the next render waits again
+		VkResult vkResult = vkWaitForFences( m_SharedState.vkDevice, 1, &pFrameData->vkCommandFence, VK_TRUE, k_unFrameSlotTimeoutNs );
+		if ( vkResult == VK_TIMEOUT )
 		{
-			UpdateUniformBuffers( &uboMatricesSkybox, &skyboxUniformBuffer, skybox, &matViewProjection, eyePose );
+			LogError( "Timed out waiting for frame slot %u to finish rendering, skipping this render.", m_unCurrentFrame );
+			return vkResult;
+		}
 
-			// todo: double buffering, vecDescriptorSets[ x ].skybox : x for command buffer index
-			vkCmdBindDescriptorSets( m_vecFrameData[ 0 ].vkCommandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, vkPipelineLayout, 0, 1, &vecDescriptorSets[ 0 ].skybox, 0, nullptr );
-			vkCmdBindPipeline( m_vecFrameData[ 0 ].vkCommandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipelines.skybox );
-			skybox->gltfModel.draw( m_vecFrameData[ 0 ].vkCommandBuffer );
+		if ( vkResult != VK_SUCCESS )
+		{
+			m_bDeviceLost = vkResult == VK_ERROR_DEVICE_LOST;
+			LogError( "Unable to wait for frame slot %u with vulkan result (%i), skipping this render.", m_unCurrentFrame, ( int32_t )vkResult );
+			return vkResult;
 		}
 
-		// (14) Draw all renderables (recording command buffer)
+		// (3) Reuse the slot
+		vkResetFences( m_SharedState.vkDevice, 1, &pFrameData->vkCommandFence );
+		vkResetCommandPool( m_SharedState.vkDevice, pFrameData->vkCommandPool, 0 );
 
-		// (14.1) Update renderables current poses
-		UpdateRenderablePoses( pSession, pFrameState );
+		for ( auto &vkCommandPool : pFrameData->vecSecondaryCommandPools )
+			vkResetCommandPool( m_SharedState.vkDevice, vkCommandPool, 0 );
 
-		// (14.2) Update renderables shader values UBOs
-		UpdateUniformBuffers( &uboMatricesScene, &vecUniformBuffers[ 0 ].scene, &matViewProjection, eyePose );
+		// The slot's previous render is done, so are its timestamps
+		ResolveGpuTiming();
+	}
 
-		// (14.3) Copy pbr properties to gpu
-		memcpy( vecUniformBuffers[ 0 ].params.mapped, &shaderValuesPbrParams, sizeof( shaderValuesPbrParams ) );
+	void Render::BeginGpuTiming( VkCommandBuffer vkCommandBuffer )
+	{
+		FrameData *pFrameData = &m_vecFrameData[ m_unCurrentFrame ];
+		pFrameData->bTimestampsWritten = m_vkTimestampQueryPool != VK_NULL_HANDLE && m_pFrameTiming->IsTimingFrame();
+		if ( !pFrameData->bTimestampsWritten )
+			return;
 
-		// (14.4) Draw renderables
-		RenderGltfScenes();
+		pFrameData->unTimedFrameIndex = m_pFrameTiming->GetCurrentFrameIndex();
+		pFrameData->unTimedPass = m_unTimedPass;
 
-		// (15) Draw basic geometry if present
-		for ( auto &shape : vecShapes )
-		{
-			if ( !shape->bIsVisible )
-				continue;
+		// queries must be reset outside of a render pass
+		vkCmdResetQueryPool( vkCommandBuffer, m_vkTimestampQueryPool, 2 * m_unCurrentFrame, 2 );
+		vkCmdWriteTimestamp( vkCommandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, m_vkTimestampQueryPool, 2 * m_unCurrentFrame );
+	}
 
-			// Bind the graphics pipeline for this shape
-			vkCmdBindPipeline( m_vecFrameData[ 0 ].vkCommandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, shape->pipeline );
+	void Render::EndGpuTiming( VkCommandBuffer vkCommandBuffer )
+	{
+		if ( m_vecFrameData[ m_unCurrentFrame ].bTimestampsWritten )
+			vkCmdWriteTimestamp( vkCommandBuffer, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, m_vkTimestampQueryPool, 2 * m_unCurrentFrame + 1 );
+	}
 
-			// Bind shape's index and vertex buffers
-			const VkDeviceSize offsets[ 1 ] = { 0 };
-			vkCmdBindIndexBuffer( m_vecFrameData[ 0 ].vkCommandBuffer, shape->indexBuffer.buffer, 0, VK_INDEX_TYPE_UINT16 );
-			vkCmdBindVertexBuffers( m_vecFrameData[ 0 ].vkCommandBuffer, 0, 1, &shape->vertexBuffer.buffer, offsets );
+	void Render::ResolveGpuTiming()
+	{
+		FrameData *pFrameData = &m_vecFrameData[ m_unCurrentFrame ];
+		if ( !pFrameData->bTimestampsWritten )
+			return;
 
-			// Compute the model-view-projection transform and push as a vertex shader constant
-			XrMatrix4x4f model;
-			XrMatrix4x4f_CreateTranslationRotationScale( &model, &shape->pose.position, &shape->pose.orientation, &shape->scale );
+		pFrameData->bTimestampsWritten = false;
 
-			XrMatrix4x4f mvp;
-			XrMatrix4x4f_Multiply( &mvp, &matViewProjection, &model );
+		uint64_t unTimestamps[ 2 ] = {};
+		if ( vkGetQueryPoolResults(
+				 m_SharedState.vkDevice, m_vkTimestampQueryPool, 2 * m_unCurrentFrame, 2, sizeof( unTimestamps ), unTimestamps, sizeof( uint64_t ), VK_QUERY_RESULT_64_BIT ) != VK_SUCCESS )
+			return;
 
-			vkCmdPushConstants( m_vecFrameData[ 0 ].vkCommandBuffer, vkPipelineLayoutShapes, VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof( mvp.m ), &mvp.m[ 0 ] );
+		const uint64_t unTicks = ( unTimestamps[ 1 ] - unTimestamps[ 0 ] ) & m_unTimestampMask;
+		const float fMs = static_cast< float >( unTicks * static_cast< double >( m_pVulkanDevice->properties.limits.timestampPeriod ) / 1000000.0 );
+		m_pFrameTiming->SetGpuPassTime( pFrameData->unTimedFrameIndex, pFrameData->unTimedPass, fMs );
+	}
 
-			// Draw the shape
-			vkCmdDrawIndexed( m_vecFrameData[ 0 ].vkCommandBuffer, shape->indexBuffer.count, 1, 0, 0, 0 );
-		}
+	VkCommandBuffer Render::BeginSecondaryCommandBuffer( uint32_t unIndex, VkRenderPassBeginInfo *pRenderPassBeginInfo )
+	{
+		VkCommandBuffer vkCommandBuffer = m_vecFrameData[ m_unCurrentFrame ].vecSecondaryCommandBuffers[ unIndex ];
 
-		// (16) End render pass
-		vkCmdEndRenderPass( m_vecFrameData[ 0 ].vkCommandBuffer );
+		// secondaries continue the primary's render pass, so they need to know which render pass and framebuffer they'll be executed in
+		VkCommandBufferInheritanceInfo inheritanceInfo { VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO };
+		inheritanceInfo.renderPass = pRenderPassBeginInfo->renderPass;
+		inheritanceInfo.subpass = 0;
+		inheritanceInfo.framebuffer = pRenderPassBeginInfo->framebuffer;
+
+		VkCommandBufferBeginInfo cmdBeginInfo { VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO };
+		cmdBeginInfo.flags = VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT;
+		cmdBeginInfo.pInheritanceInfo = &inheritanceInfo;
+		vkBeginCommandBuffer( vkCommandBuffer, &cmdBeginInfo );
 
-		// (17) Close command buffer recording
-		vkEndCommandBuffer( m_vecFrameData[ 0 ].vkCommandBuffer );
+		return vkCommandBuffer;
 	}
 
-	void Render::EndRender()
+	void Render::StartParallelRecording( VkRenderPassBeginInfo *pRenderPassBeginInfo )
 	{
-		// Execute command buffer (requires exclusive access to vkQueue)
-		// safest after wait swapchain image
-		VkSubmitInfo submitInfo { VK_STRUCTURE_TYPE_SUBMIT_INFO };
-		submitInfo.commandBufferCount = 1;
-		submitInfo.pCommandBuffers = &m_vecFrameData[ 0 ].vkCommandBuffer;
-		vkQueueSubmit( m_SharedState.vkQueue, 1, &submitInfo, m_vecFrameData[ 0 ].vkCommandFence );
+		assert( m_pJobSystem );
+		assert( m_vecRecordingJobs.empty() );
 
-		const uint32_t timeoutNs = 1 * 1000000000;
-		vkWaitForFences( m_SharedState.vkDevice, 1, &m_vecFrameData[ 0 ].vkCommandFence, VK_TRUE, timeoutNs );
-		vkResetFences( m_SharedState.vkDevice, 1, &m_vecFrameData[ 0 ].vkCommandFence );
-		vkResetCommandBuffer( m_vecFrameData[ 0 ].vkCommandBuffer, 0 );
-	}
+		// (1) Gather visible renderables in the same order they're drawn single threaded
+		m_vecRecordingRenderables.clear();
+		for ( auto &renderable : vecRenderScenes )
+		{
+			if ( renderable->bIsVisible )
+				m_vecRecordingRenderables.push_back( renderable );
+		}
 
-	void Render::RenderNode( RenderSceneBase *renderable, vkglTF::Node *gltfNode, uint32_t unCmdBufIndex, vkglTF::Material::AlphaMode gltfAlphaMode )
-	{
-		if ( gltfNode->mesh )
+		for ( auto &renderable : vecRenderSectors )
 		{
-			// update gltf node pose and scale with renderable's
-			gltfNode->scale = renderable->GetScale();
-			gltfNode->translation = renderable->GetPosition();
-			gltfNode->rotation = renderable->GetRotation();
-			gltfNode->update();
+			if ( renderable->IsInstanceSource() || ( renderable->bIsVisible && !renderable->pInstanceGroup ) )
+				m_vecRecordingRenderables.push_back( renderable );
+		}
 
-			// Render mesh primitives
-			for ( vkglTF::Primitive *primitive : gltfNode->mesh->primitives )
-			{
-				vkBoundPipeline = renderable->vkPipeline;
+		for ( auto &renderable : vecRenderModels )
+		{
+			if ( renderable->IsInstanceSource() || ( renderable->bIsVisible && !renderable->pInstanceGroup ) )
+				m_vecRecordingRenderables.push_back( renderable );
+		}
 
-				// Check for custom pipeline
-				if ( vkBoundPipeline != VK_NULL_HANDLE )
-				{
-					vkCmdBindPipeline( m_vecFrameData[ unCmdBufIndex ].vkCommandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, vkBoundPipeline );
-				}
-				else if ( primitive->material.alphaMode == gltfAlphaMode )
-				{
-					// Otherwise, use our pbr pipelines
-					VkPipeline pipeline = VK_NULL_HANDLE;
-					switch ( gltfAlphaMode )
-					{
-						case vkglTF::Material::ALPHAMODE_OPAQUE:
-						case vkglTF::Material::ALPHAMODE_MASK:
-							pipeline = primitive->material.doubleSided ? pipelines.pbrDoubleSided : pipelines.pbr;
-							break;
-						case vkglTF::Material::ALPHAMODE_BLEND:
-							pipeline = pipelines.pbrAlphaBlend;
-							break;
-					}
+		// (2) Split renderables into contiguous chunks, one per worker thread - executing chunks in order keeps draw order identical to single threaded
+		const uint32_t unRenderables = static_cast< uint32_t >( m_vecRecordingRenderables.size() );
+		const uint32_t unChunks = std::min( m_pJobSystem->GetThreadCount(), unRenderables );
 
-					if ( pipeline != vkBoundPipeline )
-					{
-						vkCmdBindPipeline( m_vecFrameData[ unCmdBufIndex ].vkCommandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline );
-						vkBoundPipeline = pipeline;
-					}
-				}
+		// (3) Record each chunk into its own secondary command buffer (each with its own pool) in a worker thread
+		for ( uint32_t i = 0; i < unChunks; i++ )
+		{
+			const uint32_t unStart = ( unRenderables * i ) / unChunks;
+			const uint32_t unEnd = ( unRenderables * ( i + 1 ) ) / unChunks;
+			VkCommandBuffer vkCommandBuffer = BeginSecondaryCommandBuffer( k_unSecondaryFirstChunk + i, pRenderPassBeginInfo );
 
-				if ( vkBoundPipeline != VK_NULL_HANDLE )
+			m_vecRecordingJobs.push_back( m_pJobSystem->Submit(
+				[ this, vkCommandBuffer, unStart, unEnd ]()
 				{
-					const std::vector< VkDescriptorSet > descriptorsets = {
-						vecDescriptorSets[ unCmdBufIndex ].scene,
-						primitive->material.descriptorSet,
-						gltfNode->mesh->uniformBuffer.descriptorSet,
-					};
-					vkCmdBindDescriptorSets(
-						m_vecFrameData[ unCmdBufIndex ].vkCommandBuffer,
-						VK_PIPELINE_BIND_POINT_GRAPHICS,
-						vkPipelineLayout,
-						0,
-						static_cast< uint32_t >( descriptorsets.size() ),
-						descriptorsets.data(),
-						0,
-						NULL );
-
-					// Pass material parameters as push constants
-					PushConstBlockMaterial pushConstBlockMaterial {};
-					pushConstBlockMaterial.emissiveFactor = primitive->material.emissiveFactor;
-
-					// To save push constant space, availability and texture coordinate set are combined
-					// -1 = texture not used for this material, >= 0 texture used and index of texture coordinate set
-					pushConstBlockMaterial.colorTextureSet = primitive->material.baseColorTexture != nullptr ? primitive->material.texCoordSets.baseColor : -1;
-					pushConstBlockMaterial.normalTextureSet = primitive->material.normalTexture != nullptr ? primitive->material.texCoordSets.normal : -1;
-					pushConstBlockMaterial.occlusionTextureSet = primitive->material.occlusionTexture != nullptr ? primitive->material.texCoordSets.occlusion : -1;
-					pushConstBlockMaterial.emissiveTextureSet = primitive->material.emissiveTexture != nullptr ? primitive->material.texCoordSets.emissive : -1;
-					pushConstBlockMaterial.alphaMask = static_cast< float >( primitive->material.alphaMode == vkglTF::Material::ALPHAMODE_MASK );
-					pushConstBlockMaterial.alphaMaskCutoff = primitive->material.alphaCutoff;
-
-					// TODO: glTF specs states that metallic roughness should be preferred, even if specular glosiness is present
-
-					if ( primitive->material.pbrWorkflows.metallicRoughness )
-					{
-						// Metallic roughness workflow
-						pushConstBlockMaterial.workflow = static_cast< float >( PBR_WORKFLOW_METALLIC_ROUGHNESS );
-						pushConstBlockMaterial.baseColorFactor = primitive->material.baseColorFactor;
-						pushConstBlockMaterial.metallicFactor = primitive->material.metallicFactor;
-						pushConstBlockMaterial.roughnessFactor = primitive->material.roughnessFactor;
-						pushConstBlockMaterial.PhysicalDescriptorTextureSet = primitive->material.metallicRoughnessTexture != nullptr ? primitive->material.texCoordSets.metallicRoughness : -1;
-						pushConstBlockMaterial.colorTextureSet = primitive->material.baseColorTexture != nullptr ? primitive->material.texCoordSets.baseColor : -1;
-					}
-
-					if ( primitive->material.pbrWorkflows.specularGlossiness )
-					{
-						// Specular glossiness workflow
-						pushConstBlockMaterial.workflow = static_cast< float >( PBR_WORKFLOW_SPECULAR_GLOSINESS );
-						pushConstBlockMaterial.PhysicalDescriptorTextureSet =
-							primitive->material.extension.specularGlossinessTexture != nullptr ? primitive->material.texCoordSets.specularGlossiness : -1;
-						pushConstBlockMaterial.colorTextureSet = primitive->material.extension.diffuseTexture != nullptr ? primitive->material.texCoordSets.baseColor : -1;
-						pushConstBlockMaterial.diffuseFactor = primitive->material.extension.diffuseFactor;
-						pushConstBlockMaterial.specularFactor = glm::vec4( primitive->material.extension.specularFactor, 1.0f );
-					}
+					BindSceneDescriptorSets( vkCommandBuffer );
 
-					vkCmdPushConstants( m_vecFrameData[ unCmdBufIndex ].vkCommandBuffer, vkPipelineLayout, VK_SHADER_STAGE_FRAGMENT_BIT, 0, sizeof( PushConstBlockMaterial ), &pushConstBlockMaterial );
+					for ( uint32_t r = unStart; r < unEnd; r++ )
+						RenderGltfScene( m_vecRecordingRenderables[ r ], vkCommandBuffer );
 
-					if ( primitive->hasIndices )
-					{
-						vkCmdDrawIndexed( m_vecFrameData[ unCmdBufIndex ].vkCommandBuffer, primitive->indexCount, 1, primitive->firstIndex, 0, 0 );
-					}
-					else
-					{
-						vkCmdDraw( m_vecFrameData[ unCmdBufIndex ].vkCommandBuffer, primitive->vertexCount, 1, 0, 0 );
-					}
-				}
-			}
-		};
-		for ( auto child : gltfNode->children )
-		{
-			RenderNode( renderable, child, unCmdBufIndex, gltfAlphaMode );
+					vkEndCommandBuffer( vkCommandBuffer );
+				} ) );
 		}
 	}
 
+	void Render::ExecuteSecondaryCommandBuffers( VkCommandBuffer vkPrimaryCommandBuffer )
+	{
+		// (1) Wait for worker threads to finish recording
+		for ( auto &job : m_vecRecordingJobs )
+			job.get();
+
+		// (2) Execute in draw order: vismask and skybox, renderable chunks, then basic geometry
+		const std::vector< VkCommandBuffer > &vecSecondaries = m_vecFrameData[ m_unCurrentFrame ].vecSecondaryCommandBuffers;
+		const uint32_t unChunks = static_cast< uint32_t >( m_vecRecordingJobs.size() );
+
+		std::vector< VkCommandBuffer > vecExecute;
+		vecExecute.push_back( vecSecondaries[ k_unSecondaryPre ] );
+		for ( uint32_t i = 0; i < unChunks; i++ )
+			vecExecute.push_back( vecSecondaries[ k_unSecondaryFirstChunk + i ] );
+		vecExecute.push_back( vecSecondaries[ k_unSecondaryPost ] );
+
+		vkCmdExecuteCommands( vkPrimaryCommandBuffer, static_cast< uint32_t >( vecExecute.size() ), vecExecute.data() );
+		m_vecRecordingJobs.clear();
+	}
+
 	void Render::LoadAssets()
 	{
 		assert( skybox );
@@ -737,67 +1558,197 @@ namespace xrvk
 
 		// Load skybox
 		skybox->gltfModel.loadFromFile( skybox->sFilename, m_pVulkanDevice, m_SharedState.vkQueue );
+		skybox->bIsLoaded = true;
 		LoadEnvironment( skyboxTexture.c_str() );
 
 		// Load all renderables from storage
 		LoadGltfScenes();
 	}
 
-	void Render::LoadGltfScene( RenderSceneBase *renderable )
+	AssetHandle Render::LoadGltfScene( RenderSceneBase *renderable )
 	{
-		LogInfo( "gltf file %s started loading", renderable->sFilename.c_str() );
+		if ( m_pAssetLoader == nullptr )
+			m_pAssetLoader = new AssetLoader( m_pVulkanDevice, m_pUploadManager, m_unAssetLoaderThreads, m_sMeshCacheDirectory );
 
-		// reset
-		renderable->bIsVisible = false;
+		// reset - the model belongs to the loader until its load is done
+		renderable->bIsLoaded = false;
+		renderable->drawList.Clear();
 		renderable->gltfModel.destroy( m_SharedState.vkDevice );
-		nAnimationIndex = 0;
-		fAnimationTimer = 0.0f;
-
-		// load async
-		auto tStart = std::chrono::high_resolution_clock::now();
-		renderable->gltfModel.loadFromFile( renderable->sFilename, m_pVulkanDevice, m_SharedState.vkQueue );
-		auto tFileLoad = std::chrono::duration< double, std::milli >( std::chrono::high_resolution_clock::now() - tStart ).count();
 
-		renderable->bIsVisible = true;
-		LogInfo( "gltf file %s loaded. Took %lf ms", renderable->sFilename.c_str(), tFileLoad );
+		return m_pAssetLoader->Load( renderable->sFilename, &renderable->gltfModel );
 	}
 
 	void Render::LoadGltfScenes()
 	{
-		// TODO: ensure fixed thread pool for all platforms
-		std::vector< std::future< void > > asyncResults;
-		asyncResults.resize( vecRenderScenes.size() + vecRenderSectors.size() + vecRenderModels.size() );
+		// Renderables sharing a source file only load it once (instance group source)
+		BuildInstanceGroups();
+
+		nAnimationIndex = 0;
+		fAnimationTimer = 0.0f;
+
+		// (1) Queue all loads - parsing runs on the loader's worker threads, uploads are batched on its upload thread
+		std::vector< std::pair< RenderSceneBase *, AssetHandle > > vecLoads;
+		auto tStart = std::chrono::high_resolution_clock::now();
 
-		// Scenes
 		for ( auto &renderable : vecRenderScenes )
 		{
-			asyncResults.push_back( std::async( std::launch::async, &Render::LoadGltfScene, this, renderable ) );
-			//LoadGltfScene( renderable );
+			vecLoads.push_back( { renderable, LoadGltfScene( renderable ) } );
 		}
 
-		// Sectors
 		for ( auto &renderable : vecRenderSectors )
 		{
-			asyncResults.push_back( std::async( std::launch::async, &Render::LoadGltfScene, this, renderable ) );
+			if ( renderable->pInstanceGroup && !renderable->IsInstanceSource() )
+				continue;
+
+			vecLoads.push_back( { renderable, LoadGltfScene( renderable ) } );
 		}
 
-		// Models
 		for ( auto &renderable : vecRenderModels )
 		{
-			asyncResults.push_back( std::async( std::launch::async, &Render::LoadGltfScene, this, renderable ) );
-			//LoadGltfScene( renderable );
+			if ( renderable->pInstanceGroup && !renderable->IsInstanceSource() )
+				continue;
+
+			vecLoads.push_back( { renderable, LoadGltfScene( renderable ) } );
+		}
+
+		// (2) Descriptor setup needs every model, later loads are streamed in (see LoadRenderableAsync)
+		m_pAssetLoader->WaitAll();
+		m_pUploadManager->SubmitGraphicsWork( m_SharedState.vkQueue );
+		auto tLoad = std::chrono::duration< double, std::milli >( std::chrono::high_resolution_clock::now() - tStart ).count();
+
+		for ( auto &load : vecLoads )
+		{
+			load.first->bIsLoaded = load.second->IsReady();
+			LogInfo( "gltf file %s loaded. Took %.2f ms to %s and %.2f ms to upload", load.first->sFilename.c_str(), load.second->fParseMs,
+					 load.second->bFromCache ? "read from the mesh cache" : "parse", load.second->fUploadMs );
+		}
+
+		m_pMemoryAllocator->LogStats();
+
+		// instances share their source's model
+		for ( auto &instanceGroup : m_vecInstanceGroups )
+		{
+			for ( auto &renderable : instanceGroup->vecInstances )
+				renderable->bIsLoaded = instanceGroup->pSource->bIsLoaded;
+		}
+
+		LogInfo( "%i gltf file(s) loaded in %lf ms with %i loader threads", static_cast< uint32_t >( vecLoads.size() ), tLoad, m_pAssetLoader->GetThreadCount() );
+	}
+
+	AssetHandle Render::LoadRenderableAsync( RenderSceneBase *renderable )
+	{
+		assert( renderable );
+
+		if ( renderable->bIsLoaded || renderable->pInstanceGroup )
+			return AssetHandle();
+
+		for ( auto &streaming : m_vecStreamingRenderables )
+		{
+			if ( streaming.first == renderable )
+				return AssetHandle();
 		}
 
-		asyncResults.clear();
+		AssetHandle asset = LoadGltfScene( renderable );
+		m_vecStreamingRenderables.push_back( { renderable, asset } );
+
+		return asset;
+	}
+
+	void Render::FinishStreamedRenderables()
+	{
+		// Descriptors of renderables streamed in before setup are created with all the others
+		if ( m_vecStreamingRenderables.empty() || vkDescriptorPool == VK_NULL_HANDLE )
+			return;
+
+		for ( auto it = m_vecStreamingRenderables.begin(); it != m_vecStreamingRenderables.end(); )
+		{
+			RenderSceneBase *renderable = it->first;
+			AssetHandle &asset = it->second;
+
+			// ... its copies must also be acquired (recorded earlier in this frame's command buffer)
+			if ( !asset->IsDone() || ( asset->IsReady() && asset->unUploadToken > m_pUploadManager->GetRecordedToken() ) )
+			{
+				++it;
+				continue;
+			}
+
+			if ( !asset->IsReady() )
+			{
+				LogInfo( "gltf file %s was not loaded (%s)", renderable->sFilename.c_str(), asset->eState == EAssetState::Cancelled ? "cancelled" : "failed" );
+				it = m_vecStreamingRenderables.erase( it );
+				continue;
+			}
+
+			// (1) Descriptor pool sized for this model only
+			uint32_t imageSamplerCount = 0;
+			uint32_t materialCount = 0;
+			uint32_t meshSetCount = 0;
+			CalculateDescriptorScope( &renderable->gltfModel, &imageSamplerCount, &materialCount, &meshSetCount );
+
+			std::vector< VkDescriptorPoolSize > poolSizes;
+			if ( meshSetCount > 0 )
+				poolSizes.push_back( { VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC, meshSetCount } );
+
+			if ( imageSamplerCount > 0 )
+				poolSizes.push_back( { VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, imageSamplerCount } );
+
+			if ( !poolSizes.empty() )
+			{
+				VkDescriptorPoolCreateInfo descriptorPoolCI {};
+				descriptorPoolCI.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+				descriptorPoolCI.poolSizeCount = static_cast< uint32_t >( poolSizes.size() );
+				descriptorPoolCI.pPoolSizes = poolSizes.data();
+				descriptorPoolCI.maxSets = materialCount + meshSetCount;
+				VK_CHECK_RESULT( vkCreateDescriptorPool( m_SharedState.vkDevice, &descriptorPoolCI, nullptr, &renderable->vkDescriptorPool ) );
+			}
+
+			// (2) Material and mesh descriptor sets
+			if ( m_bBindlessEnabled )
+				RegisterBindlessMaterials( &renderable->gltfModel );
+			else
+				AllocateDescriptorSet( &renderable->gltfModel, renderable->vkDescriptorPool );
+
+			SetupMeshDescriptorSet( renderable, renderable->vkDescriptorPool );
+
+			// (3) Draw list, the renderable is drawn from this frame on
+			BuildDrawList( renderable );
+			renderable->bIsLoaded = true;
+
+			LogInfo( "gltf file %s streamed in. Took %.2f ms to %s and %.2f ms to upload", renderable->sFilename.c_str(), asset->fParseMs,
+					 asset->bFromCache ? "read from the mesh cache" : "parse", asset->fUploadMs );
+			it = m_vecStreamingRenderables.erase( it );
+		}
 	}
 
 	void Render::PrepareAllPipelines()
 	{
 		GenerateBRDFLUT();
-		GenerateCubemaps();
+
+		// cubemaps are generated when the environment is loaded
+		if ( textures.irradianceCube.image == VK_NULL_HANDLE )
+			GenerateCubemaps();
+
 		PrepareUniformBuffers();
 		SetupDescriptors();
+
+		auto tStart = std::chrono::high_resolution_clock::now();
 		PreparePipelines();
+		float fCreationMs = std::chrono::duration< float, std::milli >( std::chrono::high_resolution_clock::now() - tStart ).count();
+
+		// Report the time saved against the last start without a cache, a start without a cache becomes the new reference
+		if ( m_bPipelineCacheLoaded && m_fPipelineColdCreationMs > 0.0f )
+		{
+			LogInfo( "Pipelines created in %.2fms from the pipeline cache (%.2fms saved against %.2fms without a cache).", fCreationMs, m_fPipelineColdCreationMs - fCreationMs, m_fPipelineColdCreationMs );
+		}
+		else if ( m_bPipelineCacheLoaded )
+		{
+			LogInfo( "Pipelines created in %.2fms from the pipeline cache.", fCreationMs );
+		}
+		else
+		{
+			m_fPipelineColdCreationMs = fCreationMs;
+			LogInfo( "Pipelines created in %.2fms without a pipeline cache.", fCreationMs );
+		}
 	}
 
 	void Render::LoadEnvironment( std::string sFilename )
@@ -810,6 +1761,7 @@ namespace xrvk
 			textures.prefilteredCube.destroy();
 		}
 		textures.environmentCube.loadFromFile( sFilename, VK_FORMAT_R16G16B16A16_SFLOAT, m_pVulkanDevice, m_SharedState.vkQueue );
+		m_sEnvironmentFilename = sFilename;
 		GenerateCubemaps();
 	}
 
@@ -821,6 +1773,30 @@ namespace xrvk
 			PREFILTEREDENV = 1
 		};
 
+		// (1) Upload previously generated cubemaps for this environment and filter parameters if cached
+		auto tCacheStart = std::chrono::high_resolution_clock::now();
+		std::vector< IBLCacheImage > vecCacheImages = {
+			{ &textures.irradianceCube, VK_FORMAT_R32G32B32A32_SFLOAT }, { &textures.prefilteredCube, VK_FORMAT_R16G16B16A16_SFLOAT } };
+
+		std::string sCacheFilename;
+		if ( !m_sIBLCacheDirectory.empty() && !m_sEnvironmentFilename.empty() )
+		{
+			uint64_t unCacheKey = HashIBLInputs(
+				{ m_sEnvironmentFilename, "shaders/filtercube.vert.spv", "shaders/irradiancecube.frag.spv", "shaders/prefilterenvmap.frag.spv" },
+				{ k_unIBLCacheFileVersion, VK_FORMAT_R32G32B32A32_SFLOAT, k_unIrradianceDim, VK_FORMAT_R16G16B16A16_SFLOAT, k_unPrefilteredDim, k_unPrefilterSamples } );
+			sCacheFilename = GetIBLCacheFilename( "cubemaps", unCacheKey );
+
+			if ( !m_bForceIBLRegeneration && LoadIBLCache( sCacheFilename, vecCacheImages ) )
+			{
+				shaderValuesPbrParams.prefilteredCubeMipLevels = static_cast< float >( textures.prefilteredCube.mipLevels );
+
+				auto tDiff = std::chrono::duration< double, std::milli >( std::chrono::high_resolution_clock::now() - tCacheStart ).count();
+				LogInfo( "Loading cube maps from cache %s took %lf ms", sCacheFilename.c_str(), tDiff );
+				return;
+			}
+		}
+
+		// (2) Generate cubemaps
 		for ( uint32_t target = 0; target < PREFILTEREDENV + 1; target++ )
 		{
 			vks::TextureCubeMap cubemap;
@@ -833,11 +1809,11 @@ namespace xrvk
 			{
 				case IRRADIANCE:
 					format = VK_FORMAT_R32G32B32A32_SFLOAT;
-					dim = 64;
+					dim = k_unIrradianceDim;
 					break;
 				case PREFILTEREDENV:
 					format = VK_FORMAT_R16G16B16A16_SFLOAT;
-					dim = 512;
+					dim = k_unPrefilteredDim;
 					break;
 			};
 
@@ -857,19 +1833,11 @@ namespace xrvk
 				imageCI.arrayLayers = 6;
 				imageCI.samples = VK_SAMPLE_COUNT_1_BIT;
 				imageCI.tiling = VK_IMAGE_TILING_OPTIMAL;
-				imageCI.usage = VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT;
+				imageCI.usage = VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT;
 				imageCI.flags = VK_IMAGE_CREATE_CUBE_COMPATIBLE_BIT;
 				VK_CHECK_RESULT( vkCreateImage( m_SharedState.vkDevice, &imageCI, nullptr, &cubemap.image ) );
 
-				VkMemoryRequirements memReqs;
-				vkGetImageMemoryRequirements( m_SharedState.vkDevice, cubemap.image, &memReqs );
-
-				VkMemoryAllocateInfo memAllocInfo {};
-				memAllocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
-				memAllocInfo.allocationSize = memReqs.size;
-				memAllocInfo.memoryTypeIndex = m_pVulkanDevice->getMemoryType( memReqs.memoryTypeBits, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT );
-				VK_CHECK_RESULT( vkAllocateMemory( m_SharedState.vkDevice, &memAllocInfo, nullptr, &cubemap.deviceMemory ) );
-				VK_CHECK_RESULT( vkBindImageMemory( m_SharedState.vkDevice, cubemap.image, cubemap.deviceMemory, 0 ) );
+				VK_CHECK_RESULT( m_pVulkanDevice->memoryAllocator->AllocateImage( cubemap.image, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, &cubemap.deviceMemory ) );
 
 				// View
 				VkImageViewCreateInfo viewCI {};
@@ -950,7 +1918,7 @@ namespace xrvk
 			{
 				VkImage image;
 				VkImageView view;
-				VkDeviceMemory memory;
+				MemoryAllocation memory;
 				VkFramebuffer framebuffer;
 			} offscreen;
 
@@ -973,15 +1941,7 @@ namespace xrvk
 				imageCI.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
 				VK_CHECK_RESULT( vkCreateImage( m_SharedState.vkDevice, &imageCI, nullptr, &offscreen.image ) );
 
-				VkMemoryRequirements memReqs;
-				vkGetImageMemoryRequirements( m_SharedState.vkDevice, offscreen.image, &memReqs );
-				VkMemoryAllocateInfo memAllocInfo {};
-				memAllocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
-				memAllocInfo.allocationSize = memReqs.size;
-				memAllocInfo.memoryTypeIndex = m_pVulkanDevice->getMemoryType( memReqs.memoryTypeBits, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT );
-
-				VK_CHECK_RESULT( vkAllocateMemory( m_SharedState.vkDevice, &memAllocInfo, nullptr, &offscreen.memory ) );
-				VK_CHECK_RESULT( vkBindImageMemory( m_SharedState.vkDevice, offscreen.image, offscreen.memory, 0 ) );
+				VK_CHECK_RESULT( m_pVulkanDevice->memoryAllocator->AllocateImage( offscreen.image, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, &offscreen.memory ) );
 
 				// View
 				VkImageViewCreateInfo viewCI {};
@@ -1070,7 +2030,7 @@ namespace xrvk
 			{
 				glm::mat4 mvp;
 				float roughness;
-				uint32_t numSamples = 32u;
+				uint32_t numSamples = k_unPrefilterSamples;
 			} pushBlockPrefilterEnv;
 
 			// Pipeline layout
@@ -1251,15 +2211,13 @@ namespace xrvk
 				imageMemoryBarrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
 				imageMemoryBarrier.subresourceRange = subresourceRange;
 				vkCmdPipelineBarrier( cmdBuf, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, 0, 0, nullptr, 0, nullptr, 1, &imageMemoryBarrier );
-				m_pVulkanDevice->flushCommandBuffer( cmdBuf, m_SharedState.vkQueue, false );
 			}
 
+			// All faces and mips are recorded into the same command buffer and submitted once, the offscreen barriers order the passes
 			for ( uint32_t m = 0; m < numMips; m++ )
 			{
 				for ( uint32_t f = 0; f < 6; f++ )
 				{
-					m_pVulkanDevice->beginCommandBuffer( cmdBuf );
-
 					viewport.width = static_cast< float >( dim * std::pow( 0.5f, m ) );
 					viewport.height = static_cast< float >( dim * std::pow( 0.5f, m ) );
 					vkCmdSetViewport( cmdBuf, 0, 1, &viewport );
@@ -1341,13 +2299,10 @@ namespace xrvk
 						imageMemoryBarrier.subresourceRange = { VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1 };
 						vkCmdPipelineBarrier( cmdBuf, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, 0, 0, nullptr, 0, nullptr, 1, &imageMemoryBarrier );
 					}
-
-					m_pVulkanDevice->flushCommandBuffer( cmdBuf, m_SharedState.vkQueue, false );
 				}
 			}
 
 			{
-				m_pVulkanDevice->beginCommandBuffer( cmdBuf );
 				VkImageMemoryBarrier imageMemoryBarrier {};
 				imageMemoryBarrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
 				imageMemoryBarrier.image = cubemap.image;
@@ -1357,14 +2312,14 @@ namespace xrvk
 				imageMemoryBarrier.dstAccessMask = VK_ACCESS_HOST_WRITE_BIT | VK_ACCESS_TRANSFER_WRITE_BIT;
 				imageMemoryBarrier.subresourceRange = subresourceRange;
 				vkCmdPipelineBarrier( cmdBuf, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, 0, 0, nullptr, 0, nullptr, 1, &imageMemoryBarrier );
-				m_pVulkanDevice->flushCommandBuffer( cmdBuf, m_SharedState.vkQueue, false );
+				m_pVulkanDevice->flushCommandBuffer( cmdBuf, m_SharedState.vkQueue, true );
 			}
 
 			vkDestroyRenderPass( m_SharedState.vkDevice, renderpass, nullptr );
 			vkDestroyFramebuffer( m_SharedState.vkDevice, offscreen.framebuffer, nullptr );
-			vkFreeMemory( m_SharedState.vkDevice, offscreen.memory, nullptr );
 			vkDestroyImageView( m_SharedState.vkDevice, offscreen.view, nullptr );
 			vkDestroyImage( m_SharedState.vkDevice, offscreen.image, nullptr );
+			m_pVulkanDevice->memoryAllocator->Free( offscreen.memory );
 			vkDestroyDescriptorPool( m_SharedState.vkDevice, descriptorpool, nullptr );
 			vkDestroyDescriptorSetLayout( m_SharedState.vkDevice, descriptorsetlayout, nullptr );
 			vkDestroyPipeline( m_SharedState.vkDevice, pipeline, nullptr );
@@ -1374,6 +2329,11 @@ namespace xrvk
 			cubemap.descriptor.sampler = cubemap.sampler;
 			cubemap.descriptor.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
 			cubemap.device = m_pVulkanDevice;
+			cubemap.width = dim;
+			cubemap.height = dim;
+			cubemap.mipLevels = numMips;
+			cubemap.layerCount = 6;
+			cubemap.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
 
 			switch ( target )
 			{
@@ -1388,8 +2348,12 @@ namespace xrvk
 
 			auto tEnd = std::chrono::high_resolution_clock::now();
 			auto tDiff = std::chrono::duration< double, std::milli >( tEnd - tStart ).count();
-			std::cout << "Generating cube map with " << numMips << " mip levels took " << tDiff << " ms" << std::endl;
+			LogInfo( "Generating cube map with %i mip levels took %lf ms", numMips, tDiff );
 		}
+
+		// (3) Store generated cubemaps for later starts
+		if ( !sCacheFilename.empty() )
+			SaveIBLCache( sCacheFilename, vecCacheImages );
 	}
 
 	void Render::GenerateBRDFLUT()
@@ -1397,7 +2361,24 @@ namespace xrvk
 		auto tStart = std::chrono::high_resolution_clock::now();
 
 		const VkFormat format = VK_FORMAT_R16G16_SFLOAT;
-		const int32_t dim = 512;
+		const int32_t dim = k_unBRDFLUTDim;
+
+		// Upload a previously generated lut if cached, the lut only depends on the shaders and its size
+		std::vector< IBLCacheImage > vecCacheImages = { { &textures.lutBrdf, format } };
+
+		std::string sCacheFilename;
+		if ( !m_sIBLCacheDirectory.empty() )
+		{
+			uint64_t unCacheKey = HashIBLInputs( { "shaders/genbrdflut.vert.spv", "shaders/genbrdflut.frag.spv" }, { k_unIBLCacheFileVersion, format, k_unBRDFLUTDim } );
+			sCacheFilename = GetIBLCacheFilename( "brdflut", unCacheKey );
+
+			if ( !m_bForceIBLRegeneration && LoadIBLCache( sCacheFilename, vecCacheImages ) )
+			{
+				auto tDiff = std::chrono::duration< double, std::milli >( std::chrono::high_resolution_clock::now() - tStart ).count();
+				LogInfo( "Loading BRDF LUT from cache %s took %lf ms", sCacheFilename.c_str(), tDiff );
+				return;
+			}
+		}
 
 		// Image
 		VkImageCreateInfo imageCI {};
@@ -1411,17 +2392,10 @@ namespace xrvk
 		imageCI.arrayLayers = 1;
 		imageCI.samples = VK_SAMPLE_COUNT_1_BIT;
 		imageCI.tiling = VK_IMAGE_TILING_OPTIMAL;
-		imageCI.usage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
+		imageCI.usage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT;
 		VK_CHECK_RESULT( vkCreateImage( m_SharedState.vkDevice, &imageCI, nullptr, &textures.lutBrdf.image ) );
 
-		VkMemoryRequirements memReqs;
-		vkGetImageMemoryRequirements( m_SharedState.vkDevice, textures.lutBrdf.image, &memReqs );
-		VkMemoryAllocateInfo memAllocInfo {};
-		memAllocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
-		memAllocInfo.allocationSize = memReqs.size;
-		memAllocInfo.memoryTypeIndex = m_pVulkanDevice->getMemoryType( memReqs.memoryTypeBits, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT );
-		VK_CHECK_RESULT( vkAllocateMemory( m_SharedState.vkDevice, &memAllocInfo, nullptr, &textures.lutBrdf.deviceMemory ) );
-		VK_CHECK_RESULT( vkBindImageMemory( m_SharedState.vkDevice, textures.lutBrdf.image, textures.lutBrdf.deviceMemory, 0 ) );
+		VK_CHECK_RESULT( m_pVulkanDevice->memoryAllocator->AllocateImage( textures.lutBrdf.image, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, &textures.lutBrdf.deviceMemory ) );
 
 		// View
 		VkImageViewCreateInfo viewCI {};
@@ -1640,8 +2614,6 @@ namespace xrvk
 		vkCmdEndRenderPass( cmdBuf );
 		m_pVulkanDevice->flushCommandBuffer( cmdBuf, m_SharedState.vkQueue );
 
-		vkQueueWaitIdle( m_SharedState.vkQueue );
-
 		vkDestroyPipeline( m_SharedState.vkDevice, pipeline, nullptr );
 		vkDestroyPipelineLayout( m_SharedState.vkDevice, pipelinelayout, nullptr );
 		vkDestroyRenderPass( m_SharedState.vkDevice, renderpass, nullptr );
@@ -1652,21 +2624,333 @@ namespace xrvk
 		textures.lutBrdf.descriptor.sampler = textures.lutBrdf.sampler;
 		textures.lutBrdf.descriptor.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
 		textures.lutBrdf.device = m_pVulkanDevice;
+		textures.lutBrdf.width = dim;
+		textures.lutBrdf.height = dim;
+		textures.lutBrdf.mipLevels = 1;
+		textures.lutBrdf.layerCount = 1;
+		textures.lutBrdf.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
 
 		auto tEnd = std::chrono::high_resolution_clock::now();
 		auto tDiff = std::chrono::duration< double, std::milli >( tEnd - tStart ).count();
 		LogInfo( "Generating BRDF LUT took %lf ms", tDiff );
+
+		// Store generated lut for later starts
+		if ( !sCacheFilename.empty() )
+			SaveIBLCache( sCacheFilename, vecCacheImages );
+	}
+
+	uint64_t Render::HashIBLInputs( const std::vector< std::string > &vecFiles, const std::vector< uint32_t > &vecParams )
+	{
+		// FNV-1a over the source files and filter parameters
+		uint64_t unHash = 0xcbf29ce484222325ull;
+		auto HashBytes = [ &unHash ]( const char *pData, size_t unSize )
+		{
+			for ( size_t i = 0; i < unSize; i++ )
+			{
+				unHash ^= static_cast< uint8_t >( pData[ i ] );
+				unHash *= 0x100000001b3ull;
+			}
+		};
+
+		for ( auto &sFile : vecFiles )
+		{
+			std::vector< char > vecData = readFile( sFile );
+			HashBytes( vecData.data(), vecData.size() );
+		}
+
+		HashBytes( reinterpret_cast< const char * >( vecParams.data() ), vecParams.size() * sizeof( uint32_t ) );
+		return unHash;
+	}
+
+	std::string Render::GetIBLCacheFilename( const char *pccName, uint64_t unKey )
+	{
+		char pcFilename[ 64 ];
+		snprintf( pcFilename, sizeof( pcFilename ), "xrvk_ibl_%s_%016llx.bin", pccName, static_cast< unsigned long long >( unKey ) );
+		return ( std::filesystem::path( m_sIBLCacheDirectory ) / pcFilename ).generic_string();
+	}
+
+	uint32_t Render::GetIBLTexelSize( VkFormat vkFormat )
+	{
+		switch ( vkFormat )
+		{
+			case VK_FORMAT_R32G32B32A32_SFLOAT:
+				return 16;
+			case VK_FORMAT_R16G16B16A16_SFLOAT:
+				return 8;
+			case VK_FORMAT_R16G16_SFLOAT:
+				return 4;
+			default:
+				return 0;
+		}
+	}
+
+	VkDeviceSize Render::GetIBLImageSize( VkFormat vkFormat, uint32_t unDim, uint32_t unMips, uint32_t unLayers )
+	{
+		VkDeviceSize unSize = 0;
+		for ( uint32_t m = 0; m < unMips; m++ )
+		{
+			VkDeviceSize unMipDim = std::max( unDim >> m, 1u );
+			unSize += unMipDim * unMipDim * GetIBLTexelSize( vkFormat ) * unLayers;
+		}
+
+		return unSize;
+	}
+
+	bool Render::LoadIBLCache( const std::string &sFilename, std::vector< IBLCacheImage > &vecImages )
+	{
+		// (1) Read the whole file and validate all images before creating any vulkan resources
+		std::ifstream file( sFilename, std::ios::ate | std::ios::binary );
+		if ( !file.is_open() )
+			return false;
+
+		std::vector< char > vecData( static_cast< size_t >( file.tellg() ) );
+		file.seekg( 0 );
+		file.read( vecData.data(), vecData.size() );
+		if ( !file.good() || vecData.size() < sizeof( IBLCacheFileHeader ) )
+		{
+			LogInfo( "IBL cache %s is invalid and will be regenerated.", sFilename.c_str() );
+			return false;
+		}
+		file.close();
+
+		IBLCacheFileHeader fileHeader {};
+		memcpy( &fileHeader, vecData.data(), sizeof( IBLCacheFileHeader ) );
+		if ( fileHeader.unMagic != k_unIBLCacheMagic || fileHeader.unVersion != k_unIBLCacheFileVersion || fileHeader.unImageCount != vecImages.size() )
+		{
+			LogInfo( "IBL cache %s is stale and will be regenerated.", sFilename.c_str() );
+			return false;
+		}
+
+		std::vector< IBLCacheImageHeader > vecImageHeaders( vecImages.size() );
+		std::vector< size_t > vecImageOffsets( vecImages.size() );
+		size_t unOffset = sizeof( IBLCacheFileHeader );
+		for ( size_t i = 0; i < vecImages.size(); i++ )
+		{
+			IBLCacheImageHeader &imageHeader = vecImageHeaders[ i ];
+			if ( unOffset + sizeof( IBLCacheImageHeader ) > vecData.size() )
+				return false;
+
+			memcpy( &imageHeader, vecData.data() + unOffset, sizeof( IBLCacheImageHeader ) );
+			unOffset += sizeof( IBLCacheImageHeader );
+
+			bool bValid = imageHeader.unFormat == static_cast< uint32_t >( vecImages[ i ].vkFormat ) && imageHeader.unDim > 0 && imageHeader.unMips > 0 &&
+						  ( imageHeader.unLayers == 1 || imageHeader.unLayers == 6 ) &&
+						  imageHeader.unDataSize == GetIBLImageSize( vecImages[ i ].vkFormat, imageHeader.unDim, imageHeader.unMips, imageHeader.unLayers ) &&
+						  unOffset + imageHeader.unDataSize <= vecData.size();
+
+			if ( !bValid )
+			{
+				LogInfo( "IBL cache %s is invalid and will be regenerated.", sFilename.c_str() );
+				return false;
+			}
+
+			vecImageOffsets[ i ] = unOffset;
+			unOffset += static_cast< size_t >( imageHeader.unDataSize );
+		}
+
+		// (2) Create and upload each image
+		for ( size_t i = 0; i < vecImages.size(); i++ )
+		{
+			const IBLCacheImageHeader &imageHeader = vecImageHeaders[ i ];
+			vks::Texture *pTexture = vecImages[ i ].pTexture;
+			const VkFormat vkFormat = vecImages[ i ].vkFormat;
+			const bool bCube = imageHeader.unLayers == 6;
+
+			VkImageCreateInfo imageCI {};
+			imageCI.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+			imageCI.imageType = VK_IMAGE_TYPE_2D;
+			imageCI.format = vkFormat;
+			imageCI.extent.width = imageHeader.unDim;
+			imageCI.extent.height = imageHeader.unDim;
+			imageCI.extent.depth = 1;
+			imageCI.mipLevels = imageHeader.unMips;
+			imageCI.arrayLayers = imageHeader.unLayers;
+			imageCI.samples = VK_SAMPLE_COUNT_1_BIT;
+			imageCI.tiling = VK_IMAGE_TILING_OPTIMAL;
+			imageCI.usage = VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT;
+			imageCI.flags = bCube ? VK_IMAGE_CREATE_CUBE_COMPATIBLE_BIT : 0;
+			VK_CHECK_RESULT( vkCreateImage( m_SharedState.vkDevice, &imageCI, nullptr, &pTexture->image ) );
+
+			VK_CHECK_RESULT( m_pVulkanDevice->memoryAllocator->AllocateImage( pTexture->image, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, &pTexture->deviceMemory ) );
+
+			VkImageViewCreateInfo viewCI {};
+			viewCI.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+			viewCI.viewType = bCube ? VK_IMAGE_VIEW_TYPE_CUBE : VK_IMAGE_VIEW_TYPE_2D;
+			viewCI.format = vkFormat;
+			viewCI.subresourceRange = {};
+			viewCI.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+			viewCI.subresourceRange.levelCount = imageHeader.unMips;
+			viewCI.subresourceRange.layerCount = imageHeader.unLayers;
+			viewCI.image = pTexture->image;
+			VK_CHECK_RESULT( vkCreateImageView( m_SharedState.vkDevice, &viewCI, nullptr, &pTexture->view ) );
+
+			// Same sampler as the generated textures
+			VkSamplerCreateInfo samplerCI {};
+			samplerCI.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
+			samplerCI.magFilter = VK_FILTER_LINEAR;
+			samplerCI.minFilter = VK_FILTER_LINEAR;
+			samplerCI.mipmapMode = VK_SAMPLER_MIPMAP_MODE_LINEAR;
+			samplerCI.addressModeU = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+			samplerCI.addressModeV = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+			samplerCI.addressModeW = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+			samplerCI.minLod = 0.0f;
+			samplerCI.maxLod = static_cast< float >( imageHeader.unMips );
+			samplerCI.maxAnisotropy = 1.0f;
+			samplerCI.borderColor = VK_BORDER_COLOR_FLOAT_OPAQUE_WHITE;
+			VK_CHECK_RESULT( vkCreateSampler( m_SharedState.vkDevice, &samplerCI, nullptr, &pTexture->sampler ) );
+
+			// Copy all mips and layers from a staging buffer, data is laid out per mip then per layer
+			Buffer stagingBuffer;
+			stagingBuffer.create(
+				m_pVulkanDevice,
+				VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+				VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+				imageHeader.unDataSize,
+				vecData.data() + vecImageOffsets[ i ] );
+
+			std::vector< VkBufferImageCopy > vecRegions( imageHeader.unMips );
+			VkDeviceSize unRegionOffset = 0;
+			for ( uint32_t m = 0; m < imageHeader.unMips; m++ )
+			{
+				uint32_t unMipDim = std::max( imageHeader.unDim >> m, 1u );
+				vecRegions[ m ] = {};
+				vecRegions[ m ].bufferOffset = unRegionOffset;
+				vecRegions[ m ].imageSubresource = { VK_IMAGE_ASPECT_COLOR_BIT, m, 0, imageHeader.unLayers };
+				vecRegions[ m ].imageExtent = { unMipDim, unMipDim, 1 };
+				unRegionOffset += GetIBLImageSize( vkFormat, unMipDim, 1, imageHeader.unLayers );
+			}
+
+			VkImageSubresourceRange subresourceRange = { VK_IMAGE_ASPECT_COLOR_BIT, 0, imageHeader.unMips, 0, imageHeader.unLayers };
+			VkCommandBuffer cmdBuf = m_pVulkanDevice->createCommandBuffer( VK_COMMAND_BUFFER_LEVEL_PRIMARY, true );
+
+			VkImageMemoryBarrier imageMemoryBarrier {};
+			imageMemoryBarrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+			imageMemoryBarrier.image = pTexture->image;
+			imageMemoryBarrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+			imageMemoryBarrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+			imageMemoryBarrier.srcAccessMask = 0;
+			imageMemoryBarrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+			imageMemoryBarrier.subresourceRange = subresourceRange;
+			vkCmdPipelineBarrier( cmdBuf, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, nullptr, 0, nullptr, 1, &imageMemoryBarrier );
+
+			vkCmdCopyBufferToImage( cmdBuf, stagingBuffer.buffer, pTexture->image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, static_cast< uint32_t >( vecRegions.size() ), vecRegions.data() );
+
+			imageMemoryBarrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+			imageMemoryBarrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+			imageMemoryBarrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+			imageMemoryBarrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+			vkCmdPipelineBarrier( cmdBuf, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, 0, 0, nullptr, 0, nullptr, 1, &imageMemoryBarrier );
+
+			m_pVulkanDevice->flushCommandBuffer( cmdBuf, m_SharedState.vkQueue );
+			stagingBuffer.destroy();
+
+			pTexture->device = m_pVulkanDevice;
+			pTexture->width = imageHeader.unDim;
+			pTexture->height = imageHeader.unDim;
+			pTexture->mipLevels = imageHeader.unMips;
+			pTexture->layerCount = imageHeader.unLayers;
+			pTexture->imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+			pTexture->updateDescriptor();
+		}
+
+		return true;
+	}
+
+	bool Render::SaveIBLCache( const std::string &sFilename, std::vector< IBLCacheImage > &vecImages )
+	{
+		IBLCacheFileHeader fileHeader {};
+		fileHeader.unImageCount = static_cast< uint32_t >( vecImages.size() );
+
+		std::vector< char > vecData( reinterpret_cast< const char * >( &fileHeader ), reinterpret_cast< const char * >( &fileHeader ) + sizeof( IBLCacheFileHeader ) );
+
+		for ( auto &cacheImage : vecImages )
+		{
+			vks::Texture *pTexture = cacheImage.pTexture;
+			if ( GetIBLTexelSize( cacheImage.vkFormat ) == 0 )
+				return false;
+
+			IBLCacheImageHeader imageHeader {};
+			imageHeader.unFormat = static_cast< uint32_t >( cacheImage.vkFormat );
+			imageHeader.unDim = pTexture->width;
+			imageHeader.unMips = pTexture->mipLevels;
+			imageHeader.unLayers = pTexture->layerCount;
+			imageHeader.unDataSize = GetIBLImageSize( cacheImage.vkFormat, pTexture->width, pTexture->mipLevels, pTexture->layerCount );
+
+			// (1) Read back all mips and layers, data is laid out per mip then per layer
+			Buffer stagingBuffer;
+			stagingBuffer.create( m_pVulkanDevice, VK_BUFFER_USAGE_TRANSFER_DST_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, imageHeader.unDataSize );
+
+			std::vector< VkBufferImageCopy > vecRegions( imageHeader.unMips );
+			VkDeviceSize unRegionOffset = 0;
+			for ( uint32_t m = 0; m < imageHeader.unMips; m++ )
+			{
+				uint32_t unMipDim = std::max( imageHeader.unDim >> m, 1u );
+				vecRegions[ m ] = {};
+				vecRegions[ m ].bufferOffset = unRegionOffset;
+				vecRegions[ m ].imageSubresource = { VK_IMAGE_ASPECT_COLOR_BIT, m, 0, imageHeader.unLayers };
+				vecRegions[ m ].imageExtent = { unMipDim, unMipDim, 1 };
+				unRegionOffset += GetIBLImageSize( cacheImage.vkFormat, unMipDim, 1, imageHeader.unLayers );
+			}
+
+			VkImageSubresourceRange subresourceRange = { VK_IMAGE_ASPECT_COLOR_BIT, 0, imageHeader.unMips, 0, imageHeader.unLayers };
+			VkCommandBuffer cmdBuf = m_pVulkanDevice->createCommandBuffer( VK_COMMAND_BUFFER_LEVEL_PRIMARY, true );
+
+			VkImageMemoryBarrier imageMemoryBarrier {};
+			imageMemoryBarrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+			imageMemoryBarrier.image = pTexture->image;
+			imageMemoryBarrier.oldLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+			imageMemoryBarrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+			imageMemoryBarrier.srcAccessMask = VK_ACCESS_MEMORY_WRITE_BIT;
+			imageMemoryBarrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+			imageMemoryBarrier.subresourceRange = subresourceRange;
+			vkCmdPipelineBarrier( cmdBuf, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, nullptr, 0, nullptr, 1, &imageMemoryBarrier );
+
+			vkCmdCopyImageToBuffer( cmdBuf, pTexture->image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, stagingBuffer.buffer, static_cast< uint32_t >( vecRegions.size() ), vecRegions.data() );
+
+			imageMemoryBarrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+			imageMemoryBarrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+			imageMemoryBarrier.srcAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+			imageMemoryBarrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+			vkCmdPipelineBarrier( cmdBuf, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, 0, 0, nullptr, 0, nullptr, 1, &imageMemoryBarrier );
+
+			VkBufferMemoryBarrier bufferMemoryBarrier { VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER };
+			bufferMemoryBarrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+			bufferMemoryBarrier.dstAccessMask = VK_ACCESS_HOST_READ_BIT;
+			bufferMemoryBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+			bufferMemoryBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+			bufferMemoryBarrier.buffer = stagingBuffer.buffer;
+			bufferMemoryBarrier.size = VK_WHOLE_SIZE;
+			vkCmdPipelineBarrier( cmdBuf, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_HOST_BIT, 0, 0, nullptr, 1, &bufferMemoryBarrier, 0, nullptr );
+
+			m_pVulkanDevice->flushCommandBuffer( cmdBuf, m_SharedState.vkQueue );
+
+			// (2) Append image header and data
+			const char *pcHeader = reinterpret_cast< const char * >( &imageHeader );
+			vecData.insert( vecData.end(), pcHeader, pcHeader + sizeof( IBLCacheImageHeader ) );
+
+			const char *pcMapped = static_cast< const char * >( stagingBuffer.mapped );
+			vecData.insert( vecData.end(), pcMapped, pcMapped + imageHeader.unDataSize );
+			stagingBuffer.destroy();
+		}
+
+		// (3) Write cache file
+		if ( !WriteFileAtomically( sFilename, vecData ) )
+			return false;
+
+		LogInfo( "IBL cache saved to %s (%i bytes).", sFilename.c_str(), ( int32_t )vecData.size() );
+		return true;
 	}
 
 	void Render::PrepareUniformBuffers()
 	{
-		// skybox ubo set
-		skyboxUniformBuffer.create( m_pVulkanDevice, VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, sizeof( UBOMatrices ) );
+		// matrices for all views are in the same ubo for multiview
+		VkDeviceSize vkMatricesSize = m_bMultiviewEnabled ? sizeof( UBOMatricesMultiview ) : sizeof( UBOMatrices );
 
-		// renderables ubo sets
+		// ubo sets for each frame slot
 		for ( auto &uniformBuffer : vecUniformBuffers )
 		{
-			uniformBuffer.scene.create( m_pVulkanDevice, VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, sizeof( UBOMatrices ) );
+			uniformBuffer.skybox.create( m_pVulkanDevice, VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, vkMatricesSize );
+			uniformBuffer.scene.create( m_pVulkanDevice, VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, vkMatricesSize );
 			uniformBuffer.params.create(
 				m_pVulkanDevice, VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, sizeof( ShaderValuesParams ) );
 		}
@@ -1707,13 +2991,51 @@ namespace xrvk
 	{
 		uint32_t unSize = static_cast< uint32_t >( vecShapes.size() );
 
-		shape->scale = scale;
-		vecShapes.push_back( shape );
+		shape->scale = scale;
+		vecShapes.push_back( shape );
+
+		return unSize;
+	}
+
+	void Render::UpdateUniformBuffers( UBOMatrices *uboMatrices, Buffer *buffer, RenderSceneBase *renderable, XrMatrix4x4f *matViewProjection, XrPosef *eyePose )
+	{
+		if ( !renderable->bIsVisible )
+			return;
+
+		// Retrieve the model matrix
+		XrMatrix4x4f matModel;
+		renderable->GetMatrix( &matModel );
+
+		// Update ubo
+		uboMatrices->vp = *matViewProjection;
+		uboMatrices->model = matModel;
+		uboMatrices->eyePos = eyePose->position;
+
+		memcpy( buffer->mapped, uboMatrices, sizeof( UBOMatrices ) );
+	}
+
+	void Render::UpdateUniformBuffers( UBOMatrices *uboMatrices, Buffer *buffer, XrMatrix4x4f *matViewProjection, XrPosef *eyePose )
+	{
+		// Scenes
+		for ( auto &renderable : vecRenderScenes )
+		{
+			UpdateUniformBuffers( uboMatrices, buffer, renderable, matViewProjection, eyePose );
+		}
+
+		// Sectors
+		for ( auto &renderable : vecRenderSectors )
+		{
+			UpdateUniformBuffers( uboMatrices, buffer, renderable, matViewProjection, eyePose );
+		}
 
-		return unSize;
+		// Models
+		for ( auto &renderable : vecRenderModels )
+		{
+			UpdateUniformBuffers( uboMatrices, buffer, renderable, matViewProjection, eyePose );
+		}
 	}
 
-	void Render::UpdateUniformBuffers( UBOMatrices *uboMatrices, Buffer *buffer, RenderSceneBase *renderable, XrMatrix4x4f *matViewProjection, XrPosef *eyePose )
+	void Render::UpdateUniformBuffers( UBOMatricesMultiview *uboMatrices, Buffer *buffer, RenderSceneBase *renderable, XrMatrix4x4f *matViewProjections, XrPosef *eyePoses )
 	{
 		if ( !renderable->bIsVisible )
 			return;
@@ -1722,32 +3044,35 @@ namespace xrvk
 		XrMatrix4x4f matModel;
 		renderable->GetMatrix( &matModel );
 
-		// Update ubo
-		uboMatrices->vp = *matViewProjection;
+		// Update ubo with the matrices of each view
+		for ( uint32_t i = 0; i < k_unMultiviewCount; i++ )
+		{
+			uboMatrices->vp[ i ] = matViewProjections[ i ];
+			uboMatrices->eyePos[ i ] = { eyePoses[ i ].position.x, eyePoses[ i ].position.y, eyePoses[ i ].position.z, 1.0f };
+		}
 		uboMatrices->model = matModel;
-		uboMatrices->eyePos = eyePose->position;
 
-		memcpy( buffer->mapped, uboMatrices, sizeof( UBOMatrices ) );
+		memcpy( buffer->mapped, uboMatrices, sizeof( UBOMatricesMultiview ) );
 	}
 
-	void Render::UpdateUniformBuffers( UBOMatrices *uboMatrices, Buffer *buffer, XrMatrix4x4f *matViewProjection, XrPosef *eyePose )
+	void Render::UpdateUniformBuffers( UBOMatricesMultiview *uboMatrices, Buffer *buffer, XrMatrix4x4f *matViewProjections, XrPosef *eyePoses )
 	{
 		// Scenes
 		for ( auto &renderable : vecRenderScenes )
 		{
-			UpdateUniformBuffers( uboMatrices, buffer, renderable, matViewProjection, eyePose );
+			UpdateUniformBuffers( uboMatrices, buffer, renderable, matViewProjections, eyePoses );
 		}
 
 		// Sectors
 		for ( auto &renderable : vecRenderSectors )
 		{
-			UpdateUniformBuffers( uboMatrices, buffer, renderable, matViewProjection, eyePose );
+			UpdateUniformBuffers( uboMatrices, buffer, renderable, matViewProjections, eyePoses );
 		}
 
 		// Models
 		for ( auto &renderable : vecRenderModels )
 		{
-			UpdateUniformBuffers( uboMatrices, buffer, renderable, matViewProjection, eyePose );
+			UpdateUniformBuffers( uboMatrices, buffer, renderable, matViewProjections, eyePoses );
 		}
 	}
 
@@ -1756,6 +3081,12 @@ namespace xrvk
 		assert( pSession );
 		assert( pFrameState );
 
+		// Poses and animations only advance once per frame, not once per view
+		if ( pFrameState->predictedDisplayTime == m_xrPosedDisplayTime )
+			return;
+
+		m_xrPosedDisplayTime = pFrameState->predictedDisplayTime;
+
 		XrSpaceLocation xrSpaceLocation { XR_TYPE_SPACE_LOCATION };
 		pSession->LocateAppSpace( pFrameState->predictedDisplayTime, &xrSpaceLocation );
 
@@ -1891,29 +3222,33 @@ namespace xrvk
 		}
 	}
 
-	void Render::CalculateDescriptorScope( vkglTF::Model *gltfModel, uint32_t *imageSamplerCount, uint32_t *materialCount, uint32_t *meshCount )
+	void Render::CalculateDescriptorScope( vkglTF::Model *gltfModel, uint32_t *imageSamplerCount, uint32_t *materialCount, uint32_t *meshSetCount )
 	{
-		for ( auto &material : gltfModel->materials )
+		// materials live in the bindless descriptor set which has its own pool
+		if ( !m_bBindlessEnabled )
 		{
-			*imageSamplerCount += 5;
-			*materialCount = *materialCount + 1;
+			*imageSamplerCount += 5 * static_cast< uint32_t >( gltfModel->materials.size() );
+			*materialCount += static_cast< uint32_t >( gltfModel->materials.size() );
 		}
-		for ( auto node : skybox->gltfModel.linearNodes )
+
+		// all meshes of a model share one dynamic uniform buffer descriptor
+		for ( auto node : gltfModel->linearNodes )
 		{
 			if ( node->mesh )
 			{
-				*meshCount = *meshCount + 1;
+				*meshSetCount = *meshSetCount + 1;
+				break;
 			}
 		}
 	}
 
-	void Render::AllocateDescriptorSet( vkglTF::Model *gltfModel )
+	void Render::AllocateDescriptorSet( vkglTF::Model *gltfModel, VkDescriptorPool vkPool )
 	{
 		for ( auto &material : gltfModel->materials )
 		{
 			VkDescriptorSetAllocateInfo descriptorSetAllocInfo {};
 			descriptorSetAllocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
-			descriptorSetAllocInfo.descriptorPool = vkDescriptorPool;
+			descriptorSetAllocInfo.descriptorPool = vkPool == VK_NULL_HANDLE ? vkDescriptorPool : vkPool;
 			descriptorSetAllocInfo.pSetLayouts = &descriptorSetLayouts.material;
 			descriptorSetAllocInfo.descriptorSetCount = 1;
 			VK_CHECK_RESULT( vkAllocateDescriptorSets( m_SharedState.vkDevice, &descriptorSetAllocInfo, &material.descriptorSet ) );
@@ -1965,14 +3300,187 @@ namespace xrvk
 		}
 	}
 
+	void Render::SetupBindlessDescriptorSet()
+	{
+		// (1) Layout - material table (ssbo) and a variable sized texture array that can be updated after it's bound
+		std::vector< VkDescriptorSetLayoutBinding > setLayoutBindings = {
+			{ 0, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_FRAGMENT_BIT, nullptr },
+			{ 1, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, m_unBindlessTextureCapacity, VK_SHADER_STAGE_FRAGMENT_BIT, nullptr },
+		};
+
+		std::vector< VkDescriptorBindingFlagsEXT > vecBindingFlags = {
+			0, VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT_EXT | VK_DESCRIPTOR_BINDING_VARIABLE_DESCRIPTOR_COUNT_BIT_EXT | VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT_EXT };
+
+		VkDescriptorSetLayoutBindingFlagsCreateInfoEXT bindingFlagsCI { VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_BINDING_FLAGS_CREATE_INFO_EXT };
+		bindingFlagsCI.bindingCount = static_cast< uint32_t >( vecBindingFlags.size() );
+		bindingFlagsCI.pBindingFlags = vecBindingFlags.data();
+
+		VkDescriptorSetLayoutCreateInfo descriptorSetLayoutCI {};
+		descriptorSetLayoutCI.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+		descriptorSetLayoutCI.pNext = &bindingFlagsCI;
+		descriptorSetLayoutCI.flags = VK_DESCRIPTOR_SET_LAYOUT_CREATE_UPDATE_AFTER_BIND_POOL_BIT_EXT;
+		descriptorSetLayoutCI.pBindings = setLayoutBindings.data();
+		descriptorSetLayoutCI.bindingCount = static_cast< uint32_t >( setLayoutBindings.size() );
+		VK_CHECK_RESULT( vkCreateDescriptorSetLayout( m_SharedState.vkDevice, &descriptorSetLayoutCI, nullptr, &descriptorSetLayouts.material ) );
+
+		// (2) Pool - sized once for the full capacity, so loading more models never needs a bigger pool
+		std::vector< VkDescriptorPoolSize > poolSizes = {
+			{ VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1 }, { VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, m_unBindlessTextureCapacity } };
+		VkDescriptorPoolCreateInfo descriptorPoolCI {};
+		descriptorPoolCI.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+		descriptorPoolCI.flags = VK_DESCRIPTOR_POOL_CREATE_UPDATE_AFTER_BIND_BIT_EXT;
+		descriptorPoolCI.poolSizeCount = static_cast< uint32_t >( poolSizes.size() );
+		descriptorPoolCI.pPoolSizes = poolSizes.data();
+		descriptorPoolCI.maxSets = 1;
+		VK_CHECK_RESULT( vkCreateDescriptorPool( m_SharedState.vkDevice, &descriptorPoolCI, nullptr, &m_vkBindlessDescriptorPool ) );
+
+		// (3) Set
+		VkDescriptorSetVariableDescriptorCountAllocateInfoEXT variableCountAllocInfo { VK_STRUCTURE_TYPE_DESCRIPTOR_SET_VARIABLE_DESCRIPTOR_COUNT_ALLOCATE_INFO_EXT };
+		variableCountAllocInfo.descriptorSetCount = 1;
+		variableCountAllocInfo.pDescriptorCounts = &m_unBindlessTextureCapacity;
+
+		VkDescriptorSetAllocateInfo descriptorSetAllocInfo {};
+		descriptorSetAllocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+		descriptorSetAllocInfo.pNext = &variableCountAllocInfo;
+		descriptorSetAllocInfo.descriptorPool = m_vkBindlessDescriptorPool;
+		descriptorSetAllocInfo.pSetLayouts = &descriptorSetLayouts.material;
+		descriptorSetAllocInfo.descriptorSetCount = 1;
+		VK_CHECK_RESULT( vkAllocateDescriptorSets( m_SharedState.vkDevice, &descriptorSetAllocInfo, &m_vkBindlessDescriptorSet ) );
+
+		// (4) Material table - host visible as it's only written when models are registered
+		m_BindlessMaterialBuffer.create(
+			m_pVulkanDevice,
+			VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+			VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+			sizeof( BindlessMaterial ) * k_unBindlessMaxMaterials );
+
+		// (5) Write material table and the empty texture (slot 0 - used by materials that don't have a map)
+		std::array< VkWriteDescriptorSet, 2 > writeDescriptorSets {};
+
+		writeDescriptorSets[ 0 ].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+		writeDescriptorSets[ 0 ].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+		writeDescriptorSets[ 0 ].descriptorCount = 1;
+		writeDescriptorSets[ 0 ].dstSet = m_vkBindlessDescriptorSet;
+		writeDescriptorSets[ 0 ].dstBinding = 0;
+		writeDescriptorSets[ 0 ].pBufferInfo = &m_BindlessMaterialBuffer.descriptor;
+
+		writeDescriptorSets[ 1 ].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+		writeDescriptorSets[ 1 ].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+		writeDescriptorSets[ 1 ].descriptorCount = 1;
+		writeDescriptorSets[ 1 ].dstSet = m_vkBindlessDescriptorSet;
+		writeDescriptorSets[ 1 ].dstBinding = 1;
+		writeDescriptorSets[ 1 ].dstArrayElement = 0;
+		writeDescriptorSets[ 1 ].pImageInfo = &textures.empty.descriptor;
+
+		vkUpdateDescriptorSets( m_SharedState.vkDevice, static_cast< uint32_t >( writeDescriptorSets.size() ), writeDescriptorSets.data(), 0, nullptr );
+
+		m_unBindlessTextureCount = 1;
+		m_unBindlessMaterialCount = 0;
+		m_mapBindlessTextures.clear();
+		m_mapBindlessMaterials.clear();
+
+		LogInfo( "Bindless material table created with capacity for %i textures and %i materials.", m_unBindlessTextureCapacity, k_unBindlessMaxMaterials );
+	}
+
+	uint32_t Render::RegisterBindlessTexture( vkglTF::Texture *pTexture )
+	{
+		if ( pTexture == nullptr )
+			return 0;
+
+		// (1) Textures shared between materials only take up one slot
+		auto it = m_mapBindlessTextures.find( pTexture );
+		if ( it != m_mapBindlessTextures.end() )
+			return it->second;
+
+		if ( m_unBindlessTextureCount >= m_unBindlessTextureCapacity )
+		{
+			LogError( "Bindless texture array is full (%i textures), using the empty texture instead.", m_unBindlessTextureCapacity );
+			return 0;
+		}
+
+		// (2) Write to the next free slot - the array is update after bind so this is valid even if the set is in use
+		const uint32_t unSlot = m_unBindlessTextureCount++;
+
+		VkWriteDescriptorSet writeDescriptorSet {};
+		writeDescriptorSet.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+		writeDescriptorSet.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+		writeDescriptorSet.descriptorCount = 1;
+		writeDescriptorSet.dstSet = m_vkBindlessDescriptorSet;
+		writeDescriptorSet.dstBinding = 1;
+		writeDescriptorSet.dstArrayElement = unSlot;
+		writeDescriptorSet.pImageInfo = &pTexture->descriptor;
+
+		vkUpdateDescriptorSets( m_SharedState.vkDevice, 1, &writeDescriptorSet, 0, nullptr );
+
+		m_mapBindlessTextures[ pTexture ] = unSlot;
+		return unSlot;
+	}
+
+	void Render::RegisterBindlessMaterials( vkglTF::Model *gltfModel )
+	{
+		BindlessMaterial *pMaterialTable = static_cast< BindlessMaterial * >( m_BindlessMaterialBuffer.mapped );
+
+		for ( auto &material : gltfModel->materials )
+		{
+			if ( m_mapBindlessMaterials.find( &material ) != m_mapBindlessMaterials.end() )
+				continue;
+
+			if ( m_unBindlessMaterialCount >= k_unBindlessMaxMaterials )
+			{
+				LogError( "Bindless material table is full (%i materials), remaining materials will use the first material.", k_unBindlessMaxMaterials );
+				m_mapBindlessMaterials[ &material ] = UINT32_MAX;
+				continue;
+			}
+
+			// (1) Texture maps, same assignment as the per material descriptor sets
+			BindlessMaterial bindlessMaterial {};
+			bindlessMaterial.normalMap = RegisterBindlessTexture( material.normalTexture );
+			bindlessMaterial.aoMap = RegisterBindlessTexture( material.occlusionTexture );
+			bindlessMaterial.emissiveMap = RegisterBindlessTexture( material.emissiveTexture );
+
+			// TODO: glTF specs states that metallic roughness should be preferred, even if specular glossiness is present
+			if ( material.pbrWorkflows.metallicRoughness )
+			{
+				bindlessMaterial.colorMap = RegisterBindlessTexture( material.baseColorTexture );
+				bindlessMaterial.physicalDescriptorMap = RegisterBindlessTexture( material.metallicRoughnessTexture );
+			}
+
+			if ( material.pbrWorkflows.specularGlossiness )
+			{
+				if ( material.extension.diffuseTexture )
+					bindlessMaterial.colorMap = RegisterBindlessTexture( material.extension.diffuseTexture );
+
+				if ( material.extension.specularGlossinessTexture )
+					bindlessMaterial.physicalDescriptorMap = RegisterBindlessTexture( material.extension.specularGlossinessTexture );
+			}
+
+			// (2) Material parameters are filled in with the draw list (same values as the push constants in the non-bindless path)
+			const uint32_t unIndex = m_unBindlessMaterialCount++;
+			pMaterialTable[ unIndex ] = bindlessMaterial;
+			m_mapBindlessMaterials[ &material ] = unIndex;
+		}
+	}
+
 	void Render::SetupDescriptors()
 	{
+		// Renderables streamed in before setup are set up with everything else
+		if ( m_pAssetLoader != nullptr && !m_vecStreamingRenderables.empty() )
+		{
+			m_pAssetLoader->WaitAll();
+			m_pUploadManager->SubmitGraphicsWork( m_SharedState.vkQueue );
+
+			for ( auto &streaming : m_vecStreamingRenderables )
+				streaming.first->bIsLoaded = streaming.second->IsReady();
+
+			m_vecStreamingRenderables.clear();
+		}
+
 		/*
 			Descriptor Pool
 		*/
 		uint32_t imageSamplerCount = 0;
 		uint32_t materialCount = 0;
-		uint32_t meshCount = 0;
+		uint32_t meshSetCount = 0;
 
 		// Environment samplers (radiance, irradiance, brdf lut)
 		imageSamplerCount += 3;
@@ -1980,28 +3488,43 @@ namespace xrvk
 		// Scenes
 		for ( auto &renderable : vecRenderScenes )
 		{
-			CalculateDescriptorScope( &renderable->gltfModel, &imageSamplerCount, &materialCount, &meshCount );
+			CalculateDescriptorScope( &renderable->gltfModel, &imageSamplerCount, &materialCount, &meshSetCount );
 		}
 
 		// Sectors
 		for ( auto &renderable : vecRenderSectors )
 		{
-			CalculateDescriptorScope( &renderable->gltfModel, &imageSamplerCount, &materialCount, &meshCount );
+			CalculateDescriptorScope( &renderable->gltfModel, &imageSamplerCount, &materialCount, &meshSetCount );
 		}
 
 		// Models
 		for ( auto &renderable : vecRenderModels )
 		{
-			CalculateDescriptorScope( &renderable->gltfModel, &imageSamplerCount, &materialCount, &meshCount );
+			CalculateDescriptorScope( &renderable->gltfModel, &imageSamplerCount, &materialCount, &meshSetCount );
 		}
 
+		// Instance groups (instance matrices for the vertex shader and the culling prepass, two sets per frame slot)
+		const uint32_t instanceGroupCount = static_cast< uint32_t >( m_vecInstanceGroups.size() );
+
+		const uint32_t unFrameSlots = static_cast< uint32_t >( vecDescriptorSets.size() );
 		std::vector< VkDescriptorPoolSize > poolSizes = {
-			{ VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, ( 4 + meshCount ) * k_unCommandBufferNum }, { VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, imageSamplerCount * k_unCommandBufferNum } };
+			{ VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 4 * unFrameSlots }, { VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, imageSamplerCount * unFrameSlots } };
+
+		// Mesh uniforms, one set per model covers all frame slots
+		if ( meshSetCount > 0 )
+			poolSizes.push_back( { VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC, meshSetCount } );
+
+		if ( instanceGroupCount > 0 )
+		{
+			poolSizes.push_back( { VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 4 * instanceGroupCount * unFrameSlots } );
+			poolSizes.push_back( { VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, instanceGroupCount * unFrameSlots } );
+		}
+
 		VkDescriptorPoolCreateInfo descriptorPoolCI {};
 		descriptorPoolCI.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
-		descriptorPoolCI.poolSizeCount = 2;
+		descriptorPoolCI.poolSizeCount = static_cast< uint32_t >( poolSizes.size() );
 		descriptorPoolCI.pPoolSizes = poolSizes.data();
-		descriptorPoolCI.maxSets = ( 2 + materialCount + meshCount ) * k_unCommandBufferNum;
+		descriptorPoolCI.maxSets = ( 2 + materialCount + 2 * instanceGroupCount ) * unFrameSlots + meshSetCount;
 		VK_CHECK_RESULT( vkCreateDescriptorPool( m_SharedState.vkDevice, &descriptorPoolCI, nullptr, &vkDescriptorPool ) );
 
 		/*
@@ -2074,6 +3597,27 @@ namespace xrvk
 			}
 		}
 
+		// Material (bindless - single material table and texture array for all models)
+		if ( m_bBindlessEnabled )
+		{
+			SetupBindlessDescriptorSet();
+
+			for ( auto &renderable : vecRenderScenes )
+			{
+				RegisterBindlessMaterials( &renderable->gltfModel );
+			}
+
+			for ( auto &renderable : vecRenderSectors )
+			{
+				RegisterBindlessMaterials( &renderable->gltfModel );
+			}
+
+			for ( auto &renderable : vecRenderModels )
+			{
+				RegisterBindlessMaterials( &renderable->gltfModel );
+			}
+		}
+
 		// Material (samplers)
 		{
 			std::vector< VkDescriptorSetLayoutBinding > setLayoutBindings = {
@@ -2087,30 +3631,34 @@ namespace xrvk
 			descriptorSetLayoutCI.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
 			descriptorSetLayoutCI.pBindings = setLayoutBindings.data();
 			descriptorSetLayoutCI.bindingCount = static_cast< uint32_t >( setLayoutBindings.size() );
-			VK_CHECK_RESULT( vkCreateDescriptorSetLayout( m_SharedState.vkDevice, &descriptorSetLayoutCI, nullptr, &descriptorSetLayouts.material ) );
 
-			// Scenes: Per-Material descriptor sets
-			for ( auto &renderable : vecRenderScenes )
+			if ( !m_bBindlessEnabled )
 			{
-				AllocateDescriptorSet( &renderable->gltfModel );
-			}
+				VK_CHECK_RESULT( vkCreateDescriptorSetLayout( m_SharedState.vkDevice, &descriptorSetLayoutCI, nullptr, &descriptorSetLayouts.material ) );
 
-			// Sectors: Per-Material descriptor sets
-			for ( auto &renderable : vecRenderSectors )
-			{
-				AllocateDescriptorSet( &renderable->gltfModel );
-			}
+				// Scenes: Per-Material descriptor sets
+				for ( auto &renderable : vecRenderScenes )
+				{
+					AllocateDescriptorSet( &renderable->gltfModel );
+				}
 
-			// Models: Per-Material descriptor sets
-			for ( auto &renderable : vecRenderModels )
-			{
-				AllocateDescriptorSet( &renderable->gltfModel );
+				// Sectors: Per-Material descriptor sets
+				for ( auto &renderable : vecRenderSectors )
+				{
+					AllocateDescriptorSet( &renderable->gltfModel );
+				}
+
+				// Models: Per-Material descriptor sets
+				for ( auto &renderable : vecRenderModels )
+				{
+					AllocateDescriptorSet( &renderable->gltfModel );
+				}
 			}
 
-			// Model node (matrices)
+			// Model node (matrices and joints of all meshes, addressed with a dynamic offset per draw)
 			{
 				std::vector< VkDescriptorSetLayoutBinding > setLayoutBindings = {
-					{ 0, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 1, VK_SHADER_STAGE_VERTEX_BIT, nullptr },
+					{ 0, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC, 1, VK_SHADER_STAGE_VERTEX_BIT, nullptr },
 				};
 				VkDescriptorSetLayoutCreateInfo descriptorSetLayoutCI {};
 				descriptorSetLayoutCI.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
@@ -2118,35 +3666,45 @@ namespace xrvk
 				descriptorSetLayoutCI.bindingCount = static_cast< uint32_t >( setLayoutBindings.size() );
 				VK_CHECK_RESULT( vkCreateDescriptorSetLayout( m_SharedState.vkDevice, &descriptorSetLayoutCI, nullptr, &descriptorSetLayouts.node ) );
 
-				// Scenes: Per-Node descriptor set
+				// Scenes: Per-Model mesh descriptor set
 				for ( auto &renderable : vecRenderScenes )
 				{
-					for ( auto &node : renderable->gltfModel.nodes )
-					{
-						SetupNodeDescriptorSet( node );
-					}
+					SetupMeshDescriptorSet( renderable );
 				}
 
-				// Sectors: Per-Node descriptor set
+				// Sectors: Per-Model mesh descriptor set
 				for ( auto &renderable : vecRenderSectors )
 				{
-					for ( auto &node : renderable->gltfModel.nodes )
-					{
-						SetupNodeDescriptorSet( node );
-					}
+					SetupMeshDescriptorSet( renderable );
 				}
 
-				// Models: Per-Node descriptor set
+				// Models: Per-Model mesh descriptor set
 				for ( auto &renderable : vecRenderModels )
 				{
-					for ( auto &node : renderable->gltfModel.nodes )
-					{
-						SetupNodeDescriptorSet( node );
-					}
+					SetupMeshDescriptorSet( renderable );
 				}
 			}
 		}
 
+		// Flattened draw lists (requires material and node descriptor sets)
+		for ( auto &renderable : vecRenderScenes )
+		{
+			BuildDrawList( renderable );
+		}
+
+		for ( auto &renderable : vecRenderSectors )
+		{
+			BuildDrawList( renderable );
+		}
+
+		for ( auto &renderable : vecRenderModels )
+		{
+			BuildDrawList( renderable );
+		}
+
+		// Instance groups (requires draw lists)
+		SetupInstanceGroups();
+
 		// Skybox (fixed set)
 		for ( auto i = 0; i < vecUniformBuffers.size(); i++ )
 		{
@@ -2164,7 +3722,7 @@ namespace xrvk
 			writeDescriptorSets[ 0 ].descriptorCount = 1;
 			writeDescriptorSets[ 0 ].dstSet = vecDescriptorSets[ i ].skybox;
 			writeDescriptorSets[ 0 ].dstBinding = 0;
-			writeDescriptorSets[ 0 ].pBufferInfo = &skyboxUniformBuffer.descriptor;
+			writeDescriptorSets[ 0 ].pBufferInfo = &vecUniformBuffers[ i ].skybox.descriptor;
 
 			writeDescriptorSets[ 1 ].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
 			writeDescriptorSets[ 1 ].descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
@@ -2184,45 +3742,212 @@ namespace xrvk
 		}
 	}
 
-	void Render::SetupNodeDescriptorSet( vkglTF::Node *node )
+	void Render::SetupMeshDescriptorSet( RenderSceneBase *renderable, VkDescriptorPool vkPool )
+	{
+		vkglTF::Model *gltfModel = &renderable->gltfModel;
+
+		// (1) One uniform buffer for all meshes of the model, with a region per frame slot
+		if ( gltfModel->meshUniforms.buffer == VK_NULL_HANDLE )
+			gltfModel->createMeshUniforms( GetFrameSlotCount() );
+
+		if ( gltfModel->meshUniforms.buffer == VK_NULL_HANDLE )
+			return;
+
+		// (2) Single descriptor set, draws select their mesh and frame with a dynamic offset
+		VkDescriptorSetAllocateInfo descriptorSetAllocInfo {};
+		descriptorSetAllocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+		descriptorSetAllocInfo.descriptorPool = vkPool == VK_NULL_HANDLE ? vkDescriptorPool : vkPool;
+		descriptorSetAllocInfo.pSetLayouts = &descriptorSetLayouts.node;
+		descriptorSetAllocInfo.descriptorSetCount = 1;
+		VK_CHECK_RESULT( vkAllocateDescriptorSets( m_SharedState.vkDevice, &descriptorSetAllocInfo, &gltfModel->meshUniforms.descriptorSet ) );
+
+		VkWriteDescriptorSet writeDescriptorSet {};
+		writeDescriptorSet.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+		writeDescriptorSet.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
+		writeDescriptorSet.descriptorCount = 1;
+		writeDescriptorSet.dstSet = gltfModel->meshUniforms.descriptorSet;
+		writeDescriptorSet.dstBinding = 0;
+		writeDescriptorSet.pBufferInfo = &gltfModel->meshUniforms.descriptor;
+
+		vkUpdateDescriptorSets( m_SharedState.vkDevice, 1, &writeDescriptorSet, 0, nullptr );
+
+		LogVerbose(
+			"Mesh uniforms for %s: %i meshes in 1 buffer (%llu bytes for %i frames) and 1 descriptor set, previously %i buffers and %i descriptor sets.",
+			renderable->sFilename.c_str(),
+			gltfModel->meshUniforms.meshCount,
+			( unsigned long long )( gltfModel->meshUniforms.frameSize * gltfModel->meshUniforms.frameCount ),
+			gltfModel->meshUniforms.frameCount,
+			gltfModel->meshUniforms.meshCount,
+			gltfModel->meshUniforms.meshCount );
+	}
+
+	void Render::PrepareShapesPipeline( Shapes::Shape *shape, std::string sVertexShader, std::string sFragmentShader, VkPolygonMode vkPolygonMode )
+	{
+		assert( shape );
+
+		// (1) Create and allocate memory buffers
+		uint32_t unCountIndices = static_cast< uint32_t >( shape->vecIndices->size() );
+		uint32_t unCountVertices = static_cast< uint32_t >( shape->vecVertices->size() );
+
+		shape->indexBuffer.create(
+			m_pVulkanDevice,
+			VK_BUFFER_USAGE_INDEX_BUFFER_BIT,
+			VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+			sizeof( uint16_t ) * unCountIndices,
+			shape->vecIndices->data() );
+
+		shape->indexBuffer.count = unCountIndices;
+
+		shape->vertexBuffer.create(
+			m_pVulkanDevice,
+			VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
+			VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+			sizeof( Shapes::Vertex ) * unCountVertices,
+			shape->vecVertices->data() );
+
+		shape->vertexBuffer.count = unCountVertices;
+
+		// (2) Create the graphics pipeline
+		shape->pipeline = CreateShapesPipeline( sVertexShader, sFragmentShader, vkPolygonMode, false );
+	}
+
+	uint32_t Render::AddShapeBatch(
+		std::vector< unsigned short > *vecIndices,
+		std::vector< Shapes::Vertex > *vecVertices,
+		uint32_t unCapacity,
+		std::string sVertexShader,
+		std::string sFragmentShader,
+		VkPolygonMode vkPolygonMode )
 	{
-		if ( node->mesh )
+		assert( vecIndices );
+		assert( vecVertices );
+		assert( GetFrameSlotCount() > 0 );
+
+		Shapes::ShapeBatch *pShapeBatch = new Shapes::ShapeBatch;
+
+		// (1) Create and allocate memory buffers for the shared mesh
+		pShapeBatch->indexBuffer.create(
+			m_pVulkanDevice,
+			VK_BUFFER_USAGE_INDEX_BUFFER_BIT,
+			VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+			sizeof( uint16_t ) * vecIndices->size(),
+			vecIndices->data() );
+
+		pShapeBatch->indexBuffer.count = static_cast< int32_t >( vecIndices->size() );
+
+		pShapeBatch->vertexBuffer.create(
+			m_pVulkanDevice,
+			VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
+			VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+			sizeof( Shapes::Vertex ) * vecVertices->size(),
+			vecVertices->data() );
+
+		pShapeBatch->vertexBuffer.count = static_cast< int32_t >( vecVertices->size() );
+
+		// (2) Instanced draws need the instanced vertex shader (and its multiview variant when multiview is on), otherwise fall back to the per shape one
+		pShapeBatch->bInstanced = IsShaderAvailable( sVertexShader ) && ( !m_bMultiviewEnabled || GetShaderVariant( sVertexShader ) != sVertexShader );
+		if ( !pShapeBatch->bInstanced )
 		{
-			VkDescriptorSetAllocateInfo descriptorSetAllocInfo {};
-			descriptorSetAllocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
-			descriptorSetAllocInfo.descriptorPool = vkDescriptorPool;
-			descriptorSetAllocInfo.pSetLayouts = &descriptorSetLayouts.node;
-			descriptorSetAllocInfo.descriptorSetCount = 1;
-			VK_CHECK_RESULT( vkAllocateDescriptorSets( m_SharedState.vkDevice, &descriptorSetAllocInfo, &node->mesh->uniformBuffer.descriptorSet ) );
+			LogWarning( "Instanced shape shader %s not found. Shape batch will draw each of its instances separately.", sVertexShader.c_str() );
+			sVertexShader = "shaders/shape.vert.spv";
+		}
 
-			VkWriteDescriptorSet writeDescriptorSet {};
-			writeDescriptorSet.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-			writeDescriptorSet.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-			writeDescriptorSet.descriptorCount = 1;
-			writeDescriptorSet.dstSet = node->mesh->uniformBuffer.descriptorSet;
-			writeDescriptorSet.dstBinding = 0;
-			writeDescriptorSet.pBufferInfo = &node->mesh->uniformBuffer.descriptor;
+		// (3) Fixed capacity instance storage - the cpu copy and, for instanced draws, a persistently mapped ring with a region per frame slot
+		pShapeBatch->unCapacity = unCapacity;
+		pShapeBatch->pInstances.reset( new Shapes::ShapeInstance[ unCapacity ] );
 
-			vkUpdateDescriptorSets( m_SharedState.vkDevice, 1, &writeDescriptorSet, 0, nullptr );
+		if ( pShapeBatch->bInstanced )
+		{
+			pShapeBatch->unRegions = GetFrameSlotCount();
+			pShapeBatch->instanceBuffer.create(
+				m_pVulkanDevice,
+				VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
+				VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+				sizeof( Shapes::ShapeInstance ) * unCapacity * pShapeBatch->unRegions );
+
+			pShapeBatch->vecRegionChanges.assign( pShapeBatch->unRegions, { unCapacity, 0 } );
 		}
 
-		for ( auto &child : node->children )
+		// (4) Create the graphics pipeline (instance rate vertex attributes if instanced)
+		pShapeBatch->pipeline = CreateShapesPipeline( sVertexShader, sFragmentShader, vkPolygonMode, pShapeBatch->bInstanced );
+
+		uint32_t unSize = static_cast< uint32_t >( vecShapeBatches.size() );
+		vecShapeBatches.push_back( pShapeBatch );
+
+		return unSize;
+	}
+
+	void Render::UploadShapeBatch( Shapes::ShapeBatch *pShapeBatch )
+	{
+		// Added instances are already in every region, only what Set() changed since this frame slot was last drawn is copied
+		std::pair< uint32_t, uint32_t > &changes = pShapeBatch->vecRegionChanges[ m_unCurrentFrame ];
+		if ( changes.first < changes.second )
 		{
-			SetupNodeDescriptorSet( child );
+			Shapes::ShapeInstance *pRegion = static_cast< Shapes::ShapeInstance * >( pShapeBatch->instanceBuffer.mapped ) + ( pShapeBatch->unCapacity * m_unCurrentFrame );
+			memcpy( pRegion + changes.first, pShapeBatch->pInstances.get() + changes.first, sizeof( Shapes::ShapeInstance ) * ( changes.second - changes.first ) );
 		}
+
+		changes = { pShapeBatch->unCapacity, 0 };
 	}
 
-	void Render::PrepareShapesPipeline( Shapes::Shape *shape, std::string sVertexShader, std::string sFragmentShader, VkPolygonMode vkPolygonMode )
+	void Render::DrawShapeBatches( VkCommandBuffer vkCommandBuffer, XrMatrix4x4f *pViewProjections, uint32_t unViewCount )
 	{
-		assert( shape );
+		for ( auto &pShapeBatch : vecShapeBatches )
+		{
+			// Instances published after this are drawn from the next frame on
+			const uint32_t unCount = pShapeBatch->Count();
+			if ( !pShapeBatch->bIsVisible || unCount == 0 )
+				continue;
+
+			vkCmdBindPipeline( vkCommandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pShapeBatch->pipeline );
+			vkCmdBindIndexBuffer( vkCommandBuffer, pShapeBatch->indexBuffer.buffer, 0, VK_INDEX_TYPE_UINT16 );
+
+			// (1) Fallback - one draw per instance with its mvp(s) pushed, same as a shape
+			if ( !pShapeBatch->bInstanced )
+			{
+				const VkDeviceSize offset = 0;
+				vkCmdBindVertexBuffers( vkCommandBuffer, 0, 1, &pShapeBatch->vertexBuffer.buffer, &offset );
+
+				for ( uint32_t i = 0; i < unCount; i++ )
+				{
+					const Shapes::ShapeInstance &instance = pShapeBatch->pInstances[ i ];
+
+					XrMatrix4x4f model;
+					XrMatrix4x4f_CreateTranslationRotationScale( &model, &instance.position, &instance.orientation, &instance.scale );
+
+					XrMatrix4x4f mvps[ k_unMultiviewCount ];
+					for ( uint32_t v = 0; v < unViewCount; v++ )
+						XrMatrix4x4f_Multiply( &mvps[ v ], &pViewProjections[ v ], &model );
 
+					vkCmdPushConstants( vkCommandBuffer, vkPipelineLayoutShapes, VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof( XrMatrix4x4f ) * unViewCount, &mvps[ 0 ].m[ 0 ] );
+					vkCmdDrawIndexed( vkCommandBuffer, pShapeBatch->indexBuffer.count, 1, 0, 0, 0 );
+				}
+
+				continue;
+			}
+
+			// (2) Instanced - mesh vertices (binding 0) and this frame slot's region of the instance ring (binding 1)
+			UploadShapeBatch( pShapeBatch );
+
+			const VkBuffer vkBuffers[ 2 ] = { pShapeBatch->vertexBuffer.buffer, pShapeBatch->instanceBuffer.buffer };
+			const VkDeviceSize offsets[ 2 ] = { 0, sizeof( Shapes::ShapeInstance ) * pShapeBatch->unCapacity * m_unCurrentFrame };
+			vkCmdBindVertexBuffers( vkCommandBuffer, 0, 2, vkBuffers, offsets );
+
+			// Instance transforms are applied in the vertex shader, so only the view projection(s) are pushed
+			vkCmdPushConstants( vkCommandBuffer, vkPipelineLayoutShapes, VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof( XrMatrix4x4f ) * unViewCount, pViewProjections );
+			vkCmdDrawIndexed( vkCommandBuffer, pShapeBatch->indexBuffer.count, unCount, 0, 0, 0 );
+		}
+	}
+
+	VkPipeline Render::CreateShapesPipeline( std::string sVertexShader, std::string sFragmentShader, VkPolygonMode vkPolygonMode, bool bInstanced )
+	{
 		// (1) Create pipeline layout if it doesn't exist
 		if ( vkPipelineLayoutShapes == VK_NULL_HANDLE )
 		{
 			VkPushConstantRange vkPCR = {};
 			vkPCR.stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
 			vkPCR.offset = 0;
-			vkPCR.size = 4 * 4 * sizeof( float );
+			vkPCR.size = 4 * 4 * sizeof( float ) * ( m_bMultiviewEnabled ? k_unMultiviewCount : 1 );
 
 			VkPipelineLayoutCreateInfo pipelineLayoutCreateInfo { VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO };
 			pipelineLayoutCreateInfo.pushConstantRangeCount = 1;
@@ -2231,45 +3956,32 @@ namespace xrvk
 		}
 
 		// (2) Define programmable stages
-		auto vertShader = CreateShaderModule( sVertexShader );
-		auto fragShader = CreateShaderModule( sFragmentShader );
+		auto vertShader = CreateShaderModule( GetShaderVariant( sVertexShader ) );
+		auto fragShader = CreateShaderModule( GetShaderVariant( sFragmentShader ) );
 
 		std::string sFunctionEntrypoint = "main";
 		auto vertShaderStage = CreateShaderStage( VK_SHADER_STAGE_VERTEX_BIT, &vertShader, sFunctionEntrypoint );
 		auto fragShaderStage = CreateShaderStage( VK_SHADER_STAGE_FRAGMENT_BIT, &fragShader, sFunctionEntrypoint );
 
-		std::vector< VkPipelineShaderStageCreateInfo > shaderStages = { vertShaderStage, fragShaderStage };
-
-		// (3) Create and allocate memory buffers
-		uint32_t unCountIndices = static_cast< uint32_t >( shape->vecIndices->size() );
-		uint32_t unCountVertices = static_cast< uint32_t >( shape->vecVertices->size() );
-
-		shape->indexBuffer.create(
-			m_pVulkanDevice,
-			VK_BUFFER_USAGE_INDEX_BUFFER_BIT,
-			VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
-			sizeof( uint16_t ) * unCountIndices,
-			shape->vecIndices->data() );
-
-		shape->indexBuffer.count = unCountIndices;
-
-		shape->vertexBuffer.create(
-			m_pVulkanDevice,
-			VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
-			VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
-			sizeof( Shapes::Vertex ) * unCountVertices,
-			shape->vecVertices->data() );
-
-		shape->vertexBuffer.count = unCountVertices;
+		std::vector< VkPipelineShaderStageCreateInfo > shaderStages = { vertShaderStage, fragShaderStage };
 
-		// (4) Define fixed Function stages
-		VkVertexInputBindingDescription vertexInputBinding = { 0, sizeof( Shapes::Vertex ), VK_VERTEX_INPUT_RATE_VERTEX };
+		// (3) Define fixed Function stages
+		std::vector< VkVertexInputBindingDescription > vertexInputBindings = { { 0, sizeof( Shapes::Vertex ), VK_VERTEX_INPUT_RATE_VERTEX } };
 		std::vector< VkVertexInputAttributeDescription > vertexInputAttributes = {
 			{ 0, 0, VK_FORMAT_R32G32B32_SFLOAT, offsetof( Shapes::Vertex, Position ) }, { 1, 0, VK_FORMAT_R32G32B32_SFLOAT, offsetof( Shapes::Vertex, Color ) } };
 
+		if ( bInstanced )
+		{
+			vertexInputBindings.push_back( { 1, sizeof( Shapes::ShapeInstance ), VK_VERTEX_INPUT_RATE_INSTANCE } );
+			vertexInputAttributes.push_back( { 2, 1, VK_FORMAT_R32G32B32A32_SFLOAT, offsetof( Shapes::ShapeInstance, orientation ) } );
+			vertexInputAttributes.push_back( { 3, 1, VK_FORMAT_R32G32B32_SFLOAT, offsetof( Shapes::ShapeInstance, position ) } );
+			vertexInputAttributes.push_back( { 4, 1, VK_FORMAT_R32G32B32_SFLOAT, offsetof( Shapes::ShapeInstance, scale ) } );
+			vertexInputAttributes.push_back( { 5, 1, VK_FORMAT_R32G32B32_SFLOAT, offsetof( Shapes::ShapeInstance, color ) } );
+		}
+
 		VkPipelineVertexInputStateCreateInfo vertexInputInfo { VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO };
-		vertexInputInfo.vertexBindingDescriptionCount = 1;
-		vertexInputInfo.pVertexBindingDescriptions = &vertexInputBinding;
+		vertexInputInfo.vertexBindingDescriptionCount = static_cast< uint32_t >( vertexInputBindings.size() );
+		vertexInputInfo.pVertexBindingDescriptions = vertexInputBindings.data();
 		vertexInputInfo.vertexAttributeDescriptionCount = static_cast< uint32_t >( vertexInputAttributes.size() );
 		vertexInputInfo.pVertexAttributeDescriptions = vertexInputAttributes.data();
 
@@ -2356,13 +4068,18 @@ namespace xrvk
 		pipeInfo.renderPass = m_vecRenderPasses[ 0 ];
 		pipeInfo.subpass = 0;
 
-		// (5) Finally, create the graphics pipeline - whew!
+		// (4) Finally, create the graphics pipeline - whew!
 		VkPipeline shapesPipeline = VK_NULL_HANDLE;
-		VkResult vkResult = vkCreateGraphicsPipelines( m_pVulkanDevice->logicalDevice, VK_NULL_HANDLE, 1, &pipeInfo, nullptr, &shape->pipeline );
+		VkResult vkResult = vkCreateGraphicsPipelines( m_pVulkanDevice->logicalDevice, m_SharedState.vkPipelineCache, 1, &pipeInfo, nullptr, &shapesPipeline );
+
+		if ( vkResult != VK_SUCCESS )
+			LogError( "Error creating shapes pipeline (%s, %s) with vulkan result (%i)", sVertexShader.c_str(), sFragmentShader.c_str(), ( int32_t )vkResult );
 
-		// (6) Cleanup
+		// (5) Cleanup
 		vkDestroyShaderModule( m_pVulkanDevice->logicalDevice, vertShader, nullptr );
 		vkDestroyShaderModule( m_pVulkanDevice->logicalDevice, fragShader, nullptr );
+
+		return shapesPipeline;
 	}
 
 	void Render::PreparePipelines()
@@ -2424,7 +4141,7 @@ namespace xrvk
 		VkPushConstantRange vkPushConstantVisMask = {};
 		vkPushConstantVisMask.stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
 		vkPushConstantVisMask.offset = 0;
-		vkPushConstantVisMask.size = 4 * 4 * sizeof( float );
+		vkPushConstantVisMask.size = m_bMultiviewEnabled ? sizeof( PushConstVisMaskMultiview ) : 4 * 4 * sizeof( float );
 
 		VkPipelineLayoutCreateInfo pipelineLayoutCreateInfoVismask { VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO };
 		pipelineLayoutCreateInfoVismask.pushConstantRangeCount = 1;
@@ -2455,6 +4172,29 @@ namespace xrvk
 		pipelineLayoutCI.pPushConstantRanges = &pushConstantRange;
 		VK_CHECK_RESULT( vkCreatePipelineLayout( m_SharedState.vkDevice, &pipelineLayoutCI, nullptr, &vkPipelineLayout ) );
 
+		// PIPELINE LAYOUT: PBR instanced (pbr sets and push constants, plus instance matrices)
+		if ( descriptorSetLayouts.instance != VK_NULL_HANDLE )
+		{
+			const std::vector< VkDescriptorSetLayout > setLayoutsInstanced = {
+				descriptorSetLayouts.scene, descriptorSetLayouts.material, descriptorSetLayouts.node, descriptorSetLayouts.instance };
+			pipelineLayoutCI.setLayoutCount = static_cast< uint32_t >( setLayoutsInstanced.size() );
+			pipelineLayoutCI.pSetLayouts = setLayoutsInstanced.data();
+			VK_CHECK_RESULT( vkCreatePipelineLayout( m_SharedState.vkDevice, &pipelineLayoutCI, nullptr, &vkPipelineLayoutInstanced ) );
+		}
+
+		// PIPELINE LAYOUT: Instance culling prepass (instances, culled instances, indirect draws and views, per group push constants)
+		if ( descriptorSetLayouts.instanceCull != VK_NULL_HANDLE )
+		{
+			VkPushConstantRange vkPushConstantInstanceCull { VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof( PushConstInstanceCull ) };
+
+			VkPipelineLayoutCreateInfo pipelineLayoutCreateInfoCull { VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO };
+			pipelineLayoutCreateInfoCull.setLayoutCount = 1;
+			pipelineLayoutCreateInfoCull.pSetLayouts = &descriptorSetLayouts.instanceCull;
+			pipelineLayoutCreateInfoCull.pushConstantRangeCount = 1;
+			pipelineLayoutCreateInfoCull.pPushConstantRanges = &vkPushConstantInstanceCull;
+			VK_CHECK_RESULT( vkCreatePipelineLayout( m_SharedState.vkDevice, &pipelineLayoutCreateInfoCull, nullptr, &vkPipelineLayoutInstanceCull ) );
+		}
+
 		// VERTEX BINDINGS: PBR
 		VkVertexInputBindingDescription vertexInputBinding = { 0, sizeof( vkglTF::Model::Vertex ), VK_VERTEX_INPUT_RATE_VERTEX };
 		std::vector< VkVertexInputAttributeDescription > vertexInputAttributes = {
@@ -2502,12 +4242,12 @@ namespace xrvk
 
 #ifdef XR_USE_PLATFORM_ANDROID
 		shaderStages = {
-			loadShader( m_SharedState.androidAssetManager, m_SharedState.vkDevice, "shaders/vismask.vert.spv", VK_SHADER_STAGE_VERTEX_BIT ),
-			loadShader( m_SharedState.androidAssetManager, m_SharedState.vkDevice, "shaders/vismask.frag.spv", VK_SHADER_STAGE_FRAGMENT_BIT ) };
+			loadShader( m_SharedState.androidAssetManager, m_SharedState.vkDevice, GetShaderVariant( "shaders/vismask.vert.spv" ), VK_SHADER_STAGE_VERTEX_BIT ),
+			loadShader( m_SharedState.androidAssetManager, m_SharedState.vkDevice, GetShaderVariant( "shaders/vismask.frag.spv" ), VK_SHADER_STAGE_FRAGMENT_BIT ) };
 #else
 		shaderStages = {
-			loadShader( m_SharedState.vkDevice, "shaders/vismask.vert.spv", VK_SHADER_STAGE_VERTEX_BIT ),
-			loadShader( m_SharedState.vkDevice, "shaders/vismask.frag.spv", VK_SHADER_STAGE_FRAGMENT_BIT ) };
+			loadShader( m_SharedState.vkDevice, GetShaderVariant( "shaders/vismask.vert.spv" ), VK_SHADER_STAGE_VERTEX_BIT ),
+			loadShader( m_SharedState.vkDevice, GetShaderVariant( "shaders/vismask.frag.spv" ), VK_SHADER_STAGE_FRAGMENT_BIT ) };
 #endif
 
 		VK_CHECK_RESULT( vkCreateGraphicsPipelines( m_SharedState.vkDevice, m_SharedState.vkPipelineCache, 1, &pipelineCI, nullptr, &pipelines.vismask ) );
@@ -2526,12 +4266,12 @@ namespace xrvk
 		// PIPELINE: Skybox (background cube)
 #ifdef XR_USE_PLATFORM_ANDROID
 		shaderStages = {
-			loadShader( m_SharedState.androidAssetManager, m_SharedState.vkDevice, "shaders/skybox.vert.spv", VK_SHADER_STAGE_VERTEX_BIT ),
-			loadShader( m_SharedState.androidAssetManager, m_SharedState.vkDevice, "shaders/skybox.frag.spv", VK_SHADER_STAGE_FRAGMENT_BIT ) };
+			loadShader( m_SharedState.androidAssetManager, m_SharedState.vkDevice, GetShaderVariant( "shaders/skybox.vert.spv" ), VK_SHADER_STAGE_VERTEX_BIT ),
+			loadShader( m_SharedState.androidAssetManager, m_SharedState.vkDevice, GetShaderVariant( "shaders/skybox.frag.spv" ), VK_SHADER_STAGE_FRAGMENT_BIT ) };
 #else
 		shaderStages = {
-			loadShader( m_SharedState.vkDevice, "shaders/skybox.vert.spv", VK_SHADER_STAGE_VERTEX_BIT ),
-			loadShader( m_SharedState.vkDevice, "shaders/skybox.frag.spv", VK_SHADER_STAGE_FRAGMENT_BIT ) };
+			loadShader( m_SharedState.vkDevice, GetShaderVariant( "shaders/skybox.vert.spv" ), VK_SHADER_STAGE_VERTEX_BIT ),
+			loadShader( m_SharedState.vkDevice, GetShaderVariant( "shaders/skybox.frag.spv" ), VK_SHADER_STAGE_FRAGMENT_BIT ) };
 #endif
 
 		VK_CHECK_RESULT( vkCreateGraphicsPipelines( m_SharedState.vkDevice, m_SharedState.vkPipelineCache, 1, &pipelineCI, nullptr, &pipelines.skybox ) );
@@ -2543,13 +4283,14 @@ namespace xrvk
 		}
 
 		// PIPELINE: PBR
+		const std::string sPbrFragmentShader = GetShaderVariant( m_bBindlessEnabled ? "shaders/pbr_khr_bindless.frag.spv" : "shaders/pbr_khr.frag.spv" );
 #ifdef XR_USE_PLATFORM_ANDROID
 		shaderStages = {
-			loadShader( m_SharedState.androidAssetManager, m_SharedState.vkDevice, "shaders/pbr.vert.spv", VK_SHADER_STAGE_VERTEX_BIT ),
-			loadShader( m_SharedState.androidAssetManager, m_SharedState.vkDevice, "shaders/pbr_khr.frag.spv", VK_SHADER_STAGE_FRAGMENT_BIT ) };
+			loadShader( m_SharedState.androidAssetManager, m_SharedState.vkDevice, GetShaderVariant( "shaders/pbr.vert.spv" ), VK_SHADER_STAGE_VERTEX_BIT ),
+			loadShader( m_SharedState.androidAssetManager, m_SharedState.vkDevice, sPbrFragmentShader, VK_SHADER_STAGE_FRAGMENT_BIT ) };
 #else
 		shaderStages = {
-			loadShader( m_SharedState.vkDevice, "shaders/pbr.vert.spv", VK_SHADER_STAGE_VERTEX_BIT ), loadShader( m_SharedState.vkDevice, "shaders/pbr_khr.frag.spv", VK_SHADER_STAGE_FRAGMENT_BIT ) };
+			loadShader( m_SharedState.vkDevice, GetShaderVariant( "shaders/pbr.vert.spv" ), VK_SHADER_STAGE_VERTEX_BIT ), loadShader( m_SharedState.vkDevice, sPbrFragmentShader, VK_SHADER_STAGE_FRAGMENT_BIT ) };
 #endif
 
 		rasterizationStateCI.cullMode = VK_CULL_MODE_BACK_BIT;
@@ -2574,6 +4315,42 @@ namespace xrvk
 		blendAttachmentState.alphaBlendOp = VK_BLEND_OP_ADD;
 		VK_CHECK_RESULT( vkCreateGraphicsPipelines( m_SharedState.vkDevice, m_SharedState.vkPipelineCache, 1, &pipelineCI, nullptr, &pipelines.pbrAlphaBlend ) );
 
+		// PIPELINES: PBR instanced (same states as above, instanced vertex shader)
+		if ( vkPipelineLayoutInstanced != VK_NULL_HANDLE )
+		{
+			vkDestroyShaderModule( m_SharedState.vkDevice, shaderStages[ 0 ].module, nullptr );
+#ifdef XR_USE_PLATFORM_ANDROID
+			shaderStages[ 0 ] = loadShader( m_SharedState.androidAssetManager, m_SharedState.vkDevice, GetShaderVariant( "shaders/pbr_instanced.vert.spv" ), VK_SHADER_STAGE_VERTEX_BIT );
+#else
+			shaderStages[ 0 ] = loadShader( m_SharedState.vkDevice, GetShaderVariant( "shaders/pbr_instanced.vert.spv" ), VK_SHADER_STAGE_VERTEX_BIT );
+#endif
+			pipelineCI.layout = vkPipelineLayoutInstanced;
+			VK_CHECK_RESULT( vkCreateGraphicsPipelines( m_SharedState.vkDevice, m_SharedState.vkPipelineCache, 1, &pipelineCI, nullptr, &pipelines.pbrAlphaBlendInstanced ) );
+
+			blendAttachmentState.blendEnable = VK_FALSE;
+			VK_CHECK_RESULT( vkCreateGraphicsPipelines( m_SharedState.vkDevice, m_SharedState.vkPipelineCache, 1, &pipelineCI, nullptr, &pipelines.pbrDoubleSidedInstanced ) );
+
+			rasterizationStateCI.cullMode = VK_CULL_MODE_BACK_BIT;
+			VK_CHECK_RESULT( vkCreateGraphicsPipelines( m_SharedState.vkDevice, m_SharedState.vkPipelineCache, 1, &pipelineCI, nullptr, &pipelines.pbrInstanced ) );
+
+			pipelineCI.layout = vkPipelineLayout;
+		}
+
+		// PIPELINE: Instance culling prepass (compute)
+		if ( vkPipelineLayoutInstanceCull != VK_NULL_HANDLE )
+		{
+			VkComputePipelineCreateInfo computePipelineCI { VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO };
+#ifdef XR_USE_PLATFORM_ANDROID
+			computePipelineCI.stage = loadShader( m_SharedState.androidAssetManager, m_SharedState.vkDevice, "shaders/instance_cull.comp.spv", VK_SHADER_STAGE_COMPUTE_BIT );
+#else
+			computePipelineCI.stage = loadShader( m_SharedState.vkDevice, "shaders/instance_cull.comp.spv", VK_SHADER_STAGE_COMPUTE_BIT );
+#endif
+			computePipelineCI.layout = vkPipelineLayoutInstanceCull;
+			VK_CHECK_RESULT( vkCreateComputePipelines( m_SharedState.vkDevice, m_SharedState.vkPipelineCache, 1, &computePipelineCI, nullptr, &pipelines.instanceCull ) );
+
+			vkDestroyShaderModule( m_SharedState.vkDevice, computePipelineCI.stage.module, nullptr );
+		}
+
 		// cleanup
 		for ( auto shaderStage : shaderStages )
 		{
@@ -2661,11 +4438,11 @@ namespace xrvk
 		// Create shader stages
 		std::array< VkPipelineShaderStageCreateInfo, 2 > shaderStages;
 #ifdef XR_USE_PLATFORM_ANDROID
-		shaderStages[ 0 ] = loadShader( m_SharedState.androidAssetManager, m_SharedState.vkDevice, sVertexShader, VK_SHADER_STAGE_VERTEX_BIT );
-		shaderStages[ 1 ] = loadShader( m_SharedState.androidAssetManager, m_SharedState.vkDevice, sFragmentShader, VK_SHADER_STAGE_FRAGMENT_BIT );
+		shaderStages[ 0 ] = loadShader( m_SharedState.androidAssetManager, m_SharedState.vkDevice, GetShaderVariant( sVertexShader ), VK_SHADER_STAGE_VERTEX_BIT );
+		shaderStages[ 1 ] = loadShader( m_SharedState.androidAssetManager, m_SharedState.vkDevice, GetShaderVariant( sFragmentShader ), VK_SHADER_STAGE_FRAGMENT_BIT );
 #else
-		shaderStages[ 0 ] = loadShader( m_SharedState.vkDevice, sVertexShader, VK_SHADER_STAGE_VERTEX_BIT );
-		shaderStages[ 1 ] = loadShader( m_SharedState.vkDevice, sFragmentShader, VK_SHADER_STAGE_FRAGMENT_BIT );
+		shaderStages[ 0 ] = loadShader( m_SharedState.vkDevice, GetShaderVariant( sVertexShader ), VK_SHADER_STAGE_VERTEX_BIT );
+		shaderStages[ 1 ] = loadShader( m_SharedState.vkDevice, GetShaderVariant( sFragmentShader ), VK_SHADER_STAGE_FRAGMENT_BIT );
 #endif
 
 		pCreateInfo->stageCount = static_cast< uint32_t >( shaderStages.size() );
@@ -2673,7 +4450,7 @@ namespace xrvk
 
 		// Create graphics pipeline
 		VkPipeline pipeline = VK_NULL_HANDLE;
-		VK_CHECK_RESULT( vkCreateGraphicsPipelines( m_SharedState.vkDevice, VK_NULL_HANDLE, 1, pCreateInfo, nullptr, &pipeline ) );
+		VK_CHECK_RESULT( vkCreateGraphicsPipelines( m_SharedState.vkDevice, m_SharedState.vkPipelineCache, 1, pCreateInfo, nullptr, &pipeline ) );
 
 		// cleanup
 		for ( auto shaderStage : shaderStages )
@@ -2709,57 +4486,607 @@ namespace xrvk
 		return m_bShowSkybox;
 	}
 
-	void Render::RenderGltfScene( RenderSceneBase *renderable )
+	void Render::BuildInstanceGroups()
 	{
-		if ( !renderable->bIsVisible )
+		for ( auto &instanceGroup : m_vecInstanceGroups )
+		{
+			for ( auto &renderable : instanceGroup->vecInstances )
+				renderable->pInstanceGroup = nullptr;
+
+			delete instanceGroup;
+		}
+		m_vecInstanceGroups.clear();
+
+		if ( !m_bInstancingEnabled )
+			return;
+
+		// (1) Instanced draws need the instanced variant of the pbr vertex shader and the culling prepass
+		if ( !IsShaderAvailable( "shaders/pbr_instanced.vert.spv" ) || ( m_bMultiviewEnabled && !IsShaderAvailable( "shaders/pbr_instanced_multiview.vert.spv" ) ) ||
+			 !IsShaderAvailable( "shaders/instance_cull.comp.spv" ) )
+		{
+			LogInfo( "Instanced pbr or instance culling shader not found. Renderables that share a source file will each load their own model." );
+			return;
+		}
+
+		// (2) Group sectors and models by source file, keeping the order they were added in
+		std::unordered_map< std::string, std::vector< RenderSceneBase * > > mapSourceFiles;
+		std::vector< std::string > vecSourceFiles;
+
+		auto Gather = [ & ]( RenderSceneBase *renderable )
+		{
+			std::vector< RenderSceneBase * > &vecRenderables = mapSourceFiles[ renderable->sFilename ];
+			if ( vecRenderables.empty() )
+				vecSourceFiles.push_back( renderable->sFilename );
+
+			vecRenderables.push_back( renderable );
+		};
+
+		for ( auto &renderable : vecRenderSectors )
+			Gather( renderable );
+
+		for ( auto &renderable : vecRenderModels )
+			Gather( renderable );
+
+		// (3) Files used more than once become instance groups, the first renderable loads and draws the shared model
+		for ( auto &sFilename : vecSourceFiles )
+		{
+			std::vector< RenderSceneBase * > &vecRenderables = mapSourceFiles[ sFilename ];
+			if ( vecRenderables.size() < 2 )
+				continue;
+
+			InstanceGroup *pInstanceGroup = new InstanceGroup;
+			pInstanceGroup->pSource = vecRenderables[ 0 ];
+			pInstanceGroup->vecInstances = vecRenderables;
+
+			for ( auto &renderable : vecRenderables )
+				renderable->pInstanceGroup = pInstanceGroup;
+
+			m_vecInstanceGroups.push_back( pInstanceGroup );
+			LogInfo( "gltf file %s is shared by %i instanced renderables.", sFilename.c_str(), ( uint32_t )vecRenderables.size() );
+		}
+	}
+
+	void Render::SetupInstanceGroups()
+	{
+		if ( m_vecInstanceGroups.empty() )
+			return;
+
+		// (1) Layouts - culled instance matrices (set 3 of the instanced pbr pipeline layout) and the culling prepass
+		VkDescriptorSetLayoutBinding setLayoutBinding { 0, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_VERTEX_BIT, nullptr };
+		VkDescriptorSetLayoutCreateInfo descriptorSetLayoutCI {};
+		descriptorSetLayoutCI.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+		descriptorSetLayoutCI.pBindings = &setLayoutBinding;
+		descriptorSetLayoutCI.bindingCount = 1;
+		VK_CHECK_RESULT( vkCreateDescriptorSetLayout( m_SharedState.vkDevice, &descriptorSetLayoutCI, nullptr, &descriptorSetLayouts.instance ) );
+
+		const std::vector< VkDescriptorSetLayoutBinding > setLayoutBindingsCull = {
+			{ 0, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT, nullptr },
+			{ 1, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT, nullptr },
+			{ 2, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT, nullptr },
+			{ 3, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT, nullptr },
+		};
+		descriptorSetLayoutCI.pBindings = setLayoutBindingsCull.data();
+		descriptorSetLayoutCI.bindingCount = static_cast< uint32_t >( setLayoutBindingsCull.size() );
+		VK_CHECK_RESULT( vkCreateDescriptorSetLayout( m_SharedState.vkDevice, &descriptorSetLayoutCI, nullptr, &descriptorSetLayouts.instanceCull ) );
+
+		// (2) View projections the prepass culls against, shared by all groups
+		const uint32_t unFrameSlots = static_cast< uint32_t >( vecDescriptorSets.size() );
+		m_vecInstanceCullBuffers.resize( unFrameSlots );
+		for ( auto &buffer : m_vecInstanceCullBuffers )
+		{
+			buffer.create(
+				m_pVulkanDevice, VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, sizeof( XrMatrix4x4f ) * k_unMultiviewCount );
+		}
+
+		for ( auto &pInstanceGroup : m_vecInstanceGroups )
+		{
+			DrawList *pDrawList = &pInstanceGroup->pSource->drawList;
+			const uint32_t unInstances = static_cast< uint32_t >( pInstanceGroup->vecInstances.size() );
+
+			// (3) Bounding sphere of the shared model, models without bounds are never culled
+			const vkglTF::Model &gltfModel = pInstanceGroup->pSource->gltfModel;
+			if ( gltfModel.dimensions.min.x <= gltfModel.dimensions.max.x )
+			{
+				const glm::vec3 center = ( gltfModel.dimensions.min + gltfModel.dimensions.max ) * 0.5f;
+				pInstanceGroup->boundingSphere = glm::vec4( center, glm::length( gltfModel.dimensions.max - center ) );
+			}
+
+			// (4) Indirect draw commands mirror the source's draw list, only the instance count changes per frame.
+			// Non indexed draws read the same commands as VkDrawIndirectCommand (vertexCount, instanceCount, firstVertex, firstInstance)
+			std::vector< VkDrawIndexedIndirectCommand > vecCommands( std::max( pDrawList->Size(), 1u ) );
+			for ( uint32_t i = 0; i < pDrawList->Size(); i++ )
+			{
+				vecCommands[ i ].indexCount = pDrawList->vecCounts[ i ];
+				vecCommands[ i ].instanceCount = 0;
+				vecCommands[ i ].firstIndex = pDrawList->vecIndexed[ i ] ? pDrawList->vecFirstIndices[ i ] : 0;
+				vecCommands[ i ].vertexOffset = 0;
+				vecCommands[ i ].firstInstance = 0;
+			}
+
+			// (5) Per frame slot buffers and descriptor sets - instances are written by the cpu, culled instances and instance counts by the prepass
+			pInstanceGroup->vecInstanceBuffers.resize( unFrameSlots );
+			pInstanceGroup->vecCulledInstanceBuffers.resize( unFrameSlots );
+			pInstanceGroup->vecIndirectBuffers.resize( unFrameSlots );
+			pInstanceGroup->vecDescriptorSets.resize( unFrameSlots );
+			pInstanceGroup->vecCullDescriptorSets.resize( unFrameSlots );
+
+			for ( uint32_t i = 0; i < unFrameSlots; i++ )
+			{
+				pInstanceGroup->vecInstanceBuffers[ i ].create(
+					m_pVulkanDevice,
+					VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+					VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+					sizeof( glm::mat4 ) * unInstances );
+
+				pInstanceGroup->vecCulledInstanceBuffers[ i ].create( m_pVulkanDevice, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, sizeof( glm::mat4 ) * unInstances, false );
+
+				pInstanceGroup->vecIndirectBuffers[ i ].create(
+					m_pVulkanDevice,
+					VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+					VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+					sizeof( VkDrawIndexedIndirectCommand ) * vecCommands.size(),
+					vecCommands.data() );
+
+				VkDescriptorSetAllocateInfo descriptorSetAllocInfo {};
+				descriptorSetAllocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+				descriptorSetAllocInfo.descriptorPool = vkDescriptorPool;
+				descriptorSetAllocInfo.pSetLayouts = &descriptorSetLayouts.instance;
+				descriptorSetAllocInfo.descriptorSetCount = 1;
+				VK_CHECK_RESULT( vkAllocateDescriptorSets( m_SharedState.vkDevice, &descriptorSetAllocInfo, &pInstanceGroup->vecDescriptorSets[ i ] ) );
+
+				descriptorSetAllocInfo.pSetLayouts = &descriptorSetLayouts.instanceCull;
+				VK_CHECK_RESULT( vkAllocateDescriptorSets( m_SharedState.vkDevice, &descriptorSetAllocInfo, &pInstanceGroup->vecCullDescriptorSets[ i ] ) );
+
+				std::array< VkWriteDescriptorSet, 5 > writeDescriptorSets {};
+				for ( auto &writeDescriptorSet : writeDescriptorSets )
+				{
+					writeDescriptorSet.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+					writeDescriptorSet.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+					writeDescriptorSet.descriptorCount = 1;
+					writeDescriptorSet.dstSet = pInstanceGroup->vecCullDescriptorSets[ i ];
+				}
+
+				writeDescriptorSets[ 0 ].dstSet = pInstanceGroup->vecDescriptorSets[ i ];
+				writeDescriptorSets[ 0 ].dstBinding = 0;
+				writeDescriptorSets[ 0 ].pBufferInfo = &pInstanceGroup->vecCulledInstanceBuffers[ i ].descriptor;
+
+				writeDescriptorSets[ 1 ].dstBinding = 0;
+				writeDescriptorSets[ 1 ].pBufferInfo = &pInstanceGroup->vecInstanceBuffers[ i ].descriptor;
+
+				writeDescriptorSets[ 2 ].dstBinding = 1;
+				writeDescriptorSets[ 2 ].pBufferInfo = &pInstanceGroup->vecCulledInstanceBuffers[ i ].descriptor;
+
+				writeDescriptorSets[ 3 ].dstBinding = 2;
+				writeDescriptorSets[ 3 ].pBufferInfo = &pInstanceGroup->vecIndirectBuffers[ i ].descriptor;
+
+				writeDescriptorSets[ 4 ].descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+				writeDescriptorSets[ 4 ].dstBinding = 3;
+				writeDescriptorSets[ 4 ].pBufferInfo = &m_vecInstanceCullBuffers[ i ].descriptor;
+
+				vkUpdateDescriptorSets( m_SharedState.vkDevice, static_cast< uint32_t >( writeDescriptorSets.size() ), writeDescriptorSets.data(), 0, nullptr );
+			}
+		}
+	}
+
+	uint32_t Render::UpdateInstanceGroup( InstanceGroup *pInstanceGroup )
+	{
+		// (1) Write model matrices of visible instances for this frame slot. Mesh nodes of the shared model keep their own
+		// transforms (hierarchy, node local trs and animations), the vertex shader applies the instance matrix on top (see pbr_instanced.vert)
+		glm::mat4 *pInstanceMatrices = static_cast< glm::mat4 * >( pInstanceGroup->vecInstanceBuffers[ m_unCurrentFrame ].mapped );
+
+		uint32_t unVisibleInstances = 0;
+		for ( RenderSceneBase *renderable : pInstanceGroup->vecInstances )
+		{
+			if ( !renderable->bIsVisible )
+				continue;
+
+			pInstanceMatrices[ unVisibleInstances++ ] = glm::translate( glm::mat4( 1.0f ), renderable->GetPosition() ) * glm::mat4( renderable->GetRotation() ) *
+														glm::scale( glm::mat4( 1.0f ), renderable->GetScale() );
+		}
+
+		// (2) Reset the instance count of all indirect draws, the culling prepass counts the instances inside the frustum
+		VkDrawIndexedIndirectCommand *pCommands = static_cast< VkDrawIndexedIndirectCommand * >( pInstanceGroup->vecIndirectBuffers[ m_unCurrentFrame ].mapped );
+
+		const uint32_t unDraws = pInstanceGroup->pSource->drawList.Size();
+		for ( uint32_t i = 0; i < unDraws; i++ )
+			pCommands[ i ].instanceCount = 0;
+
+		pInstanceGroup->unVisibleInstances = unVisibleInstances;
+		return unVisibleInstances;
+	}
+
+	void Render::CullInstanceGroups( VkCommandBuffer vkCommandBuffer, XrMatrix4x4f *pViewProjections, uint32_t unViewCount )
+	{
+		if ( m_vecInstanceGroups.empty() || pipelines.instanceCull == VK_NULL_HANDLE )
+			return;
+
+		// (1) Views of this render, all groups are culled against the same frustums
+		assert( unViewCount <= k_unMultiviewCount );
+		memcpy( m_vecInstanceCullBuffers[ m_unCurrentFrame ].mapped, pViewProjections, sizeof( XrMatrix4x4f ) * unViewCount );
+
+		vkCmdBindPipeline( vkCommandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, pipelines.instanceCull );
+
+		// (2) One invocation per visible instance of each group
+		for ( auto &pInstanceGroup : m_vecInstanceGroups )
+		{
+			if ( pInstanceGroup->vecInstanceBuffers.empty() || !pInstanceGroup->pSource->drawList.bIsBuilt )
+				continue;
+
+			PushConstInstanceCull pushConstInstanceCull {};
+			pushConstInstanceCull.boundingSphere = pInstanceGroup->boundingSphere;
+			pushConstInstanceCull.unInstanceCount = UpdateInstanceGroup( pInstanceGroup );
+			pushConstInstanceCull.unDrawCount = pInstanceGroup->pSource->drawList.Size();
+			pushConstInstanceCull.unViewCount = unViewCount;
+
+			// Unbounded models are never culled
+			if ( pushConstInstanceCull.boundingSphere.w < 0.0f )
+				pushConstInstanceCull.unViewCount = 0;
+
+			if ( pushConstInstanceCull.unInstanceCount == 0 || pushConstInstanceCull.unDrawCount == 0 )
+				continue;
+
+			vkCmdBindDescriptorSets(
+				vkCommandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, vkPipelineLayoutInstanceCull, 0, 1, &pInstanceGroup->vecCullDescriptorSets[ m_unCurrentFrame ], 0, nullptr );
+			vkCmdPushConstants( vkCommandBuffer, vkPipelineLayoutInstanceCull, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof( PushConstInstanceCull ), &pushConstInstanceCull );
+			vkCmdDispatch( vkCommandBuffer, ( pushConstInstanceCull.unInstanceCount + k_unInstanceCullGroupSize - 1 ) / k_unInstanceCullGroupSize, 1, 1 );
+		}
+
+		// (3) Instance counts are read by the indirect draws, culled instances by the vertex shader
+		VkMemoryBarrier vkMemoryBarrier { VK_STRUCTURE_TYPE_MEMORY_BARRIER };
+		vkMemoryBarrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+		vkMemoryBarrier.dstAccessMask = VK_ACCESS_INDIRECT_COMMAND_READ_BIT | VK_ACCESS_SHADER_READ_BIT;
+		vkCmdPipelineBarrier(
+			vkCommandBuffer,
+			VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+			VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT | VK_PIPELINE_STAGE_VERTEX_SHADER_BIT,
+			0,
+			1,
+			&vkMemoryBarrier,
+			0,
+			nullptr,
+			0,
+			nullptr );
+	}
+
+	void Render::BuildDrawList( RenderSceneBase *renderable )
+	{
+		DrawList *pDrawList = &renderable->drawList;
+		pDrawList->Clear();
+
+		// (1) Precompute material push constants
+		std::unordered_map< const vkglTF::Material *, uint32_t > mapMaterials;
+		for ( auto &material : renderable->gltfModel.materials )
+		{
+			PushConstBlockMaterial pushConstBlockMaterial {};
+			pushConstBlockMaterial.emissiveFactor = material.emissiveFactor;
+
+			// To save push constant space, availability and texture coordinate set are combined
+			// -1 = texture not used for this material, >= 0 texture used and index of texture coordinate set
+			pushConstBlockMaterial.colorTextureSet = material.baseColorTexture != nullptr ? material.texCoordSets.baseColor : -1;
+			pushConstBlockMaterial.normalTextureSet = material.normalTexture != nullptr ? material.texCoordSets.normal : -1;
+			pushConstBlockMaterial.occlusionTextureSet = material.occlusionTexture != nullptr ? material.texCoordSets.occlusion : -1;
+			pushConstBlockMaterial.emissiveTextureSet = material.emissiveTexture != nullptr ? material.texCoordSets.emissive : -1;
+			pushConstBlockMaterial.alphaMask = static_cast< float >( material.alphaMode == vkglTF::Material::ALPHAMODE_MASK );
+			pushConstBlockMaterial.alphaMaskCutoff = material.alphaCutoff;
+
+			// TODO: glTF specs states that metallic roughness should be preferred, even if specular glosiness is present
+
+			if ( material.pbrWorkflows.metallicRoughness )
+			{
+				// Metallic roughness workflow
+				pushConstBlockMaterial.workflow = static_cast< float >( PBR_WORKFLOW_METALLIC_ROUGHNESS );
+				pushConstBlockMaterial.baseColorFactor = material.baseColorFactor;
+				pushConstBlockMaterial.metallicFactor = material.metallicFactor;
+				pushConstBlockMaterial.roughnessFactor = material.roughnessFactor;
+				pushConstBlockMaterial.PhysicalDescriptorTextureSet = material.metallicRoughnessTexture != nullptr ? material.texCoordSets.metallicRoughness : -1;
+				pushConstBlockMaterial.colorTextureSet = material.baseColorTexture != nullptr ? material.texCoordSets.baseColor : -1;
+			}
+
+			if ( material.pbrWorkflows.specularGlossiness )
+			{
+				// Specular glossiness workflow
+				pushConstBlockMaterial.workflow = static_cast< float >( PBR_WORKFLOW_SPECULAR_GLOSINESS );
+				pushConstBlockMaterial.PhysicalDescriptorTextureSet = material.extension.specularGlossinessTexture != nullptr ? material.texCoordSets.specularGlossiness : -1;
+				pushConstBlockMaterial.colorTextureSet = material.extension.diffuseTexture != nullptr ? material.texCoordSets.baseColor : -1;
+				pushConstBlockMaterial.diffuseFactor = material.extension.diffuseFactor;
+				pushConstBlockMaterial.specularFactor = glm::vec4( material.extension.specularFactor, 1.0f );
+			}
+
+			mapMaterials[ &material ] = static_cast< uint32_t >( pDrawList->vecMaterialPushConstants.size() );
+			pDrawList->vecMaterialPushConstants.push_back( pushConstBlockMaterial );
+			pDrawList->vecMaterialDescriptorSets.push_back( material.descriptorSet );
+
+			// Bindless: material parameters live in the material table instead, draws only push the table index
+			if ( m_bBindlessEnabled )
+			{
+				auto it = m_mapBindlessMaterials.find( &material );
+				uint32_t unTableIndex = it != m_mapBindlessMaterials.end() ? it->second : UINT32_MAX;
+
+				if ( unTableIndex != UINT32_MAX )
+					static_cast< BindlessMaterial * >( m_BindlessMaterialBuffer.mapped )[ unTableIndex ].params = pushConstBlockMaterial;
+				else
+					unTableIndex = 0;
+
+				pDrawList->vecMaterialTableIndices.push_back( unTableIndex );
+			}
+		}
+
+		// (2) Gather mesh nodes and their primitives in traversal order (depth first)
+		struct DrawEntry
+		{
+			vkglTF::Material::AlphaMode alphaMode;
+			DrawList::EPipeline pipeline;
+			uint32_t unMaterial;
+			vkglTF::Node *node;
+			vkglTF::Primitive *primitive;
+		};
+		std::vector< DrawEntry > vecEntries;
+
+		std::vector< vkglTF::Node * > vecStack( renderable->gltfModel.nodes.rbegin(), renderable->gltfModel.nodes.rend() );
+		while ( !vecStack.empty() )
+		{
+			vkglTF::Node *node = vecStack.back();
+			vecStack.pop_back();
+
+			if ( node->mesh )
+			{
+				pDrawList->vecMeshNodes.push_back( node );
+
+				for ( vkglTF::Primitive *primitive : node->mesh->primitives )
+				{
+					DrawEntry entry { primitive->material.alphaMode, DrawList::EPipeline::Pbr, 0, node, primitive };
+
+					if ( entry.alphaMode == vkglTF::Material::ALPHAMODE_BLEND )
+						entry.pipeline = DrawList::EPipeline::PbrAlphaBlend;
+					else if ( primitive->material.doubleSided )
+						entry.pipeline = DrawList::EPipeline::PbrDoubleSided;
+
+					auto it = mapMaterials.find( &primitive->material );
+					assert( it != mapMaterials.end() );
+					entry.unMaterial = it->second;
+
+					vecEntries.push_back( entry );
+				}
+			}
+
+			for ( auto child = node->children.rbegin(); child != node->children.rend(); ++child )
+				vecStack.push_back( *child );
+		}
+
+		// (3) Sort to minimize state changes - blended draws only sort by alpha mode so their node order is kept
+		std::stable_sort(
+			vecEntries.begin(),
+			vecEntries.end(),
+			[]( const DrawEntry &a, const DrawEntry &b )
+			{
+				if ( a.alphaMode != b.alphaMode )
+					return a.alphaMode < b.alphaMode;
+
+				if ( a.alphaMode == vkglTF::Material::ALPHAMODE_BLEND )
+					return false;
+
+				if ( a.pipeline != b.pipeline )
+					return a.pipeline < b.pipeline;
+
+				return a.unMaterial < b.unMaterial;
+			} );
+
+		// (4) Flatten
+		for ( auto &entry : vecEntries )
+		{
+			pDrawList->vecPipelines.push_back( entry.pipeline );
+			pDrawList->vecMaterials.push_back( entry.unMaterial );
+			pDrawList->vecMeshUniformOffsets.push_back( renderable->gltfModel.getMeshUniformOffset( entry.node->mesh, 0 ) );
+			pDrawList->vecFirstIndices.push_back( entry.primitive->firstIndex );
+			pDrawList->vecCounts.push_back( entry.primitive->hasIndices ? entry.primitive->indexCount : entry.primitive->vertexCount );
+			pDrawList->vecIndexed.push_back( entry.primitive->hasIndices ? 1 : 0 );
+		}
+
+		pDrawList->bIsBuilt = true;
+		LogVerbose( "Draw list for %s built with %i draws and %i materials.", renderable->sFilename.c_str(), pDrawList->Size(), ( uint32_t )mapMaterials.size() );
+	}
+
+	void Render::RenderGltfScene( RenderSceneBase *renderable, VkCommandBuffer vkCommandBuffer )
+	{
+		// Instanced renderables are all drawn by their group's source, as long as any of them is visible
+		DrawList *pDrawList = &renderable->drawList;
+		InstanceGroup *pInstanceGroup = renderable->pInstanceGroup;
+		if ( !pDrawList->bIsBuilt || ( pInstanceGroup ? !renderable->IsInstanceSource() : !renderable->bIsVisible ) )
 			return;
 
 		const vkglTF::Model *gltfModel = &renderable->gltfModel;
 
-		vkCmdBindVertexBuffers( m_vecFrameData[ 0 ].vkCommandBuffer, 0, 1, &gltfModel->vertices.buffer, vkDeviceSizeOffsets );
+		// (1) Update gltf node pose and scale with renderable's - only nodes that moved since the last render are recomputed and written to their ubos
+		if ( pInstanceGroup )
+		{
+			// Instance matrices and counts were written by the culling prepass of this render
+			if ( pInstanceGroup->unVisibleInstances == 0 )
+				return;
+		}
+		else
+		{
+			for ( vkglTF::Node *node : pDrawList->vecMeshNodes )
+			{
+				node->scale = renderable->GetScale();
+				node->translation = renderable->GetPosition();
+				node->rotation = renderable->GetRotation();
+			}
+		}
+		renderable->gltfModel.updateTransforms();
+		renderable->gltfModel.writeMeshUniforms( m_unCurrentFrame );
+
+		// (2) Bind model buffers - scene (and bindless material) descriptor sets are bound once per command buffer
+		vkCmdBindVertexBuffers( vkCommandBuffer, 0, 1, &gltfModel->vertices.buffer, vkDeviceSizeOffsets );
 
-		if ( &gltfModel->indices.buffer != VK_NULL_HANDLE )
+		if ( gltfModel->indices.buffer != VK_NULL_HANDLE )
 		{
-			vkCmdBindIndexBuffer( m_vecFrameData[ 0 ].vkCommandBuffer, gltfModel->indices.buffer, 0, VK_INDEX_TYPE_UINT32 );
+			vkCmdBindIndexBuffer( vkCommandBuffer, gltfModel->indices.buffer, 0, VK_INDEX_TYPE_UINT32 );
 		}
 
-		// Opaque primitives first
-		for ( auto node : gltfModel->nodes )
+		// (3) Draw all primitives (opaque, alpha masked then transparent), only binding state that differs from the previous draw
+		// TODO: Correct depth sorting of transparent primitives
+		const VkPipeline pbrPipelines[ ( uint32_t )DrawList::EPipeline::EMax ] = { pipelines.pbr, pipelines.pbrDoubleSided, pipelines.pbrAlphaBlend };
+		const VkPipeline pbrPipelinesInstanced[ ( uint32_t )DrawList::EPipeline::EMax ] = {
+			pipelines.pbrInstanced, pipelines.pbrDoubleSidedInstanced, pipelines.pbrAlphaBlendInstanced };
+
+		// Instanced layout is compatible with the pbr layout for sets 0 - 2, so the scene and material sets stay bound
+		const VkPipeline *pPbrPipelines = pInstanceGroup ? pbrPipelinesInstanced : pbrPipelines;
+		const VkPipelineLayout vkLayout = pInstanceGroup ? vkPipelineLayoutInstanced : vkPipelineLayout;
+
+		if ( pInstanceGroup )
 		{
-			RenderNode( renderable, node, 0, vkglTF::Material::ALPHAMODE_OPAQUE );
+			vkCmdBindDescriptorSets(
+				vkCommandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, vkPipelineLayoutInstanced, 3, 1, &pInstanceGroup->vecDescriptorSets[ m_unCurrentFrame ], 0, nullptr );
 		}
 
-		// Alpha masked primitives
-		for ( auto node : gltfModel->nodes )
+		// Mesh uniforms of this frame's region
+		const VkDescriptorSet vkMeshDescriptorSet = gltfModel->meshUniforms.descriptorSet;
+		const uint32_t unMeshFrameOffset = static_cast< uint32_t >( gltfModel->meshUniforms.frameSize * m_unCurrentFrame );
+
+		VkPipeline vkBoundPipeline = VK_NULL_HANDLE;
+		uint32_t unBoundMeshOffset = UINT32_MAX;
+		uint32_t unBoundMaterial = UINT32_MAX;
+
+		const uint32_t unDraws = pDrawList->Size();
+		for ( uint32_t i = 0; i < unDraws; i++ )
 		{
-			RenderNode( renderable, node, 0, vkglTF::Material::ALPHAMODE_MASK );
+			// Custom pipeline overrides the pbr pipelines
+			VkPipeline pipeline = renderable->vkPipeline != VK_NULL_HANDLE && !pInstanceGroup ? renderable->vkPipeline : pPbrPipelines[ ( uint32_t )pDrawList->vecPipelines[ i ] ];
+			if ( pipeline != vkBoundPipeline )
+			{
+				vkCmdBindPipeline( vkCommandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline );
+				vkBoundPipeline = pipeline;
+			}
+
+			const uint32_t unMaterial = pDrawList->vecMaterials[ i ];
+			if ( unMaterial != unBoundMaterial && m_bBindlessEnabled )
+			{
+				vkCmdPushConstants( vkCommandBuffer, vkLayout, VK_SHADER_STAGE_FRAGMENT_BIT, 0, sizeof( uint32_t ), &pDrawList->vecMaterialTableIndices[ unMaterial ] );
+
+				unBoundMaterial = unMaterial;
+			}
+			else if ( unMaterial != unBoundMaterial )
+			{
+				vkCmdBindDescriptorSets( vkCommandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, vkLayout, 1, 1, &pDrawList->vecMaterialDescriptorSets[ unMaterial ], 0, nullptr );
+
+				vkCmdPushConstants(
+					vkCommandBuffer,
+					vkLayout,
+					VK_SHADER_STAGE_FRAGMENT_BIT,
+					0,
+					sizeof( PushConstBlockMaterial ),
+					&pDrawList->vecMaterialPushConstants[ unMaterial ] );
+
+				unBoundMaterial = unMaterial;
+			}
+
+			const uint32_t unMeshOffset = unMeshFrameOffset + pDrawList->vecMeshUniformOffsets[ i ];
+			if ( unMeshOffset != unBoundMeshOffset )
+			{
+				vkCmdBindDescriptorSets( vkCommandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, vkLayout, 2, 1, &vkMeshDescriptorSet, 1, &unMeshOffset );
+				unBoundMeshOffset = unMeshOffset;
+			}
+
+			if ( pDrawList->vecIndexed[ i ] && pInstanceGroup )
+			{
+				vkCmdDrawIndexedIndirect(
+					vkCommandBuffer,
+					pInstanceGroup->vecIndirectBuffers[ m_unCurrentFrame ].buffer,
+					i * sizeof( VkDrawIndexedIndirectCommand ),
+					1,
+					sizeof( VkDrawIndexedIndirectCommand ) );
+			}
+			else if ( pDrawList->vecIndexed[ i ] )
+			{
+				vkCmdDrawIndexed( vkCommandBuffer, pDrawList->vecCounts[ i ], 1, pDrawList->vecFirstIndices[ i ], 0, 0 );
+			}
+			else if ( pInstanceGroup )
+			{
+				vkCmdDrawIndirect(
+					vkCommandBuffer,
+					pInstanceGroup->vecIndirectBuffers[ m_unCurrentFrame ].buffer,
+					i * sizeof( VkDrawIndexedIndirectCommand ),
+					1,
+					sizeof( VkDrawIndexedIndirectCommand ) );
+			}
+			else
+			{
+				vkCmdDraw( vkCommandBuffer, pDrawList->vecCounts[ i ], 1, 0, 0 );
+			}
 		}
 
-		// Transparent primitives
-		// TODO: Correct depth sorting
-		for ( auto node : gltfModel->nodes )
+		m_unDrawCalls += unDraws;
+	}
+
+	uint32_t Render::GetDrawCallCount( bool bReset /*= true*/ )
+	{
+		return bReset ? m_unDrawCalls.exchange( 0 ) : m_unDrawCalls.load();
+	}
+
+	void Render::GetTransformCounters( uint32_t *pNodesRecomputed, uint32_t *pUniformBuffersWritten, bool bReset /*= true*/ )
+	{
+		uint32_t unNodesRecomputed = 0;
+		uint32_t unUniformBuffersWritten = 0;
+
+		auto Accumulate = [ & ]( RenderSceneBase *renderable )
+		{
+			unNodesRecomputed += renderable->gltfModel.nodesRecomputed;
+			unUniformBuffersWritten += renderable->gltfModel.uniformBuffersWritten;
+
+			if ( bReset )
+				renderable->gltfModel.resetTransformCounters();
+		};
+
+		for ( auto &renderable : vecRenderScenes )
+			Accumulate( renderable );
+
+		for ( auto &renderable : vecRenderSectors )
+			Accumulate( renderable );
+
+		for ( auto &renderable : vecRenderModels )
+			Accumulate( renderable );
+
+		if ( pNodesRecomputed )
+			*pNodesRecomputed = unNodesRecomputed;
+
+		if ( pUniformBuffersWritten )
+			*pUniformBuffersWritten = unUniformBuffersWritten;
+	}
+
+	void Render::BindSceneDescriptorSets( VkCommandBuffer vkCommandBuffer )
+	{
+		// Scene set and, when bindless, the material table and texture array of all models
+		if ( m_bBindlessEnabled )
+		{
+			const std::array< VkDescriptorSet, 2 > vkDescriptorSets = { vecDescriptorSets[ m_unCurrentFrame ].scene, m_vkBindlessDescriptorSet };
+			vkCmdBindDescriptorSets(
+				vkCommandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, vkPipelineLayout, 0, static_cast< uint32_t >( vkDescriptorSets.size() ), vkDescriptorSets.data(), 0, nullptr );
+		}
+		else
 		{
-			RenderNode( renderable, node, 0, vkglTF::Material::ALPHAMODE_BLEND );
+			vkCmdBindDescriptorSets( vkCommandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, vkPipelineLayout, 0, 1, &vecDescriptorSets[ m_unCurrentFrame ].scene, 0, nullptr );
 		}
 	}
 
-	void Render::RenderGltfScenes()
+	void Render::RenderGltfScenes( VkCommandBuffer vkCommandBuffer )
 	{
+		BindSceneDescriptorSets( vkCommandBuffer );
+
 		// Scenes
 		for ( auto &renderable : vecRenderScenes )
 		{
-			RenderGltfScene( renderable );
+			RenderGltfScene( renderable, vkCommandBuffer );
 		}
 
 		// Sectors
 		for ( auto &renderable : vecRenderSectors )
 		{
-			RenderGltfScene( renderable );
+			RenderGltfScene( renderable, vkCommandBuffer );
 		}
 
 		for ( auto &renderable : vecRenderModels )
 		{
-			RenderGltfScene( renderable );
+			RenderGltfScene( renderable, vkCommandBuffer );
 		}
 	}
 
@@ -2807,6 +5134,17 @@ namespace xrvk
 		rpInfo.subpassCount = 1;
 		rpInfo.pSubpasses = subpasses;
 
+		// multiview: broadcast the subpass to each view (array layer), views are also correlated so the driver can render them concurrently
+		const uint32_t unViewMask = ( 1u << k_unMultiviewCount ) - 1;
+		VkRenderPassMultiviewCreateInfoKHR rpMultiviewInfo { VK_STRUCTURE_TYPE_RENDER_PASS_MULTIVIEW_CREATE_INFO_KHR };
+		rpMultiviewInfo.subpassCount = 1;
+		rpMultiviewInfo.pViewMasks = &unViewMask;
+		rpMultiviewInfo.correlationMaskCount = 1;
+		rpMultiviewInfo.pCorrelationMasks = &unViewMask;
+
+		if ( m_bMultiviewEnabled )
+			rpInfo.pNext = &rpMultiviewInfo;
+
 		vkCreateRenderPass( m_SharedState.vkDevice, &rpInfo, nullptr, &m_vecRenderPasses[ nIndex ] );
 	}
 
@@ -2837,7 +5175,7 @@ namespace xrvk
 				{
 					VkImageViewCreateInfo colorViewInfo { VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO };
 					colorViewInfo.image = vkColorSwapchainImage->image;
-					colorViewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+					colorViewInfo.viewType = m_bMultiviewEnabled ? VK_IMAGE_VIEW_TYPE_2D_ARRAY : VK_IMAGE_VIEW_TYPE_2D;
 					colorViewInfo.format = oxrSwapchain->vulkanTextureFormats.vkColorTextureFormat;
 					colorViewInfo.components.r = VK_COMPONENT_SWIZZLE_R;
 					colorViewInfo.components.g = VK_COMPONENT_SWIZZLE_G;
@@ -2847,7 +5185,7 @@ namespace xrvk
 					colorViewInfo.subresourceRange.baseMipLevel = 0;
 					colorViewInfo.subresourceRange.levelCount = 1;
 					colorViewInfo.subresourceRange.baseArrayLayer = 0;
-					colorViewInfo.subresourceRange.layerCount = 1;
+					colorViewInfo.subresourceRange.layerCount = m_bMultiviewEnabled ? k_unMultiviewCount : 1;
 
 					vkCreateImageView( m_SharedState.vkDevice, &colorViewInfo, nullptr, &m_vec2RenderTargets[ i ][ j ].vkColorView );
 					attachments[ attachmentCount++ ] = m_vec2RenderTargets[ i ][ j ].vkColorView;
@@ -2861,7 +5199,7 @@ namespace xrvk
 				{
 					VkImageViewCreateInfo depthViewInfo { VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO };
 					depthViewInfo.image = vkDepthSwapchainImage->image;
-					depthViewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+					depthViewInfo.viewType = m_bMultiviewEnabled ? VK_IMAGE_VIEW_TYPE_2D_ARRAY : VK_IMAGE_VIEW_TYPE_2D;
 					depthViewInfo.format = oxrSwapchain->vulkanTextureFormats.vkDepthTextureFormat;
 					depthViewInfo.components.r = VK_COMPONENT_SWIZZLE_R;
 					depthViewInfo.components.g = VK_COMPONENT_SWIZZLE_G;
@@ -2871,7 +5209,7 @@ namespace xrvk
 					depthViewInfo.subresourceRange.baseMipLevel = 0;
 					depthViewInfo.subresourceRange.levelCount = 1;
 					depthViewInfo.subresourceRange.baseArrayLayer = 0;
-					depthViewInfo.subresourceRange.layerCount = 1;
+					depthViewInfo.subresourceRange.layerCount = m_bMultiviewEnabled ? k_unMultiviewCount : 1;
 
 					vkCreateImageView( m_SharedState.vkDevice, &depthViewInfo, nullptr, &m_vec2RenderTargets[ i ][ j ].vkDepthView );
 					attachments[ attachmentCount++ ] = m_vec2RenderTargets[ i ][ j ].vkDepthView;
@@ -2883,12 +5221,43 @@ namespace xrvk
 				fbInfo.pAttachments = attachments.data();
 				fbInfo.width = oxrSwapchain->unWidth;
 				fbInfo.height = oxrSwapchain->unHeight;
-				fbInfo.layers = 1;
+				fbInfo.layers = 1; // multiview renders to the layers in the image views
 				vkCreateFramebuffer( m_SharedState.vkDevice, &fbInfo, nullptr, &m_vec2RenderTargets[ i ][ j ].vkFrameBuffer );
 			}
 		}
 	}
 
+	bool Render::IsShaderAvailable( const std::string &sFilename )
+	{
+#ifdef XR_USE_PLATFORM_ANDROID
+		AAsset *file = AAssetManager_open( m_SharedState.androidAssetManager, sFilename.c_str(), AASSET_MODE_UNKNOWN );
+		if ( file == nullptr )
+			return false;
+
+		AAsset_close( file );
+		return true;
+#else
+		return std::filesystem::exists( sFilename );
+#endif
+	}
+
+	std::string Render::GetShaderVariant( const std::string &sFilename )
+	{
+		if ( !m_bMultiviewEnabled )
+			return sFilename;
+
+		// Multiview variants are named after the shader with a "_multiview" suffix (e.g. shaders/pbr.vert.spv -> shaders/pbr_multiview.vert.spv)
+		size_t unNameStart = sFilename.find_last_of( '/' );
+		size_t unExtensionStart = sFilename.find( '.', unNameStart == std::string::npos ? 0 : unNameStart + 1 );
+		if ( unExtensionStart == std::string::npos )
+			return sFilename;
+
+		std::string sVariant = sFilename.substr( 0, unExtensionStart ) + "_multiview" + sFilename.substr( unExtensionStart );
+
+		// Shaders that don't use per-view data (e.g. most fragment shaders) are shared by both paths
+		return IsShaderAvailable( sVariant ) ? sVariant : sFilename;
+	}
+
 	void RenderScene::GetMatrix( XrMatrix4x4f *matrix ) { XrMatrix4x4f_CreateTranslationRotationScale( matrix, &currentPose.position, &currentPose.orientation, &currentScale ); }
 
 	void RenderSector::GetMatrix( XrMatrix4x4f *matrix ) { XrMatrix4x4f_CreateTranslationRotationScale( matrix, &currentPose.position, &currentPose.orientation, &currentScale ); }
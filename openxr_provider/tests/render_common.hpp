@@ -0,0 +1,498 @@
+/* Copyright 2021, 2022, 2023 Rune Berg (GitHub: https://github.com/1runeberg, Twitter: https://twitter.com/1runeberg, YouTube: https://www.youtube.com/@1RuneBerg)
+ *
+ *  SPDX-License-Identifier: MIT
+ *
+ *  Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+ *
+ *  2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *
+ *  3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote products derived from this
+ *     software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ *  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+ *  BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ *  GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+ *  DAMAGE.
+ *
+ */
+
+#pragma once
+
+// Scene rendering and readback shared by the render tests (test_render_*). These run the provider's renderer on the mock
+// runtime and need a vulkan device, the template app's assets and the compiled shader variants (see tests/CMakeLists.txt)
+
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <memory>
+#include <vector>
+
+#include <xrvk/xrvk.hpp>
+
+#include "test_common.hpp"
+
+namespace oxr::test
+{
+	static const uint32_t k_unRenderFrames = 4;
+	static const uint32_t k_unRenderExtent = 256;
+
+	// Per channel difference allowed for a pixel to count as equal, and the share of pixels allowed to differ beyond that.
+	// Compared runs use different shader modules (e.g. pbr.vert vs pbr_multiview.vert, pbr_khr.frag vs pbr_khr_bindless.frag)
+	// and gl_Position isn't declared invariant, so vulkan doesn't guarantee bit identical results: lit colors may round
+	// differently (a unit or two per channel) and coverage of pixels on silhouette edges may flip (0.1% is ~65 of 65536 pixels)
+	static const uint32_t k_unChannelTolerance = 2;
+	static const double k_dMaxMismatchRatio = 0.001;
+
+	// OpenXR Reference Cube (SPDX-License-Identifier: Apache-2.0), as in the finger painting samples
+	inline std::vector< unsigned short > g_vecCubeIndices = {
+		0,	1,	2,	3,	4,	5,	// -X
+		6,	7,	8,	9,	10, 11, // +X
+		12, 13, 14, 15, 16, 17, // -Y
+		18, 19, 20, 21, 22, 23, // +Y
+		24, 25, 26, 27, 28, 29, // -Z
+		30, 31, 32, 33, 34, 35, // +Z
+	};
+
+	inline std::vector< Shapes::Vertex > g_vecCubeVertices = {
+		CUBE_SIDE( Shapes::LTB, Shapes::LBF, Shapes::LBB, Shapes::LTB, Shapes::LTF, Shapes::LBF, Shapes::DarkRed )	 // -X
+		CUBE_SIDE( Shapes::RTB, Shapes::RBB, Shapes::RBF, Shapes::RTB, Shapes::RBF, Shapes::RTF, Shapes::Red )		 // +X
+		CUBE_SIDE( Shapes::LBB, Shapes::LBF, Shapes::RBF, Shapes::LBB, Shapes::RBF, Shapes::RBB, Shapes::DarkGreen ) // -Y
+		CUBE_SIDE( Shapes::LTB, Shapes::RTB, Shapes::RTF, Shapes::LTB, Shapes::RTF, Shapes::LTF, Shapes::Green )	 // +Y
+		CUBE_SIDE( Shapes::LBB, Shapes::RBB, Shapes::RTB, Shapes::LBB, Shapes::RTB, Shapes::LTB, Shapes::DarkBlue )	 // -Z
+		CUBE_SIDE( Shapes::LBF, Shapes::LTF, Shapes::RTF, Shapes::LBF, Shapes::RTF, Shapes::RBF, Shapes::Blue )		 // +Z
+	};
+
+	// Render callbacks are plain function pointers, so the renderer and frame state of the current run live here
+	inline xrvk::Render *g_pRender = nullptr;
+	inline oxr::Session *g_pSession = nullptr;
+	inline std::vector< XrCompositionLayerProjectionView > g_vecFrameLayerProjectionViews;
+	inline XrFrameState g_xrFrameState { XR_TYPE_FRAME_STATE };
+
+	inline void PreRender_Callback( uint32_t unSwapchainIndex, uint32_t unImageIndex )
+	{
+		g_pRender->BeginRender( g_pSession, g_vecFrameLayerProjectionViews, &g_xrFrameState, unSwapchainIndex, unImageIndex );
+	}
+
+	inline void PostRender_Callback( uint32_t unSwapchainIndex, uint32_t unImageIndex ) { g_pRender->EndRender(); }
+
+	// Tightly packed 32 bit texels of one eye
+	struct EyeImage
+	{
+		uint32_t unWidth = 0;
+		uint32_t unHeight = 0;
+		std::vector< uint8_t > vecTexels;
+	};
+
+	enum class ERunResult
+	{
+		Rendered,
+		NoRuntime,
+		NotSupported,
+		Failed
+	};
+
+	inline uint32_t FindHostVisibleMemoryType( VkPhysicalDevice vkPhysicalDevice, uint32_t unTypeBits )
+	{
+		VkPhysicalDeviceMemoryProperties vkMemoryProperties {};
+		vkGetPhysicalDeviceMemoryProperties( vkPhysicalDevice, &vkMemoryProperties );
+
+		const VkMemoryPropertyFlags vkFlags = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+		for ( uint32_t i = 0; i < vkMemoryProperties.memoryTypeCount; i++ )
+		{
+			if ( ( unTypeBits & ( 1u << i ) ) && ( vkMemoryProperties.memoryTypes[ i ].propertyFlags & vkFlags ) == vkFlags )
+				return i;
+		}
+
+		return UINT32_MAX;
+	}
+
+	/// <summary>
+	/// Copies the projection views submitted in the last frame to host memory. The frame's gpu work is complete once xrEndFrame returned
+	/// </summary>
+	/// <param name="pSharedState">Vulkan device and queue of the renderer</param>
+	/// <param name="vecEyes">Output, one image per submitted view</param>
+	/// <returns>True if all views were read back</returns>
+	inline bool ReadSubmittedViews( xrvk::SharedState *pSharedState, std::vector< EyeImage > &vecEyes )
+	{
+		const VkDevice vkDevice = pSharedState->vkDevice;
+		const std::vector< oxr::mock::SubmittedView > vecViews = oxr::mock::GetLastSubmittedViews();
+
+		vecEyes.clear();
+		for ( auto &view : vecViews )
+		{
+			// (1) Host visible buffer for the view's image rect
+			const uint32_t unWidth = static_cast< uint32_t >( view.xrImageRect.extent.width );
+			const uint32_t unHeight = static_cast< uint32_t >( view.xrImageRect.extent.height );
+			const VkDeviceSize vkSize = VkDeviceSize( unWidth ) * unHeight * 4;
+
+			VkBufferCreateInfo vkBufferCI { VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO };
+			vkBufferCI.size = vkSize;
+			vkBufferCI.usage = VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+			vkBufferCI.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+			VkBuffer vkBuffer = VK_NULL_HANDLE;
+			if ( vkCreateBuffer( vkDevice, &vkBufferCI, nullptr, &vkBuffer ) != VK_SUCCESS )
+				return false;
+
+			VkMemoryRequirements vkMemoryRequirements {};
+			vkGetBufferMemoryRequirements( vkDevice, vkBuffer, &vkMemoryRequirements );
+
+			VkMemoryAllocateInfo vkMemoryAI { VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO };
+			vkMemoryAI.allocationSize = vkMemoryRequirements.size;
+			vkMemoryAI.memoryTypeIndex = FindHostVisibleMemoryType( pSharedState->vkPhysicalDevice, vkMemoryRequirements.memoryTypeBits );
+
+			VkDeviceMemory vkMemory = VK_NULL_HANDLE;
+			if ( vkMemoryAI.memoryTypeIndex == UINT32_MAX || vkAllocateMemory( vkDevice, &vkMemoryAI, nullptr, &vkMemory ) != VK_SUCCESS )
+			{
+				vkDestroyBuffer( vkDevice, vkBuffer, nullptr );
+				return false;
+			}
+
+			vkBindBufferMemory( vkDevice, vkBuffer, vkMemory, 0 );
+
+			// (2) Copy the view's array layer - swapchain images are left in the color attachment layout by the render pass
+			VkCommandPoolCreateInfo vkPoolCI { VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO };
+			vkPoolCI.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+			vkPoolCI.queueFamilyIndex = pSharedState->vkQueueFamilyIndex;
+
+			VkCommandPool vkPool = VK_NULL_HANDLE;
+			vkCreateCommandPool( vkDevice, &vkPoolCI, nullptr, &vkPool );
+
+			VkCommandBufferAllocateInfo vkCmdAI { VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO };
+			vkCmdAI.commandPool = vkPool;
+			vkCmdAI.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+			vkCmdAI.commandBufferCount = 1;
+
+			VkCommandBuffer vkCmd = VK_NULL_HANDLE;
+			vkAllocateCommandBuffers( vkDevice, &vkCmdAI, &vkCmd );
+
+			VkCommandBufferBeginInfo vkBeginInfo { VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO };
+			vkBeginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+			vkBeginCommandBuffer( vkCmd, &vkBeginInfo );
+
+			VkImageMemoryBarrier vkBarrier { VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER };
+			vkBarrier.srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+			vkBarrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+			vkBarrier.oldLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+			vkBarrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+			vkBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+			vkBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+			vkBarrier.image = view.vkImage;
+			vkBarrier.subresourceRange = { VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, view.unArrayIndex, 1 };
+			vkCmdPipelineBarrier( vkCmd, VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, nullptr, 0, nullptr, 1, &vkBarrier );
+
+			VkBufferImageCopy vkRegion {};
+			vkRegion.imageSubresource = { VK_IMAGE_ASPECT_COLOR_BIT, 0, view.unArrayIndex, 1 };
+			vkRegion.imageOffset = { view.xrImageRect.offset.x, view.xrImageRect.offset.y, 0 };
+			vkRegion.imageExtent = { unWidth, unHeight, 1 };
+			vkCmdCopyImageToBuffer( vkCmd, view.vkImage, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, vkBuffer, 1, &vkRegion );
+
+			std::swap( vkBarrier.oldLayout, vkBarrier.newLayout );
+			vkBarrier.srcAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+			vkBarrier.dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+			vkCmdPipelineBarrier( vkCmd, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, 0, 0, nullptr, 0, nullptr, 1, &vkBarrier );
+
+			vkEndCommandBuffer( vkCmd );
+
+			VkSubmitInfo vkSubmitInfo { VK_STRUCTURE_TYPE_SUBMIT_INFO };
+			vkSubmitInfo.commandBufferCount = 1;
+			vkSubmitInfo.pCommandBuffers = &vkCmd;
+			const bool bCopied = vkQueueSubmit( pSharedState->vkQueue, 1, &vkSubmitInfo, VK_NULL_HANDLE ) == VK_SUCCESS && vkQueueWaitIdle( pSharedState->vkQueue ) == VK_SUCCESS;
+
+			// (3) Keep the texels
+			if ( bCopied )
+			{
+				EyeImage eye;
+				eye.unWidth = unWidth;
+				eye.unHeight = unHeight;
+				eye.vecTexels.resize( static_cast< size_t >( vkSize ) );
+
+				void *pMapped = nullptr;
+				vkMapMemory( vkDevice, vkMemory, 0, vkSize, 0, &pMapped );
+				std::memcpy( eye.vecTexels.data(), pMapped, eye.vecTexels.size() );
+				vkUnmapMemory( vkDevice, vkMemory );
+
+				vecEyes.push_back( std::move( eye ) );
+			}
+
+			vkDestroyCommandPool( vkDevice, vkPool, nullptr );
+			vkDestroyBuffer( vkDevice, vkBuffer, nullptr );
+			vkFreeMemory( vkDevice, vkMemory, nullptr );
+
+			if ( !bCopied )
+				return false;
+		}
+
+		return !vecEyes.empty();
+	}
+
+	/// <summary>
+	/// A renderer drawing into the swapchains of a session on the mock runtime. Init() creates everything up to the render resources,
+	/// the caller then adds its scene and loads assets, Begin() runs the session until it is focused and RenderFrame() renders a frame
+	/// </summary>
+	struct RenderSession
+	{
+		// The renderer is declared first so it outlives the provider, whose session owns swapchain images on the renderer's device
+		std::unique_ptr< xrvk::Render > pRender;
+		std::unique_ptr< oxr::Provider > pProvider;
+		oxr::Session *pSession = nullptr;
+		bool bRunning = false;
+
+		oxr::RenderImageCallback preRenderCallback;
+		oxr::RenderImageCallback postRenderCallback;
+
+		~RenderSession() { End(); }
+
+		/// <summary>
+		/// Creates the instance, renderer, session, swapchains and render resources
+		/// </summary>
+		/// <param name="pccAppName">Application name for the instance</param>
+		/// <param name="bMultiview">Render all views in a single pass into a single two layer swapchain</param>
+		/// <param name="bBindless">Use the bindless material table instead of a descriptor set per material</param>
+		/// <param name="unRecordingThreads">Worker threads recording renderables, 0 records on the render thread</param>
+		/// <returns>Rendered if the renderer is ready for a scene, or why it isn't</returns>
+		ERunResult Init( const char *pccAppName, bool bMultiview, bool bBindless, uint32_t unRecordingThreads = 0 )
+		{
+			// (1) Instance
+			pProvider = std::make_unique< oxr::Provider >( oxr::ELogLevel::LogWarning );
+
+			std::vector< const char * > vecExtensions { XR_KHR_VULKAN_ENABLE_EXTENSION_NAME };
+			if ( !XR_UNQUALIFIED_SUCCESS( pProvider->FilterOutUnsupportedExtensions( vecExtensions ) ) || vecExtensions.empty() )
+				return ERunResult::NoRuntime;
+
+			oxr::AppInstanceInfo appInstanceInfo {};
+			appInstanceInfo.sAppName = pccAppName;
+			appInstanceInfo.unAppVersion = OXR_MAKE_VERSION32( 0, 1, 0 );
+			appInstanceInfo.sEngineName = "openxr_provider";
+			appInstanceInfo.unEngineVersion = OXR_MAKE_VERSION32( PROVIDER_VERSION_MAJOR, PROVIDER_VERSION_MINOR, PROVIDER_VERSION_PATCH );
+			appInstanceInfo.vecInstanceExtensions = vecExtensions;
+
+			if ( !XR_UNQUALIFIED_SUCCESS( pProvider->Init( &appInstanceInfo ) ) )
+				return ERunResult::NoRuntime;
+
+			// (2) Renderer - no vulkan device means there's nothing to render with
+			pRender = std::make_unique< xrvk::Render >( xrvk::ELogLevel::LogWarning, false );
+			if ( !XR_UNQUALIFIED_SUCCESS( pRender->Init( pProvider.get(), pccAppName, 1, "openxr_provider", 1, bMultiview, bBindless ) ) )
+				return ERunResult::NoRuntime;
+
+			if ( ( bMultiview && !pRender->IsMultiviewSupported() ) || pRender->IsBindlessEnabled() != bBindless )
+				return ERunResult::NotSupported;
+
+			// (3) Session and swapchains - multiview renders both eyes into the layers of a single swapchain
+			if ( !XR_UNQUALIFIED_SUCCESS( pProvider->CreateSession( pRender->GetVulkanGraphicsBinding() ) ) )
+				return ERunResult::Failed;
+
+			pSession = pProvider->Session();
+			oxr::TextureFormats selectedTextureFormats { VK_FORMAT_UNDEFINED, VK_FORMAT_UNDEFINED };
+			const std::vector< int64_t > vecColorFormats { VK_FORMAT_R8G8B8A8_UNORM, VK_FORMAT_B8G8R8A8_UNORM, VK_FORMAT_R8G8B8A8_SRGB, VK_FORMAT_B8G8R8A8_SRGB };
+			const std::vector< int64_t > vecDepthFormats { VK_FORMAT_D32_SFLOAT, VK_FORMAT_D24_UNORM_S8_UINT };
+
+			XrResult xrResult = bMultiview ? pSession->CreateSwapchains( &selectedTextureFormats, vecColorFormats, vecDepthFormats, k_unRenderExtent, k_unRenderExtent, XR_VIEW_CONFIGURATION_TYPE_PRIMARY_STEREO, 1, 2 )
+										   : pSession->CreateSwapchains( &selectedTextureFormats, vecColorFormats, vecDepthFormats, k_unRenderExtent, k_unRenderExtent );
+			if ( !XR_UNQUALIFIED_SUCCESS( xrResult ) )
+				return ERunResult::Failed;
+
+			pRender->CreateRenderResources(
+				pSession, selectedTextureFormats.vkColorTextureFormat, selectedTextureFormats.vkDepthTextureFormat, { k_unRenderExtent, k_unRenderExtent }, xrvk::k_unCommandBufferNum, unRecordingThreads );
+			if ( pRender->IsMultiviewEnabled() != bMultiview )
+				return bMultiview ? ERunResult::NotSupported : ERunResult::Failed;
+
+			return ERunResult::Rendered;
+		}
+
+		/// <summary>
+		/// Registers the render callbacks and runs the session until it is focused. The scene's assets and pipelines must be loaded
+		/// </summary>
+		/// <returns>True if the session is focused and frames can be rendered</returns>
+		bool Begin()
+		{
+			preRenderCallback.fnCallback = PreRender_Callback;
+			pSession->RegisterWaitSwapchainImageImageCallback( &preRenderCallback );
+
+			postRenderCallback.fnCallback = PostRender_Callback;
+			pSession->RegisterWaitSwapchainImageImageCallback( &postRenderCallback );
+
+			if ( !PollUntilState( pProvider.get(), XR_SESSION_STATE_READY ) || !XR_UNQUALIFIED_SUCCESS( pSession->Begin() ) )
+				return false;
+
+			bRunning = true;
+			g_pRender = pRender.get();
+			g_pSession = pSession;
+
+			return PollUntilState( pProvider.get(), XR_SESSION_STATE_FOCUSED );
+		}
+
+		/// <summary>
+		/// Renders and submits one frame, returns once its gpu work is complete
+		/// </summary>
+		void RenderFrame()
+		{
+			pProvider->PollXrEvents();
+			g_vecFrameLayerProjectionViews.clear();
+			pSession->RenderFrame( g_vecFrameLayerProjectionViews, &g_xrFrameState );
+		}
+
+		/// <summary>
+		/// Ends the session if it was begun - the provider (and its swapchains) still go before the renderer
+		/// </summary>
+		void End()
+		{
+			if ( !bRunning )
+				return;
+
+			EndSession( pProvider.get() );
+			bRunning = false;
+			g_pRender = nullptr;
+			g_pSession = nullptr;
+		}
+	};
+
+	/// <summary>
+	/// Renders the test scene for a few frames on a fresh instance and session, then reads back the last frame's views
+	/// </summary>
+	/// <param name="pccAppName">Application name for the instance</param>
+	/// <param name="bMultiview">Render all views in a single pass into a single two layer swapchain</param>
+	/// <param name="bBindless">Use the bindless material table instead of a descriptor set per material</param>
+	/// <param name="vecEyes">Output, the last frame's image per eye</param>
+	/// <returns>Whether the scene was rendered, or why it couldn't be</returns>
+	inline ERunResult RenderScene( const char *pccAppName, bool bMultiview, bool bBindless, std::vector< EyeImage > &vecEyes )
+	{
+		// (1) Renderer on a new session
+		RenderSession session;
+		const ERunResult eResult = session.Init( pccAppName, bMultiview, bBindless );
+		if ( eResult != ERunResult::Rendered )
+			return eResult;
+
+		xrvk::Render *pRender = session.pRender.get();
+
+		// (2) Scene - a pbr model in front of the viewer and shapes at different depths and sides so the eyes see different parallax
+		pRender->AddRenderScene( "models/floor_spot.glb", { 0.5f, 0.5f, 0.5f } );
+		pRender->vecRenderScenes.back()->currentPose.position = { 0.0f, -0.5f, -1.5f };
+
+		pRender->LoadAssets();
+		pRender->PrepareAllPipelines();
+
+		Shapes::Shape cube;
+		cube.vecIndices = &g_vecCubeIndices;
+		cube.vecVertices = &g_vecCubeVertices;
+		pRender->PrepareShapesPipeline( &cube, "shaders/shape.vert.spv", "shaders/shape.frag.spv" );
+
+		const XrVector3f arrPositions[] = { { -0.3f, 0.1f, -0.6f }, { 0.25f, 0.0f, -1.0f }, { 0.0f, 0.3f, -2.5f } };
+		for ( auto &position : arrPositions )
+		{
+			Shapes::Shape *pShape = cube.Duplicate();
+			XrPosef_Identity( &pShape->pose );
+			pShape->pose.position = position;
+			pShape->pose.orientation = { 0.2f, 0.3f, 0.0f, 0.93f };
+			pRender->AddShape( pShape, { 0.2f, 0.2f, 0.2f } );
+		}
+
+		// (3) Run the session and render
+		if ( !session.Begin() )
+			return ERunResult::Failed;
+
+		for ( uint32_t i = 0; i < k_unRenderFrames; i++ )
+			session.RenderFrame();
+
+		return ReadSubmittedViews( pRender->GetSharedState(), vecEyes ) ? ERunResult::Rendered : ERunResult::Failed;
+	}
+
+	/// <summary>
+	/// Counts the pixels of two images that differ by more than the tolerance in any channel
+	/// </summary>
+	inline size_t CountMismatchedPixels( const EyeImage &a, const EyeImage &b )
+	{
+		size_t unMismatched = 0;
+		for ( size_t i = 0; i < a.vecTexels.size(); i += 4 )
+		{
+			for ( size_t c = 0; c < 4; c++ )
+			{
+				if ( static_cast< uint32_t >( std::abs( int( a.vecTexels[ i + c ] ) - int( b.vecTexels[ i + c ] ) ) ) > k_unChannelTolerance )
+				{
+					unMismatched++;
+					break;
+				}
+			}
+		}
+
+		return unMismatched;
+	}
+
+	/// <summary>
+	/// Counts the pixels that differ from the clear color (the first pixel is in an empty corner of the scene)
+	/// </summary>
+	inline size_t CountDrawnPixels( const EyeImage &eye )
+	{
+		size_t unDrawn = 0;
+		for ( size_t i = 4; i < eye.vecTexels.size(); i += 4 )
+		{
+			if ( std::memcmp( &eye.vecTexels[ i ], &eye.vecTexels[ 0 ], 4 ) != 0 )
+				unDrawn++;
+		}
+
+		return unDrawn;
+	}
+	/// <summary>
+	/// Checks that two runs produced the same image per eye (within tolerance) and that the scene covers part of each view
+	/// </summary>
+	/// <param name="pccTestName">Name of the test executable, for the report</param>
+	/// <param name="vecReference">Images of the reference run</param>
+	/// <param name="vecCandidate">Images of the run under test</param>
+	/// <returns>True if both runs submitted two equally sized views, whether or not the pixels matched</returns>
+	inline bool CheckSameEyes( const char *pccTestName, const std::vector< EyeImage > &vecReference, const std::vector< EyeImage > &vecCandidate )
+	{
+		if ( !OXR_CHECK( vecReference.size() == 2 ) || !OXR_CHECK( vecCandidate.size() == 2 ) )
+			return false;
+
+		for ( size_t unEye = 0; unEye < 2; unEye++ )
+		{
+			const EyeImage &reference = vecReference[ unEye ];
+			const EyeImage &candidate = vecCandidate[ unEye ];
+
+			if ( !OXR_CHECK( reference.unWidth == candidate.unWidth && reference.unHeight == candidate.unHeight ) )
+				return false;
+
+			const size_t unPixels = size_t( reference.unWidth ) * reference.unHeight;
+			const size_t unMismatched = CountMismatchedPixels( reference, candidate );
+			std::printf( "[%s] eye %zu: %zu of %zu pixels differ\n", pccTestName, unEye, unMismatched, unPixels );
+
+			// The scene must actually cover part of the view, otherwise two cleared images would pass
+			OXR_CHECK( CountDrawnPixels( reference ) > unPixels / 100 );
+			OXR_CHECK( double( unMismatched ) <= double( unPixels ) * k_dMaxMismatchRatio );
+		}
+
+		return true;
+	}
+
+	/// <summary>
+	/// Switches to the render test assets directory and sets up the mock runtime so every run sees the same views
+	/// </summary>
+	/// <returns>False if the assets directory wasn't found</returns>
+	inline bool PrepareRenderTest()
+	{
+		// Shaders and models are loaded relative to the working directory
+		std::error_code ec;
+		std::filesystem::current_path( OXR_TEST_ASSETS_DIRECTORY, ec );
+		if ( ec )
+			return false;
+
+		// Unthrottled, with the head at the origin
+		oxr::mock::Config config = oxr::mock::GetConfig();
+		config.fDisplayRate = 0.0f;
+		config.unRecommendedWidth = k_unRenderExtent;
+		config.unRecommendedHeight = k_unRenderExtent;
+		oxr::mock::SetConfig( config );
+
+		XrPosef xrHeadPose;
+		XrPosef_Identity( &xrHeadPose );
+		oxr::mock::SetHeadPose( xrHeadPose );
+
+		return true;
+	}
+
+} // namespace oxr::test
@@ -0,0 +1,154 @@
+/* Copyright 2021, 2022, 2023 Rune Berg (GitHub: https://github.com/1runeberg, Twitter: https://twitter.com/1runeberg, YouTube: https://www.youtube.com/@1RuneBerg)
+ *
+ *  SPDX-License-Identifier: MIT
+ *
+ *  Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+ *
+ *  2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *
+ *  3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote products derived from this
+ *     software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ *  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+ *  BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ *  GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+ *  DAMAGE.
+ *
+ */
+
+// Animation sampler evaluation - keyframe cursor reuse and seeks, LINEAR/STEP clamping and CUBICSPLINE (Hermite) interpolation.
+
+#include <cmath>
+
+#include "test_common.hpp"
+#include "xrvk/vulkanpbr/VulkanglTFModel.h"
+
+namespace
+{
+	const char *k_pccTestName = "test_animation_sampler";
+
+	const float k_fEpsilon = 1e-4f;
+
+	bool Near( float fA, float fB ) { return std::fabs( fA - fB ) < k_fEpsilon; }
+
+	vkglTF::AnimationSampler CreateSampler( vkglTF::AnimationSampler::InterpolationType interpolation, std::vector< float > vecInputs, std::vector< glm::vec4 > vecOutputs )
+	{
+		vkglTF::AnimationSampler sampler {};
+		sampler.interpolation = interpolation;
+		sampler.inputs = std::move( vecInputs );
+		sampler.outputsVec4 = std::move( vecOutputs );
+		return sampler;
+	}
+
+	void TestKeyframeCursor()
+	{
+		// 1000 keyframes, 0.1s apart
+		std::vector< float > vecInputs;
+		std::vector< glm::vec4 > vecOutputs;
+		for ( uint32_t i = 0; i < 1000; i++ )
+		{
+			vecInputs.push_back( i * 0.1f );
+			vecOutputs.push_back( glm::vec4( static_cast< float >( i ) ) );
+		}
+
+		vkglTF::AnimationSampler sampler = CreateSampler( vkglTF::AnimationSampler::LINEAR, vecInputs, vecOutputs );
+		OXR_CHECK( sampler.isValid() );
+
+		// (1) Playback that stays on the cached keyframe or moves to the next one keeps the cursor in step
+		size_t unCursor = 0;
+		OXR_CHECK( sampler.findKeyframe( 0.05f, unCursor ) == 0 && unCursor == 0 );
+		OXR_CHECK( sampler.findKeyframe( 0.15f, unCursor ) == 1 && unCursor == 1 );
+		OXR_CHECK( sampler.findKeyframe( 0.25f, unCursor ) == 2 && unCursor == 2 );
+
+		// (2) Seeks forward and loops back to the start are found by the binary search
+		OXR_CHECK( sampler.findKeyframe( 50.05f, unCursor ) == 500 && unCursor == 500 );
+		OXR_CHECK( sampler.findKeyframe( 0.05f, unCursor ) == 0 && unCursor == 0 );
+
+		// (3) Times outside the clip clamp to the first and last pair of keyframes
+		OXR_CHECK( sampler.findKeyframe( -1.0f, unCursor ) == 0 );
+		OXR_CHECK( sampler.findKeyframe( 1000.0f, unCursor ) == 998 );
+
+		// (4) A stale cursor past the end is clamped rather than read out of bounds
+		unCursor = 5000;
+		OXR_CHECK( sampler.findKeyframe( 99.95f, unCursor ) == 998 );
+	}
+
+	void TestLinearAndStep()
+	{
+		std::vector< float > vecInputs = { 0.0f, 1.0f, 2.0f };
+		std::vector< glm::vec4 > vecOutputs = { glm::vec4( 0.0f ), glm::vec4( 10.0f ), glm::vec4( 30.0f ) };
+
+		// (1) LINEAR interpolates between keyframes and holds the end values outside the clip
+		vkglTF::AnimationSampler linear = CreateSampler( vkglTF::AnimationSampler::LINEAR, vecInputs, vecOutputs );
+		size_t unCursor = 0;
+		OXR_CHECK( Near( linear.evaluate( 0.5f, unCursor, false ).x, 5.0f ) );
+		OXR_CHECK( Near( linear.evaluate( 1.25f, unCursor, false ).x, 15.0f ) );
+		OXR_CHECK( Near( linear.evaluate( -1.0f, unCursor, false ).x, 0.0f ) );
+		OXR_CHECK( Near( linear.evaluate( 5.0f, unCursor, false ).x, 30.0f ) );
+
+		// (2) STEP holds each keyframe's value until the next one
+		vkglTF::AnimationSampler step = CreateSampler( vkglTF::AnimationSampler::STEP, vecInputs, vecOutputs );
+		unCursor = 0;
+		OXR_CHECK( Near( step.evaluate( 0.99f, unCursor, false ).x, 0.0f ) );
+		OXR_CHECK( Near( step.evaluate( 1.5f, unCursor, false ).x, 10.0f ) );
+		OXR_CHECK( Near( step.evaluate( 2.0f, unCursor, false ).x, 30.0f ) );
+
+		// (3) LINEAR rotations are slerped - halfway through a 90 degree turn about y is a 45 degree turn
+		std::vector< glm::vec4 > vecRotations = { glm::vec4( 0.0f, 0.0f, 0.0f, 1.0f ), glm::vec4( 0.0f, std::sin( glm::radians( 45.0f ) ), 0.0f, std::cos( glm::radians( 45.0f ) ) ) };
+		vkglTF::AnimationSampler rotation = CreateSampler( vkglTF::AnimationSampler::LINEAR, { 0.0f, 1.0f }, vecRotations );
+		unCursor = 0;
+		glm::vec4 halfway = rotation.evaluate( 0.5f, unCursor, true );
+		OXR_CHECK( Near( glm::length( halfway ), 1.0f ) );
+		OXR_CHECK( Near( halfway.y, std::sin( glm::radians( 22.5f ) ) ) && Near( halfway.w, std::cos( glm::radians( 22.5f ) ) ) );
+	}
+
+	void TestCubicSpline()
+	{
+		// Cubic spline outputs are (in tangent, value, out tangent) per keyframe
+		std::vector< float > vecInputs = { 0.0f, 2.0f };
+
+		// (1) Endpoints return the keyframe values, flat tangents ease in and out through the midpoint
+		vkglTF::AnimationSampler flat = CreateSampler(
+			vkglTF::AnimationSampler::CUBICSPLINE, vecInputs, { glm::vec4( 0.0f ), glm::vec4( 0.0f ), glm::vec4( 0.0f ), glm::vec4( 0.0f ), glm::vec4( 4.0f ), glm::vec4( 0.0f ) } );
+		OXR_CHECK( flat.isValid() );
+
+		size_t unCursor = 0;
+		OXR_CHECK( Near( flat.evaluate( 0.0f, unCursor, false ).x, 0.0f ) );
+		OXR_CHECK( Near( flat.evaluate( 1.0f, unCursor, false ).x, 2.0f ) );
+		OXR_CHECK( Near( flat.evaluate( 2.0f, unCursor, false ).x, 4.0f ) );
+		OXR_CHECK( flat.evaluate( 0.5f, unCursor, false ).x < 1.0f ); // eases in, slower than linear (1.0)
+
+		// (2) Tangents are scaled by the keyframe delta - a slope of 2 per second over 2 seconds from 0 to 4 is a straight line
+		vkglTF::AnimationSampler line = CreateSampler(
+			vkglTF::AnimationSampler::CUBICSPLINE, vecInputs, { glm::vec4( 2.0f ), glm::vec4( 0.0f ), glm::vec4( 2.0f ), glm::vec4( 2.0f ), glm::vec4( 4.0f ), glm::vec4( 2.0f ) } );
+		unCursor = 0;
+		OXR_CHECK( Near( line.evaluate( 0.5f, unCursor, false ).x, 1.0f ) );
+		OXR_CHECK( Near( line.evaluate( 1.5f, unCursor, false ).x, 3.0f ) );
+
+		// (3) Rotations are normalized
+		glm::vec4 qIdentity( 0.0f, 0.0f, 0.0f, 1.0f );
+		glm::vec4 qTurn( 0.0f, 1.0f, 0.0f, 0.0f );
+		vkglTF::AnimationSampler rotation
+			= CreateSampler( vkglTF::AnimationSampler::CUBICSPLINE, vecInputs, { glm::vec4( 0.0f ), qIdentity, glm::vec4( 0.0f ), glm::vec4( 0.0f ), qTurn, glm::vec4( 0.0f ) } );
+		unCursor = 0;
+		OXR_CHECK( Near( glm::length( rotation.evaluate( 1.0f, unCursor, true ) ), 1.0f ) );
+
+		// (4) Samplers without the three values per keyframe are rejected
+		vkglTF::AnimationSampler truncated = CreateSampler( vkglTF::AnimationSampler::CUBICSPLINE, vecInputs, { glm::vec4( 0.0f ), glm::vec4( 0.0f ), glm::vec4( 0.0f ) } );
+		OXR_CHECK( !truncated.isValid() );
+	}
+} // namespace
+
+int main( int argc, char *argv[] )
+{
+	TestKeyframeCursor();
+	TestLinearAndStep();
+	TestCubicSpline();
+
+	return oxr::test::Finish( k_pccTestName );
+}
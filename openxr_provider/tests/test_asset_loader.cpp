@@ -0,0 +1,178 @@
+/* Copyright 2021, 2022, 2023 Rune Berg (GitHub: https://github.com/1runeberg, Twitter: https://twitter.com/1runeberg, YouTube: https://www.youtube.com/@1RuneBerg)
+ *
+ *  SPDX-License-Identifier: MIT
+ *
+ *  Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+ *
+ *  2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *
+ *  3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote products derived from this
+ *     software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ *  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+ *  BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ *  GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+ *  DAMAGE.
+ *
+ */
+
+// Asset loader - loading many models at once runs on the loader's fixed pool (worker threads plus the upload thread), the process
+// never gains more threads than that however many loads are queued, and every thread is gone once the loader is destroyed.
+
+#include <algorithm>
+#include <atomic>
+#include <filesystem>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "test_common.hpp"
+#include "xrvk/asset_loader.hpp"
+#include "xrvk/memory_allocator.hpp"
+#include "xrvk/upload_manager.hpp"
+
+namespace
+{
+	const char *k_pccTestName = "test_asset_loader";
+	const char *k_pccTexturedModel = OXR_TEST_ASSETS_DIRECTORY "/models/floor_spot.glb";
+	const char *k_pccUntexturedModel = OXR_TEST_ASSETS_DIRECTORY "/models/Box.glb";
+
+	const uint32_t k_unModels = 50;
+	const uint32_t k_unWorkerThreads = 2;
+
+	/// <summary>
+	/// Counts the threads of this process
+	/// </summary>
+	uint32_t CountThreads()
+	{
+		uint32_t unCount = 0;
+		std::error_code ec;
+		for ( std::filesystem::directory_iterator it( "/proc/self/task", ec ), end; !ec && it != end; it.increment( ec ) )
+			unCount++;
+
+		return unCount;
+	}
+
+	/// <summary>
+	/// Samples the process thread count on a thread of its own until stopped, keeping the highest count seen
+	/// </summary>
+	struct ThreadCountSampler
+	{
+		std::atomic< bool > bStop { false };
+		std::atomic< uint32_t > unPeak { 0 };
+		std::thread sampler;
+
+		void Start()
+		{
+			sampler = std::thread(
+				[ this ]()
+				{
+					while ( !bStop.load() )
+					{
+						unPeak = std::max( unPeak.load(), CountThreads() );
+						std::this_thread::sleep_for( std::chrono::microseconds( 200 ) );
+					}
+				} );
+		}
+
+		uint32_t Stop()
+		{
+			bStop = true;
+			sampler.join();
+			return unPeak.load();
+		}
+	};
+
+	void TestBoundedThreads( vks::VulkanDevice *pVulkanDevice, xrvk::UploadManager *pUploadManager )
+	{
+		// (1) Warm up - a first load lets the driver start any threads it creates lazily on the first submits
+		{
+			xrvk::AssetLoader warmupLoader( pVulkanDevice, pUploadManager, k_unWorkerThreads );
+
+			vkglTF::Model model;
+			xrvk::AssetHandle asset = warmupLoader.Load( k_pccTexturedModel, &model );
+			warmupLoader.WaitAll();
+			OXR_CHECK( asset->IsReady() );
+
+			model.destroy( pVulkanDevice->logicalDevice );
+		}
+
+		// (2) Baseline, with the sampler's own thread
+		ThreadCountSampler threadCount;
+		threadCount.Start();
+		const uint32_t unBaseline = CountThreads();
+
+		// (3) Queue every load at once on a fixed pool
+		std::unique_ptr< vkglTF::Model[] > pModels( new vkglTF::Model[ k_unModels ] );
+		uint32_t unReady = 0;
+		uint32_t unPoolSize = 0;
+		{
+			xrvk::AssetLoader loader( pVulkanDevice, pUploadManager, k_unWorkerThreads );
+			unPoolSize = loader.GetThreadCount();
+			OXR_CHECK( unPoolSize == k_unWorkerThreads + 1 );
+
+			std::vector< xrvk::AssetHandle > vecAssets;
+			for ( uint32_t i = 0; i < k_unModels; i++ )
+				vecAssets.push_back( loader.Load( i % 2 ? k_pccUntexturedModel : k_pccTexturedModel, &pModels[ i ] ) );
+
+			OXR_CHECK( loader.GetThreadCount() == unPoolSize );
+			loader.WaitAll();
+
+			for ( auto &asset : vecAssets )
+				unReady += asset->IsReady() ? 1 : 0;
+		}
+
+		// (4) Never more threads than the pool, and none left behind by the loader
+		const uint32_t unPeak = threadCount.Stop();
+		const uint32_t unAfter = CountThreads();
+		std::printf( "[%s] %u threads before loading, peak of %u while loading %u models on a pool of %u, %u after\n", k_pccTestName, unBaseline, unPeak, k_unModels, unPoolSize, unAfter );
+
+		OXR_CHECK( unReady == k_unModels );
+		OXR_CHECK( unPeak >= unBaseline && unPeak <= unBaseline + unPoolSize );
+		OXR_CHECK( unAfter < unBaseline ); // the sampler has stopped as well
+
+		for ( uint32_t i = 0; i < k_unModels; i++ )
+			pModels[ i ].destroy( pVulkanDevice->logicalDevice );
+	}
+} // namespace
+
+int main( int argc, char *argv[] )
+{
+#ifndef __linux__
+	return oxr::test::Skip( k_pccTestName, "thread counts are read from /proc/self/task" );
+#else
+	if ( !std::filesystem::exists( k_pccTexturedModel ) || !std::filesystem::exists( k_pccUntexturedModel ) )
+		return oxr::test::Skip( k_pccTestName, "test assets not found" );
+
+	oxr::test::VulkanContext vulkan;
+	if ( !vulkan.Create( k_pccTestName ) )
+		return oxr::test::Skip( k_pccTestName, "no vulkan device available" );
+
+	{
+		// The context owns the logical device, the loader only needs the vks device for buffer and image creation and its memory allocator
+		vks::VulkanDevice vulkanDevice( vulkan.vkPhysicalDevice );
+		vulkanDevice.logicalDevice = vulkan.vkDevice;
+
+		xrvk::MemoryAllocator allocator( vulkan.vkPhysicalDevice, vulkan.vkDevice );
+		vulkanDevice.memoryAllocator = &allocator;
+
+		// Uploads go through the context's only queue, so there are no queue family transfers
+		VkQueue vkQueue = VK_NULL_HANDLE;
+		vkGetDeviceQueue( vulkan.vkDevice, 0, 0, &vkQueue );
+
+		{
+			xrvk::UploadManager uploadManager( &vulkanDevice, vkQueue, 0, 0, false );
+			TestBoundedThreads( &vulkanDevice, &uploadManager );
+		}
+
+		vulkanDevice.logicalDevice = VK_NULL_HANDLE;
+	}
+
+	return oxr::test::Finish( k_pccTestName );
+#endif
+}
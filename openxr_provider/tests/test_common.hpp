@@ -0,0 +1,204 @@
+/* Copyright 2021, 2022, 2023 Rune Berg (GitHub: https://github.com/1runeberg, Twitter: https://twitter.com/1runeberg, YouTube: https://www.youtube.com/@1RuneBerg)
+ *
+ *  SPDX-License-Identifier: MIT
+ *
+ *  Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+ *
+ *  2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *
+ *  3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote products derived from this
+ *     software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ *  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+ *  BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ *  GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+ *  DAMAGE.
+ *
+ */
+
+
+#pragma once
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+
+#include <openxr_provider.h>
+
+#include "mock_runtime.hpp"
+
+// Minimal test harness shared by the provider tests. Each test is its own executable registered with ctest,
+// failures are counted and reported through the process exit code
+namespace oxr::test
+{
+	// Exit code ctest treats as a skipped test (see SKIP_RETURN_CODE), e.g. when the mock runtime can't be loaded
+	static const int k_nSkipReturnCode = 77;
+
+	inline int g_nChecks = 0;
+	inline int g_nFailures = 0;
+
+	inline bool Check( bool bPassed, const char *pccExpression, const char *pccFile, int nLine )
+	{
+		g_nChecks++;
+		if ( !bPassed )
+		{
+			g_nFailures++;
+			std::fprintf( stderr, "%s(%i): check failed: %s\n", pccFile, nLine, pccExpression );
+		}
+
+		return bPassed;
+	}
+
+	/// <summary>
+	/// Prints the check summary and returns the test's exit code
+	/// </summary>
+	/// <param name="pccTestName">Name of the test executable</param>
+	/// <returns>0 if all checks passed, 1 otherwise</returns>
+	inline int Finish( const char *pccTestName )
+	{
+		std::printf( "[%s] %i checks, %i failures\n", pccTestName, g_nChecks, g_nFailures );
+		return g_nFailures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+	}
+
+	/// <summary>
+	/// Skips the test with a reason
+	/// </summary>
+	/// <param name="pccTestName">Name of the test executable</param>
+	/// <param name="pccReason">Why the test can't run in this environment</param>
+	/// <returns>The skip exit code</returns>
+	inline int Skip( const char *pccTestName, const char *pccReason )
+	{
+		std::printf( "[%s] skipped: %s\n", pccTestName, pccReason );
+		return k_nSkipReturnCode;
+	}
+
+	/// <summary>
+	/// Vulkan instance and logical device (one queue of family 0) for tests that need device memory but no session
+	/// </summary>
+	struct VulkanContext
+	{
+		VkInstance vkInstance = VK_NULL_HANDLE;
+		VkPhysicalDevice vkPhysicalDevice = VK_NULL_HANDLE;
+		VkDevice vkDevice = VK_NULL_HANDLE;
+
+		~VulkanContext()
+		{
+			if ( vkDevice != VK_NULL_HANDLE )
+				vkDestroyDevice( vkDevice, nullptr );
+
+			if ( vkInstance != VK_NULL_HANDLE )
+				vkDestroyInstance( vkInstance, nullptr );
+		}
+
+		/// <summary>
+		/// Creates the instance and a logical device on the first physical device
+		/// </summary>
+		/// <param name="pccAppName">Application name for the instance</param>
+		/// <returns>False if no vulkan device is available</returns>
+		bool Create( const char *pccAppName )
+		{
+			VkApplicationInfo vkApplicationInfo { VK_STRUCTURE_TYPE_APPLICATION_INFO };
+			vkApplicationInfo.pApplicationName = pccAppName;
+			vkApplicationInfo.apiVersion = VK_API_VERSION_1_1;
+
+			VkInstanceCreateInfo vkInstanceCreateInfo { VK_STRUCTURE_TYPE_INSTANCE_CREATE_INFO };
+			vkInstanceCreateInfo.pApplicationInfo = &vkApplicationInfo;
+			if ( vkCreateInstance( &vkInstanceCreateInfo, nullptr, &vkInstance ) != VK_SUCCESS )
+				return false;
+
+			uint32_t unCount = 1;
+			VkResult vkResult = vkEnumeratePhysicalDevices( vkInstance, &unCount, &vkPhysicalDevice );
+			if ( ( vkResult != VK_SUCCESS && vkResult != VK_INCOMPLETE ) || unCount == 0 )
+				return false;
+
+			float fPriority = 1.0f;
+			VkDeviceQueueCreateInfo vkQueueCreateInfo { VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO };
+			vkQueueCreateInfo.queueFamilyIndex = 0;
+			vkQueueCreateInfo.queueCount = 1;
+			vkQueueCreateInfo.pQueuePriorities = &fPriority;
+
+			VkDeviceCreateInfo vkDeviceCreateInfo { VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO };
+			vkDeviceCreateInfo.queueCreateInfoCount = 1;
+			vkDeviceCreateInfo.pQueueCreateInfos = &vkQueueCreateInfo;
+			return vkCreateDevice( vkPhysicalDevice, &vkDeviceCreateInfo, nullptr, &vkDevice ) == VK_SUCCESS;
+		}
+	};
+
+	inline int64_t NowNs() { return std::chrono::duration_cast< std::chrono::nanoseconds >( std::chrono::steady_clock::now().time_since_epoch() ).count(); }
+
+	/// <summary>
+	/// Polls openxr events until the session reaches the given state
+	/// </summary>
+	/// <param name="pProvider">Provider with an active session</param>
+	/// <param name="xrState">Session state to wait for</param>
+	/// <returns>True if the state was reached before the event queue ran dry</returns>
+	inline bool PollUntilState( oxr::Provider *pProvider, XrSessionState xrState )
+	{
+		while ( pProvider->Session()->GetState() != xrState )
+		{
+			if ( !pProvider->PollXrEvents() )
+				return false;
+		}
+
+		return true;
+	}
+
+	/// <summary>
+	/// Creates an openxr instance and a headless session on the mock runtime and runs it up to the FOCUSED state
+	/// </summary>
+	/// <param name="pccAppName">Application name for the instance</param>
+	/// <param name="vecExtensions">Instance extensions to enable</param>
+	/// <returns>The provider, or nullptr if the mock runtime couldn't be loaded</returns>
+	inline std::unique_ptr< oxr::Provider > CreateFocusedHeadlessSession( const char *pccAppName, std::vector< const char * > vecExtensions = {} )
+	{
+		auto pProvider = std::make_unique< oxr::Provider >( oxr::ELogLevel::LogWarning );
+
+		oxr::AppInstanceInfo appInstanceInfo {};
+		appInstanceInfo.sAppName = pccAppName;
+		appInstanceInfo.unAppVersion = OXR_MAKE_VERSION32( 0, 1, 0 );
+		appInstanceInfo.sEngineName = "openxr_provider";
+		appInstanceInfo.unEngineVersion = OXR_MAKE_VERSION32( PROVIDER_VERSION_MAJOR, PROVIDER_VERSION_MINOR, PROVIDER_VERSION_PATCH );
+		appInstanceInfo.vecInstanceExtensions = vecExtensions;
+
+		if ( !XR_UNQUALIFIED_SUCCESS( pProvider->Init( &appInstanceInfo ) ) )
+			return nullptr;
+
+		// Headless - the mock runtime accepts sessions without a graphics binding
+		XrSessionCreateInfo xrSessionCreateInfo { XR_TYPE_SESSION_CREATE_INFO };
+		xrSessionCreateInfo.systemId = pProvider->GetOpenXrSystemId();
+		if ( !XR_UNQUALIFIED_SUCCESS( pProvider->CreateSession( &xrSessionCreateInfo ) ) )
+			return nullptr;
+
+		if ( !PollUntilState( pProvider.get(), XR_SESSION_STATE_READY ) || !XR_UNQUALIFIED_SUCCESS( pProvider->Session()->Begin() ) )
+			return nullptr;
+
+		if ( !PollUntilState( pProvider.get(), XR_SESSION_STATE_FOCUSED ) )
+			return nullptr;
+
+		return pProvider;
+	}
+
+	/// <summary>
+	/// Stops and ends a running session on the mock runtime
+	/// </summary>
+	/// <param name="pProvider">Provider with a running session</param>
+	/// <returns>True if the session reached the IDLE state</returns>
+	inline bool EndSession( oxr::Provider *pProvider )
+	{
+		oxr::mock::RequestSessionStop();
+		if ( !PollUntilState( pProvider, XR_SESSION_STATE_STOPPING ) )
+			return false;
+
+		pProvider->Session()->End();
+		return PollUntilState( pProvider, XR_SESSION_STATE_IDLE );
+	}
+
+} // namespace oxr::test
+
+#define OXR_CHECK( expression ) oxr::test::Check( ( expression ), #expression, __FILE__, __LINE__ )
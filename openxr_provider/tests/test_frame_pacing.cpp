@@ -0,0 +1,143 @@
+/* Copyright 2021, 2022, 2023 Rune Berg (GitHub: https://github.com/1runeberg, Twitter: https://twitter.com/1runeberg, YouTube: https://www.youtube.com/@1RuneBerg)
+ *
+ *  SPDX-License-Identifier: MIT
+ *
+ *  Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+ *
+ *  2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *
+ *  3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote products derived from this
+ *     software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ *  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+ *  BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ *  GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+ *  DAMAGE.
+ *
+ */
+
+
+// Frame throughput of the inline and pipelined (frame pacing thread) frame loops on the mock runtime.
+//
+// The mock paces xrWaitFrame to a 250Hz display and the app spends 5ms of cpu time per frame (longer than the display period).
+// Inline, every frame waits for the next display period after its work is done, so frames take two periods (8ms). Pipelined,
+// the wait for frame N+1 overlaps the work of frame N, so frames are only bound by the work (5ms).
+
+#include <thread>
+
+#include "test_common.hpp"
+
+namespace
+{
+	const char *k_pccTestName = "test_frame_pacing";
+	const float k_fDisplayRate = 250.0f;
+	const std::chrono::microseconds k_AppWork( 5000 );
+	const uint32_t k_unWarmupFrames = 10;
+	const uint32_t k_unMeasuredFrames = 200;
+
+	struct FrameLoopResult
+	{
+		double dFramesPerSecond = 0.0;
+		bool bDisplayTimesIncreasing = true;
+	};
+
+	FrameLoopResult RunFrameLoop( oxr::Session *pSession, bool bPipelined )
+	{
+		FrameLoopResult result;
+		if ( bPipelined )
+		{
+			OXR_CHECK( pSession->StartFramePacing() == XR_SUCCESS );
+			OXR_CHECK( pSession->IsFramePacingActive() );
+		}
+
+		XrFrameState xrFrameState { XR_TYPE_FRAME_STATE };
+		XrTime xrLastDisplayTime = 0;
+		int64_t nStartNs = 0;
+
+		for ( uint32_t i = 0; i < k_unWarmupFrames + k_unMeasuredFrames; i++ )
+		{
+			if ( i == k_unWarmupFrames )
+				nStartNs = oxr::test::NowNs();
+
+			pSession->RenderHeadlessFrame( &xrFrameState );
+
+			// Every frame must be a new one from the runtime
+			if ( xrFrameState.predictedDisplayTime <= xrLastDisplayTime )
+				result.bDisplayTimesIncreasing = false;
+			xrLastDisplayTime = xrFrameState.predictedDisplayTime;
+
+			// Simulated app work (input, simulation, command recording)
+			std::this_thread::sleep_for( k_AppWork );
+		}
+
+		const int64_t nElapsedNs = oxr::test::NowNs() - nStartNs;
+		result.dFramesPerSecond = k_unMeasuredFrames * 1e9 / ( double )nElapsedNs;
+
+		if ( bPipelined )
+		{
+			pSession->StopFramePacing();
+			OXR_CHECK( !pSession->IsFramePacingActive() );
+		}
+
+		return result;
+	}
+
+	void CheckFrameCounters( const char *pccLoop )
+	{
+		// Every waited frame was begun, every begun frame was ended, and the runtime saw no call order errors
+		const oxr::mock::Stats stats = oxr::mock::GetStats();
+		std::printf( "[%s] %s: wait (%llu) begin (%llu) end (%llu) discarded (%llu) errors (%llu)\n", k_pccTestName, pccLoop, ( unsigned long long )stats.unWaitFrameCalls,
+					 ( unsigned long long )stats.unBeginFrameCalls, ( unsigned long long )stats.unEndFrameCalls, ( unsigned long long )stats.unDiscardedFrames, ( unsigned long long )stats.unErrors );
+
+		OXR_CHECK( stats.unWaitFrameCalls == stats.unBeginFrameCalls );
+		OXR_CHECK( stats.unBeginFrameCalls == stats.unEndFrameCalls );
+		OXR_CHECK( stats.unEndFrameCalls >= k_unWarmupFrames + k_unMeasuredFrames );
+		OXR_CHECK( stats.unDiscardedFrames == 0 );
+		OXR_CHECK( stats.unErrors == 0 );
+	}
+} // namespace
+
+int main( int argc, char *argv[] )
+{
+	oxr::mock::Config config;
+	config.fDisplayRate = k_fDisplayRate;
+	oxr::mock::SetConfig( config );
+
+	std::unique_ptr< oxr::Provider > pProvider = oxr::test::CreateFocusedHeadlessSession( k_pccTestName );
+	if ( !pProvider )
+		return oxr::test::Skip( k_pccTestName, "unable to start a session on the mock runtime (is XR_RUNTIME_JSON set?)" );
+
+	oxr::Session *pSession = pProvider->Session();
+
+	// (1) Inline frame loop
+	oxr::mock::ResetStats();
+	const FrameLoopResult inlineResult = RunFrameLoop( pSession, false );
+	OXR_CHECK( inlineResult.bDisplayTimesIncreasing );
+	CheckFrameCounters( "inline" );
+
+	// (2) Pipelined frame loop
+	oxr::mock::ResetStats();
+	const FrameLoopResult pipelinedResult = RunFrameLoop( pSession, true );
+	OXR_CHECK( pipelinedResult.bDisplayTimesIncreasing );
+	CheckFrameCounters( "pipelined" );
+
+	// (3) Pipelining must recover most of the period lost inline - 1.6x in theory, allow for scheduler noise
+	std::printf( "[%s] throughput: inline (%.1f fps) pipelined (%.1f fps)\n", k_pccTestName, inlineResult.dFramesPerSecond, pipelinedResult.dFramesPerSecond );
+	OXR_CHECK( pipelinedResult.dFramesPerSecond > inlineResult.dFramesPerSecond * 1.2 );
+
+	// (4) Restarting after a stop works and leaves no frame open
+	oxr::mock::ResetStats();
+	OXR_CHECK( pSession->StartFramePacing() == XR_SUCCESS );
+	pSession->StopFramePacing();
+	const oxr::mock::Stats stats = oxr::mock::GetStats();
+	OXR_CHECK( stats.unBeginFrameCalls == stats.unEndFrameCalls );
+	OXR_CHECK( stats.unErrors == 0 );
+
+	OXR_CHECK( oxr::test::EndSession( pProvider.get() ) );
+	return oxr::test::Finish( k_pccTestName );
+}
@@ -0,0 +1,92 @@
+/* Copyright 2021, 2022, 2023 Rune Berg (GitHub: https://github.com/1runeberg, Twitter: https://twitter.com/1runeberg, YouTube: https://www.youtube.com/@1RuneBerg)
+ *
+ *  SPDX-License-Identifier: MIT
+ *
+ *  Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+ *
+ *  2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *
+ *  3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote products derived from this
+ *     software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ *  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+ *  BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ *  GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+ *  DAMAGE.
+ *
+ */
+
+// Binding paths and interaction profiles - malformed binding paths are rejected when added, and the current interaction profile is an interned c string.
+
+#include <cstring>
+
+#include "test_common.hpp"
+
+namespace
+{
+	const char *k_pccTestName = "test_input_bindings";
+
+	void NoCallback( oxr::Action *, uint32_t ) {}
+
+	void TestBindings( oxr::Provider *pProvider )
+	{
+		// (1) One float action on both hands
+		oxr::Input *pInput = pProvider->Input();
+		oxr::ActionSet actionSet;
+		OXR_CHECK( pInput->CreateActionSet( &actionSet, "test", "test actions" ) == XR_SUCCESS );
+
+		oxr::Action actionTrigger( XR_ACTION_TYPE_FLOAT_INPUT, &NoCallback );
+		OXR_CHECK( pInput->CreateAction( &actionTrigger, &actionSet, "trigger", "trigger", { "/user/hand/left", "/user/hand/right" } ) == XR_SUCCESS );
+
+		// (2) Malformed paths fail when added rather than being skipped silently when bindings are suggested
+		oxr::ValveIndex controller;
+		for ( const char *pccMalformed : { "", "/", "user/hand/left/input/trigger/value", "/user/hand/left/input/trigger/value/", "/user//hand/left/input/trigger/value",
+										   "/user/hand/left/input/Trigger/value", "/user/hand/left/input/../value", "/user/hand/left/input/trigger value" } )
+		{
+			OXR_CHECK( pInput->AddBinding( &controller, actionTrigger.xrActionHandle, pccMalformed ) == XR_ERROR_PATH_FORMAT_INVALID );
+		}
+
+		OXR_CHECK( controller.vecPendingBindings.empty() );
+
+		// (3) Well formed paths are accepted, including ones built from controller components
+		OXR_CHECK( pInput->AddBinding( &controller, actionTrigger.xrActionHandle, "/user/hand/left/input/trigger/value" ) == XR_SUCCESS );
+		OXR_CHECK( pInput->AddBinding( &controller, actionTrigger.xrActionHandle, XR_HAND_RIGHT_EXT, oxr::Controller::Component::Trigger, oxr::Controller::Qualifier::Value ) == XR_SUCCESS );
+		OXR_CHECK( controller.vecPendingBindings.size() == 2 );
+
+		OXR_CHECK( pInput->SuggestBindings( &controller, nullptr ) == XR_SUCCESS );
+		OXR_CHECK( controller.vecPendingBindings.empty() && controller.vecSuggestedBindings.size() == 2 );
+
+		pInput->Init( pProvider->Session() );
+		OXR_CHECK( pInput->AttachActionSetsToSession( &actionSet.xrActionSetHandle, 1 ) == XR_SUCCESS );
+
+		// (4) The current profile is a null terminated string owned by the path table - the same pointer on every call
+		const char *pccLeft = pInput->GetCurrentInteractionProfile( "/user/hand/left" );
+		const char *pccRight = pInput->GetCurrentInteractionProfile( "/user/hand/right" );
+		OXR_CHECK( pccLeft && std::strcmp( pccLeft, controller.Path() ) == 0 );
+		OXR_CHECK( pccLeft == pccRight );
+
+		// (5) User paths without a bound profile, and invalid user paths, give an empty string
+		const char *pccHead = pInput->GetCurrentInteractionProfile( "/user/head" );
+		OXR_CHECK( pccHead && pccHead[ 0 ] == '\0' );
+
+		const char *pccInvalid = pInput->GetCurrentInteractionProfile( "not a path" );
+		OXR_CHECK( pccInvalid && pccInvalid[ 0 ] == '\0' );
+	}
+} // namespace
+
+int main( int argc, char *argv[] )
+{
+	std::unique_ptr< oxr::Provider > pProvider = oxr::test::CreateFocusedHeadlessSession( k_pccTestName );
+	if ( !pProvider )
+		return oxr::test::Skip( k_pccTestName, "unable to start a session on the mock runtime (is XR_RUNTIME_JSON set?)" );
+
+	TestBindings( pProvider.get() );
+
+	OXR_CHECK( oxr::test::EndSession( pProvider.get() ) );
+	return oxr::test::Finish( k_pccTestName );
+}
@@ -0,0 +1,109 @@
+/* Copyright 2021, 2022, 2023 Rune Berg (GitHub: https://github.com/1runeberg, Twitter: https://twitter.com/1runeberg, YouTube: https://www.youtube.com/@1RuneBerg)
+ *
+ *  SPDX-License-Identifier: MIT
+ *
+ *  Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+ *
+ *  2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *
+ *  3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote products derived from this
+ *     software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ *  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+ *  BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ *  GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+ *  DAMAGE.
+ *
+ */
+
+// Deferred callback dispatch - a fast polling input thread queues pose callbacks only for active hands, one at a time, and nothing for unchanged inputs.
+
+#include <thread>
+
+#include "test_common.hpp"
+
+namespace
+{
+	const char *k_pccTestName = "test_input_deferred";
+
+	uint32_t g_unPoseCallbacks[ 2 ] = {};
+	uint32_t g_unTriggerCallbacks = 0;
+
+	void PoseCallback( oxr::Action *, uint32_t unActionStateIndex ) { g_unPoseCallbacks[ unActionStateIndex ]++; }
+	void TriggerCallback( oxr::Action *, uint32_t ) { g_unTriggerCallbacks++; }
+
+	void ResetCallbackCounts()
+	{
+		g_unPoseCallbacks[ 0 ] = g_unPoseCallbacks[ 1 ] = 0;
+		g_unTriggerCallbacks = 0;
+	}
+
+	void TestDeferredDispatch( oxr::Provider *pProvider )
+	{
+		// (1) A pose action on both hands, bound only on the left so the right hand stays inactive, and a trigger on the left hand
+		oxr::Input *pInput = pProvider->Input();
+		oxr::ActionSet actionSet;
+		OXR_CHECK( pInput->CreateActionSet( &actionSet, "test", "test actions" ) == XR_SUCCESS );
+
+		oxr::Action actionPose( XR_ACTION_TYPE_POSE_INPUT, &PoseCallback );
+		OXR_CHECK( pInput->CreateAction( &actionPose, &actionSet, "pose", "pose", { "/user/hand/left", "/user/hand/right" } ) == XR_SUCCESS );
+
+		oxr::Action actionTrigger( XR_ACTION_TYPE_FLOAT_INPUT, &TriggerCallback );
+		OXR_CHECK( pInput->CreateAction( &actionTrigger, &actionSet, "trigger", "trigger", { "/user/hand/left" } ) == XR_SUCCESS );
+
+		oxr::ValveIndex controller;
+		OXR_CHECK( pInput->AddBinding( &controller, actionPose.xrActionHandle, "/user/hand/left/input/aim/pose" ) == XR_SUCCESS );
+		OXR_CHECK( pInput->AddBinding( &controller, actionTrigger.xrActionHandle, "/user/hand/left/input/trigger/value" ) == XR_SUCCESS );
+		OXR_CHECK( pInput->SuggestBindings( &controller, nullptr ) == XR_SUCCESS );
+
+		pInput->Init( pProvider->Session() );
+		OXR_CHECK( pInput->AttachActionSetsToSession( &actionSet.xrActionSetHandle, 1 ) == XR_SUCCESS );
+		OXR_CHECK( pInput->AddActionsetForSync( &actionSet ) == XR_SUCCESS );
+
+		// (2) Poll much faster than callbacks are dispatched. Values only count as changed once an action was already active, so the
+		// trigger moves after the first syncs
+		OXR_CHECK( pInput->StartInputThread( 1000.0f, oxr::EInputCallbackDispatch::Deferred ) == XR_SUCCESS );
+		std::this_thread::sleep_for( std::chrono::milliseconds( 20 ) );
+		pInput->DispatchCallbacks();
+
+		oxr::mock::SetInputFloat( "/user/hand/left/input/trigger/value", 0.5f );
+		std::this_thread::sleep_for( std::chrono::milliseconds( 100 ) );
+
+		// (3) Many syncs ran, but only one left hand pose is waiting, the inactive right hand queued nothing and the trigger only its change
+		ResetCallbackCounts();
+		pInput->DispatchCallbacks();
+		OXR_CHECK( pInput->GetInputThreadStats().unProcessedFrames > 10 );
+		OXR_CHECK( g_unPoseCallbacks[ 0 ] == 1 );
+		OXR_CHECK( g_unPoseCallbacks[ 1 ] == 0 );
+		OXR_CHECK( g_unTriggerCallbacks == 1 );
+
+		// (4) Once dispatched, the active pose is queued again on the next sync - the unchanged trigger isn't
+		std::this_thread::sleep_for( std::chrono::milliseconds( 50 ) );
+		ResetCallbackCounts();
+		pInput->DispatchCallbacks();
+		OXR_CHECK( g_unPoseCallbacks[ 0 ] == 1 );
+		OXR_CHECK( g_unPoseCallbacks[ 1 ] == 0 );
+		OXR_CHECK( g_unTriggerCallbacks == 0 );
+
+		pInput->StopInputThread();
+		pInput->DispatchCallbacks();
+		OXR_CHECK( pInput->GetInputThreadStats().unDroppedCallbacks == 0 );
+	}
+} // namespace
+
+int main( int argc, char *argv[] )
+{
+	std::unique_ptr< oxr::Provider > pProvider = oxr::test::CreateFocusedHeadlessSession( k_pccTestName );
+	if ( !pProvider )
+		return oxr::test::Skip( k_pccTestName, "unable to start a session on the mock runtime (is XR_RUNTIME_JSON set?)" );
+
+	TestDeferredDispatch( pProvider.get() );
+
+	OXR_CHECK( oxr::test::EndSession( pProvider.get() ) );
+	return oxr::test::Finish( k_pccTestName );
+}
@@ -0,0 +1,199 @@
+/* Copyright 2021, 2022, 2023 Rune Berg (GitHub: https://github.com/1runeberg, Twitter: https://twitter.com/1runeberg, YouTube: https://www.youtube.com/@1RuneBerg)
+ *
+ *  SPDX-License-Identifier: MIT
+ *
+ *  Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+ *
+ *  2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *
+ *  3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote products derived from this
+ *     software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ *  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+ *  BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ *  GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+ *  DAMAGE.
+ *
+ */
+
+// Input event queue - SpscRing capacity, order and wrap around (single and two threads), and event resend after a full queue.
+
+#include <thread>
+
+#include "test_common.hpp"
+
+namespace
+{
+	const char *k_pccTestName = "test_input_events";
+
+	void NoCallback( oxr::Action *, uint32_t ) {}
+
+	void TestRingSingleThread()
+	{
+		oxr::SpscRing< uint32_t > ring;
+		uint32_t unValue = 0;
+
+		// (1) Unallocated rings reject everything
+		OXR_CHECK( !ring.IsAllocated() );
+		OXR_CHECK( !ring.Push( 1 ) );
+		OXR_CHECK( !ring.Pop( unValue ) );
+
+		// (2) Capacity is rounded up to a power of two, pushes fail while full and pops while empty
+		ring.Allocate( 5 );
+		OXR_CHECK( ring.IsAllocated() );
+		OXR_CHECK( !ring.Pop( unValue ) );
+
+		for ( uint32_t i = 0; i < 8; i++ )
+			OXR_CHECK( ring.Push( i ) );
+		OXR_CHECK( !ring.Push( 8 ) );
+
+		for ( uint32_t i = 0; i < 8; i++ )
+			OXR_CHECK( ring.Pop( unValue ) && unValue == i );
+		OXR_CHECK( !ring.Pop( unValue ) );
+
+		// (3) Items stay in order while the indices wrap around the buffer many times, with the ring at every fill level
+		uint32_t unNextPush = 0;
+		uint32_t unNextPop = 0;
+		bool bOrdered = true;
+		for ( uint32_t unRound = 0; unRound < 100; unRound++ )
+		{
+			const uint32_t unPushes = 1 + unRound % 8;
+			for ( uint32_t i = 0; i < unPushes; i++ )
+			{
+				if ( ring.Push( unNextPush ) )
+					unNextPush++;
+			}
+
+			const uint32_t unPops = 1 + ( unRound * 3 ) % 8;
+			for ( uint32_t i = 0; i < unPops && ring.Pop( unValue ); i++ )
+				bOrdered = bOrdered && unValue == unNextPop++;
+		}
+
+		while ( ring.Pop( unValue ) )
+			bOrdered = bOrdered && unValue == unNextPop++;
+
+		OXR_CHECK( bOrdered );
+		OXR_CHECK( unNextPop == unNextPush );
+		OXR_CHECK( unNextPush > 8 * 10 );
+
+		// (4) Reallocating empties the ring
+		OXR_CHECK( ring.Push( 1 ) );
+		ring.Allocate( 2 );
+		OXR_CHECK( !ring.Pop( unValue ) );
+	}
+
+	void TestRingTwoThreads()
+	{
+		// A small ring forces the producer to wait on the consumer constantly, every item must arrive once and in order
+		const uint32_t unItems = 1000000;
+		oxr::SpscRing< uint32_t > ring;
+		ring.Allocate( 16 );
+
+		std::thread threadProducer( [ & ] {
+			for ( uint32_t i = 0; i < unItems; i++ )
+			{
+				while ( !ring.Push( i ) )
+					std::this_thread::yield();
+			}
+		} );
+
+		uint32_t unExpected = 0;
+		bool bOrdered = true;
+		uint32_t unValue = 0;
+		while ( unExpected < unItems )
+		{
+			if ( !ring.Pop( unValue ) )
+			{
+				std::this_thread::yield();
+				continue;
+			}
+
+			bOrdered = bOrdered && unValue == unExpected;
+			unExpected++;
+		}
+
+		threadProducer.join();
+		OXR_CHECK( bOrdered );
+		OXR_CHECK( !ring.Pop( unValue ) );
+	}
+
+	void TestEventResend( oxr::Provider *pProvider )
+	{
+		// (1) One float action on both hands
+		oxr::Input *pInput = pProvider->Input();
+		oxr::ActionSet actionSet;
+		OXR_CHECK( pInput->CreateActionSet( &actionSet, "test", "test actions" ) == XR_SUCCESS );
+
+		oxr::Action actionTrigger( XR_ACTION_TYPE_FLOAT_INPUT, &NoCallback );
+		OXR_CHECK( pInput->CreateAction( &actionTrigger, &actionSet, "trigger", "trigger", { "/user/hand/left", "/user/hand/right" } ) == XR_SUCCESS );
+
+		oxr::ValveIndex controller;
+		OXR_CHECK( pInput->AddBinding( &controller, actionTrigger.xrActionHandle, "/user/hand/left/input/trigger/value" ) == XR_SUCCESS );
+		OXR_CHECK( pInput->AddBinding( &controller, actionTrigger.xrActionHandle, "/user/hand/right/input/trigger/value" ) == XR_SUCCESS );
+		OXR_CHECK( pInput->SuggestBindings( &controller, nullptr ) == XR_SUCCESS );
+
+		pInput->Init( pProvider->Session() );
+		OXR_CHECK( pInput->AttachActionSetsToSession( &actionSet.xrActionSetHandle, 1 ) == XR_SUCCESS );
+		OXR_CHECK( pInput->AddActionsetForSync( &actionSet ) == XR_SUCCESS );
+
+		// (2) A one event queue - both hands become active on the first sync, only the left hand's event fits
+		oxr::mock::SetInputFloat( "/user/hand/left/input/trigger/value", 0.5f );
+		oxr::mock::SetInputFloat( "/user/hand/right/input/trigger/value", 0.75f );
+		pInput->EnableEventQueue( 0.01f, 0.0f, 1 );
+
+		std::vector< oxr::InputEvent > vecEvents;
+		OXR_CHECK( pInput->ProcessInput() == XR_SUCCESS );
+		OXR_CHECK( pInput->GetInputThreadStats().unDroppedEvents == 1 );
+		OXR_CHECK( pInput->DrainEvents( vecEvents ) == 1 );
+		OXR_CHECK( vecEvents.size() == 1 && vecEvents[ 0 ].unActionStateIndex == 0 && vecEvents[ 0 ].bIsActive && vecEvents[ 0 ].value.x == 0.5f );
+
+		// (3) The dropped right hand change is sent on the next sync, even though the runtime state didn't change again
+		vecEvents.clear();
+		OXR_CHECK( pInput->ProcessInput() == XR_SUCCESS );
+		OXR_CHECK( pInput->DrainEvents( vecEvents ) == 1 );
+		OXR_CHECK( vecEvents.size() == 1 && vecEvents[ 0 ].unActionStateIndex == 1 && vecEvents[ 0 ].bIsActive && vecEvents[ 0 ].value.x == 0.75f );
+
+		// (4) Once both hands are up to date, nothing more is sent
+		vecEvents.clear();
+		OXR_CHECK( pInput->ProcessInput() == XR_SUCCESS );
+		OXR_CHECK( pInput->DrainEvents( vecEvents ) == 0 );
+
+		// (5) Moves within the epsilon are not sent, larger ones are
+		oxr::mock::SetInputFloat( "/user/hand/left/input/trigger/value", 0.505f );
+		OXR_CHECK( pInput->ProcessInput() == XR_SUCCESS );
+		OXR_CHECK( pInput->DrainEvents( vecEvents ) == 0 );
+
+		oxr::mock::SetInputFloat( "/user/hand/left/input/trigger/value", 0.6f );
+		OXR_CHECK( pInput->ProcessInput() == XR_SUCCESS );
+		OXR_CHECK( pInput->DrainEvents( vecEvents ) == 1 );
+		OXR_CHECK( vecEvents.size() == 1 && vecEvents[ 0 ].unActionStateIndex == 0 && vecEvents[ 0 ].value.x == 0.6f );
+
+		pInput->DisableEventQueue();
+	}
+} // namespace
+
+int main( int argc, char *argv[] )
+{
+	TestRingSingleThread();
+	TestRingTwoThreads();
+
+	std::unique_ptr< oxr::Provider > pProvider = oxr::test::CreateFocusedHeadlessSession( k_pccTestName );
+	if ( !pProvider )
+	{
+		// The ring tests above don't need a runtime
+		if ( oxr::test::g_nFailures > 0 )
+			return oxr::test::Finish( k_pccTestName );
+
+		return oxr::test::Skip( k_pccTestName, "unable to start a session on the mock runtime (is XR_RUNTIME_JSON set?)" );
+	}
+
+	TestEventResend( pProvider.get() );
+
+	OXR_CHECK( oxr::test::EndSession( pProvider.get() ) );
+	return oxr::test::Finish( k_pccTestName );
+}
@@ -0,0 +1,190 @@
+/* Copyright 2021, 2022, 2023 Rune Berg (GitHub: https://github.com/1runeberg, Twitter: https://twitter.com/1runeberg, YouTube: https://www.youtube.com/@1RuneBerg)
+ *
+ *  SPDX-License-Identifier: MIT
+ *
+ *  Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+ *
+ *  2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *
+ *  3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote products derived from this
+ *     software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ *  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+ *  BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ *  GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+ *  DAMAGE.
+ *
+ */
+
+// Action state snapshots - nothing is published before the first sync, each sync publishes a newer snapshot, snapshots held by a
+// reader don't change while later syncs are published, and readers on other threads never see a torn or older snapshot.
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "test_common.hpp"
+
+namespace
+{
+	const char *k_pccTestName = "test_input_snapshot";
+	const char *k_pccHands[] = { "/user/hand/left", "/user/hand/right" };
+
+	const uint32_t k_unStressSyncs = 20000;
+	const uint32_t k_unStressReaders = 4;
+
+	void NoCallback( oxr::Action *, uint32_t ) {}
+
+	void TestSnapshots( oxr::Provider *pProvider )
+	{
+		// (1) Trigger and squeeze float actions on both hands and a boolean on the left hand - five states per snapshot
+		oxr::Input *pInput = pProvider->Input();
+		oxr::ActionSet actionSet;
+		OXR_CHECK( pInput->CreateActionSet( &actionSet, "test", "test actions" ) == XR_SUCCESS );
+
+		oxr::Action actionTrigger( XR_ACTION_TYPE_FLOAT_INPUT, &NoCallback );
+		oxr::Action actionSqueeze( XR_ACTION_TYPE_FLOAT_INPUT, &NoCallback );
+		oxr::Action actionButton( XR_ACTION_TYPE_BOOLEAN_INPUT, &NoCallback );
+		OXR_CHECK( pInput->CreateAction( &actionTrigger, &actionSet, "trigger", "trigger", { k_pccHands[ 0 ], k_pccHands[ 1 ] } ) == XR_SUCCESS );
+		OXR_CHECK( pInput->CreateAction( &actionSqueeze, &actionSet, "squeeze", "squeeze", { k_pccHands[ 0 ], k_pccHands[ 1 ] } ) == XR_SUCCESS );
+		OXR_CHECK( pInput->CreateAction( &actionButton, &actionSet, "button", "button", { k_pccHands[ 0 ] } ) == XR_SUCCESS );
+
+		oxr::ValveIndex controller;
+		for ( const char *pccHand : k_pccHands )
+		{
+			OXR_CHECK( pInput->AddBinding( &controller, actionTrigger.xrActionHandle, std::string( pccHand ) + "/input/trigger/value" ) == XR_SUCCESS );
+			OXR_CHECK( pInput->AddBinding( &controller, actionSqueeze.xrActionHandle, std::string( pccHand ) + "/input/squeeze/value" ) == XR_SUCCESS );
+		}
+		OXR_CHECK( pInput->AddBinding( &controller, actionButton.xrActionHandle, "/user/hand/left/input/a/click" ) == XR_SUCCESS );
+		OXR_CHECK( pInput->SuggestBindings( &controller, nullptr ) == XR_SUCCESS );
+
+		pInput->Init( pProvider->Session() );
+		OXR_CHECK( pInput->AttachActionSetsToSession( &actionSet.xrActionSetHandle, 1 ) == XR_SUCCESS );
+		OXR_CHECK( pInput->AddActionsetForSync( &actionSet ) == XR_SUCCESS );
+
+		// Slots are assigned when the actionset is added, before any sync
+		OXR_CHECK( actionTrigger.unSnapshotSlot != UINT32_MAX && actionSqueeze.unSnapshotSlot != UINT32_MAX && actionButton.unSnapshotSlot != UINT32_MAX );
+
+		// Every sync scripts the four float states to the number of syncs before it and the button to its parity,
+		// so all of a snapshot's states must agree with its sync index
+		uint32_t unSyncs = 0;
+		auto Sync = [ & ]() {
+			float fValue = static_cast< float >( unSyncs );
+			for ( const char *pccHand : k_pccHands )
+			{
+				oxr::mock::SetInputFloat( ( std::string( pccHand ) + "/input/trigger/value" ).c_str(), fValue );
+				oxr::mock::SetInputFloat( ( std::string( pccHand ) + "/input/squeeze/value" ).c_str(), fValue );
+			}
+			oxr::mock::SetInputBoolean( "/user/hand/left/input/a/click", ( unSyncs & 1 ) != 0 );
+			unSyncs++;
+			return pInput->ProcessInput() == XR_SUCCESS;
+		};
+
+		auto IsConsistent = [ & ]( const oxr::ActionStateSnapshot &snapshot ) {
+			float fExpected = static_cast< float >( snapshot.unSyncIndex );
+			for ( uint32_t i = 0; i < 2; i++ )
+			{
+				if ( !snapshot.IsActive( &actionTrigger, i ) || snapshot.GetFloat( &actionTrigger, i ) != fExpected )
+					return false;
+
+				if ( !snapshot.IsActive( &actionSqueeze, i ) || snapshot.GetFloat( &actionSqueeze, i ) != fExpected )
+					return false;
+			}
+
+			return snapshot.IsActive( &actionButton ) && snapshot.GetBoolean( &actionButton ) == ( ( snapshot.unSyncIndex & 1 ) != 0 );
+		};
+
+		// (2) Nothing is published before the first sync
+		OXR_CHECK( !pInput->AcquireActionStates().IsValid() );
+
+		// (3) Each sync publishes the latest states
+		OXR_CHECK( Sync() );
+		oxr::ActionStateSnapshotRef first = pInput->AcquireActionStates();
+		OXR_CHECK( first.IsValid() );
+		OXR_CHECK( first->unSyncIndex == 0 );
+		OXR_CHECK( IsConsistent( *first ) );
+
+		// (4) A held snapshot stays as it was while newer ones are published, and publishing doesn't wait on it
+		for ( uint32_t i = 0; i < 5; i++ )
+			OXR_CHECK( Sync() );
+
+		OXR_CHECK( first->unSyncIndex == 0 && IsConsistent( *first ) );
+
+		{
+			oxr::ActionStateSnapshotRef latest = pInput->AcquireActionStates();
+			OXR_CHECK( latest.IsValid() && latest->unSyncIndex == 5 && IsConsistent( *latest ) );
+			OXR_CHECK( latest->xrSyncTime >= first->xrSyncTime );
+		}
+
+		first.Release();
+		OXR_CHECK( !first.IsValid() );
+
+		// (5) Readers on several threads see sync indices and times that never go back, every state of each snapshot agreeing with its index
+		std::atomic< bool > bStop { false };
+		std::atomic< uint32_t > unReads { 0 };
+		std::atomic< uint32_t > unOutOfOrder { 0 };
+		std::atomic< uint32_t > unTorn { 0 };
+
+		std::vector< std::thread > vecReaders;
+		for ( uint32_t r = 0; r < k_unStressReaders; r++ )
+		{
+			vecReaders.emplace_back( [ & ] {
+				uint64_t unLastIndex = 0;
+				XrTime xrLastSyncTime = 0;
+				uint32_t unThreadReads = 0;
+				// Every reader checks at least one snapshot, even if it's only scheduled after the syncs
+				while ( !bStop.load() || unThreadReads == 0 )
+				{
+					oxr::ActionStateSnapshotRef snapshot = pInput->AcquireActionStates();
+					if ( !snapshot.IsValid() )
+						continue;
+
+					if ( snapshot->unSyncIndex < unLastIndex || snapshot->xrSyncTime < xrLastSyncTime )
+						unOutOfOrder++;
+
+					if ( !IsConsistent( *snapshot ) )
+						unTorn++;
+
+					unLastIndex = snapshot->unSyncIndex;
+					xrLastSyncTime = snapshot->xrSyncTime;
+					unThreadReads++;
+				}
+
+				unReads += unThreadReads;
+			} );
+		}
+
+		bool bSynced = true;
+		for ( uint32_t i = 0; i < k_unStressSyncs; i++ )
+			bSynced = Sync() && bSynced;
+
+		bStop.store( true );
+		for ( auto &threadReader : vecReaders )
+			threadReader.join();
+
+		OXR_CHECK( bSynced );
+		OXR_CHECK( unReads >= k_unStressReaders );
+		OXR_CHECK( unOutOfOrder == 0 );
+		OXR_CHECK( unTorn == 0 );
+
+		oxr::ActionStateSnapshotRef last = pInput->AcquireActionStates();
+		OXR_CHECK( last.IsValid() && last->unSyncIndex == unSyncs - 1 && IsConsistent( *last ) );
+	}
+} // namespace
+
+int main( int argc, char *argv[] )
+{
+	std::unique_ptr< oxr::Provider > pProvider = oxr::test::CreateFocusedHeadlessSession( k_pccTestName );
+	if ( !pProvider )
+		return oxr::test::Skip( k_pccTestName, "unable to start a session on the mock runtime (is XR_RUNTIME_JSON set?)" );
+
+	TestSnapshots( pProvider.get() );
+
+	OXR_CHECK( oxr::test::EndSession( pProvider.get() ) );
+	return oxr::test::Finish( k_pccTestName );
+}
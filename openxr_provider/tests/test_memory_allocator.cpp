@@ -0,0 +1,315 @@
+/* Copyright 2021, 2022, 2023 Rune Berg (GitHub: https://github.com/1runeberg, Twitter: https://twitter.com/1runeberg, YouTube: https://www.youtube.com/@1RuneBerg)
+ *
+ *  SPDX-License-Identifier: MIT
+ *
+ *  Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+ *
+ *  2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *
+ *  3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote products derived from this
+ *     software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ *  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+ *  BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ *  GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+ *  DAMAGE.
+ *
+ */
+
+// Pooled device memory - sub-allocation with alignment padding, best fit reuse, merging of freed neighbours, dedicated allocations
+// and release of empty blocks. Allocations are made from memory requirements directly, so only a vulkan device is needed.
+
+#include <algorithm>
+#include <cstring>
+#include <random>
+#include <vector>
+
+#include "test_common.hpp"
+#include "xrvk/memory_allocator.hpp"
+
+namespace
+{
+	const char *k_pccTestName = "test_memory_allocator";
+
+	const VkDeviceSize k_unBlockSize = 1024 * 1024;
+	const uint32_t k_unStressSteps = 4000;
+	const size_t k_unStressMaxLive = 256;
+	const VkMemoryPropertyFlags k_vkHostMemory = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+
+	VkMemoryRequirements Requirements( VkDeviceSize unSize, VkDeviceSize unAlignment ) { return { unSize, unAlignment, UINT32_MAX }; }
+
+	void TestSubAllocation( xrvk::MemoryAllocator &allocator )
+	{
+		// (1) Allocations share a block, each starts at its alignment and the padding is accounted for
+		xrvk::MemoryAllocation a, b, c;
+		OXR_CHECK( allocator.Allocate( Requirements( 1000, 256 ), k_vkHostMemory, true, &a ) == VK_SUCCESS );
+		OXR_CHECK( allocator.Allocate( Requirements( 1000, 256 ), k_vkHostMemory, true, &b ) == VK_SUCCESS );
+		OXR_CHECK( allocator.Allocate( Requirements( 4096, 4096 ), k_vkHostMemory, true, &c ) == VK_SUCCESS );
+
+		OXR_CHECK( a.pBlock != nullptr && a.pBlock == b.pBlock && b.pBlock == c.pBlock );
+		OXR_CHECK( a.unOffset == 0 && b.unOffset == 1024 && c.unOffset == 4096 );
+		OXR_CHECK( a.pMapped != nullptr && b.pMapped == static_cast< uint8_t * >( a.pMapped ) + 1024 );
+
+		xrvk::MemoryStats stats = allocator.GetStats();
+		OXR_CHECK( stats.unBlockCount == 1 && stats.unAllocationCount == 3 && stats.unDedicatedCount == 0 );
+		OXR_CHECK( stats.unUsedBytes == 6096 && stats.unWastedBytes == ( 1024 - 1000 ) + ( 4096 - 2024 ) );
+		OXR_CHECK( stats.unFreeBytes == k_unBlockSize - 8192 && stats.GetFragmentation() == 0.0f );
+
+		// Mapped memory is writable for the whole allocation
+		std::memset( c.pMapped, 0xAB, c.unSize );
+
+		// (2) Freeing the middle allocation leaves a hole
+		allocator.Free( b );
+		OXR_CHECK( !b.IsValid() );
+
+		stats = allocator.GetStats();
+		OXR_CHECK( stats.unAllocationCount == 2 && stats.unFreeBytes == k_unBlockSize - 8192 + 1024 );
+		OXR_CHECK( stats.GetFragmentation() > 0.0f );
+
+		// (3) Freeing its neighbour merges the hole with the free tail of the block
+		allocator.Free( c );
+		stats = allocator.GetStats();
+		OXR_CHECK( stats.unFreeBytes == k_unBlockSize - 1000 && stats.unLargestFreeRange == stats.unFreeBytes );
+		OXR_CHECK( stats.unWastedBytes == 0 );
+
+		// (4) An empty block is kept for reuse
+		allocator.Free( a );
+		stats = allocator.GetStats();
+		OXR_CHECK( stats.unBlockCount == 1 && stats.unAllocationCount == 0 && stats.unUsedBytes == 0 );
+		OXR_CHECK( stats.unFreeBytes == k_unBlockSize && stats.unLargestFreeRange == k_unBlockSize );
+	}
+
+	void TestBestFit( xrvk::MemoryAllocator &allocator )
+	{
+		// A freed hole that fits exactly is preferred over the larger free tail
+		xrvk::MemoryAllocation x, y, z, w;
+		OXR_CHECK( allocator.Allocate( Requirements( 65536, 1 ), k_vkHostMemory, true, &x ) == VK_SUCCESS );
+		OXR_CHECK( allocator.Allocate( Requirements( 100, 1 ), k_vkHostMemory, true, &y ) == VK_SUCCESS );
+		OXR_CHECK( allocator.Allocate( Requirements( 65536, 1 ), k_vkHostMemory, true, &z ) == VK_SUCCESS );
+
+		const VkDeviceSize unHoleOffset = y.unOffset;
+		allocator.Free( y );
+
+		OXR_CHECK( allocator.Allocate( Requirements( 100, 1 ), k_vkHostMemory, true, &w ) == VK_SUCCESS );
+		OXR_CHECK( w.unOffset == unHoleOffset && w.pBlock == x.pBlock );
+
+		allocator.Free( x );
+		allocator.Free( w );
+		allocator.Free( z );
+		OXR_CHECK( allocator.GetStats().unAllocationCount == 0 );
+	}
+
+	void TestBlocksAndDedicated( xrvk::MemoryAllocator &allocator )
+	{
+		// (1) Allocations larger than half a block are dedicated
+		xrvk::MemoryAllocation dedicated;
+		OXR_CHECK( allocator.Allocate( Requirements( k_unBlockSize / 2 + 1, 256 ), k_vkHostMemory, true, &dedicated ) == VK_SUCCESS );
+		OXR_CHECK( dedicated.IsValid() && dedicated.pBlock == nullptr && dedicated.unOffset == 0 && dedicated.pMapped != nullptr );
+		OXR_CHECK( allocator.GetStats().unDedicatedCount == 1 );
+
+		allocator.Free( dedicated );
+		OXR_CHECK( allocator.GetStats().unDedicatedCount == 0 );
+
+		// (2) A full block spills into a new one
+		xrvk::MemoryAllocation arrAllocations[ 3 ];
+		for ( auto &allocation : arrAllocations )
+			OXR_CHECK( allocator.Allocate( Requirements( k_unBlockSize / 2, 256 ), k_vkHostMemory, true, &allocation ) == VK_SUCCESS );
+
+		OXR_CHECK( arrAllocations[ 0 ].pBlock == arrAllocations[ 1 ].pBlock && arrAllocations[ 2 ].pBlock != arrAllocations[ 0 ].pBlock );
+		OXR_CHECK( allocator.GetStats().unBlockCount == 2 );
+
+		// (3) Once everything is freed, only one empty block is kept
+		for ( auto &allocation : arrAllocations )
+			allocator.Free( allocation );
+
+		xrvk::MemoryStats stats = allocator.GetStats();
+		OXR_CHECK( stats.unBlockCount == 1 && stats.unAllocationCount == 0 && stats.unAllocatedBytes == k_unBlockSize );
+	}
+
+	// An allocation made by the stress test, filled with its own byte so overlapping ranges show up as corrupted contents
+	struct LiveAllocation
+	{
+		xrvk::MemoryAllocation allocation;
+		VkDeviceSize unAlignment = 1;
+		bool bLinear = true;
+		uint8_t unPattern = 0;
+	};
+
+	bool HasPattern( const LiveAllocation &live )
+	{
+		const uint8_t *pData = static_cast< const uint8_t * >( live.allocation.pMapped );
+		return std::all_of( pData, pData + live.allocation.unSize, [ &live ]( uint8_t unByte ) { return unByte == live.unPattern; } );
+	}
+
+	// Checks that no two live allocations overlap, buffers and images only share blocks if the granularity allows it and the stats match the live set
+	bool IsConsistent( xrvk::MemoryAllocator &allocator, const std::vector< LiveAllocation > &vecLive, VkDeviceSize unBufferImageGranularity )
+	{
+		// (1) Each allocation is aligned and lies within its reserved range
+		VkDeviceSize unUsedBytes = 0;
+		VkDeviceSize unBlockRangeBytes = 0;
+		VkDeviceSize unDedicatedBytes = 0;
+		uint32_t unDedicatedCount = 0;
+
+		for ( auto &live : vecLive )
+		{
+			const xrvk::MemoryAllocation &allocation = live.allocation;
+			if ( !allocation.IsValid() || allocation.unOffset % live.unAlignment != 0 )
+				return false;
+
+			if ( allocation.unOffset < allocation.unRangeOffset || allocation.unOffset + allocation.unSize > allocation.unRangeOffset + allocation.unRangeSize )
+				return false;
+
+			unUsedBytes += allocation.unSize;
+			if ( allocation.pBlock == nullptr )
+			{
+				unDedicatedCount++;
+				unDedicatedBytes += allocation.unSize;
+			}
+			else
+			{
+				unBlockRangeBytes += allocation.unRangeSize;
+			}
+		}
+
+		// (2) Reserved ranges in the same block never overlap, and buffers never share a block with images unless the granularity is 1
+		std::vector< const LiveAllocation * > vecSorted;
+		for ( auto &live : vecLive )
+			vecSorted.push_back( &live );
+
+		std::sort( vecSorted.begin(), vecSorted.end(), []( const LiveAllocation *pA, const LiveAllocation *pB ) {
+			if ( pA->allocation.vkMemory != pB->allocation.vkMemory )
+				return pA->allocation.vkMemory < pB->allocation.vkMemory;
+			return pA->allocation.unRangeOffset < pB->allocation.unRangeOffset;
+		} );
+
+		for ( size_t i = 1; i < vecSorted.size(); i++ )
+		{
+			const LiveAllocation &previous = *vecSorted[ i - 1 ];
+			const LiveAllocation &current = *vecSorted[ i ];
+			if ( previous.allocation.vkMemory != current.allocation.vkMemory )
+				continue;
+
+			if ( previous.allocation.unRangeOffset + previous.allocation.unRangeSize > current.allocation.unRangeOffset )
+				return false;
+
+			if ( unBufferImageGranularity > 1 && previous.bLinear != current.bLinear )
+				return false;
+		}
+
+		// (3) Stats account for exactly the live allocations
+		xrvk::MemoryStats stats = allocator.GetStats();
+		if ( stats.unAllocationCount != vecLive.size() || stats.unDedicatedCount != unDedicatedCount || stats.unUsedBytes != unUsedBytes )
+			return false;
+
+		if ( stats.unWastedBytes != unBlockRangeBytes - ( unUsedBytes - unDedicatedBytes ) )
+			return false;
+
+		if ( unBlockRangeBytes + stats.unFreeBytes + unDedicatedBytes != stats.unAllocatedBytes || stats.unLargestFreeRange > stats.unFreeBytes )
+			return false;
+
+		return true;
+	}
+
+	void TestRandomStress( xrvk::MemoryAllocator &allocator, VkDeviceSize unBufferImageGranularity )
+	{
+		// (1) Mixed size, alignment and resource kind allocations interleaved with frees of random live ones
+		const VkDeviceSize arrAlignments[] = { 1, 4, 16, 64, 256, 1024, 4096, 65536 };
+
+		std::mt19937 rng( 1234 );
+		std::vector< LiveAllocation > vecLive;
+		uint8_t unNextPattern = 1;
+		uint32_t unFailedSteps = 0;
+		uint32_t unCorrupted = 0;
+
+		for ( uint32_t unStep = 0; unStep < k_unStressSteps; unStep++ )
+		{
+			const bool bAllocate = vecLive.empty() || ( vecLive.size() < k_unStressMaxLive && rng() % 100 < 60 );
+			if ( bAllocate )
+			{
+				// mostly small resources, some up to a quarter block and a few dedicated ones
+				const uint32_t unKind = rng() % 100;
+				VkDeviceSize unSize = 1 + rng() % 16384;
+				if ( unKind >= 98 )
+					unSize = k_unBlockSize / 2 + 1 + rng() % k_unBlockSize;
+				else if ( unKind >= 85 )
+					unSize = 16384 + rng() % ( k_unBlockSize / 4 );
+
+				LiveAllocation live;
+				live.unAlignment = arrAlignments[ rng() % std::size( arrAlignments ) ];
+				live.bLinear = rng() % 2 == 0;
+				live.unPattern = unNextPattern++;
+
+				if ( allocator.Allocate( Requirements( unSize, live.unAlignment ), k_vkHostMemory, live.bLinear, &live.allocation ) != VK_SUCCESS || live.allocation.pMapped == nullptr )
+				{
+					unFailedSteps++;
+					continue;
+				}
+
+				std::memset( live.allocation.pMapped, live.unPattern, live.allocation.unSize );
+				vecLive.push_back( live );
+			}
+			else
+			{
+				const size_t unIndex = rng() % vecLive.size();
+				if ( !HasPattern( vecLive[ unIndex ] ) )
+					unCorrupted++;
+
+				allocator.Free( vecLive[ unIndex ].allocation );
+				vecLive[ unIndex ] = vecLive.back();
+				vecLive.pop_back();
+			}
+
+			if ( !IsConsistent( allocator, vecLive, unBufferImageGranularity ) )
+				unFailedSteps++;
+		}
+
+		OXR_CHECK( unFailedSteps == 0 );
+
+		// (2) Releasing everything leaves no used or padded bytes, only free empty blocks
+		for ( auto &live : vecLive )
+		{
+			if ( !HasPattern( live ) )
+				unCorrupted++;
+
+			allocator.Free( live.allocation );
+		}
+
+		OXR_CHECK( unCorrupted == 0 );
+
+		xrvk::MemoryStats stats = allocator.GetStats();
+		OXR_CHECK( stats.unAllocationCount == 0 && stats.unDedicatedCount == 0 && stats.unUsedBytes == 0 && stats.unWastedBytes == 0 );
+		OXR_CHECK( stats.unBlockCount > 0 && stats.unFreeBytes == stats.unAllocatedBytes );
+	}
+} // namespace
+
+int main( int argc, char *argv[] )
+{
+	oxr::test::VulkanContext vulkan;
+	if ( !vulkan.Create( k_pccTestName ) )
+		return oxr::test::Skip( k_pccTestName, "no vulkan device available" );
+
+	{
+		xrvk::MemoryAllocator allocator( vulkan.vkPhysicalDevice, vulkan.vkDevice, k_unBlockSize );
+
+		TestSubAllocation( allocator );
+		TestBestFit( allocator );
+		TestBlocksAndDedicated( allocator );
+	}
+
+	{
+		// Buffers and optimally tiled images are kept in separate blocks if the device's granularity is above 1
+		VkPhysicalDeviceProperties vkPhysicalDeviceProperties {};
+		vkGetPhysicalDeviceProperties( vulkan.vkPhysicalDevice, &vkPhysicalDeviceProperties );
+		const VkDeviceSize unBufferImageGranularity = std::max< VkDeviceSize >( 1, vkPhysicalDeviceProperties.limits.bufferImageGranularity );
+
+		xrvk::MemoryAllocator allocator( vulkan.vkPhysicalDevice, vulkan.vkDevice, k_unBlockSize );
+		TestRandomStress( allocator, unBufferImageGranularity );
+	}
+
+	return oxr::test::Finish( k_pccTestName );
+}
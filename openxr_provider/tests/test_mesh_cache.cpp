@@ -0,0 +1,139 @@
+/* Copyright 2021, 2022, 2023 Rune Berg (GitHub: https://github.com/1runeberg, Twitter: https://twitter.com/1runeberg, YouTube: https://www.youtube.com/@1RuneBerg)
+ *
+ *  SPDX-License-Identifier: MIT
+ *
+ *  Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+ *
+ *  2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *
+ *  3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote products derived from this
+ *     software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ *  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+ *  BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ *  GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+ *  DAMAGE.
+ *
+ */
+
+// Mesh cache - a model saved right after parsing loads back with the same structure, geometry and bounds, and cache files that
+// are stale (source hash mismatch), truncated or missing are rejected so the model is parsed again.
+
+#include <filesystem>
+#include <cstring>
+
+#include "test_common.hpp"
+#include "xrvk/memory_allocator.hpp"
+#include "xrvk/mesh_cache.hpp"
+
+namespace
+{
+	const char *k_pccTestName = "test_mesh_cache";
+	const char *k_pccSource = OXR_TEST_ASSETS_DIRECTORY "/models/Box.glb";
+
+	uint32_t CountPrimitives( vkglTF::Model &model )
+	{
+		uint32_t unCount = 0;
+		for ( auto pNode : model.linearNodes )
+			unCount += pNode->mesh ? static_cast< uint32_t >( pNode->mesh->primitives.size() ) : 0;
+
+		return unCount;
+	}
+
+	void TestRoundTrip( xrvk::MeshCache &meshCache, vks::VulkanDevice *pVulkanDevice )
+	{
+		// (1) Cache files are named per source and scale, and the source hash covers the scale
+		const std::string sCacheFilename = meshCache.GetFilename( k_pccSource, 1.0f );
+		OXR_CHECK( !sCacheFilename.empty() && sCacheFilename != meshCache.GetFilename( k_pccSource, 2.0f ) );
+
+		const uint64_t unSourceHash = meshCache.HashSource( k_pccSource, 1.0f );
+		OXR_CHECK( unSourceHash != 0 && unSourceHash == meshCache.HashSource( k_pccSource, 1.0f ) );
+		OXR_CHECK( unSourceHash != meshCache.HashSource( k_pccSource, 2.0f ) );
+
+		// (2) Nothing to load before the model is saved
+		std::filesystem::remove( sCacheFilename );
+
+		vkglTF::Model cached;
+		OXR_CHECK( !meshCache.Load( sCacheFilename, unSourceHash, &cached, pVulkanDevice ) );
+
+		// (3) Parse and save, then load back
+		vkglTF::Model parsed;
+		OXR_CHECK( parsed.parseFromFile( k_pccSource, pVulkanDevice, 1.0f ) );
+		OXR_CHECK( meshCache.Save( sCacheFilename, unSourceHash, &parsed ) );
+		OXR_CHECK( meshCache.Load( sCacheFilename, unSourceHash, &cached, pVulkanDevice ) );
+
+		// (4) Same structure, geometry and bounds as the parsed model
+		OXR_CHECK( cached.linearNodes.size() == parsed.linearNodes.size() && cached.nodes.size() == parsed.nodes.size() );
+		OXR_CHECK( CountPrimitives( cached ) == CountPrimitives( parsed ) && CountPrimitives( cached ) > 0 );
+		OXR_CHECK( cached.materials.size() == parsed.materials.size() && cached.textures.size() == parsed.textures.size() );
+		OXR_CHECK( cached.animations.size() == parsed.animations.size() );
+		OXR_CHECK( cached.dimensions.min == parsed.dimensions.min && cached.dimensions.max == parsed.dimensions.max );
+
+		OXR_CHECK( cached.pendingUpload && parsed.pendingUpload );
+		if ( cached.pendingUpload && parsed.pendingUpload )
+		{
+			const auto &cachedUpload = *cached.pendingUpload;
+			const auto &parsedUpload = *parsed.pendingUpload;
+
+			OXR_CHECK( cachedUpload.vertexCount == parsedUpload.vertexCount && cachedUpload.indexCount == parsedUpload.indexCount );
+			OXR_CHECK( cachedUpload.vertexCount > 0 );
+			OXR_CHECK( std::memcmp( cachedUpload.vertexData, parsedUpload.vertexData, sizeof( vkglTF::Model::Vertex ) * parsedUpload.vertexCount ) == 0 );
+			OXR_CHECK( std::memcmp( cachedUpload.indexData, parsedUpload.indexData, sizeof( uint32_t ) * parsedUpload.indexCount ) == 0 );
+		}
+
+		cached.destroy( pVulkanDevice->logicalDevice );
+		parsed.destroy( pVulkanDevice->logicalDevice );
+
+		// (5) A different source hash (the source or scale changed) is stale
+		vkglTF::Model stale;
+		OXR_CHECK( !meshCache.Load( sCacheFilename, unSourceHash + 1, &stale, pVulkanDevice ) );
+		stale.destroy( pVulkanDevice->logicalDevice );
+
+		// (6) A truncated file is rejected
+		const std::string sTruncatedFilename = sCacheFilename + ".truncated";
+		std::filesystem::copy_file( sCacheFilename, sTruncatedFilename, std::filesystem::copy_options::overwrite_existing );
+		std::filesystem::resize_file( sTruncatedFilename, std::filesystem::file_size( sTruncatedFilename ) / 2 );
+
+		vkglTF::Model truncated;
+		OXR_CHECK( !meshCache.Load( sTruncatedFilename, unSourceHash, &truncated, pVulkanDevice ) );
+		truncated.destroy( pVulkanDevice->logicalDevice );
+
+		std::filesystem::remove( sTruncatedFilename );
+		std::filesystem::remove( sCacheFilename );
+	}
+} // namespace
+
+int main( int argc, char *argv[] )
+{
+	if ( !std::filesystem::exists( k_pccSource ) )
+		return oxr::test::Skip( k_pccTestName, "test assets not found" );
+
+	oxr::test::VulkanContext vulkan;
+	if ( !vulkan.Create( k_pccTestName ) )
+		return oxr::test::Skip( k_pccTestName, "no vulkan device available" );
+
+	const std::filesystem::path cacheDirectory = std::filesystem::temp_directory_path() / k_pccTestName;
+	std::filesystem::create_directories( cacheDirectory );
+
+	{
+		// The context owns the logical device, models only need the vks device for buffer creation and its memory allocator
+		vks::VulkanDevice vulkanDevice( vulkan.vkPhysicalDevice );
+		vulkanDevice.logicalDevice = vulkan.vkDevice;
+
+		xrvk::MemoryAllocator allocator( vulkan.vkPhysicalDevice, vulkan.vkDevice );
+		vulkanDevice.memoryAllocator = &allocator;
+
+		xrvk::MeshCache meshCache( cacheDirectory.generic_string() );
+		TestRoundTrip( meshCache, &vulkanDevice );
+
+		vulkanDevice.logicalDevice = VK_NULL_HANDLE;
+	}
+
+	std::filesystem::remove_all( cacheDirectory );
+	return oxr::test::Finish( k_pccTestName );
+}
@@ -0,0 +1,66 @@
+/* Copyright 2021, 2022, 2023 Rune Berg (GitHub: https://github.com/1runeberg, Twitter: https://twitter.com/1runeberg, YouTube: https://www.youtube.com/@1RuneBerg)
+ *
+ *  SPDX-License-Identifier: MIT
+ *
+ *  Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+ *
+ *  2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *
+ *  3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote products derived from this
+ *     software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ *  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+ *  BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ *  GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+ *  DAMAGE.
+ *
+ */
+
+// The bindless material table (one texture array and material buffer for all models) must produce the same pixels as binding a
+// descriptor set per material.
+//
+// The pbr model and shapes of the render tests are drawn with a render pass per eye, once with per material descriptor sets and
+// once with bindless materials, and the submitted images are compared per eye. Needs a vulkan device with descriptor indexing and
+// the compiled bindless shaders, skips otherwise.
+
+#include "render_common.hpp"
+
+namespace
+{
+	const char *k_pccTestName = "test_render_bindless";
+} // namespace
+
+int main()
+{
+	if ( !oxr::test::PrepareRenderTest() )
+		return oxr::test::Skip( k_pccTestName, "test assets directory not found" );
+
+	if ( !std::filesystem::exists( "shaders/pbr_khr_bindless.frag.spv" ) )
+		return oxr::test::Skip( k_pccTestName, "bindless shaders weren't compiled (glslangValidator not found at configure time)" );
+
+	// (1) Reference - a descriptor set per material
+	std::vector< oxr::test::EyeImage > vecPerMaterial;
+	oxr::test::ERunResult eResult = oxr::test::RenderScene( k_pccTestName, false, false, vecPerMaterial );
+	if ( eResult == oxr::test::ERunResult::NoRuntime )
+		return oxr::test::Skip( k_pccTestName, "mock runtime or vulkan device unavailable" );
+
+	OXR_CHECK( eResult == oxr::test::ERunResult::Rendered );
+
+	// (2) Bindless materials
+	std::vector< oxr::test::EyeImage > vecBindless;
+	eResult = oxr::test::RenderScene( k_pccTestName, false, true, vecBindless );
+	if ( eResult == oxr::test::ERunResult::NoRuntime || eResult == oxr::test::ERunResult::NotSupported )
+		return oxr::test::Skip( k_pccTestName, "descriptor indexing not supported by the vulkan device" );
+
+	OXR_CHECK( eResult == oxr::test::ERunResult::Rendered );
+
+	// (3) Compare per eye
+	oxr::test::CheckSameEyes( k_pccTestName, vecPerMaterial, vecBindless );
+
+	return oxr::test::Finish( k_pccTestName );
+}
@@ -0,0 +1,69 @@
+/* Copyright 2021, 2022, 2023 Rune Berg (GitHub: https://github.com/1runeberg, Twitter: https://twitter.com/1runeberg, YouTube: https://www.youtube.com/@1RuneBerg)
+ *
+ *  SPDX-License-Identifier: MIT
+ *
+ *  Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+ *
+ *  2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *
+ *  3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote products derived from this
+ *     software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ *  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+ *  BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ *  GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+ *  DAMAGE.
+ *
+ */
+
+// Multiview (single pass stereo) must produce the same pixels per eye as rendering each view separately.
+//
+// The same scene (a gltf model drawn through the pbr pipeline and a few shapes) is rendered twice on the mock runtime, once with
+// a swapchain per eye and once with a single two layer swapchain and multiview. The submitted images are read back after the
+// frame has ended and compared per eye. Needs a vulkan device and the compiled multiview shaders, skips otherwise.
+
+#include "render_common.hpp"
+
+namespace
+{
+	const char *k_pccTestName = "test_render_multiview";
+} // namespace
+
+int main()
+{
+	if ( !oxr::test::PrepareRenderTest() )
+		return oxr::test::Skip( k_pccTestName, "test assets directory not found" );
+
+	if ( !std::filesystem::exists( "shaders/pbr_multiview.vert.spv" ) )
+		return oxr::test::Skip( k_pccTestName, "multiview shaders weren't compiled (glslangValidator not found at configure time)" );
+
+	// (1) Reference - a render pass per eye
+	std::vector< oxr::test::EyeImage > vecTwoPass;
+	oxr::test::ERunResult eResult = oxr::test::RenderScene( k_pccTestName, false, false, vecTwoPass );
+	if ( eResult == oxr::test::ERunResult::NoRuntime )
+		return oxr::test::Skip( k_pccTestName, "mock runtime or vulkan device unavailable" );
+
+	OXR_CHECK( eResult == oxr::test::ERunResult::Rendered );
+
+	// (2) Single pass stereo
+	std::vector< oxr::test::EyeImage > vecMultiview;
+	eResult = oxr::test::RenderScene( k_pccTestName, true, false, vecMultiview );
+	if ( eResult == oxr::test::ERunResult::NoRuntime || eResult == oxr::test::ERunResult::NotSupported )
+		return oxr::test::Skip( k_pccTestName, "multiview not supported by the vulkan device" );
+
+	OXR_CHECK( eResult == oxr::test::ERunResult::Rendered );
+
+	// (3) Compare per eye
+	if ( oxr::test::CheckSameEyes( k_pccTestName, vecTwoPass, vecMultiview ) )
+	{
+		// ... and the eyes must differ from each other, so a view index stuck at 0 is caught
+		OXR_CHECK( oxr::test::CountMismatchedPixels( vecMultiview[ 0 ], vecMultiview[ 1 ] ) > 0 );
+	}
+
+	return oxr::test::Finish( k_pccTestName );
+}
@@ -0,0 +1,136 @@
+/* Copyright 2021, 2022, 2023 Rune Berg (GitHub: https://github.com/1runeberg, Twitter: https://twitter.com/1runeberg, YouTube: https://www.youtube.com/@1RuneBerg)
+ *
+ *  SPDX-License-Identifier: MIT
+ *
+ *  Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+ *
+ *  2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *
+ *  3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote products derived from this
+ *     software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ *  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+ *  BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+ *  GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+ *  DAMAGE.
+ *
+ */
+
+// Space location cache - hits skip the runtime, invalidation forces a new locate, and concurrent locates of the same space cache one entry.
+
+#include <thread>
+
+#include "test_common.hpp"
+
+namespace
+{
+	const char *k_pccTestName = "test_space_cache";
+
+	const uint32_t k_unThreads = 4;
+	const uint32_t k_unLocatesPerThread = 1000;
+
+	void NoCallback( oxr::Action *, uint32_t ) {}
+
+	void TestSpaceCache( oxr::Provider *pProvider )
+	{
+		oxr::Session *pSession = pProvider->Session();
+
+		XrSpace xrViewSpace = XR_NULL_HANDLE;
+		OXR_CHECK( pSession->CreateReferenceSpace( &xrViewSpace, XR_REFERENCE_SPACE_TYPE_VIEW, { { 0.0f, 0.0f, 0.0f, 1.0f }, { 0.0f, 0.0f, 0.0f } } ) == XR_SUCCESS );
+
+		// (1) Only the first locate for a space and time reaches the runtime
+		pSession->InvalidateSpaceLocationCache();
+		oxr::mock::ResetStats();
+
+		XrSpaceLocation xrSpaceLocation { XR_TYPE_SPACE_LOCATION };
+		OXR_CHECK( pSession->LocateSpace( pSession->GetReferenceSpace(), xrViewSpace, 1000, &xrSpaceLocation ) == XR_SUCCESS );
+		OXR_CHECK( pSession->LocateSpace( pSession->GetReferenceSpace(), xrViewSpace, 1000, &xrSpaceLocation ) == XR_SUCCESS );
+		OXR_CHECK( oxr::mock::GetStats().unLocateSpaceCalls == 1 );
+
+		// (2) A different time, or an invalidated cache, locates again
+		OXR_CHECK( pSession->LocateSpace( pSession->GetReferenceSpace(), xrViewSpace, 2000, &xrSpaceLocation ) == XR_SUCCESS );
+		OXR_CHECK( oxr::mock::GetStats().unLocateSpaceCalls == 2 );
+
+		pSession->InvalidateSpaceLocationCache();
+		OXR_CHECK( pSession->LocateSpace( pSession->GetReferenceSpace(), xrViewSpace, 1000, &xrSpaceLocation ) == XR_SUCCESS );
+		OXR_CHECK( oxr::mock::GetStats().unLocateSpaceCalls == 3 );
+
+		// (3) Threads racing on an uncached location each locate at most once - the runtime call is made outside the cache lock,
+		// after which the first result is cached and every later call is a hit
+		pSession->InvalidateSpaceLocationCache();
+		oxr::mock::ResetStats();
+
+		std::atomic< uint32_t > unFailures { 0 };
+		std::vector< std::thread > vecThreads;
+		for ( uint32_t i = 0; i < k_unThreads; i++ )
+		{
+			vecThreads.emplace_back( [ & ]() {
+				for ( uint32_t j = 0; j < k_unLocatesPerThread; j++ )
+				{
+					XrSpaceLocation xrThreadLocation { XR_TYPE_SPACE_LOCATION };
+					if ( pSession->LocateSpace( pSession->GetReferenceSpace(), xrViewSpace, 3000, &xrThreadLocation ) != XR_SUCCESS )
+						unFailures++;
+				}
+			} );
+		}
+
+		for ( auto &thread : vecThreads )
+			thread.join();
+
+		OXR_CHECK( unFailures == 0 );
+		OXR_CHECK( oxr::mock::GetStats().unLocateSpaceCalls >= 1 && oxr::mock::GetStats().unLocateSpaceCalls <= k_unThreads );
+
+		// (4) An input sync only drops action space locations - reference spaces stay cached for their display time
+		oxr::Input *pInput = pProvider->Input();
+		oxr::ActionSet actionSet;
+		OXR_CHECK( pInput->CreateActionSet( &actionSet, "test", "test actions" ) == XR_SUCCESS );
+
+		oxr::Action actionPose( XR_ACTION_TYPE_POSE_INPUT, &NoCallback );
+		OXR_CHECK( pInput->CreateAction( &actionPose, &actionSet, "pose", "pose", { "/user/hand/left" } ) == XR_SUCCESS );
+
+		oxr::ValveIndex controller;
+		OXR_CHECK( pInput->AddBinding( &controller, actionPose.xrActionHandle, "/user/hand/left/input/aim/pose" ) == XR_SUCCESS );
+		OXR_CHECK( pInput->SuggestBindings( &controller, nullptr ) == XR_SUCCESS );
+
+		pInput->Init( pSession );
+		XrPosef xrIdentity { { 0.0f, 0.0f, 0.0f, 1.0f }, { 0.0f, 0.0f, 0.0f } };
+		OXR_CHECK( pInput->CreateActionSpaces( &actionPose, &xrIdentity ) == XR_SUCCESS );
+		OXR_CHECK( pInput->AttachActionSetsToSession( &actionSet.xrActionSetHandle, 1 ) == XR_SUCCESS );
+		OXR_CHECK( pInput->AddActionsetForSync( &actionSet ) == XR_SUCCESS );
+
+		pSession->InvalidateSpaceLocationCache();
+		oxr::mock::ResetStats();
+
+		XrSpaceLocation xrActionLocation { XR_TYPE_SPACE_LOCATION };
+		OXR_CHECK( pSession->LocateSpace( pSession->GetReferenceSpace(), xrViewSpace, 4000, &xrSpaceLocation ) == XR_SUCCESS );
+		OXR_CHECK( pInput->GetActionPose( &xrActionLocation, &actionPose, 0, 4000 ) == XR_SUCCESS );
+		OXR_CHECK( pInput->GetActionPose( &xrActionLocation, &actionPose, 0, 4000 ) == XR_SUCCESS );
+		OXR_CHECK( oxr::mock::GetStats().unLocateSpaceCalls == 2 );
+
+		OXR_CHECK( pInput->ProcessInput() == XR_SUCCESS );
+		OXR_CHECK( pSession->LocateSpace( pSession->GetReferenceSpace(), xrViewSpace, 4000, &xrSpaceLocation ) == XR_SUCCESS );
+		OXR_CHECK( oxr::mock::GetStats().unLocateSpaceCalls == 2 );
+
+		OXR_CHECK( pInput->GetActionPose( &xrActionLocation, &actionPose, 0, 4000 ) == XR_SUCCESS );
+		OXR_CHECK( oxr::mock::GetStats().unLocateSpaceCalls == 3 );
+
+		xrDestroySpace( xrViewSpace );
+	}
+} // namespace
+
+int main( int argc, char *argv[] )
+{
+	std::unique_ptr< oxr::Provider > pProvider = oxr::test::CreateFocusedHeadlessSession( k_pccTestName );
+	if ( !pProvider )
+		return oxr::test::Skip( k_pccTestName, "unable to start a session on the mock runtime (is XR_RUNTIME_JSON set?)" );
+
+	TestSpaceCache( pProvider.get() );
+
+	OXR_CHECK( oxr::test::EndSession( pProvider.get() ) );
+	return oxr::test::Finish( k_pccTestName );
+}
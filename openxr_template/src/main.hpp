@@ -47,9 +47,6 @@ oxr::Session *g_pSession = nullptr;
 // Pointer to input handling object of the openxr provider library
 oxr::Input *g_pInput = nullptr;
 
-// Future for input thread
-std::future< XrResult > g_inputThread;
-
 // Current openxr session state
 XrSessionState g_sessionState = XR_SESSION_STATE_UNKNOWN;
 
@@ -160,25 +160,15 @@ XrResult demo_openxr_start()
 	// (8.2) Initialize render resources
 	g_pRender->CreateRenderResources( g_pSession, selectedTextureFormats.vkColorTextureFormat, selectedTextureFormats.vkDepthTextureFormat, vkExtent );
 
-	// (8.3) Optional: Add any shape pipelines
+	// (8.3) Optional: Add any shape batches (instanced shapes)
 	if ( g_extHandTracking )
 	{
 		// For hand tracking cubes
-		Shapes::Shape cubePalmLeft {};
-		cubePalmLeft.vecIndices = &g_vecCubeIndices;
-		cubePalmLeft.vecVertices = &g_vecCubeVertices;
-
-		g_pRender->PrepareShapesPipeline( &cubePalmLeft, "shaders/shape.vert.spv", "shaders/shape.frag.spv" );
-
-		PopulateHandShapes( &cubePalmLeft );
+		g_pHandJoints = g_pRender->vecShapeBatches[ g_pRender->AddShapeBatch( &g_vecCubeIndices, &g_vecCubeVertices, XR_HAND_JOINT_COUNT_EXT * 2 ) ];
+		PopulateHandShapes();
 
 		// For painting cubes
-		g_pReferencePaint = new Shapes::Shape;
-		g_pReferencePaint->vecIndices = &g_vecCubeIndices;
-		g_pReferencePaint->vecVertices = &g_vecPaintCubeVertices;
-		g_pReferencePaint->scale = { 0.01f, 0.01f, 0.01f };
-
-		g_pRender->PrepareShapesPipeline( g_pReferencePaint, "shaders/shape.vert.spv", "shaders/shape.frag.spv" );
+		g_pPaint = g_pRender->vecShapeBatches[ g_pRender->AddShapeBatch( &g_vecCubeIndices, &g_vecPaintCubeVertices ) ];
 	}
 
 	// (8.3) Add Render Scenes to render (will spawn in world origin)
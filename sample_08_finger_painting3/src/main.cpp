@@ -176,26 +176,17 @@ XrResult demo_openxr_start()
 	// (8.2) Initialize render resources
 	g_pRender->CreateRenderResources( g_pSession, selectedTextureFormats.vkColorTextureFormat, selectedTextureFormats.vkDepthTextureFormat, vkExtent );
 
-	// (8.3) Optional: Add any shape pipelines
+	// (8.3) Optional: Add any shape batches (instanced shapes)
 	if ( g_extHandTracking )
 	{
 		// For hand tracking cubes
-		Shapes::Shape cubePalmLeft {};
-		cubePalmLeft.vecIndices = &g_vecCubeIndices;
-		cubePalmLeft.vecVertices = &g_vecCubeVertices;
-		g_pRender->PrepareShapesPipeline( &cubePalmLeft, "shaders/shape.vert.spv", "shaders/shape.frag.spv" );
-
-		PopulateHandShapes( &cubePalmLeft );
-
-		// For painting cubes
-		g_pReferencePaint = new Shapes::Shape;
-		g_pReferencePaint->vecIndices = &g_vecCubeIndices;
-		g_pReferencePaint->vecVertices = &g_vecPaintCubeVertices;
-		g_pReferencePaint->scale = { 0.01f, 0.01f, 0.01f };
-
-		g_pRender->PrepareShapesPipeline( g_pReferencePaint, "shaders/shape.vert.spv", "shaders/shape.frag.spv" );
+		g_pHandJoints = g_pRender->vecShapeBatches[ g_pRender->AddShapeBatch( &g_vecCubeIndices, &g_vecCubeVertices, XR_HAND_JOINT_COUNT_EXT * 2 ) ];
+		PopulateHandShapes();
 	}
 
+	// For painting cubes - with either hand tracking or controllers
+	g_pPaint = g_pRender->vecShapeBatches[ g_pRender->AddShapeBatch( &g_vecCubeIndices, &g_vecPaintCubeVertices ) ];
+
 	// (8.3) Add stuff to render (will spawn in world origin)
 	g_pRender->AddRenderScene( "models/xr_gallery.glb", { 1.0f, 1.0f, 1.0f } );
 
@@ -477,11 +468,15 @@ XrResult demo_openxr_start()
 				{
 					// (16.1) Start input
 					bProcessInputFrame = true;
+					if ( g_pInput )
+						g_pInput->StartInputThread();
 				}
 				else if ( g_sessionState == XR_SESSION_STATE_STOPPING )
 				{
 					// (16.2) End session - end input
 					bProcessRenderFrame = bProcessInputFrame = false;
+					if ( g_pInput )
+						g_pInput->StopInputThread();
 
 					// (16.3) End session - end the app's frame loop here
 					oxr::LogInfo( LOG_CATEGORY_DEMO, "App frame loop ends here." );
@@ -504,7 +499,7 @@ XrResult demo_openxr_start()
 		// (17) Input
 		if ( bProcessInputFrame && g_pInput )
 		{
-			g_inputThread = std::async( std::launch::async, &oxr::Input::ProcessInput, g_pInput );
+			g_pInput->RequestInput();
 		}
 
 		// (18) Render
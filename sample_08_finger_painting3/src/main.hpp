@@ -29,6 +29,7 @@
 // Generated by cmake by populating project_config.h.in
 #include "project_config.h"
 
+#include <atomic>
 #include <cstdlib>
 #include <iomanip>
 #include <iostream>
@@ -47,9 +48,6 @@ oxr::Session *g_pSession = nullptr;
 // Pointer to input handling object of the openxr provider library
 oxr::Input *g_pInput = nullptr;
 
-// Future for input thread
-std::future< XrResult > g_inputThread;
-
 // Current openxr session state
 XrSessionState g_sessionState = XR_SESSION_STATE_UNKNOWN;
 
@@ -112,11 +110,11 @@ float g_fCurrentSaturationValue = 0.0f;
 bool g_bClapActive = false;
 uint16_t g_unPassthroughFXCycleStage = 0;
 
-// Holds the state for painting using the aim pose of the controller
+// Holds the state for painting using the aim pose of the controller - set by action callbacks on the input thread, read by the frame loop
 struct
 {
-	bool bIsActive = false;
-	bool bCurrentState = false;
+	std::atomic< bool > bIsActive { false };
+	std::atomic< bool > bCurrentState { false };
 } g_ActionPainterLeft, g_ActionPainterRight;
 
 // Reference to the pose action (used for aim pose painting)
@@ -174,8 +172,9 @@ std::vector< Shapes::Vertex > g_vecPaintCubeVertices = {
 	CUBE_SIDE( LBF, LTF, RTF, LBF, RTF, RBF, colorCyan ) // +Z
 };
 
-// Reference shape for painting
-Shapes::Shape *g_pReferencePaint = nullptr;
+// Instanced shapes - a batch for the hand joint cubes and one for the paint cubes, each drawn with a single call per eye
+Shapes::ShapeBatch *g_pHandJoints = nullptr;
+Shapes::ShapeBatch *g_pPaint = nullptr;
 
 /**
  * These are utility functions for the extensions we will be using in this demo
@@ -183,50 +182,45 @@ Shapes::Shape *g_pReferencePaint = nullptr;
 
 inline void HideHandShapes()
 {
-	uint32_t unTotalHandJoints = XR_HAND_JOINT_COUNT_EXT * 2;
-
-	// left hand will use the first XR_HAND_JOINT_COUNT_EXT indices
-	// right hand will use specHandJointIndex + XR_HAND_JOINT_COUNT_EXT indices
-	for ( uint32_t i = 0; i < unTotalHandJoints; i++ )
-	{
-		g_pRender->vecShapes[ i ]->scale = { 0.f, 0.f, 0.f };
-	}
+	if ( g_pHandJoints )
+		g_pHandJoints->bIsVisible = false;
 }
 
-inline void PopulateHandShapes( Shapes::Shape *shapePalm )
+inline void PopulateHandShapes()
 {
-	assert( g_pRender );
-	assert( shapePalm );
+	assert( g_pHandJoints );
 
-	// a cube per joint per hand - we'll match the indices with the hand tracking extension's
+	// a cube per joint per hand - we'll match the instance indices with the hand tracking extension's
 	// so we can easily refer to them later on to update the current tracked poses
 	uint32_t unTotalHandJoints = XR_HAND_JOINT_COUNT_EXT * 2;
-	g_pRender->vecShapes.resize( unTotalHandJoints );
 
 	// zero out the scale so cubes won't immediately appear until after the first frame of poses come in
-	shapePalm->scale = { 0.0f, 0.0f, 0.0f };
-
-	// XR_HAND_JOINT_PALM_EXT (0) - Use as a reference
-	g_pRender->vecShapes[ XR_HAND_JOINT_PALM_EXT ] = shapePalm;
+	Shapes::ShapeInstance joint {};
+	joint.scale = { 0.0f, 0.0f, 0.0f };
 
 	// left hand will use the first XR_HAND_JOINT_COUNT_EXT indices
 	// right hand will use specHandJointIndex + XR_HAND_JOINT_COUNT_EXT indices
-	for ( uint32_t i = 1; i < unTotalHandJoints; i++ )
+	for ( uint32_t i = 0; i < unTotalHandJoints; i++ )
 	{
-		g_pRender->vecShapes[ i ] = shapePalm->Duplicate();
+		g_pHandJoints->Add( joint );
 	}
 }
 
 inline void UpdateHandJoints( XrHandEXT hand, XrHandJointLocationEXT *handJoints )
 {
 	uint8_t unOffset = hand == XR_HAND_LEFT_EXT ? 0 : XR_HAND_JOINT_COUNT_EXT;
+	g_pHandJoints->bIsVisible = true;
 
 	for ( uint32_t i = 0; i < XR_HAND_JOINT_COUNT_EXT; i++ )
 	{
 		if ( ( handJoints[ i ].locationFlags & XR_SPACE_LOCATION_POSITION_VALID_BIT ) != 0 )
 		{
-			g_pRender->vecShapes[ i + unOffset ]->pose = handJoints[ i ].pose;
-			g_pRender->vecShapes[ i + unOffset ]->scale = { handJoints[ i ].radius, handJoints[ i ].radius, handJoints[ i ].radius };
+			Shapes::ShapeInstance joint {};
+			joint.orientation = handJoints[ i ].pose.orientation;
+			joint.position = handJoints[ i ].pose.position;
+			joint.scale = { handJoints[ i ].radius, handJoints[ i ].radius, handJoints[ i ].radius };
+
+			g_pHandJoints->Set( i + unOffset, joint );
 		}
 	}
 }
@@ -254,9 +248,12 @@ inline void UpdateHandTrackingPoses( XrFrameState *frameState )
 
 inline void Paint( XrPosef pose )
 {
-	Shapes::Shape *newPaint = g_pReferencePaint->Duplicate();
-	newPaint->pose = pose;
-	g_pRender->vecShapes.push_back( newPaint );
+	Shapes::ShapeInstance paint {};
+	paint.orientation = pose.orientation;
+	paint.position = pose.position;
+	paint.scale = { 0.01f, 0.01f, 0.01f };
+
+	g_pPaint->Add( paint );
 }
 
 inline void Paint( XrHandEXT hand )
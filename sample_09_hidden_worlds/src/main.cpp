@@ -548,11 +548,15 @@ XrResult demo_openxr_start()
 				{
 					// (16.1) Start input
 					bProcessInputFrame = true;
+					if ( g_pInput )
+						g_pInput->StartInputThread();
 				}
 				else if ( g_sessionState == XR_SESSION_STATE_STOPPING )
 				{
 					// (16.2) End session - end input
 					bProcessRenderFrame = bProcessInputFrame = false;
+					if ( g_pInput )
+						g_pInput->StopInputThread();
 
 					// (16.3) End session - end the app's frame loop here
 					oxr::LogInfo( LOG_CATEGORY_DEMO, "App frame loop ends here." );
@@ -575,7 +579,7 @@ XrResult demo_openxr_start()
 		// (17) Input
 		if ( bProcessInputFrame && g_pInput )
 		{
-			g_inputThread = std::async( std::launch::async, &oxr::Input::ProcessInput, g_pInput );
+			g_pInput->RequestInput();
 		}
 
 		// (18) Render
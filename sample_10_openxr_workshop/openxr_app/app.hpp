@@ -216,9 +216,6 @@ namespace oxr
 		// Pointer to input handling object of the openxr provider library
 		oxr::Input *m_pInput = nullptr;
 
-		// Future for input thread
-		std::future< XrResult > m_inputThread;
-
 		// Event data packet sent by the openxr runtime during polling
 		XrEventDataBaseHeader *m_xrEventDataBaseheader = nullptr;
 
@@ -365,7 +365,7 @@ namespace oxa
 			// (3) Input
 			if ( m_bProcessInputFrame && m_pInput )
 			{
-				m_inputThread = std::async( std::launch::async, &oxr::Input::ProcessInput, m_pInput );
+				m_pInput->RequestInput();
 			}
 
 			// (4) Render
@@ -415,11 +415,15 @@ namespace oxa
 			{
 				// Start input
 				m_bProcessInputFrame = true;
+				if ( m_pInput )
+					m_pInput->StartInputThread();
 			}
 			else if ( m_sessionState == XR_SESSION_STATE_STOPPING )
 			{
 				// End session - end input
 				m_bProcessRenderFrame = m_bProcessInputFrame = false;
+				if ( m_pInput )
+					m_pInput->StopInputThread();
 
 				// End session - end the app's frame loop here
 				oxr::LogInfo( LOG_CATEGORY_APP, "App frame loop ends here." );
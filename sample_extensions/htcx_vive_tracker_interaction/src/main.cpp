@@ -354,11 +354,15 @@ namespace
 					{
 						// (13.1.2) Start input
 						bProcessInputFrame = true;
+						if ( g_pInput )
+							g_pInput->StartInputThread();
 					}
 					else if ( g_sessionState == XR_SESSION_STATE_STOPPING )
 					{
 						// (13.1.3) End session - end the app's frame loop here
 						bProcessRenderFrame = bProcessInputFrame = false;
+						if ( g_pInput )
+							g_pInput->StopInputThread();
 
 						// (13.1.4) End session - end the app's frame loop here
 						oxr::LogInfo( LOG_CATEGORY_DEMO_EXT, "App frame loop ends here." );
@@ -387,7 +391,7 @@ namespace
 			// (14) Input
 			if ( bProcessInputFrame && g_pInput )
 			{
-				g_inputThread = std::async( std::launch::async, &oxr::Input::ProcessInput, g_pInput );
+				g_pInput->RequestInput();
 			}
 
 			// (15) Render loop
@@ -62,9 +62,6 @@ XrSessionState g_sessionState = XR_SESSION_STATE_UNKNOWN;
 // Vive Tracker Extension, if present
 oxr::ExtHTCXViveTrackerInteraction *g_extViveTracker = nullptr;
 
-// Future for input thread
-std::future< XrResult > g_inputThread;
-
 // Reference to the pose action (used for aim pose painting)
 oxr::Action *g_ControllerPoseAction = nullptr;
 